@@ -12,6 +12,7 @@
 
 #include <QtCore/QByteArray>
 #include <QtCore/QDateTime>
+#include <QtCore/QIODevice>
 #include <QtCore/QtEndian>
 
 QGC_LOGGING_CATEGORY(ExifParserLog, "qgc.analyzeview.exifparser")
@@ -71,6 +72,46 @@ bool _readIFDTagValue(const QByteArray& buf, size_t ifdOffset, bool isLittleEndi
     return false;
 }
 
+QByteArray readHeader(QIODevice &device)
+{
+    QByteArray header = device.read(2);
+    if (header != QByteArray("\xFF\xD8", 2)) {
+        qCWarning(ExifParserLog) << "Not a valid JPEG file";
+        return QByteArray();
+    }
+
+    // Walk the APPn segments at the start of the file until the APP1 segment is found. Each one is
+    // a two byte marker followed by a big endian length which includes the length field itself.
+    const int maxSegments = 16;
+    for (int segment = 0; segment < maxSegments; ++segment) {
+        const QByteArray marker = device.read(4);
+        if ((marker.size() != 4) || (static_cast<uint8_t>(marker[0]) != 0xFF) || ((static_cast<uint8_t>(marker[1]) & 0xF0) != 0xE0)) {
+            break;
+        }
+
+        const uint16_t length = qFromBigEndian<uint16_t>(marker.constData() + 2);
+        if (length < 2) {
+            break;
+        }
+
+        const QByteArray payload = device.read(length - 2);
+        if (payload.size() != (length - 2)) {
+            qCWarning(ExifParserLog) << "Truncated JPEG segment";
+            return QByteArray();
+        }
+
+        (void) header.append(marker);
+        (void) header.append(payload);
+
+        if (static_cast<uint8_t>(marker[1]) == 0xE1) {
+            return header;
+        }
+    }
+
+    qCWarning(ExifParserLog) << "APP1 marker not found in JPEG file";
+    return QByteArray();
+}
+
 QDateTime readTime(const QByteArray& buffer)
 {
     // Check for JPEG SOI marker (Start of Image)
@@ -83,14 +124,14 @@ QDateTime readTime(const QByteArray& buffer)
     // Search for the APP1 marker (EXIF metadata)
     size_t offset = 2;
     QByteArray app1Marker("\xFF\xE1", 2);
-    size_t app1MarkerIndex = buffer.indexOf(app1Marker, offset);
+    const qsizetype app1MarkerIndex = buffer.indexOf(app1Marker, offset);
     if (app1MarkerIndex == -1) {
         qCWarning(ExifParserLog) << "APP1 marker not found in JPEG file";
         return QDateTime();
     }
 
-    // Found APP1 marker
-    size_t exifStart = offset + 4;
+    // Found APP1 marker, skip it and the segment length
+    size_t exifStart = app1MarkerIndex + 4;
 
     // Check for "Exif\0\0" header
     QByteArray exifHeader("\x45\x78\x69\x66\x00\x00", 6);
@@ -14,11 +14,15 @@
 #include "GeoTagWorker.h"
 
 class QByteArray;
+class QIODevice;
 
 Q_DECLARE_LOGGING_CATEGORY(ExifParserLog)
 
 namespace ExifParser
 {
+    /// Reads from the start of a JPEG up to the end of its EXIF APP1 segment, which is all readTime and write need.
+    ///     @return Empty if the device does not contain a JPEG with an APP1 segment
+    QByteArray readHeader(QIODevice &device);
     QDateTime readTime(const QByteArray &buf);
     bool write(QByteArray &buf, const GeoTagWorker::CameraFeedbackPacket &geotag);
 }
@@ -28,6 +28,7 @@ GeoTagController::GeoTagController(QObject *parent)
     _worker->moveToThread(_workerThread);
 
     (void) connect(_worker, &GeoTagWorker::progressChanged, this, &GeoTagController::_workerProgressChanged);
+    (void) connect(_worker, &GeoTagWorker::imagesPerSecondChanged, this, &GeoTagController::_workerImagesPerSecondChanged);
     (void) connect(_worker, &GeoTagWorker::error, this, &GeoTagController::_workerError);
     (void) connect(_workerThread, &QThread::started, _worker, &GeoTagWorker::process);
     (void) connect(_workerThread, &QThread::started, this, &GeoTagController::inProgressChanged);
@@ -44,7 +45,8 @@ GeoTagController::~GeoTagController()
 
 void GeoTagController::cancelTagging()
 {
-    (void) QMetaObject::invokeMethod(_worker, "cancelTagging", Qt::AutoConnection);
+    // Called directly, a queued call would not be delivered until the busy worker thread returns to its event loop
+    _worker->cancelTagging();
     (void) QMetaObject::invokeMethod(_workerThread, "quit", Qt::AutoConnection);
 
     _workerThread->wait();
@@ -151,6 +153,7 @@ void GeoTagController::setSaveDirectory(const QString &dir)
 void GeoTagController::startTagging()
 {
     _setErrorMessage(QString());
+    _workerImagesPerSecondChanged(0);
 
     const QDir imageDirectory = QDir(_worker->imageDirectory());
     if (!imageDirectory.exists()) {
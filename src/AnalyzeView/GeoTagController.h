@@ -30,6 +30,7 @@ class GeoTagController : public QObject
     Q_PROPERTY(QString  saveDirectory   READ saveDirectory  WRITE setSaveDirectory  NOTIFY saveDirectoryChanged)
     Q_PROPERTY(QString  errorMessage    READ errorMessage                           NOTIFY errorMessageChanged)
     Q_PROPERTY(double   progress        READ progress                               NOTIFY progressChanged)
+    Q_PROPERTY(double   imagesPerSecond READ imagesPerSecond                        NOTIFY imagesPerSecondChanged)
     Q_PROPERTY(bool     inProgress      READ inProgress                             NOTIFY inProgressChanged)
 
 public:
@@ -46,6 +47,9 @@ class GeoTagController : public QObject
     /// Progress indicator: 0-100
     double progress() const { return _progress; }
 
+    /// Image processing throughput of the current tagging step
+    double imagesPerSecond() const { return _imagesPerSecond; }
+
     /// true: Currently in the process of tagging
     bool inProgress() const;
 
@@ -61,17 +65,20 @@ class GeoTagController : public QObject
     void imageDirectoryChanged(const QString &imageDirectory);
     void saveDirectoryChanged(const QString &saveDirectory);
     void progressChanged(double progress);
+    void imagesPerSecondChanged(double imagesPerSecond);
     void inProgressChanged();
     void errorMessageChanged(const QString &errorMessage);
 
 private slots:
     void _workerProgressChanged(double progress) { if (progress != _progress) { _progress = progress; emit progressChanged(_progress); } }
+    void _workerImagesPerSecondChanged(double imagesPerSecond) { if (imagesPerSecond != _imagesPerSecond) { _imagesPerSecond = imagesPerSecond; emit imagesPerSecondChanged(_imagesPerSecond); } }
     void _setErrorMessage(const QString &errorMsg) { if (errorMsg != _errorMessage) { _errorMessage = errorMsg; emit errorMessageChanged(_errorMessage); } }
     void _workerError(const QString &errorMsg) { _setErrorMessage(errorMsg); }
 
 private:
     QString _errorMessage;
     double _progress = 0.;
+    double _imagesPerSecond = 0.;
     bool _inProgress = false;
     GeoTagWorker *_worker = nullptr;
     QThread *_workerThread = nullptr;
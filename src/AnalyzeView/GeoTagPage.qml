@@ -50,6 +50,13 @@ AnalyzePage {
                 Layout.alignment: Qt.AlignVCenter
             }
 
+            QGCLabel {
+                text: qsTr("%1 images/s").arg(geoController.imagesPerSecond.toFixed(1))
+                visible: geoController.inProgress && geoController.imagesPerSecond > 0
+                Layout.alignment: Qt.AlignHCenter
+                Layout.columnSpan: 2
+            }
+
             QGCLabel {
                 text: geoController.errorMessage
                 color: "red"
@@ -15,7 +15,17 @@
 #include "PX4LogParser.h"
 #include "QGCLoggingCategory.h"
 
+#include <QtConcurrent/QtConcurrentMap>
 #include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QEventLoop>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QSet>
+#include <QtCore/QThread>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
 
 QGC_LOGGING_CATEGORY(GeoTagWorkerLog, "qgc.analyzeview.geotagworker")
 
@@ -24,6 +34,8 @@ GeoTagWorker::GeoTagWorker(QObject *parent)
 {
     // qCDebug(GeoTagWorkerLog) << Q_FUNC_INFO << this;
 
+    _threadPool.setMaxThreadCount(qBound(1, QThread::idealThreadCount(), kMaxThreads));
+
 #ifdef QT_DEBUG
     (void) connect(this, &GeoTagWorker::error, this, [](const QString &errorMsg) {
         qCDebug(GeoTagWorkerLog) << errorMsg;
@@ -33,6 +45,9 @@ GeoTagWorker::GeoTagWorker(QObject *parent)
 
 GeoTagWorker::~GeoTagWorker()
 {
+    _cancel = true;
+    _threadPool.waitForDone();
+
     // qCDebug(GeoTagWorkerLog) << Q_FUNC_INFO << this;
 }
 
@@ -94,29 +109,28 @@ bool GeoTagWorker::_parseExif()
 {
     _imageTimestamps.clear();
 
-    // TODO: QtConcurrent::mapped?
-    for (const QFileInfo& fileInfo : _imageList) {
-        if (_cancel) {
-            emit error(tr("Tagging cancelled"));
-            return false;
-        }
-
-        QFile file(fileInfo.absoluteFilePath());
-        if (!file.open(QIODevice::ReadOnly)) {
-            emit error(tr("Geotagging failed. Couldn't open image: %1").arg(fileInfo.fileName()));
-            return false;
-        }
+    QFutureWatcher<QDateTime> watcher;
+    watcher.setFuture(QtConcurrent::mapped(&_threadPool, _imageList, [this](const QFileInfo &fileInfo) {
+        return _cancel ? QDateTime() : _readImageTime(fileInfo.absoluteFilePath());
+    }));
 
-        const QByteArray imageBuffer = file.readAll();
-        file.close();
+    if (!_waitForImages(watcher, 100. / kSteps)) {
+        return false;
+    }
 
-        const QDateTime imageTime = ExifParser::readTime(imageBuffer);
-        if (!imageTime.isValid()) {
-            emit error(tr("Geotagging failed. Couldn't extract time from image: %1").arg(fileInfo.fileName()));
+    const QList<QDateTime> imageTimes = watcher.future().results();
+    for (qsizetype i = 0; i < imageTimes.count(); i++) {
+        if (!imageTimes[i].isValid()) {
+            const QFileInfo &fileInfo = _imageList[i];
+            if (!fileInfo.isReadable()) {
+                emit error(tr("Geotagging failed. Couldn't open image: %1").arg(fileInfo.fileName()));
+            } else {
+                emit error(tr("Geotagging failed. Couldn't extract time from image: %1").arg(fileInfo.fileName()));
+            }
             return false;
         }
 
-        (void) _imageTimestamps.append(imageTime.toSecsSinceEpoch());
+        (void) _imageTimestamps.append(imageTimes[i].toSecsSinceEpoch());
     }
 
     emit progressChanged(2.0 * (100.0 / kSteps));
@@ -124,24 +138,41 @@ bool GeoTagWorker::_parseExif()
     return true;
 }
 
-bool GeoTagWorker::_parseLogs()
+QDateTime GeoTagWorker::_readImageTime(const QString &imagePath)
 {
-    _triggerList.clear();
-
-    QFile file(_logFile);
+    QFile file(imagePath);
     if (!file.open(QIODevice::ReadOnly)) {
-        emit error(tr("Geotagging failed. Couldn't open log file."));
-        return false;
+        return QDateTime();
     }
 
-    const QByteArray log = file.readAll();
-    file.close();
+    return ExifParser::readTime(ExifParser::readHeader(file));
+}
+
+bool GeoTagWorker::_parseLogs()
+{
+    _triggerList.clear();
 
     bool parseComplete = false;
     QString errorString;
     if (_logFile.endsWith(".ulg", Qt::CaseSensitive)) {
-        parseComplete = ULogParser::getTagsFromLog(log, _triggerList, errorString);
+        // Streamed in chunks, only the camera capture topic is decoded
+        parseComplete = ULogParser::getTagsFromLog(_logFile, _triggerList, errorString, &_threadPool);
     } else {
+        QFile file(_logFile);
+        if (!file.open(QIODevice::ReadOnly)) {
+            emit error(tr("Geotagging failed. Couldn't open log file."));
+            return false;
+        }
+
+        // Map the log rather than reading it in, so large logs are paged in by the OS as the parser walks them
+        QByteArray log;
+        const uchar *const mappedLog = file.map(0, file.size());
+        if (mappedLog) {
+            log = QByteArray::fromRawData(reinterpret_cast<const char*>(mappedLog), file.size());
+        } else {
+            log = file.readAll();
+        }
+
         parseComplete = PX4LogParser::getTagsFromLog(log, _triggerList);
     }
 
@@ -203,49 +234,140 @@ bool GeoTagWorker::_calibrate()
 bool GeoTagWorker::_tagImages()
 {
     const qsizetype maxIndex = std::min(_imageIndices.count(), _triggerIndices.count());
-    for (int i = 0; i < maxIndex; i++) {
-        if (_cancel) {
-            emit error(tr("Tagging cancelled"));
-            return false;
-        }
 
+    QList<int> imageIndices;
+    QSet<int> uniqueImageIndices;
+    for (int i = 0; i < maxIndex; i++) {
         const int imageIndex = _imageIndices[i];
         if (imageIndex >= _imageList.count()) {
             emit error(tr("Geotagging failed. Requesting image #%1, but only %2 images present.").arg(imageIndex).arg(_imageList.count()));
             return false;
         }
 
-        const QFileInfo &imageInfo = _imageList.at(imageIndex);
-        QFile fileRead(imageInfo.absoluteFilePath());
-        if (!fileRead.open(QIODevice::ReadOnly)) {
-            emit error(tr("Geotagging failed. Couldn't open an image."));
-            return false;
+        // Each image is written once, so no two threads write the same tagged file
+        if (!uniqueImageIndices.contains(imageIndex)) {
+            (void) uniqueImageIndices.insert(imageIndex);
+            (void) imageIndices.append(imageIndex);
         }
+    }
+
+    QFutureWatcher<QString> watcher;
+    watcher.setFuture(QtConcurrent::mapped(&_threadPool, imageIndices, [this](int imageIndex) {
+        return _cancel ? QString() : _tagImage(imageIndex);
+    }));
 
-        QByteArray imageBuffer = fileRead.readAll();
-        fileRead.close();
+    if (!_waitForImages(watcher, 4. * (100. / kSteps))) {
+        return false;
+    }
 
-        if (!ExifParser::write(imageBuffer, _triggerList[imageIndex])) {
-            emit error(tr("Geotagging failed. Couldn't write to image: %1").arg(imageInfo.fileName()));
+    for (const QString &errorMsg : watcher.future().results()) {
+        if (!errorMsg.isEmpty()) {
+            emit error(errorMsg);
             return false;
         }
+    }
 
-        QFile fileWrite;
-        if (_saveDirectory.isEmpty()) {
-            fileWrite.setFileName(_imageDirectory + "/TAGGED/" + imageInfo.fileName());
-        } else {
-            fileWrite.setFileName(_saveDirectory + "/" + imageInfo.fileName());
+    return true;
+}
+
+QString GeoTagWorker::_tagImage(int imageIndex) const
+{
+    const QFileInfo &imageInfo = _imageList.at(imageIndex);
+    QFile fileRead(imageInfo.absoluteFilePath());
+    if (!fileRead.open(QIODevice::ReadOnly)) {
+        return tr("Geotagging failed. Couldn't open an image.");
+    }
+
+    // Only the EXIF header is rewritten, the rest of the image is copied over untouched
+    QByteArray header = ExifParser::readHeader(fileRead);
+    const qint64 headerSize = header.size();
+    if (header.isEmpty() || !ExifParser::write(header, _triggerList[imageIndex])) {
+        return tr("Geotagging failed. Couldn't write to image: %1").arg(imageInfo.fileName());
+    }
+
+    QFile fileWrite;
+    if (_saveDirectory.isEmpty()) {
+        fileWrite.setFileName(_imageDirectory + "/TAGGED/" + imageInfo.fileName());
+    } else {
+        fileWrite.setFileName(_saveDirectory + "/" + imageInfo.fileName());
+    }
+
+    if (!fileWrite.open(QFile::WriteOnly) || (fileWrite.write(header) != header.size()) || !_copyFileRange(fileRead, headerSize, fileWrite)) {
+        return tr("Geotagging failed. Couldn't write to image: %1").arg(imageInfo.fileName());
+    }
+
+    return QString();
+}
+
+bool GeoTagWorker::_copyFileRange(QFile &source, qint64 offset, QFile &destination)
+{
+    qint64 remaining = source.size() - offset;
+
+#ifdef Q_OS_LINUX
+    // Let the kernel copy directly between the files. Anything it can't handle (no native handle, filesystem
+    // without support) falls through to the buffered copy below.
+    if ((source.handle() != -1) && (destination.handle() != -1) && destination.flush()) {
+        loff_t sourceOffset = offset;
+        while (remaining > 0) {
+            const ssize_t copied = ::copy_file_range(source.handle(), &sourceOffset, destination.handle(), nullptr, static_cast<size_t>(remaining), 0);
+            if (copied <= 0) {
+                break;
+            }
+            remaining -= copied;
+        }
+
+        if (remaining == 0) {
+            return true;
         }
 
-        if (!fileWrite.open(QFile::WriteOnly)) {
-            emit error(tr("Geotagging failed. Couldn't write to image: %1").arg(imageInfo.fileName()));
+        // The kernel moved the destination file position, resync QFile before continuing
+        offset = sourceOffset;
+        if (!destination.seek(destination.size())) {
             return false;
         }
+    }
+#endif
+
+    if (!source.seek(offset)) {
+        return false;
+    }
+
+    while (remaining > 0) {
+        const QByteArray chunk = source.read(std::min(remaining, kCopyChunkSize));
+        if (chunk.isEmpty() || (destination.write(chunk) != chunk.size())) {
+            return false;
+        }
+        remaining -= chunk.size();
+    }
+
+    return true;
+}
+
+bool GeoTagWorker::_waitForImages(QFutureWatcherBase &watcher, double progressStart)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QEventLoop loop;
+    (void) connect(&watcher, &QFutureWatcherBase::progressValueChanged, &loop, [this, &watcher, &timer, progressStart](int progressValue) {
+        if (watcher.progressMaximum() > 0) {
+            emit progressChanged(progressStart + ((100. / kSteps) * progressValue) / watcher.progressMaximum());
+        }
+        if (timer.nsecsElapsed() > 0) {
+            emit imagesPerSecondChanged((progressValue * 1e9) / timer.nsecsElapsed());
+        }
+    });
+    (void) connect(&watcher, &QFutureWatcherBase::finished, &loop, &QEventLoop::quit);
 
-        fileWrite.write(imageBuffer);
-        fileWrite.close();
+    if (!watcher.isFinished()) {
+        (void) loop.exec();
+    }
 
-        emit progressChanged(4. * (100. / kSteps) + ((100. / kSteps) / maxIndex) * i);
+    qCDebug(GeoTagWorkerLog) << "Processed" << watcher.progressMaximum() << "images in" << timer.elapsed() << "msecs";
+
+    if (_cancel) {
+        emit error(tr("Tagging cancelled"));
+        return false;
     }
 
     return true;
@@ -13,9 +13,19 @@
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QObject>
 #include <QtCore/QString>
+#include <QtCore/QThreadPool>
+
+#include <atomic>
+
+class QDateTime;
+class QFile;
+class QFutureWatcherBase;
 
 Q_DECLARE_LOGGING_CATEGORY(GeoTagWorkerLog)
 
+/// Geotags a directory of images from the camera trigger packets in a flight log.
+/// Images are processed in parallel on a bounded thread pool. Only the EXIF header of each image is read and
+/// rewritten, the remainder of the image is copied to the tagged file without passing through QGC.
 class GeoTagWorker : public QObject
 {
     Q_OBJECT
@@ -46,10 +56,12 @@ class GeoTagWorker : public QObject
 signals:
     void error(const QString &errorMsg);
     void progressChanged(double progress);
+    void imagesPerSecondChanged(double imagesPerSecond);
     void taggingComplete();
 
 public slots:
     bool process();
+    /// Thread safe, may be called directly from any thread
     void cancelTagging() { _cancel = true; }
 
 private:
@@ -59,7 +71,15 @@ public slots:
     bool _calibrate();
     bool _tagImages();
 
-    bool _cancel = false;
+    /// Runs an event loop until the parallel step in the watcher completes, reporting progress and throughput
+    ///     @return false: cancelled
+    bool _waitForImages(QFutureWatcherBase &watcher, double progressStart);
+    QString _tagImage(int imageIndex) const;
+    static QDateTime _readImageTime(const QString &imagePath);
+    static bool _copyFileRange(QFile &source, qint64 offset, QFile &destination);
+
+    std::atomic_bool _cancel = false;
+    QThreadPool _threadPool;
     QString _logFile;
     QString _imageDirectory;
     QString _saveDirectory;
@@ -71,4 +91,6 @@ public slots:
     QList<int> _triggerIndices;
 
     static constexpr double kSteps = 5.;
+    static constexpr int kMaxThreads = 8;                   ///< Image processing is mostly I/O bound, more threads just contend for the disk
+    static constexpr qint64 kCopyChunkSize = 1024 * 1024;   ///< Buffer size for the fallback image data copy
 };
@@ -0,0 +1,155 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LogAnalyticsController.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCharts/QXYSeries>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QStandardPaths>
+
+QGC_LOGGING_CATEGORY(LogAnalyticsControllerLog, "qgc.analyzeview.loganalyticscontroller")
+
+LogAnalyticsController::LogAnalyticsController(QObject *parent)
+    : QObject(parent)
+{
+    // qCDebug(LogAnalyticsControllerLog) << Q_FUNC_INFO << this;
+
+    (void) connect(&_buildWatcher, &QFutureWatcherBase::finished, this, &LogAnalyticsController::_buildFinished);
+}
+
+LogAnalyticsController::~LogAnalyticsController()
+{
+    _buildWatcher.waitForFinished();
+
+    // qCDebug(LogAnalyticsControllerLog) << Q_FUNC_INFO << this;
+}
+
+void LogAnalyticsController::setLogFile(const QString &logFile)
+{
+    if (logFile == _logFile) {
+        return;
+    }
+
+    _logFile = logFile;
+    emit logFileChanged();
+
+    if (_buildWatcher.isRunning()) {
+        _reloadPending = true;
+        return;
+    }
+
+    _load();
+}
+
+void LogAnalyticsController::_load()
+{
+    _store.close();
+    emit topicsChanged();
+    _setErrorMessage(QString());
+
+    if (_logFile.isEmpty()) {
+        return;
+    }
+
+    const QString cacheRoot = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1String("/QGCLogAnalytics");
+    _cacheDirectory = LogColumnStore::cacheDirectory(_logFile, cacheRoot);
+
+    const QString logFile = _logFile;
+    const QString cacheDirectory = _cacheDirectory;
+    _buildWatcher.setFuture(QtConcurrent::run([logFile, cacheDirectory]() {
+        QString errorMessage;
+        LogColumnStore store;
+        if (!store.open(cacheDirectory, errorMessage)) {
+            qCDebug(LogAnalyticsControllerLog) << "Ingesting" << logFile << "into" << cacheDirectory;
+            (void) LogColumnStore::build(logFile, cacheDirectory, errorMessage);
+        } else {
+            errorMessage.clear();
+        }
+        return errorMessage;
+    }));
+    emit loadingChanged();
+}
+
+void LogAnalyticsController::_buildFinished()
+{
+    emit loadingChanged();
+
+    if (_reloadPending) {
+        _reloadPending = false;
+        _load();
+        return;
+    }
+
+    QString errorMessage = _buildWatcher.result();
+    if (errorMessage.isEmpty()) {
+        (void) _store.open(_cacheDirectory, errorMessage);
+    }
+
+    _setErrorMessage(errorMessage);
+    emit topicsChanged();
+}
+
+void LogAnalyticsController::_setErrorMessage(const QString &errorMessage)
+{
+    if (errorMessage != _errorMessage) {
+        _errorMessage = errorMessage;
+        if (!errorMessage.isEmpty()) {
+            qCWarning(LogAnalyticsControllerLog) << errorMessage;
+        }
+        emit errorMessageChanged();
+    }
+}
+
+QVariantMap LogAnalyticsController::updateRangeSeries(QAbstractSeries *series, const QString &topic, const QString &field, double t0, double t1, int maxPoints)
+{
+    return _fillSeries(series, _store.range(topic, field, t0, t1, maxPoints));
+}
+
+QVariantMap LogAnalyticsController::updateResampledSeries(QAbstractSeries *series, const QString &topic, const QString &field, double interval, Aggregate aggregate)
+{
+    return _fillSeries(series, _store.resample(topic, field, 0., _store.duration(), interval, static_cast<LogColumnStore::Aggregate>(aggregate)));
+}
+
+QVariantMap LogAnalyticsController::updateBinnedSeries(QAbstractSeries *series, const QString &xTopic, const QString &xField, const QString &yTopic, const QString &yField, double binWidth, Aggregate aggregate)
+{
+    return _fillSeries(series, _store.binned(xTopic, xField, yTopic, yField, binWidth, static_cast<LogColumnStore::Aggregate>(aggregate)));
+}
+
+QVariantMap LogAnalyticsController::_fillSeries(QAbstractSeries *series, const QList<QPointF> &points)
+{
+    QXYSeries *const xySeries = qobject_cast<QXYSeries*>(series);
+    if (xySeries) {
+        xySeries->replace(points);
+    }
+
+    QVariantMap bounds;
+    bounds[QStringLiteral("count")] = points.size();
+    if (points.isEmpty()) {
+        return bounds;
+    }
+
+    double xMin = points.constFirst().x();
+    double xMax = xMin;
+    double yMin = points.constFirst().y();
+    double yMax = yMin;
+    for (const QPointF &point : points) {
+        xMin = qMin(xMin, point.x());
+        xMax = qMax(xMax, point.x());
+        yMin = qMin(yMin, point.y());
+        yMax = qMax(yMax, point.y());
+    }
+
+    bounds[QStringLiteral("xMin")] = xMin;
+    bounds[QStringLiteral("xMax")] = xMax;
+    bounds[QStringLiteral("yMin")] = yMin;
+    bounds[QStringLiteral("yMax")] = yMax;
+
+    return bounds;
+}
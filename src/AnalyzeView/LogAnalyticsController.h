@@ -0,0 +1,92 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "LogColumnStore.h"
+
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QVariantMap>
+#include <QtQmlIntegration/QtQmlIntegration>
+
+class QAbstractSeries;
+
+Q_DECLARE_LOGGING_CATEGORY(LogAnalyticsControllerLog)
+
+/// Controller for LogAnalyticsPage.qml. Ingests the selected log into the column store cache in the background,
+/// then fills chart series from store queries.
+class LogAnalyticsController : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+    Q_MOC_INCLUDE(<QtCharts/QAbstractSeries>)
+
+    Q_PROPERTY(QString      logFile         READ logFile        WRITE setLogFile    NOTIFY logFileChanged)
+    Q_PROPERTY(bool         loading         READ loading                            NOTIFY loadingChanged)
+    Q_PROPERTY(QString      errorMessage    READ errorMessage                       NOTIFY errorMessageChanged)
+    Q_PROPERTY(QStringList  topics          READ topics                             NOTIFY topicsChanged)
+    Q_PROPERTY(double       duration        READ duration                           NOTIFY topicsChanged)
+
+public:
+    enum Aggregate {
+        Mean = LogColumnStore::AggregateMean,
+        Min = LogColumnStore::AggregateMin,
+        Max = LogColumnStore::AggregateMax,
+        Rms = LogColumnStore::AggregateRms,
+        Sum = LogColumnStore::AggregateSum,
+        Count = LogColumnStore::AggregateCount
+    };
+    Q_ENUM(Aggregate)
+
+    explicit LogAnalyticsController(QObject *parent = nullptr);
+    ~LogAnalyticsController();
+
+    Q_INVOKABLE QStringList fields(const QString &topic) const { return _store.fields(topic); }
+
+    /// The samples between t0 and t1 (seconds from the start of the log), reduced to about maxPoints.
+    /// The update functions return the bounds of the points as xMin, xMax, yMin and yMax, plus the point count.
+    Q_INVOKABLE QVariantMap updateRangeSeries(QAbstractSeries *series, const QString &topic, const QString &field, double t0, double t1, int maxPoints);
+
+    /// One point per interval over the whole log, for example vibration RMS per minute
+    Q_INVOKABLE QVariantMap updateResampledSeries(QAbstractSeries *series, const QString &topic, const QString &field, double interval, Aggregate aggregate);
+
+    /// The y field binned by the x field, for example battery voltage per throttle bin
+    Q_INVOKABLE QVariantMap updateBinnedSeries(QAbstractSeries *series, const QString &xTopic, const QString &xField, const QString &yTopic, const QString &yField, double binWidth, Aggregate aggregate);
+
+    QString logFile() const { return _logFile; }
+    bool loading() const { return _buildWatcher.isRunning(); }
+    QString errorMessage() const { return _errorMessage; }
+    QStringList topics() const { return _store.topics(); }
+    double duration() const { return _store.duration(); }
+
+    void setLogFile(const QString &logFile);
+
+signals:
+    void logFileChanged();
+    void loadingChanged();
+    void errorMessageChanged();
+    void topicsChanged();
+
+private slots:
+    void _buildFinished();
+
+private:
+    void _load();
+    void _setErrorMessage(const QString &errorMessage);
+    static QVariantMap _fillSeries(QAbstractSeries *series, const QList<QPointF> &points);
+
+    QString _logFile;
+    QString _cacheDirectory;
+    QString _errorMessage;
+    bool _reloadPending = false;
+    LogColumnStore _store;
+    QFutureWatcher<QString> _buildWatcher;
+};
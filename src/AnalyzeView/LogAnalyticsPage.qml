@@ -0,0 +1,201 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+import QtQuick
+import QtQuick.Controls
+import QtQuick.Layouts
+import QtCharts
+
+import QGroundControl
+import QGroundControl.Controls
+import QGroundControl.ScreenTools
+
+AnalyzePage {
+    pageComponent: pageComponent
+    pageDescription: qsTr("Plots fields from a ULog or telemetry log. The first time a log is opened it is indexed into a cache, after that queries run directly against the cache.")
+
+    readonly property real _margin:         ScreenTools.defaultFontPixelWidth
+    readonly property real _comboWidth:     ScreenTools.defaultFontPixelWidth * 24
+    readonly property real _valueWidth:     ScreenTools.defaultFontPixelWidth * 8
+    readonly property int  _modeRaw:        0
+    readonly property int  _modeResample:   1
+    readonly property int  _modeBinned:     2
+
+    LogAnalyticsController {
+        id: analyticsController
+    }
+
+    Component {
+        id: pageComponent
+
+        ColumnLayout {
+            width:      availableWidth
+            height:     availableHeight
+            spacing:    _margin
+
+            function updateChart() {
+                var bounds
+                if (modeCombo.currentIndex === _modeResample) {
+                    bounds = analyticsController.updateResampledSeries(lineSeries, topicCombo.currentText, fieldCombo.currentText, parseFloat(intervalField.text), aggregateCombo.currentValue)
+                } else if (modeCombo.currentIndex === _modeBinned) {
+                    bounds = analyticsController.updateBinnedSeries(lineSeries, xTopicCombo.currentText, xFieldCombo.currentText, topicCombo.currentText, fieldCombo.currentText, parseFloat(intervalField.text), aggregateCombo.currentValue)
+                } else {
+                    bounds = analyticsController.updateRangeSeries(lineSeries, topicCombo.currentText, fieldCombo.currentText, 0, analyticsController.duration, Math.max(2, chartView.plotArea.width))
+                }
+                if (bounds.count > 0) {
+                    var yMargin = Math.max((bounds.yMax - bounds.yMin) * 0.05, 0.001)
+                    axisX.min = bounds.xMin
+                    axisX.max = Math.max(bounds.xMax, bounds.xMin + 0.001)
+                    axisY.min = bounds.yMin - yMargin
+                    axisY.max = bounds.yMax + yMargin
+                }
+            }
+
+            RowLayout {
+                spacing: _margin
+
+                QGCButton {
+                    text:       qsTr("Open Log")
+                    enabled:    !analyticsController.loading
+                    onClicked:  openLogFile.openForLoad()
+
+                    QGCFileDialog {
+                        id:             openLogFile
+                        title:          qsTr("Select log file")
+                        folder:         QGroundControl.settingsManager.appSettings.logSavePath
+                        nameFilters:    [qsTr("ULog file (*.ulg)"), qsTr("Telemetry log (*.tlog)"), qsTr("All Files (*)")]
+                        onAcceptedForLoad: (file) => {
+                            analyticsController.logFile = file
+                            close()
+                        }
+                    }
+                }
+
+                QGCLabel {
+                    Layout.fillWidth:   true
+                    elide:              Text.ElideMiddle
+                    text:               analyticsController.loading ? qsTr("Indexing %1...").arg(analyticsController.logFile) :
+                                        (analyticsController.errorMessage !== "" ? analyticsController.errorMessage : analyticsController.logFile)
+                }
+            }
+
+            RowLayout {
+                spacing:    _margin
+                enabled:    analyticsController.topics.length > 0
+
+                QGCComboBox {
+                    id:                     modeCombo
+                    Layout.preferredWidth:  _valueWidth * 2
+                    model:                  [qsTr("Samples"), qsTr("Resample"), qsTr("Binned")]
+                }
+
+                QGCComboBox {
+                    id:                     topicCombo
+                    Layout.preferredWidth:  _comboWidth
+                    model:                  analyticsController.topics
+                }
+
+                QGCComboBox {
+                    id:                     fieldCombo
+                    Layout.preferredWidth:  _comboWidth
+                    model:                  analyticsController.fields(topicCombo.currentText)
+                }
+
+                QGCLabel {
+                    text:       qsTr("by")
+                    visible:    modeCombo.currentIndex === _modeBinned
+                }
+
+                QGCComboBox {
+                    id:                     xTopicCombo
+                    Layout.preferredWidth:  _comboWidth
+                    model:                  analyticsController.topics
+                    visible:                modeCombo.currentIndex === _modeBinned
+                }
+
+                QGCComboBox {
+                    id:                     xFieldCombo
+                    Layout.preferredWidth:  _comboWidth
+                    model:                  analyticsController.fields(xTopicCombo.currentText)
+                    visible:                modeCombo.currentIndex === _modeBinned
+                }
+
+                QGCComboBox {
+                    id:                     aggregateCombo
+                    Layout.preferredWidth:  _valueWidth * 2
+                    visible:                modeCombo.currentIndex !== _modeRaw
+                    textRole:               "text"
+                    valueRole:              "value"
+                    model: [
+                        { value: LogAnalyticsController.Mean,   text: qsTr("Mean") },
+                        { value: LogAnalyticsController.Min,    text: qsTr("Min") },
+                        { value: LogAnalyticsController.Max,    text: qsTr("Max") },
+                        { value: LogAnalyticsController.Rms,    text: qsTr("RMS") },
+                        { value: LogAnalyticsController.Sum,    text: qsTr("Sum") },
+                        { value: LogAnalyticsController.Count,  text: qsTr("Count") }
+                    ]
+                }
+
+                QGCLabel {
+                    text:       modeCombo.currentIndex === _modeBinned ? qsTr("Bin width") : qsTr("Interval (s)")
+                    visible:    modeCombo.currentIndex !== _modeRaw
+                }
+
+                QGCTextField {
+                    id:                     intervalField
+                    Layout.preferredWidth:  _valueWidth
+                    text:                   "60"
+                    numericValuesOnly:      true
+                    visible:                modeCombo.currentIndex !== _modeRaw
+                }
+
+                QGCButton {
+                    text:       qsTr("Plot")
+                    onClicked:  updateChart()
+                }
+            }
+
+            ChartView {
+                id:                     chartView
+                Layout.fillWidth:       true
+                Layout.fillHeight:      true
+                theme:                  ChartView.ChartThemeDark
+                antialiasing:           true
+                animationOptions:       ChartView.NoAnimation
+                legend.visible:         false
+                backgroundColor:        qgcPal.window
+                backgroundRoundness:    0
+
+                ValueAxis {
+                    id:                     axisX
+                    titleText:              modeCombo.currentIndex === _modeBinned ? xFieldCombo.currentText : qsTr("Time (s)")
+                    labelsFont.family:      ScreenTools.fixedFontFamily
+                    labelsFont.pointSize:   ScreenTools.smallFontPointSize
+                    labelsColor:            qgcPal.text
+                }
+
+                ValueAxis {
+                    id:                     axisY
+                    lineVisible:            false
+                    labelsFont.family:      ScreenTools.fixedFontFamily
+                    labelsFont.pointSize:   ScreenTools.smallFontPointSize
+                    labelsColor:            qgcPal.text
+                }
+
+                LineSeries {
+                    id:     lineSeries
+                    axisX:  axisX
+                    axisY:  axisY
+                    color:  "#00E04B"
+                    width:  1
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,1070 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LogColumnStore.h"
+#include "MAVLinkLib.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSaveFile>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QtEndian>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+
+QGC_LOGGING_CATEGORY(LogColumnStoreLog, "qgc.analyzeview.logcolumnstore")
+
+namespace {
+    constexpr const char *kIndexFile = "index.json";
+    constexpr const char *kVersionKey = "version";
+    constexpr const char *kSourceKey = "source";
+    constexpr const char *kStartKey = "startUsecs";
+    constexpr const char *kEndKey = "endUsecs";
+    constexpr const char *kTopicsKey = "topics";
+    constexpr const char *kNameKey = "name";
+    constexpr const char *kRowsKey = "rows";
+    constexpr const char *kTimeKey = "time";
+    constexpr const char *kFieldsKey = "fields";
+    constexpr const char *kTypeKey = "type";
+    constexpr const char *kValuesKey = "values";
+    constexpr const char *kBlocksKey = "blocks";
+
+    constexpr qint64 kTlogTimestampBytes = sizeof(quint64);
+
+    /// A topic on its way to disk. Columns are in little endian byte order, like the log.
+    typedef struct {
+        QString name;
+        QList<qint64> time;
+        QStringList fieldNames;
+        QList<ULogReader::FieldType> types;
+        QList<QByteArray> columns;
+    } IngestTopic_t;
+
+    template<typename T, typename Visit>
+    void visitTyped(const uchar *values, qint64 first, qint64 last, Visit &visit)
+    {
+        for (qint64 row = first; row < last; row++) {
+            if constexpr (sizeof(T) == 1) {
+                visit(row, static_cast<double>(static_cast<T>(values[row])));
+            } else {
+                visit(row, static_cast<double>(qFromLittleEndian<T>(values + (row * sizeof(T)))));
+            }
+        }
+    }
+
+    /// Calls visit(row, value) for the rows [first, last) of a column, the type switch is outside the loop
+    template<typename Visit>
+    void visitValues(ULogReader::FieldType type, const uchar *values, qint64 first, qint64 last, Visit &&visit)
+    {
+        switch (type) {
+        case ULogReader::FieldTypeInt8:
+            visitTyped<qint8>(values, first, last, visit);
+            break;
+        case ULogReader::FieldTypeUInt8:
+        case ULogReader::FieldTypeChar:
+            visitTyped<quint8>(values, first, last, visit);
+            break;
+        case ULogReader::FieldTypeBool:
+            for (qint64 row = first; row < last; row++) {
+                visit(row, (values[row] != 0) ? 1. : 0.);
+            }
+            break;
+        case ULogReader::FieldTypeInt16:
+            visitTyped<qint16>(values, first, last, visit);
+            break;
+        case ULogReader::FieldTypeUInt16:
+            visitTyped<quint16>(values, first, last, visit);
+            break;
+        case ULogReader::FieldTypeInt32:
+            visitTyped<qint32>(values, first, last, visit);
+            break;
+        case ULogReader::FieldTypeUInt32:
+            visitTyped<quint32>(values, first, last, visit);
+            break;
+        case ULogReader::FieldTypeInt64:
+            visitTyped<qint64>(values, first, last, visit);
+            break;
+        case ULogReader::FieldTypeUInt64:
+            visitTyped<quint64>(values, first, last, visit);
+            break;
+        case ULogReader::FieldTypeFloat:
+            visitTyped<float>(values, first, last, visit);
+            break;
+        case ULogReader::FieldTypeDouble:
+            visitTyped<double>(values, first, last, visit);
+            break;
+        }
+    }
+
+    double valueAt(ULogReader::FieldType type, const uchar *values, qint64 row)
+    {
+        double value = 0.;
+        visitValues(type, values, row, row + 1, [&value](qint64, double rowValue) { value = rowValue; });
+        return value;
+    }
+
+    typedef QPair<qint64, qint64> RowRange_t;
+
+    /// Runs scan over each range, on the pool if there is more than one
+    template<typename Scan>
+    auto runScans(QThreadPool *threadPool, const QList<RowRange_t> &ranges, Scan scan)
+    {
+        using Result = std::invoke_result_t<Scan, const RowRange_t&>;
+
+        if (ranges.size() <= 1) {
+            QList<Result> results;
+            for (const RowRange_t &range : ranges) {
+                results.append(scan(range));
+            }
+            return results;
+        }
+
+        return QtConcurrent::blockingMapped<QList<Result>>(threadPool, ranges, scan);
+    }
+
+    bool writeFile(const QString &fileName, const char *data, qint64 size, QString &errorMessage)
+    {
+        QFile file(fileName);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || (file.write(data, size) != size)) {
+            errorMessage = QStringLiteral("Unable to write %1: %2").arg(fileName, file.errorString());
+            return false;
+        }
+
+        return true;
+    }
+
+    /// Logs normally come in timestamp order, but ULog timestamps can step back and tlogs from several links interleave
+    void sortByTime(IngestTopic_t &topic)
+    {
+        if (std::is_sorted(topic.time.cbegin(), topic.time.cend())) {
+            return;
+        }
+
+        QList<qint64> order(topic.time.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&topic](qint64 a, qint64 b) { return topic.time[a] < topic.time[b]; });
+
+        QList<qint64> time(order.size());
+        for (qsizetype row = 0; row < order.size(); row++) {
+            time[row] = topic.time[order[row]];
+        }
+        topic.time = time;
+
+        for (int i = 0; i < topic.columns.size(); i++) {
+            const int size = ULogReader::fieldSize(topic.types[i]);
+            const QByteArray &column = topic.columns[i];
+            QByteArray sorted(column.size(), Qt::Uninitialized);
+            for (qsizetype row = 0; row < order.size(); row++) {
+                (void) memcpy(sorted.data() + (row * size), column.constData() + (order[row] * size), size);
+            }
+            topic.columns[i] = sorted;
+        }
+    }
+
+    bool mavlinkFieldType(mavlink_message_type_t mavlinkType, ULogReader::FieldType &type)
+    {
+        switch (mavlinkType) {
+        case MAVLINK_TYPE_UINT8_T:  type = ULogReader::FieldTypeUInt8;  return true;
+        case MAVLINK_TYPE_INT8_T:   type = ULogReader::FieldTypeInt8;   return true;
+        case MAVLINK_TYPE_UINT16_T: type = ULogReader::FieldTypeUInt16; return true;
+        case MAVLINK_TYPE_INT16_T:  type = ULogReader::FieldTypeInt16;  return true;
+        case MAVLINK_TYPE_UINT32_T: type = ULogReader::FieldTypeUInt32; return true;
+        case MAVLINK_TYPE_INT32_T:  type = ULogReader::FieldTypeInt32;  return true;
+        case MAVLINK_TYPE_UINT64_T: type = ULogReader::FieldTypeUInt64; return true;
+        case MAVLINK_TYPE_INT64_T:  type = ULogReader::FieldTypeInt64;  return true;
+        case MAVLINK_TYPE_FLOAT:    type = ULogReader::FieldTypeFloat;  return true;
+        case MAVLINK_TYPE_DOUBLE:   type = ULogReader::FieldTypeDouble; return true;
+        case MAVLINK_TYPE_CHAR:
+        default:
+            return false;
+        }
+    }
+
+    /// Parses a tlog: each message is preceded by its big endian timestamp in usecs since the epoch. Messages are
+    /// framed without a MAVLink channel, so ingesting does not take one away from the links.
+    bool ingestTlog(const QString &logFile, QList<IngestTopic_t> &topics, QString &errorMessage)
+    {
+        QFile file(logFile);
+        if (!file.open(QIODevice::ReadOnly)) {
+            errorMessage = QStringLiteral("Unable to open %1: %2").arg(logFile, file.errorString());
+            return false;
+        }
+
+        const qint64 size = file.size();
+        QByteArray readLog;
+        const uchar *data = (size > 0) ? file.map(0, size) : nullptr;
+        if (!data) {
+            readLog = file.readAll();
+            data = reinterpret_cast<const uchar*>(readLog.constData());
+        }
+
+        typedef struct {
+            int offset;
+            int size;
+        } FieldLayout_t;
+
+        typedef struct {
+            uint8_t systemId;
+            uint8_t componentId;
+            QString messageName;
+            QList<FieldLayout_t> layout;
+        } Source_t;
+
+        QHash<quint64, int> sourceIndex;
+        QList<Source_t> sources;
+        int vehicleSystemId = -1;
+        int vehicleComponentId = -1;
+        int resyncs = 0;
+        const qint64 nowUsecs = QDateTime::currentMSecsSinceEpoch() * 1000;
+
+        qint64 pos = 0;
+        while ((pos + kTlogTimestampBytes) < size) {
+            const qint64 messageStart = pos + kTlogTimestampBytes;
+            const uchar stx = data[messageStart];
+
+            mavlink_message_t rxMessage{};
+            mavlink_status_t rxStatus{};
+            mavlink_message_t message{};
+            mavlink_status_t status{};
+            uint8_t framing = MAVLINK_FRAMING_INCOMPLETE;
+            qint64 next = messageStart;
+            if ((stx == MAVLINK_STX) || (stx == MAVLINK_STX_MAVLINK1)) {
+                while ((next < size) && (framing == MAVLINK_FRAMING_INCOMPLETE)) {
+                    framing = mavlink_frame_char_buffer(&rxMessage, &rxStatus, data[next++], &message, &status);
+                }
+            }
+
+            if (framing != MAVLINK_FRAMING_OK) {
+                // Skip to the next byte which could start a message and read the timestamp in front of it
+                qint64 nextStx = messageStart + 1;
+                while ((nextStx < size) && (data[nextStx] != MAVLINK_STX) && (data[nextStx] != MAVLINK_STX_MAVLINK1)) {
+                    nextStx++;
+                }
+                pos = nextStx - kTlogTimestampBytes;
+                resyncs++;
+                continue;
+            }
+            pos = next;
+
+            qint64 usecs = static_cast<qint64>(qFromBigEndian<quint64>(data + messageStart - kTlogTimestampBytes));
+            if ((usecs < 0) || (usecs > nowUsecs)) {
+                // Same heuristic as log replay, some tools write the timestamp in little endian
+                usecs = static_cast<qint64>(qFromLittleEndian<quint64>(data + messageStart - kTlogTimestampBytes));
+            }
+
+            const mavlink_message_info_t *const info = mavlink_get_message_info(&message);
+            if (!info) {
+                continue;
+            }
+
+            if ((vehicleSystemId < 0) && (message.msgid == MAVLINK_MSG_ID_HEARTBEAT) && (mavlink_msg_heartbeat_get_autopilot(&message) != MAV_AUTOPILOT_INVALID)) {
+                vehicleSystemId = message.sysid;
+                vehicleComponentId = message.compid;
+            }
+
+            const quint64 key = (static_cast<quint64>(message.msgid) << 16) | (message.sysid << 8) | message.compid;
+            auto it = sourceIndex.constFind(key);
+            if (it == sourceIndex.constEnd()) {
+                Source_t source{ message.sysid, message.compid, QString(info->name), {} };
+                IngestTopic_t topic;
+                for (unsigned int i = 0; i < info->num_fields; i++) {
+                    const mavlink_field_info_t &fieldInfo = info->fields[i];
+                    ULogReader::FieldType type;
+                    if (!mavlinkFieldType(fieldInfo.type, type)) {
+                        continue;
+                    }
+                    const int fieldSize = ULogReader::fieldSize(type);
+                    const int count = qMax(1U, fieldInfo.array_length);
+                    for (int element = 0; element < count; element++) {
+                        const QString name = (fieldInfo.array_length > 0) ? QStringLiteral("%1[%2]").arg(fieldInfo.name).arg(element) : QString(fieldInfo.name);
+                        topic.fieldNames.append(name);
+                        topic.types.append(type);
+                        topic.columns.append(QByteArray());
+                        source.layout.append({ static_cast<int>(fieldInfo.wire_offset) + (element * fieldSize), fieldSize });
+                    }
+                }
+                it = sourceIndex.insert(key, sources.size());
+                sources.append(source);
+                topics.append(topic);
+            }
+
+            // MAVLink 2 trims trailing zeros from the payload
+            uint8_t payload[MAVLINK_MAX_PAYLOAD_LEN] = {};
+            (void) memcpy(payload, _MAV_PAYLOAD(&message), message.len);
+
+            IngestTopic_t &topic = topics[*it];
+            const QList<FieldLayout_t> &layout = sources[*it].layout;
+            topic.time.append(usecs);
+            for (int i = 0; i < layout.size(); i++) {
+                (void) topic.columns[i].append(reinterpret_cast<const char*>(payload + layout[i].offset), layout[i].size);
+            }
+        }
+
+        if (resyncs > 0) {
+            qCDebug(LogColumnStoreLog) << "Skipped" << resyncs << "corrupt stretches in" << logFile;
+        }
+
+        for (int i = 0; i < topics.size(); i++) {
+            const Source_t &source = sources[i];
+            topics[i].name = ((source.systemId == vehicleSystemId) && (source.componentId == vehicleComponentId))
+                ? source.messageName
+                : QStringLiteral("%1#%2:%3").arg(source.messageName).arg(source.systemId).arg(source.componentId);
+        }
+
+        if (topics.isEmpty()) {
+            errorMessage = QStringLiteral("No MAVLink messages found in %1").arg(logFile);
+            return false;
+        }
+
+        return true;
+    }
+
+    /// Topics of one ULog ingest pass, the reader's columns are shared, not copied
+    void ulogTopics(const ULogReader &reader, QList<IngestTopic_t> &topics)
+    {
+        for (const ULogReader::Topic_t &readerTopic : reader.topics()) {
+            const int timestampIndex = ULogReader::fieldIndex(readerTopic, QStringLiteral("timestamp"));
+            if ((timestampIndex < 0) || (readerTopic.rows == 0)) {
+                continue;
+            }
+
+            IngestTopic_t topic;
+            topic.name = (readerTopic.multiId == 0) ? readerTopic.name : QStringLiteral("%1#%2").arg(readerTopic.name).arg(readerTopic.multiId);
+            topic.time.resize(readerTopic.rows);
+            const ULogReader::Column_t &timestamps = readerTopic.columns[timestampIndex];
+            for (qsizetype row = 0; row < readerTopic.rows; row++) {
+                topic.time[row] = static_cast<qint64>(ULogReader::value(timestamps, row));
+            }
+
+            for (int i = 0; i < readerTopic.fields.size(); i++) {
+                if (i == timestampIndex) {
+                    continue;
+                }
+                topic.fieldNames.append(readerTopic.fields[i].name);
+                topic.types.append(readerTopic.columns[i].type);
+                topic.columns.append(readerTopic.columns[i].data);
+            }
+
+            topics.append(topic);
+        }
+    }
+
+    typedef struct {
+        bool ok;
+        QJsonObject entry;
+        QString errorMessage;
+        qint64 firstUsecs;
+        qint64 lastUsecs;
+    } WriteResult_t;
+
+    WriteResult_t writeTopic(const QString &directory, int number, IngestTopic_t &topic)
+    {
+        WriteResult_t result{ false, {}, {}, 0, 0 };
+
+        sortByTime(topic);
+
+        const qint64 rows = topic.time.size();
+        QList<qint64> time(rows);
+        for (qint64 row = 0; row < rows; row++) {
+            time[row] = qToLittleEndian(topic.time[row]);
+        }
+        const QString timeFile = QStringLiteral("%1.time").arg(number);
+        if (!writeFile(QDir(directory).filePath(timeFile), reinterpret_cast<const char*>(time.constData()), rows * sizeof(qint64), result.errorMessage)) {
+            return result;
+        }
+
+        const qint64 blockCount = (rows + LogColumnStore::kBlockRows - 1) / LogColumnStore::kBlockRows;
+        QJsonArray fields;
+        for (int i = 0; i < topic.columns.size(); i++) {
+            const uchar *const values = reinterpret_cast<const uchar*>(topic.columns[i].constData());
+
+            QList<LogColumnStore::Stats_t> blocks(blockCount, LogColumnStore::emptyStats());
+            for (qint64 block = 0; block < blockCount; block++) {
+                LogColumnStore::Stats_t &stats = blocks[block];
+                const qint64 first = block * LogColumnStore::kBlockRows;
+                visitValues(topic.types[i], values, first, qMin(first + LogColumnStore::kBlockRows, rows), [&stats](qint64, double value) {
+                    LogColumnStore::addValue(stats, value);
+                });
+            }
+
+            const QString valuesFile = QStringLiteral("%1_%2.col").arg(number).arg(i);
+            const QString blocksFile = QStringLiteral("%1_%2.blk").arg(number).arg(i);
+            if (!writeFile(QDir(directory).filePath(valuesFile), topic.columns[i].constData(), topic.columns[i].size(), result.errorMessage) ||
+                !writeFile(QDir(directory).filePath(blocksFile), reinterpret_cast<const char*>(blocks.constData()), blockCount * sizeof(LogColumnStore::Stats_t), result.errorMessage)) {
+                return result;
+            }
+
+            QJsonObject field;
+            field[kNameKey] = topic.fieldNames[i];
+            field[kTypeKey] = static_cast<int>(topic.types[i]);
+            field[kValuesKey] = valuesFile;
+            field[kBlocksKey] = blocksFile;
+            fields.append(field);
+        }
+
+        result.entry[kNameKey] = topic.name;
+        result.entry[kRowsKey] = rows;
+        result.entry[kTimeKey] = timeFile;
+        result.entry[kFieldsKey] = fields;
+        result.firstUsecs = topic.time.constFirst();
+        result.lastUsecs = topic.time.constLast();
+        result.ok = true;
+
+        // Free the decoded data as soon as it is on disk
+        topic = IngestTopic_t();
+
+        return result;
+    }
+}
+
+LogColumnStore::LogColumnStore()
+{
+    // qCDebug(LogColumnStoreLog) << Q_FUNC_INFO << this;
+}
+
+LogColumnStore::~LogColumnStore()
+{
+    // qCDebug(LogColumnStoreLog) << Q_FUNC_INFO << this;
+}
+
+QString LogColumnStore::cacheDirectory(const QString &logFile, const QString &cacheRoot)
+{
+    const QFileInfo fileInfo(logFile);
+    const QString key = QStringLiteral("%1|%2|%3|%4").arg(fileInfo.absoluteFilePath()).arg(fileInfo.size()).arg(fileInfo.lastModified().toMSecsSinceEpoch()).arg(kCacheVersion);
+    const QByteArray hash = QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1).toHex().left(16);
+
+    return QDir(cacheRoot).filePath(QStringLiteral("%1-%2").arg(fileInfo.completeBaseName(), QString::fromLatin1(hash)));
+}
+
+bool LogColumnStore::build(const QString &logFile, const QString &cacheDirectory, QString &errorMessage, QThreadPool *threadPool)
+{
+    errorMessage.clear();
+    if (!threadPool) {
+        threadPool = QThreadPool::globalInstance();
+    }
+
+    QDir directory(cacheDirectory);
+    if ((directory.exists() && !directory.removeRecursively()) || !directory.mkpath(QStringLiteral("."))) {
+        errorMessage = QStringLiteral("Unable to create cache directory %1").arg(cacheDirectory);
+        return false;
+    }
+
+    QJsonArray topicEntries;
+    qint64 startUsecs = std::numeric_limits<qint64>::max();
+    qint64 endUsecs = std::numeric_limits<qint64>::min();
+    int topicNumber = 0;
+
+    // Topics are written out in parallel, then dropped
+    const auto writeTopics = [&](QList<IngestTopic_t> &topics) {
+        QList<int> numbers(topics.size());
+        std::iota(numbers.begin(), numbers.end(), topicNumber);
+        const int firstNumber = topicNumber;
+        topicNumber += topics.size();
+
+        IngestTopic_t *const topicData = topics.data();
+        const QList<WriteResult_t> results = QtConcurrent::blockingMapped<QList<WriteResult_t>>(threadPool, numbers, [&](int number) {
+            return writeTopic(cacheDirectory, number, topicData[number - firstNumber]);
+        });
+        topics.clear();
+
+        for (const WriteResult_t &result : results) {
+            if (!result.ok) {
+                errorMessage = result.errorMessage;
+                return false;
+            }
+            topicEntries.append(result.entry);
+            startUsecs = qMin(startUsecs, result.firstUsecs);
+            endUsecs = qMax(endUsecs, result.lastUsecs);
+        }
+
+        return true;
+    };
+
+    if (logFile.endsWith(QStringLiteral(".ulg"), Qt::CaseInsensitive)) {
+        ULogReader definitions;
+        if (!definitions.open(logFile, errorMessage)) {
+            return false;
+        }
+
+        // Decoded data takes about as much memory as the log, so large logs are decoded a few topics at a time
+        const QStringList formats = definitions.formatNames();
+        const int passes = qBound(1, static_cast<int>((QFileInfo(logFile).size() + kIngestPassBytes - 1) / kIngestPassBytes), qMax(1, formats.size()));
+        for (int pass = 0; pass < passes; pass++) {
+            ULogReader reader;
+            if (!reader.open(logFile, errorMessage)) {
+                return false;
+            }
+            reader.setThreadPool(threadPool);
+            for (int i = pass; i < formats.size(); i += passes) {
+                reader.subscribe(formats[i]);
+            }
+            if (!reader.read(errorMessage)) {
+                return false;
+            }
+
+            QList<IngestTopic_t> topics;
+            ulogTopics(reader, topics);
+            if (!writeTopics(topics)) {
+                return false;
+            }
+        }
+    } else {
+        QList<IngestTopic_t> topics;
+        if (!ingestTlog(logFile, topics, errorMessage) || !writeTopics(topics)) {
+            return false;
+        }
+    }
+
+    if (topicEntries.isEmpty()) {
+        errorMessage = QStringLiteral("No timestamped data found in %1").arg(logFile);
+        return false;
+    }
+
+    QJsonObject index;
+    index[kVersionKey] = kCacheVersion;
+    index[kSourceKey] = QFileInfo(logFile).absoluteFilePath();
+    index[kStartKey] = startUsecs;
+    index[kEndKey] = endUsecs;
+    index[kTopicsKey] = topicEntries;
+
+    // The index goes last, a cache without one is incomplete and never opened
+    QSaveFile indexFile(directory.filePath(kIndexFile));
+    if (!indexFile.open(QIODevice::WriteOnly) || (indexFile.write(QJsonDocument(index).toJson(QJsonDocument::Compact)) < 0) || !indexFile.commit()) {
+        errorMessage = QStringLiteral("Unable to write %1: %2").arg(indexFile.fileName(), indexFile.errorString());
+        return false;
+    }
+
+    qCDebug(LogColumnStoreLog) << "Ingested" << logFile << topicEntries.size() << "topics";
+
+    return true;
+}
+
+bool LogColumnStore::open(const QString &cacheDirectory, QString &errorMessage)
+{
+    close();
+    errorMessage.clear();
+
+    QFile indexFile(QDir(cacheDirectory).filePath(kIndexFile));
+    if (!indexFile.open(QIODevice::ReadOnly)) {
+        errorMessage = QStringLiteral("No log cache in %1").arg(cacheDirectory);
+        return false;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(indexFile.readAll(), &parseError);
+    const QJsonObject index = document.object();
+    if ((parseError.error != QJsonParseError::NoError) || (index[kVersionKey].toInt() != kCacheVersion)) {
+        errorMessage = QStringLiteral("Log cache in %1 is invalid or out of date").arg(cacheDirectory);
+        return false;
+    }
+
+    QList<Topic_t> topics;
+    for (const QJsonValue &topicValue : index[kTopicsKey].toArray()) {
+        const QJsonObject topicObject = topicValue.toObject();
+        Topic_t topic{ topicObject[kNameKey].toString(), topicObject[kRowsKey].toInteger(), topicObject[kTimeKey].toString(), {} };
+        for (const QJsonValue &fieldValue : topicObject[kFieldsKey].toArray()) {
+            const QJsonObject fieldObject = fieldValue.toObject();
+            const int type = fieldObject[kTypeKey].toInt(-1);
+            if ((type < ULogReader::FieldTypeInt8) || (type > ULogReader::FieldTypeChar)) {
+                errorMessage = QStringLiteral("Log cache in %1 is invalid or out of date").arg(cacheDirectory);
+                return false;
+            }
+            topic.fields.append({ fieldObject[kNameKey].toString(), static_cast<ULogReader::FieldType>(type), fieldObject[kValuesKey].toString(), fieldObject[kBlocksKey].toString() });
+        }
+        topics.append(topic);
+    }
+
+    std::sort(topics.begin(), topics.end(), [](const Topic_t &a, const Topic_t &b) { return a.name < b.name; });
+
+    _directory = cacheDirectory;
+    _startUsecs = index[kStartKey].toInteger();
+    _endUsecs = index[kEndKey].toInteger();
+    _topics = topics;
+    for (int i = 0; i < _topics.size(); i++) {
+        _topicIndex.insert(_topics[i].name, i);
+    }
+
+    return isOpen();
+}
+
+void LogColumnStore::close()
+{
+    QMutexLocker lock(&_mappingsMutex);
+
+    _mappings.clear();
+    _topics.clear();
+    _topicIndex.clear();
+    _directory.clear();
+    _startUsecs = 0;
+    _endUsecs = 0;
+}
+
+QStringList LogColumnStore::topics() const
+{
+    QStringList names;
+    for (const Topic_t &topic : _topics) {
+        names.append(topic.name);
+    }
+
+    return names;
+}
+
+QStringList LogColumnStore::fields(const QString &topic) const
+{
+    QStringList names;
+    const Topic_t *const storeTopic = _topic(topic);
+    if (storeTopic) {
+        for (const Field_t &field : storeTopic->fields) {
+            names.append(field.name);
+        }
+    }
+
+    return names;
+}
+
+qint64 LogColumnStore::rows(const QString &topic) const
+{
+    const Topic_t *const storeTopic = _topic(topic);
+    return storeTopic ? storeTopic->rows : 0;
+}
+
+const LogColumnStore::Topic_t *LogColumnStore::_topic(const QString &name) const
+{
+    const auto it = _topicIndex.constFind(name);
+    return (it != _topicIndex.constEnd()) ? &_topics[*it] : nullptr;
+}
+
+const uchar *LogColumnStore::_map(const QString &fileName, qint64 size) const
+{
+    const auto it = _mappings.constFind(fileName);
+    if (it != _mappings.constEnd()) {
+        return (*it)->data;
+    }
+
+    std::shared_ptr<Mapping> mapping = std::make_shared<Mapping>();
+    mapping->file.setFileName(QDir(_directory).filePath(fileName));
+    if (!mapping->file.open(QIODevice::ReadOnly) || (mapping->file.size() != size)) {
+        qCWarning(LogColumnStoreLog) << "Log cache file missing or truncated:" << mapping->file.fileName();
+        return nullptr;
+    }
+    mapping->data = mapping->file.map(0, size);
+    if (!mapping->data) {
+        qCWarning(LogColumnStoreLog) << "Unable to map" << mapping->file.fileName() << mapping->file.errorString();
+        return nullptr;
+    }
+
+    (void) _mappings.insert(fileName, mapping);
+
+    return mapping->data;
+}
+
+bool LogColumnStore::_column(const QString &topic, const QString &field, Column_t &column) const
+{
+    const Topic_t *const storeTopic = _topic(topic);
+    if (!storeTopic || (storeTopic->rows == 0)) {
+        return false;
+    }
+
+    const auto fieldIt = std::find_if(storeTopic->fields.cbegin(), storeTopic->fields.cend(), [&field](const Field_t &storeField) {
+        return storeField.name == field;
+    });
+    if (fieldIt == storeTopic->fields.cend()) {
+        return false;
+    }
+
+    const qint64 rows = storeTopic->rows;
+    const qint64 blockCount = (rows + kBlockRows - 1) / kBlockRows;
+
+    QMutexLocker lock(&_mappingsMutex);
+
+    column.rows = rows;
+    column.type = fieldIt->type;
+    column.time = reinterpret_cast<const qint64*>(_map(storeTopic->timeFile, rows * sizeof(qint64)));
+    column.values = _map(fieldIt->valuesFile, rows * ULogReader::fieldSize(fieldIt->type));
+    column.blocks = reinterpret_cast<const Stats_t*>(_map(fieldIt->blocksFile, blockCount * sizeof(Stats_t)));
+
+    return column.time && column.values && column.blocks;
+}
+
+qint64 LogColumnStore::_usecs(double secs) const
+{
+    const double usecs = std::round(secs * 1e6);
+    if (!(usecs < static_cast<double>(_endUsecs - _startUsecs))) {
+        return _endUsecs + 1;
+    }
+    if (!(usecs > 0.)) {
+        return _startUsecs;
+    }
+
+    return _startUsecs + static_cast<qint64>(usecs);
+}
+
+qint64 LogColumnStore::_lowerRow(const Column_t &column, qint64 usecs) const
+{
+    const qint64 *const row = std::lower_bound(column.time, column.time + column.rows, usecs, [](const qint64 &time, qint64 value) {
+        return qFromLittleEndian(time) < value;
+    });
+
+    return row - column.time;
+}
+
+QList<QPair<qint64, qint64>> LogColumnStore::_split(qint64 first, qint64 last) const
+{
+    QList<RowRange_t> ranges;
+    if (first >= last) {
+        return ranges;
+    }
+
+    // A few tasks per thread to even out the load, each covering whole blocks
+    const int threads = qMax(1, QThread::idealThreadCount());
+    const qint64 taskRows = qMax(kParallelRows, (((last - first) / (threads * 4)) + kBlockRows - 1) / kBlockRows * kBlockRows);
+    for (qint64 start = first; start < last;) {
+        qint64 end = ((start + taskRows) / kBlockRows) * kBlockRows;
+        end = (end > start) ? qMin(end, last) : qMin(start + taskRows, last);
+        ranges.append(RowRange_t(start, end));
+        start = end;
+    }
+
+    return ranges;
+}
+
+QList<QPointF> LogColumnStore::range(const QString &topic, const QString &field, double t0, double t1, int maxPoints) const
+{
+    QList<QPointF> points;
+
+    Column_t column;
+    if (!_column(topic, field, column) || (t1 < t0)) {
+        return points;
+    }
+
+    const qint64 first = _lowerRow(column, _usecs(t0));
+    const qint64 last = _lowerRow(column, _usecs(t1) + 1);
+    const qint64 count = last - first;
+    if (count <= 0) {
+        return points;
+    }
+
+    const qint64 startUsecs = _startUsecs;
+    const auto point = [&column, startUsecs](qint64 row, double value) {
+        return QPointF((qFromLittleEndian(column.time[row]) - startUsecs) / 1e6, value);
+    };
+
+    if ((maxPoints <= 0) || (count <= maxPoints)) {
+        points.reserve(count);
+        visitValues(column.type, column.values, first, last, [&points, &point](qint64 row, double value) {
+            if (!std::isnan(value)) {
+                points.append(point(row, value));
+            }
+        });
+        return points;
+    }
+
+    // The smallest and largest sample of each slice, in time order
+    const qint64 slices = qMax(1, maxPoints / 2);
+    const qint64 slicesPerTask = qMax(qint64(1), (slices * kParallelRows) / count);
+    QList<RowRange_t> sliceRanges;
+    for (qint64 slice = 0; slice < slices; slice += slicesPerTask) {
+        sliceRanges.append(RowRange_t(slice, qMin(slice + slicesPerTask, slices)));
+    }
+
+    const QList<QList<QPointF>> slicePoints = runScans(_threadPool ? _threadPool : QThreadPool::globalInstance(), sliceRanges, [&](const RowRange_t &sliceRange) {
+        QList<QPointF> taskPoints;
+        for (qint64 slice = sliceRange.first; slice < sliceRange.second; slice++) {
+            qint64 minRow = -1;
+            qint64 maxRow = -1;
+            double minValue = std::numeric_limits<double>::infinity();
+            double maxValue = -std::numeric_limits<double>::infinity();
+            visitValues(column.type, column.values, first + ((count * slice) / slices), first + ((count * (slice + 1)) / slices), [&](qint64 row, double value) {
+                if (value < minValue) {
+                    minValue = value;
+                    minRow = row;
+                }
+                if (value > maxValue) {
+                    maxValue = value;
+                    maxRow = row;
+                }
+            });
+
+            if (minRow < 0) {
+                continue;
+            }
+            if (minRow == maxRow) {
+                taskPoints.append(point(minRow, minValue));
+            } else if (minRow < maxRow) {
+                taskPoints.append(point(minRow, minValue));
+                taskPoints.append(point(maxRow, maxValue));
+            } else {
+                taskPoints.append(point(maxRow, maxValue));
+                taskPoints.append(point(minRow, minValue));
+            }
+        }
+        return taskPoints;
+    });
+
+    for (const QList<QPointF> &taskPoints : slicePoints) {
+        points.append(taskPoints);
+    }
+
+    return points;
+}
+
+QList<QPointF> LogColumnStore::resample(const QString &topic, const QString &field, double t0, double t1, double interval, Aggregate aggregate) const
+{
+    QList<QPointF> points;
+
+    Column_t column;
+    if (!_column(topic, field, column) || (t1 < t0) || !(interval > 0.)) {
+        return points;
+    }
+
+    const qint64 first = _lowerRow(column, _usecs(t0));
+    const qint64 last = _lowerRow(column, _usecs(t1) + 1);
+    if (first >= last) {
+        return points;
+    }
+
+    const qint64 originUsecs = _startUsecs + static_cast<qint64>(std::round(t0 * 1e6));
+    const qint64 intervalUsecs = qMax(qint64(1), static_cast<qint64>(std::round(interval * 1e6)));
+    const auto bucket = [&column, originUsecs, intervalUsecs](qint64 row) {
+        return (qFromLittleEndian(column.time[row]) - originUsecs) / intervalUsecs;
+    };
+
+    const qint64 firstBucket = bucket(first);
+    const qint64 bucketCount = bucket(last - 1) - firstBucket + 1;
+    if (bucketCount > kMaxBuckets) {
+        qCWarning(LogColumnStoreLog) << "Resampling" << topic << field << "would produce" << bucketCount << "points";
+        return points;
+    }
+
+    typedef struct {
+        qint64 firstBucket;
+        QList<Stats_t> buckets;
+    } Partial_t;
+
+    const QList<Partial_t> partials = runScans(_threadPool ? _threadPool : QThreadPool::globalInstance(), _split(first, last), [&](const RowRange_t &range) {
+        Partial_t partial{ bucket(range.first), {} };
+        partial.buckets.resize(bucket(range.second - 1) - partial.firstBucket + 1, emptyStats());
+
+        for (qint64 row = range.first; row < range.second;) {
+            const qint64 block = row / kBlockRows;
+            const qint64 blockEnd = qMin((block + 1) * kBlockRows, column.rows);
+            if ((row == (block * kBlockRows)) && (blockEnd <= range.second)) {
+                const qint64 blockBucket = bucket(row);
+                if (blockBucket == bucket(blockEnd - 1)) {
+                    mergeStats(partial.buckets[blockBucket - partial.firstBucket], column.blocks[block]);
+                    row = blockEnd;
+                    continue;
+                }
+            }
+
+            const qint64 end = qMin(blockEnd, range.second);
+            visitValues(column.type, column.values, row, end, [&](qint64 valueRow, double value) {
+                addValue(partial.buckets[bucket(valueRow) - partial.firstBucket], value);
+            });
+            row = end;
+        }
+
+        return partial;
+    });
+
+    QList<Stats_t> buckets(bucketCount, emptyStats());
+    for (const Partial_t &partial : partials) {
+        for (qsizetype i = 0; i < partial.buckets.size(); i++) {
+            mergeStats(buckets[partial.firstBucket - firstBucket + i], partial.buckets[i]);
+        }
+    }
+
+    for (qint64 i = 0; i < bucketCount; i++) {
+        if (buckets[i].count > 0) {
+            points.append(QPointF(t0 + ((firstBucket + i) * intervalUsecs / 1e6), statsValue(buckets[i], aggregate)));
+        }
+    }
+
+    return points;
+}
+
+double LogColumnStore::aggregate(const QString &topic, const QString &field, double t0, double t1, Aggregate aggregate) const
+{
+    Column_t column;
+    if (!_column(topic, field, column) || (t1 < t0)) {
+        return statsValue(emptyStats(), aggregate);
+    }
+
+    const qint64 first = _lowerRow(column, _usecs(t0));
+    const qint64 last = _lowerRow(column, _usecs(t1) + 1);
+
+    const QList<Stats_t> partials = runScans(_threadPool ? _threadPool : QThreadPool::globalInstance(), _split(first, last), [&column](const RowRange_t &range) {
+        Stats_t stats = emptyStats();
+        for (qint64 row = range.first; row < range.second;) {
+            const qint64 block = row / kBlockRows;
+            const qint64 blockEnd = qMin((block + 1) * kBlockRows, column.rows);
+            if ((row == (block * kBlockRows)) && (blockEnd <= range.second)) {
+                mergeStats(stats, column.blocks[block]);
+            } else {
+                visitValues(column.type, column.values, row, qMin(blockEnd, range.second), [&stats](qint64, double value) {
+                    addValue(stats, value);
+                });
+            }
+            row = qMin(blockEnd, range.second);
+        }
+        return stats;
+    });
+
+    Stats_t stats = emptyStats();
+    for (const Stats_t &partial : partials) {
+        mergeStats(stats, partial);
+    }
+
+    return statsValue(stats, aggregate);
+}
+
+QList<QPointF> LogColumnStore::binned(const QString &xTopic, const QString &xField, const QString &yTopic, const QString &yField, double binWidth, Aggregate aggregate) const
+{
+    QList<QPointF> points;
+
+    Column_t xColumn;
+    Column_t yColumn;
+    if (!_column(xTopic, xField, xColumn) || !_column(yTopic, yField, yColumn) || !(binWidth > 0.)) {
+        return points;
+    }
+
+    // The block stats give the x range without a scan
+    Stats_t xStats = emptyStats();
+    for (qint64 block = 0; block < ((xColumn.rows + kBlockRows - 1) / kBlockRows); block++) {
+        mergeStats(xStats, xColumn.blocks[block]);
+    }
+    if (xStats.count == 0) {
+        return points;
+    }
+
+    const double binOrigin = std::floor(xStats.min / binWidth) * binWidth;
+    const double binCountValue = std::floor((xStats.max - binOrigin) / binWidth) + 1.;
+    if (!(binCountValue <= kMaxBuckets)) {
+        qCWarning(LogColumnStoreLog) << "Binning" << yTopic << yField << "would produce" << binCountValue << "points";
+        return points;
+    }
+    const qint64 binCount = static_cast<qint64>(binCountValue);
+
+    const QList<QList<Stats_t>> partials = runScans(_threadPool ? _threadPool : QThreadPool::globalInstance(), _split(0, yColumn.rows), [&](const RowRange_t &range) {
+        QList<Stats_t> bins(binCount, emptyStats());
+
+        // Latest x sample at or before the first y sample, then walk both forward
+        const qint64 firstTime = qFromLittleEndian(yColumn.time[range.first]);
+        qint64 xRow = (std::upper_bound(xColumn.time, xColumn.time + xColumn.rows, firstTime, [](qint64 value, const qint64 &time) {
+            return value < qFromLittleEndian(time);
+        }) - xColumn.time) - 1;
+
+        visitValues(yColumn.type, yColumn.values, range.first, range.second, [&](qint64 row, double value) {
+            const qint64 time = qFromLittleEndian(yColumn.time[row]);
+            while (((xRow + 1) < xColumn.rows) && (qFromLittleEndian(xColumn.time[xRow + 1]) <= time)) {
+                xRow++;
+            }
+            if (xRow < 0) {
+                return;
+            }
+
+            const double x = valueAt(xColumn.type, xColumn.values, xRow);
+            if (std::isnan(x)) {
+                return;
+            }
+            const qint64 bin = qBound(qint64(0), static_cast<qint64>(std::floor((x - binOrigin) / binWidth)), binCount - 1);
+            addValue(bins[bin], value);
+        });
+
+        return bins;
+    });
+
+    QList<Stats_t> bins(binCount, emptyStats());
+    for (const QList<Stats_t> &partial : partials) {
+        for (qint64 bin = 0; bin < binCount; bin++) {
+            mergeStats(bins[bin], partial[bin]);
+        }
+    }
+
+    for (qint64 bin = 0; bin < binCount; bin++) {
+        if (bins[bin].count > 0) {
+            points.append(QPointF(binOrigin + ((bin + 0.5) * binWidth), statsValue(bins[bin], aggregate)));
+        }
+    }
+
+    return points;
+}
+
+LogColumnStore::Stats_t LogColumnStore::emptyStats()
+{
+    return Stats_t{ 0, std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(), 0., 0. };
+}
+
+void LogColumnStore::addValue(Stats_t &stats, double value)
+{
+    if (std::isnan(value)) {
+        return;
+    }
+
+    stats.count++;
+    stats.min = qMin(stats.min, value);
+    stats.max = qMax(stats.max, value);
+    stats.sum += value;
+    stats.sumSquares += value * value;
+}
+
+void LogColumnStore::mergeStats(Stats_t &stats, const Stats_t &other)
+{
+    if (other.count == 0) {
+        return;
+    }
+
+    stats.count += other.count;
+    stats.min = qMin(stats.min, other.min);
+    stats.max = qMax(stats.max, other.max);
+    stats.sum += other.sum;
+    stats.sumSquares += other.sumSquares;
+}
+
+double LogColumnStore::statsValue(const Stats_t &stats, Aggregate aggregate)
+{
+    switch (aggregate) {
+    case AggregateCount:
+        return stats.count;
+    case AggregateSum:
+        return stats.sum;
+    default:
+        break;
+    }
+
+    if (stats.count == 0) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    switch (aggregate) {
+    case AggregateMean:
+        return stats.sum / stats.count;
+    case AggregateMin:
+        return stats.min;
+    case AggregateMax:
+        return stats.max;
+    case AggregateRms:
+        return std::sqrt(stats.sumSquares / stats.count);
+    default:
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+}
@@ -0,0 +1,156 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "ULogReader.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QMutex>
+#include <QtCore/QPointF>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+#include <memory>
+
+class QThreadPool;
+
+Q_DECLARE_LOGGING_CATEGORY(LogColumnStoreLog)
+
+/// On-disk columnar cache of a ULog or tlog, and the queries the Analyze view charts run against it.
+/// build() ingests a log once: every topic (ULog) or message (tlog) gets a time column sorted by timestamp plus one
+/// typed column per scalar field, split into blocks of kBlockRows with the count, min, max, sum and sum of squares
+/// of each block stored alongside. open() maps columns in only when a query first needs them. Queries find their
+/// rows by binary search on the time column, scan on a thread pool and take whole blocks from the block stats
+/// wherever a block falls into a single output bucket, so hour-long, kHz-rate topics resample in milliseconds.
+class LogColumnStore
+{
+public:
+    enum Aggregate {
+        AggregateMean,
+        AggregateMin,
+        AggregateMax,
+        AggregateRms,
+        AggregateSum,
+        AggregateCount
+    };
+
+    /// Accumulated values of a block, bucket or range. NaN values are not counted.
+    typedef struct {
+        qint64 count;
+        double min;
+        double max;
+        double sum;
+        double sumSquares;
+    } Stats_t;
+
+    LogColumnStore();
+    ~LogColumnStore();
+
+    /// Ingests a ULog (.ulg) or tlog (anything else) into cacheDirectory, replacing whatever was there
+    ///     @return false if failed, errorMessage set
+    static bool build(const QString &logFile, const QString &cacheDirectory, QString &errorMessage, QThreadPool *threadPool = nullptr);
+
+    /// Cache directory below cacheRoot for a log. It changes with the log's path, size and modification time, so a
+    /// log which has been replaced is ingested again.
+    static QString cacheDirectory(const QString &logFile, const QString &cacheRoot);
+
+    /// Opens a cache written by build()
+    ///     @return false if failed, errorMessage set
+    bool open(const QString &cacheDirectory, QString &errorMessage);
+    void close();
+    bool isOpen() const { return !_topics.isEmpty(); }
+
+    /// Pool queries scan on, the global pool by default
+    void setThreadPool(QThreadPool *threadPool) { _threadPool = threadPool; }
+
+    /// ULog topic names, with "#<multi id>" appended for instances other than 0. tlog message names, with
+    /// "#<system id>:<component id>" appended unless they came from the vehicle's autopilot.
+    QStringList topics() const;
+    QStringList fields(const QString &topic) const;
+    qint64 rows(const QString &topic) const;
+
+    /// Seconds from the first to the last sample in the log. Query times are seconds from the first sample.
+    double duration() const { return (_endUsecs - _startUsecs) / 1e6; }
+
+    /// Samples between t0 and t1. Above maxPoints (if > 0) the range is split into maxPoints / 2 slices and only the
+    /// smallest and largest sample of each slice are returned, which keeps spikes visible.
+    QList<QPointF> range(const QString &topic, const QString &field, double t0, double t1, int maxPoints = 0) const;
+
+    /// One point per interval from t0 to t1 at the start of the interval, skipping intervals without samples
+    QList<QPointF> resample(const QString &topic, const QString &field, double t0, double t1, double interval, Aggregate aggregate) const;
+
+    /// The aggregate over [t0, t1], NaN if there are no samples
+    double aggregate(const QString &topic, const QString &field, double t0, double t1, Aggregate aggregate) const;
+
+    /// The y samples grouped by the latest x value at or before each of them, one point per non empty bin at the
+    /// centre of the bin. For example battery voltage binned by throttle.
+    QList<QPointF> binned(const QString &xTopic, const QString &xField, const QString &yTopic, const QString &yField, double binWidth, Aggregate aggregate) const;
+
+    static void addValue(Stats_t &stats, double value);
+    static void mergeStats(Stats_t &stats, const Stats_t &other);
+    static double statsValue(const Stats_t &stats, Aggregate aggregate);
+    static Stats_t emptyStats();
+
+    static constexpr int kCacheVersion = 1;
+    static constexpr qint64 kBlockRows = 4096;
+    static constexpr qint64 kParallelRows = 64 * 1024;          ///< Rows below which a query is scanned on the calling thread
+    static constexpr qint64 kMaxBuckets = 1000000;              ///< Resampling and binning refuse to produce more points
+    static constexpr qint64 kIngestPassBytes = 512 * 1024 * 1024; ///< Log bytes decoded per ULog ingest pass
+
+private:
+    /// A mapped column file
+    struct Mapping {
+        QFile file;
+        const uchar *data = nullptr;
+    };
+
+    typedef struct {
+        QString name;
+        ULogReader::FieldType type;
+        QString valuesFile;
+        QString blocksFile;
+    } Field_t;
+
+    typedef struct {
+        QString name;
+        qint64 rows;
+        QString timeFile;
+        QList<Field_t> fields;
+    } Topic_t;
+
+    /// Everything a scan needs, with the files mapped
+    typedef struct {
+        qint64 rows;
+        const qint64 *time;
+        ULogReader::FieldType type;
+        const uchar *values;
+        const Stats_t *blocks;
+    } Column_t;
+
+    const Topic_t *_topic(const QString &name) const;
+    bool _column(const QString &topic, const QString &field, Column_t &column) const;
+    const uchar *_map(const QString &fileName, qint64 size) const;
+    qint64 _usecs(double secs) const;
+    qint64 _lowerRow(const Column_t &column, qint64 usecs) const;
+    QList<QPair<qint64, qint64>> _split(qint64 first, qint64 last) const;
+
+    QString _directory;
+    qint64 _startUsecs = 0;
+    qint64 _endUsecs = 0;
+    QList<Topic_t> _topics;
+    QHash<QString, int> _topicIndex;
+    QThreadPool *_threadPool = nullptr;
+
+    mutable QMutex _mappingsMutex;
+    mutable QHash<QString, std::shared_ptr<Mapping>> _mappings;
+};
@@ -239,94 +239,98 @@ void LogDownloadController::_logData(uint32_t ofs, uint16_t id, uint8_t count, c
         return;
     }
 
-    bool result = false;
-    if (ofs <= _downloadData->entry->size()) {
-        const uint32_t chunk = ofs / LogDownloadData::kChunkSize;
-        // qCDebug(LogDownloadControllerLog) << "Received data - Offset:" << ofs << "Chunk:" << chunk;
-        if (chunk != _downloadData->current_chunk) {
-            qCWarning(LogDownloadControllerLog) << "Ignored packet for out of order chunk actual:expected" << chunk << _downloadData->current_chunk;
+    if ((ofs >= _downloadData->entry->size()) || (count == 0)) {
+        qCWarning(LogDownloadControllerLog) << "Received log offset greater than expected";
+        return;
+    }
+
+    // Data is accepted wherever it falls in the log, bins already on disk are only counted
+    const uint32_t bin = ofs / MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
+    if (!_downloadData->bins.testBit(bin)) {
+        if ((_downloadData->file.pos() != ofs) && !_downloadData->file.seek(ofs)) {
+            qCWarning(LogDownloadControllerLog) << "Error while seeking log file offset";
+            _downloadData->entry->setStatus(tr("Error"));
             return;
         }
 
-        const uint16_t bin = (ofs - (chunk * LogDownloadData::kChunkSize)) / MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
-        if (bin >= _downloadData->chunk_table.size()) {
-            qCWarning(LogDownloadControllerLog) << "Out of range bin received";
-        } else {
-            _downloadData->chunk_table.setBit(bin);
+        if (_downloadData->file.write(reinterpret_cast<const char*>(data), count) != count) {
+            qCWarning(LogDownloadControllerLog) << "Error while writing log file chunk";
+            _downloadData->entry->setStatus(tr("Error"));
+            return;
         }
 
-        if (_downloadData->file.pos() != ofs) {
-            if (!_downloadData->file.seek(ofs)) {
-                qCWarning(LogDownloadControllerLog) << "Error while seeking log file offset";
-                return;
-            }
-        }
+        (void) _downloadData->setBinReceived(bin);
+        _downloadData->written += count;
+        _downloadData->rate_bytes += count;
+    }
 
-        if (_downloadData->file.write(reinterpret_cast<const char*>(data), count)) {
-            _downloadData->written += count;
-            _downloadData->rate_bytes += count;
-            _updateDataRate();
-
-            result = true;
-            _retries = 0;
-
-            _timer->start(kTimeOutMs);
-            if (_logComplete()) {
-                _downloadData->entry->setStatus(tr("Downloaded"));
-                _receivedAllData();
-            } else if (_chunkComplete()) {
-                _downloadData->advanceChunk();
-                _requestLogData(_downloadData->ID,
-                                _downloadData->current_chunk * LogDownloadData::kChunkSize,
-                                _downloadData->chunk_table.size() * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN);
-            } else if ((bin < (_downloadData->chunk_table.size() - 1)) && _downloadData->chunk_table.at(bin + 1)) {
-                // Likely to be grabbing fragments and got to the end of a gap
-                _findMissingData();
-            }
-        } else {
-            qCWarning(LogDownloadControllerLog) << "Error while writing log file chunk";
-        }
-    } else {
-        qCWarning(LogDownloadControllerLog) << "Received log offset greater than expected";
+    _retries = 0;
+    _updateDataRate();
+
+    if (_downloadData->complete()) {
+        _finishDownload();
+        return;
     }
 
-    if (!result) {
-        _downloadData->entry->setStatus(tr("Error"));
+    if (_downloadData->stateSaved.elapsed() > LogDownloadData::kStateSaveMs) {
+        (void) _downloadData->saveState();
+    }
+
+    _timer->start(kTimeOutMs);
+
+    const uint32_t windowEnd = _downloadData->requestBin + _downloadData->requestBins;
+    if ((bin + 1) == windowEnd) {
+        // The vehicle has sent the whole window, whatever was lost is picked up by a later one
+        _downloadData->adaptWindow(false);
+        _requestNextWindow();
     }
 }
 
 void LogDownloadController::_findMissingData()
 {
-    if (_logComplete()) {
-        _receivedAllData();
+    if (_downloadData->complete()) {
+        _finishDownload();
         return;
     }
 
-    if (_chunkComplete()) {
-        _downloadData->advanceChunk();
-    }
-
+    // Nothing arrived for a while, the request or the end of the window was lost. Ask again from the first bin of
+    // the window still missing, with a smaller window.
     _retries++;
+    _downloadData->adaptWindow(true);
+    _downloadData->nextRequestBin = _downloadData->requestBin;
+    (void) _downloadData->saveState();
 
     _updateDataRate();
+    _requestNextWindow();
+}
 
-    uint16_t start = 0, end = 0;
-    const int size = _downloadData->chunk_table.size();
-    for (; start < size; start++) {
-        if (!_downloadData->chunk_table.testBit(start)) {
-            break;
-        }
+void LogDownloadController::_requestNextWindow()
+{
+    if (!_downloadData->nextWindow()) {
+        _finishDownload();
+        return;
     }
 
-    for (end = start; end < size; end++) {
-        if (_downloadData->chunk_table.testBit(end)) {
-            break;
-        }
+    _requestLogData(_downloadData->ID,
+                    _downloadData->requestBin * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN,
+                    _downloadData->requestBins * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN,
+                    _retries);
+    _timer->start(kTimeOutMs);
+}
+
+void LogDownloadController::_finishDownload()
+{
+    _timer->stop();
+
+    const QString fileName = _downloadData->finish();
+    if (fileName.isEmpty()) {
+        _downloadData->entry->setStatus(tr("Error"));
+    } else {
+        qCDebug(LogDownloadControllerLog) << "Downloaded" << fileName << "resumed bins" << _downloadData->resumedBins << "of" << _downloadData->bins.size();
+        _downloadData->entry->setStatus(tr("Downloaded"));
     }
 
-    const uint32_t pos = (_downloadData->current_chunk * LogDownloadData::kChunkSize) + (start * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN);
-    const uint32_t len = (end - start) * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
-    _requestLogData(_downloadData->ID, pos, len, _retries);
+    _receivedAllData();
 }
 
 void LogDownloadController::_updateDataRate()
@@ -346,22 +350,11 @@ void LogDownloadController::_updateDataRate()
     _downloadData->elapsed.start();
 }
 
-bool LogDownloadController::_chunkComplete() const
-{
-    return _downloadData->chunkEquals(true);
-}
-
-bool LogDownloadController::_logComplete() const
-{
-    return (_chunkComplete() && ((_downloadData->current_chunk + 1) == _downloadData->numChunks()));
-}
-
 void LogDownloadController::_receivedAllData()
 {
     _timer->stop();
     if (_prepareLogDownload()) {
-        _requestLogData(_downloadData->ID, 0, _downloadData->chunk_table.size() * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN);
-        _timer->start(kTimeOutMs);
+        _requestNextWindow();
     } else {
         _resetSelection();
         _setDownloading(false);
@@ -397,40 +390,17 @@ bool LogDownloadController::_prepareLogDownload()
         _downloadData->filename += ".bin";
     }
 
-    _downloadData->file.setFileName(_downloadPath + _downloadData->filename);
-
-    if (_downloadData->file.exists()) {
-        uint32_t numDups = 0;
-        const QStringList filename_spl = _downloadData->filename.split('.');
-        do {
-            numDups += 1;
-            const QString filename = filename_spl[0] + '_' + QString::number(numDups) + '.' + filename_spl[1];
-            _downloadData->file.setFileName(filename);
-        } while ( _downloadData->file.exists());
-    }
-
-    bool result = false;
-    if (!_downloadData->file.open(QIODevice::WriteOnly)) {
-        qCWarning(LogDownloadControllerLog) << "Failed to create log file:" <<  _downloadData->filename;
-    } else if (!_downloadData->file.resize(entry->size())) {
-        qCWarning(LogDownloadControllerLog) << "Failed to allocate space for log file:" <<  _downloadData->filename;
-    } else {
-        _downloadData->current_chunk = 0;
-        _downloadData->chunk_table = QBitArray(_downloadData->chunkBins(), false);
-        _downloadData->elapsed.start();
-        result = true;
+    if (!_downloadData->open(_downloadPath + _downloadData->filename)) {
+        _downloadData->entry->setStatus(tr("Error"));
+        _downloadData.reset();
+        return false;
     }
 
-    if (!result) {
-        if (_downloadData->file.exists()) {
-            (void) _downloadData->file.remove();
-        }
-
-        _downloadData->entry->setStatus(QStringLiteral("Error"));
-        _downloadData.reset();
+    if (_downloadData->resumedBins > 0) {
+        _downloadData->entry->setStatus(tr("Resuming"));
     }
 
-    return result;
+    return true;
 }
 
 void LogDownloadController::refresh()
@@ -462,11 +432,8 @@ void LogDownloadController::cancel()
     _receivedAllEntries();
 
     if (_downloadData) {
+        // The partial file is kept, downloading the log again resumes it
         _downloadData->entry->setStatus(QStringLiteral("Canceled"));
-        if (_downloadData->file.exists()) {
-            (void) _downloadData->file.remove();
-        }
-
         _downloadData.reset();
     }
 
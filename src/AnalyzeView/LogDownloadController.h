@@ -61,17 +61,17 @@ private slots:
     bool _getRequestingList() const { return _requestingLogEntries; }
     bool _getDownloadingLogs() const { return _downloadingLogs; }
 
-    bool _chunkComplete() const;
     bool _entriesComplete() const;
-    bool _logComplete() const;
     bool _prepareLogDownload();
     void _downloadToDirectory(const QString &dir);
     void _findMissingData();
     void _findMissingEntries();
+    void _finishDownload();
     void _receivedAllData();
     void _receivedAllEntries();
     void _requestLogData(uint16_t id, uint32_t offset, uint32_t count, int retryCount = 0);
     void _requestLogList(uint32_t start, uint32_t end);
+    void _requestNextWindow();
     void _requestLogEnd();
     void _resetSelection(bool canceled = false);
     void _setDownloading(bool active);
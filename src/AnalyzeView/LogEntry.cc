@@ -11,10 +11,18 @@
 #include "QGCApplication.h"
 #include "QGCLoggingCategory.h"
 
-#include <QtCore/QtMath>
+#include <QtCore/QDataStream>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
 
 QGC_LOGGING_CATEGORY(LogEntryLog, "test.analyzeview.logentry")
 
+namespace {
+    constexpr quint32 kStateMagic = 0x51474C44; // "QGLD"
+    constexpr qint32 kStateVersion = 1;
+}
+
 LogDownloadData::LogDownloadData(QGCLogEntry * const entry)
     : ID(entry->id())
     , entry(entry)
@@ -24,30 +32,218 @@ LogDownloadData::LogDownloadData(QGCLogEntry * const entry)
 
 LogDownloadData::~LogDownloadData()
 {
+    // Whatever stops the download, what has been received so far is kept for the next attempt
+    if (file.isOpen()) {
+        (void) saveState();
+    }
+
     // qCDebug(LogEntryLog) << Q_FUNC_INFO << this;
 }
 
-void LogDownloadData::advanceChunk()
+bool LogDownloadData::open(const QString &fileName)
 {
-    ++current_chunk;
-    chunk_table = QBitArray(chunkBins(), false);
+    finalFileName = fileName;
+    file.setFileName(fileName + QLatin1String(kPartialSuffix));
+
+    bins = QBitArray(numBins(entry->size()), false);
+    receivedBins = 0;
+    if (file.exists() && _loadState()) {
+        resumedBins = receivedBins;
+        written = qMin(receivedBins * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN, entry->size());
+        qCDebug(LogEntryLog) << "Resuming" << file.fileName() << "with" << written << "of" << entry->size() << "bytes";
+    } else {
+        (void) QFile::remove(_stateFileName());
+    }
+
+    // ReadWrite keeps the data of a resumed download
+    if (!file.open(QIODevice::ReadWrite)) {
+        qCWarning(LogEntryLog) << "Failed to open log file:" << file.fileName() << file.errorString();
+        return false;
+    }
+
+    if ((file.size() != entry->size()) && !file.resize(entry->size())) {
+        qCWarning(LogEntryLog) << "Failed to allocate space for log file:" << file.fileName() << file.errorString();
+        return false;
+    }
+
+    nextRequestBin = 0;
+    elapsed.start();
+    stateSaved.start();
+
+    return true;
 }
 
-uint32_t LogDownloadData::chunkBins() const
+bool LogDownloadData::setBinReceived(uint32_t bin)
 {
-    const qreal num = static_cast<qreal>((entry->size() - (current_chunk * kChunkSize))) / static_cast<qreal>(MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN);
-    return qMin(static_cast<uint32_t>(qCeil(num)), kTableBins);
+    if (bins.testBit(bin)) {
+        return false;
+    }
+
+    bins.setBit(bin);
+    receivedBins++;
+    stateDirty = true;
+
+    if ((bin >= requestBin) && (bin < (requestBin + requestBins))) {
+        requestReceived++;
+    }
+
+    return true;
 }
 
-uint32_t LogDownloadData::numChunks() const
+bool LogDownloadData::nextWindow()
 {
-    const qreal num = static_cast<qreal>(entry->size()) / static_cast<qreal>(kChunkSize);
-    return qCeil(num);
+    const uint32_t totalBins = bins.size();
+    if (complete() || (totalBins == 0)) {
+        return false;
+    }
+
+    // Skip whole bytes of received bins, the bitmap of a large log has millions of bits
+    const auto firstMissing = [this, totalBins](uint32_t from) -> qint64 {
+        const uchar *const bits = reinterpret_cast<const uchar*>(bins.bits());
+        uint32_t bin = from;
+        while (bin < totalBins) {
+            if (((bin % 8) == 0) && (bits[bin / 8] == 0xFF)) {
+                bin += 8;
+                continue;
+            }
+            if (!bins.testBit(bin)) {
+                return bin;
+            }
+            bin++;
+        }
+        return -1;
+    };
+
+    qint64 start = firstMissing(nextRequestBin);
+    if (start < 0) {
+        start = firstMissing(0);
+    }
+    if (start < 0) {
+        return false;
+    }
+
+    uint32_t end = start;
+    while ((end < totalBins) && !bins.testBit(end) && ((end - start) < windowBins)) {
+        end++;
+    }
+
+    requestBin = start;
+    requestBins = end - start;
+    requestReceived = 0;
+    nextRequestBin = (end < totalBins) ? end : 0;
+
+    return true;
+}
+
+void LogDownloadData::adaptWindow(bool timedOut)
+{
+    const qreal loss = (requestBins > 0) ? (1. - (static_cast<qreal>(requestReceived) / requestBins)) : 0.;
+
+    if (timedOut || (loss > kShrinkLoss)) {
+        windowBins = qMax(kMinWindowBins, windowBins / 2);
+    } else if (loss < kGrowLoss) {
+        windowBins = qMin(kMaxWindowBins, windowBins * 2);
+    }
+
+    if (rate_avg > 0.) {
+        const uint32_t rateBins = static_cast<uint32_t>((rate_avg * kMaxWindowSecs) / MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN);
+        windowBins = qMin(windowBins, qMax(kMinWindowBins, rateBins));
+    }
+
+    qCDebug(LogEntryLog) << "Window" << requestBin << requestBins << "loss" << loss << (timedOut ? "timed out" : "") << "next window" << windowBins;
+}
+
+bool LogDownloadData::saveState()
+{
+    if (!stateDirty) {
+        return true;
+    }
+
+    // Data first, the bitmap must never claim bins which are not on disk
+    if (!file.flush()) {
+        qCWarning(LogEntryLog) << "Failed to flush log file:" << file.fileName() << file.errorString();
+        return false;
+    }
+
+    QSaveFile stateFile(_stateFileName());
+    if (!stateFile.open(QIODevice::WriteOnly)) {
+        qCWarning(LogEntryLog) << "Failed to save download state:" << stateFile.fileName() << stateFile.errorString();
+        return false;
+    }
+
+    QDataStream stream(&stateFile);
+    stream << kStateMagic << kStateVersion << static_cast<quint32>(ID) << static_cast<quint32>(entry->size()) << entry->time().toSecsSinceEpoch() << bins;
+    if ((stream.status() != QDataStream::Ok) || !stateFile.commit()) {
+        qCWarning(LogEntryLog) << "Failed to save download state:" << stateFile.fileName() << stateFile.errorString();
+        return false;
+    }
+
+    stateDirty = false;
+    stateSaved.start();
+
+    return true;
+}
+
+bool LogDownloadData::_loadState()
+{
+    QFile stateFile(_stateFileName());
+    if (!stateFile.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&stateFile);
+    quint32 magic = 0;
+    qint32 version = 0;
+    quint32 id = 0;
+    quint32 size = 0;
+    qint64 timeUTC = 0;
+    QBitArray savedBins;
+    stream >> magic >> version >> id >> size >> timeUTC >> savedBins;
+
+    if ((stream.status() != QDataStream::Ok) || (magic != kStateMagic) || (version != kStateVersion)) {
+        qCWarning(LogEntryLog) << "Ignoring unreadable download state:" << stateFile.fileName();
+        return false;
+    }
+
+    if ((id != ID) || (size != entry->size()) || (timeUTC != entry->time().toSecsSinceEpoch()) || (savedBins.size() != bins.size())) {
+        qCDebug(LogEntryLog) << "Download state belongs to a different log:" << stateFile.fileName();
+        return false;
+    }
+
+    bins = savedBins;
+    receivedBins = savedBins.count(true);
+
+    return true;
+}
+
+QString LogDownloadData::finish()
+{
+    const QString stateFileName = _stateFileName();
+    file.close();
+
+    QString fileName = finalFileName;
+    if (QFile::exists(fileName)) {
+        const QFileInfo fileInfo(finalFileName);
+        uint32_t numDups = 0;
+        do {
+            numDups++;
+            fileName = fileInfo.dir().filePath(fileInfo.completeBaseName() + '_' + QString::number(numDups) + '.' + fileInfo.suffix());
+        } while (QFile::exists(fileName));
+    }
+
+    if (!file.rename(fileName)) {
+        qCWarning(LogEntryLog) << "Failed to rename" << file.fileName() << "to" << fileName << file.errorString();
+        return QString();
+    }
+
+    (void) QFile::remove(stateFileName);
+
+    return fileName;
 }
 
-bool LogDownloadData::chunkEquals(const bool val) const
+uint32_t LogDownloadData::numBins(uint32_t logSize)
 {
-    return (chunk_table == QBitArray(chunk_table.size(), val));
+    return (logSize + MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN - 1) / MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
 }
 
 /*===========================================================================*/
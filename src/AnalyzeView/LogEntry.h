@@ -12,6 +12,7 @@
 #include <QtCore/QBitArray>
 #include <QtCore/QDateTime>
 #include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QObject>
 #include <QtCore/QString>
@@ -23,36 +24,78 @@ class QGCLogEntry;
 
 Q_DECLARE_LOGGING_CATEGORY(LogEntryLog)
 
+/// One log being downloaded. LOG_DATA packets are written wherever they belong in a sparse file as they arrive, in
+/// any order, and a bitmap over the whole log records which MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN bins have been
+/// received. The vehicle serves one LOG_REQUEST_DATA at a time, so data is requested as a window of missing bins,
+/// sized from the measured rate and loss of the previous windows. The bitmap is saved next to the partial file so a
+/// download which is interrupted picks up where it left off the next time the log is downloaded.
 struct LogDownloadData
 {
     explicit LogDownloadData(QGCLogEntry * const entry);
     ~LogDownloadData();
 
-    void advanceChunk();
+    /// Opens the partial file for fileName, resuming it if the saved state belongs to the same log
+    bool open(const QString &fileName);
 
-    /// The number of MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN bins in the current chunk
-    uint32_t chunkBins() const;
+    /// Marks a bin received
+    ///     @return false if it had been received already
+    bool setBinReceived(uint32_t bin);
 
-    /// The number of kChunkSize chunks in the file
-    uint32_t numChunks() const;
+    bool complete() const { return (receivedBins == static_cast<uint32_t>(bins.size())); }
 
-    /// True if all bins in the chunk have been set to val
-    bool chunkEquals(const bool val) const;
+    /// Picks the next window: the first run of missing bins at or after nextRequestBin, wrapping around to fill the
+    /// gaps left behind, at most windowBins long
+    ///     @return false if nothing is missing
+    bool nextWindow();
+
+    /// Grows or shrinks windowBins after a window ended or timed out
+    void adaptWindow(bool timedOut);
+
+    /// Flushes the data written so far and saves the bitmap
+    bool saveState();
+
+    /// Closes the partial file and moves it to its final name, appending a number if that is taken
+    ///     @return the final file name, empty on failure
+    QString finish();
+
+    /// The number of MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN bins in a log of the given size
+    static uint32_t numBins(uint32_t logSize);
 
     uint ID = 0;
     QGCLogEntry *const entry = nullptr;
 
-    QBitArray chunk_table;
-    uint32_t current_chunk = 0;
+    QBitArray bins;
+    uint32_t receivedBins = 0;
+    uint32_t resumedBins = 0;               ///< Bins already on disk from an earlier session
     QFile file;
     QString filename;
+    QString finalFileName;
     uint written = 0;
     size_t rate_bytes = 0;
     qreal rate_avg = 0.;
     QElapsedTimer elapsed;
+    QElapsedTimer stateSaved;
+    bool stateDirty = false;
+
+    uint32_t windowBins = kInitialWindowBins;
+    uint32_t requestBin = 0;                ///< First bin of the current window
+    uint32_t requestBins = 0;
+    uint32_t requestReceived = 0;           ///< New bins received inside the current window
+    uint32_t nextRequestBin = 0;
+
+    static constexpr uint32_t kInitialWindowBins = 512;
+    static constexpr uint32_t kMinWindowBins = 32;
+    static constexpr uint32_t kMaxWindowBins = 64 * 1024;  ///< About 5.9 MB
+    static constexpr qreal kMaxWindowSecs = 5.;             ///< At the measured rate, so a lost request costs little
+    static constexpr qreal kGrowLoss = 0.02;
+    static constexpr qreal kShrinkLoss = 0.3;               ///< Random loss is refetched later, only heavy loss shrinks the window
+    static constexpr uint32_t kStateSaveMs = 2000;
+    static constexpr const char *kPartialSuffix = ".partial";
+    static constexpr const char *kStateSuffix = ".state";
 
-    static constexpr uint32_t kTableBins = 512;
-    static constexpr uint32_t kChunkSize = kTableBins * MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN;
+private:
+    bool _loadState();
+    QString _stateFileName() const { return file.fileName() + QLatin1String(kStateSuffix); }
 };
 
 /*===========================================================================*/
@@ -0,0 +1,135 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TelemetryLatencyController.h"
+#include "TelemetryTracer.h"
+#include "QGCLoggingCategory.h"
+
+#include <algorithm>
+#include <functional>
+
+QGC_LOGGING_CATEGORY(TelemetryLatencyControllerLog, "qgc.analyzeview.telemetrylatencycontroller")
+
+namespace {
+    template<typename Key>
+    QVariantList buildRows(const QHash<Key, TelemetryTracer::StageHistograms_t> &histograms, const std::function<QString(Key)> &name)
+    {
+        QList<Key> keys = histograms.keys();
+        std::sort(keys.begin(), keys.end());
+
+        QVariantList rows;
+        rows.reserve(keys.size());
+        for (const Key key : keys) {
+            const TelemetryTracer::StageHistograms_t &stages = *histograms.constFind(key);
+
+            QVariantList stageValues;
+            for (const LatencyHistogram &histogram : stages) {
+                stageValues.append(QVariant(QVariantList{
+                    histogram.valueAtPercentile(50.),
+                    histogram.valueAtPercentile(90.),
+                    histogram.valueAtPercentile(99.),
+                    histogram.max(),
+                }));
+            }
+
+            QVariantMap row;
+            row[QStringLiteral("key")] = static_cast<qulonglong>(key);
+            row[QStringLiteral("name")] = name(key);
+            row[QStringLiteral("count")] = stages[TelemetryTracer::StageParse].count();
+            row[QStringLiteral("stages")] = stageValues;
+            rows.append(row);
+        }
+
+        return rows;
+    }
+}
+
+TelemetryLatencyController::TelemetryLatencyController(QObject *parent)
+    : QObject(parent)
+{
+    // qCDebug(TelemetryLatencyControllerLog) << Q_FUNC_INFO << this;
+
+    _updateTimer.setInterval(kUpdateIntervalMsecs);
+    (void) connect(&_updateTimer, &QTimer::timeout, this, &TelemetryLatencyController::_updateRows);
+    (void) connect(TelemetryTracer::instance(), &TelemetryTracer::enabledChanged, this, [this](bool enabled) {
+        if (enabled) {
+            _updateTimer.start();
+        } else {
+            _updateTimer.stop();
+            _updateRows();
+        }
+        emit tracingChanged(enabled);
+    });
+
+    if (tracing()) {
+        _updateTimer.start();
+    }
+    _updateRows();
+}
+
+TelemetryLatencyController::~TelemetryLatencyController()
+{
+    // qCDebug(TelemetryLatencyControllerLog) << Q_FUNC_INFO << this;
+}
+
+bool TelemetryLatencyController::tracing() const
+{
+    return TelemetryTracer::enabled();
+}
+
+void TelemetryLatencyController::setTracing(bool tracing)
+{
+    TelemetryTracer::instance()->setEnabled(tracing);
+}
+
+void TelemetryLatencyController::setGroupByVehicle(bool groupByVehicle)
+{
+    if (groupByVehicle != _groupByVehicle) {
+        _groupByVehicle = groupByVehicle;
+        emit groupByVehicleChanged(_groupByVehicle);
+        _updateRows();
+    }
+}
+
+QStringList TelemetryLatencyController::stageNames() const
+{
+    QStringList names;
+    for (int stage = 0; stage < TelemetryTracer::StageCount; stage++) {
+        names.append(TelemetryTracer::stageName(static_cast<TelemetryTracer::Stage_t>(stage)));
+    }
+    return names;
+}
+
+void TelemetryLatencyController::reset()
+{
+    TelemetryTracer::instance()->reset();
+    _updateRows();
+}
+
+bool TelemetryLatencyController::exportChromeTrace(const QString &filename)
+{
+    return TelemetryTracer::instance()->exportChromeTrace(filename);
+}
+
+void TelemetryLatencyController::_updateRows()
+{
+    const TelemetryTracer *const tracer = TelemetryTracer::instance();
+
+    if (_groupByVehicle) {
+        _rows = buildRows<uint8_t>(tracer->vehicleHistograms(), [](uint8_t systemId) {
+            return tr("Vehicle %1").arg(systemId);
+        });
+    } else {
+        _rows = buildRows<uint32_t>(tracer->messageHistograms(), [](uint32_t messageId) {
+            return TelemetryTracer::messageName(messageId);
+        });
+    }
+
+    emit rowsChanged();
+}
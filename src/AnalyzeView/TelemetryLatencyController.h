@@ -0,0 +1,65 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QTimer>
+#include <QtCore/QVariantList>
+#include <QtQmlIntegration/QtQmlIntegration>
+
+Q_DECLARE_LOGGING_CATEGORY(TelemetryLatencyControllerLog)
+
+/// Controller for TelemetryLatencyPage.qml. Presents the TelemetryTracer histograms as a table.
+class TelemetryLatencyController : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+
+    Q_PROPERTY(bool         tracing         READ tracing        WRITE setTracing        NOTIFY tracingChanged)
+    Q_PROPERTY(bool         groupByVehicle  READ groupByVehicle WRITE setGroupByVehicle NOTIFY groupByVehicleChanged)
+    Q_PROPERTY(QStringList  stageNames      READ stageNames                             CONSTANT)
+    Q_PROPERTY(QVariantList rows            READ rows                                   NOTIFY rowsChanged)
+
+public:
+    explicit TelemetryLatencyController(QObject *parent = nullptr);
+    ~TelemetryLatencyController();
+
+    /// Clears all collected latencies
+    Q_INVOKABLE void reset();
+
+    /// Writes the recent message trace as Chrome trace event JSON, which chrome://tracing and Perfetto UI can open
+    Q_INVOKABLE bool exportChromeTrace(const QString &filename);
+
+    bool tracing() const;
+    bool groupByVehicle() const { return _groupByVehicle; }
+    QStringList stageNames() const;
+
+    /// One map per message id or vehicle: key, name, count and for each stage a list of p50, p90, p99, max in usecs
+    QVariantList rows() const { return _rows; }
+
+    void setTracing(bool tracing);
+    void setGroupByVehicle(bool groupByVehicle);
+
+signals:
+    void tracingChanged(bool tracing);
+    void groupByVehicleChanged(bool groupByVehicle);
+    void rowsChanged();
+
+private slots:
+    void _updateRows();
+
+private:
+    QTimer _updateTimer;
+    bool _groupByVehicle = false;
+    QVariantList _rows;
+
+    static constexpr int kUpdateIntervalMsecs = 1000;
+};
@@ -0,0 +1,137 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+import QtQuick
+import QtQuick.Controls
+import QtQuick.Layouts
+
+import QGroundControl
+import QGroundControl.Controls
+import QGroundControl.ScreenTools
+
+AnalyzePage {
+    pageComponent: pageComponent
+    pageDescription: qsTr("Measures how long received telemetry takes from the link to the display. Each column is the latency from the link read to the end of that stage, shown as p50 / p90 / p99 / max in milliseconds.")
+
+    readonly property real _margin:         ScreenTools.defaultFontPixelWidth
+    readonly property real _nameWidth:      ScreenTools.defaultFontPixelWidth * 28
+    readonly property real _countWidth:     ScreenTools.defaultFontPixelWidth * 10
+    readonly property real _stageWidth:     ScreenTools.defaultFontPixelWidth * 26
+
+    TelemetryLatencyController {
+        id: latencyController
+    }
+
+    function _formatStage(values) {
+        return values.map(usecs => (usecs / 1000).toFixed(2)).join(" / ")
+    }
+
+    Component {
+        id: pageComponent
+
+        ColumnLayout {
+            width:      availableWidth
+            height:     availableHeight
+            spacing:    _margin
+
+            RowLayout {
+                spacing: _margin
+
+                QGCCheckBox {
+                    text:       qsTr("Enable tracing")
+                    checked:    latencyController.tracing
+                    onClicked:  latencyController.tracing = checked
+                }
+
+                QGCCheckBox {
+                    text:       qsTr("Group by vehicle")
+                    checked:    latencyController.groupByVehicle
+                    onClicked:  latencyController.groupByVehicle = checked
+                }
+
+                QGCButton {
+                    text:       qsTr("Reset")
+                    onClicked:  latencyController.reset()
+                }
+
+                QGCButton {
+                    text:       qsTr("Export Trace")
+                    onClicked:  exportDialog.openForSave()
+
+                    QGCFileDialog {
+                        id:             exportDialog
+                        folder:         QGroundControl.settingsManager.appSettings.logSavePath
+                        nameFilters:    [qsTr("Trace files (*.json)"), qsTr("All Files (*)")]
+                        defaultSuffix:  "json"
+                        title:          qsTr("Select trace save file")
+                        onAcceptedForSave: (file) => {
+                            if (!latencyController.exportChromeTrace(file)) {
+                                mainWindow.showMessageDialog(title, qsTr("Unable to write trace file %1").arg(file))
+                            }
+                            close()
+                        }
+                    }
+                }
+            }
+
+            Row {
+                QGCLabel {
+                    width:      _nameWidth
+                    text:       latencyController.groupByVehicle ? qsTr("Vehicle") : qsTr("Message")
+                    font.bold:  true
+                }
+
+                QGCLabel {
+                    width:      _countWidth
+                    text:       qsTr("Count")
+                    font.bold:  true
+                }
+
+                Repeater {
+                    model: latencyController.stageNames
+
+                    QGCLabel {
+                        width:      _stageWidth
+                        text:       modelData
+                        font.bold:  true
+                    }
+                }
+            }
+
+            QGCListView {
+                model:              latencyController.rows
+                clip:               true
+                Layout.fillWidth:   true
+                Layout.fillHeight:  true
+
+                delegate: Row {
+                    QGCLabel {
+                        width:  _nameWidth
+                        text:   modelData.name
+                        elide:  Text.ElideRight
+                    }
+
+                    QGCLabel {
+                        width:  _countWidth
+                        text:   modelData.count
+                    }
+
+                    Repeater {
+                        model: modelData.stages
+
+                        QGCLabel {
+                            width:  _stageWidth
+                            text:   modelData[0] === 0 && modelData[3] === 0 ? "-" : _formatStage(modelData)
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
@@ -8,66 +8,80 @@
  ****************************************************************************/
 
 #include "ULogParser.h"
+#include "ULogReader.h"
 #include "QGCLoggingCategory.h"
 
 #include <QtCore/QByteArray>
 #include <QtCore/QString>
 
-#include <ulog_cpp/data_container.hpp>
-#include <ulog_cpp/reader.hpp>
-
-using namespace ulog_cpp;
+#include <cmath>
 
 QGC_LOGGING_CATEGORY(ULogParserLog, "qgc.analyzeview.ulogparser")
 
 namespace ULogParser {
 
-bool getTagsFromLog(const QByteArray &log, QList<GeoTagWorker::CameraFeedbackPacket> &cameraFeedback, QString &errorMessage)
+static bool _getTags(ULogReader &reader, QList<GeoTagWorker::CameraFeedbackPacket> &cameraFeedback, QString &errorMessage)
 {
-    errorMessage.clear();
-
-    std::shared_ptr<DataContainer> data = std::make_shared<DataContainer>(DataContainer::StorageConfig::FullLog);
-    Reader parser(data);
-    parser.readChunk(reinterpret_cast<const uint8_t*>(log.constData()), log.size());
-
-    if (!data->parsingErrors().empty()) {
-        for (const std::string &parsing_error : data->parsingErrors()) {
-            (void) errorMessage.append(parsing_error);
-            (void) errorMessage.append(", ");
-        }
-    }
-
-    if (data->hadFatalError()) {
-        errorMessage = QStringLiteral("Could not parse ULog");
+    static const QStringList requiredFields = {
+        QStringLiteral("timestamp"),
+        QStringLiteral("timestamp_utc"),
+        QStringLiteral("seq"),
+        QStringLiteral("lat"),
+        QStringLiteral("lon"),
+        QStringLiteral("alt"),
+        QStringLiteral("ground_distance"),
+        QStringLiteral("result")
+    };
+    static const QStringList attitudeFields = {
+        QStringLiteral("q[0]"),
+        QStringLiteral("q[1]"),
+        QStringLiteral("q[2]"),
+        QStringLiteral("q[3]")
+    };
+
+    reader.subscribe(QStringLiteral("camera_capture"), requiredFields + attitudeFields);
+    if (!reader.read(errorMessage)) {
         return false;
     }
 
-    if (!data->isHeaderComplete()) {
-        errorMessage = QStringLiteral("Could not parse ULog header");
-        return false;
-    }
+    const ULogReader::Topic_t *const topic = reader.topic(QStringLiteral("camera_capture"));
+    if (topic) {
+        QList<int> columns;
+        for (const QString &field : requiredFields) {
+            columns.append(ULogReader::fieldIndex(*topic, field));
+        }
+        QList<int> attitudeColumns;
+        for (const QString &field : attitudeFields) {
+            attitudeColumns.append(ULogReader::fieldIndex(*topic, field));
+        }
 
-    const std::set<std::string> subscription_names = data->subscriptionNames();
-    if (subscription_names.find("camera_capture") != subscription_names.end()) {
-        const std::shared_ptr<Subscription> subscription = data->subscription("camera_capture");
-        for (const TypedDataView &sample : *subscription) {
-            GeoTagWorker::CameraFeedbackPacket feedback = {0};
-
-            try {
-                feedback.timestamp = sample.at("timestamp").as<uint64_t>() / 1.0e6; // to seconds
-                feedback.timestampUTC = sample.at("timestamp_utc").as<uint64_t>() / 1.0e6; // to seconds
-                feedback.imageSequence = sample.at("seq").as<uint32_t>();
-                feedback.latitude = sample.at("lat").as<double>();
-                feedback.longitude = sample.at("lon").as<double>();
+        if (columns.contains(-1)) {
+            qCDebug(ULogParserLog) << Q_FUNC_INFO << "camera_capture is missing fields";
+        } else {
+            const auto value = [topic](int column, qsizetype row) {
+                return ULogReader::value(topic->columns[column], row);
+            };
+
+            cameraFeedback.reserve(topic->rows);
+            for (qsizetype row = 0; row < topic->rows; row++) {
+                GeoTagWorker::CameraFeedbackPacket feedback;
+
+                feedback.timestamp = value(columns[0], row) / 1.0e6; // to seconds
+                feedback.timestampUTC = value(columns[1], row) / 1.0e6; // to seconds
+                feedback.imageSequence = static_cast<uint32_t>(value(columns[2], row));
+                feedback.latitude = value(columns[3], row);
+                feedback.longitude = value(columns[4], row);
                 feedback.longitude = fmod(180.0 + feedback.longitude, 360.0) - 180.0;
-                feedback.altitude = sample.at("alt").as<float>();
-                feedback.groundDistance = sample.at("ground_distance").as<float>();
-                // feedback.attitude = sample.at("q");
-                feedback.captureResult = sample.at("result").as<uint8_t>();
+                feedback.altitude = value(columns[5], row);
+                feedback.groundDistance = value(columns[6], row);
+                if (!attitudeColumns.contains(-1)) {
+                    for (int i = 0; i < 4; i++) {
+                        feedback.attitudeQuaternion[i] = value(attitudeColumns[i], row);
+                    }
+                }
+                feedback.captureResult = static_cast<uint8_t>(value(columns[7], row));
 
                 (void) cameraFeedback.append(feedback);
-            } catch (const AccessException &exception) {
-                qCDebug(ULogParserLog) << Q_FUNC_INFO << exception.what();
             }
         }
     }
@@ -77,7 +91,31 @@ bool getTagsFromLog(const QByteArray &log, QList<GeoTagWorker::CameraFeedbackPac
         return false;
     }
 
+    const ULogReader::Stats_t stats = reader.stats();
+    qCDebug(ULogParserLog) << "Scanned" << stats.bytesScanned << "bytes in" << stats.chunks << "chunks, peak mapped" << stats.peakMappedBytes;
+
     return true;
 }
 
+bool getTagsFromLog(const QByteArray &log, QList<GeoTagWorker::CameraFeedbackPacket> &cameraFeedback, QString &errorMessage)
+{
+    ULogReader reader;
+    if (!reader.open(log, errorMessage)) {
+        return false;
+    }
+
+    return _getTags(reader, cameraFeedback, errorMessage);
+}
+
+bool getTagsFromLog(const QString &logFile, QList<GeoTagWorker::CameraFeedbackPacket> &cameraFeedback, QString &errorMessage, QThreadPool *threadPool)
+{
+    ULogReader reader;
+    if (!reader.open(logFile, errorMessage)) {
+        return false;
+    }
+    reader.setThreadPool(threadPool);
+
+    return _getTags(reader, cameraFeedback, errorMessage);
+}
+
 } // namespace ULogParser
@@ -16,11 +16,17 @@
 
 class QByteArray;
 class QString;
+class QThreadPool;
 
 Q_DECLARE_LOGGING_CATEGORY(ULogParserLog)
 
 namespace ULogParser {
     /// Get GeoTags from a ULog
-    ///     @return true if failed, errorMessage set
+    ///     @return false if failed, errorMessage set
     bool getTagsFromLog(const QByteArray &log, QList<GeoTagWorker::CameraFeedbackPacket> &cameraFeedback, QString &errorMessage);
+
+    /// Get GeoTags from a ULog file. The log is streamed in chunks scanned on threadPool (the global pool if null),
+    /// only camera_capture is decoded.
+    ///     @return false if failed, errorMessage set
+    bool getTagsFromLog(const QString &logFile, QList<GeoTagWorker::CameraFeedbackPacket> &cameraFeedback, QString &errorMessage, QThreadPool *threadPool = nullptr);
 } // namespace ULogParser
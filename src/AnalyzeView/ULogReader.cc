@@ -0,0 +1,679 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ULogReader.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtCore/QThreadPool>
+#include <QtCore/QtEndian>
+
+#include <algorithm>
+#include <cstring>
+
+QGC_LOGGING_CATEGORY(ULogReaderLog, "qgc.analyzeview.ulogreader")
+
+namespace {
+    // https://docs.px4.io/main/en/dev_log/ulog_file_format.html
+    constexpr char kHeaderMagic[] = { 'U', 'L', 'o', 'g', 0x01, 0x12, 0x35 };
+    constexpr int kHeaderSize = 16;
+    constexpr int kMessageHeaderSize = 3;       ///< uint16_t msg_size, uint8_t msg_type
+
+    /// Message header and payload of a sync message
+    constexpr uchar kSyncMessage[] = { 0x08, 0x00, 'S', 0x2F, 0x73, 0x13, 0x20, 0x25, 0x0C, 0xBB, 0x12 };
+    constexpr qint64 kSyncSearchStep = 64 * 1024;
+
+    constexpr uint8_t kIncompatDataAppended = 0x01;
+}
+
+struct ULogReader::Chunk {
+    qint64 start = 0;
+    qint64 end = 0;
+
+    // Subscriptions pass
+    QList<Subscription_t> subscriptions;
+    qint64 messages = 0;
+    int resyncs = 0;
+
+    // Decode pass, subscribed msg_id to its columns
+    QHash<uint16_t, QList<QByteArray>> columns;
+    qint64 samples = 0;
+
+    bool failed = false;
+};
+
+ULogReader::ULogReader()
+{
+    // qCDebug(ULogReaderLog) << Q_FUNC_INFO << this;
+}
+
+ULogReader::~ULogReader()
+{
+    // qCDebug(ULogReaderLog) << Q_FUNC_INFO << this;
+}
+
+bool ULogReader::open(const QString &fileName, QString &errorMessage)
+{
+    _fileName = fileName;
+    _log.clear();
+
+    _file.setFileName(fileName);
+    if (!_file.open(QIODevice::ReadOnly)) {
+        errorMessage = QStringLiteral("Could not open ULog %1: %2").arg(fileName, _file.errorString());
+        return false;
+    }
+    _size = _file.size();
+
+    return _openHeader(errorMessage);
+}
+
+bool ULogReader::open(const QByteArray &log, QString &errorMessage)
+{
+    _fileName.clear();
+    _log = log;
+    _size = log.size();
+
+    return _openHeader(errorMessage);
+}
+
+bool ULogReader::_openHeader(QString &errorMessage)
+{
+    errorMessage.clear();
+    _formats.clear();
+    _appendedOffsets.clear();
+    _topics.clear();
+
+    const QByteArray header = _readBytes(0, kHeaderSize);
+    if ((header.size() < kHeaderSize) || (memcmp(header.constData(), kHeaderMagic, sizeof(kHeaderMagic)) != 0)) {
+        errorMessage = QStringLiteral("Could not parse ULog header");
+        return false;
+    }
+
+    // Definitions run until the first message which belongs to the data section
+    qint64 pos = kHeaderSize;
+    _dataStart = _size;
+    while ((pos + kMessageHeaderSize) <= _size) {
+        const QByteArray messageHeader = _readBytes(pos, kMessageHeaderSize);
+        if (messageHeader.size() < kMessageHeaderSize) {
+            break;
+        }
+        const uint16_t msgSize = qFromLittleEndian<uint16_t>(messageHeader.constData());
+        const char msgType = messageHeader.at(2);
+
+        if ((msgType != 'B') && (msgType != 'F') && (msgType != 'I') && (msgType != 'M') && (msgType != 'P') && (msgType != 'Q')) {
+            _dataStart = pos;
+            break;
+        }
+
+        const QByteArray payload = _readBytes(pos + kMessageHeaderSize, msgSize);
+        if (payload.size() < msgSize) {
+            errorMessage = QStringLiteral("Could not parse ULog definitions");
+            return false;
+        }
+
+        if (msgType == 'B') {
+            // uint8_t compat_flags[8], uint8_t incompat_flags[8], uint64_t appended_offsets[3]
+            if (msgSize < 40) {
+                errorMessage = QStringLiteral("Could not parse ULog flag bits");
+                return false;
+            }
+            const uchar *const flags = reinterpret_cast<const uchar*>(payload.constData());
+            if ((flags[8] & ~kIncompatDataAppended) || std::any_of(flags + 9, flags + 16, [](uchar flag) { return flag != 0; })) {
+                errorMessage = QStringLiteral("ULog uses unsupported incompatible features");
+                return false;
+            }
+            if (flags[8] & kIncompatDataAppended) {
+                for (int i = 0; i < 3; i++) {
+                    const qint64 offset = qFromLittleEndian<quint64>(flags + 16 + (i * 8));
+                    if ((offset > 0) && (offset < _size)) {
+                        _appendedOffsets.append(offset);
+                    }
+                }
+            }
+        } else if (msgType == 'F') {
+            // "name:type field;type field;..."
+            const QString format = QString::fromLatin1(payload);
+            const qsizetype colon = format.indexOf(QLatin1Char(':'));
+            if (colon <= 0) {
+                qCWarning(ULogReaderLog) << "Skipping malformed format" << format;
+            } else {
+                Format_t parsedFormat{ {}, -1, {} };
+                const QStringList fields = format.sliced(colon + 1).split(QLatin1Char(';'), Qt::SkipEmptyParts);
+                for (const QString &field : fields) {
+                    const QStringList typeAndName = field.split(QLatin1Char(' '), Qt::SkipEmptyParts);
+                    if (typeAndName.size() == 2) {
+                        parsedFormat.rawFields.append({ typeAndName[0], typeAndName[1] });
+                    }
+                }
+                _formats.insert(format.first(colon), parsedFormat);
+            }
+        }
+
+        pos += kMessageHeaderSize + msgSize;
+    }
+
+    // Formats may refer to formats defined after them, so sizes are only known once all are in
+    for (auto it = _formats.begin(); it != _formats.end(); ++it) {
+        QStringList resolving;
+        (void) _resolveFormat(it.key(), resolving);
+    }
+    for (auto it = _formats.begin(); it != _formats.end(); ++it) {
+        if (it->size >= 0) {
+            _flatten(it.key(), QString(), 0, it->fields);
+        }
+    }
+
+    std::sort(_appendedOffsets.begin(), _appendedOffsets.end());
+
+    qCDebug(ULogReaderLog) << "Definitions" << _formats.size() << "formats, data section at" << _dataStart << "of" << _size;
+
+    return true;
+}
+
+bool ULogReader::_parseFieldType(const QString &type, QString &baseType, int &arraySize)
+{
+    const qsizetype bracket = type.indexOf(QLatin1Char('['));
+    if (bracket < 0) {
+        baseType = type;
+        arraySize = 1;
+        return true;
+    }
+
+    bool ok = false;
+    baseType = type.first(bracket);
+    arraySize = type.sliced(bracket + 1).chopped(1).toInt(&ok);
+    return ok && type.endsWith(QLatin1Char(']')) && (arraySize > 0);
+}
+
+bool ULogReader::_basicType(const QString &type, FieldType &fieldType)
+{
+    static const QHash<QString, FieldType> basicTypes = {
+        { QStringLiteral("int8_t"),     FieldTypeInt8 },
+        { QStringLiteral("uint8_t"),    FieldTypeUInt8 },
+        { QStringLiteral("int16_t"),    FieldTypeInt16 },
+        { QStringLiteral("uint16_t"),   FieldTypeUInt16 },
+        { QStringLiteral("int32_t"),    FieldTypeInt32 },
+        { QStringLiteral("uint32_t"),   FieldTypeUInt32 },
+        { QStringLiteral("int64_t"),    FieldTypeInt64 },
+        { QStringLiteral("uint64_t"),   FieldTypeUInt64 },
+        { QStringLiteral("float"),      FieldTypeFloat },
+        { QStringLiteral("double"),     FieldTypeDouble },
+        { QStringLiteral("bool"),       FieldTypeBool },
+        { QStringLiteral("char"),       FieldTypeChar },
+    };
+
+    const auto it = basicTypes.constFind(type);
+    if (it == basicTypes.constEnd()) {
+        return false;
+    }
+
+    fieldType = *it;
+    return true;
+}
+
+int ULogReader::fieldSize(FieldType type)
+{
+    switch (type) {
+    case FieldTypeInt8:
+    case FieldTypeUInt8:
+    case FieldTypeBool:
+    case FieldTypeChar:
+        return 1;
+    case FieldTypeInt16:
+    case FieldTypeUInt16:
+        return 2;
+    case FieldTypeInt32:
+    case FieldTypeUInt32:
+    case FieldTypeFloat:
+        return 4;
+    case FieldTypeInt64:
+    case FieldTypeUInt64:
+    case FieldTypeDouble:
+        return 8;
+    }
+
+    return 0;
+}
+
+bool ULogReader::_resolveFormat(const QString &formatName, QStringList &resolving)
+{
+    const auto it = _formats.find(formatName);
+    if (it == _formats.end()) {
+        return false;
+    }
+    if (it->size != -1) {
+        return it->size >= 0;
+    }
+    if (resolving.contains(formatName)) {
+        it->size = -2;
+        return false;
+    }
+    resolving.append(formatName);
+
+    int size = 0;
+    const QList<RawField_t> rawFields = it->rawFields;
+    for (const RawField_t &rawField : rawFields) {
+        QString baseType;
+        int arraySize = 0;
+        FieldType fieldType;
+        int elementSize = 0;
+        if (!_parseFieldType(rawField.type, baseType, arraySize)) {
+            size = -2;
+            break;
+        }
+        if (_basicType(baseType, fieldType)) {
+            elementSize = fieldSize(fieldType);
+        } else if (_resolveFormat(baseType, resolving)) {
+            elementSize = _formats.value(baseType).size;
+        } else {
+            qCWarning(ULogReaderLog) << "Format" << formatName << "refers to unknown format" << baseType;
+            size = -2;
+            break;
+        }
+        size += elementSize * arraySize;
+    }
+
+    (void) resolving.removeLast();
+    _formats[formatName].size = size;
+
+    return size >= 0;
+}
+
+void ULogReader::_flatten(const QString &formatName, const QString &prefix, int offset, QList<Field_t> &fields) const
+{
+    const Format_t format = _formats.value(formatName);
+    for (const RawField_t &rawField : format.rawFields) {
+        QString baseType;
+        int arraySize = 0;
+        (void) _parseFieldType(rawField.type, baseType, arraySize);
+
+        FieldType fieldType;
+        const bool basic = _basicType(baseType, fieldType);
+        const int elementSize = basic ? fieldSize(fieldType) : _formats.value(baseType).size;
+
+        // Padding is only there for alignment, strings are not values
+        const bool skip = rawField.name.startsWith(QStringLiteral("_padding")) || (basic && (fieldType == FieldTypeChar));
+
+        for (int i = 0; i < arraySize; i++) {
+            if (!skip) {
+                const QString name = prefix + ((arraySize > 1) ? QStringLiteral("%1[%2]").arg(rawField.name).arg(i) : rawField.name);
+                if (basic) {
+                    fields.append({ name, fieldType, offset });
+                } else {
+                    _flatten(baseType, name + QLatin1Char('.'), offset, fields);
+                }
+            }
+            offset += elementSize;
+        }
+    }
+}
+
+QList<ULogReader::Field_t> ULogReader::formatFields(const QString &formatName) const
+{
+    return _formats.value(formatName).fields;
+}
+
+void ULogReader::subscribe(const QString &topic, const QStringList &fields)
+{
+    _subscribedFields.insert(topic, fields);
+}
+
+QByteArray ULogReader::_readBytes(qint64 offset, qint64 size)
+{
+    size = qMin(size, _size - offset);
+    if (size <= 0) {
+        return QByteArray();
+    }
+
+    if (_fileName.isEmpty()) {
+        return QByteArray::fromRawData(_log.constData() + offset, size);
+    }
+
+    if (!_file.seek(offset)) {
+        return QByteArray();
+    }
+    return _file.read(size);
+}
+
+qint64 ULogReader::_findSync(const uchar *data, qint64 size, qint64 from)
+{
+    const QByteArrayView view(data, size);
+    return view.indexOf(QByteArrayView(kSyncMessage, sizeof(kSyncMessage)), from);
+}
+
+qint64 ULogReader::_findSyncInLog(qint64 from, qint64 to)
+{
+    // Syncs are normally close together, read a little at a time rather than the whole window
+    for (qint64 pos = from; pos < to; pos += kSyncSearchStep) {
+        const QByteArray window = _readBytes(pos, qMin(kSyncSearchStep, to - pos) + static_cast<qint64>(sizeof(kSyncMessage)) - 1);
+        const qint64 index = _findSync(reinterpret_cast<const uchar*>(window.constData()), window.size(), 0);
+        if (index >= 0) {
+            return pos + index;
+        }
+    }
+
+    return -1;
+}
+
+QList<ULogReader::Chunk> ULogReader::_splitChunks()
+{
+    // Appended data always starts a chunk, the message cut off in front of it is dropped
+    QList<qint64> segmentStarts = { _dataStart };
+    for (const qint64 offset : std::as_const(_appendedOffsets)) {
+        if (offset > _dataStart) {
+            segmentStarts.append(offset);
+        }
+    }
+
+    QList<Chunk> chunks;
+    for (qsizetype i = 0; i < segmentStarts.size(); i++) {
+        const qint64 segmentEnd = ((i + 1) < segmentStarts.size()) ? segmentStarts[i + 1] : _size;
+        qint64 chunkStart = segmentStarts[i];
+
+        // Split at the first sync message after each chunk size step, if there is one close enough
+        for (qint64 split = chunkStart + _chunkSize; split < segmentEnd; split += _chunkSize) {
+            if (split <= chunkStart) {
+                continue;
+            }
+            const qint64 sync = _findSyncInLog(split, qMin(segmentEnd, split + kSyncSearchBytes));
+            if ((sync > chunkStart) && (sync < segmentEnd)) {
+                Chunk chunk;
+                chunk.start = chunkStart;
+                chunk.end = sync;
+                chunks.append(chunk);
+                chunkStart = sync;
+            }
+        }
+
+        Chunk chunk;
+        chunk.start = chunkStart;
+        chunk.end = segmentEnd;
+        chunks.append(chunk);
+    }
+
+    return chunks;
+}
+
+template<typename Scan>
+bool ULogReader::_withChunkData(const Chunk &chunk, Scan &&scan)
+{
+    const qint64 size = chunk.end - chunk.start;
+
+    if (_fileName.isEmpty()) {
+        scan(reinterpret_cast<const uchar*>(_log.constData()) + chunk.start, size);
+        return true;
+    }
+
+    // Each task has its own QFile, mapping is not thread safe on a shared one
+    QFile file(_fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const qint64 mappedBytes = _mappedBytes.fetch_add(size) + size;
+    qint64 peak = _peakMappedBytes.load();
+    while ((mappedBytes > peak) && !_peakMappedBytes.compare_exchange_weak(peak, mappedBytes));
+
+    bool success = true;
+    uchar *const mapped = file.map(chunk.start, size);
+    if (mapped) {
+        scan(mapped, size);
+        (void) file.unmap(mapped);
+    } else if (file.seek(chunk.start)) {
+        const QByteArray data = file.read(size);
+        success = (data.size() == size);
+        if (success) {
+            scan(reinterpret_cast<const uchar*>(data.constData()), size);
+        }
+    } else {
+        success = false;
+    }
+
+    (void) _mappedBytes.fetch_sub(size);
+
+    return success;
+}
+
+namespace {
+    /// Calls handle(type, payload, size) for each message in the chunk. Resyncs on the next sync message when the
+    /// chunk runs into something which can't be a message.
+    template<typename Handle>
+    void walkMessages(const uchar *data, qint64 size, qint64 &messages, int &resyncs, Handle &&handle)
+    {
+        const QByteArrayView sync(kSyncMessage, sizeof(kSyncMessage));
+
+        qint64 pos = 0;
+        while ((pos + kMessageHeaderSize) <= size) {
+            const uint16_t msgSize = qFromLittleEndian<uint16_t>(data + pos);
+            const char msgType = static_cast<char>(data[pos + 2]);
+
+            // Zero filled or cut short, the rest of the log may still be usable past the next sync message
+            if (((msgSize == 0) && (msgType == 0)) || ((pos + kMessageHeaderSize + msgSize) > size)) {
+                const qint64 next = QByteArrayView(data, size).indexOf(sync, pos + 1);
+                if (next < 0) {
+                    break;
+                }
+                resyncs++;
+                pos = next;
+                continue;
+            }
+
+            handle(msgType, data + pos + kMessageHeaderSize, msgSize);
+            messages++;
+            pos += kMessageHeaderSize + msgSize;
+        }
+    }
+}
+
+bool ULogReader::read(QString &errorMessage)
+{
+    errorMessage.clear();
+    _topics.clear();
+    _peakMappedBytes = 0;
+
+    QList<Chunk> chunks = _splitChunks();
+    QThreadPool *const threadPool = _threadPool ? _threadPool : QThreadPool::globalInstance();
+
+    // First pass only collects the subscriptions. Topics may be subscribed anywhere in the log, so a chunk can
+    // only decode its data once it knows about the subscriptions in the chunks before it.
+    QtConcurrent::blockingMap(threadPool, chunks, [this](Chunk &chunk) {
+        chunk.failed = !_withChunkData(chunk, [&chunk](const uchar *data, qint64 size) {
+            walkMessages(data, size, chunk.messages, chunk.resyncs, [&chunk](char msgType, const uchar *payload, uint16_t msgSize) {
+                // uint8_t multi_id, uint16_t msg_id, char message_name[]
+                if ((msgType == 'A') && (msgSize > 3)) {
+                    chunk.subscriptions.append({
+                        payload[0],
+                        qFromLittleEndian<uint16_t>(payload + 1),
+                        QString::fromLatin1(reinterpret_cast<const char*>(payload + 3), msgSize - 3)
+                    });
+                }
+            });
+        });
+    });
+
+    _bytesScanned = 0;
+    _messages = 0;
+    _resyncs = 0;
+    _chunks = chunks.size();
+    for (const Chunk &chunk : std::as_const(chunks)) {
+        if (chunk.failed) {
+            errorMessage = QStringLiteral("Could not read ULog data");
+            return false;
+        }
+        _bytesScanned += chunk.end - chunk.start;
+        _messages += chunk.messages;
+        _resyncs += chunk.resyncs;
+    }
+
+    // Decode plan for the subscribed topics: msg_id to topic and the fields to copy
+    typedef struct {
+        int topicIndex;
+        QList<Field_t> fields;
+    } Decode_t;
+    QHash<uint16_t, Decode_t> decodes;
+    for (const Chunk &chunk : std::as_const(chunks)) {
+        for (const Subscription_t &subscription : chunk.subscriptions) {
+            const auto subscribed = _subscribedFields.constFind(subscription.name);
+            if ((subscribed == _subscribedFields.constEnd()) || decodes.contains(subscription.msgId)) {
+                continue;
+            }
+
+            const auto format = _formats.constFind(subscription.name);
+            if ((format == _formats.constEnd()) || (format->size < 0)) {
+                qCWarning(ULogReaderLog) << "No usable format for subscribed topic" << subscription.name;
+                continue;
+            }
+
+            Topic_t topic{ subscription.name, subscription.multiId, {}, {}, 0 };
+            for (const Field_t &field : format->fields) {
+                if (subscribed->isEmpty() || subscribed->contains(field.name)) {
+                    topic.fields.append(field);
+                    topic.columns.append({ field.type, QByteArray() });
+                }
+            }
+
+            decodes.insert(subscription.msgId, { static_cast<int>(_topics.size()), topic.fields });
+            _topics.append(topic);
+        }
+    }
+
+    if (!decodes.isEmpty()) {
+        QtConcurrent::blockingMap(threadPool, chunks, [this, &decodes](Chunk &chunk) {
+            qint64 messages = 0;
+            int resyncs = 0;
+            chunk.failed = !_withChunkData(chunk, [&](const uchar *data, qint64 size) {
+                walkMessages(data, size, messages, resyncs, [&chunk, &decodes](char msgType, const uchar *payload, uint16_t msgSize) {
+                    // uint16_t msg_id, uint8_t data[]
+                    if ((msgType != 'D') || (msgSize < 2)) {
+                        return;
+                    }
+                    const auto decode = decodes.constFind(qFromLittleEndian<uint16_t>(payload));
+                    if (decode == decodes.constEnd()) {
+                        return;
+                    }
+
+                    const uchar *const sample = payload + 2;
+                    const int sampleSize = msgSize - 2;
+                    QList<QByteArray> &columns = chunk.columns[decode.key()];
+                    if (columns.isEmpty()) {
+                        columns.resize(decode->fields.size());
+                    }
+                    for (qsizetype i = 0; i < decode->fields.size(); i++) {
+                        const Field_t &field = decode->fields[i];
+                        const int size = fieldSize(field.type);
+                        if ((field.offset + size) <= sampleSize) {
+                            (void) columns[i].append(reinterpret_cast<const char*>(sample + field.offset), size);
+                        } else {
+                            // Trailing padding is not logged, anything cut off reads as zero
+                            (void) columns[i].append(size, '\0');
+                        }
+                    }
+                    chunk.samples++;
+                });
+            });
+        });
+
+        // Chunks are in log order, so appending them keeps every column in order
+        _samplesDecoded = 0;
+        for (auto decode = decodes.cbegin(); decode != decodes.cend(); ++decode) {
+            Topic_t &topic = _topics[decode->topicIndex];
+            for (const Chunk &chunk : std::as_const(chunks)) {
+                const auto columns = chunk.columns.constFind(decode.key());
+                if (columns == chunk.columns.constEnd()) {
+                    continue;
+                }
+                for (qsizetype i = 0; i < topic.columns.size(); i++) {
+                    (void) topic.columns[i].data.append(columns->at(i));
+                }
+            }
+            topic.rows = topic.fields.isEmpty() ? 0 : (topic.columns.constFirst().data.size() / fieldSize(topic.fields.constFirst().type));
+            _samplesDecoded += topic.rows;
+        }
+
+        for (const Chunk &chunk : std::as_const(chunks)) {
+            if (chunk.failed) {
+                errorMessage = QStringLiteral("Could not read ULog data");
+                return false;
+            }
+        }
+    }
+
+    qCDebug(ULogReaderLog) << "Scanned" << _bytesScanned << "bytes in" << _chunks << "chunks," << _messages << "messages," << _samplesDecoded << "samples decoded," << _resyncs << "resyncs";
+
+    return true;
+}
+
+const ULogReader::Topic_t *ULogReader::topic(const QString &name, uint8_t multiId) const
+{
+    for (const Topic_t &topic : _topics) {
+        if ((topic.name == name) && (topic.multiId == multiId)) {
+            return &topic;
+        }
+    }
+
+    return nullptr;
+}
+
+int ULogReader::fieldIndex(const Topic_t &topic, const QString &fieldName)
+{
+    for (qsizetype i = 0; i < topic.fields.size(); i++) {
+        if (topic.fields[i].name == fieldName) {
+            return static_cast<int>(i);
+        }
+    }
+
+    return -1;
+}
+
+ULogReader::Stats_t ULogReader::stats() const
+{
+    Stats_t stats;
+
+    stats.bytesScanned      = _bytesScanned;
+    stats.messages          = _messages;
+    stats.samplesDecoded    = _samplesDecoded;
+    stats.chunks            = _chunks;
+    stats.resyncs           = _resyncs;
+    stats.peakMappedBytes   = _peakMappedBytes.load();
+
+    return stats;
+}
+
+double ULogReader::value(const Column_t &column, qsizetype row)
+{
+    const uchar *const data = reinterpret_cast<const uchar*>(column.data.constData()) + (row * fieldSize(column.type));
+
+    switch (column.type) {
+    case FieldTypeInt8:
+        return static_cast<int8_t>(*data);
+    case FieldTypeUInt8:
+    case FieldTypeChar:
+        return *data;
+    case FieldTypeBool:
+        return (*data != 0) ? 1. : 0.;
+    case FieldTypeInt16:
+        return qFromLittleEndian<qint16>(data);
+    case FieldTypeUInt16:
+        return qFromLittleEndian<quint16>(data);
+    case FieldTypeInt32:
+        return qFromLittleEndian<qint32>(data);
+    case FieldTypeUInt32:
+        return qFromLittleEndian<quint32>(data);
+    case FieldTypeInt64:
+        return static_cast<double>(qFromLittleEndian<qint64>(data));
+    case FieldTypeUInt64:
+        return static_cast<double>(qFromLittleEndian<quint64>(data));
+    case FieldTypeFloat:
+        return qFromLittleEndian<float>(data);
+    case FieldTypeDouble:
+        return qFromLittleEndian<double>(data);
+    }
+
+    return 0.;
+}
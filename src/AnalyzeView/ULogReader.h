@@ -0,0 +1,177 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+#include <atomic>
+
+class QThreadPool;
+
+Q_DECLARE_LOGGING_CATEGORY(ULogReaderLog)
+
+/// Streaming ULog reader which only decodes the topics and fields it is asked for.
+/// open() reads the header and definitions. read() then scans the data section in chunks, each split at a sync
+/// message so the chunks can be scanned in parallel. Each chunk is mapped (or read, if mapping fails) on its own
+/// and released as soon as it has been scanned, so memory use depends on the chunk size and thread count rather
+/// than the size of the log. Subscribed fields are copied straight out of the data messages into typed columns.
+class ULogReader
+{
+public:
+    enum FieldType {
+        FieldTypeInt8,
+        FieldTypeUInt8,
+        FieldTypeInt16,
+        FieldTypeUInt16,
+        FieldTypeInt32,
+        FieldTypeUInt32,
+        FieldTypeInt64,
+        FieldTypeUInt64,
+        FieldTypeFloat,
+        FieldTypeDouble,
+        FieldTypeBool,
+        FieldTypeChar
+    };
+
+    typedef struct {
+        QString name;       ///< Nested fields are flattened to "parent.child", array elements to "name[index]"
+        FieldType type;
+        int offset;         ///< From the start of the message data, after the msg_id
+    } Field_t;
+
+    /// Values of one field, packed in log (little endian) byte order
+    typedef struct {
+        FieldType type;
+        QByteArray data;
+    } Column_t;
+
+    /// One instance of a subscribed topic. columns matches fields.
+    typedef struct {
+        QString name;
+        uint8_t multiId;
+        QList<Field_t> fields;
+        QList<Column_t> columns;
+        qsizetype rows;
+    } Topic_t;
+
+    typedef struct {
+        qint64 bytesScanned;
+        qint64 messages;
+        qint64 samplesDecoded;
+        int chunks;
+        int resyncs;            ///< Corrupt stretches skipped by searching for the next sync message
+        qint64 peakMappedBytes; ///< Most log data held in memory at once
+    } Stats_t;
+
+    ULogReader();
+    ~ULogReader();
+
+    /// Reads the header and definitions of a log file
+    ///     @return false if failed, errorMessage set
+    bool open(const QString &fileName, QString &errorMessage);
+
+    /// Same for a log already in memory, which must stay valid while the reader uses it
+    bool open(const QByteArray &log, QString &errorMessage);
+
+    /// Message formats from the definitions section
+    QStringList formatNames() const { return _formats.keys(); }
+
+    /// The scalar fields of a message format. char fields are strings, they are left out.
+    QList<Field_t> formatFields(const QString &formatName) const;
+
+    /// Decode the topic in read(). An empty fields list decodes all of them, unknown fields are ignored.
+    void subscribe(const QString &topic, const QStringList &fields = QStringList());
+
+    /// Pool the chunks are scanned on, the global pool by default
+    void setThreadPool(QThreadPool *threadPool) { _threadPool = threadPool; }
+
+    /// Approximate amount of the log scanned per task
+    void setChunkSize(qint64 chunkSize) { _chunkSize = qMax(chunkSize, qint64(1)); }
+
+    /// Scans the data section for the subscribed topics
+    ///     @return false if failed, errorMessage set
+    bool read(QString &errorMessage);
+
+    /// Every instance of the subscribed topics seen in the log, in order of subscription
+    const QList<Topic_t> &topics() const { return _topics; }
+    const Topic_t *topic(const QString &name, uint8_t multiId = 0) const;
+    static int fieldIndex(const Topic_t &topic, const QString &fieldName);
+
+    Stats_t stats() const;
+
+    static double value(const Column_t &column, qsizetype row);
+    static int fieldSize(FieldType type);
+
+    static constexpr qint64 kDefaultChunkSize = 32 * 1024 * 1024;
+    static constexpr qint64 kSyncSearchBytes = 4 * 1024 * 1024;    ///< How far past a split point to look for a sync message
+
+private:
+    typedef struct {
+        QString type;       ///< As written in the format, "float[4]", "vehicle_attitude", ...
+        QString name;
+    } RawField_t;
+
+    typedef struct {
+        QList<RawField_t> rawFields;
+        int size;           ///< -1 until resolved, -2 if it refers to an unknown format
+        QList<Field_t> fields;
+    } Format_t;
+
+    typedef struct {
+        uint8_t multiId;
+        uint16_t msgId;
+        QString name;
+    } Subscription_t;
+
+    struct Chunk;
+
+    bool _openHeader(QString &errorMessage);
+    bool _resolveFormat(const QString &formatName, QStringList &resolving);
+    void _flatten(const QString &formatName, const QString &prefix, int offset, QList<Field_t> &fields) const;
+    QByteArray _readBytes(qint64 offset, qint64 size);
+    qint64 _findSyncInLog(qint64 from, qint64 to);
+    QList<Chunk> _splitChunks();
+
+    /// Calls scan with the chunk's bytes, mapped or read in
+    template<typename Scan> bool _withChunkData(const Chunk &chunk, Scan &&scan);
+
+    static bool _parseFieldType(const QString &type, QString &baseType, int &arraySize);
+    static bool _basicType(const QString &type, FieldType &fieldType);
+    static qint64 _findSync(const uchar *data, qint64 size, qint64 from);
+
+    QString _fileName;
+    QFile _file;
+    QByteArray _log;
+    qint64 _size = 0;
+
+    qint64 _dataStart = 0;
+    QList<qint64> _appendedOffsets;
+    QHash<QString, Format_t> _formats;
+
+    QHash<QString, QStringList> _subscribedFields;
+    QList<Topic_t> _topics;
+
+    QThreadPool *_threadPool = nullptr;
+    qint64 _chunkSize = kDefaultChunkSize;
+
+    std::atomic<qint64> _mappedBytes = 0;
+    std::atomic<qint64> _peakMappedBytes = 0;
+    qint64 _bytesScanned = 0;
+    qint64 _messages = 0;
+    qint64 _samplesDecoded = 0;
+    int _chunks = 0;
+    int _resyncs = 0;
+};
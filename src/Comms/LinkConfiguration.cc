@@ -19,6 +19,7 @@
 #endif
 #ifdef QT_DEBUG
 #include "MockLink.h"
+#include "MockSwarmConfiguration.h"
 #endif
 #ifndef QGC_AIRLINK_DISABLED
 #include "AirLinkLink.h"
@@ -88,6 +89,9 @@ LinkConfiguration *LinkConfiguration::createSettings(int type, const QString &na
     case TypeMock:
         config = new MockConfiguration(name);
         break;
+    case TypeMockSwarm:
+        config = new MockSwarmConfiguration(name);
+        break;
 #endif
 #ifndef QGC_AIRLINK_DISABLED
     case AirLink:
@@ -130,6 +134,9 @@ LinkConfiguration *LinkConfiguration::duplicateSettings(const LinkConfiguration
     case TypeMock:
         dupe = new MockConfiguration(qobject_cast<const MockConfiguration*>(source));
         break;
+    case TypeMockSwarm:
+        dupe = new MockSwarmConfiguration(qobject_cast<const MockSwarmConfiguration*>(source));
+        break;
 #endif
 #ifndef QGC_AIRLINK_DISABLED
     case AirLink:
@@ -87,6 +87,7 @@ class LinkConfiguration : public QObject
 #endif
 #ifdef QT_DEBUG
         TypeMock,       ///< Mock Link for Unitesting
+        TypeMockSwarm,  ///< Many simulated vehicles for load testing
 #endif
 #ifndef QGC_AIRLINK_DISABLED
         AirLink,
@@ -14,7 +14,9 @@
 #include "MAVLinkSigning.h"
 #include "SettingsManager.h"
 #include "MavlinkSettings.h"
+#include "TelemetryTracer.h"
 
+#include <QtCore/QThread>
 #include <QtQml/QQmlEngine>
 
 QGC_LOGGING_CATEGORY(LinkInterfaceLog, "qgc.comms.linkinterface")
@@ -24,6 +26,22 @@ LinkInterface::LinkInterface(SharedLinkConfigurationPtr &config, QObject *parent
     , _config(config)
 {
     QQmlEngine::setObjectOwnership(this, QQmlEngine::CppOwnership);
+
+    _writeStatsTimer.start();
+
+    // Direct so the timestamp is taken on the thread which read the bytes, before any queueing
+    (void) connect(this, &LinkInterface::bytesReceived, this, [this](LinkInterface *, const QByteArray &data) {
+        if (!TelemetryTracer::enabled()) {
+            return;
+        }
+
+        const qint64 readNsecs = TelemetryTracer::nowNsecs();
+        QMutexLocker locker(&_traceReadsMutex);
+        if (_traceReads.size() >= kMaxTraceReads) {
+            _traceReads.removeFirst();
+        }
+        _traceReads.append({ data.constData(), readNsecs });
+    }, Qt::DirectConnection);
 }
 
 LinkInterface::~LinkInterface()
@@ -105,10 +123,39 @@ void LinkInterface::_freeMavlinkChannel()
     _mavlinkChannel = LinkManager::invalidMavlinkChannel();
 }
 
-void LinkInterface::writeBytesThreadSafe(const char *bytes, int length)
+void LinkInterface::writeBytesThreadSafe(const char *bytes, int length, bool priority)
 {
-    const QByteArray data(bytes, length);
-    (void) QMetaObject::invokeMethod(this, "_writeBytes", Qt::AutoConnection, data);
+    if (_writeQueue.push(bytes, length, priority)) {
+        _writeQueueReady();
+    }
+}
+
+void LinkInterface::_writeQueueReady()
+{
+    if (QThread::currentThread() == thread()) {
+        _drainWriteQueue();
+    } else {
+        // One queued drain covers every frame pushed until it runs
+        (void) QMetaObject::invokeMethod(this, &LinkInterface::_drainWriteQueue, Qt::QueuedConnection);
+    }
+}
+
+void LinkInterface::_drainWriteQueue()
+{
+    _writeQueue.drain(false, [this](const char *bytes, int length) {
+        _writeBytes(QByteArray(bytes, length));
+    });
+}
+
+LinkInterface::WriteStats_t LinkInterface::writeStats() const
+{
+    WriteStats_t stats;
+
+    stats.queue = _writeQueue.stats();
+    const qint64 elapsedMsecs = _writeStatsTimer.elapsed();
+    stats.bytesPerSecond = (elapsedMsecs > 0) ? ((stats.queue.bytesWritten * 1000.) / elapsedMsecs) : 0.;
+
+    return stats;
 }
 
 void LinkInterface::removeVehicleReference()
@@ -140,3 +187,19 @@ void LinkInterface::setSigningSignatureFailure(bool failure)
         }
     }
 }
+
+qint64 LinkInterface::takeTraceReadNsecs(const QByteArray &bytes)
+{
+    QMutexLocker locker(&_traceReadsMutex);
+
+    // Receivers see the emits in order, so anything ahead of the match was never consumed
+    for (qsizetype i = 0; i < _traceReads.size(); i++) {
+        if (_traceReads[i].data == bytes.constData()) {
+            const qint64 readNsecs = _traceReads[i].readNsecs;
+            _traceReads.remove(0, i + 1);
+            return readNsecs;
+        }
+    }
+
+    return -1;
+}
@@ -9,10 +9,13 @@
 
 #pragma once
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QMutex>
 #include <QtQmlIntegration/QtQmlIntegration>
 
 #include "LinkConfiguration.h"
+#include "LinkWriteQueue.h"
 
 class LinkManager;
 
@@ -34,6 +37,7 @@ class LinkInterface : public QObject
     virtual bool isConnected() const = 0;
     virtual bool isLogReplay() const { return false; }
     virtual bool isSecureConnection() const { return false; } ///< Returns true if the connection is secure (e.g. USB, wired ethernet)
+    virtual qint64 nominalBytesPerSecond() const { return 0; } ///< Throughput the transport is configured for, 0 if unknown or not limited
 
     SharedLinkConfigurationPtr linkConfiguration() { return _config; }
     const SharedLinkConfigurationPtr linkConfiguration() const { return _config; }
@@ -41,7 +45,21 @@ class LinkInterface : public QObject
     bool mavlinkChannelIsSet() const;
     bool decodedFirstMavlinkPacket() const { return _decodedFirstMavlinkPacket; }
     void setDecodedFirstMavlinkPacket(bool decodedFirstMavlinkPacket) { _decodedFirstMavlinkPacket = decodedFirstMavlinkPacket; }
-    void writeBytesThreadSafe(const char *bytes, int length);
+    /// Queues the bytes for writing. Frames are collected and handed to the transport together, see
+    /// _writeQueueReady. Priority frames are written ahead of normal frames still waiting in the queue.
+    void writeBytesThreadSafe(const char *bytes, int length, bool priority = false);
+
+    typedef struct {
+        LinkWriteQueue::Stats_t queue;
+        double bytesPerSecond;      ///< Average since the link was created
+    } WriteStats_t;
+
+    /// Send path counters, thread safe
+    WriteStats_t writeStats() const;
+
+    /// Time at which the link emitted bytes, for TelemetryTracer. Only recorded while tracing is enabled.
+    ///     @return TelemetryTracer::nowNsecs() at emit, -1 if not recorded
+    qint64 takeTraceReadNsecs(const QByteArray &bytes);
     void addVehicleReference() { ++_vehicleReferenceCount; }
     void removeVehicleReference();
     bool initMavlinkSigning();
@@ -66,16 +84,38 @@ class LinkInterface : public QObject
 
     void _connectionRemoved();
 
+    /// Called from the writing thread when frames are waiting and no drain has been requested since the last
+    /// one started, so at most once per batch. The default drains on the link's thread through _writeBytes.
+    /// Links with a transport worker override this to wake the worker, which drains writeQueue() itself and
+    /// writes straight to its socket or port.
+    virtual void _writeQueueReady();
+
+    LinkWriteQueue *writeQueue() { return &_writeQueue; }
+
     SharedLinkConfigurationPtr _config;
 
 private slots:
-    /// Not thread safe if called directly, only writeBytesThreadSafe is thread safe
-    virtual void _writeBytes(const QByteArray &bytes) = 0;
+    /// Used by the default _writeQueueReady only. Not thread safe if called directly, only writeBytesThreadSafe is thread safe
+    virtual void _writeBytes(const QByteArray &bytes) { Q_UNUSED(bytes); }
 
 private:
     /// connect is private since all links should be created through LinkManager::createConnectedLink calls
     virtual bool _connect() = 0;
 
+    void _drainWriteQueue();
+
+    LinkWriteQueue _writeQueue;
+    QElapsedTimer _writeStatsTimer;
+
+    typedef struct {
+        const char *data;           ///< Identifies the emitted QByteArray, receivers get an implicitly shared copy
+        qint64 readNsecs;
+    } TraceRead_t;
+
+    QMutex _traceReadsMutex;
+    QList<TraceRead_t> _traceReads;
+    static constexpr qsizetype kMaxTraceReads = 4096;
+
     uint8_t _mavlinkChannel = std::numeric_limits<uint8_t>::max();
     bool _decodedFirstMavlinkPacket = false;
     int _vehicleReferenceCount = 0;
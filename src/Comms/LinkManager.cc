@@ -35,6 +35,7 @@
 
 #ifdef QT_DEBUG
 #include "MockLink.h"
+#include "MockSwarmLink.h"
 #endif
 
 #ifndef QGC_AIRLINK_DISABLED
@@ -136,6 +137,9 @@ bool LinkManager::createConnectedLink(SharedLinkConfigurationPtr &config)
     case LinkConfiguration::TypeMock:
         link = std::make_shared<MockLink>(config);
         break;
+    case LinkConfiguration::TypeMockSwarm:
+        link = std::make_shared<MockSwarmLink>(config);
+        break;
 #endif
 #ifndef QGC_AIRLINK_DISABLED
     case LinkConfiguration::AirLink:
@@ -345,6 +349,9 @@ void LinkManager::loadLinkConfigurationList()
             case LinkConfiguration::TypeMock:
                 link = new MockConfiguration(name);
                 break;
+            case LinkConfiguration::TypeMockSwarm:
+                link = new MockSwarmConfiguration(name);
+                break;
 #endif
 #ifndef QGC_AIRLINK_DISABLED
             case LinkConfiguration::AirLink:
@@ -550,6 +557,7 @@ QStringList LinkManager::linkTypeStrings() const
 #endif
 #ifdef QT_DEBUG
     list += tr("Mock Link");
+    list += tr("Mock Swarm");
 #endif
 #ifndef QGC_AIRLINK_DISABLED
     list += tr("AirLink");
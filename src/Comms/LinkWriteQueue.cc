@@ -0,0 +1,217 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LinkWriteQueue.h"
+#include "QGCLoggingCategory.h"
+
+#include <bit>
+#include <cstring>
+
+QGC_LOGGING_CATEGORY(LinkWriteQueueLog, "qgc.comms.linkwritequeue")
+
+LinkWriteQueue::LinkWriteQueue()
+{
+    // qCDebug(LinkWriteQueueLog) << Q_FUNC_INFO << this;
+
+    for (int i = 0; i < kPoolSize; i++) {
+        _pool[i].poolIndex = i;
+    }
+}
+
+LinkWriteQueue::~LinkWriteQueue()
+{
+    // Anything still queued is dropped, only heap frames need freeing
+    for (List *const list : { &_priorityFrames, &_frames }) {
+        while (Frame *const frame = _popFrame(*list)) {
+            _releaseFrame(frame);
+        }
+    }
+
+    // qCDebug(LinkWriteQueueLog) << Q_FUNC_INFO << this;
+}
+
+bool LinkWriteQueue::push(const char *bytes, int length, bool priority)
+{
+    Frame *const frame = _acquireFrame(length);
+    frame->size = length;
+    if (length > kInlineFrameSize) {
+        frame->overflow = QByteArray(bytes, length);
+    } else {
+        (void) memcpy(frame->data, bytes, length);
+    }
+    frame->enqueued = Clock::now();
+
+    _pushFrame(priority ? _priorityFrames : _frames, frame);
+    (void) _framesQueued.fetch_add(1, std::memory_order_relaxed);
+    if (priority) {
+        (void) _priorityFramesQueued.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Must come after the push is complete, see drain
+    return !_drainRequested.exchange(true, std::memory_order_seq_cst);
+}
+
+void LinkWriteQueue::drain(bool coalesce, const std::function<void(const char *bytes, int length)> &write)
+{
+    if (_draining) {
+        return;
+    }
+    _draining = true;
+
+    int coalescedSize = 0;
+    quint64 frames = 0;
+    quint64 bytes = 0;
+    quint64 writeCalls = 0;
+    qint64 totalLatencyNsecs = 0;
+    qint64 maxLatencyNsecs = _maxLatencyNsecs.load(std::memory_order_relaxed);
+
+    const auto flush = [&]() {
+        if (coalescedSize > 0) {
+            write(_coalesced.data(), coalescedSize);
+            writeCalls++;
+            coalescedSize = 0;
+        }
+    };
+
+    // The request flag is cleared before each pass, so a producer whose frame is not visible yet will see it
+    // clear and request another drain. Passes repeat until one finds nothing, which also covers frames pushed
+    // by write itself.
+    bool popped;
+    do {
+        _drainRequested.store(false, std::memory_order_seq_cst);
+        popped = false;
+
+        while (true) {
+            // Priority frames are looked for again before every normal frame
+            Frame *frame = _popFrame(_priorityFrames);
+            if (!frame) {
+                frame = _popFrame(_frames);
+            }
+            if (!frame) {
+                break;
+            }
+            popped = true;
+
+            const qint64 latencyNsecs = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - frame->enqueued).count();
+            totalLatencyNsecs += latencyNsecs;
+            maxLatencyNsecs = qMax(maxLatencyNsecs, latencyNsecs);
+            frames++;
+            bytes += frame->size;
+
+            if (coalesce && (frame->size <= kMaxCoalescedBytes)) {
+                if ((coalescedSize + frame->size) > kMaxCoalescedBytes) {
+                    flush();
+                }
+                (void) memcpy(_coalesced.data() + coalescedSize, frame->bytes(), frame->size);
+                coalescedSize += frame->size;
+            } else {
+                // Anything already joined must go out first to keep the order
+                flush();
+                write(frame->bytes(), frame->size);
+                writeCalls++;
+            }
+
+            _releaseFrame(frame);
+        }
+        flush();
+    } while (popped);
+
+    (void) _framesWritten.fetch_add(frames, std::memory_order_relaxed);
+    (void) _bytesWritten.fetch_add(bytes, std::memory_order_relaxed);
+    (void) _writeCalls.fetch_add(writeCalls, std::memory_order_relaxed);
+    (void) _totalLatencyNsecs.fetch_add(totalLatencyNsecs, std::memory_order_relaxed);
+    _maxLatencyNsecs.store(maxLatencyNsecs, std::memory_order_relaxed);
+
+    _draining = false;
+}
+
+LinkWriteQueue::Stats_t LinkWriteQueue::stats() const
+{
+    Stats_t stats;
+
+    stats.framesQueued          = _framesQueued.load(std::memory_order_relaxed);
+    stats.framesWritten         = _framesWritten.load(std::memory_order_relaxed);
+    stats.bytesWritten          = _bytesWritten.load(std::memory_order_relaxed);
+    stats.writeCalls            = _writeCalls.load(std::memory_order_relaxed);
+    stats.poolMisses            = _poolMisses.load(std::memory_order_relaxed);
+    stats.priorityFrames        = _priorityFramesQueued.load(std::memory_order_relaxed);
+    stats.averageLatencyUsecs   = stats.framesWritten ? (_totalLatencyNsecs.load(std::memory_order_relaxed) / 1000.) / stats.framesWritten : 0.;
+    stats.maxLatencyUsecs       = _maxLatencyNsecs.load(std::memory_order_relaxed) / 1000.;
+
+    return stats;
+}
+
+LinkWriteQueue::Frame *LinkWriteQueue::_acquireFrame(int length)
+{
+    if (length <= kInlineFrameSize) {
+        quint64 mask = _freeMask.load(std::memory_order_relaxed);
+        while (mask != 0) {
+            const int index = std::countr_zero(mask);
+            if (_freeMask.compare_exchange_weak(mask, mask & ~(quint64(1) << index), std::memory_order_acquire, std::memory_order_relaxed)) {
+                return &_pool[index];
+            }
+        }
+    }
+
+    (void) _poolMisses.fetch_add(1, std::memory_order_relaxed);
+    return new Frame;
+}
+
+void LinkWriteQueue::_releaseFrame(Frame *frame)
+{
+    if (frame->poolIndex < 0) {
+        delete frame;
+        return;
+    }
+
+    (void) _freeMask.fetch_or(quint64(1) << frame->poolIndex, std::memory_order_release);
+}
+
+void LinkWriteQueue::_pushFrame(List &list, Frame *frame)
+{
+    frame->next.store(nullptr, std::memory_order_relaxed);
+    Frame *const previous = list.head.exchange(frame, std::memory_order_acq_rel);
+    previous->next.store(frame, std::memory_order_release);
+}
+
+LinkWriteQueue::Frame *LinkWriteQueue::_popFrame(List &list)
+{
+    Frame *tail = list.tail;
+    Frame *next = tail->next.load(std::memory_order_acquire);
+
+    if (tail == &list.stub) {
+        if (!next) {
+            return nullptr;
+        }
+        list.tail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next) {
+        list.tail = next;
+        return tail;
+    }
+
+    // tail looks like the last frame. If a producer has already swapped the head but not linked its frame yet,
+    // leave it for now, that producer will request another drain.
+    if (tail != list.head.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+
+    // Re-insert the stub behind tail so tail can be handed out without leaving the list empty
+    _pushFrame(list, &list.stub);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next) {
+        list.tail = next;
+        return tail;
+    }
+
+    return nullptr;
+}
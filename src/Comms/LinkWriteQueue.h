@@ -0,0 +1,107 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QLoggingCategory>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+Q_DECLARE_LOGGING_CATEGORY(LinkWriteQueueLog)
+
+/// Outgoing frame queue for a link. Any number of threads may push, a single consumer thread drains.
+/// The queue is an intrusive lock-free MPSC list (Vyukov) of frames taken from a fixed pool, so queuing a
+/// frame neither locks nor allocates unless the pool runs dry or the frame doesn't fit a pooled buffer.
+/// Priority frames go on a second list which the consumer checks before each normal frame, so they overtake
+/// a backlog of bulk traffic. Order is kept within each list.
+class LinkWriteQueue
+{
+public:
+    typedef struct {
+        quint64 framesQueued;
+        quint64 framesWritten;
+        quint64 bytesWritten;
+        quint64 writeCalls;         ///< Less than framesWritten when frames are coalesced
+        quint64 poolMisses;         ///< Frames which had to be heap allocated
+        quint64 priorityFrames;     ///< Frames queued with priority, included in framesQueued
+        double  averageLatencyUsecs;///< Time from push to hand off to the transport
+        double  maxLatencyUsecs;
+    } Stats_t;
+
+    LinkWriteQueue();
+    ~LinkWriteQueue();
+
+    /// Thread safe. Copies the bytes into a queued frame.
+    ///     @param priority Frame is written ahead of any normal frames still queued
+    ///     @return true: The consumer must be told to drain, no drain has been requested since the last one started
+    bool push(const char *bytes, int length, bool priority = false);
+
+    /// Consumer thread only. Hands every frame queued so far to write, in push order. With coalesce set
+    /// consecutive frames are joined into writes of up to kMaxCoalescedBytes, otherwise each frame is a write.
+    /// The bytes point into the queue's own storage and are only valid for the duration of the call.
+    /// Re-entrant calls from within write return immediately, the outer drain picks up anything they would have.
+    void drain(bool coalesce, const std::function<void(const char *bytes, int length)> &write);
+
+    /// Thread safe snapshot of the counters
+    Stats_t stats() const;
+
+    static constexpr int kPoolSize = 64;
+    static constexpr int kInlineFrameSize = 280;        ///< MAVLINK_MAX_PACKET_LEN, larger frames go to the heap
+    static constexpr int kMaxCoalescedBytes = 4096;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Frame {
+        std::atomic<Frame*> next = nullptr;
+        Clock::time_point enqueued;
+        int size = 0;
+        int poolIndex = -1;                             ///< -1: heap allocated
+        QByteArray overflow;                            ///< Storage for frames larger than kInlineFrameSize
+        char data[kInlineFrameSize];
+
+        const char *bytes() const { return (size > kInlineFrameSize) ? overflow.constData() : data; }
+    };
+
+    struct List {
+        List() : head(&stub), tail(&stub) {}
+
+        std::atomic<Frame*> head;                       ///< Producers push here
+        Frame *tail = nullptr;                          ///< Consumer pops here
+        Frame stub;
+    };
+
+    Frame *_acquireFrame(int length);
+    void _releaseFrame(Frame *frame);
+    static void _pushFrame(List &list, Frame *frame);
+    static Frame *_popFrame(List &list);
+
+    std::array<Frame, kPoolSize> _pool;
+    std::atomic<quint64> _freeMask = ~quint64(0);      ///< Bit set for each pool frame which is available
+
+    List _priorityFrames;
+    List _frames;
+
+    std::atomic_bool _drainRequested = false;
+    bool _draining = false;
+    std::array<char, kMaxCoalescedBytes> _coalesced;   ///< Consumer only, reused by every coalescing drain
+
+    std::atomic<quint64> _framesQueued = 0;
+    std::atomic<quint64> _framesWritten = 0;
+    std::atomic<quint64> _bytesWritten = 0;
+    std::atomic<quint64> _writeCalls = 0;
+    std::atomic<quint64> _poolMisses = 0;
+    std::atomic<quint64> _priorityFramesQueued = 0;
+    std::atomic<qint64> _totalLatencyNsecs = 0;
+    std::atomic<qint64> _maxLatencyNsecs = 0;
+};
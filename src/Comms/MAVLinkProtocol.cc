@@ -17,6 +17,7 @@
 #include "MavlinkSettings.h"
 #include "AppSettings.h"
 #include "QmlObjectListModel.h"
+#include "TelemetryTracer.h"
 
 #include <QtCore/qapplicationstatic.h>
 #include <QtCore/QDir>
@@ -110,6 +111,9 @@ void MAVLinkProtocol::receiveBytes(LinkInterface *link, const QByteArray &data)
         return;
     }
 
+    const bool tracing = TelemetryTracer::enabled();
+    const qint64 traceReadNsecs = tracing ? link->takeTraceReadNsecs(data) : -1;
+
     for (const uint8_t &byte: data) {
         const uint8_t mavlinkChannel = link->mavlinkChannel();
         mavlink_message_t message{};
@@ -119,6 +123,10 @@ void MAVLinkProtocol::receiveBytes(LinkInterface *link, const QByteArray &data)
             continue;
         }
 
+        if (tracing) {
+            TelemetryTracer::instance()->beginMessage(traceReadNsecs, message);
+        }
+
         _updateVersion(link, mavlinkChannel);
         _updateCounters(mavlinkChannel, message);
         if (!linkPtr->linkConfiguration()->isForwarding()) {
@@ -127,7 +135,13 @@ void MAVLinkProtocol::receiveBytes(LinkInterface *link, const QByteArray &data)
         }
         _logData(link, message);
 
-        if (!_updateStatus(link, linkPtr, mavlinkChannel, message)) {
+        const bool linkActive = _updateStatus(link, linkPtr, mavlinkChannel, message);
+
+        if (tracing) {
+            TelemetryTracer::instance()->endMessage();
+        }
+
+        if (!linkActive) {
             break;
         }
     }
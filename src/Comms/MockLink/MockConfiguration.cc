@@ -25,6 +25,7 @@ MockConfiguration::MockConfiguration(const MockConfiguration *copy, QObject *par
     , _sendStatusText(copy->sendStatusText())
     , _incrementVehicleId(copy->incrementVehicleId())
     , _failureMode(copy->failureMode())
+    , _linkBytesPerSecond(copy->linkBytesPerSecond())
 {
     // qCDebug(MockConfigurationLog) << Q_FUNC_INFO << this;
 }
@@ -47,6 +48,7 @@ void MockConfiguration::copyFrom(const LinkConfiguration *source)
     setSendStatusText(mockLinkSource->sendStatusText());
     setIncrementVehicleId(mockLinkSource->incrementVehicleId());
     setFailureMode(mockLinkSource->failureMode());
+    setLinkBytesPerSecond(mockLinkSource->linkBytesPerSecond());
 }
 
 void MockConfiguration::loadSettings(QSettings &settings, const QString &root)
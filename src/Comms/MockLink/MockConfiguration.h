@@ -51,6 +51,9 @@ class MockConfiguration : public LinkConfiguration
     void setVehicleType(MAV_TYPE vehicleType) { _vehicleType = vehicleType; emit vehicleChanged(); }
     bool sendStatusText() const { return _sendStatusText; }
     void setSendStatusText(bool sendStatusText) { _sendStatusText = sendStatusText; emit sendStatusChanged(); }
+    /// Simulated link throughput from the vehicle in bytes per second, 0 for no limit
+    int linkBytesPerSecond() const { return _linkBytesPerSecond; }
+    void setLinkBytesPerSecond(int bytesPerSecond) { _linkBytesPerSecond = bytesPerSecond; }
 
     enum FailureMode_t {
         FailNone,                                                   // No failures
@@ -79,6 +82,7 @@ class MockConfiguration : public LinkConfiguration
     bool _incrementVehicleId = true;
     uint16_t _boardVendorId = 0;
     uint16_t _boardProductId = 0;
+    int _linkBytesPerSecond = 0;
 
     static constexpr const char *_firmwareTypeKey = "FirmwareType";
     static constexpr const char *_vehicleTypeKey = "VehicleType";
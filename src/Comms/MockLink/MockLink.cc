@@ -59,6 +59,7 @@ MockLink::MockLink(SharedLinkConfigurationPtr &config, QObject *parent)
     , _vehicleLongitude(_defaultVehicleLongitude + ((_vehicleSystemId - 128) * 0.0001))
     , _boardVendorId(_mockConfig->boardVendorId())
     , _boardProductId(_mockConfig->boardProductId())
+    , _linkBytesPerSecond(_mockConfig->linkBytesPerSecond())
     , _missionItemHandler(new MockLinkMissionItemHandler(this))
     , _mockLinkFTP(new MockLinkFTP(_vehicleSystemId, _vehicleComponentId, this))
 {
@@ -195,6 +196,10 @@ void MockLink::run500HzTasks()
         return;
     }
 
+    if (_linkBytesPerSecond > 0) {
+        _sendRateLimitedBytes();
+    }
+
     if (_mavlinkStarted && _connected) {
         _paramRequestListWorker();
         _logDownloadWorker();
@@ -508,11 +513,52 @@ void MockLink::respondWithMavlinkMessage(const mavlink_message_t &msg)
     if (!_commLost) {
         uint8_t buffer[MAVLINK_MAX_PACKET_LEN]{};
         const int cBuffer = mavlink_msg_to_send_buffer(buffer, &msg);
+        if (_linkBytesPerSecond > 0) {
+            QMutexLocker locker(&_rateLimitedMutex);
+            (void) _rateLimitedBytes.append(reinterpret_cast<char*>(buffer), cBuffer);
+            return;
+        }
         const QByteArray bytes(reinterpret_cast<char*>(buffer), cBuffer);
         emit bytesReceived(this, bytes);
     }
 }
 
+void MockLink::_sendRateLimitedBytes()
+{
+    if (!_rateLimitedTimer.isValid()) {
+        _rateLimitedTimer.start();
+    }
+
+    // Unused bandwidth only carries over for a short while, same as a real link which sits idle
+    const qint64 maxBudget = qMax(static_cast<qint64>(MAVLINK_MAX_PACKET_LEN), static_cast<qint64>(_linkBytesPerSecond / 50));
+    _rateLimitedBudget = qMin(_rateLimitedBudget + ((_linkBytesPerSecond * _rateLimitedTimer.restart()) / 1000), maxBudget);
+
+    QByteArray bytes;
+    {
+        QMutexLocker locker(&_rateLimitedMutex);
+        const qsizetype cBytes = qMin(_rateLimitedBytes.size(), static_cast<qsizetype>(_rateLimitedBudget));
+        if (cBytes == 0) {
+            return;
+        }
+        bytes = _rateLimitedBytes.left(cBytes);
+        (void) _rateLimitedBytes.remove(0, cBytes);
+    }
+
+    _rateLimitedBudget -= bytes.size();
+    emit bytesReceived(this, bytes);
+}
+
+bool MockLink::_linkBacklogged()
+{
+    if (_linkBytesPerSecond <= 0) {
+        return false;
+    }
+
+    // More than 100 msecs worth of data waiting to go out
+    QMutexLocker locker(&_rateLimitedMutex);
+    return (_rateLimitedBytes.size() > (_linkBytesPerSecond / 10));
+}
+
 void MockLink::_writeBytes(const QByteArray &bytes)
 {
     // This prevents the responses to mavlink messages from being sent until the _writeBytes returns.
@@ -610,6 +656,9 @@ void MockLink::_handleIncomingMavlinkMsg(const mavlink_message_t &msg)
     case MAVLINK_MSG_ID_LOG_REQUEST_DATA:
         _handleLogRequestData(msg);
         break;
+    case MAVLINK_MSG_ID_LOG_REQUEST_END:
+        _handleLogRequestEnd(msg);
+        break;
     case MAVLINK_MSG_ID_PARAM_MAP_RC:
         _handleParamMapRC(msg);
         break;
@@ -793,6 +842,11 @@ void MockLink::_paramRequestListWorker()
         return;
     }
 
+    if (_linkBacklogged()) {
+        // Vehicles pace the parameter stream to the link
+        return;
+    }
+
     const int componentId = _mapParamName2Value.keys()[_currentParamRequestListComponentIndex];
     const int cParameters = _mapParamName2Value[componentId].count();
     const QString paramName = _mapParamName2Value[componentId].keys()[_currentParamRequestListParamIndex];
@@ -1548,10 +1602,11 @@ QString MockLink::_createRandomFile(uint32_t byteCount)
         return QString();
     }
 
-    for (uint32_t bytesWritten = 0; bytesWritten < byteCount; bytesWritten++) {
-        const unsigned char byte = (QRandomGenerator::global()->generate() * 0xFF) / RAND_MAX;
-        (void) tempFile.write(reinterpret_cast<const char*>(&byte), 1);
+    QByteArray bytes(byteCount, Qt::Uninitialized);
+    for (char &byte : bytes) {
+        byte = static_cast<char>(QRandomGenerator::global()->bounded(256));
     }
+    (void) tempFile.write(bytes);
 
     tempFile.close();
     return tempFile.fileName();
@@ -1578,14 +1633,21 @@ void MockLink::_handleLogRequestData(const mavlink_message_t &msg)
         return;
     }
 
-    // This will trigger _logDownloadWorker to send data
+    // This will trigger _logDownloadWorker to send data. A new request replaces the one in progress.
     _logDownloadCurrentOffset = request.ofs;
-    if (request.ofs + request.count > _logDownloadFileSize) {
+    if ((static_cast<uint64_t>(request.ofs) + request.count) > _logDownloadFileSize) {
         request.count = _logDownloadFileSize - request.ofs;
     }
     _logDownloadBytesRemaining = request.count;
 }
 
+void MockLink::_handleLogRequestEnd(const mavlink_message_t &msg)
+{
+    Q_UNUSED(msg);
+
+    _logDownloadBytesRemaining = 0;
+}
+
 void MockLink::_logDownloadWorker()
 {
     if (_logDownloadBytesRemaining == 0) {
@@ -1598,29 +1660,38 @@ void MockLink::_logDownloadWorker()
         return;
     }
 
-    uint8_t buffer[MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN]{};
+    for (int packet = 0; (packet < _logDownloadPacketsPerTick) && (_logDownloadBytesRemaining > 0); packet++) {
+        uint8_t buffer[MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN]{};
 
-    const qint64 bytesToRead = qMin(_logDownloadBytesRemaining, (uint32_t)MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN);
-    Q_ASSERT(file.seek(_logDownloadCurrentOffset));
-    Q_ASSERT(file.read(reinterpret_cast<char*>(buffer), bytesToRead) == bytesToRead);
+        const qint64 bytesToRead = qMin(_logDownloadBytesRemaining, (uint32_t)MAVLINK_MSG_LOG_DATA_FIELD_DATA_LEN);
+        if (!file.seek(_logDownloadCurrentOffset) || (file.read(reinterpret_cast<char*>(buffer), bytesToRead) != bytesToRead)) {
+            qCWarning(MockLinkLog) << "_logDownloadWorker read failed" << file.errorString();
+            _logDownloadBytesRemaining = 0;
+            break;
+        }
 
-    qCDebug(MockLinkLog) << "_logDownloadWorker" << _logDownloadCurrentOffset << _logDownloadBytesRemaining;
+        qCDebug(MockLinkLog) << "_logDownloadWorker" << _logDownloadCurrentOffset << _logDownloadBytesRemaining;
 
-    mavlink_message_t responseMsg{};
-    (void) mavlink_msg_log_data_pack_chan(
-        _vehicleSystemId,
-        _vehicleComponentId,
-        mavlinkChannel(),
-        &responseMsg,
-        _logDownloadLogId,
-        _logDownloadCurrentOffset,
-        bytesToRead,
-        &buffer[0]
-    );
-    respondWithMavlinkMessage(responseMsg);
+        const bool drop = (_logDownloadLossPercent > 0) && (static_cast<int>(QRandomGenerator::global()->bounded(100)) < _logDownloadLossPercent);
+        if (!drop) {
+            mavlink_message_t responseMsg{};
+            (void) mavlink_msg_log_data_pack_chan(
+                _vehicleSystemId,
+                _vehicleComponentId,
+                mavlinkChannel(),
+                &responseMsg,
+                _logDownloadLogId,
+                _logDownloadCurrentOffset,
+                bytesToRead,
+                &buffer[0]
+            );
+            respondWithMavlinkMessage(responseMsg);
+        }
 
-    _logDownloadCurrentOffset += bytesToRead;
-    _logDownloadBytesRemaining -= bytesToRead;
+        _logDownloadBytesSent += bytesToRead;
+        _logDownloadCurrentOffset += bytesToRead;
+        _logDownloadBytesRemaining -= bytesToRead;
+    }
 
     file.close();
 }
@@ -44,6 +44,7 @@ class MockLink : public LinkInterface
     bool shouldSendStatusText() const { return _sendStatusText; }
 
     bool isConnected() const final { return _connected; }
+    qint64 nominalBytesPerSecond() const final { return _linkBytesPerSecond; }
     void disconnect() final;
 
     Q_INVOKABLE void setCommLost(bool commLost) { _commLost = commLost; }
@@ -54,7 +55,8 @@ class MockLink : public LinkInterface
 
     void emitRemoteControlChannelRawChanged(int channel, uint16_t raw);
 
-    /// Sends the specified mavlink message to QGC
+    /// Sends the specified mavlink message to QGC. If the configuration sets a link rate the message is queued
+    /// and goes out once the simulated link has the bandwidth for it.
     void respondWithMavlinkMessage(const mavlink_message_t &msg);
 
     MockLinkFTP *mockLinkFTP() const;
@@ -81,6 +83,15 @@ class MockLink : public LinkInterface
     /// Returns the filename for the simulated log file. Only available after a download is requested.
     QString logDownloadFile() const { return _logDownloadFilename; }
 
+    /// Size of the simulated log file, must be set before the log list is requested
+    void setLogDownloadFileSize(uint32_t size) { _logDownloadFileSize = size; }
+
+    /// Percentage of LOG_DATA messages which are dropped, to simulate a lossy link
+    void setLogDownloadLossPercent(int percent) { _logDownloadLossPercent = percent; }
+
+    /// Number of log bytes sent to the vehicle so far, including dropped messages
+    uint64_t logDownloadBytesSent() const { return _logDownloadBytesSent; }
+
     void clearReceivedMavCommandCounts() { _receivedMavCommandCountMap.clear(); }
     int receivedMavCommandCount(MAV_CMD command) const { return _receivedMavCommandCountMap[command]; }
 
@@ -160,6 +171,7 @@ private slots:
     void _handleTakeoff(const mavlink_command_long_t &request);
     void _handleLogRequestList(const mavlink_message_t &msg);
     void _handleLogRequestData(const mavlink_message_t &msg);
+    void _handleLogRequestEnd(const mavlink_message_t &msg);
     void _handleParamMapRC(const mavlink_message_t &msg);
     bool _handleRequestMessage(const mavlink_command_long_t &request, bool &noAck);
 
@@ -182,6 +194,9 @@ private slots:
     void _sendVideoInfo();
     void _sendAvailableModesMonitor();
 
+    void _sendRateLimitedBytes();
+    /// true: The simulated link is backed up, so streams should hold off
+    bool _linkBacklogged();
     void _paramRequestListWorker();
     void _logDownloadWorker();
     void _availableModesWorker();
@@ -212,6 +227,7 @@ private slots:
     // They do not control any mock simulation (and it is up to the Custom build to do that).
     const uint16_t _boardVendorId = 0;
     const uint16_t _boardProductId = 0;
+    const int _linkBytesPerSecond = 0;
     MockLinkMissionItemHandler *const _missionItemHandler = nullptr;
     MockLinkFTP *const _mockLinkFTP = nullptr;
 
@@ -236,6 +252,11 @@ private slots:
 
     double _vehicleAltitudeAMSL = _defaultVehicleHomeAltitude;
     bool _commLost = false;
+
+    QMutex _rateLimitedMutex;
+    QByteArray _rateLimitedBytes;                       ///< Bytes waiting for link bandwidth, only used with a link rate
+    QElapsedTimer _rateLimitedTimer;
+    qint64 _rateLimitedBudget = 0;                      ///< Bytes which can be sent now
     bool _highLatencyTransmissionEnabled = true;
 
     int _sendHomePositionDelayCount = 10;               ///< No home position for 4 seconds
@@ -251,6 +272,9 @@ private slots:
     QString _logDownloadFilename;                       ///< Filename for log download which is in progress
     uint32_t _logDownloadCurrentOffset = 0;             ///< Current offset we are sending from
     uint32_t _logDownloadBytesRemaining = 0;            ///< Number of bytes still to send, 0 = send inactive
+    uint32_t _logDownloadFileSize = 1000;               ///< Size of simulated log file
+    int _logDownloadLossPercent = 0;                    ///< Percentage of LOG_DATA messages dropped
+    uint64_t _logDownloadBytesSent = 0;                 ///< Total log bytes sent, including dropped messages
 
     RequestMessageFailureMode_t _requestMessageFailureMode = FailRequestMessageNone;
 
@@ -281,7 +305,7 @@ private slots:
     static constexpr uint8_t _vehicleComponentId = MAV_COMP_ID_AUTOPILOT1;
 
     static constexpr uint16_t _logDownloadLogId = 0;        ///< Id of siumulated log file
-    static constexpr uint32_t _logDownloadFileSize = 1000;  ///< Size of simulated log file
+    static constexpr int _logDownloadPacketsPerTick = 4;    ///< LOG_DATA messages sent per 500Hz tick
 
     static constexpr bool _mavlinkStarted = true;
 
@@ -25,6 +25,10 @@ MockLinkFTP::MockLinkFTP(uint8_t systemIdServer, uint8_t componentIdServer, Mock
 
 MockLinkFTP::~MockLinkFTP()
 {
+    for (int i = 0; i < _maxSessionsSupported; i++) {
+        _closeSession(i);
+    }
+
     // qCDebug(MockLinkFTPLog) << Q_FUNC_INFO << this;
 }
 
@@ -109,7 +113,18 @@ void MockLinkFTP::_openCommand(uint8_t senderSystemId, uint8_t senderComponentId
     Q_ASSERT(cchPath != sizeof(request->data));
     Q_UNUSED(cchPath); // Fix initialized-but-not-referenced warning on release builds
 
-    _currentFile.close();
+    int sessionIndex = -1;
+    for (int i = 0; i < _maxSessions; i++) {
+        if (!_sessionFiles[i].isOpen()) {
+            sessionIndex = i;
+            break;
+        }
+    }
+    if (sessionIndex < 0) {
+        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrNoSessionsAvailable, outgoingSeqNumber, MavlinkFTP::kCmdOpenFileRO);
+        return;
+    }
+    QFile &currentFile = _sessionFiles[sessionIndex];
 
     QString tmpFilename;
     const QString sizePrefix = sizeFilenamePrefix;
@@ -129,9 +144,9 @@ void MockLinkFTP::_openCommand(uint8_t senderSystemId, uint8_t senderComponentId
     }
 
     if (!tmpFilename.isEmpty()) {
-        _currentFile.setFileName(tmpFilename);
-        if (!_currentFile.open(QIODevice::ReadOnly)) {
-            _sendNakErrno(senderSystemId, senderComponentId, _currentFile.error(), outgoingSeqNumber, MavlinkFTP::kCmdOpenFileRO);
+        currentFile.setFileName(tmpFilename);
+        if (!currentFile.open(QIODevice::ReadOnly)) {
+            _sendNakErrno(senderSystemId, senderComponentId, currentFile.error(), outgoingSeqNumber, MavlinkFTP::kCmdOpenFileRO);
             return;
         }
     } else {
@@ -141,13 +156,16 @@ void MockLinkFTP::_openCommand(uint8_t senderSystemId, uint8_t senderComponentId
 
     response.hdr.opcode = MavlinkFTP::kRspAck;
     response.hdr.req_opcode = MavlinkFTP::kCmdOpenFileRO;
-    response.hdr.session = _sessionId;
+    response.hdr.session = static_cast<uint8_t>(sessionIndex + 1);
 
     // Data contains file length
     response.hdr.size = sizeof(uint32_t);
 
     // Ardupilot sends constant wrong file size for parameter file due to dynamic on the fly generation
-    response.openFileLength = ((path == "@PARAM/param.pck") ? qPow(1024, 2) : _currentFile.size());
+    response.openFileLength = ((path == "@PARAM/param.pck") ? qPow(1024, 2) : currentFile.size());
+    if (_reportedFileSize >= 0) {
+        response.openFileLength = _reportedFileSize;
+    }
 
     _sendResponse(senderSystemId, senderComponentId, &response, outgoingSeqNumber);
 }
@@ -157,8 +175,9 @@ void MockLinkFTP::_readCommand(uint8_t senderSystemId, uint8_t senderComponentId
     MavlinkFTP::Request	response{};
     const uint16_t outgoingSeqNumber = _nextSeqNumber(seqNumber);
 
-    if (request->hdr.session != _sessionId) {
-        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrInvalidSession, outgoingSeqNumber, MavlinkFTP::kCmdReadFile);
+    QFile *const currentFile = _sessionFile(request->hdr.session);
+    if (!currentFile) {
+        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrInvalidSession, outgoingSeqNumber, MavlinkFTP::kCmdReadFile, request->hdr.session);
         return;
     }
 
@@ -167,7 +186,7 @@ void MockLinkFTP::_readCommand(uint8_t senderSystemId, uint8_t senderComponentId
         // If we get here it means the client is requesting additional data past the first request
         if (_errMode == errModeNakSecondResponse) {
             // Nak error all subsequent requests
-            _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrFail, outgoingSeqNumber, MavlinkFTP::kCmdReadFile);
+            _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrFail, outgoingSeqNumber, MavlinkFTP::kCmdReadFile, request->hdr.session);
             return;
         }
 
@@ -177,20 +196,21 @@ void MockLinkFTP::_readCommand(uint8_t senderSystemId, uint8_t senderComponentId
         }
     }
 
-    if (readOffset >= _currentFile.size()) {
-        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrEOF, outgoingSeqNumber, MavlinkFTP::kCmdReadFile);
+    if (readOffset >= currentFile->size()) {
+        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrEOF, outgoingSeqNumber, MavlinkFTP::kCmdReadFile, request->hdr.session);
         return;
     }
 
-    const uint8_t cBytesToRead = static_cast<uint8_t>(qMin(static_cast<qint64>(sizeof(response.data)), _currentFile.size() - readOffset));
-    (void) _currentFile.seek(readOffset);
-    const QByteArray bytes = _currentFile.read(cBytesToRead);
+    const qint64 cBytesRequested = ((request->hdr.size > 0) && (request->hdr.size < sizeof(response.data))) ? request->hdr.size : sizeof(response.data);
+    const uint8_t cBytesToRead = static_cast<uint8_t>(qMin(cBytesRequested, currentFile->size() - readOffset));
+    (void) currentFile->seek(readOffset);
+    const QByteArray bytes = currentFile->read(cBytesToRead);
     (void) memcpy(response.data, bytes.constData(), cBytesToRead);
 
     // We should always have written something, otherwise there is something wrong with the code above
     Q_ASSERT(cBytesToRead);
 
-    response.hdr.session = _sessionId;
+    response.hdr.session = request->hdr.session;
     response.hdr.size = cBytesToRead;
     response.hdr.offset = request->hdr.offset;
     response.hdr.opcode = MavlinkFTP::kRspAck;
@@ -204,8 +224,9 @@ void MockLinkFTP::_burstReadCommand(uint8_t senderSystemId, uint8_t senderCompon
     MavlinkFTP::Request response{};
     uint16_t outgoingSeqNumber = _nextSeqNumber(seqNumber);
 
-    if (request->hdr.session != _sessionId) {
-        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrFail, outgoingSeqNumber, MavlinkFTP::kCmdBurstReadFile);
+    QFile *const currentFile = _sessionFile(request->hdr.session);
+    if (!currentFile) {
+        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrFail, outgoingSeqNumber, MavlinkFTP::kCmdBurstReadFile, request->hdr.session);
         return;
     }
 
@@ -213,16 +234,16 @@ void MockLinkFTP::_burstReadCommand(uint8_t senderSystemId, uint8_t senderCompon
     int burstCount = 1;
     uint32_t burstOffset = request->hdr.offset;
 
-    while ((burstOffset < _currentFile.size()) && (burstCount++ < burstMax)) {
-        _currentFile.seek(burstOffset);
+    while ((burstOffset < currentFile->size()) && (burstCount++ < burstMax)) {
+        (void) currentFile->seek(burstOffset);
 
-        const uint8_t cBytes = static_cast<uint8_t>(qMin(static_cast<qint64>(sizeof(response.data)), _currentFile.size() - burstOffset));
-        const QByteArray bytes = _currentFile.read(cBytes);
+        const uint8_t cBytes = static_cast<uint8_t>(qMin(static_cast<qint64>(sizeof(response.data)), currentFile->size() - burstOffset));
+        const QByteArray bytes = currentFile->read(cBytes);
         Q_ASSERT(cBytes); // We should always have written something, otherwise there is something wrong with the code above
 
         (void) memcpy(response.data, bytes.constData(), cBytes);
 
-        response.hdr.session = _sessionId;
+        response.hdr.session = request->hdr.session;
         response.hdr.size = cBytes;
         response.hdr.offset = burstOffset;
         response.hdr.opcode = MavlinkFTP::kRspAck;
@@ -235,9 +256,9 @@ void MockLinkFTP::_burstReadCommand(uint8_t senderSystemId, uint8_t senderCompon
         burstOffset += cBytes;
     }
 
-    if (burstOffset >= _currentFile.size()) {
+    if (burstOffset >= currentFile->size()) {
         // Burst is fully complete
-        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrEOF, outgoingSeqNumber, MavlinkFTP::kCmdBurstReadFile);
+        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrEOF, outgoingSeqNumber, MavlinkFTP::kCmdBurstReadFile, request->hdr.session);
     }
 }
 
@@ -245,12 +266,13 @@ void MockLinkFTP::_terminateCommand(uint8_t senderSystemId, uint8_t senderCompon
 {
     const uint16_t outgoingSeqNumber = _nextSeqNumber(seqNumber);
 
-    if (request->hdr.session != _sessionId) {
-        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrInvalidSession, outgoingSeqNumber, MavlinkFTP::kCmdTerminateSession);
+    if (!_sessionFile(request->hdr.session)) {
+        _sendNak(senderSystemId, senderComponentId, MavlinkFTP::kErrInvalidSession, outgoingSeqNumber, MavlinkFTP::kCmdTerminateSession, request->hdr.session);
         return;
     }
 
-    _sendAck(senderSystemId, senderComponentId, outgoingSeqNumber, MavlinkFTP::kCmdTerminateSession);
+    _closeSession(request->hdr.session - 1);
+    _sendAck(senderSystemId, senderComponentId, outgoingSeqNumber, MavlinkFTP::kCmdTerminateSession, request->hdr.session);
 
     emit terminateCommandReceived();
 }
@@ -259,8 +281,9 @@ void MockLinkFTP::_resetCommand(uint8_t senderSystemId, uint8_t senderComponentI
 {
     const uint16_t outgoingSeqNumber = _nextSeqNumber(seqNumber);
 
-    _currentFile.close();
-    _currentFile.remove();
+    for (int i = 0; i < _maxSessionsSupported; i++) {
+        _closeSession(i);
+    }
     _sendAck(senderSystemId, senderComponentId, outgoingSeqNumber, MavlinkFTP::kCmdResetSessions);
 
     emit resetCommandReceived();
@@ -282,8 +305,8 @@ void MockLinkFTP::mavlinkMessageReceived(const mavlink_message_t &message)
     MavlinkFTP::Request *request = reinterpret_cast<MavlinkFTP::Request*>(&requestFTP.payload[0]);
 
     // kCmdOpenFileRO and kCmdResetSessions don't support retry so we can't drop those
-    if (_randomDropsEnabled && (request->hdr.opcode != MavlinkFTP::kCmdOpenFileRO) && (request->hdr.opcode != MavlinkFTP::kCmdResetSessions)) {
-        if ((rand() % 5) == 0) {
+    if ((request->hdr.opcode != MavlinkFTP::kCmdOpenFileRO) && (request->hdr.opcode != MavlinkFTP::kCmdResetSessions)) {
+        if (_randomDrop()) {
             qCDebug(MockLinkFTPLog) << "MockLinkFTP: Random drop of incoming packet";
             return;
         }
@@ -347,38 +370,38 @@ void MockLinkFTP::mavlinkMessageReceived(const mavlink_message_t &message)
     }
 }
 
-void MockLinkFTP::_sendAck(uint8_t targetSystemId, uint8_t targetComponentId, uint16_t seqNumber, MavlinkFTP::OpCode_t reqOpcode)
+void MockLinkFTP::_sendAck(uint8_t targetSystemId, uint8_t targetComponentId, uint16_t seqNumber, MavlinkFTP::OpCode_t reqOpcode, uint8_t session)
 {
     MavlinkFTP::Request ackResponse{};
 
     ackResponse.hdr.opcode = MavlinkFTP::kRspAck;
     ackResponse.hdr.req_opcode = reqOpcode;
-    ackResponse.hdr.session = _sessionId;
+    ackResponse.hdr.session = session;
     ackResponse.hdr.size = 0;
 
     _sendResponse(targetSystemId, targetComponentId, &ackResponse, seqNumber);
 }
 
-void MockLinkFTP::_sendNak(uint8_t targetSystemId, uint8_t targetComponentId, MavlinkFTP::ErrorCode_t error, uint16_t seqNumber, MavlinkFTP::OpCode_t reqOpcode)
+void MockLinkFTP::_sendNak(uint8_t targetSystemId, uint8_t targetComponentId, MavlinkFTP::ErrorCode_t error, uint16_t seqNumber, MavlinkFTP::OpCode_t reqOpcode, uint8_t session)
 {
     MavlinkFTP::Request nakResponse{};
 
     nakResponse.hdr.opcode = MavlinkFTP::kRspNak;
     nakResponse.hdr.req_opcode = reqOpcode;
-    nakResponse.hdr.session = _sessionId;
+    nakResponse.hdr.session = session;
     nakResponse.hdr.size = 1;
     nakResponse.data[0] = error;
 
     _sendResponse(targetSystemId, targetComponentId, &nakResponse, seqNumber);
 }
 
-void MockLinkFTP::_sendNakErrno(uint8_t targetSystemId, uint8_t targetComponentId, uint8_t nakErrno, uint16_t seqNumber, MavlinkFTP::OpCode_t reqOpcode)
+void MockLinkFTP::_sendNakErrno(uint8_t targetSystemId, uint8_t targetComponentId, uint8_t nakErrno, uint16_t seqNumber, MavlinkFTP::OpCode_t reqOpcode, uint8_t session)
 {
     MavlinkFTP::Request nakResponse{};
 
     nakResponse.hdr.opcode = MavlinkFTP::kRspNak;
     nakResponse.hdr.req_opcode = reqOpcode;
-    nakResponse.hdr.session = _sessionId;
+    nakResponse.hdr.session = session;
     nakResponse.hdr.size = 2;
     nakResponse.data[0] = MavlinkFTP::kErrFailErrno;
     nakResponse.data[1] = nakErrno;
@@ -405,8 +428,8 @@ void MockLinkFTP::_sendResponse(uint8_t targetSystemId, uint8_t targetComponentI
     );
 
     // kCmdOpenFileRO and kCmdResetSessions don't support retry so we can't drop those
-    if (_randomDropsEnabled && (request->hdr.req_opcode != MavlinkFTP::kCmdOpenFileRO) && (request->hdr.req_opcode != MavlinkFTP::kCmdResetSessions)) {
-        if ((rand() % 5) == 0) {
+    if ((request->hdr.req_opcode != MavlinkFTP::kCmdOpenFileRO) && (request->hdr.req_opcode != MavlinkFTP::kCmdResetSessions)) {
+        if (_randomDrop()) {
             qCDebug(MockLinkFTPLog) << "MockLinkFTP: Random drop of outgoing packet";
             return;
         }
@@ -427,14 +450,43 @@ uint16_t MockLinkFTP::_nextSeqNumber(uint16_t seqNumber) const
     return outgoingSeqNumber;
 }
 
+QFile *MockLinkFTP::_sessionFile(uint8_t session)
+{
+    if ((session < 1) || (session > _maxSessionsSupported) || !_sessionFiles[session - 1].isOpen()) {
+        return nullptr;
+    }
+
+    return &_sessionFiles[session - 1];
+}
+
+void MockLinkFTP::_closeSession(int index)
+{
+    QFile &file = _sessionFiles[index];
+    if (!file.isOpen()) {
+        return;
+    }
+
+    file.close();
+    if (!file.fileName().startsWith(QLatin1Char(':'))) {
+        (void) file.remove();
+    }
+}
+
+bool MockLinkFTP::_randomDrop() const
+{
+    return ((_randomDropPercent > 0) && ((rand() % 100) < _randomDropPercent));
+}
+
 QString MockLinkFTP::_createTestTempFile(int size)
 {
     QGCTemporaryFile tmpFile("MockLinkFTPTestCase");
 
     if (tmpFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        QByteArray bytes(size, Qt::Uninitialized);
         for (int i = 0; i < size; i++) {
-            (void) tmpFile.write(QByteArray(1, i % 255));
+            bytes[i] = static_cast<char>(i % 255);
         }
+        (void) tmpFile.write(bytes);
         tmpFile.close();
     }
 
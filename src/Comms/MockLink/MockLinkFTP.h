@@ -36,9 +36,18 @@ class MockLinkFTP : public QObject
     /// Called to handle an FTP message
     void mavlinkMessageReceived(const mavlink_message_t &message);
 
-    void enableRandromDrops(bool enable) { _randomDropsEnabled = enable; }
+    void enableRandromDrops(bool enable) { _randomDropPercent = enable ? 20 : 0; }
+
+    /// Percentage of packets dropped in each direction, 0 disables drops
+    void setRandomDropPercent(int percent) { _randomDropPercent = percent; }
+
+    /// Number of sessions which can be open at once, extra opens are Nak'ed with kErrNoSessionsAvailable
+    void setMaxSessions(int maxSessions) { _maxSessions = qBound(1, maxSessions, _maxSessionsSupported); }
     void enableBinParamFile(bool enable) { _BinParamFileEnabled = enable; }
 
+    /// Overrides the file size sent in open responses, like a vehicle which generates the file on the fly. -1 sends the real size.
+    void setReportedFileSize(int size) { _reportedFileSize = size; }
+
     /// By calling setErrorMode with one of these modes you can cause the server to simulate an error.
     enum ErrorMode_t {
         errModeNone,                        ///< No error, respond correctly
@@ -78,9 +87,9 @@ class MockLinkFTP : public QObject
 
 private:
     /// Sends an Ack
-    void _sendAck(uint8_t targetSystemId, uint8_t targetComponentId, uint16_t seqNumber, MavlinkFTP::OpCode_t reqOpCode);
-    void _sendNak(uint8_t targetSystemId, uint8_t targetComponentId, MavlinkFTP::ErrorCode_t error, uint16_t seqNumber, MavlinkFTP::OpCode_t reqOpCode);
-    void _sendNakErrno(uint8_t targetSystemId, uint8_t targetComponentId, uint8_t nakErrno, uint16_t seqNumber, MavlinkFTP::OpCode_t reqOpCode);
+    void _sendAck(uint8_t targetSystemId, uint8_t targetComponentId, uint16_t seqNumber, MavlinkFTP::OpCode_t reqOpCode, uint8_t session = 0);
+    void _sendNak(uint8_t targetSystemId, uint8_t targetComponentId, MavlinkFTP::ErrorCode_t error, uint16_t seqNumber, MavlinkFTP::OpCode_t reqOpCode, uint8_t session = 0);
+    void _sendNakErrno(uint8_t targetSystemId, uint8_t targetComponentId, uint8_t nakErrno, uint16_t seqNumber, MavlinkFTP::OpCode_t reqOpCode, uint8_t session = 0);
     /// Emits a Request through the messageReceived signal.
     void _sendResponse(uint8_t targetSystemId, uint8_t targetComponentId, MavlinkFTP::Request *request, uint16_t seqNumber);
     /// Handles List command requests. Only supports root folder paths.
@@ -94,6 +103,10 @@ class MockLinkFTP : public QObject
     /// Generates the next sequence number given an incoming sequence number. Handles generating
     /// bad sequence numbers when errModeBadSequence is set.
     uint16_t _nextSeqNumber(uint16_t seqNumber) const;
+    /// Returns the open file for the session, nullptr if the session is not open
+    QFile *_sessionFile(uint8_t session);
+    void _closeSession(int index);
+    bool _randomDrop() const;
     static QString _createTestTempFile(int size);
 
     /// if request is a string, this ensures it's null-terminated
@@ -103,15 +116,17 @@ class MockLinkFTP : public QObject
     const uint8_t _componentIdServer;           ///< Component ID for server
     MockLink *_mockLink;                        ///< MockLink to communicate through
 
+    static constexpr int _maxSessionsSupported = 8;
+
     bool _BinParamFileEnabled = false;
     bool _lastReplyValid = false;
-    bool _randomDropsEnabled = false;
+    int _randomDropPercent = 0;
+    int _maxSessions = _maxSessionsSupported;
+    int _reportedFileSize = -1;
     ErrorMode_t _errMode = errModeNone;         ///< Currently set error mode, as specified by setErrorMode
     mavlink_message_t _lastReply{};
-    QFile _currentFile;
+    QFile _sessionFiles[_maxSessionsSupported]; ///< Session id is the index + 1
     QStringList _fileList;                      ///< List of files returned by List command
     uint16_t _lastReplySequence = 0;
-
-    static constexpr uint8_t _sessionId = 1;    ///< We only support a single fixed session
 };
 
@@ -0,0 +1,204 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MockSwarmConfiguration.h"
+#include "QGCLoggingCategory.h"
+
+QGC_LOGGING_CATEGORY(MockSwarmConfigurationLog, "qgc.comms.mocklink.mockswarmconfiguration")
+
+MockSwarmConfiguration::MockSwarmConfiguration(const QString &name, QObject *parent)
+    : LinkConfiguration(name, parent)
+{
+    // qCDebug(MockSwarmConfigurationLog) << Q_FUNC_INFO << this;
+}
+
+MockSwarmConfiguration::MockSwarmConfiguration(const MockSwarmConfiguration *copy, QObject *parent)
+    : LinkConfiguration(copy, parent)
+    , _vehicleCount(copy->_vehicleCount)
+    , _firstSystemId(copy->firstSystemId())
+    , _workerThreads(copy->workerThreads())
+    , _packetLossPercent(copy->packetLossPercent())
+    , _latencyMsecs(copy->latencyMsecs())
+    , _latencyJitterMsecs(copy->latencyJitterMsecs())
+    , _burstIntervalMsecs(copy->burstIntervalMsecs())
+    , _burstLengthMsecs(copy->burstLengthMsecs())
+    , _randomSeed(copy->randomSeed())
+{
+    // qCDebug(MockSwarmConfigurationLog) << Q_FUNC_INFO << this;
+
+    for (int i = 0; i < MessageCount; i++) {
+        _messageRates[i] = copy->messageRate(static_cast<Message_t>(i));
+    }
+}
+
+MockSwarmConfiguration::~MockSwarmConfiguration()
+{
+    // qCDebug(MockSwarmConfigurationLog) << Q_FUNC_INFO << this;
+}
+
+void MockSwarmConfiguration::setVehicleCount(int vehicleCount)
+{
+    vehicleCount = qBound(1, vehicleCount, kMaxVehicleCount);
+    if (vehicleCount != _vehicleCount) {
+        const int previousCount = this->vehicleCount();
+        _vehicleCount = vehicleCount;
+        if (this->vehicleCount() != previousCount) {
+            emit vehicleCountChanged();
+        }
+    }
+}
+
+void MockSwarmConfiguration::setFirstSystemId(int firstSystemId)
+{
+    firstSystemId = qBound(1, firstSystemId, kMaxSystemId);
+    if (firstSystemId != _firstSystemId) {
+        const int previousCount = vehicleCount();
+        _firstSystemId = firstSystemId;
+        emit firstSystemIdChanged();
+        if (vehicleCount() != previousCount) {
+            emit vehicleCountChanged();
+        }
+    }
+}
+
+void MockSwarmConfiguration::setWorkerThreads(int workerThreads)
+{
+    workerThreads = qMax(1, workerThreads);
+    if (workerThreads != _workerThreads) {
+        _workerThreads = workerThreads;
+        emit workerThreadsChanged();
+    }
+}
+
+void MockSwarmConfiguration::setMessageRate(Message_t message, double rateHz)
+{
+    rateHz = qBound(0., rateHz, 1000.);
+    if (rateHz != _messageRates[message]) {
+        _messageRates[message] = rateHz;
+        emit messageRatesChanged();
+    }
+}
+
+void MockSwarmConfiguration::setPacketLossPercent(double packetLossPercent)
+{
+    packetLossPercent = qBound(0., packetLossPercent, 100.);
+    if (packetLossPercent != _packetLossPercent) {
+        _packetLossPercent = packetLossPercent;
+        emit packetLossPercentChanged();
+    }
+}
+
+void MockSwarmConfiguration::setLatencyMsecs(int latencyMsecs)
+{
+    latencyMsecs = qMax(0, latencyMsecs);
+    if (latencyMsecs != _latencyMsecs) {
+        _latencyMsecs = latencyMsecs;
+        emit latencyChanged();
+    }
+}
+
+void MockSwarmConfiguration::setLatencyJitterMsecs(int latencyJitterMsecs)
+{
+    latencyJitterMsecs = qMax(0, latencyJitterMsecs);
+    if (latencyJitterMsecs != _latencyJitterMsecs) {
+        _latencyJitterMsecs = latencyJitterMsecs;
+        emit latencyChanged();
+    }
+}
+
+void MockSwarmConfiguration::setBurstIntervalMsecs(int burstIntervalMsecs)
+{
+    burstIntervalMsecs = qMax(0, burstIntervalMsecs);
+    if (burstIntervalMsecs != _burstIntervalMsecs) {
+        _burstIntervalMsecs = burstIntervalMsecs;
+        emit burstChanged();
+    }
+}
+
+void MockSwarmConfiguration::setBurstLengthMsecs(int burstLengthMsecs)
+{
+    burstLengthMsecs = qMax(0, burstLengthMsecs);
+    if (burstLengthMsecs != _burstLengthMsecs) {
+        _burstLengthMsecs = burstLengthMsecs;
+        emit burstChanged();
+    }
+}
+
+void MockSwarmConfiguration::setRandomSeed(quint32 randomSeed)
+{
+    if (randomSeed != _randomSeed) {
+        _randomSeed = randomSeed;
+        emit randomSeedChanged();
+    }
+}
+
+void MockSwarmConfiguration::copyFrom(const LinkConfiguration *source)
+{
+    Q_ASSERT(source);
+    LinkConfiguration::copyFrom(source);
+
+    const MockSwarmConfiguration *const swarmSource = qobject_cast<const MockSwarmConfiguration*>(source);
+    Q_ASSERT(swarmSource);
+
+    setVehicleCount(swarmSource->_vehicleCount);
+    setFirstSystemId(swarmSource->firstSystemId());
+    setWorkerThreads(swarmSource->workerThreads());
+    for (int i = 0; i < MessageCount; i++) {
+        setMessageRate(static_cast<Message_t>(i), swarmSource->messageRate(static_cast<Message_t>(i)));
+    }
+    setPacketLossPercent(swarmSource->packetLossPercent());
+    setLatencyMsecs(swarmSource->latencyMsecs());
+    setLatencyJitterMsecs(swarmSource->latencyJitterMsecs());
+    setBurstIntervalMsecs(swarmSource->burstIntervalMsecs());
+    setBurstLengthMsecs(swarmSource->burstLengthMsecs());
+    setRandomSeed(swarmSource->randomSeed());
+}
+
+void MockSwarmConfiguration::loadSettings(QSettings &settings, const QString &root)
+{
+    settings.beginGroup(root);
+
+    setVehicleCount(settings.value(_vehicleCountKey, _vehicleCount).toInt());
+    setFirstSystemId(settings.value(_firstSystemIdKey, _firstSystemId).toInt());
+    setWorkerThreads(settings.value(_workerThreadsKey, _workerThreads).toInt());
+    const QVariantList rates = settings.value(_messageRatesKey).toList();
+    for (int i = 0; i < qMin(static_cast<int>(rates.count()), static_cast<int>(MessageCount)); i++) {
+        setMessageRate(static_cast<Message_t>(i), rates[i].toDouble());
+    }
+    setPacketLossPercent(settings.value(_packetLossPercentKey, _packetLossPercent).toDouble());
+    setLatencyMsecs(settings.value(_latencyMsecsKey, _latencyMsecs).toInt());
+    setLatencyJitterMsecs(settings.value(_latencyJitterMsecsKey, _latencyJitterMsecs).toInt());
+    setBurstIntervalMsecs(settings.value(_burstIntervalMsecsKey, _burstIntervalMsecs).toInt());
+    setBurstLengthMsecs(settings.value(_burstLengthMsecsKey, _burstLengthMsecs).toInt());
+    setRandomSeed(settings.value(_randomSeedKey, _randomSeed).toUInt());
+
+    settings.endGroup();
+}
+
+void MockSwarmConfiguration::saveSettings(QSettings &settings, const QString &root) const
+{
+    settings.beginGroup(root);
+
+    settings.setValue(_vehicleCountKey, _vehicleCount);
+    settings.setValue(_firstSystemIdKey, _firstSystemId);
+    settings.setValue(_workerThreadsKey, _workerThreads);
+    QVariantList rates;
+    for (const double rate : _messageRates) {
+        rates.append(rate);
+    }
+    settings.setValue(_messageRatesKey, rates);
+    settings.setValue(_packetLossPercentKey, _packetLossPercent);
+    settings.setValue(_latencyMsecsKey, _latencyMsecs);
+    settings.setValue(_latencyJitterMsecsKey, _latencyJitterMsecs);
+    settings.setValue(_burstIntervalMsecsKey, _burstIntervalMsecs);
+    settings.setValue(_burstLengthMsecsKey, _burstLengthMsecs);
+    settings.setValue(_randomSeedKey, _randomSeed);
+
+    settings.endGroup();
+}
@@ -0,0 +1,147 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "LinkConfiguration.h"
+
+#include <QtCore/QLoggingCategory>
+
+Q_DECLARE_LOGGING_CATEGORY(MockSwarmConfigurationLog)
+
+/// Settings for a MockSwarmLink: how many vehicles, which messages they stream at what rates, and how the
+/// simulated radio link between them and QGC misbehaves.
+class MockSwarmConfiguration : public LinkConfiguration
+{
+    Q_OBJECT
+    Q_PROPERTY(int      vehicleCount        READ vehicleCount       WRITE setVehicleCount       NOTIFY vehicleCountChanged)
+    Q_PROPERTY(int      firstSystemId       READ firstSystemId      WRITE setFirstSystemId      NOTIFY firstSystemIdChanged)
+    Q_PROPERTY(int      workerThreads       READ workerThreads      WRITE setWorkerThreads      NOTIFY workerThreadsChanged)
+    Q_PROPERTY(double   attitudeRate        READ attitudeRate       WRITE setAttitudeRate       NOTIFY messageRatesChanged)
+    Q_PROPERTY(double   globalPositionRate  READ globalPositionRate WRITE setGlobalPositionRate NOTIFY messageRatesChanged)
+    Q_PROPERTY(double   vfrHudRate          READ vfrHudRate         WRITE setVfrHudRate         NOTIFY messageRatesChanged)
+    Q_PROPERTY(double   sysStatusRate       READ sysStatusRate      WRITE setSysStatusRate      NOTIFY messageRatesChanged)
+    Q_PROPERTY(double   escStatusRate       READ escStatusRate      WRITE setEscStatusRate      NOTIFY messageRatesChanged)
+    Q_PROPERTY(double   adsbRate            READ adsbRate           WRITE setAdsbRate           NOTIFY messageRatesChanged)
+    Q_PROPERTY(double   packetLossPercent   READ packetLossPercent  WRITE setPacketLossPercent  NOTIFY packetLossPercentChanged)
+    Q_PROPERTY(int      latencyMsecs        READ latencyMsecs       WRITE setLatencyMsecs       NOTIFY latencyChanged)
+    Q_PROPERTY(int      latencyJitterMsecs  READ latencyJitterMsecs WRITE setLatencyJitterMsecs NOTIFY latencyChanged)
+    Q_PROPERTY(int      burstIntervalMsecs  READ burstIntervalMsecs WRITE setBurstIntervalMsecs NOTIFY burstChanged)
+    Q_PROPERTY(int      burstLengthMsecs    READ burstLengthMsecs   WRITE setBurstLengthMsecs   NOTIFY burstChanged)
+    Q_PROPERTY(quint32  randomSeed          READ randomSeed         WRITE setRandomSeed         NOTIFY randomSeedChanged)
+
+public:
+    explicit MockSwarmConfiguration(const QString &name, QObject *parent = nullptr);
+    explicit MockSwarmConfiguration(const MockSwarmConfiguration *copy, QObject *parent = nullptr);
+    ~MockSwarmConfiguration();
+
+    LinkType type() const final { return LinkConfiguration::TypeMockSwarm; }
+    void copyFrom(const LinkConfiguration *source) final;
+    void loadSettings(QSettings &settings, const QString &root) final;
+    void saveSettings(QSettings &settings, const QString &root) const final;
+    QString settingsURL() const final { return QStringLiteral("MockSwarmLinkSettings.qml"); }
+    QString settingsTitle() const final { return tr("Mock Swarm Link Settings"); }
+
+    /// Streamed messages, indices into the rate table. Heartbeats are always sent at 1Hz.
+    enum Message_t {
+        MessageAttitude,
+        MessageGlobalPositionInt,
+        MessageVfrHud,
+        MessageSysStatus,
+        MessageEscStatus,
+        MessageAdsbVehicle,
+        MessageCount
+    };
+
+    /// At most enough vehicles to reach kMaxSystemId from firstSystemId. The count asked for is kept, so it comes
+    /// back once firstSystemId is lowered again and the order the two are set in does not matter.
+    int vehicleCount() const { return qMin(_vehicleCount, kMaxSystemId - _firstSystemId + 1); }
+    void setVehicleCount(int vehicleCount);
+    int firstSystemId() const { return _firstSystemId; }
+    void setFirstSystemId(int firstSystemId);
+    int workerThreads() const { return _workerThreads; }
+    void setWorkerThreads(int workerThreads);
+
+    /// @return Rate in Hz, 0 if the message is not sent
+    double messageRate(Message_t message) const { return _messageRates[message]; }
+    void setMessageRate(Message_t message, double rateHz);
+    double attitudeRate() const { return messageRate(MessageAttitude); }
+    void setAttitudeRate(double rateHz) { setMessageRate(MessageAttitude, rateHz); }
+    double globalPositionRate() const { return messageRate(MessageGlobalPositionInt); }
+    void setGlobalPositionRate(double rateHz) { setMessageRate(MessageGlobalPositionInt, rateHz); }
+    double vfrHudRate() const { return messageRate(MessageVfrHud); }
+    void setVfrHudRate(double rateHz) { setMessageRate(MessageVfrHud, rateHz); }
+    double sysStatusRate() const { return messageRate(MessageSysStatus); }
+    void setSysStatusRate(double rateHz) { setMessageRate(MessageSysStatus, rateHz); }
+    double escStatusRate() const { return messageRate(MessageEscStatus); }
+    void setEscStatusRate(double rateHz) { setMessageRate(MessageEscStatus, rateHz); }
+    double adsbRate() const { return messageRate(MessageAdsbVehicle); }
+    void setAdsbRate(double rateHz) { setMessageRate(MessageAdsbVehicle, rateHz); }
+
+    double packetLossPercent() const { return _packetLossPercent; }
+    void setPacketLossPercent(double packetLossPercent);
+    int latencyMsecs() const { return _latencyMsecs; }
+    void setLatencyMsecs(int latencyMsecs);
+    int latencyJitterMsecs() const { return _latencyJitterMsecs; }
+    void setLatencyJitterMsecs(int latencyJitterMsecs);
+
+    /// Every burstIntervalMsecs the link holds back all traffic for burstLengthMsecs and then delivers it at once,
+    /// the way a buffering radio does. 0 disables bursts.
+    int burstIntervalMsecs() const { return _burstIntervalMsecs; }
+    void setBurstIntervalMsecs(int burstIntervalMsecs);
+    int burstLengthMsecs() const { return _burstLengthMsecs; }
+    void setBurstLengthMsecs(int burstLengthMsecs);
+
+    /// Seeds packet loss, jitter and message phase so runs are reproducible
+    quint32 randomSeed() const { return _randomSeed; }
+    void setRandomSeed(quint32 randomSeed);
+
+    static constexpr int kMaxVehicleCount = 250;        ///< System ids are 8 bit, use more links with different firstSystemId for larger swarms
+    static constexpr int kMaxSystemId = 254;            ///< 255 is the GCS
+
+signals:
+    void vehicleCountChanged();
+    void firstSystemIdChanged();
+    void workerThreadsChanged();
+    void messageRatesChanged();
+    void packetLossPercentChanged();
+    void latencyChanged();
+    void burstChanged();
+    void randomSeedChanged();
+
+private:
+    int _vehicleCount = 10;                             ///< As set, vehicleCount() applies the system id limit
+    int _firstSystemId = 1;
+    int _workerThreads = 4;
+    double _messageRates[MessageCount] = {
+        50.,    // MessageAttitude
+        10.,    // MessageGlobalPositionInt
+        4.,     // MessageVfrHud
+        1.,     // MessageSysStatus
+        10.,    // MessageEscStatus
+        2.,     // MessageAdsbVehicle
+    };
+    double _packetLossPercent = 0.;
+    int _latencyMsecs = 0;
+    int _latencyJitterMsecs = 0;
+    int _burstIntervalMsecs = 0;
+    int _burstLengthMsecs = 0;
+    quint32 _randomSeed = 1;
+
+    static constexpr const char *_vehicleCountKey = "VehicleCount";
+    static constexpr const char *_firstSystemIdKey = "FirstSystemId";
+    static constexpr const char *_workerThreadsKey = "WorkerThreads";
+    static constexpr const char *_messageRatesKey = "MessageRates";
+    static constexpr const char *_packetLossPercentKey = "PacketLossPercent";
+    static constexpr const char *_latencyMsecsKey = "LatencyMsecs";
+    static constexpr const char *_latencyJitterMsecsKey = "LatencyJitterMsecs";
+    static constexpr const char *_burstIntervalMsecsKey = "BurstIntervalMsecs";
+    static constexpr const char *_burstLengthMsecsKey = "BurstLengthMsecs";
+    static constexpr const char *_randomSeedKey = "RandomSeed";
+};
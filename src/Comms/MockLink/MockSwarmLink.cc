@@ -0,0 +1,186 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MockSwarmLink.h"
+#include "LinkManager.h"
+#include "MockSwarmWorker.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QThread>
+
+QGC_LOGGING_CATEGORY(MockSwarmLinkLog, "qgc.comms.mocklink.mockswarmlink")
+
+MockSwarmLink::MockSwarmLink(SharedLinkConfigurationPtr &config, QObject *parent)
+    : LinkInterface(config, parent)
+    , _swarmConfig(qobject_cast<const MockSwarmConfiguration*>(_config.get()))
+{
+    // qCDebug(MockSwarmLinkLog) << Q_FUNC_INFO << this;
+}
+
+MockSwarmLink::~MockSwarmLink()
+{
+    MockSwarmLink::disconnect();
+
+    // qCDebug(MockSwarmLinkLog) << Q_FUNC_INFO << this;
+}
+
+bool MockSwarmLink::_connect()
+{
+    if (_connected) {
+        return true;
+    }
+
+    const int vehicleCount = _swarmConfig->vehicleCount();
+    const int workerCount = qMin(_swarmConfig->workerThreads(), vehicleCount);
+
+    // Deal the vehicles out round robin so every worker carries the same load
+    QList<QList<int>> vehicleIndices(workerCount);
+    for (int i = 0; i < vehicleCount; i++) {
+        vehicleIndices[i % workerCount].append(i);
+    }
+
+    for (int i = 0; i < workerCount; i++) {
+        QThread *const thread = new QThread(this);
+        thread->setObjectName(QStringLiteral("MockSwarm%1").arg(i));
+
+        MockSwarmWorker *const worker = new MockSwarmWorker(_swarmConfig, vehicleIndices[i], i);
+        worker->moveToThread(thread);
+        (void) connect(thread, &QThread::started, worker, &MockSwarmWorker::startWork);
+        (void) connect(thread, &QThread::finished, worker, &QObject::deleteLater);
+        // Runs on the worker thread, the same way MockLink delivers its traffic
+        (void) connect(worker, &MockSwarmWorker::bytesReady, this, [this](const QByteArray &bytes) {
+            emit bytesReceived(this, bytes);
+        }, Qt::DirectConnection);
+
+        _workerThreads.append(thread);
+        _workers.append(worker);
+        thread->start();
+    }
+
+    qCDebug(MockSwarmLinkLog) << "Started" << vehicleCount << "vehicles on" << workerCount << "threads";
+
+    _connected = true;
+    emit connected();
+
+    return true;
+}
+
+void MockSwarmLink::disconnect()
+{
+    _stopWorkers();
+
+    if (_connected) {
+        _connected = false;
+        emit disconnected();
+    }
+}
+
+void MockSwarmLink::_stopWorkers()
+{
+    for (QThread *const thread : _workerThreads) {
+        thread->quit();
+    }
+    for (QThread *const thread : _workerThreads) {
+        (void) thread->wait();
+        thread->deleteLater();
+    }
+
+    _workerThreads.clear();
+    _workers.clear();
+}
+
+MockSwarmLink::Stats_t MockSwarmLink::stats() const
+{
+    Stats_t stats{};
+
+    for (const MockSwarmWorker *const worker : _workers) {
+        const MockSwarmWorker::Stats_t &workerStats = worker->stats();
+        stats.messagesGenerated += workerStats.messagesGenerated.load(std::memory_order_relaxed);
+        stats.messagesDropped += workerStats.messagesDropped.load(std::memory_order_relaxed);
+        stats.bytesDelivered += workerStats.bytesDelivered.load(std::memory_order_relaxed);
+        stats.deliveries += workerStats.deliveries.load(std::memory_order_relaxed);
+    }
+
+    return stats;
+}
+
+void MockSwarmLink::_writeBytes(const QByteArray &bytes)
+{
+    mavlink_message_t message{};
+    mavlink_status_t status{};
+
+    for (const char byte : bytes) {
+        if (!mavlink_parse_char(_mavlinkAuxChannel, static_cast<uint8_t>(byte), &message, &status)) {
+            continue;
+        }
+
+        if (message.msgid == MAVLINK_MSG_ID_HEARTBEAT) {
+            continue;
+        }
+
+        // Only the worker owning the target system responds
+        for (MockSwarmWorker *const worker : _workers) {
+            (void) QMetaObject::invokeMethod(worker, [worker, message]() {
+                worker->handleMessage(message);
+            }, Qt::QueuedConnection);
+        }
+    }
+}
+
+bool MockSwarmLink::_allocateMavlinkChannel()
+{
+    // should only be called by the LinkManager during setup
+    Q_ASSERT(!_mavlinkAuxChannelIsSet());
+    Q_ASSERT(!mavlinkChannelIsSet());
+
+    if (!LinkInterface::_allocateMavlinkChannel()) {
+        qCWarning(MockSwarmLinkLog) << "LinkInterface::_allocateMavlinkChannel failed";
+        return false;
+    }
+
+    _mavlinkAuxChannel = LinkManager::instance()->allocateMavlinkChannel();
+    if (!_mavlinkAuxChannelIsSet()) {
+        qCWarning(MockSwarmLinkLog) << "_allocateMavlinkChannel failed";
+        LinkInterface::_freeMavlinkChannel();
+        return false;
+    }
+
+    return true;
+}
+
+void MockSwarmLink::_freeMavlinkChannel()
+{
+    if (!_mavlinkAuxChannelIsSet()) {
+        Q_ASSERT(!mavlinkChannelIsSet());
+        return;
+    }
+
+    LinkManager::instance()->freeMavlinkChannel(_mavlinkAuxChannel);
+    _mavlinkAuxChannel = LinkManager::invalidMavlinkChannel();
+    LinkInterface::_freeMavlinkChannel();
+}
+
+bool MockSwarmLink::_mavlinkAuxChannelIsSet() const
+{
+    return (LinkManager::invalidMavlinkChannel() != _mavlinkAuxChannel);
+}
+
+MockSwarmLink *MockSwarmLink::startMockSwarmLink(int vehicleCount)
+{
+    MockSwarmConfiguration *const swarmConfig = new MockSwarmConfiguration(QStringLiteral("Mock Swarm"));
+    swarmConfig->setVehicleCount(vehicleCount);
+    swarmConfig->setDynamic(true);
+
+    SharedLinkConfigurationPtr config = LinkManager::instance()->addConfiguration(swarmConfig);
+    if (LinkManager::instance()->createConnectedLink(config)) {
+        return qobject_cast<MockSwarmLink*>(config->link());
+    }
+
+    return nullptr;
+}
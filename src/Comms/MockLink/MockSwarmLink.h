@@ -0,0 +1,69 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "LinkInterface.h"
+#include "MockSwarmConfiguration.h"
+
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+
+#include <limits>
+
+class MockSwarmWorker;
+class QThread;
+
+Q_DECLARE_LOGGING_CATEGORY(MockSwarmLinkLog)
+
+/// Load generator link: many lightweight simulated vehicles on one link, spread over a pool of worker threads.
+/// Unlike MockLink the vehicles implement only the protocol QGC needs to bring them up, the point is to reproduce
+/// the traffic of a large swarm so ground station throughput, latency and memory can be measured without hardware.
+class MockSwarmLink : public LinkInterface
+{
+    Q_OBJECT
+
+public:
+    typedef struct {
+        quint64 messagesGenerated;
+        quint64 messagesDropped;
+        quint64 bytesDelivered;
+        quint64 deliveries;
+    } Stats_t;
+
+    explicit MockSwarmLink(SharedLinkConfigurationPtr &config, QObject *parent = nullptr);
+    virtual ~MockSwarmLink();
+
+    bool isConnected() const final { return _connected; }
+    void disconnect() final;
+
+    /// Totals over all workers, thread safe
+    Stats_t stats() const;
+
+    static MockSwarmLink *startMockSwarmLink(int vehicleCount);
+
+private slots:
+    void _writeBytes(const QByteArray &bytes) final;
+
+private:
+    bool _connect() final;
+    bool _allocateMavlinkChannel() final;
+    void _freeMavlinkChannel() final;
+
+    bool _mavlinkAuxChannelIsSet() const;
+    void _stopWorkers();
+
+    const MockSwarmConfiguration *_swarmConfig = nullptr;
+
+    QList<QThread*> _workerThreads;
+    QList<MockSwarmWorker*> _workers;
+
+    uint8_t _mavlinkAuxChannel = std::numeric_limits<uint8_t>::max();   ///< Parses what QGC sends to the swarm
+    bool _connected = false;
+};
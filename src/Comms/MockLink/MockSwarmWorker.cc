@@ -0,0 +1,396 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MockSwarmWorker.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QTimer>
+#include <QtCore/QtMath>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+QGC_LOGGING_CATEGORY(MockSwarmWorkerLog, "qgc.comms.mocklink.mockswarmworker")
+
+namespace {
+    constexpr double kMetersPerDegree = 111320.;
+    constexpr double kSwarmLatitude = 47.397;           ///< Same area as MockLink
+    constexpr double kSwarmLongitude = 8.5455;
+    constexpr double kHomeAltitude = 488.;
+    constexpr double kFlightAltitude = 50.;
+    constexpr double kGridSpacingMeters = 150.;
+    constexpr int kGridColumns = 16;
+}
+
+MockSwarmWorker::MockSwarmWorker(const MockSwarmConfiguration *config, const QList<int> &vehicleIndices, int workerIndex, QObject *parent)
+    : QObject(parent)
+    , _packetLossFraction(config->packetLossPercent() / 100.)
+    , _latencyMsecs(config->latencyMsecs())
+    , _latencyJitterMsecs(config->latencyJitterMsecs())
+    , _burstIntervalMsecs(config->burstIntervalMsecs())
+    , _burstLengthMsecs(config->burstLengthMsecs())
+    , _random(config->randomSeed() + static_cast<quint32>(workerIndex))
+{
+    // qCDebug(MockSwarmWorkerLog) << Q_FUNC_INFO << this;
+
+    for (int i = 0; i < MockSwarmConfiguration::MessageCount; i++) {
+        const double rate = config->messageRate(static_cast<MockSwarmConfiguration::Message_t>(i));
+        _messageIntervalsMsecs[i] = (rate > 0.) ? (1000. / rate) : 0.;
+    }
+
+    _vehicles.reserve(vehicleIndices.count());
+    for (const int index : vehicleIndices) {
+        Vehicle_t vehicle{};
+        vehicle.systemId = static_cast<uint8_t>(config->firstSystemId() + index);
+
+        // Lay the swarm out on a grid, each vehicle orbiting its own cell
+        const double northMeters = (index / kGridColumns) * kGridSpacingMeters;
+        const double eastMeters = (index % kGridColumns) * kGridSpacingMeters;
+        vehicle.centerLatitude = kSwarmLatitude + (northMeters / kMetersPerDegree);
+        vehicle.centerLongitude = kSwarmLongitude + (eastMeters / (kMetersPerDegree * std::cos(qDegreesToRadians(kSwarmLatitude))));
+        vehicle.orbitPhase = _random.bounded(2. * M_PI);
+
+        // Spread the streams over their interval so the swarm doesn't send in lock step
+        vehicle.nextHeartbeatMsecs = _random.bounded(1000);
+        for (int i = 0; i < MockSwarmConfiguration::MessageCount; i++) {
+            vehicle.nextMessageMsecs[i] = (_messageIntervalsMsecs[i] > 0.) ? _random.bounded(_messageIntervalsMsecs[i]) : 0.;
+        }
+
+        _systemIdToVehicle[vehicle.systemId] = _vehicles.count();
+        _vehicles.append(vehicle);
+    }
+
+    _clock.start();
+}
+
+MockSwarmWorker::~MockSwarmWorker()
+{
+    stopWork();
+
+    // qCDebug(MockSwarmWorkerLog) << Q_FUNC_INFO << this;
+}
+
+void MockSwarmWorker::startWork()
+{
+    _timer = new QTimer(this);
+    _timer->setTimerType(Qt::PreciseTimer);
+    (void) connect(_timer, &QTimer::timeout, this, &MockSwarmWorker::_tick);
+    _timer->start(kTickMsecs);
+}
+
+void MockSwarmWorker::stopWork()
+{
+    if (_timer) {
+        _timer->stop();
+    }
+}
+
+void MockSwarmWorker::_tick()
+{
+    const QByteArray bytes = generate(_clock.elapsed());
+    if (!bytes.isEmpty()) {
+        emit bytesReady(bytes);
+    }
+}
+
+QByteArray MockSwarmWorker::generate(qint64 nowMsecs)
+{
+    for (Vehicle_t &vehicle : _vehicles) {
+        if (vehicle.nextHeartbeatMsecs <= nowMsecs) {
+            _sendHeartbeat(vehicle);
+            vehicle.nextHeartbeatMsecs = qMax(vehicle.nextHeartbeatMsecs + 1000, nowMsecs - kCatchUpLimitMsecs);
+        }
+
+        for (int i = 0; i < MockSwarmConfiguration::MessageCount; i++) {
+            const double interval = _messageIntervalsMsecs[i];
+            if (interval <= 0.) {
+                continue;
+            }
+
+            double &next = vehicle.nextMessageMsecs[i];
+            next = qMax(next, static_cast<double>(nowMsecs - kCatchUpLimitMsecs));
+            while (next <= nowMsecs) {
+                _sendStreamMessage(vehicle, static_cast<MockSwarmConfiguration::Message_t>(i), static_cast<qint64>(next));
+                next += interval;
+            }
+        }
+    }
+
+    _queueDelivery(nowMsecs);
+    const QByteArray bytes = _takeDeliveries(nowMsecs);
+    if (!bytes.isEmpty()) {
+        (void) _stats.bytesDelivered.fetch_add(bytes.size(), std::memory_order_relaxed);
+        (void) _stats.deliveries.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    return bytes;
+}
+
+void MockSwarmWorker::handleMessage(const mavlink_message_t &message)
+{
+    const auto vehicleFor = [this](uint8_t targetSystem) -> Vehicle_t* {
+        const int index = _systemIdToVehicle.value(targetSystem, -1);
+        return (index < 0) ? nullptr : &_vehicles[index];
+    };
+
+    switch (message.msgid) {
+    case MAVLINK_MSG_ID_COMMAND_LONG: {
+        mavlink_command_long_t request{};
+        mavlink_msg_command_long_decode(&message, &request);
+        if (Vehicle_t *const vehicle = vehicleFor(request.target_system)) {
+            _sendCommandAck(*vehicle, request.command, message);
+        }
+        break;
+    }
+    case MAVLINK_MSG_ID_COMMAND_INT: {
+        mavlink_command_int_t request{};
+        mavlink_msg_command_int_decode(&message, &request);
+        if (Vehicle_t *const vehicle = vehicleFor(request.target_system)) {
+            _sendCommandAck(*vehicle, request.command, message);
+        }
+        break;
+    }
+    case MAVLINK_MSG_ID_PARAM_REQUEST_LIST: {
+        mavlink_param_request_list_t request{};
+        mavlink_msg_param_request_list_decode(&message, &request);
+        if (Vehicle_t *const vehicle = vehicleFor(request.target_system)) {
+            _sendParamValue(*vehicle);
+        }
+        break;
+    }
+    case MAVLINK_MSG_ID_PARAM_REQUEST_READ: {
+        mavlink_param_request_read_t request{};
+        mavlink_msg_param_request_read_decode(&message, &request);
+        if (Vehicle_t *const vehicle = vehicleFor(request.target_system)) {
+            _sendParamValue(*vehicle);
+        }
+        break;
+    }
+    case MAVLINK_MSG_ID_MISSION_REQUEST_LIST: {
+        mavlink_mission_request_list_t request{};
+        mavlink_msg_mission_request_list_decode(&message, &request);
+        if (Vehicle_t *const vehicle = vehicleFor(request.target_system)) {
+            _sendMissionCount(*vehicle, request.mission_type, message);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void MockSwarmWorker::_sendMessage(Vehicle_t &vehicle, uint32_t messageId, const void *packet, uint8_t minLength, uint8_t length, uint8_t crcExtra)
+{
+    // Packed the same way the generated _pack functions do it, but against the vehicle's own status rather than a
+    // shared channel so workers never touch common state and each vehicle has its own sequence numbers
+    mavlink_message_t message{};
+    (void) memcpy(_MAV_PAYLOAD_NON_CONST(&message), packet, length);
+    message.msgid = messageId;
+    (void) mavlink_finalize_message_buffer(&message, vehicle.systemId, kComponentId, &vehicle.status, minLength, length, crcExtra);
+
+    (void) _stats.messagesGenerated.fetch_add(1, std::memory_order_relaxed);
+
+    // Dropped after packing so QGC sees the gap in the sequence numbers, as with a real lossy link
+    if ((_packetLossFraction > 0.) && (_random.generateDouble() < _packetLossFraction)) {
+        (void) _stats.messagesDropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+    const uint16_t cBuffer = mavlink_msg_to_send_buffer(buffer, &message);
+    (void) _pending.append(reinterpret_cast<const char*>(buffer), cBuffer);
+}
+
+void MockSwarmWorker::_sendHeartbeat(Vehicle_t &vehicle)
+{
+    mavlink_heartbeat_t heartbeat{};
+    heartbeat.type = MAV_TYPE_QUADROTOR;
+    heartbeat.autopilot = MAV_AUTOPILOT_GENERIC;
+    heartbeat.base_mode = MAV_MODE_FLAG_CUSTOM_MODE_ENABLED | MAV_MODE_FLAG_SAFETY_ARMED;
+    heartbeat.system_status = MAV_STATE_ACTIVE;
+    heartbeat.mavlink_version = 3;
+
+    _sendMessage(vehicle, MAVLINK_MSG_ID_HEARTBEAT, &heartbeat, MAVLINK_MSG_ID_HEARTBEAT_MIN_LEN, MAVLINK_MSG_ID_HEARTBEAT_LEN, MAVLINK_MSG_ID_HEARTBEAT_CRC);
+}
+
+void MockSwarmWorker::_sendStreamMessage(Vehicle_t &vehicle, MockSwarmConfiguration::Message_t message, qint64 nowMsecs)
+{
+    const double seconds = nowMsecs / 1000.;
+    const double angle = vehicle.orbitPhase + ((2. * M_PI * seconds) / kOrbitPeriodSecs);
+    const double speed = (2. * M_PI * kOrbitRadiusMeters) / kOrbitPeriodSecs;
+    const double latitude = vehicle.centerLatitude + ((kOrbitRadiusMeters * std::cos(angle)) / kMetersPerDegree);
+    const double longitude = vehicle.centerLongitude + ((kOrbitRadiusMeters * std::sin(angle)) / (kMetersPerDegree * std::cos(qDegreesToRadians(latitude))));
+    const double yaw = std::remainder(angle + (M_PI / 2.), 2. * M_PI);
+    const double headingDegrees = std::fmod(qRadiansToDegrees(yaw) + 360., 360.);
+    const uint32_t bootMsecs = static_cast<uint32_t>(nowMsecs);
+
+    switch (message) {
+    case MockSwarmConfiguration::MessageAttitude: {
+        mavlink_attitude_t attitude{};
+        attitude.time_boot_ms = bootMsecs;
+        attitude.roll = static_cast<float>(0.1 * std::sin(seconds));
+        attitude.pitch = static_cast<float>(0.05 * std::cos(seconds));
+        attitude.yaw = static_cast<float>(yaw);
+        attitude.yawspeed = static_cast<float>((2. * M_PI) / kOrbitPeriodSecs);
+        _sendMessage(vehicle, MAVLINK_MSG_ID_ATTITUDE, &attitude, MAVLINK_MSG_ID_ATTITUDE_MIN_LEN, MAVLINK_MSG_ID_ATTITUDE_LEN, MAVLINK_MSG_ID_ATTITUDE_CRC);
+        break;
+    }
+    case MockSwarmConfiguration::MessageGlobalPositionInt: {
+        mavlink_global_position_int_t position{};
+        position.time_boot_ms = bootMsecs;
+        position.lat = static_cast<int32_t>(latitude * 1e7);
+        position.lon = static_cast<int32_t>(longitude * 1e7);
+        position.alt = static_cast<int32_t>((kHomeAltitude + kFlightAltitude) * 1000.);
+        position.relative_alt = static_cast<int32_t>(kFlightAltitude * 1000.);
+        position.vx = static_cast<int16_t>(speed * std::cos(yaw) * 100.);
+        position.vy = static_cast<int16_t>(speed * std::sin(yaw) * 100.);
+        position.hdg = static_cast<uint16_t>(headingDegrees * 100.);
+        _sendMessage(vehicle, MAVLINK_MSG_ID_GLOBAL_POSITION_INT, &position, MAVLINK_MSG_ID_GLOBAL_POSITION_INT_MIN_LEN, MAVLINK_MSG_ID_GLOBAL_POSITION_INT_LEN, MAVLINK_MSG_ID_GLOBAL_POSITION_INT_CRC);
+        break;
+    }
+    case MockSwarmConfiguration::MessageVfrHud: {
+        mavlink_vfr_hud_t vfrHud{};
+        vfrHud.airspeed = static_cast<float>(speed);
+        vfrHud.groundspeed = static_cast<float>(speed);
+        vfrHud.alt = static_cast<float>(kHomeAltitude + kFlightAltitude);
+        vfrHud.heading = static_cast<int16_t>(headingDegrees);
+        vfrHud.throttle = 50;
+        _sendMessage(vehicle, MAVLINK_MSG_ID_VFR_HUD, &vfrHud, MAVLINK_MSG_ID_VFR_HUD_MIN_LEN, MAVLINK_MSG_ID_VFR_HUD_LEN, MAVLINK_MSG_ID_VFR_HUD_CRC);
+        break;
+    }
+    case MockSwarmConfiguration::MessageSysStatus: {
+        constexpr uint32_t sensors = MAV_SYS_STATUS_SENSOR_3D_GYRO | MAV_SYS_STATUS_SENSOR_3D_ACCEL | MAV_SYS_STATUS_SENSOR_3D_MAG | MAV_SYS_STATUS_SENSOR_GPS;
+        mavlink_sys_status_t sysStatus{};
+        sysStatus.onboard_control_sensors_present = sensors;
+        sysStatus.onboard_control_sensors_enabled = sensors;
+        sysStatus.onboard_control_sensors_health = sensors;
+        sysStatus.load = 300;
+        sysStatus.voltage_battery = 16000;
+        sysStatus.current_battery = 1000;
+        sysStatus.battery_remaining = 80;
+        _sendMessage(vehicle, MAVLINK_MSG_ID_SYS_STATUS, &sysStatus, MAVLINK_MSG_ID_SYS_STATUS_MIN_LEN, MAVLINK_MSG_ID_SYS_STATUS_LEN, MAVLINK_MSG_ID_SYS_STATUS_CRC);
+        break;
+    }
+    case MockSwarmConfiguration::MessageEscStatus: {
+        mavlink_esc_status_t escStatus{};
+        escStatus.index = 0;
+        escStatus.time_usec = static_cast<uint64_t>(nowMsecs) * 1000;
+        for (int i = 0; i < 4; i++) {
+            escStatus.rpm[i] = 5000 + static_cast<int32_t>(200. * std::sin(seconds + i));
+            escStatus.voltage[i] = 16.f;
+            escStatus.current[i] = 5.f;
+        }
+        _sendMessage(vehicle, MAVLINK_MSG_ID_ESC_STATUS, &escStatus, MAVLINK_MSG_ID_ESC_STATUS_MIN_LEN, MAVLINK_MSG_ID_ESC_STATUS_LEN, MAVLINK_MSG_ID_ESC_STATUS_CRC);
+        break;
+    }
+    case MockSwarmConfiguration::MessageAdsbVehicle: {
+        // Each vehicle reports one piece of traffic crossing its cell
+        mavlink_adsb_vehicle_t adsb{};
+        adsb.ICAO_address = 0xC00000 + vehicle.systemId;
+        adsb.lat = static_cast<int32_t>((vehicle.centerLatitude + ((2. * kOrbitRadiusMeters * std::sin(angle)) / kMetersPerDegree)) * 1e7);
+        adsb.lon = static_cast<int32_t>(vehicle.centerLongitude * 1e7);
+        adsb.altitude_type = ADSB_ALTITUDE_TYPE_GEOMETRIC;
+        adsb.altitude = static_cast<int32_t>((kHomeAltitude + 300.) * 1000.);
+        adsb.heading = 0;
+        adsb.hor_velocity = 3000;
+        (void) snprintf(adsb.callsign, sizeof(adsb.callsign), "SWARM%03d", vehicle.systemId);
+        adsb.emitter_type = ADSB_EMITTER_TYPE_LIGHT;
+        adsb.tslc = 1;
+        adsb.flags = ADSB_FLAGS_VALID_COORDS | ADSB_FLAGS_VALID_ALTITUDE | ADSB_FLAGS_VALID_HEADING | ADSB_FLAGS_VALID_VELOCITY | ADSB_FLAGS_VALID_CALLSIGN | ADSB_FLAGS_SIMULATED;
+        _sendMessage(vehicle, MAVLINK_MSG_ID_ADSB_VEHICLE, &adsb, MAVLINK_MSG_ID_ADSB_VEHICLE_MIN_LEN, MAVLINK_MSG_ID_ADSB_VEHICLE_LEN, MAVLINK_MSG_ID_ADSB_VEHICLE_CRC);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void MockSwarmWorker::_sendParamValue(Vehicle_t &vehicle)
+{
+    // A single read only parameter is enough for the parameter manager to consider the vehicle loaded
+    mavlink_param_value_t paramValue{};
+    (void) strncpy(paramValue.param_id, "SWARM_ID", sizeof(paramValue.param_id));
+    paramValue.param_value = vehicle.systemId;
+    paramValue.param_type = MAV_PARAM_TYPE_REAL32;
+    paramValue.param_count = 1;
+    paramValue.param_index = 0;
+
+    _sendMessage(vehicle, MAVLINK_MSG_ID_PARAM_VALUE, &paramValue, MAVLINK_MSG_ID_PARAM_VALUE_MIN_LEN, MAVLINK_MSG_ID_PARAM_VALUE_LEN, MAVLINK_MSG_ID_PARAM_VALUE_CRC);
+}
+
+void MockSwarmWorker::_sendCommandAck(Vehicle_t &vehicle, uint16_t command, const mavlink_message_t &request)
+{
+    // Unsupported gets QGC through the connect sequence without retries
+    mavlink_command_ack_t ack{};
+    ack.command = command;
+    ack.result = MAV_RESULT_UNSUPPORTED;
+    ack.target_system = request.sysid;
+    ack.target_component = request.compid;
+
+    _sendMessage(vehicle, MAVLINK_MSG_ID_COMMAND_ACK, &ack, MAVLINK_MSG_ID_COMMAND_ACK_MIN_LEN, MAVLINK_MSG_ID_COMMAND_ACK_LEN, MAVLINK_MSG_ID_COMMAND_ACK_CRC);
+}
+
+void MockSwarmWorker::_sendMissionCount(Vehicle_t &vehicle, uint8_t missionType, const mavlink_message_t &request)
+{
+    mavlink_mission_count_t count{};
+    count.count = 0;
+    count.target_system = request.sysid;
+    count.target_component = request.compid;
+    count.mission_type = missionType;
+
+    _sendMessage(vehicle, MAVLINK_MSG_ID_MISSION_COUNT, &count, MAVLINK_MSG_ID_MISSION_COUNT_MIN_LEN, MAVLINK_MSG_ID_MISSION_COUNT_LEN, MAVLINK_MSG_ID_MISSION_COUNT_CRC);
+}
+
+void MockSwarmWorker::_queueDelivery(qint64 nowMsecs)
+{
+    if (_pending.isEmpty()) {
+        return;
+    }
+
+    qint64 deliverMsecs = nowMsecs + _latencyMsecs;
+    if (_latencyJitterMsecs > 0) {
+        deliverMsecs += _random.bounded(_latencyJitterMsecs + 1);
+    }
+
+    // Jitter delays delivery but never reorders it, a radio link is still a FIFO
+    deliverMsecs = qMax(deliverMsecs, _lastDeliverMsecs);
+    _lastDeliverMsecs = deliverMsecs;
+
+    _inFlight.push_back({ deliverMsecs, std::move(_pending) });
+    _pending = QByteArray();
+}
+
+QByteArray MockSwarmWorker::_takeDeliveries(qint64 nowMsecs)
+{
+    if (_inBurstHold(nowMsecs)) {
+        return QByteArray();
+    }
+
+    QByteArray bytes;
+    while (!_inFlight.empty() && (_inFlight.front().deliverMsecs <= nowMsecs)) {
+        if (bytes.isEmpty()) {
+            bytes = std::move(_inFlight.front().bytes);
+        } else {
+            (void) bytes.append(_inFlight.front().bytes);
+        }
+        _inFlight.pop_front();
+    }
+
+    return bytes;
+}
+
+bool MockSwarmWorker::_inBurstHold(qint64 nowMsecs) const
+{
+    if ((_burstIntervalMsecs <= 0) || (_burstLengthMsecs <= 0)) {
+        return false;
+    }
+
+    return (nowMsecs % _burstIntervalMsecs) < _burstLengthMsecs;
+}
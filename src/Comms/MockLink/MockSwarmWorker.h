@@ -0,0 +1,123 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "MAVLinkLib.h"
+#include "MockSwarmConfiguration.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+#include <QtCore/QRandomGenerator>
+
+#include <atomic>
+#include <deque>
+
+class QTimer;
+
+Q_DECLARE_LOGGING_CATEGORY(MockSwarmWorkerLog)
+
+/// Simulates a slice of a MockSwarmLink's vehicles on its own thread. Each vehicle streams the configured message
+/// mix with its own sequence numbers and answers just enough of the connect sequence (commands, parameters, mission
+/// counts) for QGC to bring it up. Generated traffic goes through the simulated radio: packet loss, latency with
+/// jitter and bursts, before it is handed to the link.
+class MockSwarmWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    typedef struct {
+        std::atomic<quint64> messagesGenerated = 0;
+        std::atomic<quint64> messagesDropped = 0;
+        std::atomic<quint64> bytesDelivered = 0;
+        std::atomic<quint64> deliveries = 0;
+    } Stats_t;
+
+    /// @param vehicleIndices Indices into the swarm (0 based) of the vehicles this worker simulates
+    MockSwarmWorker(const MockSwarmConfiguration *config, const QList<int> &vehicleIndices, int workerIndex, QObject *parent = nullptr);
+    ~MockSwarmWorker();
+
+    /// Generates everything which is due at nowMsecs and returns the bytes the radio delivers at that time.
+    /// Driven by the worker's timer, but callable directly with simulated time.
+    QByteArray generate(qint64 nowMsecs);
+
+    /// Queues the response of the addressed vehicle, if it belongs to this worker, to a message from QGC.
+    /// Worker thread only, the response goes out with the next generate.
+    void handleMessage(const mavlink_message_t &message);
+
+    const Stats_t &stats() const { return _stats; }
+    int vehicleCount() const { return _vehicles.count(); }
+
+    static constexpr int kTickMsecs = 5;
+    static constexpr uint8_t kComponentId = MAV_COMP_ID_AUTOPILOT1;
+
+public slots:
+    void startWork();
+    void stopWork();
+
+signals:
+    void bytesReady(const QByteArray &bytes);
+
+private slots:
+    void _tick();
+
+private:
+    typedef struct {
+        uint8_t systemId;
+        mavlink_status_t status;                            ///< Per vehicle outgoing sequence numbers
+        double centerLatitude;
+        double centerLongitude;
+        double orbitPhase;
+        qint64 nextHeartbeatMsecs;
+        double nextMessageMsecs[MockSwarmConfiguration::MessageCount];   ///< Fractional so non integer intervals keep their rate
+    } Vehicle_t;
+
+    typedef struct {
+        qint64 deliverMsecs;
+        QByteArray bytes;
+    } Delivery_t;
+
+    void _sendMessage(Vehicle_t &vehicle, uint32_t messageId, const void *packet, uint8_t minLength, uint8_t length, uint8_t crcExtra);
+    void _sendHeartbeat(Vehicle_t &vehicle);
+    void _sendStreamMessage(Vehicle_t &vehicle, MockSwarmConfiguration::Message_t message, qint64 nowMsecs);
+    void _sendParamValue(Vehicle_t &vehicle);
+    void _sendCommandAck(Vehicle_t &vehicle, uint16_t command, const mavlink_message_t &request);
+    void _sendMissionCount(Vehicle_t &vehicle, uint8_t missionType, const mavlink_message_t &request);
+    void _queueDelivery(qint64 nowMsecs);
+    QByteArray _takeDeliveries(qint64 nowMsecs);
+    bool _inBurstHold(qint64 nowMsecs) const;
+
+    QList<Vehicle_t> _vehicles;
+    QHash<uint8_t, int> _systemIdToVehicle;
+
+    double _messageIntervalsMsecs[MockSwarmConfiguration::MessageCount]{};   ///< 0: Message not sent
+    const double _packetLossFraction = 0.;
+    const int _latencyMsecs = 0;
+    const int _latencyJitterMsecs = 0;
+    const int _burstIntervalMsecs = 0;
+    const int _burstLengthMsecs = 0;
+    QRandomGenerator _random;
+
+    QByteArray _pending;                                    ///< Generated this tick, not yet handed to the radio
+    std::deque<Delivery_t> _inFlight;
+    qint64 _lastDeliverMsecs = 0;
+
+    QTimer *_timer = nullptr;
+    QElapsedTimer _clock;
+
+    Stats_t _stats;
+
+    static constexpr double kOrbitRadiusMeters = 50.;
+    static constexpr double kOrbitPeriodSecs = 60.;
+    static constexpr int kCatchUpLimitMsecs = 1000;        ///< After a stall, messages older than this are skipped rather than flooded
+};
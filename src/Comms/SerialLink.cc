@@ -8,6 +8,7 @@
  ****************************************************************************/
 
 #include "SerialLink.h"
+#include "LinkWriteQueue.h"
 #include "QGCLoggingCategory.h"
 #include "QGCSerialPortInfo.h"
 #include <QtCore/QSettings>
@@ -185,9 +186,10 @@ QString SerialConfiguration::cleanPortDisplayName(const QString &name)
 
 /*===========================================================================*/
 
-SerialWorker::SerialWorker(const SerialConfiguration *config, QObject *parent)
+SerialWorker::SerialWorker(const SerialConfiguration *config, LinkWriteQueue *writeQueue, QObject *parent)
     : QObject(parent)
     , _serialConfig(config)
+    , _writeQueue(writeQueue)
 {
     // qCDebug(SerialLinkLog) << this;
 
@@ -274,9 +276,16 @@ void SerialWorker::disconnectFromPort()
     _port->close();
 }
 
-void SerialWorker::writeData(const QByteArray &data)
+void SerialWorker::drainWriteQueue()
 {
-    if (data.isEmpty()) {
+    _writeQueue->drain(true, [this](const char *data, int length) {
+        _writeData(data, length);
+    });
+}
+
+void SerialWorker::_writeData(const char *data, int length)
+{
+    if (length <= 0) {
         emit errorOccurred(tr("Data to Send is Empty"));
         return;
     }
@@ -292,8 +301,8 @@ void SerialWorker::writeData(const QByteArray &data)
     }
 
     qint64 totalBytesWritten = 0;
-    while (totalBytesWritten < data.size()) {
-        const qint64 bytesWritten = _port->write(data.constData() + totalBytesWritten, data.size() - totalBytesWritten);
+    while (totalBytesWritten < length) {
+        const qint64 bytesWritten = _port->write(data + totalBytesWritten, length - totalBytesWritten);
         if (bytesWritten == -1) {
             emit errorOccurred(tr("Could Not Send Data - Write Failed: %1").arg(_port->errorString()));
             return;
@@ -304,8 +313,7 @@ void SerialWorker::writeData(const QByteArray &data)
         totalBytesWritten += bytesWritten;
     }
 
-    const QByteArray sent = data.first(totalBytesWritten);
-    emit dataSent(sent);
+    emit dataSent(QByteArray(data, totalBytesWritten));
 }
 
 void SerialWorker::_onPortConnected()
@@ -396,7 +404,7 @@ void SerialWorker::_checkPortAvailability()
 SerialLink::SerialLink(SharedLinkConfigurationPtr &config, QObject *parent)
     : LinkInterface(config, parent)
     , _serialConfig(qobject_cast<const SerialConfiguration*>(config.get()))
-    , _worker(new SerialWorker(_serialConfig))
+    , _worker(new SerialWorker(_serialConfig, writeQueue()))
     , _workerThread(new QThread(this))
 {
     // qCDebug(SerialLinkLog) << this;
@@ -470,7 +478,7 @@ void SerialLink::_onDataSent(const QByteArray &data)
     emit bytesSent(this, data);
 }
 
-void SerialLink::_writeBytes(const QByteArray &data)
+void SerialLink::_writeQueueReady()
 {
-    (void) QMetaObject::invokeMethod(_worker, "writeData", Qt::QueuedConnection, Q_ARG(QByteArray, data));
+    (void) QMetaObject::invokeMethod(_worker, &SerialWorker::drainWriteQueue, Qt::QueuedConnection);
 }
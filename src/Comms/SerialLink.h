@@ -21,6 +21,7 @@
 #include "LinkConfiguration.h"
 #include "LinkInterface.h"
 
+class LinkWriteQueue;
 class QThread;
 class QTimer;
 
@@ -107,7 +108,7 @@ class SerialWorker : public QObject
     Q_OBJECT
 
 public:
-    explicit SerialWorker(const SerialConfiguration *config, QObject *parent = nullptr);
+    explicit SerialWorker(const SerialConfiguration *config, LinkWriteQueue *writeQueue, QObject *parent = nullptr);
     ~SerialWorker();
 
     bool isConnected() const;
@@ -124,7 +125,8 @@ public slots:
     void setupPort();
     void connectToPort();
     void disconnectFromPort();
-    void writeData(const QByteArray &data);
+    /// Writes everything queued on the link, coalesced, straight to the port
+    void drainWriteQueue();
 
 private slots:
     void _onPortConnected();
@@ -135,7 +137,10 @@ private slots:
     void _checkPortAvailability();
 
 private:
+    void _writeData(const char *data, int length);
+
     const SerialConfiguration *_serialConfig = nullptr;
+    LinkWriteQueue *_writeQueue = nullptr;
     QSerialPort *_port = nullptr;
     QTimer *_timer = nullptr;
     bool _errorEmitted = false;
@@ -153,12 +158,17 @@ class SerialLink : public LinkInterface
 
     bool isConnected() const override;
     bool isSecureConnection() const override { return _serialConfig->usbDirect(); }
+    /// 8N1 framing, ten bits on the wire per byte. USB connections aren't limited by the baud rate.
+    qint64 nominalBytesPerSecond() const override { return (_serialConfig->usbDirect() ? 0 : (_serialConfig->baud() / 10)); }
 
     const QSerialPort *port() const { return _worker->port(); }
 
 public slots:
     void disconnect() override;
 
+protected:
+    void _writeQueueReady() override;
+
 private slots:
     void _onConnected();
     void _onDisconnected();
@@ -168,7 +178,6 @@ private slots:
 
 private:
     bool _connect() override;
-    void _writeBytes(const QByteArray &data) override;
 
     const SerialConfiguration *_serialConfig = nullptr;
     SerialWorker *_worker = nullptr;
@@ -9,6 +9,7 @@
 
 #include "TCPLink.h"
 #include "DeviceInfo.h"
+#include "LinkWriteQueue.h"
 #include "QGCLoggingCategory.h"
 
 #include <QtCore/QThread>
@@ -77,9 +78,10 @@ void TCPConfiguration::saveSettings(QSettings &settings, const QString &root) co
 
 /*===========================================================================*/
 
-TCPWorker::TCPWorker(const TCPConfiguration *config, QObject *parent)
+TCPWorker::TCPWorker(const TCPConfiguration *config, LinkWriteQueue *writeQueue, QObject *parent)
     : QObject(parent)
     , _config(config)
+    , _writeQueue(writeQueue)
 {
     // qCDebug(TCPLinkLog) << Q_FUNC_INFO << this;
 }
@@ -161,9 +163,16 @@ void TCPWorker::disconnectFromHost()
     _socket->disconnectFromHost();
 }
 
-void TCPWorker::writeData(const QByteArray &data)
+void TCPWorker::drainWriteQueue()
 {
-    if (data.isEmpty()) {
+    _writeQueue->drain(true, [this](const char *data, int length) {
+        _writeData(data, length);
+    });
+}
+
+void TCPWorker::_writeData(const char *data, int length)
+{
+    if (length <= 0) {
         emit errorOccurred(tr("Data to Send is Empty"));
         return;
     }
@@ -174,8 +183,8 @@ void TCPWorker::writeData(const QByteArray &data)
     }
 
     qint64 totalBytesWritten = 0;
-    while (totalBytesWritten < data.size()) {
-        const qint64 bytesWritten = _socket->write(data.constData() + totalBytesWritten, data.size() - totalBytesWritten);
+    while (totalBytesWritten < length) {
+        const qint64 bytesWritten = _socket->write(data + totalBytesWritten, length - totalBytesWritten);
         if (bytesWritten == -1) {
             emit errorOccurred(tr("Could Not Send Data - Write Failed: %1").arg(_socket->errorString()));
             return;
@@ -186,7 +195,7 @@ void TCPWorker::writeData(const QByteArray &data)
         totalBytesWritten += bytesWritten;
     }
 
-    emit dataSent(data.first(totalBytesWritten));
+    emit dataSent(QByteArray(data, totalBytesWritten));
 }
 
 void TCPWorker::_onSocketConnected()
@@ -232,7 +241,7 @@ void TCPWorker::_onSocketErrorOccurred(QAbstractSocket::SocketError socketError)
 TCPLink::TCPLink(SharedLinkConfigurationPtr &config, QObject *parent)
     : LinkInterface(config, parent)
     , _tcpConfig(qobject_cast<const TCPConfiguration*>(config.get()))
-    , _worker(new TCPWorker(_tcpConfig))
+    , _worker(new TCPWorker(_tcpConfig, writeQueue()))
     , _workerThread(new QThread(this))
 {
     // qCDebug(TCPLinkLog) << Q_FUNC_INFO << this;
@@ -306,9 +315,9 @@ void TCPLink::_onDataSent(const QByteArray &data)
     emit bytesSent(this, data);
 }
 
-void TCPLink::_writeBytes(const QByteArray& bytes)
+void TCPLink::_writeQueueReady()
 {
-    (void) QMetaObject::invokeMethod(_worker, "writeData", Qt::QueuedConnection, Q_ARG(QByteArray, bytes));
+    (void) QMetaObject::invokeMethod(_worker, &TCPWorker::drainWriteQueue, Qt::QueuedConnection);
 }
 
 bool TCPLink::isSecureConnection() const
@@ -18,6 +18,7 @@
 #include "LinkConfiguration.h"
 #include "LinkInterface.h"
 
+class LinkWriteQueue;
 class QTcpSocket;
 class QThread;
 
@@ -65,7 +66,7 @@ class TCPWorker : public QObject
     Q_OBJECT
 
 public:
-    explicit TCPWorker(const TCPConfiguration *config, QObject *parent = nullptr);
+    explicit TCPWorker(const TCPConfiguration *config, LinkWriteQueue *writeQueue, QObject *parent = nullptr);
     ~TCPWorker();
 
     bool isConnected() const;
@@ -81,7 +82,8 @@ public slots:
     void setupSocket();
     void connectToHost();
     void disconnectFromHost();
-    void writeData(const QByteArray &data);
+    /// Writes everything queued on the link, coalesced, straight to the socket
+    void drainWriteQueue();
 
 private slots:
     void _onSocketConnected();
@@ -91,7 +93,10 @@ private slots:
     void _onSocketErrorOccurred(QAbstractSocket::SocketError socketError);
 
 private:
+    void _writeData(const char *data, int length);
+
     const TCPConfiguration *_config = nullptr;
+    LinkWriteQueue *_writeQueue = nullptr;
     QTcpSocket *_socket = nullptr;
     bool _errorEmitted = false;
 };
@@ -110,8 +115,10 @@ class TCPLink : public LinkInterface
     void disconnect() override;
     bool isSecureConnection() const override;
 
+protected:
+    void _writeQueueReady() override;
+
 private slots:
-    void _writeBytes(const QByteArray &bytes) override;
     void _onConnected();
     void _onDisconnected();
     void _onErrorOccurred(const QString &errorString);
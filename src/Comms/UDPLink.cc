@@ -8,8 +8,10 @@
  ****************************************************************************/
 
 #include "UDPLink.h"
+#include "UdpBatchIO.h"
 #include "AutoConnectSettings.h"
 #include "DeviceInfo.h"
+#include "LinkWriteQueue.h"
 #include "QGCLoggingCategory.h"
 #include "SettingsManager.h"
 
@@ -265,9 +267,10 @@ QString UDPConfiguration::_getIpAddress(const QString &address)
 
 const QHostAddress UDPWorker::_multicastGroup = QHostAddress(QStringLiteral("224.0.0.1"));
 
-UDPWorker::UDPWorker(const UDPConfiguration *config, QObject *parent)
+UDPWorker::UDPWorker(const UDPConfiguration *config, LinkWriteQueue *writeQueue, QObject *parent)
     : QObject(parent)
     , _udpConfig(config)
+    , _writeQueue(writeQueue)
 {
     // qCDebug(UDPLinkLog) << Q_FUNC_INFO << this;
 }
@@ -276,6 +279,8 @@ UDPWorker::~UDPWorker()
 {
     disconnectLink();
 
+    delete _batchIO;
+
     // qCDebug(UDPLinkLog) << Q_FUNC_INFO << this;
 }
 
@@ -294,6 +299,10 @@ void UDPWorker::setupSocket()
 
     _socket->setProxy(QNetworkProxy::NoProxy);
 
+    if (UdpBatchIO::isSupported()) {
+        _batchIO = new UdpBatchIO();
+    }
+
     (void) connect(_socket, &QUdpSocket::connected, this, &UDPWorker::_onSocketConnected);
     (void) connect(_socket, &QUdpSocket::disconnected, this, &UDPWorker::_onSocketDisconnected);
     (void) connect(_socket, &QUdpSocket::readyRead, this, &UDPWorker::_onSocketReadyRead);
@@ -374,34 +383,47 @@ void UDPWorker::disconnectLink()
     _sessionTargets.clear();
 }
 
-void UDPWorker::writeData(const QByteArray &data)
+void UDPWorker::drainWriteQueue()
 {
     if (!isConnected()) {
-        emit errorOccurred(tr("Could Not Send Data - Link is Disconnected!"));
+        // Frames are still taken off the queue so they don't pile up while disconnected
+        _writeQueue->drain(false, [this](const char *, int) {
+            emit errorOccurred(tr("Could Not Send Data - Link is Disconnected!"));
+        });
         return;
     }
 
     QMutexLocker locker(&_sessionTargetsMutex);
 
-    // Send to all manually targeted systems
+    // Send to all manually targeted systems, then to all connected systems. The targets are gathered once for
+    // the whole batch.
+    QList<std::shared_ptr<UDPClient>> targets;
     for (const std::shared_ptr<UDPClient> &target : _udpConfig->targetHosts()) {
         if (!containsTarget(_sessionTargets, target->address, target->port)) {
-            if (_socket->writeDatagram(data, target->address, target->port) < 0) {
-                qCWarning(UDPLinkLog) << "Could Not Send Data - Write Failed!";
-            }
+            targets.append(target);
         }
     }
+    targets.append(_sessionTargets);
+
+    locker.unlock();
+
+    _writeQueue->drain(false, [this, &targets](const char *data, int length) {
+        _writeData(data, length, targets);
+    });
+}
 
-    // Send to all connected systems
-    for (const std::shared_ptr<UDPClient> &target: _sessionTargets) {
-        if (_socket->writeDatagram(data, target->address, target->port) < 0) {
+void UDPWorker::_writeData(const char *data, int length, const QList<std::shared_ptr<UDPClient>> &targets)
+{
+    // Fan out to as many targets as possible in one system call, anything left goes through QUdpSocket
+    const QByteArray datagram = QByteArray::fromRawData(data, length);
+    const qsizetype batchSent = _batchIO ? _batchIO->send(_socket->socketDescriptor(), datagram, targets) : 0;
+    for (qsizetype i = batchSent; i < targets.size(); i++) {
+        if (_socket->writeDatagram(data, length, targets[i]->address, targets[i]->port) < 0) {
             qCWarning(UDPLinkLog) << "Could Not Send Data - Write Failed!";
         }
     }
 
-    locker.unlock();
-
-    emit dataSent(data);
+    emit dataSent(QByteArray(data, length));
 }
 
 void UDPWorker::_onSocketConnected()
@@ -438,13 +460,9 @@ void UDPWorker::_onSocketReadyRead()
     QElapsedTimer timer;
     timer.start();
     bool received = false;
-    while (_socket->hasPendingDatagrams()) {
-        const QNetworkDatagram datagramIn = _socket->receiveDatagram();
-        if (datagramIn.isNull() || datagramIn.data().isEmpty()) {
-            continue;
-        }
 
-        (void) buffer.append(datagramIn.data());
+    const auto appendData = [&](const char *data, qsizetype size) {
+        (void) buffer.append(data, size);
 
         if ((buffer.size() > BUFFER_TRIGGER_SIZE) || (timer.elapsed() > RECEIVE_TIME_LIMIT_MS)) {
             received = true;
@@ -452,16 +470,43 @@ void UDPWorker::_onSocketReadyRead()
             buffer.clear();
             (void) timer.restart();
         }
+    };
 
-        const bool ipLocal = datagramIn.senderAddress().isLoopback() || _localAddresses.contains(datagramIn.senderAddress());
-        const QHostAddress senderAddress = ipLocal ? QHostAddress(QHostAddress::SpecialAddress::LocalHost) : datagramIn.senderAddress();
+    while (_socket->hasPendingDatagrams()) {
+        const QNetworkDatagram datagramIn = _socket->receiveDatagram();
+        if (datagramIn.isNull() || datagramIn.data().isEmpty()) {
+            continue;
+        }
+
+        appendData(datagramIn.data().constData(), datagramIn.data().size());
+        _addSessionTarget(datagramIn.senderAddress(), datagramIn.senderPort());
+
+        if (!_batchIO) {
+            continue;
+        }
 
-        QMutexLocker locker(&_sessionTargetsMutex);
-        if (!containsTarget(_sessionTargets, senderAddress, datagramIn.senderPort())) {
-            qCDebug(UDPLinkLog) << "UDP Adding target:" << senderAddress << datagramIn.senderPort();
-            _sessionTargets.append(std::make_shared<UDPClient>(senderAddress, datagramIn.senderPort()));
+        // Reading through QUdpSocket above re-arms its read notifier. Whatever else is already queued is
+        // drained straight from the socket in batches, without a QNetworkDatagram per packet.
+        int count;
+        while ((count = _batchIO->receive(_socket->socketDescriptor())) > 0) {
+            quint32 lastSenderAddress = 0;
+            quint16 lastSenderPort = 0;
+            for (int i = 0; i < count; i++) {
+                const UdpBatchIO::Datagram &datagram = _batchIO->datagram(i);
+                appendData(datagram.data, datagram.size);
+
+                // Senders rarely change within a batch, only look them up when they do
+                if ((i == 0) || (datagram.senderAddress != lastSenderAddress) || (datagram.senderPort != lastSenderPort)) {
+                    lastSenderAddress = datagram.senderAddress;
+                    lastSenderPort = datagram.senderPort;
+                    _addSessionTarget(QHostAddress(datagram.senderAddress), datagram.senderPort);
+                }
+            }
+
+            if (count < _batchIO->batchSize()) {
+                break;
+            }
         }
-        locker.unlock();
     }
 
     if (!received && buffer.isEmpty()) {
@@ -472,6 +517,18 @@ void UDPWorker::_onSocketReadyRead()
     emit dataReceived(buffer);
 }
 
+void UDPWorker::_addSessionTarget(const QHostAddress &senderAddress, quint16 senderPort)
+{
+    const bool ipLocal = senderAddress.isLoopback() || _localAddresses.contains(senderAddress);
+    const QHostAddress targetAddress = ipLocal ? QHostAddress(QHostAddress::SpecialAddress::LocalHost) : senderAddress;
+
+    QMutexLocker locker(&_sessionTargetsMutex);
+    if (!containsTarget(_sessionTargets, targetAddress, senderPort)) {
+        qCDebug(UDPLinkLog) << "UDP Adding target:" << targetAddress << senderPort;
+        _sessionTargets.append(std::make_shared<UDPClient>(targetAddress, senderPort));
+    }
+}
+
 void UDPWorker::_onSocketBytesWritten(qint64 bytes)
 {
     qCDebug(UDPLinkLog) << "Wrote" << bytes << "bytes";
@@ -561,7 +618,7 @@ void UDPWorker::_deregisterZeroconf()
 UDPLink::UDPLink(SharedLinkConfigurationPtr &config, QObject *parent)
     : LinkInterface(config, parent)
     , _udpConfig(qobject_cast<const UDPConfiguration*>(config.get()))
-    , _worker(new UDPWorker(_udpConfig))
+    , _worker(new UDPWorker(_udpConfig, writeQueue()))
     , _workerThread(new QThread(this))
 {
     // qCDebug(UDPLinkLog) << Q_FUNC_INFO << this;
@@ -635,9 +692,9 @@ void UDPLink::_onDataSent(const QByteArray &data)
     emit bytesSent(this, data);
 }
 
-void UDPLink::_writeBytes(const QByteArray& bytes)
+void UDPLink::_writeQueueReady()
 {
-    (void) QMetaObject::invokeMethod(_worker, "writeData", Qt::QueuedConnection, Q_ARG(QByteArray, bytes));
+    (void) QMetaObject::invokeMethod(_worker, &UDPWorker::drainWriteQueue, Qt::QueuedConnection);
 }
 
 bool UDPLink::isSecureConnection() const
@@ -26,8 +26,10 @@
 #include "LinkConfiguration.h"
 #include "LinkInterface.h"
 
+class LinkWriteQueue;
 class QUdpSocket;
 class QThread;
+class UdpBatchIO;
 
 Q_DECLARE_LOGGING_CATEGORY(UDPLinkLog)
 
@@ -115,7 +117,7 @@ class UDPWorker : public QObject
     Q_OBJECT
 
 public:
-    explicit UDPWorker(const UDPConfiguration *config, QObject *parent = nullptr);
+    explicit UDPWorker(const UDPConfiguration *config, LinkWriteQueue *writeQueue, QObject *parent = nullptr);
     virtual ~UDPWorker();
 
     bool isConnected() const;
@@ -124,7 +126,8 @@ public slots:
     void setupSocket();
     void connectLink();
     void disconnectLink();
-    void writeData(const QByteArray &data);
+    /// Sends everything queued on the link straight from the socket, one datagram per frame
+    void drainWriteQueue();
 
 signals:
     void connected();
@@ -141,8 +144,13 @@ private slots:
     void _onSocketErrorOccurred(QAbstractSocket::SocketError socketError);
 
 private:
+    void _addSessionTarget(const QHostAddress &senderAddress, quint16 senderPort);
+    void _writeData(const char *data, int length, const QList<std::shared_ptr<UDPClient>> &targets);
+
     const UDPConfiguration *_udpConfig = nullptr;
+    LinkWriteQueue *_writeQueue = nullptr;
     QUdpSocket *_socket = nullptr;
+    UdpBatchIO *_batchIO = nullptr;     ///< Linux only, nullptr elsewhere
     QMutex _sessionTargetsMutex;
     QList<std::shared_ptr<UDPClient>> _sessionTargets;
     bool _isConnected = false;
@@ -176,9 +184,9 @@ class UDPLink : public LinkInterface
 
 protected:
     bool _connect() override;
+    void _writeQueueReady() override;
 
 private slots:
-    void _writeBytes(const QByteArray &data) override;
     void _onConnected();
     void _onDisconnected();
     void _onErrorOccurred(const QString &errorString);
@@ -0,0 +1,162 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "UdpBatchIO.h"
+#include "UDPLink.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QtEndian>
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <cstring>
+#endif
+
+QGC_LOGGING_CATEGORY(UdpBatchIOLog, "qgc.comms.udpbatchio")
+
+UdpBatchIO::UdpBatchIO(int batchSize)
+    : _batchSize(qMax(1, batchSize))
+{
+    // qCDebug(UdpBatchIOLog) << Q_FUNC_INFO << this;
+
+#ifdef Q_OS_LINUX
+    _slab.resize(static_cast<size_t>(_batchSize) * kMaxDatagramSize);
+    _datagrams.resize(_batchSize);
+    _receiveHeaders.resize(_batchSize);
+    _receiveIovecs.resize(_batchSize);
+    _receiveAddresses.resize(_batchSize);
+    _sendHeaders.resize(_batchSize);
+    _sendAddresses.resize(_batchSize);
+
+    // The receive headers always point at the same slab slots, only the lengths change between calls
+    for (int i = 0; i < _batchSize; i++) {
+        _receiveIovecs[i].iov_base = _slab.data() + (static_cast<size_t>(i) * kMaxDatagramSize);
+        _receiveIovecs[i].iov_len = kMaxDatagramSize;
+
+        msghdr &header = _receiveHeaders[i].msg_hdr;
+        (void) memset(&header, 0, sizeof(header));
+        header.msg_name = &_receiveAddresses[i];
+        header.msg_iov = &_receiveIovecs[i];
+        header.msg_iovlen = 1;
+    }
+#endif
+}
+
+UdpBatchIO::~UdpBatchIO()
+{
+    // qCDebug(UdpBatchIOLog) << Q_FUNC_INFO << this;
+}
+
+int UdpBatchIO::receive(qintptr socketDescriptor)
+{
+#ifdef Q_OS_LINUX
+    for (int i = 0; i < _batchSize; i++) {
+        _receiveHeaders[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+        _receiveHeaders[i].msg_hdr.msg_flags = 0;
+    }
+
+    int count;
+    do {
+        count = ::recvmmsg(static_cast<int>(socketDescriptor), _receiveHeaders.data(), _batchSize, MSG_DONTWAIT, nullptr);
+    } while ((count < 0) && (errno == EINTR));
+
+    if (count < 0) {
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+            return 0;
+        }
+
+        qCWarning(UdpBatchIOLog) << "recvmmsg failed:" << strerror(errno);
+        return -1;
+    }
+
+    int valid = 0;
+    for (int i = 0; i < count; i++) {
+        const mmsghdr &header = _receiveHeaders[i];
+        if (header.msg_hdr.msg_flags & MSG_TRUNC) {
+            qCWarning(UdpBatchIOLog) << "Dropping datagram larger than" << kMaxDatagramSize << "bytes";
+            continue;
+        }
+
+        const sockaddr_in &sender = _receiveAddresses[i];
+        Datagram &datagram = _datagrams[valid++];
+        datagram.data = static_cast<const char*>(_receiveIovecs[i].iov_base);
+        datagram.size = header.msg_len;
+        datagram.senderAddress = qFromBigEndian(sender.sin_addr.s_addr);
+        datagram.senderPort = qFromBigEndian(sender.sin_port);
+    }
+
+    return valid;
+#else
+    Q_UNUSED(socketDescriptor);
+    return 0;
+#endif
+}
+
+qsizetype UdpBatchIO::send(qintptr socketDescriptor, const QByteArray &data, const QList<std::shared_ptr<UDPClient>> &targets)
+{
+#ifdef Q_OS_LINUX
+    // Every message shares the one payload iovec, only the destination differs
+    iovec payload;
+    payload.iov_base = const_cast<char*>(data.constData());
+    payload.iov_len = static_cast<size_t>(data.size());
+
+    qsizetype sent = 0;
+    while (sent < targets.size()) {
+        int count = 0;
+        while ((count < _batchSize) && ((sent + count) < targets.size())) {
+            const UDPClient &target = *targets[sent + count];
+
+            bool isIPv4 = false;
+            const quint32 address = target.address.toIPv4Address(&isIPv4);
+            if (!isIPv4) {
+                break;
+            }
+
+            sockaddr_in &destination = _sendAddresses[count];
+            (void) memset(&destination, 0, sizeof(destination));
+            destination.sin_family = AF_INET;
+            destination.sin_addr.s_addr = qToBigEndian(address);
+            destination.sin_port = qToBigEndian(target.port);
+
+            msghdr &header = _sendHeaders[count].msg_hdr;
+            (void) memset(&header, 0, sizeof(header));
+            header.msg_name = &destination;
+            header.msg_namelen = sizeof(destination);
+            header.msg_iov = &payload;
+            header.msg_iovlen = 1;
+
+            count++;
+        }
+
+        if (count == 0) {
+            break;
+        }
+
+        int result;
+        do {
+            result = ::sendmmsg(static_cast<int>(socketDescriptor), _sendHeaders.data(), count, MSG_DONTWAIT);
+        } while ((result < 0) && (errno == EINTR));
+
+        if (result <= 0) {
+            qCDebug(UdpBatchIOLog) << "sendmmsg failed:" << strerror(errno);
+            break;
+        }
+
+        sent += result;
+        if (result < count) {
+            break;
+        }
+    }
+
+    return sent;
+#else
+    Q_UNUSED(socketDescriptor); Q_UNUSED(data); Q_UNUSED(targets);
+    return 0;
+#endif
+}
@@ -0,0 +1,82 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+
+#include <memory>
+#include <vector>
+
+#ifdef Q_OS_LINUX
+#include <netinet/in.h>
+#include <sys/socket.h>
+#endif
+
+struct UDPClient;
+
+Q_DECLARE_LOGGING_CATEGORY(UdpBatchIOLog)
+
+/// UdpBatchIO moves batches of datagrams through a bound IPv4 UDP socket with a single system call, using
+/// recvmmsg/sendmmsg on Linux. Received datagrams land in a slab allocated once up front and are handed out
+/// as views into it, so the receive path does no per datagram allocation.
+/// On other platforms isSupported() is false and all calls do nothing, callers stay on the QUdpSocket path.
+class UdpBatchIO
+{
+public:
+    struct Datagram {
+        const char *data = nullptr;     ///< Points into the receive slab, only valid until the next receive()
+        qsizetype size = 0;
+        quint32 senderAddress = 0;      ///< IPv4 address, host byte order
+        quint16 senderPort = 0;
+    };
+
+    explicit UdpBatchIO(int batchSize = kDefaultBatchSize);
+    ~UdpBatchIO();
+
+    static constexpr bool isSupported()
+    {
+#ifdef Q_OS_LINUX
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    int batchSize() const { return _batchSize; }
+
+    /// Reads up to batchSize() queued datagrams without blocking
+    ///     @return Number of datagrams received, 0 if none were queued, -1 on error
+    int receive(qintptr socketDescriptor);
+
+    const Datagram &datagram(int index) const { return _datagrams[index]; }
+
+    /// Sends the same datagram to each target, batchSize() targets per system call. Stops at the first
+    /// target which is not an IPv4 address or which the kernel refuses.
+    ///     @return Number of leading targets the datagram was sent to, the caller is responsible for the rest
+    qsizetype send(qintptr socketDescriptor, const QByteArray &data, const QList<std::shared_ptr<UDPClient>> &targets);
+
+    static constexpr int kDefaultBatchSize = 32;
+    static constexpr qsizetype kMaxDatagramSize = 9216;  ///< Larger datagrams are truncated by the kernel and dropped
+
+private:
+    int _batchSize = kDefaultBatchSize;
+    std::vector<char> _slab;
+    std::vector<Datagram> _datagrams;
+
+#ifdef Q_OS_LINUX
+    std::vector<mmsghdr> _receiveHeaders;
+    std::vector<iovec> _receiveIovecs;
+    std::vector<sockaddr_in> _receiveAddresses;
+    std::vector<mmsghdr> _sendHeaders;
+    std::vector<sockaddr_in> _sendAddresses;
+#endif
+};
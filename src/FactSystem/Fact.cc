@@ -12,6 +12,7 @@
 #include "QGCApplication.h"
 #include "QGCCorePlugin.h"
 #include "QGCLoggingCategory.h"
+#include "TelemetryTracer.h"
 
 QGC_LOGGING_CATEGORY(FactLog, "qgc.factsystem.fact")
 
@@ -67,6 +68,10 @@ Fact::Fact(const Fact &other, QObject *parent)
 Fact::~Fact()
 {
     // qCDebug(FactLog) << Q_FUNC_INFO << this;
+
+    if (TelemetryTracer::enabled()) {
+        TelemetryTracer::instance()->factDestroyed(this);
+    }
 }
 
 void Fact::_init()
@@ -311,10 +316,15 @@ QStringList Fact::selectedBitmaskStrings() const
 }
 
 QString Fact::_variantToString(const QVariant &variant, int decimalPlaces) const
+{
+    return variantToString(variant, type(), decimalPlaces);
+}
+
+QString Fact::variantToString(const QVariant &variant, FactMetaData::ValueType_t type, int decimalPlaces)
 {
     QString valueString;
 
-    switch (type()) {
+    switch (type) {
     case FactMetaData::valueTypeFloat:
     {
         const float fValue = variant.toFloat();
@@ -638,6 +648,10 @@ void Fact::setSendValueChangedSignals(bool sendValueChangedSignals)
 
 void Fact::_sendValueChangedSignal(const QVariant &value)
 {
+    if (TelemetryTracer::enabled()) {
+        TelemetryTracer::instance()->factValueChanged(this, _sendValueChangedSignals);
+    }
+
     if (_sendValueChangedSignals) {
         emit valueChanged(value);
         _deferredValueChangeSignal = false;
@@ -650,6 +664,9 @@ void Fact::sendDeferredValueChangedSignal()
 {
     if (_deferredValueChangeSignal) {
         _deferredValueChangeSignal = false;
+        if (TelemetryTracer::enabled()) {
+            TelemetryTracer::instance()->factDeferredValueSent(this);
+        }
         emit valueChanged(cookedValue());
     }
 }
@@ -118,6 +118,10 @@ class Fact : public QObject
     QString rawUnits() const;
     QString rawValueString() const;
     QString cookedValueString() const;
+
+    /// Formats a value the same way the value string accessors do. Only depends on its arguments, so it is safe
+    /// to call from any thread with a value snapshotted earlier.
+    static QString variantToString(const QVariant &variant, FactMetaData::ValueType_t type, int decimalPlaces);
     bool valueEqualsDefault() const;
     bool vehicleRebootRequired() const;
     bool qgcRebootRequired() const;
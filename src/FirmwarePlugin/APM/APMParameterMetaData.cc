@@ -10,7 +10,7 @@
 #include "APMParameterMetaData.h"
 #include "QGCLoggingCategory.h"
 
-#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
 #include <QtCore/QRegularExpression>
 #include <QtCore/QRegularExpressionMatch>
 #include <QtCore/QStack>
@@ -130,7 +130,7 @@ QString APMParameterMetaData::_groupFromParameterName(const QString &name)
     return group.remove(regex); // remove any numbers from the end
 }
 
-void APMParameterMetaData::loadParameterFactMetaDataFile(const QString &metaDataFile)
+void APMParameterMetaData::loadParameterFactMetaDataFile(const QString &metaDataFile, const QString &cacheDirectory)
 {
     if (_parameterMetaDataLoaded) {
         return;
@@ -139,15 +139,25 @@ void APMParameterMetaData::loadParameterFactMetaDataFile(const QString &metaData
 
     qCDebug(APMParameterMetaDataLog) << "Loading parameter meta data:" << metaDataFile;
 
-    QFile xmlFile(metaDataFile);
-    Q_ASSERT(xmlFile.exists());
-
-    const bool success = xmlFile.open(QIODevice::ReadOnly);
-    Q_UNUSED(success);
-    Q_ASSERT(success);
+    QString errorString;
+    const bool loaded = _metaDataStore.loadConverted(metaDataFile, QStringLiteral("APM-%1").arg(kStoreRecordVersion), cacheDirectory,
+        [this](const QByteArray &xmlBytes, QJsonArray &parameters, QString &convertError) {
+            _parseXml(xmlBytes);
+            parameters = _rawMetaDataToJson();
+            if (parameters.isEmpty()) {
+                convertError = QStringLiteral("No parameters found");
+                return false;
+            }
+            return true;
+        }, errorString);
+    if (!loaded) {
+        qCWarning(APMParameterMetaDataLog) << "Parameter meta data load failed:" << metaDataFile << errorString;
+    }
+}
 
-    QXmlStreamReader xml(xmlFile.readAll());
-    xmlFile.close();
+void APMParameterMetaData::_parseXml(const QByteArray &xmlBytes)
+{
+    QXmlStreamReader xml(xmlBytes);
     if (xml.hasError()) {
         qCWarning(APMParameterMetaDataLog) << "Badly formed XML, reading failed:" << xml.errorString();
         return;
@@ -300,6 +310,100 @@ void APMParameterMetaData::loadParameterFactMetaDataFile(const QString &metaData
     }
 }
 
+QJsonArray APMParameterMetaData::_rawMetaDataToJson() const
+{
+    const auto pairsToJson = [](const QList<QPair<QString, QString>> &pairs) {
+        QJsonArray jsonPairs;
+        for (const QPair<QString, QString> &pair : pairs) {
+            jsonPairs.append(QJsonArray({ pair.first, pair.second }));
+        }
+        return jsonPairs;
+    };
+
+    QJsonArray parameters;
+    for (auto sectionIt = _vehicleTypeToParametersMap.constBegin(); sectionIt != _vehicleTypeToParametersMap.constEnd(); ++sectionIt) {
+        for (const APMFactMetaDataRaw *rawMetaData : sectionIt.value()) {
+            QJsonObject json;
+            const auto setString = [&json](const QString &key, const QString &value) {
+                if (!value.isEmpty()) {
+                    json[key] = value;
+                }
+            };
+
+            json[QStringLiteral("name")] = _storeName(sectionIt.key(), rawMetaData->name);
+            setString(QStringLiteral("category"), rawMetaData->category);
+            setString(QStringLiteral("group"), rawMetaData->group);
+            setString(QStringLiteral("shortDescription"), rawMetaData->shortDescription);
+            setString(QStringLiteral("longDescription"), rawMetaData->longDescription);
+            setString(QStringLiteral("min"), rawMetaData->min);
+            setString(QStringLiteral("max"), rawMetaData->max);
+            setString(QStringLiteral("incrementSize"), rawMetaData->incrementSize);
+            setString(QStringLiteral("units"), rawMetaData->units);
+            if (rawMetaData->rebootRequired) {
+                json[QStringLiteral("rebootRequired")] = true;
+            }
+            if (rawMetaData->readOnly) {
+                json[QStringLiteral("readOnly")] = true;
+            }
+            if (!rawMetaData->values.isEmpty()) {
+                json[QStringLiteral("values")] = pairsToJson(rawMetaData->values);
+            }
+            if (!rawMetaData->bitmask.isEmpty()) {
+                json[QStringLiteral("bitmask")] = pairsToJson(rawMetaData->bitmask);
+            }
+
+            parameters.append(json);
+        }
+    }
+
+    return parameters;
+}
+
+APMFactMetaDataRaw *APMParameterMetaData::_rawMetaDataFromJson(const QJsonObject &json, const QString &name)
+{
+    APMFactMetaDataRaw *const rawMetaData = new APMFactMetaDataRaw(this);
+
+    rawMetaData->name = name;
+    rawMetaData->category = json[QStringLiteral("category")].toString();
+    rawMetaData->group = json[QStringLiteral("group")].toString();
+    rawMetaData->shortDescription = json[QStringLiteral("shortDescription")].toString();
+    rawMetaData->longDescription = json[QStringLiteral("longDescription")].toString();
+    rawMetaData->min = json[QStringLiteral("min")].toString();
+    rawMetaData->max = json[QStringLiteral("max")].toString();
+    rawMetaData->incrementSize = json[QStringLiteral("incrementSize")].toString();
+    rawMetaData->units = json[QStringLiteral("units")].toString();
+    rawMetaData->rebootRequired = json[QStringLiteral("rebootRequired")].toBool();
+    rawMetaData->readOnly = json[QStringLiteral("readOnly")].toBool();
+
+    for (const QJsonValue &pair : json[QStringLiteral("values")].toArray()) {
+        rawMetaData->values << QPair<QString, QString>(pair[0].toString(), pair[1].toString());
+    }
+    for (const QJsonValue &pair : json[QStringLiteral("bitmask")].toArray()) {
+        rawMetaData->bitmask << QPair<QString, QString>(pair[0].toString(), pair[1].toString());
+    }
+
+    return rawMetaData;
+}
+
+APMFactMetaDataRaw *APMParameterMetaData::_rawMetaData(const QString &section, const QString &name)
+{
+    APMFactMetaDataRaw *rawMetaData = _vehicleTypeToParametersMap.value(section).value(name);
+    if (rawMetaData || !_metaDataStore.isOpen()) {
+        return rawMetaData;
+    }
+
+    // Loaded from the cached store, so the parameter is decoded on first use
+    QString indexValue;
+    const QJsonObject json = _metaDataStore.parameter(_storeName(section, name), indexValue);
+    if (json.isEmpty()) {
+        return nullptr;
+    }
+
+    rawMetaData = _rawMetaDataFromJson(json, name);
+    _vehicleTypeToParametersMap[section][name] = rawMetaData;
+    return rawMetaData;
+}
+
 void APMParameterMetaData::_correctGroupMemberships(ParameterNametoFactMetaDataMap &parameterToFactMetaDataMap, QMap<QString,QStringList> &groupMembers)
 {
     for (const QString &groupName : groupMembers.keys()) {
@@ -431,10 +535,9 @@ FactMetaData *APMParameterMetaData::getMetaDataForFact(const QString &name, MAV_
 
     // check if we have metadata for fact, use generic otherwise
     while (keepTrying) {
-        if (_vehicleTypeToParametersMap[mavTypeString].contains(name)) {
-            rawMetaData = _vehicleTypeToParametersMap[mavTypeString][name];
-        } else if (_vehicleTypeToParametersMap["libraries"].contains(name)) {
-            rawMetaData = _vehicleTypeToParametersMap["libraries"][name];
+        rawMetaData = _rawMetaData(mavTypeString, name);
+        if (!rawMetaData) {
+            rawMetaData = _rawMetaData(QStringLiteral("libraries"), name);
         }
         if (!rawMetaData && (mavTypeString == "Rover")) {
             // Hack city: Older versions of Rover have different name
@@ -17,6 +17,7 @@
 
 #include "MAVLinkLib.h"
 #include "FactMetaData.h"
+#include "ParameterMetaDataStore.h"
 
 Q_DECLARE_LOGGING_CATEGORY(APMParameterMetaDataLog)
 Q_DECLARE_LOGGING_CATEGORY(APMParameterMetaDataVerboseLog)
@@ -40,7 +41,7 @@ class APMFactMetaDataRaw : public QObject
     QString incrementSize;
     QString units;
     bool rebootRequired = false;
-    bool readOnly;
+    bool readOnly = false;
     QList<QPair<QString, QString>> values;
     QList<QPair<QString, QString>> bitmask;
 };
@@ -59,7 +60,10 @@ class APMParameterMetaData : public QObject
     ~APMParameterMetaData();
 
     FactMetaData *getMetaDataForFact(const QString &name, MAV_TYPE vehicleType, FactMetaData::ValueType_t type);
-    void loadParameterFactMetaDataFile(const QString &metaDataFile);
+
+    /// The xml is converted into a ParameterMetaDataStore in cacheDirectory, later loads of the same file map the store
+    /// and only decode the parameters which are looked up.
+    void loadParameterFactMetaDataFile(const QString &metaDataFile, const QString &cacheDirectory = ParameterMetaDataStore::defaultCacheDirectory());
 
     static void getParameterMetaDataVersionInfo(const QString &metaDataFile, int &majorVersion, int &minorVersion);
 
@@ -82,6 +86,12 @@ class APMParameterMetaData : public QObject
     ///     @param convertOk Returned: true: conversion success, false: conversion failure
     /// @return Returns the correctly type QVariant
     static QVariant _stringToTypedVariant(const QString &string, FactMetaData::ValueType_t type, bool *convertOk);
+    void _parseXml(const QByteArray &xmlBytes);
+    QJsonArray _rawMetaDataToJson() const;
+    APMFactMetaDataRaw *_rawMetaDataFromJson(const QJsonObject &json, const QString &name);
+    /// Raw metadata for the parameter from the given vehicle type or libraries section, nullptr if there is none
+    APMFactMetaDataRaw *_rawMetaData(const QString &section, const QString &name);
+    static QString _storeName(const QString &section, const QString &name) { return section + QLatin1Char('/') + name; }
     static bool _skipXMLBlock(QXmlStreamReader &xml, const QString &blockName);
     bool _parseParameterAttributes(QXmlStreamReader &xml, APMFactMetaDataRaw *rawMetaData);
     static void _correctGroupMemberships(ParameterNametoFactMetaDataMap &parameterToFactMetaDataMap, QMap<QString,QStringList> &groupMembers);
@@ -91,6 +101,9 @@ class APMParameterMetaData : public QObject
     bool _parameterMetaDataLoaded = false; ///< true: parameter meta data already loaded
     // FIXME: metadata is vehicle type specific now
     QMap<QString, ParameterNametoFactMetaDataMap> _vehicleTypeToParametersMap; ///< Maps from a vehicle type to paramametertoFactMeta map>
+    ParameterMetaDataStore _metaDataStore; ///< Raw metadata by "<vehicle type or libraries>/<name>"
+
+    static constexpr int kStoreRecordVersion = 1; ///< Bump when the json written for APMFactMetaDataRaw changes
 
     static constexpr const char *kInvalidConverstion = "Internal Error: No support for string parameters";
 };
@@ -17,6 +17,8 @@
 #include <QtCore/QFile>
 #include <QtCore/QDir>
 #include <QtCore/QDebug>
+#include <QtCore/QJsonArray>
+#include <QtCore/QSet>
 #include <QtCore/QXmlStreamReader>
 
 QGC_LOGGING_CATEGORY(PX4ParameterMetaDataLog, "PX4ParameterMetaDataLog")
@@ -76,7 +78,7 @@ QVariant PX4ParameterMetaData::_stringToTypedVariant(const QString& string, Fact
     return var;
 }
 
-void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaDataFile)
+void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaDataFile, const QString& cacheDirectory)
 {
     qCDebug(PX4ParameterMetaDataLog) << "PX4ParameterMetaData::loadParameterFactMetaDataFile" << metaDataFile;
 
@@ -88,62 +90,86 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
 
     qCDebug(PX4ParameterMetaDataLog) << "Loading parameter meta data:" << metaDataFile;
 
-    QFile xmlFile(metaDataFile);
-
-    if (!xmlFile.exists()) {
+    if (!QFile::exists(metaDataFile)) {
         qWarning() << "Internal error: metaDataFile mission" << metaDataFile;
         return;
     }
-    
-    if (!xmlFile.open(QIODevice::ReadOnly)) {
-        qWarning() << "Internal error: Unable to open parameter file:" << metaDataFile << xmlFile.errorString();
+
+    QString errorString;
+    if (!_metaDataStore.loadConverted(metaDataFile, QStringLiteral("PX4-%1").arg(kStoreRecordVersion), cacheDirectory, &PX4ParameterMetaData::_parseXml, errorString)) {
+        qWarning() << "Unable to load parameter file:" << metaDataFile << errorString;
         return;
     }
-    
-    QXmlStreamReader xml(xmlFile.readAll());
-    xmlFile.close();
+
+#ifdef GENERATE_PARAMETER_JSON
+    // Needs every parameter, not only the ones looked up so far
+    QFile xmlFile(metaDataFile);
+    QJsonArray rgParameters;
+    if (xmlFile.open(QIODevice::ReadOnly) && _parseXml(xmlFile.readAll(), rgParameters, errorString)) {
+        for (const QJsonValue& parameterValue : rgParameters) {
+            const QJsonObject parameterObj = parameterValue.toObject();
+            FactMetaData* metaData = _createMetaData(parameterObj);
+            if (metaData) {
+                _mapParameterName2FactMetaData[parameterObj[_nameKey].toString()] = metaData;
+            }
+        }
+        _generateParameterJson();
+    }
+#endif
+}
+
+/// Reads the xml into one json object per parameter holding the attributes and the parameter's elements as found, in
+/// order, so _createMetaData can build the FactMetaData exactly as reading the xml directly would.
+bool PX4ParameterMetaData::_parseXml(const QByteArray& xmlBytes, QJsonArray& rgParameters, QString& errorString)
+{
+    QXmlStreamReader xml(xmlBytes);
     if (xml.hasError()) {
-        qWarning() << "Badly formed XML" << xml.errorString();
-        return;
+        errorString = QStringLiteral("Badly formed XML: %1").arg(xml.errorString());
+        return false;
     }
-    
+
+    // Parameters read before bad xml is found are still used
+    const auto badlyFormed = [&rgParameters, &errorString]() {
+        qWarning() << "Badly formed XML";
+        errorString = QStringLiteral("Badly formed XML");
+        return !rgParameters.isEmpty();
+    };
+
     QString         factGroup;
-    QString         errorString;
-    FactMetaData*   metaData = nullptr;
+    QJsonObject     parameterObj;
+    QJsonArray      rgElements;
+    QSet<QString>   names;
     int             xmlState = XmlStateNone;
     bool            badMetaData = true;
-    
+
     while (!xml.atEnd()) {
         if (xml.isStartElement()) {
             QString elementName = xml.name().toString();
-            
+
             if (elementName == "parameters") {
                 if (xmlState != XmlStateNone) {
-                    qWarning() << "Badly formed XML";
-                    return;
+                    return badlyFormed();
                 }
                 xmlState = XmlStateFoundParameters;
-                
+
             } else if (elementName == "version") {
                 if (xmlState != XmlStateFoundParameters) {
-                    qWarning() << "Badly formed XML";
-                    return;
+                    return badlyFormed();
                 }
                 xmlState = XmlStateFoundVersion;
-                
+
                 bool convertOk;
                 QString strVersion = xml.readElementText();
                 int intVersion = strVersion.toInt(&convertOk);
                 if (!convertOk) {
-                    qWarning() << "Badly formed XML";
-                    return;
+                    return badlyFormed();
                 }
                 if (intVersion <= 2) {
                     // We can't read these old files
-                    qDebug() << "Parameter version stamp too old, skipping load. Found:" << intVersion << "Want: 3 File:" << metaDataFile;
-                    return;
+                    errorString = QStringLiteral("Parameter version stamp too old, skipping load. Found: %1 Want: 3").arg(intVersion);
+                    return false;
                 }
-                
+
             } else if (elementName == "parameter_version_major") {
                 // Just skip over for now
             } else if (elementName == "parameter_version_minor") {
@@ -152,34 +178,31 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
             } else if (elementName == "group") {
                 if (xmlState != XmlStateFoundVersion) {
                     // We didn't get a version stamp, assume older version we can't read
-                    qDebug() << "Parameter version stamp not found, skipping load" << metaDataFile;
-                    return;
+                    errorString = QStringLiteral("Parameter version stamp not found, skipping load");
+                    return false;
                 }
                 xmlState = XmlStateFoundGroup;
-                
+
                 if (!xml.attributes().hasAttribute("name")) {
-                    qWarning() << "Badly formed XML";
-                    return;
+                    return badlyFormed();
                 }
                 factGroup = xml.attributes().value("name").toString();
                 qCDebug(PX4ParameterMetaDataLog) << "Found group: " << factGroup;
-                
+
             } else if (elementName == "parameter") {
                 if (xmlState != XmlStateFoundGroup) {
-                    qWarning() << "Badly formed XML";
-                    return;
+                    return badlyFormed();
                 }
                 xmlState = XmlStateFoundParameter;
-                
+
                 if (!xml.attributes().hasAttribute("name") || !xml.attributes().hasAttribute("type")) {
-                    qWarning() << "Badly formed XML";
-                    return;
+                    return badlyFormed();
                 }
-                
+
                 QString name = xml.attributes().value("name").toString();
                 QString type = xml.attributes().value("type").toString();
                 QString strDefault =    xml.attributes().value("default").toString();
-                
+
                 QString category = xml.attributes().value("category").toString();
                 if (category.isEmpty()) {
                     category = QStringLiteral("Standard");
@@ -201,175 +224,62 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
 
                 qCDebug(PX4ParameterMetaDataLog) << "Found parameter name:" << name << " type:" << type << " default:" << strDefault;
 
-                // Convert type from string to FactMetaData::ValueType_t
                 bool unknownType;
-                FactMetaData::ValueType_t foundType = FactMetaData::stringToType(type, unknownType);
+                (void) FactMetaData::stringToType(type, unknownType);
                 if (unknownType) {
                     qWarning() << "Parameter meta data with bad type:" << type << " name:" << name;
-                    return;
+                    errorString = QStringLiteral("Parameter meta data with bad type: %1 name: %2").arg(type, name);
+                    return !rgParameters.isEmpty();
                 }
-                
-                // Now that we know type we can create meta data object and add it to the system
-                metaData = new FactMetaData(foundType, this);
-                if (_mapParameterName2FactMetaData.contains(name)) {
+
+                parameterObj = QJsonObject();
+                rgElements = QJsonArray();
+                parameterObj[_nameKey] = name;
+                parameterObj[_typeKey] = type;
+                if (names.contains(name)) {
                     // We can't trust the meta data since we have dups
                     qCWarning(PX4ParameterMetaDataLog) << "Duplicate parameter found:" << name;
                     badMetaData = true;
-                    // Reset to default meta data
-                    _mapParameterName2FactMetaData[name] = metaData;
+                    parameterObj[_duplicateKey] = true;
                 } else {
-                    _mapParameterName2FactMetaData[name] = metaData;
-                    metaData->setName(name);
-                    metaData->setCategory(category);
-                    metaData->setGroup(factGroup);
-                    metaData->setReadOnly(readOnly);
-                    metaData->setVolatileValue(volatileValue);
-                    
+                    names.insert(name);
+                    parameterObj[_categoryKey] = category;
+                    parameterObj[_groupKey] = factGroup;
+                    parameterObj[_readOnlyKey] = readOnly;
+                    parameterObj[_volatileKey] = volatileValue;
                     if (xml.attributes().hasAttribute("default") && !strDefault.isEmpty()) {
-                        QVariant varDefault;
-                        
-                        if (metaData->convertAndValidateRaw(strDefault, false, varDefault, errorString)) {
-                            metaData->setRawDefaultValue(varDefault);
-                        } else {
-                            qCWarning(PX4ParameterMetaDataLog) << "Invalid default value, name:" << name << " type:" << type << " default:" << strDefault << " error:" << errorString;
-                        }
+                        parameterObj[_defaultKey] = strDefault;
                     }
                 }
-                
+
             } else {
                 // We should be getting meta data now
                 if (xmlState != XmlStateFoundParameter) {
-                    qWarning() << "Badly formed XML";
-                    return;
+                    return badlyFormed();
                 }
 
                 if (!badMetaData) {
-                    if (metaData) {
-                        if (elementName == "short_desc") {
-                            QString text = xml.readElementText();
-                            text = text.replace("\n", " ");
-                            qCDebug(PX4ParameterMetaDataLog) << "Short description:" << text;
-                            metaData->setShortDescription(text);
-
-                        } else if (elementName == "long_desc") {
-                            QString text = xml.readElementText();
-                            text = text.replace("\n", " ");
-                            qCDebug(PX4ParameterMetaDataLog) << "Long description:" << text;
-                            metaData->setLongDescription(text);
-
-                        } else if (elementName == "min") {
-                            QString text = xml.readElementText();
-                            qCDebug(PX4ParameterMetaDataLog) << "Min:" << text;
-
-                            QVariant varMin;
-                            if (metaData->convertAndValidateRaw(text, false /* convertOnly */, varMin, errorString)) {
-                                metaData->setRawMin(varMin);
-                            } else {
-                                qCWarning(PX4ParameterMetaDataLog) << "Invalid min value, name:" << metaData->name() << " type:" << metaData->type() << " min:" << text << " error:" << errorString;
-                            }
-
-                        } else if (elementName == "max") {
-                            QString text = xml.readElementText();
-                            qCDebug(PX4ParameterMetaDataLog) << "Max:" << text;
-
-                            QVariant varMax;
-                            if (metaData->convertAndValidateRaw(text, false /* convertOnly */, varMax, errorString)) {
-                                metaData->setRawMax(varMax);
-                            } else {
-                                qCWarning(PX4ParameterMetaDataLog) << "Invalid max value, name:" << metaData->name() << " type:" << metaData->type() << " max:" << text << " error:" << errorString;
-                            }
-
-                        } else if (elementName == "unit") {
-                            QString text = xml.readElementText();
-                            qCDebug(PX4ParameterMetaDataLog) << "Unit:" << text;
-                            metaData->setRawUnits(text);
-
-                        } else if (elementName == "decimal") {
-                            QString text = xml.readElementText();
-                            qCDebug(PX4ParameterMetaDataLog) << "Decimal:" << text;
-
-                            bool convertOk;
-                            QVariant varDecimals = QVariant(text).toUInt(&convertOk);
-                            if (convertOk) {
-                                metaData->setDecimalPlaces(varDecimals.toInt());
-                            } else {
-                                qCWarning(PX4ParameterMetaDataLog) << "Invalid decimals value, name:" << metaData->name() << " type:" << metaData->type() << " decimals:" << text << " error: invalid number";
-                            }
-
-                        } else if (elementName == "reboot_required") {
-                            QString text = xml.readElementText();
-                            qCDebug(PX4ParameterMetaDataLog) << "RebootRequired:" << text;
-                            if (text.compare("true", Qt::CaseInsensitive) == 0) {
-                                metaData->setVehicleRebootRequired(true);
-                            }
-
-                        } else if (elementName == "values") {
-                            // doing nothing individual value will follow anyway. May be used for sanity checking.
-
-                        } else if (elementName == "value") {
-                            QString enumValueStr = xml.attributes().value("code").toString();
-                            QString enumString = xml.readElementText();
-                            qCDebug(PX4ParameterMetaDataLog) << "parameter value:"
-                                                             << "value desc:" << enumString << "code:" << enumValueStr;
-
-                            QVariant    enumValue;
-                            QString     errorString;
-                            if (metaData->convertAndValidateRaw(enumValueStr, false /* validate */, enumValue, errorString)) {
-                                metaData->addEnumInfo(enumString, enumValue);
-                            } else {
-                                qCDebug(PX4ParameterMetaDataLog) << "Invalid enum value, name:" << metaData->name()
-                                                                 << " type:" << metaData->type() << " value:" << enumValueStr
-                                                                 << " error:" << errorString;
-                            }
-                        } else if (elementName == "increment") {
-                            double  increment;
-                            bool    ok;
-                            QString text = xml.readElementText();
-                            increment = text.toDouble(&ok);
-                            if (ok) {
-                                metaData->setRawIncrement(increment);
-                            } else {
-                                qCWarning(PX4ParameterMetaDataLog) << "Invalid value for increment, name:" << metaData->name() << " increment:" << text;
-                            }
-
-                        } else if (elementName == "boolean") {
-                            QVariant    enumValue;
-                            metaData->convertAndValidateRaw(1, false /* validate */, enumValue, errorString);
-                            metaData->addEnumInfo(tr("Enabled"), enumValue);
-                            metaData->convertAndValidateRaw(0, false /* validate */, enumValue, errorString);
-                            metaData->addEnumInfo(tr("Disabled"), enumValue);
-
-                        } else if (elementName == "bitmask") {
-                            // doing nothing individual bits will follow anyway. May be used for sanity checking.
-
-                        } else if (elementName == "bit") {
-                            bool ok = false;
-                            unsigned char bit = xml.attributes().value("index").toString().toUInt(&ok);
-                            if (ok) {
-                                QString bitDescription = xml.readElementText();
-                                qCDebug(PX4ParameterMetaDataLog) << "parameter value:"
-                                                                 << "index:" << bit << "description:" << bitDescription;
-
-                                if (bit < 31) {
-                                    QVariant bitmaskRawValue = 1 << bit;
-                                    QVariant bitmaskValue;
-                                    QString errorString;
-                                    if (metaData->convertAndValidateRaw(bitmaskRawValue, true, bitmaskValue, errorString)) {
-                                        metaData->addBitmaskInfo(bitDescription, bitmaskValue);
-                                    } else {
-                                        qCDebug(PX4ParameterMetaDataLog) << "Invalid bitmask value, name:" << metaData->name()
-                                                                         << " type:" << metaData->type() << " value:" << bitmaskValue
-                                                                         << " error:" << errorString;
-                                    }
-                                } else {
-                                    qCWarning(PX4ParameterMetaDataLog) << "Invalid value for bitmask, bit:" << bit;
-                                }
-                            }
-                        } else {
-                            qCDebug(PX4ParameterMetaDataLog) << "Unknown element in XML: " << elementName;
+                    if ((elementName == "short_desc") || (elementName == "long_desc") || (elementName == "min") || (elementName == "max") ||
+                            (elementName == "unit") || (elementName == "decimal") || (elementName == "reboot_required") || (elementName == "increment")) {
+                        rgElements.append(QJsonArray({ elementName, xml.readElementText() }));
+                    } else if (elementName == "values") {
+                        // doing nothing individual value will follow anyway. May be used for sanity checking.
+                    } else if (elementName == "value") {
+                        const QString enumValueStr = xml.attributes().value("code").toString();
+                        rgElements.append(QJsonArray({ elementName, xml.readElementText(), enumValueStr }));
+                    } else if (elementName == "boolean") {
+                        rgElements.append(QJsonArray({ elementName }));
+                    } else if (elementName == "bitmask") {
+                        // doing nothing individual bits will follow anyway. May be used for sanity checking.
+                    } else if (elementName == "bit") {
+                        bool ok = false;
+                        const QString bitIndex = xml.attributes().value("index").toString();
+                        (void) bitIndex.toUInt(&ok);
+                        if (ok) {
+                            rgElements.append(QJsonArray({ elementName, xml.readElementText(), bitIndex }));
                         }
                     } else {
-                        qWarning() << "Internal error";
+                        qCDebug(PX4ParameterMetaDataLog) << "Unknown element in XML: " << elementName;
                     }
                 }
             }
@@ -377,17 +287,14 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
             QString elementName = xml.name().toString();
 
             if (elementName == "parameter") {
-                // Done loading this parameter, validate default value
-                if (metaData->defaultValueAvailable()) {
-                    QVariant var;
-
-                    if (!metaData->convertAndValidateRaw(metaData->rawDefaultValue(), false /* convertOnly */, var, errorString)) {
-                        qCWarning(PX4ParameterMetaDataLog) << "Invalid default value, name:" << metaData->name() << " type:" << metaData->type() << " default:" << metaData->rawDefaultValue() << " error:" << errorString;
-                    }
+                if (!rgElements.isEmpty()) {
+                    parameterObj[_elementsKey] = rgElements;
                 }
+                rgParameters.append(parameterObj);
 
                 // Reset for next parameter
-                metaData = nullptr;
+                parameterObj = QJsonObject();
+                rgElements = QJsonArray();
                 badMetaData = false;
                 xmlState = XmlStateFoundGroup;
             } else if (elementName == "group") {
@@ -399,9 +306,169 @@ void PX4ParameterMetaData::loadParameterFactMetaDataFile(const QString& metaData
         xml.readNext();
     }
 
-#ifdef GENERATE_PARAMETER_JSON
-    _generateParameterJson();
-#endif
+    if (rgParameters.isEmpty()) {
+        errorString = QStringLiteral("No parameters found");
+        return false;
+    }
+
+    return true;
+}
+
+FactMetaData* PX4ParameterMetaData::_createMetaData(const QJsonObject& parameterObj)
+{
+    const QString name = parameterObj[_nameKey].toString();
+    const QString type = parameterObj[_typeKey].toString();
+
+    bool unknownType;
+    FactMetaData::ValueType_t foundType = FactMetaData::stringToType(type, unknownType);
+    if (unknownType) {
+        qWarning() << "Parameter meta data with bad type:" << type << " name:" << name;
+        return nullptr;
+    }
+
+    FactMetaData* metaData = new FactMetaData(foundType, this);
+    if (parameterObj[_duplicateKey].toBool()) {
+        // Default meta data, as for any duplicate
+        return metaData;
+    }
+
+    QString errorString;
+
+    metaData->setName(name);
+    metaData->setCategory(parameterObj[_categoryKey].toString());
+    metaData->setGroup(parameterObj[_groupKey].toString());
+    metaData->setReadOnly(parameterObj[_readOnlyKey].toBool());
+    metaData->setVolatileValue(parameterObj[_volatileKey].toBool());
+
+    if (parameterObj.contains(_defaultKey)) {
+        const QString strDefault = parameterObj[_defaultKey].toString();
+        QVariant varDefault;
+
+        if (metaData->convertAndValidateRaw(strDefault, false, varDefault, errorString)) {
+            metaData->setRawDefaultValue(varDefault);
+        } else {
+            qCWarning(PX4ParameterMetaDataLog) << "Invalid default value, name:" << name << " type:" << type << " default:" << strDefault << " error:" << errorString;
+        }
+    }
+
+    for (const QJsonValue& elementValue : parameterObj[_elementsKey].toArray()) {
+        const QJsonArray element = elementValue.toArray();
+        const QString elementName = element[0].toString();
+        QString text = element[1].toString();
+
+        if (elementName == "short_desc") {
+            text = text.replace("\n", " ");
+            qCDebug(PX4ParameterMetaDataLog) << "Short description:" << text;
+            metaData->setShortDescription(text);
+
+        } else if (elementName == "long_desc") {
+            text = text.replace("\n", " ");
+            qCDebug(PX4ParameterMetaDataLog) << "Long description:" << text;
+            metaData->setLongDescription(text);
+
+        } else if (elementName == "min") {
+            qCDebug(PX4ParameterMetaDataLog) << "Min:" << text;
+
+            QVariant varMin;
+            if (metaData->convertAndValidateRaw(text, false /* convertOnly */, varMin, errorString)) {
+                metaData->setRawMin(varMin);
+            } else {
+                qCWarning(PX4ParameterMetaDataLog) << "Invalid min value, name:" << metaData->name() << " type:" << metaData->type() << " min:" << text << " error:" << errorString;
+            }
+
+        } else if (elementName == "max") {
+            qCDebug(PX4ParameterMetaDataLog) << "Max:" << text;
+
+            QVariant varMax;
+            if (metaData->convertAndValidateRaw(text, false /* convertOnly */, varMax, errorString)) {
+                metaData->setRawMax(varMax);
+            } else {
+                qCWarning(PX4ParameterMetaDataLog) << "Invalid max value, name:" << metaData->name() << " type:" << metaData->type() << " max:" << text << " error:" << errorString;
+            }
+
+        } else if (elementName == "unit") {
+            qCDebug(PX4ParameterMetaDataLog) << "Unit:" << text;
+            metaData->setRawUnits(text);
+
+        } else if (elementName == "decimal") {
+            qCDebug(PX4ParameterMetaDataLog) << "Decimal:" << text;
+
+            bool convertOk;
+            QVariant varDecimals = QVariant(text).toUInt(&convertOk);
+            if (convertOk) {
+                metaData->setDecimalPlaces(varDecimals.toInt());
+            } else {
+                qCWarning(PX4ParameterMetaDataLog) << "Invalid decimals value, name:" << metaData->name() << " type:" << metaData->type() << " decimals:" << text << " error: invalid number";
+            }
+
+        } else if (elementName == "reboot_required") {
+            qCDebug(PX4ParameterMetaDataLog) << "RebootRequired:" << text;
+            if (text.compare("true", Qt::CaseInsensitive) == 0) {
+                metaData->setVehicleRebootRequired(true);
+            }
+
+        } else if (elementName == "value") {
+            const QString enumValueStr = element[2].toString();
+            qCDebug(PX4ParameterMetaDataLog) << "parameter value:"
+                                             << "value desc:" << text << "code:" << enumValueStr;
+
+            QVariant    enumValue;
+            if (metaData->convertAndValidateRaw(enumValueStr, false /* validate */, enumValue, errorString)) {
+                metaData->addEnumInfo(text, enumValue);
+            } else {
+                qCDebug(PX4ParameterMetaDataLog) << "Invalid enum value, name:" << metaData->name()
+                                                 << " type:" << metaData->type() << " value:" << enumValueStr
+                                                 << " error:" << errorString;
+            }
+
+        } else if (elementName == "increment") {
+            double  increment;
+            bool    ok;
+            increment = text.toDouble(&ok);
+            if (ok) {
+                metaData->setRawIncrement(increment);
+            } else {
+                qCWarning(PX4ParameterMetaDataLog) << "Invalid value for increment, name:" << metaData->name() << " increment:" << text;
+            }
+
+        } else if (elementName == "boolean") {
+            QVariant    enumValue;
+            metaData->convertAndValidateRaw(1, false /* validate */, enumValue, errorString);
+            metaData->addEnumInfo(tr("Enabled"), enumValue);
+            metaData->convertAndValidateRaw(0, false /* validate */, enumValue, errorString);
+            metaData->addEnumInfo(tr("Disabled"), enumValue);
+
+        } else if (elementName == "bit") {
+            const unsigned char bit = element[2].toString().toUInt();
+            qCDebug(PX4ParameterMetaDataLog) << "parameter value:"
+                                             << "index:" << bit << "description:" << text;
+
+            if (bit < 31) {
+                QVariant bitmaskRawValue = 1 << bit;
+                QVariant bitmaskValue;
+                if (metaData->convertAndValidateRaw(bitmaskRawValue, true, bitmaskValue, errorString)) {
+                    metaData->addBitmaskInfo(text, bitmaskValue);
+                } else {
+                    qCDebug(PX4ParameterMetaDataLog) << "Invalid bitmask value, name:" << metaData->name()
+                                                     << " type:" << metaData->type() << " value:" << bitmaskValue
+                                                     << " error:" << errorString;
+                }
+            } else {
+                qCWarning(PX4ParameterMetaDataLog) << "Invalid value for bitmask, bit:" << bit;
+            }
+        }
+    }
+
+    // Done loading this parameter, validate default value
+    if (metaData->defaultValueAvailable()) {
+        QVariant var;
+
+        if (!metaData->convertAndValidateRaw(metaData->rawDefaultValue(), false /* convertOnly */, var, errorString)) {
+            qCWarning(PX4ParameterMetaDataLog) << "Invalid default value, name:" << metaData->name() << " type:" << metaData->type() << " default:" << metaData->rawDefaultValue() << " error:" << errorString;
+        }
+    }
+
+    return metaData;
 }
 
 #ifdef GENERATE_PARAMETER_JSON
@@ -493,8 +560,19 @@ FactMetaData* PX4ParameterMetaData::getMetaDataForFact(const QString& name, MAV_
     Q_UNUSED(vehicleType)
 
     if (!_mapParameterName2FactMetaData.contains(name)) {
-        qCDebug(PX4ParameterMetaDataLog) << "No metaData for " << name << "using generic metadata";
-        FactMetaData* metaData = new FactMetaData(type, this);
+        // Built from the store on first use
+        FactMetaData* metaData = nullptr;
+        if (_metaDataStore.isOpen()) {
+            QString indexValue;
+            const QJsonObject parameterObj = _metaDataStore.parameter(name, indexValue);
+            if (!parameterObj.isEmpty()) {
+                metaData = _createMetaData(parameterObj);
+            }
+        }
+        if (!metaData) {
+            qCDebug(PX4ParameterMetaDataLog) << "No metaData for " << name << "using generic metadata";
+            metaData = new FactMetaData(type, this);
+        }
         _mapParameterName2FactMetaData[name] = metaData;
     }
 
@@ -12,6 +12,7 @@
 
 #include "MAVLinkLib.h"
 #include "FactMetaData.h"
+#include "ParameterMetaDataStore.h"
 
 #include <QtCore/QObject>
 #include <QtCore/QLoggingCategory>
@@ -31,7 +32,9 @@ class PX4ParameterMetaData : public QObject
 public:
     PX4ParameterMetaData(QObject* parent = nullptr);
 
-    void            loadParameterFactMetaDataFile   (const QString& metaDataFile);
+    /// Converts the xml into a ParameterMetaDataStore cached in cacheDirectory, the first time a given file is seen. After
+    /// that the cache is mapped and FactMetaData is only built for the parameters asked for.
+    void            loadParameterFactMetaDataFile   (const QString& metaDataFile, const QString& cacheDirectory = ParameterMetaDataStore::defaultCacheDirectory());
     FactMetaData*   getMetaDataForFact              (const QString& name, MAV_TYPE vehicleType, FactMetaData::ValueType_t type);
 
     static void getParameterMetaDataVersionInfo(const QString& metaDataFile, int& majorVersion, int& minorVersion);
@@ -46,6 +49,8 @@ class PX4ParameterMetaData : public QObject
         XmlStateDone
     };
 
+    static bool _parseXml(const QByteArray& xmlBytes, QJsonArray& rgParameters, QString& errorString);
+    FactMetaData* _createMetaData(const QJsonObject& parameterObj);
     QVariant _stringToTypedVariant(const QString& string, FactMetaData::ValueType_t type, bool* convertOk);
     static void _outputFileWarning(const QString& metaDataFile, const QString& error1, const QString& error2);
 
@@ -55,6 +60,19 @@ class PX4ParameterMetaData : public QObject
 
     bool                                _parameterMetaDataLoaded        = false;    ///< true: parameter meta data already loaded
     FactMetaData::NameToMetaDataMap_t   _mapParameterName2FactMetaData;             ///< Maps from a parameter name to FactMetaData
+    ParameterMetaDataStore              _metaDataStore;                             ///< Parameter records converted from the xml
+
+    static constexpr int kStoreRecordVersion = 1;   ///< Bump when the record layout written by _parseXml changes
+
+    static constexpr const char* _nameKey =         "name";
+    static constexpr const char* _typeKey =         "type";
+    static constexpr const char* _defaultKey =      "default";
+    static constexpr const char* _categoryKey =     "category";
+    static constexpr const char* _groupKey =        "group";
+    static constexpr const char* _readOnlyKey =     "readOnly";
+    static constexpr const char* _volatileKey =     "volatile";
+    static constexpr const char* _duplicateKey =    "duplicate";
+    static constexpr const char* _elementsKey =     "elements";
 
     static constexpr const char* kInvalidConverstion = "Internal Error: No support for string parameters";
 
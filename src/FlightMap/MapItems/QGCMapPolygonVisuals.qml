@@ -223,7 +223,7 @@ Item {
         title:          qsTr("Select Polygon File")
 
         onAcceptedForLoad: (file) => {
-            mapPolygon.loadKMLOrSHPFile(file)
+            mapPolygon.loadKMLOrSHPFile(file, QGroundControl.settingsManager.planViewSettings.shapeSimplifyTolerance.rawValue)
             mapFitFunctions.fitMapViewportToMissionItems()
             close()
         }
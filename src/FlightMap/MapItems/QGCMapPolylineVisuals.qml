@@ -126,7 +126,7 @@ Item {
         title:          qsTr("Select Polyline File")
 
         onAcceptedForLoad: (file) => {
-            mapPolyline.loadKMLOrSHPFile(file)
+            mapPolyline.loadKMLOrSHPFile(file, QGroundControl.settingsManager.planViewSettings.shapeSimplifyTolerance.rawValue)
             mapFitFunctions.fitMapViewportToMissionItems()
             close()
         }
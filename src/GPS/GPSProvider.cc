@@ -9,7 +9,6 @@
 
 #include "GPSProvider.h"
 #include "QGCLoggingCategory.h"
-#include "RTCMMavlink.h"
 
 #include <ashtech.h>
 #include <base_station.h>
@@ -250,14 +249,12 @@ GPSBaseStationSupport *GPSProvider::_connectGPS()
 
 void GPSProvider::_sendRTCMData()
 {
-    RTCMMavlink *const rtcm = new RTCMMavlink(this);
-
     const int fakeMsgLengths[3] = { 30, 170, 240 };
     const uint8_t* const fakeData = new uint8_t[fakeMsgLengths[2]];
     while (!_requestStop) {
         for (int i = 0; i < 3; ++i) {
             const QByteArray message(reinterpret_cast<const char*>(fakeData), fakeMsgLengths[i]);
-            rtcm->RTCMDataUpdate(message);
+            emit RTCMDataUpdate(message);
             msleep(4);
         }
         msleep(100);
@@ -10,10 +10,16 @@
 #include "GPSRtk.h"
 #include "GPSProvider.h"
 #include "GPSRTKFactGroup.h"
+#include "MultiVehicleManager.h"
 #include "QGCLoggingCategory.h"
 #include "RTCMMavlink.h"
 #include "RTKSettings.h"
 #include "SettingsManager.h"
+#include "Vehicle.h"
+#include "VehicleGPSFactGroup.h"
+#include "VehicleLinkManager.h"
+
+#include <QtCore/QThread>
 
 QGC_LOGGING_CATEGORY(GPSRtkLog, "qgc.gps.gpsrtk")
 
@@ -26,6 +32,9 @@ GPSRtk::GPSRtk(QObject *parent)
     (void) qRegisterMetaType<satellite_info_s>("satellite_info_s");
     (void) qRegisterMetaType<sensor_gnss_relative_s>("sensor_gnss_relative_s");
     (void) qRegisterMetaType<sensor_gps_s>("sensor_gps_s");
+
+    _correctionAgeTimer.setInterval(1000);
+    (void) connect(&_correctionAgeTimer, &QTimer::timeout, this, &GPSRtk::_updateCorrectionAges);
 }
 
 GPSRtk::~GPSRtk()
@@ -95,8 +104,23 @@ void GPSRtk::connectGPS(const QString &device, QStringView gps_type)
     );
     (void) QMetaObject::invokeMethod(_gpsProvider, "start", Qt::AutoConnection);
 
-    _rtcmMavlink = new RTCMMavlink(this);
-    (void) connect(_gpsProvider, &GPSProvider::RTCMDataUpdate, _rtcmMavlink, &RTCMMavlink::RTCMDataUpdate);
+    // Corrections bypass the GUI thread: the provider hands them straight to the RTCM thread
+    _rtcmMavlink = new RTCMMavlink();
+    _rtcmThread = new QThread(this);
+    _rtcmThread->setObjectName(QStringLiteral("RTCM"));
+    _rtcmMavlink->moveToThread(_rtcmThread);
+    _rtcmThread->start(QThread::HighPriority);
+    (void) connect(_gpsProvider, &GPSProvider::RTCMDataUpdate, _rtcmMavlink, &RTCMMavlink::RTCMDataUpdate, Qt::DirectConnection);
+
+    MultiVehicleManager *const multiVehicleManager = MultiVehicleManager::instance();
+    (void) connect(multiVehicleManager, &MultiVehicleManager::vehicleAdded, this, &GPSRtk::_vehicleAdded, Qt::UniqueConnection);
+    (void) connect(multiVehicleManager, &MultiVehicleManager::vehicleRemoved, this, &GPSRtk::_updateRTCMTargets, Qt::UniqueConnection);
+    QmlObjectListModel *const vehicles = multiVehicleManager->vehicles();
+    for (qsizetype i = 0; i < vehicles->count(); i++) {
+        _vehicleAdded(qobject_cast<Vehicle*>(vehicles->get(i)));
+    }
+    _updateRTCMTargets();
+    _correctionAgeTimer.start();
 
     (void) connect(_gpsProvider, &GPSProvider::satelliteInfoUpdate, this, &GPSRtk::_satelliteInfoUpdate);
     (void) connect(_gpsProvider, &GPSProvider::sensorGpsUpdate, this, &GPSRtk::_sensorGpsUpdate);
@@ -112,15 +136,66 @@ void GPSRtk::disconnectGPS()
         _requestGpsStop = true;
         if (!_gpsProvider->wait(kGPSThreadDisconnectTimeout)) {
             qCWarning(GPSRtkLog) << "Failed to wait for GPS thread exit. Consider increasing the timeout";
+            // The provider still references _requestGpsStop and hands corrections straight to _rtcmMavlink,
+            // neither may go away or be reset until it has really exited
+            (void) _gpsProvider->wait();
         }
 
         _gpsProvider->deleteLater();
         _gpsProvider = nullptr;
     }
 
-    if (_rtcmMavlink) {
-        _rtcmMavlink->deleteLater();
+    if (_rtcmThread) {
+        _rtcmThread->quit();
+        _rtcmThread->wait();
+        delete _rtcmThread;
+        _rtcmThread = nullptr;
+
+        delete _rtcmMavlink;
         _rtcmMavlink = nullptr;
+
+        // The age timer is left to clear the ages on its next tick, then stops
+    }
+}
+
+void GPSRtk::_vehicleAdded(Vehicle *vehicle)
+{
+    (void) connect(vehicle->vehicleLinkManager(), &VehicleLinkManager::primaryLinkChanged, this, &GPSRtk::_updateRTCMTargets, Qt::UniqueConnection);
+    _updateRTCMTargets();
+}
+
+void GPSRtk::_updateRTCMTargets()
+{
+    if (!_rtcmMavlink) {
+        return;
+    }
+
+    QList<RTCMMavlink::Target_t> targets;
+    QmlObjectListModel *const vehicles = MultiVehicleManager::instance()->vehicles();
+    for (qsizetype i = 0; i < vehicles->count(); i++) {
+        Vehicle *const vehicle = qobject_cast<Vehicle*>(vehicles->get(i));
+        targets.append({ vehicle->id(), vehicle->vehicleLinkManager()->primaryLink() });
+    }
+
+    _rtcmMavlink->setTargets(targets);
+}
+
+void GPSRtk::_updateCorrectionAges()
+{
+    QmlObjectListModel *const vehicles = MultiVehicleManager::instance()->vehicles();
+    for (qsizetype i = 0; i < vehicles->count(); i++) {
+        Vehicle *const vehicle = qobject_cast<Vehicle*>(vehicles->get(i));
+        VehicleGPSFactGroup *const gps = qobject_cast<VehicleGPSFactGroup*>(vehicle->gpsFactGroup());
+        if (!gps) {
+            continue;
+        }
+
+        const qint64 ageMsecs = _rtcmMavlink ? _rtcmMavlink->correctionAgeMsecs(vehicle->id()) : -1;
+        gps->correctionAge()->setRawValue((ageMsecs < 0) ? std::numeric_limits<double>::quiet_NaN() : (ageMsecs / 1000.));
+    }
+
+    if (!_rtcmMavlink) {
+        _correctionAgeTimer.stop();
     }
 }
 
@@ -12,6 +12,7 @@
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QObject>
 #include <QtCore/QString>
+#include <QtCore/QTimer>
 
 #include "satellite_info.h"
 #include "sensor_gnss_relative.h"
@@ -23,6 +24,8 @@ class GPSRTKFactGroup;
 class FactGroup;
 class RTCMMavlink;
 class GPSProvider;
+class QThread;
+class Vehicle;
 
 class GPSRtk : public QObject
 {
@@ -44,10 +47,15 @@ private slots:
     void _onGPSConnect();
     void _onGPSDisconnect();
     void _onGPSSurveyInStatus(float duration, float accuracyMM, double latitude, double longitude, float altitude, bool valid, bool active);
+    void _vehicleAdded(Vehicle *vehicle);
+    void _updateRTCMTargets();
+    void _updateCorrectionAges();
 
 private:
     GPSProvider *_gpsProvider = nullptr;
     RTCMMavlink *_rtcmMavlink = nullptr;
+    QThread *_rtcmThread = nullptr;
+    QTimer _correctionAgeTimer;
     GPSRTKFactGroup *_gpsRtkFactGroup = nullptr;
 
     std::atomic_bool _requestGpsStop = false;
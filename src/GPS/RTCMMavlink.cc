@@ -9,9 +9,9 @@
 
 #include "RTCMMavlink.h"
 #include "MAVLinkProtocol.h"
-#include "MultiVehicleManager.h"
 #include "QGCLoggingCategory.h"
-#include "Vehicle.h"
+
+#include <QtCore/QThread>
 
 QGC_LOGGING_CATEGORY(RTCMMavlinkLog, "qgc.gps.rtcmmavlink")
 
@@ -21,6 +21,7 @@ RTCMMavlink::RTCMMavlink(QObject *parent)
     // qCDebug(RTCMMavlinkLog) << Q_FUNC_INFO << this;
 
     _bandwidthTimer.start();
+    _correctionTimer.start();
 }
 
 RTCMMavlink::~RTCMMavlink()
@@ -28,59 +29,185 @@ RTCMMavlink::~RTCMMavlink()
     // qCDebug(RTCMMavlinkLog) << Q_FUNC_INFO << this;
 }
 
+void RTCMMavlink::setTargets(const QList<Target_t> &targets)
+{
+    QMutexLocker lock(&_targetsMutex);
+
+    _targets = targets;
+
+    QHash<int, qint64> lastCorrectionMsecs;
+    for (const Target_t &target : targets) {
+        const auto it = _lastCorrectionMsecs.constFind(target.vehicleId);
+        if (it != _lastCorrectionMsecs.constEnd()) {
+            lastCorrectionMsecs.insert(target.vehicleId, *it);
+        }
+    }
+    _lastCorrectionMsecs = lastCorrectionMsecs;
+}
+
+qint64 RTCMMavlink::correctionAgeMsecs(int vehicleId) const
+{
+    QMutexLocker lock(&_targetsMutex);
+
+    const auto it = _lastCorrectionMsecs.constFind(vehicleId);
+    if (it == _lastCorrectionMsecs.constEnd()) {
+        return -1;
+    }
+
+    return _correctionTimer.elapsed() - *it;
+}
+
 void RTCMMavlink::RTCMDataUpdate(QByteArrayView data)
 {
-#ifdef QT_DEBUG
-    _calculateBandwith(data.size());
-#endif
+    if (data.isEmpty()) {
+        return;
+    }
 
-    mavlink_gps_rtcm_data_t gpsRtcmData{};
+    const bool processNeeded = _pending.push(data.constData(), static_cast<int>(data.size()));
+
+    if (QThread::currentThread() == thread()) {
+        _processPending();
+    } else if (processNeeded) {
+        // One queued call covers every message handed over until it runs
+        (void) QMetaObject::invokeMethod(this, &RTCMMavlink::_processPending, Qt::QueuedConnection);
+    }
+}
 
+QList<mavlink_gps_rtcm_data_t> RTCMMavlink::pack(const QList<QByteArray> &messages, uint8_t &sequenceId)
+{
     static constexpr qsizetype maxMessageLength = MAVLINK_MSG_GPS_RTCM_DATA_FIELD_DATA_LEN;
-    if (data.size() < maxMessageLength) {
-        gpsRtcmData.len = data.size();
-        gpsRtcmData.flags = (_sequenceId & 0x1FU) << 3;
-        (void) memcpy(&gpsRtcmData.data, data.data(), data.size());
-        _sendMessageToVehicle(gpsRtcmData);
-    } else {
+
+    QList<mavlink_gps_rtcm_data_t> packets;
+    mavlink_gps_rtcm_data_t packed{};
+
+    const auto flushPacked = [&packets, &packed]() {
+        if (packed.len > 0) {
+            packets.append(packed);
+            packed = {};
+        }
+    };
+
+    for (const QByteArray &message : messages) {
+        if (message.isEmpty()) {
+            continue;
+        }
+
+        if (message.size() <= maxMessageLength) {
+            // RTCM messages carry their own framing, so whole messages can share an unfragmented packet
+            if ((packed.len + message.size()) > maxMessageLength) {
+                flushPacked();
+            }
+            if (packed.len == 0) {
+                packed.flags = (sequenceId++ & 0x1FU) << 3;
+            }
+            (void) memcpy(packed.data + packed.len, message.constData(), message.size());
+            packed.len += static_cast<uint8_t>(message.size());
+            continue;
+        }
+
+        if (message.size() > (kMaxFragments * maxMessageLength)) {
+            // The fragment id only has two bits
+            qCWarning(RTCMMavlinkLog) << "Dropping RTCM message too large to fragment:" << message.size() << "bytes";
+            continue;
+        }
+
+        // Keep the stream in order
+        flushPacked();
+
+        mavlink_gps_rtcm_data_t fragment{};
         uint8_t fragmentId = 0;
         qsizetype start = 0;
-        while (start < data.size()) {
-            gpsRtcmData.flags = 0x01U; // LSB set indicates message is fragmented
-            gpsRtcmData.flags |= fragmentId++ << 1; // Next 2 bits are fragment id
-            gpsRtcmData.flags |= (_sequenceId & 0x1FU) << 3; // Next 5 bits are sequence id
+        while (start < message.size()) {
+            fragment.flags = 0x01U; // LSB set indicates message is fragmented
+            fragment.flags |= fragmentId++ << 1; // Next 2 bits are fragment id
+            fragment.flags |= (sequenceId & 0x1FU) << 3; // Next 5 bits are sequence id
 
-            const qsizetype length = std::min(data.size() - start, maxMessageLength);
-            gpsRtcmData.len = length;
+            const qsizetype length = std::min(message.size() - start, maxMessageLength);
+            fragment.len = length;
 
-            (void) memcpy(gpsRtcmData.data, data.constData() + start, length);
-            _sendMessageToVehicle(gpsRtcmData);
+            (void) memcpy(fragment.data, message.constData() + start, length);
+            packets.append(fragment);
 
             start += length;
         }
+
+        ++sequenceId;
     }
 
-    ++_sequenceId;
+    flushPacked();
+
+    return packets;
 }
 
-void RTCMMavlink::_sendMessageToVehicle(const mavlink_gps_rtcm_data_t &data)
+void RTCMMavlink::_processPending()
 {
-    QmlObjectListModel* const vehicles = MultiVehicleManager::instance()->vehicles();
-    for (qsizetype i = 0; i < vehicles->count(); i++) {
-        Vehicle* const vehicle = qobject_cast<Vehicle*>(vehicles->get(i));
-        const SharedLinkInterfacePtr sharedLink = vehicle->vehicleLinkManager()->primaryLink().lock();
-        if (sharedLink) {
+    QList<QByteArray> messages;
+    qsizetype bytes = 0;
+    _pending.drain(false, [&messages, &bytes](const QByteArray &message) {
+        messages.append(message);
+        bytes += message.size();
+    });
+
+    if (messages.isEmpty()) {
+        return;
+    }
+
+#ifdef QT_DEBUG
+    _calculateBandwith(bytes);
+#else
+    Q_UNUSED(bytes);
+#endif
+
+    const QList<mavlink_gps_rtcm_data_t> packets = pack(messages, _sequenceId);
+    if (packets.isEmpty()) {
+        return;
+    }
+
+    _targetsMutex.lock();
+    const QList<Target_t> targets = _targets;
+    _targetsMutex.unlock();
+
+    const uint8_t systemId = MAVLinkProtocol::instance()->getSystemId();
+    const uint8_t componentId = MAVLinkProtocol::getComponentId();
+
+    // GPS_RTCM_DATA is not targeted, so vehicles sharing a link all receive a single copy
+    QList<SharedLinkInterfacePtr> sentLinks;
+    QList<int> reachedVehicles;
+    for (const Target_t &target : targets) {
+        const SharedLinkInterfacePtr sharedLink = target.link.lock();
+        if (!sharedLink || !sharedLink->isConnected()) {
+            continue;
+        }
+
+        reachedVehicles.append(target.vehicleId);
+        if (sentLinks.contains(sharedLink)) {
+            continue;
+        }
+        sentLinks.append(sharedLink);
+
+        for (const mavlink_gps_rtcm_data_t &packet : packets) {
             mavlink_message_t message;
             (void) mavlink_msg_gps_rtcm_data_encode_chan(
-                MAVLinkProtocol::instance()->getSystemId(),
-                MAVLinkProtocol::getComponentId(),
+                systemId,
+                componentId,
                 sharedLink->mavlinkChannel(),
                 &message,
-                &data
+                &packet
             );
-            (void) vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), message);
+
+            uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+            const int length = mavlink_msg_to_send_buffer(buffer, &message);
+
+            // Corrections go stale quickly, don't leave them behind bulk transfers
+            sharedLink->writeBytesThreadSafe(reinterpret_cast<const char*>(buffer), length, true);
         }
     }
+
+    const qint64 now = _correctionTimer.elapsed();
+    QMutexLocker lock(&_targetsMutex);
+    for (const int vehicleId : std::as_const(reachedVehicles)) {
+        _lastCorrectionMsecs[vehicleId] = now;
+    }
 }
 
 void RTCMMavlink::_calculateBandwith(qsizetype bytes)
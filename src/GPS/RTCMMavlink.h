@@ -11,27 +11,62 @@
 #pragma once
 
 #include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+#include <QtCore/QList>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QMutex>
 #include <QtCore/QObject>
 
-typedef struct __mavlink_gps_rtcm_data_t mavlink_gps_rtcm_data_t;
+#include "LinkInterface.h"
+#include "LinkWriteQueue.h"
+#include "MAVLinkLib.h"
 
 Q_DECLARE_LOGGING_CATEGORY(RTCMMavlinkLog)
 
+/// Forwards RTCM corrections to every vehicle as GPS_RTCM_DATA. Corrections may be handed over from any
+/// thread, they are packed and sent from the thread this object lives on. Each link gets every packet once,
+/// however many vehicles share it, as a priority frame on the link's write queue.
 class RTCMMavlink : public QObject
 {
     Q_OBJECT
 
 public:
+    typedef struct {
+        int vehicleId;
+        WeakLinkInterfacePtr link;  ///< Vehicle's primary link
+    } Target_t;
+
     RTCMMavlink(QObject *parent = nullptr);
     ~RTCMMavlink();
 
+    /// Thread safe. Replaces the vehicles the corrections are sent to.
+    void setTargets(const QList<Target_t> &targets);
+
+    /// Thread safe. Time since a correction was last queued to the vehicle's link
+    ///     @return -1 if none has been
+    qint64 correctionAgeMsecs(int vehicleId) const;
+
+    /// Splits the RTCM messages into GPS_RTCM_DATA payloads. Messages which fit are packed together in order,
+    /// larger ones are fragmented. Messages too large for four fragments are dropped.
+    ///     @param sequenceId Sequence id for the next fragmented message, advanced for each one
+    static QList<mavlink_gps_rtcm_data_t> pack(const QList<QByteArray> &messages, uint8_t &sequenceId);
+
+    static constexpr int kMaxFragments = 4;
+
 public slots:
+    /// Thread safe
     void RTCMDataUpdate(QByteArrayView data);
 
 private:
+    void _processPending();
     void _calculateBandwith(qsizetype bytes);
-    static void _sendMessageToVehicle(const mavlink_gps_rtcm_data_t &data);
+
+    LinkWriteQueue _pending;            ///< RTCM messages waiting for this object's thread
+
+    mutable QMutex _targetsMutex;
+    QList<Target_t> _targets;
+    QHash<int, qint64> _lastCorrectionMsecs;    ///< Vehicle id to _correctionTimer time
+    QElapsedTimer _correctionTimer;
 
     uint8_t _sequenceId = 0;
     qsizetype _bandwidthByteCounter = 0;
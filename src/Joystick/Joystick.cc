@@ -442,9 +442,9 @@ float Joystick::_adjustRange(int value, const Calibration_t &calibration, bool w
 
 void Joystick::run()
 {
-    _open();
+    using Clock = std::chrono::steady_clock;
 
-    _axisTime.start();
+    _open();
 
     for (int buttonIndex = 0; buttonIndex < _totalButtonCount; buttonIndex++) {
         if (_buttonActionArray[buttonIndex]) {
@@ -452,20 +452,109 @@ void Joystick::run()
         }
     }
 
+    // Periodic axis sends are scheduled against fixed deadlines so processing time doesn't make the rate drift.
+    // Input arriving in between goes out right away, limited to the maximum axis rate.
+    const Clock::duration minInputInterval = _period<Clock::duration>(_maxAxisFrequencyHz);
+    Clock::time_point nextAxisDeadline = Clock::now();
+    Clock::time_point lastAxisSend;
+    Clock::time_point inputTime;
+    bool inputPending = false;
+
     while (!_exitThread) {
+        const Clock::time_point now = Clock::now();
+
+        // Button repeats are timed from the button state, so wake up regularly for them
+        Clock::time_point wakeTime = now + kButtonPollInterval;
+        if (axisCount() != 0) {
+            wakeTime = std::min(wakeTime, nextAxisDeadline);
+            if (inputPending) {
+                wakeTime = std::min(wakeTime, lastAxisSend + minInputInterval);
+            }
+        }
+
+        const std::chrono::microseconds timeout = std::chrono::duration_cast<std::chrono::microseconds>(std::max(wakeTime - now, Clock::duration::zero()));
+        if (_waitForInput(timeout) && !inputPending) {
+            inputPending = true;
+            inputTime = Clock::now();
+        }
+
         _update();
         _handleButtons();
-        if (axisCount() != 0) {
-            _handleAxis();
+
+        if (axisCount() == 0) {
+            continue;
+        }
+
+        const Clock::time_point sendTime = Clock::now();
+        const bool deadlineReached = (sendTime >= nextAxisDeadline);
+        const bool inputDue = inputPending && ((sendTime - lastAxisSend) >= minInputInterval);
+        if (!deadlineReached && !inputDue) {
+            continue;
         }
 
-        const int sleep = qMin(static_cast<int>(1000.0f / _maxAxisFrequencyHz), static_cast<int>(1000.0f / _maxButtonFrequencyHz)) / 2;
-        QThread::msleep(sleep);
+        _handleAxis();
+        const Clock::time_point sentTime = Clock::now();
+
+        {
+            QMutexLocker locker(&_inputStatsMutex);
+            if (inputPending) {
+                _inputLatency.record(std::chrono::duration_cast<std::chrono::microseconds>(sentTime - inputTime).count());
+                if (!deadlineReached) {
+                    _inputSendsAhead++;
+                }
+            }
+            if (deadlineReached) {
+                _sendJitter.record(std::chrono::duration_cast<std::chrono::microseconds>(sendTime - nextAxisDeadline).count());
+            }
+        }
+
+        inputPending = false;
+        lastAxisSend = sendTime;
+        if (deadlineReached) {
+            nextAxisDeadline += _period<Clock::duration>(_axisFrequencyHz);
+            if (nextAxisDeadline <= sentTime) {
+                // More than a period behind, start over rather than sending a burst to catch up
+                nextAxisDeadline = sentTime + _period<Clock::duration>(_axisFrequencyHz);
+            }
+        }
     }
 
     _close();
 }
 
+bool Joystick::_waitForInput(std::chrono::microseconds timeout)
+{
+    QThread::usleep(static_cast<unsigned long>(std::min(timeout, kInputPollInterval).count()));
+    return false;
+}
+
+QVariantMap Joystick::inputStats() const
+{
+    QMutexLocker locker(&_inputStatsMutex);
+
+    QVariantMap stats;
+    stats[QStringLiteral("inputSends")] = _inputLatency.count();
+    stats[QStringLiteral("inputLatencyP50")] = _inputLatency.valueAtPercentile(50.);
+    stats[QStringLiteral("inputLatencyP99")] = _inputLatency.valueAtPercentile(99.);
+    stats[QStringLiteral("inputLatencyMax")] = _inputLatency.max();
+    stats[QStringLiteral("inputSendsAhead")] = _inputSendsAhead;
+    stats[QStringLiteral("periodicSends")] = _sendJitter.count();
+    stats[QStringLiteral("sendJitterP50")] = _sendJitter.valueAtPercentile(50.);
+    stats[QStringLiteral("sendJitterP99")] = _sendJitter.valueAtPercentile(99.);
+    stats[QStringLiteral("sendJitterMax")] = _sendJitter.max();
+
+    return stats;
+}
+
+void Joystick::resetInputStats()
+{
+    QMutexLocker locker(&_inputStatsMutex);
+
+    _inputLatency.reset();
+    _inputSendsAhead = 0;
+    _sendJitter.reset();
+}
+
 void Joystick::_handleButtons()
 {
     int lastBbuttonValues[256]{};
@@ -578,13 +667,6 @@ void Joystick::_handleButtons()
 
 void Joystick::_handleAxis()
 {
-    const int axisDelay = static_cast<int>(1000.0f / _axisFrequencyHz);
-    if (_axisTime.elapsed() <= axisDelay) {
-        return;
-    }
-
-    _axisTime.start();
-
     for (int axisIndex = 0; axisIndex < _axisCount; axisIndex++) {
         int newAxisValue = _getAxis(axisIndex);
         // Calibration code requires signal to be emitted even if value hasn't changed
@@ -592,7 +674,7 @@ void Joystick::_handleAxis()
         emit rawAxisValueChanged(axisIndex, newAxisValue);
     }
 
-    if (!_activeVehicle->joystickEnabled() || _calibrationMode || !_calibrated) {
+    if (!_activeVehicle || !_activeVehicle->joystickEnabled() || _calibrationMode || !_calibrated) {
         return;
     }
 
@@ -731,7 +813,8 @@ void Joystick::startPolling(Vehicle* vehicle)
 
     if (!isRunning()) {
         _exitThread = false;
-        start();
+        resetInputStats();
+        start(QThread::TimeCriticalPriority);
     }
 }
 
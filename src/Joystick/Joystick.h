@@ -9,13 +9,18 @@
 
 #pragma once
 
+#include "LatencyHistogram.h"
 #include "MAVLinkLib.h"
 
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QMutex>
 #include <QtCore/QObject>
 #include <QtCore/QThread>
+#include <QtCore/QVariantMap>
 #include <QtQmlIntegration/QtQmlIntegration>
 
+#include <chrono>
+
 Q_DECLARE_LOGGING_CATEGORY(JoystickLog)
 Q_DECLARE_LOGGING_CATEGORY(JoystickValuesLog)
 
@@ -130,6 +135,13 @@ class Joystick : public QThread
     QStringList assignableActionTitles() const { return _availableActionTitles; }
     QString disabledActionName() const { return _buttonActionNone; }
 
+    /// Timing of the axis sends since polling started or the last reset, thread safe. All times in usecs.
+    ///     inputLatency*: From the input event being seen to the axis values having been sent
+    ///     inputSendsAhead: Input sends which went out before the next periodic deadline was reached
+    ///     sendJitter*: How late periodic sends went out relative to their deadline
+    Q_INVOKABLE QVariantMap inputStats() const;
+    Q_INVOKABLE void resetInputStats();
+
     void stop();
 
     /// Start the polling thread which will in turn emit joystick signals
@@ -246,6 +258,11 @@ private slots:
     virtual int _getAxis(int i) const = 0;
     virtual bool _getHat(int hat, int i) const = 0;
 
+    /// Blocks until the joystick reports new input or the timeout expires. The default implementation has no
+    /// input events and simply sleeps, which leaves the joystick on its periodic sends.
+    ///     @return true: Input arrived
+    virtual bool _waitForInput(std::chrono::microseconds timeout);
+
     void run() override;
 
     void _saveSettings();
@@ -270,6 +287,9 @@ private slots:
     /// Remap current axis functions from current TX mode to new TX mode
     void _remapAxes(int currentMode, int newMode, int (&newMapping)[maxFunction]);
 
+    template<typename Duration>
+    static Duration _period(float frequencyHz) { return std::chrono::duration_cast<Duration>(std::chrono::duration<float>(1.0f / frequencyHz)); }
+
     int _hatButtonCount = 0;
     int _totalButtonCount = 0;
     int *_rgAxisValues = nullptr;
@@ -289,7 +309,6 @@ private slots:
     float _buttonFrequencyHz = _defaultButtonFrequencyHz;
     float _exponential = 0;
     int _rgFunctionAxis[maxFunction] = {};
-    QElapsedTimer _axisTime;
     QList<AssignedButtonAction*> _buttonActionArray;
     QStringList _availableActionTitles;
     std::atomic<bool> _exitThread = false;    ///< true: signal thread to exit
@@ -297,6 +316,11 @@ private slots:
     Vehicle *_activeVehicle = nullptr;
     const char *_txModeSettingsKey = nullptr;
 
+    mutable QMutex _inputStatsMutex;
+    LatencyHistogram _inputLatency;
+    quint64 _inputSendsAhead = 0;
+    LatencyHistogram _sendJitter;
+
     static int _transmitterMode;
 
     static constexpr float _defaultAxisFrequencyHz = 25.0f;
@@ -307,6 +331,9 @@ private slots:
     static constexpr float _minButtonFrequencyHz = 0.25f;
     static constexpr float _maxButtonFrequencyHz = 50.0f;
 
+    static constexpr std::chrono::milliseconds kButtonPollInterval{10};
+    static constexpr std::chrono::microseconds kInputPollInterval{2000};   ///< Used when the joystick has no input events
+
     static constexpr const char *_rgFunctionSettingsKey[maxFunction] = {
         "RollAxis",
         "PitchAxis",
@@ -60,6 +60,8 @@ void JoystickManager::init()
         return;
     }
     _setActiveJoystickFromSettings();
+    // Sent from the active joystick's thread, which takes over the SDL event queue while it runs
+    (void) connect(this, &JoystickManager::updateAvailableJoysticksSignal, this, &JoystickManager::_setActiveJoystickFromSettings, Qt::QueuedConnection);
 #elif defined(Q_OS_ANDROID)
     if (!JoystickAndroid::init()) {
         return;
@@ -187,6 +189,11 @@ bool JoystickManager::setActiveJoystickName(const QString &name)
 void JoystickManager::_updateAvailableJoysticks()
 {
 #ifdef QGC_SDL_JOYSTICK
+    if (_activeJoystick && _activeJoystick->isRunning()) {
+        // The joystick thread consumes the events and reports device changes through updateAvailableJoysticksSignal
+        return;
+    }
+
     SDL_Event event;
     while (SDL_PollEvent(&event)) {
         switch(event.type) {
@@ -8,12 +8,15 @@
  ****************************************************************************/
 
 #include "JoystickSDL.h"
+#include "JoystickManager.h"
 #include "QGCLoggingCategory.h"
 
 #include <QtCore/QFile>
 #include <QtCore/QIODevice>
 #include <QtCore/QTextStream>
 
+#include <chrono>
+
 #include <SDL.h>
 
 QGC_LOGGING_CATEGORY(JoystickSDLLog, "qgc.joystick.joysticksdl")
@@ -198,6 +201,64 @@ bool JoystickSDL::_getHat(int hat, int i) const
     return ((SDL_JoystickGetHat(_sdlJoystick, hat) & hatButtons[i]) != 0);
 }
 
+bool JoystickSDL::_waitForInput(std::chrono::microseconds timeout)
+{
+    if (!_sdlJoystick) {
+        return Joystick::_waitForInput(timeout);
+    }
+
+    // While this thread runs it is the only consumer of the SDL event queue. Device added/removed events
+    // are passed on to JoystickManager, input for other joysticks is dropped.
+    const SDL_JoystickID instanceId = SDL_JoystickInstanceID(_sdlJoystick);
+    const int timeoutMsecs = static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(timeout).count());
+
+    bool input = false;
+    bool devicesChanged = false;
+    SDL_Event event;
+    int pending = SDL_WaitEventTimeout(&event, timeoutMsecs);
+    while (pending) {
+        switch (event.type) {
+        case SDL_JOYAXISMOTION:
+            input |= (event.jaxis.which == instanceId);
+            break;
+        case SDL_JOYBALLMOTION:
+            input |= (event.jball.which == instanceId);
+            break;
+        case SDL_JOYHATMOTION:
+            input |= (event.jhat.which == instanceId);
+            break;
+        case SDL_JOYBUTTONDOWN:
+        case SDL_JOYBUTTONUP:
+            input |= (event.jbutton.which == instanceId);
+            break;
+        case SDL_CONTROLLERAXISMOTION:
+            input |= (event.caxis.which == instanceId);
+            break;
+        case SDL_CONTROLLERBUTTONDOWN:
+        case SDL_CONTROLLERBUTTONUP:
+            input |= (event.cbutton.which == instanceId);
+            break;
+        case SDL_CONTROLLERDEVICEADDED:
+        case SDL_CONTROLLERDEVICEREMOVED:
+        case SDL_JOYDEVICEADDED:
+        case SDL_JOYDEVICEREMOVED:
+            qCDebug(JoystickSDLLog) << "Joystick added or removed:" << event.jdevice.which;
+            devicesChanged = true;
+            break;
+        default:
+            break;
+        }
+
+        pending = SDL_PollEvent(&event);
+    }
+
+    if (devicesChanged) {
+        emit JoystickManager::instance()->updateAvailableJoysticksSignal();
+    }
+
+    return input;
+}
+
 void JoystickSDL::_loadGameControllerMappings()
 {
     QFile file(QStringLiteral(":/gamecontrollerdb.txt"));
@@ -44,6 +44,9 @@ class JoystickSDL : public Joystick
     int  _getAxis(int i) const final;
     bool _getHat(int hat, int i) const final;
 
+    /// Waits on the SDL event queue until an axis, hat or button event of this joystick arrives or the timeout expires
+    bool _waitForInput(std::chrono::microseconds timeout) final;
+
     static void _loadGameControllerMappings();
 
     bool _isGameController = false;
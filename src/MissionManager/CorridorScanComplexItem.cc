@@ -11,6 +11,7 @@
 #include "JsonHelper.h"
 #include "SettingsManager.h"
 #include "AppSettings.h"
+#include "PlanViewSettings.h"
 #include "PlanMasterController.h"
 #include "QGCApplication.h"
 #include "QGCLoggingCategory.h"
@@ -46,7 +47,7 @@ CorridorScanComplexItem::CorridorScanComplexItem(PlanMasterController* masterCon
     connect(&_corridorPolyline,     &QGCMapPolyline::traceModeChanged,              this, &CorridorScanComplexItem::_updateWizardMode);
 
     if (!kmlOrShpFile.isEmpty()) {
-        _corridorPolyline.loadKMLOrSHPFile(kmlOrShpFile);
+        _corridorPolyline.loadKMLOrSHPFile(kmlOrShpFile, SettingsManager::instance()->planViewSettings()->shapeSimplifyTolerance()->rawValue().toDouble());
         _corridorPolyline.setDirty(false);
     }
     setDirty(false);
@@ -34,6 +34,7 @@
 #include "QGCLoggingCategory.h"
 
 #include <QtCore/QJsonArray>
+#include <QtCore/QSet>
 #include <QtCore/QJsonDocument>
 
 #define UPDATE_TIMEOUT 5000 ///< How often we check for bounding box changes
@@ -334,7 +335,7 @@ VisualMissionItem* MissionController::_insertSimpleMissionItemWorker(QGeoCoordin
     }
 
     // We send the click coordinate through here to be able to set the planned home position from the user click location if needed
-    _recalcAllWithCoordinate(coordinate);
+    _recalcAllWithCoordinate(coordinate, _visualItems->indexOf(newItem));
 
     if (makeCurrentItem) {
         setCurrentPlanViewSeqNum(newItem->sequenceNumber(), true);
@@ -373,7 +374,7 @@ VisualMissionItem* MissionController::insertTakeoffItem(QGeoCoordinate /*coordin
         _visualItems->insert(visualItemIndex, _takeoffMissionItem);
     }
 
-    _recalcAll();
+    _recalcAllWithCoordinate(QGeoCoordinate(), _visualItems->indexOf(_takeoffMissionItem));
 
     if (makeCurrentItem) {
         setCurrentPlanViewSeqNum(_takeoffMissionItem->sequenceNumber(), true);
@@ -532,7 +533,7 @@ void MissionController::_insertComplexMissionItemWorker(const QGeoCoordinate& ma
     if(!complexItem->isSimpleItem()) {
         connect(complexItem, &ComplexMissionItem::boundingCubeChanged, this, &MissionController::_complexBoundingBoxChanged);
     }
-    _recalcAllWithCoordinate(mapCenterCoordinate);
+    _recalcAllWithCoordinate(mapCenterCoordinate, _visualItems->indexOf(complexItem));
 
     if (makeCurrentItem) {
         setCurrentPlanViewSeqNum(complexItem->sequenceNumber(), true);
@@ -584,7 +585,7 @@ void MissionController::removeVisualItem(int viIndex)
         }
     }
 
-    _recalcAll();
+    _recalcAllWithCoordinate(QGeoCoordinate(), viIndex);
 
     // Adjust current item
     int newVIIndex;
@@ -1195,11 +1196,14 @@ FlightPathSegment* MissionController::_createFlightPathSegmentWorker(VisualItemP
     connect(pair.second, &VisualMissionItem::coordinateChanged,     segment,    &FlightPathSegment::setCoordinate2);
     connect(pair.second, &VisualMissionItem::amslEntryAltChanged,   segment,    &FlightPathSegment::setCoord2AMSLAlt);
 
-    connect(pair.second, &VisualMissionItem::coordinateChanged,         this,       &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
+    connect(pair.second, &VisualMissionItem::coordinateChanged,         this,       &MissionController::_visualItemFlightStatusChanged,   Qt::UniqueConnection);
 
+    // Altitude changes at either end of the segment affect flight status from the segment end item onwards
+    VisualMissionItem* segmentEndItem = pair.second;
+    auto segmentAltChanged = [this, segmentEndItem]() { _invalidateMissionFlightStatus(_visualItems->indexOf(segmentEndItem)); };
     connect(segment,    &FlightPathSegment::totalDistanceChanged,       this,       &MissionController::recalcTerrainProfile,             Qt::QueuedConnection);
-    connect(segment,    &FlightPathSegment::coord1AMSLAltChanged,       this,       &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(segment,    &FlightPathSegment::coord2AMSLAltChanged,       this,       &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
+    connect(segment,    &FlightPathSegment::coord1AMSLAltChanged,       this,       segmentAltChanged);
+    connect(segment,    &FlightPathSegment::coord2AMSLAltChanged,       this,       segmentAltChanged);
     connect(segment,    &FlightPathSegment::amslTerrainHeightsChanged,  this,       &MissionController::recalcTerrainProfile,             Qt::QueuedConnection);
     connect(segment,    &FlightPathSegment::terrainCollisionChanged,    this,       &MissionController::recalcTerrainProfile,             Qt::QueuedConnection);
 
@@ -1218,11 +1222,75 @@ FlightPathSegment* MissionController::_addFlightPathSegment(FlightPathSegmentHas
         _flightPathSegmentHashTable[pair] = segment;
     }
 
-    _simpleFlightPathSegments.append(segment);
-
     return segment;
 }
 
+/// Returns the visual item index from which a recalc must restart. Cached loop state can only be used if the items
+/// in front of it are still the same objects in the same order.
+///     @param checkpoints  Cached loop state, indexed by visual item index
+///     @param dirtyIndex   Lowest visual item index known to have changed
+template<typename T>
+static int validRestartIndex(const QList<T>& checkpoints, QmlObjectListModel* visualItems, int dirtyIndex)
+{
+    const int restartIndex = qMax(0, qMin(dirtyIndex, qMin(static_cast<int>(checkpoints.count()) - 1, visualItems->count())));
+
+    for (int i=0; i<restartIndex; i++) {
+        if (checkpoints[i].item != visualItems->get(i)) {
+            return i;
+        }
+    }
+
+    return restartIndex;
+}
+
+/// Updates the model to match the new object list. Only the range which differs is removed/inserted such that views
+/// see row level changes instead of a model reset.
+static void updateSegmentModel(QmlObjectListModel& model, const QObjectList& newList)
+{
+    const QObjectList oldList = *model.objectList();
+    const int oldCount = oldList.count();
+    const int newCount = newList.count();
+
+    int prefixCount = 0;
+    while (prefixCount < oldCount && prefixCount < newCount && oldList[prefixCount] == newList[prefixCount]) {
+        prefixCount++;
+    }
+    int suffixCount = 0;
+    while (suffixCount < oldCount - prefixCount && suffixCount < newCount - prefixCount && oldList[oldCount - suffixCount - 1] == newList[newCount - suffixCount - 1]) {
+        suffixCount++;
+    }
+
+    for (int i=oldCount-suffixCount-1; i>=prefixCount; i--) {
+        model.removeAt(i);
+    }
+    if (newCount - suffixCount > prefixCount) {
+        model.insert(prefixCount, newList.mid(prefixCount, newCount - suffixCount - prefixCount));
+    }
+}
+
+void MissionController::_invalidateFlightPathSegments(int firstChangedIndex)
+{
+    _flightPathSegmentsDirtyIndex = qMin(_flightPathSegmentsDirtyIndex, qMax(firstChangedIndex, 0));
+    emit _recalcFlightPathSegmentsSignal();
+}
+
+void MissionController::_invalidateMissionFlightStatus(int firstChangedIndex)
+{
+    _flightStatusDirtyIndex = qMin(_flightStatusDirtyIndex, qMax(firstChangedIndex, 0));
+    emit _recalcMissionFlightStatusSignal();
+}
+
+void MissionController::_visualItemFlightPathChanged(void)
+{
+    // An item which is no longer in the list (-1) forces a full recalc
+    _invalidateFlightPathSegments(_visualItems->indexOf(sender()));
+}
+
+void MissionController::_visualItemFlightStatusChanged(void)
+{
+    _invalidateMissionFlightStatus(_visualItems->indexOf(sender()));
+}
+
 void MissionController::_recalcROISpecialVisuals(void)
 {
     return;
@@ -1256,55 +1324,112 @@ void MissionController::_recalcROISpecialVisuals(void)
     }
 }
 
+// Segments are only rebuilt from the first changed item onwards. The loop state prior to each item is cached in
+// _flightPathCheckpoints so the walk can pick up from there, and the segment models are updated with row level changes.
 void MissionController::_recalcFlightPathSegments(void)
 {
-    VisualItemPair      lastSegmentVisualItemPair;
-    int                 segmentCount =              0;
-    bool                firstCoordinateNotFound =   true;
-    VisualMissionItem*  lastFlyThroughVI =          qobject_cast<VisualMissionItem*>(_visualItems->get(0));
-    bool                linkEndToHome =             false;
-    bool                linkStartToHome =           _controllerVehicle->rover() ? true : false;
-    bool                foundRTL =                  false;
+    if (_delayedSplitSegmentUpdate) {
+        // The split segment is determined while walking the current item, so make sure it is included
+        _flightPathSegmentsDirtyIndex = qMin(_flightPathSegmentsDirtyIndex, qMax(_currentPlanViewVIIndex, 0));
+    }
+
+    int                 restartIndex =              validRestartIndex(_flightPathCheckpoints, _visualItems, _flightPathSegmentsDirtyIndex);
     bool                homePositionValid =         _settingsItem->coordinate().isValid();
-    bool                roiActive =                 false;
-    bool                previousItemIsIncomplete =  false;
+    bool                fullRecalc =                restartIndex <= 1;
+    bool                prevContainsVTOLTakeoff =   _missionContainsVTOLTakeoff;
     bool                signalSplitSegmentChanged = false;
+    FlightPathCheckpoint_t checkpoint;
+
+    _flightPathSegmentsDirtyIndex = _noDirtyIndex;
+
+    if (fullRecalc) {
+        restartIndex = 1;
+
+        checkpoint.item =                           _visualItems->value<VisualMissionItem*>(0);
+        checkpoint.lastFlyThroughVI =               checkpoint.item;
+        checkpoint.lastSegmentVisualItemPair =      VisualItemPair();
+        checkpoint.segmentCount =                   0;
+        checkpoint.simpleFlightPathSegmentCount =   0;
+        checkpoint.directionArrowCount =            0;
+        checkpoint.firstCoordinateNotFound =        true;
+        checkpoint.linkEndToHome =                  false;
+        checkpoint.linkStartToHome =                _controllerVehicle->rover() ? true : false;
+        checkpoint.roiActive =                      false;
+        checkpoint.previousItemIsIncomplete =       false;
+        checkpoint.missionContainsVTOLTakeoff =     false;
+
+        _flightPathCheckpoints.clear();
+        _flightPathCheckpoints.append(checkpoint);
+    } else {
+        checkpoint = _flightPathCheckpoints[restartIndex];
+        _flightPathCheckpoints.resize(restartIndex);
+    }
+
+    VisualItemPair      lastSegmentVisualItemPair = checkpoint.lastSegmentVisualItemPair;
+    int                 segmentCount =              checkpoint.segmentCount;
+    bool                firstCoordinateNotFound =   checkpoint.firstCoordinateNotFound;
+    VisualMissionItem*  lastFlyThroughVI =          checkpoint.lastFlyThroughVI;
+    bool                linkEndToHome =             checkpoint.linkEndToHome;
+    bool                linkStartToHome =           checkpoint.linkStartToHome;
+    bool                foundRTL =                  false;
+    bool                roiActive =                 checkpoint.roiActive;
+    bool                previousItemIsIncomplete =  checkpoint.previousItemIsIncomplete;
 
-    qCDebug(MissionControllerLog) << "_recalcFlightPathSegments homePositionValid" << homePositionValid;
+    qCDebug(MissionControllerLog) << "_recalcFlightPathSegments homePositionValid:restartIndex" << homePositionValid << restartIndex;
 
-    FlightPathSegmentHashTable oldSegmentTable = _flightPathSegmentHashTable;
+    _missionContainsVTOLTakeoff = checkpoint.missionContainsVTOLTakeoff;
 
-    _missionContainsVTOLTakeoff = false;
-    _flightPathSegmentHashTable.clear();
+    // Segments in front of the restart point are kept as is, everything after is rebuilt. Pairs which are rebuilt
+    // can re-use their existing segment from the old table.
+    QObjectList newSimpleFlightPathSegments =   _simpleFlightPathSegments.objectList()->mid(0, checkpoint.simpleFlightPathSegmentCount);
+    QObjectList newDirectionArrows =            _directionArrows.objectList()->mid(0, checkpoint.directionArrowCount);
+
+    FlightPathSegmentHashTable oldSegmentTable;
+    const QSet<QObject*> keptSegments(newSimpleFlightPathSegments.cbegin(), newSimpleFlightPathSegments.cend());
+    for (auto it = _flightPathSegmentHashTable.begin(); it != _flightPathSegmentHashTable.end(); ) {
+        if (keptSegments.contains(it.value())) {
+            ++it;
+        } else {
+            oldSegmentTable.insert(it.key(), it.value());
+            it = _flightPathSegmentHashTable.erase(it);
+        }
+    }
 
     // Note: Although visual support for _incompleteComplexItemLines is still in the codebase. The support for populating the list is not.
     // This is due to the initial implementation being buggy and incomplete with respect to correctly generating the line set.
     // So for now we leave the code for displaying them in, but none are ever added until we have time to implement the correct support.
+    if (_incompleteComplexItemLines.count()) {
+        _incompleteComplexItemLines.clearAndDeleteContents();
+    }
 
-    _simpleFlightPathSegments.beginResetModel();
-    _directionArrows.beginResetModel();
-    _incompleteComplexItemLines.beginResetModel();
-
-    _simpleFlightPathSegments.clear();
-    _directionArrows.clear();
-    _incompleteComplexItemLines.clearAndDeleteContents();
-
-    // Mission Settings item needs to start with no segment
+    // The item at the start of the last segment prior to the restart point is going to get a new segment
     lastFlyThroughVI->clearSimpleFlighPathSegment();
 
-    // We need to clear the simple flight path segments on all items since they are going to be rebuilt. We can't just do this in the main loop
+    // We need to clear the simple flight path segments on all items which are going to be rebuilt. We can't just do this in the main loop
     // below since that loop won't always process all items.
-    for (int i=1; i<_visualItems->count(); i++) {
+    for (int i=restartIndex; i<_visualItems->count(); i++) {
         qobject_cast<VisualMissionItem*>(_visualItems->get(i))->clearSimpleFlighPathSegment();
     }
 
     // Grovel through the list of items keeping track of things needed to correctly draw waypoints lines
-    for (int i=1; i<_visualItems->count(); i++) {
+    for (int i=restartIndex; i<_visualItems->count(); i++) {
         VisualMissionItem*  visualItem =    qobject_cast<VisualMissionItem*>(_visualItems->get(i));
         SimpleMissionItem*  simpleItem =    qobject_cast<SimpleMissionItem*>(visualItem);
         ComplexMissionItem* complexItem =   qobject_cast<ComplexMissionItem*>(visualItem);
 
-        visualItem->clearSimpleFlighPathSegment();
+        checkpoint.item =                           visualItem;
+        checkpoint.lastFlyThroughVI =               lastFlyThroughVI;
+        checkpoint.lastSegmentVisualItemPair =      lastSegmentVisualItemPair;
+        checkpoint.segmentCount =                   segmentCount;
+        checkpoint.simpleFlightPathSegmentCount =   newSimpleFlightPathSegments.count();
+        checkpoint.directionArrowCount =            newDirectionArrows.count();
+        checkpoint.firstCoordinateNotFound =        firstCoordinateNotFound;
+        checkpoint.linkEndToHome =                  linkEndToHome;
+        checkpoint.linkStartToHome =                linkStartToHome;
+        checkpoint.roiActive =                      roiActive;
+        checkpoint.previousItemIsIncomplete =       previousItemIsIncomplete;
+        checkpoint.missionContainsVTOLTakeoff =     _missionContainsVTOLTakeoff;
+        _flightPathCheckpoints.append(checkpoint);
 
         if (simpleItem) {
             if (roiActive) {
@@ -1383,8 +1508,9 @@ void MissionController::_recalcFlightPathSegments(void)
                     bool mavlinkTerrainFrame = simpleItem ? simpleItem->missionItem().frame() == MAV_FRAME_GLOBAL_TERRAIN_ALT : false;
                     FlightPathSegment* segment = _addFlightPathSegment(oldSegmentTable, lastSegmentVisualItemPair, mavlinkTerrainFrame);
                     segment->setSpecialVisual(roiActive);
+                    newSimpleFlightPathSegments.append(segment);
                     if (addDirectionArrow) {
-                        _directionArrows.append(segment);
+                        newDirectionArrows.append(segment);
                     }
                     if (visualItem->isCurrentItem() && _delayedSplitSegmentUpdate) {
                         _splitSegment = segment;
@@ -1403,6 +1529,7 @@ void MissionController::_recalcFlightPathSegments(void)
         lastSegmentVisualItemPair = VisualItemPair(lastFlyThroughVI, _settingsItem);
         FlightPathSegment* segment = _addFlightPathSegment(oldSegmentTable, lastSegmentVisualItemPair, false /* mavlinkTerrainFrame */);
         segment->setSpecialVisual(roiActive);
+        newSimpleFlightPathSegments.append(segment);
         lastFlyThroughVI->setSimpleFlighPathSegment(segment);
     }
 
@@ -1432,17 +1559,17 @@ void MissionController::_recalcFlightPathSegments(void)
             _flightPathSegmentHashTable[lastSegmentVisualItemPair] = coordVector;
         }
 
-        _directionArrows.append(coordVector);
+        newDirectionArrows.append(coordVector);
     }
 
-    _simpleFlightPathSegments.endResetModel();
-    _directionArrows.endResetModel();
-    _incompleteComplexItemLines.endResetModel();
+    updateSegmentModel(_simpleFlightPathSegments, newSimpleFlightPathSegments);
+    updateSegmentModel(_directionArrows, newDirectionArrows);
 
     // Anything left in the old table is an obsolete line object that can go
     qDeleteAll(oldSegmentTable);
 
-    emit _recalcMissionFlightStatusSignal();
+    // The starting vtol mode for flight status depends on whether the mission contains a vtol takeoff
+    _invalidateMissionFlightStatus(fullRecalc || prevContainsVTOLTakeoff != _missionContainsVTOLTakeoff ? 0 : restartIndex);
 
     emit recalcTerrainProfile();
     if (signalSplitSegmentChanged) {
@@ -1510,43 +1637,74 @@ void MissionController::_addTimeDistance(bool vtolInHover, double hoverTime, dou
     }
 }
 
+// Flight status is accumulated along the mission. The loop state prior to each item is cached in _flightStatusCheckpoints
+// so only the suffix starting at the first changed item needs to be walked again.
 void MissionController::_recalcMissionFlightStatus()
 {
     if (!_visualItems->count()) {
         return;
     }
 
-    bool                firstCoordinateItem =           true;
-    VisualMissionItem*  lastFlyThroughVI =   qobject_cast<VisualMissionItem*>(_visualItems->get(0));
+    const int   restartIndex =          validRestartIndex(_flightStatusCheckpoints, _visualItems, _flightStatusDirtyIndex);
+    const bool  homePositionValid =     _settingsItem->coordinate().isValid();
+    const double prevMinAMSLAltitude =  _minAMSLAltitude;
+    const double prevMaxAMSLAltitude =  _maxAMSLAltitude;
 
-    bool homePositionValid = _settingsItem->coordinate().isValid();
+    _flightStatusDirtyIndex = _noDirtyIndex;
 
-    qCDebug(MissionControllerLog) << "_recalcMissionFlightStatus";
+    qCDebug(MissionControllerLog) << "_recalcMissionFlightStatus restartIndex" << restartIndex;
 
     // If home position is valid we can calculate distances between all waypoints.
     // If home position is not valid we can only calculate distances between waypoints which are
     // both relative altitude.
 
-    // No values for first item
-    lastFlyThroughVI->setAltDifference(0);
-    lastFlyThroughVI->setAzimuth(0);
-    lastFlyThroughVI->setDistance(0);
-    lastFlyThroughVI->setDistanceFromStart(0);
+    bool                firstCoordinateItem;
+    VisualMissionItem*  lastFlyThroughVI;
+    bool                linkStartToHome;
+    bool                foundRTL;
+    bool                pastLandCommand;
+    double              totalHorizontalDistance;
+
+    if (restartIndex == 0) {
+        firstCoordinateItem =       true;
+        lastFlyThroughVI =          qobject_cast<VisualMissionItem*>(_visualItems->get(0));
+        linkStartToHome =           false;
+        foundRTL =                  false;
+        pastLandCommand =           false;
+        totalHorizontalDistance =   0;
+
+        // No values for first item
+        lastFlyThroughVI->setAltDifference(0);
+        lastFlyThroughVI->setAzimuth(0);
+        lastFlyThroughVI->setDistance(0);
+        lastFlyThroughVI->setDistanceFromStart(0);
+
+        _minAMSLAltitude = _maxAMSLAltitude = qQNaN();
 
-    _minAMSLAltitude = _maxAMSLAltitude = qQNaN();
-
-    _resetMissionFlightStatus();
+        _resetMissionFlightStatus();
+    } else {
+        const FlightStatusCheckpoint_t& checkpoint = _flightStatusCheckpoints[restartIndex];
 
-    bool   linkStartToHome =            false;
-    bool   foundRTL =                   false;
-    bool   pastLandCommand =            false;
-    double totalHorizontalDistance =    0;
+        firstCoordinateItem =       checkpoint.firstCoordinateItem;
+        lastFlyThroughVI =          checkpoint.lastFlyThroughVI;
+        linkStartToHome =           checkpoint.linkStartToHome;
+        foundRTL =                  checkpoint.foundRTL;
+        pastLandCommand =           checkpoint.pastLandCommand;
+        totalHorizontalDistance =   checkpoint.totalHorizontalDistance;
+        _minAMSLAltitude =          checkpoint.minAMSLAltitude;
+        _maxAMSLAltitude =          checkpoint.maxAMSLAltitude;
+        _missionFlightStatus =      checkpoint.missionFlightStatus;
+    }
+    _flightStatusCheckpoints.resize(restartIndex);
 
-    for (int i=0; i<_visualItems->count(); i++) {
+    for (int i=restartIndex; i<_visualItems->count(); i++) {
         VisualMissionItem*  item =          qobject_cast<VisualMissionItem*>(_visualItems->get(i));
         SimpleMissionItem*  simpleItem =    qobject_cast<SimpleMissionItem*>(item);
         ComplexMissionItem* complexItem =   qobject_cast<ComplexMissionItem*>(item);
 
+        _flightStatusCheckpoints.append(FlightStatusCheckpoint_t{ item, lastFlyThroughVI, _missionFlightStatus, totalHorizontalDistance, _minAMSLAltitude, _maxAMSLAltitude,
+                                                                  firstCoordinateItem, linkStartToHome, foundRTL, pastLandCommand });
+
         if (simpleItem && simpleItem->mavCommand() == MAV_CMD_NAV_RETURN_TO_LAUNCH) {
             foundRTL = true;
         }
@@ -1734,6 +1892,11 @@ void MissionController::_recalcMissionFlightStatus()
             pastLandCommand = true;
         }
     }
+
+    // State after the last item, used to redo only the final calculations below when nothing in the list changed
+    _flightStatusCheckpoints.append(FlightStatusCheckpoint_t{ nullptr, lastFlyThroughVI, _missionFlightStatus, totalHorizontalDistance, _minAMSLAltitude, _maxAMSLAltitude,
+                                                              firstCoordinateItem, linkStartToHome, foundRTL, pastLandCommand });
+
     lastFlyThroughVI->setMissionVehicleYaw(_missionFlightStatus.vehicleYaw);
 
     // Add the information for the final segment back to home
@@ -1775,9 +1938,17 @@ void MissionController::_recalcMissionFlightStatus()
     emit minAMSLAltitudeChanged         (_minAMSLAltitude);
     emit maxAMSLAltitudeChanged         (_maxAMSLAltitude);
 
-    // Walk the list again calculating altitude percentages
+    // Walk the list again calculating altitude percentages. These are relative to the mission wide min/max, so items
+    // prior to the restart point only need updating if the range moved.
+    auto altitudeChanged = [](double oldAlt, double newAlt) {
+        return qIsNaN(oldAlt) != qIsNaN(newAlt) || (!qIsNaN(oldAlt) && oldAlt != newAlt);
+    };
+    int altPercentStartIndex = restartIndex;
+    if (altitudeChanged(prevMinAMSLAltitude, _minAMSLAltitude) || altitudeChanged(prevMaxAMSLAltitude, _maxAMSLAltitude)) {
+        altPercentStartIndex = 0;
+    }
     double altRange = _maxAMSLAltitude - _minAMSLAltitude;
-    for (int i=0; i<_visualItems->count(); i++) {
+    for (int i=altPercentStartIndex; i<_visualItems->count(); i++) {
         VisualMissionItem* item = qobject_cast<VisualMissionItem*>(_visualItems->get(i));
 
         if (item->specifiesCoordinate()) {
@@ -1884,14 +2055,15 @@ void MissionController::_setPlannedHomePositionFromFirstCoordinate(const QGeoCoo
     }
 }
 
-void MissionController::_recalcAllWithCoordinate(const QGeoCoordinate& coordinate)
+/// @param firstChangedIndex Lowest visual item index affected by the change, 0 to recalc everything
+void MissionController::_recalcAllWithCoordinate(const QGeoCoordinate& coordinate, int firstChangedIndex)
 {
     if (!_flyView) {
         _setPlannedHomePositionFromFirstCoordinate(coordinate);
     }
     _recalcSequence();
     _recalcChildItems();
-    emit _recalcFlightPathSegmentsSignal();
+    _invalidateFlightPathSegments(firstChangedIndex);
     _updateTimer.start(UPDATE_TIMEOUT);
 }
 
@@ -1960,32 +2132,32 @@ void MissionController::_initVisualItem(VisualMissionItem* visualItem)
 {
     setDirty(false);
 
-    connect(visualItem, &VisualMissionItem::specifiesCoordinateChanged,                 this, &MissionController::_recalcFlightPathSegmentsSignal,  Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::specifiedFlightSpeedChanged,                this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::specifiedGimbalYawChanged,                  this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::specifiedGimbalPitchChanged,                this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::specifiedVehicleYawChanged,                 this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::terrainAltitudeChanged,                     this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::additionalTimeDelayChanged,                 this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(visualItem, &VisualMissionItem::currentVTOLModeChanged,                     this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
+    connect(visualItem, &VisualMissionItem::specifiesCoordinateChanged,                 this, &MissionController::_visualItemFlightPathChanged);
+    connect(visualItem, &VisualMissionItem::specifiedFlightSpeedChanged,                this, &MissionController::_visualItemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::specifiedGimbalYawChanged,                  this, &MissionController::_visualItemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::specifiedGimbalPitchChanged,                this, &MissionController::_visualItemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::specifiedVehicleYawChanged,                 this, &MissionController::_visualItemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::terrainAltitudeChanged,                     this, &MissionController::_visualItemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::additionalTimeDelayChanged,                 this, &MissionController::_visualItemFlightStatusChanged);
+    connect(visualItem, &VisualMissionItem::currentVTOLModeChanged,                     this, &MissionController::_visualItemFlightStatusChanged);
     connect(visualItem, &VisualMissionItem::lastSequenceNumberChanged,                  this, &MissionController::_recalcSequence);
 
     if (visualItem->isSimpleItem()) {
         // We need to track commandChanged on simple item since recalc has special handling for takeoff command
         SimpleMissionItem* simpleItem = qobject_cast<SimpleMissionItem*>(visualItem);
         if (simpleItem) {
-            connect(&simpleItem->missionItem()._commandFact, &Fact::valueChanged, this, &MissionController::_itemCommandChanged);
+            connect(&simpleItem->missionItem()._commandFact, &Fact::valueChanged, this, [this, simpleItem]() { _itemCommandChanged(simpleItem); });
         } else {
             qWarning() << "isSimpleItem == true, yet not SimpleMissionItem";
         }
     } else {
         ComplexMissionItem* complexItem = qobject_cast<ComplexMissionItem*>(visualItem);
         if (complexItem) {
-            connect(complexItem, &ComplexMissionItem::complexDistanceChanged,       this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-            connect(complexItem, &ComplexMissionItem::greatestDistanceToChanged,    this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-            connect(complexItem, &ComplexMissionItem::minAMSLAltitudeChanged,       this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-            connect(complexItem, &ComplexMissionItem::maxAMSLAltitudeChanged,       this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-            connect(complexItem, &ComplexMissionItem::isIncompleteChanged,          this, &MissionController::_recalcFlightPathSegmentsSignal,  Qt::QueuedConnection);
+            connect(complexItem, &ComplexMissionItem::complexDistanceChanged,       this, &MissionController::_visualItemFlightStatusChanged);
+            connect(complexItem, &ComplexMissionItem::greatestDistanceToChanged,    this, &MissionController::_visualItemFlightStatusChanged);
+            connect(complexItem, &ComplexMissionItem::minAMSLAltitudeChanged,       this, &MissionController::_visualItemFlightStatusChanged);
+            connect(complexItem, &ComplexMissionItem::maxAMSLAltitudeChanged,       this, &MissionController::_visualItemFlightStatusChanged);
+            connect(complexItem, &ComplexMissionItem::isIncompleteChanged,          this, &MissionController::_visualItemFlightPathChanged);
         } else {
             qWarning() << "ComplexMissionItem not found";
         }
@@ -1998,10 +2170,10 @@ void MissionController::_deinitVisualItem(VisualMissionItem* visualItem)
     disconnect(visualItem, nullptr, nullptr, nullptr);
 }
 
-void MissionController::_itemCommandChanged(void)
+void MissionController::_itemCommandChanged(VisualMissionItem* visualItem)
 {
     _recalcChildItems();
-    emit _recalcFlightPathSegmentsSignal();
+    _invalidateFlightPathSegments(_visualItems->indexOf(visualItem));
 }
 
 void MissionController::_managerVehicleChanged(Vehicle* managerVehicle)
@@ -2029,8 +2201,8 @@ void MissionController::_managerVehicleChanged(Vehicle* managerVehicle)
     connect(_missionManager, &MissionManager::lastCurrentIndexChanged,  this, &MissionController::resumeMissionIndexChanged);
     connect(_missionManager, &MissionManager::resumeMissionReady,       this, &MissionController::resumeMissionReady);
     connect(_missionManager, &MissionManager::resumeMissionUploadFail,  this, &MissionController::resumeMissionUploadFail);
-    connect(_managerVehicle, &Vehicle::defaultCruiseSpeedChanged,       this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
-    connect(_managerVehicle, &Vehicle::defaultHoverSpeedChanged,        this, &MissionController::_recalcMissionFlightStatusSignal, Qt::QueuedConnection);
+    connect(_managerVehicle, &Vehicle::defaultCruiseSpeedChanged,       this, [this]() { _invalidateMissionFlightStatus(0); });
+    connect(_managerVehicle, &Vehicle::defaultHoverSpeedChanged,        this, [this]() { _invalidateMissionFlightStatus(0); });
     connect(_managerVehicle, &Vehicle::vehicleTypeChanged,              this, &MissionController::complexMissionItemNamesChanged);
 
     emit complexMissionItemNamesChanged();
@@ -11,9 +11,12 @@
 
 #include <QtCore/QHash>
 #include <QtCore/QFile>
+#include <QtCore/QList>
 #include <QtCore/QLoggingCategory>
 #include <QtQmlIntegration/QtQmlIntegration>
 
+#include <limits>
+
 #include "PlanElementController.h"
 #include "QmlObjectListModel.h"
 #include "QGCGeoBoundingCube.h"
@@ -316,7 +319,8 @@ class MissionController : public PlanElementController
 
 private slots:
     void _newMissionItemsAvailableFromVehicle   (bool removeAllRequested);
-    void _itemCommandChanged                    (void);
+    void _visualItemFlightPathChanged           (void);
+    void _visualItemFlightStatusChanged         (void);
     void _inProgressChanged                     (bool inProgress);
     void _currentMissionIndexChanged            (int sequenceNumber);
     void _recalcFlightPathSegments              (void);
@@ -336,7 +340,7 @@ private slots:
     void                    _init                               (void);
     void                    _recalcSequence                     (void);
     void                    _recalcChildItems                   (void);
-    void                    _recalcAllWithCoordinate            (const QGeoCoordinate& coordinate);
+    void                    _recalcAllWithCoordinate            (const QGeoCoordinate& coordinate, int firstChangedIndex = 0);
     void                    _recalcROISpecialVisuals            (void);
     void                    _initAllVisualItems                 (void);
     void                    _deinitAllVisualItems               (void);
@@ -367,6 +371,9 @@ private slots:
     bool                    _isROIBeginItem                     (SimpleMissionItem* simpleItem);
     bool                    _isROICancelItem                    (SimpleMissionItem* simpleItem);
     FlightPathSegment*      _createFlightPathSegmentWorker      (VisualItemPair& pair, bool mavlinkTerrainFrame);
+    void                    _itemCommandChanged                 (VisualMissionItem* visualItem);
+    void                    _invalidateFlightPathSegments       (int firstChangedIndex);
+    void                    _invalidateMissionFlightStatus      (int firstChangedIndex);
     void                    _allItemsRemoved                    (void);
     void                    _firstItemAdded                     (void);
 
@@ -376,6 +383,36 @@ private slots:
     static bool             _convertToMissionItems              (QmlObjectListModel* visualMissionItems, QList<MissionItem*>& rgMissionItems, QObject* missionItemParent);
 
 private:
+    /// Loop state of _recalcFlightPathSegments prior to processing the visual item at the same index
+    typedef struct {
+        VisualMissionItem*  item;
+        VisualMissionItem*  lastFlyThroughVI;
+        VisualItemPair      lastSegmentVisualItemPair;
+        int                 segmentCount;
+        int                 simpleFlightPathSegmentCount;   ///< Number of entries in _simpleFlightPathSegments which precede this item
+        int                 directionArrowCount;            ///< Number of entries in _directionArrows which precede this item
+        bool                firstCoordinateNotFound;
+        bool                linkEndToHome;
+        bool                linkStartToHome;
+        bool                roiActive;
+        bool                previousItemIsIncomplete;
+        bool                missionContainsVTOLTakeoff;
+    } FlightPathCheckpoint_t;
+
+    /// Loop state of _recalcMissionFlightStatus prior to processing the visual item at the same index
+    typedef struct {
+        VisualMissionItem*      item;
+        VisualMissionItem*      lastFlyThroughVI;
+        MissionFlightStatus_t   missionFlightStatus;
+        double                  totalHorizontalDistance;
+        double                  minAMSLAltitude;
+        double                  maxAMSLAltitude;
+        bool                    firstCoordinateItem;
+        bool                    linkStartToHome;
+        bool                    foundRTL;
+        bool                    pastLandCommand;
+    } FlightStatusCheckpoint_t;
+
     Vehicle*                    _controllerVehicle =            nullptr;
     Vehicle*                    _managerVehicle =               nullptr;
     MissionManager*             _missionManager =               nullptr;
@@ -387,6 +424,10 @@ private slots:
     QmlObjectListModel          _directionArrows;
     QmlObjectListModel          _incompleteComplexItemLines;
     FlightPathSegmentHashTable  _flightPathSegmentHashTable;
+    QList<FlightPathCheckpoint_t>   _flightPathCheckpoints;
+    QList<FlightStatusCheckpoint_t> _flightStatusCheckpoints;
+    int                         _flightPathSegmentsDirtyIndex = 0;     ///< Lowest visual item index which requires a flight path segment recalc
+    int                         _flightStatusDirtyIndex =       0;     ///< Lowest visual item index which requires a mission flight status recalc
     bool                        _firstItemsFromVehicle =        false;
     bool                        _itemsRequested =               false;
     bool                        _inRecalcSequence =             false;
@@ -432,4 +473,5 @@ private slots:
     static constexpr const char* _jsonMavAutopilotKey =           "MAV_AUTOPILOT";
 
     static constexpr int   _missionFileVersion =            2;
+    static constexpr int   _noDirtyIndex =                  std::numeric_limits<int>::max();
 };
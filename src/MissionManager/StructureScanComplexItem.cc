@@ -13,6 +13,7 @@
 #include "QGCApplication.h"
 #include "SettingsManager.h"
 #include "AppSettings.h"
+#include "PlanViewSettings.h"
 #include "PlanMasterController.h"
 #include "FlightPathSegment.h"
 #include "QGC.h"
@@ -109,7 +110,7 @@ StructureScanComplexItem::StructureScanComplexItem(PlanMasterController* masterC
     _recalcLayerInfo();
 
     if (!kmlOrShpFile.isEmpty()) {
-        _structurePolygon.loadKMLOrSHPFile(kmlOrShpFile);
+        _structurePolygon.loadKMLOrSHPFile(kmlOrShpFile, SettingsManager::instance()->planViewSettings()->shapeSimplifyTolerance()->rawValue().toDouble());
         _structurePolygon.setDirty(false);
     }
 
@@ -14,15 +14,21 @@
 #include "QGCQGeoCoordinate.h"
 #include "SettingsManager.h"
 #include "AppSettings.h"
+#include "PlanViewSettings.h"
 #include "PlanMasterController.h"
 #include "MissionItem.h"
 #include "QGCApplication.h"
 #include "Vehicle.h"
 #include "QGCLoggingCategory.h"
+#include "TransectRouteOptimizer.h"
+#include "QGC.h"
 
 #include <QtGui/QPolygonF>
 #include <QtCore/QJsonArray>
 #include <QtCore/QLineF>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
 
 QGC_LOGGING_CATEGORY(SurveyComplexItemLog, "SurveyComplexItemLog")
 
@@ -58,16 +64,26 @@ SurveyComplexItem::SurveyComplexItem(PlanMasterController* masterController, boo
     connect(&_splitConcavePolygonsFact, &Fact::valueChanged,                        this, &SurveyComplexItem::_rebuildTransects);
     connect(this,                       &SurveyComplexItem::refly90DegreesChanged,  this, &SurveyComplexItem::_rebuildTransects);
 
+    connect(&_transectsJobWatcher,      &QFutureWatcher<TransectJobResult_t>::finished, this, &SurveyComplexItem::_transectsJobFinished);
+
+    // routeTimeSaved is derived from the vehicle speed, a speed change is only announced through timeBetweenShotsChanged
+    connect(this,                       &SurveyComplexItem::timeBetweenShotsChanged, this, &SurveyComplexItem::routeTimeSavedChanged);
+
     connect(&_surveyAreaPolygon,        &QGCMapPolygon::isValidChanged,             this, &SurveyComplexItem::_updateWizardMode);
     connect(&_surveyAreaPolygon,        &QGCMapPolygon::traceModeChanged,           this, &SurveyComplexItem::_updateWizardMode);
 
     if (!kmlOrShpFile.isEmpty()) {
-        _surveyAreaPolygon.loadKMLOrSHPFile(kmlOrShpFile);
+        _surveyAreaPolygon.loadKMLOrSHPFile(kmlOrShpFile, SettingsManager::instance()->planViewSettings()->shapeSimplifyTolerance()->rawValue().toDouble());
         _surveyAreaPolygon.setDirty(false);
     }
     setDirty(false);
 }
 
+SurveyComplexItem::~SurveyComplexItem()
+{
+    _cancelTransectsJob();
+}
+
 void SurveyComplexItem::save(QJsonArray&  planItems)
 {
     QJsonObject saveObject;
@@ -426,7 +442,7 @@ bool SurveyComplexItem::_gridAngleIsNorthSouthTransects()
     return gridAngle < 45.0 || (gridAngle > 360.0 - 45.0) || (gridAngle > 90.0 + 45.0 && gridAngle < 270.0 - 45.0);
 }
 
-void SurveyComplexItem::_adjustTransectsToEntryPointLocation(QList<QList<QGeoCoordinate>>& transects)
+void SurveyComplexItem::_adjustTransectsToEntryPointLocation(int entryPoint, QList<QList<QGeoCoordinate>>& transects)
 {
     if (transects.count() == 0) {
         return;
@@ -435,10 +451,10 @@ void SurveyComplexItem::_adjustTransectsToEntryPointLocation(QList<QList<QGeoCoo
     bool reversePoints = false;
     bool reverseTransects = false;
 
-    if (_entryPoint == EntryLocationBottomLeft || _entryPoint == EntryLocationBottomRight) {
+    if (entryPoint == EntryLocationBottomLeft || entryPoint == EntryLocationBottomRight) {
         reversePoints = true;
     }
-    if (_entryPoint == EntryLocationTopRight || _entryPoint == EntryLocationBottomRight) {
+    if (entryPoint == EntryLocationTopRight || entryPoint == EntryLocationBottomRight) {
         reverseTransects = true;
     }
 
@@ -451,7 +467,7 @@ void SurveyComplexItem::_adjustTransectsToEntryPointLocation(QList<QList<QGeoCoo
         _reverseTransectOrder(transects);
     }
 
-    qCDebug(SurveyComplexItemLog) << "_adjustTransectsToEntryPointLocation Modified entry point:entryLocation" << transects.first().first() << _entryPoint;
+    qCDebug(SurveyComplexItemLog) << "_adjustTransectsToEntryPointLocation Modified entry point:entryLocation" << transects.first().first() << entryPoint;
 }
 
 QPointF SurveyComplexItem::_rotatePoint(const QPointF& point, const QPointF& origin, double angle)
@@ -573,6 +589,52 @@ void SurveyComplexItem::_intersectLinesWithPolygon(const QList<QLineF>& lineList
 }
 
 /// Adjust the line segments such that they are all going the same direction with respect to going from P1->P2
+/// Splits each line into the pieces which lie inside the polygon. A line crossing a concave part of the polygon
+/// gives a piece on either side of the gap instead of one transect flying over it.
+///     @return Number of lines which cross the polygon
+int SurveyComplexItem::_splitLinesWithPolygon(const QList<QLineF>& lineList, const QPolygonF& polygon, QList<QLineF>& resultLines)
+{
+    resultLines.clear();
+
+    int crossedLines = 0;
+    for (const QLineF& line : lineList) {
+        QList<QPointF> intersections;
+
+        for (int j=0; j<polygon.count()-1; j++) {
+            QPointF intersectPoint;
+            QLineF polygonLine = QLineF(polygon[j], polygon[j+1]);
+
+            if (line.intersects(polygonLine, &intersectPoint) == QLineF::BoundedIntersection) {
+                if (!intersections.contains(intersectPoint)) {
+                    intersections.append(intersectPoint);
+                }
+            }
+        }
+
+        if (intersections.count() < 2) {
+            continue;
+        }
+        crossedLines++;
+
+        // Ordered along the line the crossings alternate between entering and leaving the polygon
+        std::sort(intersections.begin(), intersections.end(), [&line](const QPointF& a, const QPointF& b) {
+            return QLineF(line.p1(), a).length() < QLineF(line.p1(), b).length();
+        });
+
+        if (intersections.count() & 1) {
+            // The line touches a vertex, so the crossings can't be paired up. Fly over the whole polygon as before.
+            resultLines += QLineF(intersections.first(), intersections.last());
+            continue;
+        }
+
+        for (int i=0; i<intersections.count(); i+=2) {
+            resultLines += QLineF(intersections[i], intersections[i+1]);
+        }
+    }
+
+    return crossedLines;
+}
+
 void SurveyComplexItem::_adjustLineDirection(const QList<QLineF>& lineList, QList<QLineF>& resultLines)
 {
     qreal firstAngle = 0;
@@ -627,59 +689,224 @@ double SurveyComplexItem::_turnaroundDistance(void) const
     return _turnAroundDistanceFact.rawValue().toDouble();
 }
 
+void SurveyComplexItem::_clearLoadedMissionItems(void)
+{
+    // If the transects are getting rebuilt then any previously loaded mission items are now invalid
+    if (_loadedMissionItemsParent) {
+        _loadedMissionItems.clear();
+        _loadedMissionItemsParent->deleteLater();
+        _loadedMissionItemsParent = nullptr;
+    }
+}
+
+SurveyComplexItem::TransectJob_t SurveyComplexItem::_transectJobSnapshot(void)
+{
+    TransectJob_t job;
+
+    job.polygon                 = _surveyAreaPolygon.coordinateList();
+    job.gridAngle               = _gridAngleFact.rawValue().toDouble();
+    job.gridSpacing             = _cameraCalc.adjustedFootprintSide()->rawValue().toDouble();
+    job.entryPoint              = _entryPoint;
+    job.refly90Degrees          = _refly90DegreesFact.rawValue().toBool();
+    job.flyAlternateTransects   = _flyAlternateTransectsFact.rawValue().toBool();
+    job.splitConcavePolygons    = _splitConcavePolygonsFact.rawValue().toBool();
+    job.hoverAndCapture         = triggerCamera() && hoverAndCaptureEnabled();
+    job.triggerDistance         = triggerDistance();
+    job.turnaroundDistance      = _turnAroundDistanceFact.rawValue().toDouble();
+    job.routeOptimizationEvaluations = _syncRouteOptimizationEvaluations;
+
+    if (job.gridSpacing < 0.5) {
+        // We can't let gridSpacing get too small otherwise we will end up with too many transects.
+        // So we limit to 0.5 meter spacing as min and set to huge value which will cause a single
+        // transect to be added.
+        job.gridSpacing = 100000;
+    }
+
+    return job;
+}
+
+/// Rough estimate of the line/edge intersection work needed to generate the transects for a job
+double SurveyComplexItem::_transectJobCost(const TransectJob_t& job)
+{
+    if (job.polygon.count() < 3) {
+        return 0;
+    }
+
+    double maxRadius = 0;
+    for (const QGeoCoordinate& vertex: job.polygon) {
+        maxRadius = qMax(maxRadius, job.polygon.first().distanceTo(vertex));
+    }
+
+    double lineCount = ((maxRadius * 2.0) + 2000.0) / job.gridSpacing;
+    return lineCount * job.polygon.count() * (job.refly90Degrees ? 2 : 1);
+}
+
 void SurveyComplexItem::_rebuildTransectsPhase1(void)
 {
-    _rebuildTransectsPhase1WorkerSinglePolygon(false /* refly */);
-    if (_refly90DegreesFact.rawValue().toBool()) {
-        _rebuildTransectsPhase1WorkerSinglePolygon(true /* refly */);
+    _clearLoadedMissionItems();
+
+    TransectJobResult_t result = _buildTransects(_transectJobSnapshot(), nullptr);
+    _transects = result.transects;
+    _setRouteDistanceSaved(result.routeDistanceSaved);
+}
+
+void SurveyComplexItem::_setRouteDistanceSaved(double routeDistanceSaved)
+{
+    if (!QGC::fuzzyCompare(routeDistanceSaved, _routeDistanceSaved)) {
+        _routeDistanceSaved = routeDistanceSaved;
+        emit routeTimeSavedChanged();
     }
 }
 
-void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
+bool SurveyComplexItem::_rebuildTransectsPhase1Async(void)
 {
-    if (_ignoreRecalc) {
+    // Whatever is in flight was generated from stale geometry
+    _cancelTransectsJob();
+
+    TransectJob_t job = _transectJobSnapshot();
+    double cost = _transectJobCost(job);
+    if (cost < _asyncTransectJobCostThreshold) {
+        return false;
+    }
+
+    qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1Async starting background job - cost" << cost;
+
+    // Off the GUI thread the route optimizer can be given a larger budget
+    job.routeOptimizationEvaluations = _asyncRouteOptimizationEvaluations;
+
+    _clearLoadedMissionItems();
+    _transectsJobPending = true;
+    _transectsJobWatcher.setFuture(QtConcurrent::run([job](QPromise<TransectJobResult_t>& promise) {
+        TransectJobResult_t result = _buildTransects(job, &promise);
+        if (!promise.isCanceled()) {
+            promise.addResult(result);
+        }
+    }));
+
+    return true;
+}
+
+void SurveyComplexItem::_cancelTransectsJob(void)
+{
+    if (_transectsJobPending) {
+        _transectsJobPending = false;
+        _transectsJobWatcher.cancel();
+    }
+}
+
+void SurveyComplexItem::_waitForTransectsJob(void)
+{
+    if (_transectsJobPending) {
+        _transectsJobWatcher.waitForFinished();
+        _transectsJobFinished();
+    }
+}
+
+void SurveyComplexItem::_transectsJobFinished(void)
+{
+    // The watcher's own state only updates once its finished event is delivered, which hasn't happened yet when
+    // called from _waitForTransectsJob, so check the future itself.
+    // A finished signal from a job which has since been replaced or cancelled is ignored.
+    const QFuture<TransectJobResult_t> future = _transectsJobWatcher.future();
+    if (!_transectsJobPending || !future.isFinished() || future.isCanceled() || future.resultCount() == 0) {
         return;
     }
 
-    // If the transects are getting rebuilt then any previously loaded mission items are now invalid
-    if (_loadedMissionItemsParent) {
-        _loadedMissionItems.clear();
-        _loadedMissionItemsParent->deleteLater();
-        _loadedMissionItemsParent = nullptr;
+    _transectsJobPending = false;
+
+    TransectJobResult_t result = future.result();
+    _setRouteDistanceSaved(result.routeDistanceSaved);
+    _publishTransects(result.transects);
+}
+
+/// Generates the full set of transects for the job. Safe to call from any thread since it only touches the snapshot.
+///     @param promise Used to check for cancellation when running as a background job, nullptr otherwise
+SurveyComplexItem::TransectJobResult_t SurveyComplexItem::_buildTransects(const TransectJob_t& job, const QPromise<TransectJobResult_t>* promise)
+{
+    TransectJobResult_t result;
+
+    result.routeDistanceSaved = 0;
+    _buildTransectsSinglePolygon(job, false /* refly */, result, promise);
+    if (job.refly90Degrees) {
+        _buildTransectsSinglePolygon(job, true /* refly */, result, promise);
     }
 
-    if (_surveyAreaPolygon.count() < 3) {
+    return result;
+}
+
+/// Reorders/flips the transects to cut down transit distance between them. The first transect is left alone
+/// since it was placed by the entry point selection.
+void SurveyComplexItem::_optimizeTransectRoute(const TransectJob_t& job, QList<QList<QGeoCoordinate>>& transects, double& routeDistanceSaved, const QPromise<TransectJobResult_t>* promise)
+{
+    QList<QLineF>   nedTransects;
+    QGeoCoordinate  tangentOrigin = transects.first().first();
+
+    for (const QList<QGeoCoordinate>& transect: transects) {
+        double y, x, down;
+        QPointF entry, exit;
+
+        QGCGeo::convertGeoToNed(transect.first(), tangentOrigin, y, x, down);
+        entry = QPointF(x, y);
+        QGCGeo::convertGeoToNed(transect.last(), tangentOrigin, y, x, down);
+        exit = QPointF(x, y);
+        nedTransects.append(QLineF(entry, exit));
+    }
+
+    TransectRouteOptimizer::Result_t route = TransectRouteOptimizer::optimize(nedTransects, true /* fixFirst */, job.routeOptimizationEvaluations, [promise]() {
+        return promise && promise->isCanceled();
+    });
+    if (route.optimizedTransit >= route.initialTransit) {
+        return;
+    }
+
+    QList<QList<QGeoCoordinate>> optimizedTransects;
+    for (int i=0; i<route.order.count(); i++) {
+        QList<QGeoCoordinate> transect = transects[route.order[i]];
+        if (route.reversed[i]) {
+            std::reverse(transect.begin(), transect.end());
+        }
+        optimizedTransects.append(transect);
+    }
+    transects = optimizedTransects;
+    routeDistanceSaved += route.initialTransit - route.optimizedTransit;
+
+    qCDebug(SurveyComplexItemLog) << "_optimizeTransectRoute transit before:after:evaluations" << route.initialTransit << route.optimizedTransit << route.evaluations;
+}
+
+void SurveyComplexItem::_buildTransectsSinglePolygon(const TransectJob_t& job, bool refly, TransectJobResult_t& result, const QPromise<TransectJobResult_t>* promise)
+{
+    TransectList_t& coordInfoTransects = result.transects;
+
+    auto canceled = [promise]() {
+        return promise && promise->isCanceled();
+    };
+
+    if (job.polygon.count() < 3 || canceled()) {
         return;
     }
 
     // Convert polygon to NED
 
     QList<QPointF> polygonPoints;
-    QGeoCoordinate tangentOrigin = _surveyAreaPolygon.pathModel().value<QGCQGeoCoordinate*>(0)->coordinate();
-    qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 Convert polygon to NED - _surveyAreaPolygon.count():tangentOrigin" << _surveyAreaPolygon.count() << tangentOrigin;
-    for (int i=0; i<_surveyAreaPolygon.count(); i++) {
-        double y, x, down;
-        QGeoCoordinate vertex = _surveyAreaPolygon.pathModel().value<QGCQGeoCoordinate*>(i)->coordinate();
-        if (i == 0) {
-            // This avoids a nan calculation that comes out of convertGeoToNed
-            x = y = 0;
-        } else {
-            QGCGeo::convertGeoToNed(vertex, tangentOrigin, y, x, down);
+    QGeoCoordinate tangentOrigin = job.polygon[0];
+    qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 Convert polygon to NED - polygon.count():tangentOrigin" << job.polygon.count() << tangentOrigin;
+    {
+        const QGCGeo::CoordinateArrays  vertices(job.polygon);
+        std::vector<double>             north(vertices.size());
+        std::vector<double>             east(vertices.size());
+        std::vector<double>             down(vertices.size());
+
+        QGCGeo::convertGeoToNed(vertices.latitudes, vertices.longitudes, vertices.altitudes, tangentOrigin, north, east, down);
+        for (size_t i=0; i<vertices.size(); i++) {
+            polygonPoints += QPointF(east[i], north[i]);
+            qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 vertex:x:y" << job.polygon[i] << polygonPoints.last().x() << polygonPoints.last().y();
         }
-        polygonPoints += QPointF(x, y);
-        qCDebug(SurveyComplexItemLog) << "_rebuildTransectsPhase1 vertex:x:y" << vertex << polygonPoints.last().x() << polygonPoints.last().y();
     }
 
     // Generate transects
 
-    double gridAngle = _gridAngleFact.rawValue().toDouble();
-    double gridSpacing = _cameraCalc.adjustedFootprintSide()->rawValue().toDouble();
-    if (gridSpacing < 0.5) {
-        // We can't let gridSpacing get too small otherwise we will end up with too many transects.
-        // So we limit to 0.5 meter spacing as min and set to huge value which will cause a single
-        // transect to be added.
-        gridSpacing = 100000;
-    }
+    double gridAngle = job.gridAngle;
+    double gridSpacing = job.gridSpacing;
 
     gridAngle = _clampGridAngle90(gridAngle);
     gridAngle += refly ? 90 : 0;
@@ -722,18 +949,28 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
 
     // Now intersect the lines with the polygon
     QList<QLineF> intersectLines;
+    int scanLineCount;
 #if 1
-    _intersectLinesWithPolygon(lineList, polygon, intersectLines);
+    if (job.splitConcavePolygons) {
+        scanLineCount = _splitLinesWithPolygon(lineList, polygon, intersectLines);
+    } else {
+        _intersectLinesWithPolygon(lineList, polygon, intersectLines);
+        scanLineCount = intersectLines.count();
+    }
 #else
     // This is handy for debugging grid problems, not for release
     intersectLines = lineList;
+    scanLineCount = intersectLines.count();
 #endif
 
+    if (canceled()) {
+        return;
+    }
+
     // Less than two transects intersected with the polygon:
     //      Create a single transect which goes through the center of the polygon
     //      Intersect it with the polygon
     if (intersectLines.count() < 2) {
-        _surveyAreaPolygon.center();
         QLineF firstLine = lineList.first();
         QPointF lineCenter = firstLine.pointAt(0.5);
         QPointF centerOffset = boundingCenter - lineCenter;
@@ -742,6 +979,7 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
         lineList.append(firstLine);
         intersectLines = lineList;
         _intersectLinesWithPolygon(lineList, polygon, intersectLines);
+        scanLineCount = intersectLines.count();
     }
 
     // Make sure all lines are going the same direction. Polygon intersection leads to lines which
@@ -749,27 +987,40 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
     QList<QLineF> resultLines;
     _adjustLineDirection(intersectLines, resultLines);
 
-    // Convert from NED to Geo
+    // Convert from NED to Geo, both ends of every transect in a single batch
     QList<QList<QGeoCoordinate>> transects;
-    for (const QLineF& line : resultLines) {
-        QGeoCoordinate          coord;
-        QList<QGeoCoordinate>   transect;
+    {
+        const size_t                cPoints = static_cast<size_t>(resultLines.count()) * 2;
+        std::vector<double>         north(cPoints);
+        std::vector<double>         east(cPoints);
+        std::vector<double>         down(cPoints, 0);
+        QGCGeo::CoordinateArrays    geo;
+
+        for (int i=0; i<resultLines.count(); i++) {
+            const QLineF& line = resultLines[i];
+            north[i * 2]        = line.p1().y();
+            east[i * 2]         = line.p1().x();
+            north[i * 2 + 1]    = line.p2().y();
+            east[i * 2 + 1]     = line.p2().x();
+        }
 
-        QGCGeo::convertNedToGeo(line.p1().y(), line.p1().x(), 0, tangentOrigin, coord);
-        transect.append(coord);
-        QGCGeo::convertNedToGeo(line.p2().y(), line.p2().x(), 0, tangentOrigin, coord);
-        transect.append(coord);
+        geo.resize(cPoints);
+        QGCGeo::convertNedToGeo(north, east, down, tangentOrigin, geo.latitudes, geo.longitudes, geo.altitudes);
 
-        transects.append(transect);
+        transects.reserve(resultLines.count());
+        for (size_t i=0; i<cPoints; i+=2) {
+            transects.append({ QGeoCoordinate(geo.latitudes[i], geo.longitudes[i], geo.altitudes[i]),
+                               QGeoCoordinate(geo.latitudes[i + 1], geo.longitudes[i + 1], geo.altitudes[i + 1]) });
+        }
     }
 
-    _adjustTransectsToEntryPointLocation(transects);
+    _adjustTransectsToEntryPointLocation(job.entryPoint, transects);
 
-    if (refly) {
-        _optimizeTransectsForShortestDistance(_transects.last().last().coord, transects);
+    if (refly && !coordInfoTransects.isEmpty() && !transects.isEmpty()) {
+        _optimizeTransectsForShortestDistance(coordInfoTransects.last().last().coord, transects);
     }
 
-    if (_flyAlternateTransectsFact.rawValue().toBool()) {
+    if (job.flyAlternateTransects) {
         QList<QList<QGeoCoordinate>> alternatingTransects;
         for (int i=0; i<transects.count(); i++) {
             if (!(i & 1)) {
@@ -802,8 +1053,19 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
         transects[i] = transectVertices;
     }
 
-    // Convert to CoordInfo transects and append to _transects
+    // Alternate transects are a deliberate pattern for wide turns, so those are left as is. Reordering only pays off
+    // once scan lines are split into several transects each, which happens with splitConcavePolygons. Otherwise
+    // the lawnmower order is already the shortest and no search is run.
+    if (!job.flyAlternateTransects && transects.count() > scanLineCount && transects.count() > 2) {
+        _optimizeTransectRoute(job, transects, result.routeDistanceSaved, promise);
+    }
+
+    // Convert to CoordInfo transects and append to coordInfoTransects
     for (const QList<QGeoCoordinate>& transect : transects) {
+        if (canceled()) {
+            return;
+        }
+
         QGeoCoordinate                                  coord;
         QList<TransectStyleComplexItem::CoordInfo_t>    coordInfoTransect;
         TransectStyleComplexItem::CoordInfo_t           coordInfo;
@@ -814,14 +1076,14 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
         coordInfoTransect.append(coordInfo);
 
         // For hover and capture we need points for each camera location within the transect
-        if (triggerCamera() && hoverAndCaptureEnabled()) {
+        if (job.hoverAndCapture) {
             double transectLength = transect[0].distanceTo(transect[1]);
             double transectAzimuth = transect[0].azimuthTo(transect[1]);
-            if (triggerDistance() < transectLength) {
-                int cInnerHoverPoints = static_cast<int>(floor(transectLength / triggerDistance()));
+            if (job.triggerDistance < transectLength) {
+                int cInnerHoverPoints = static_cast<int>(floor(transectLength / job.triggerDistance));
                 qCDebug(SurveyComplexItemLog) << "cInnerHoverPoints" << cInnerHoverPoints;
                 for (int i=0; i<cInnerHoverPoints; i++) {
-                    QGeoCoordinate hoverCoord = transect[0].atDistanceAndAzimuth(triggerDistance() * (i + 1), transectAzimuth);
+                    QGeoCoordinate hoverCoord = transect[0].atDistanceAndAzimuth(job.triggerDistance * (i + 1), transectAzimuth);
                     TransectStyleComplexItem::CoordInfo_t coordInfo = { hoverCoord, CoordTypeInteriorHoverTrigger };
                     coordInfoTransect.insert(1 + i, coordInfo);
                 }
@@ -829,9 +1091,9 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
         }
 
         // Extend the transect ends for turnaround
-        if (_hasTurnaround()) {
+        if (job.turnaroundDistance > 0) {
             QGeoCoordinate turnaroundCoord;
-            double turnAroundDistance = _turnAroundDistanceFact.rawValue().toDouble();
+            double turnAroundDistance = job.turnaroundDistance;
 
             double azimuth = transect[0].azimuthTo(transect[1]);
             turnaroundCoord = transect[0].atDistanceAndAzimuth(-turnAroundDistance, azimuth);
@@ -846,7 +1108,7 @@ void SurveyComplexItem::_rebuildTransectsPhase1WorkerSinglePolygon(bool refly)
             coordInfoTransect.append(coordInfo);
         }
 
-        _transects.append(coordInfoTransect);
+        coordInfoTransects.append(coordInfoTransect);
     }
 }
 
@@ -1170,7 +1432,7 @@ void SurveyComplexItem::_rebuildTransectsFromPolygon(bool refly, const QPolygonF
         transects.append(transect);
     }
 
-    _adjustTransectsToEntryPointLocation(transects);
+    _adjustTransectsToEntryPointLocation(_entryPoint, transects);
 
     if (refly) {
         _optimizeTransectsForShortestDistance(_transects.last().last().coord, transects);
@@ -13,6 +13,8 @@
 #include "SettingsFact.h"
 
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QPromise>
 
 Q_DECLARE_LOGGING_CATEGORY(SurveyComplexItemLog)
 
@@ -27,15 +29,18 @@ class SurveyComplexItem : public TransectStyleComplexItem
     /// @param flyView true: Created for use in the Fly View, false: Created for use in the Plan View
     /// @param kmlOrShpFile Polygon comes from this file, empty for default polygon
     SurveyComplexItem(PlanMasterController* masterController, bool flyView, const QString& kmlOrShpFile);
+    ~SurveyComplexItem();
 
     Q_PROPERTY(Fact*            gridAngle              READ gridAngle              CONSTANT)
     Q_PROPERTY(Fact*            flyAlternateTransects  READ flyAlternateTransects  CONSTANT)
     Q_PROPERTY(Fact*            splitConcavePolygons   READ splitConcavePolygons   CONSTANT)
     Q_PROPERTY(QGeoCoordinate   centerCoordinate       READ centerCoordinate       WRITE setCenterCoordinate)
+    Q_PROPERTY(double           routeTimeSaved         READ routeTimeSaved         NOTIFY routeTimeSavedChanged)   ///< Estimated flight time saved by transect route optimization (seconds)
 
     Fact* gridAngle             (void) { return &_gridAngleFact; }
     Fact* flyAlternateTransects (void) { return &_flyAlternateTransectsFact; }
     Fact* splitConcavePolygons  (void) { return &_splitConcavePolygonsFact; }
+    double routeTimeSaved       (void) const { return _vehicleSpeed > 0 ? _routeDistanceSaved / _vehicleSpeed : 0; }
 
     Q_INVOKABLE void rotateEntryPoint(void);
 
@@ -85,14 +90,21 @@ class SurveyComplexItem : public TransectStyleComplexItem
 
 signals:
     void refly90DegreesChanged(bool refly90Degrees);
+    void routeTimeSavedChanged(void);
 
 private slots:
     void _updateWizardMode              (void);
+    void _transectsJobFinished          (void);
 
     // Overrides from TransectStyleComplexItem
     void _rebuildTransectsPhase1        (void) final;
     void _recalcCameraShots             (void) final;
 
+protected:
+    // Overrides from TransectStyleComplexItem
+    bool _rebuildTransectsPhase1Async   (void) final;
+    void _waitForTransectsJob           (void) final;
+
 private:
     enum CameraTriggerCode {
         CameraTriggerNone,
@@ -101,21 +113,53 @@ private slots:
         CameraTriggerHoverAndCapture
     };
 
-    QPointF _rotatePoint(const QPointF& point, const QPointF& origin, double angle);
+    typedef QList<QList<CoordInfo_t>> TransectList_t;
+
+    typedef struct {
+        TransectList_t  transects;
+        double          routeDistanceSaved;     ///< Transit distance removed by route optimization (meters)
+    } TransectJobResult_t;
+
+    /// Plain copy of the geometry and settings needed to generate transects away from the GUI thread
+    typedef struct {
+        QList<QGeoCoordinate>   polygon;
+        double                  gridAngle;
+        double                  gridSpacing;
+        int                     entryPoint;
+        bool                    refly90Degrees;
+        bool                    flyAlternateTransects;
+        bool                    splitConcavePolygons;
+        bool                    hoverAndCapture;
+        double                  triggerDistance;
+        double                  turnaroundDistance;
+        qint64                  routeOptimizationEvaluations;
+    } TransectJob_t;
+
+    TransectJob_t           _transectJobSnapshot            (void);
+    void                    _cancelTransectsJob             (void);
+    void                    _clearLoadedMissionItems        (void);
+    static double           _transectJobCost                (const TransectJob_t& job);
+    static TransectJobResult_t  _buildTransects             (const TransectJob_t& job, const QPromise<TransectJobResult_t>* promise);
+    static void                 _buildTransectsSinglePolygon(const TransectJob_t& job, bool refly, TransectJobResult_t& result, const QPromise<TransectJobResult_t>* promise);
+    static void                 _optimizeTransectRoute      (const TransectJob_t& job, QList<QList<QGeoCoordinate>>& transects, double& routeDistanceSaved, const QPromise<TransectJobResult_t>* promise);
+    void                        _setRouteDistanceSaved      (double routeDistanceSaved);
+
+    static QPointF _rotatePoint(const QPointF& point, const QPointF& origin, double angle);
     void _intersectLinesWithRect(const QList<QLineF>& lineList, const QRectF& boundRect, QList<QLineF>& resultLines);
-    void _intersectLinesWithPolygon(const QList<QLineF>& lineList, const QPolygonF& polygon, QList<QLineF>& resultLines);
-    void _adjustLineDirection(const QList<QLineF>& lineList, QList<QLineF>& resultLines);
+    static void _intersectLinesWithPolygon(const QList<QLineF>& lineList, const QPolygonF& polygon, QList<QLineF>& resultLines);
+    static int _splitLinesWithPolygon(const QList<QLineF>& lineList, const QPolygonF& polygon, QList<QLineF>& resultLines);
+    static void _adjustLineDirection(const QList<QLineF>& lineList, QList<QLineF>& resultLines);
     bool _nextTransectCoord(const QList<QGeoCoordinate>& transectPoints, int pointIndex, QGeoCoordinate& coord);
     bool _appendMissionItemsWorker(QList<MissionItem*>& items, QObject* missionItemParent, int& seqNum, bool hasRefly, bool buildRefly);
-    void _optimizeTransectsForShortestDistance(const QGeoCoordinate& distanceCoord, QList<QList<QGeoCoordinate>>& transects);
+    static void _optimizeTransectsForShortestDistance(const QGeoCoordinate& distanceCoord, QList<QList<QGeoCoordinate>>& transects);
     qreal _ccw(QPointF pt1, QPointF pt2, QPointF pt3);
     qreal _dp(QPointF pt1, QPointF pt2);
     void _swapPoints(QList<QPointF>& points, int index1, int index2);
-    void _reverseTransectOrder(QList<QList<QGeoCoordinate>>& transects);
-    void _reverseInternalTransectPoints(QList<QList<QGeoCoordinate>>& transects);
-    void _adjustTransectsToEntryPointLocation(QList<QList<QGeoCoordinate>>& transects);
+    static void _reverseTransectOrder(QList<QList<QGeoCoordinate>>& transects);
+    static void _reverseInternalTransectPoints(QList<QList<QGeoCoordinate>>& transects);
+    static void _adjustTransectsToEntryPointLocation(int entryPoint, QList<QList<QGeoCoordinate>>& transects);
     bool _gridAngleIsNorthSouthTransects();
-    double _clampGridAngle90(double gridAngle);
+    static double _clampGridAngle90(double gridAngle);
     bool _imagesEverywhere(void) const;
     bool _triggerCamera(void) const;
     bool _hasTurnaround(void) const;
@@ -125,7 +169,6 @@ private slots:
     bool _loadV4V5(const QJsonObject& complexObject, int sequenceNumber, QString& errorString, int version, bool forPresets);
     void _saveCommon(QJsonObject& complexObject);
     void _rebuildTransectsPhase1Worker(bool refly);
-    void _rebuildTransectsPhase1WorkerSinglePolygon(bool refly);
     /// Adds to the _transects array from one polygon
     void _rebuildTransectsFromPolygon(bool refly, const QPolygonF& polygon, const QGeoCoordinate& tangentOrigin, const QPointF* const transitionPoint);
 
@@ -149,6 +192,14 @@ private slots:
     SettingsFact    _splitConcavePolygonsFact;
     int             _entryPoint;
 
+    QFutureWatcher<TransectJobResult_t> _transectsJobWatcher;
+    bool                                _transectsJobPending = false;
+    double                              _routeDistanceSaved = 0;
+
+    static constexpr double _asyncTransectJobCostThreshold = 250000;    ///< Jobs estimated below this are cheap enough to run on the GUI thread
+    static constexpr qint64 _syncRouteOptimizationEvaluations =     200000;     ///< Candidate moves, roughly 20 msecs on a desktop
+    static constexpr qint64 _asyncRouteOptimizationEvaluations =    5000000;
+
     static constexpr const char* _jsonGridAngleKey =          "angle";
     static constexpr const char* _jsonEntryPointKey =         "entryLocation";
 
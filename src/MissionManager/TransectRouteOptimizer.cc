@@ -0,0 +1,250 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TransectRouteOptimizer.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QElapsedTimer>
+
+#include <algorithm>
+#include <cmath>
+
+QGC_LOGGING_CATEGORY(TransectRouteOptimizerLog, "TransectRouteOptimizerLog")
+
+namespace {
+
+/// Working route state. Positions index into order/reversed, which in turn reference the input transects.
+class Route
+{
+public:
+    Route(const QList<QLineF>& transects)
+        : _transects(transects)
+    {
+        _order.reserve(transects.count());
+        _reversed.reserve(transects.count());
+        for (int i=0; i<transects.count(); i++) {
+            _order.append(i);
+            _reversed.append(false);
+        }
+    }
+
+    int count(void) const { return _order.count(); }
+
+    QPointF entry(int position) const
+    {
+        const QLineF& transect = _transects[_order[position]];
+        return _reversed[position] ? transect.p2() : transect.p1();
+    }
+
+    QPointF exit(int position) const
+    {
+        const QLineF& transect = _transects[_order[position]];
+        return _reversed[position] ? transect.p1() : transect.p2();
+    }
+
+    /// Reverses the run of transects between the two positions (inclusive), flipping each one
+    void reverseRun(int first, int last)
+    {
+        while (first < last) {
+            std::swap(_order[first], _order[last]);
+            std::swap(_reversed[first], _reversed[last]);
+            _reversed[first] = !_reversed[first];
+            _reversed[last] = !_reversed[last];
+            first++;
+            last--;
+        }
+        if (first == last) {
+            _reversed[first] = !_reversed[first];
+        }
+    }
+
+    /// Moves the run of transects starting at the position to be flown after insertAfter (-1 for the start of the route)
+    void moveRun(int first, int runLength, int insertAfter, bool flip)
+    {
+        QList<int>  runOrder    = _order.mid(first, runLength);
+        QList<bool> runReversed = _reversed.mid(first, runLength);
+        if (flip) {
+            std::reverse(runOrder.begin(), runOrder.end());
+            std::reverse(runReversed.begin(), runReversed.end());
+            for (bool& reversed: runReversed) {
+                reversed = !reversed;
+            }
+        }
+
+        _order.remove(first, runLength);
+        _reversed.remove(first, runLength);
+
+        int insertIndex = insertAfter < first ? insertAfter + 1 : insertAfter + 1 - runLength;
+        for (int i=0; i<runLength; i++) {
+            _order.insert(insertIndex + i, runOrder[i]);
+            _reversed.insert(insertIndex + i, runReversed[i]);
+        }
+    }
+
+    const QList<int>&   order   (void) const { return _order; }
+    const QList<bool>&  reversed(void) const { return _reversed; }
+
+private:
+    const QList<QLineF>&    _transects;
+    QList<int>              _order;
+    QList<bool>             _reversed;
+};
+
+double _distance(const QPointF& from, const QPointF& to)
+{
+    return std::hypot(to.x() - from.x(), to.y() - from.y());
+}
+
+} // namespace
+
+double TransectRouteOptimizer::transitDistance(const QList<QLineF>& transects, const QList<int>& order, const QList<bool>& reversed)
+{
+    double distance = 0;
+
+    for (int i=1; i<order.count(); i++) {
+        const QLineF& from  = transects[order[i - 1]];
+        const QLineF& to    = transects[order[i]];
+        distance += _distance(reversed[i - 1] ? from.p1() : from.p2(), reversed[i] ? to.p2() : to.p1());
+    }
+
+    return distance;
+}
+
+TransectRouteOptimizer::Result_t TransectRouteOptimizer::optimize(const QList<QLineF>& transects, bool fixFirst, qint64 maxEvaluations, const std::function<bool()>& isCanceled)
+{
+    QElapsedTimer   timer;
+    Route           route(transects);
+    Result_t        result;
+
+    timer.start();
+
+    result.evaluations      = 0;
+    result.passes           = 0;
+    result.stopped          = false;
+    result.initialTransit   = transitDistance(transects, route.order(), route.reversed());
+
+    const int cTransects        = route.count();
+    const int firstMovable      = fixFirst ? 1 : 0;
+
+    // Counts a candidate move, false once the budget is used up
+    auto      evaluate          = [&]() {
+        if (result.evaluations >= maxEvaluations) {
+            result.stopped = true;
+            return false;
+        }
+        result.evaluations++;
+        return true;
+    };
+    // Checked between runs of candidates, cancellation is too costly to check for every one
+    auto      stop              = [&]() {
+        if (!result.stopped && ((result.evaluations >= maxEvaluations) || (isCanceled && isCanceled()))) {
+            result.stopped = true;
+        }
+        return result.stopped;
+    };
+
+    bool improved = cTransects > 2;
+    while (improved && !stop()) {
+        improved = false;
+
+        // 2-opt: reverse the run first..last. Transits inside the run keep their length, only the two
+        // boundary transits change.
+        for (int first=firstMovable; first<cTransects && !stop(); first++) {
+            for (int last=first; last<cTransects && evaluate(); last++) {
+                double before   = 0;
+                double after    = 0;
+
+                if (first > 0) {
+                    before  += _distance(route.exit(first - 1), route.entry(first));
+                    after   += _distance(route.exit(first - 1), route.exit(last));
+                }
+                if (last < cTransects - 1) {
+                    before  += _distance(route.exit(last), route.entry(last + 1));
+                    after   += _distance(route.entry(first), route.entry(last + 1));
+                }
+
+                if (after < before - _minImprovement) {
+                    route.reverseRun(first, last);
+                    improved = true;
+                }
+            }
+        }
+
+        // Or-opt: move a run of one to three transects elsewhere in the route, in either direction
+        for (int runLength=1; runLength<=3; runLength++) {
+            for (int first=firstMovable; first + runLength <= cTransects && !stop(); first++) {
+                const int   last    = first + runLength - 1;
+                const bool  hasPrev = first > 0;
+                const bool  hasNext = last < cTransects - 1;
+
+                double removeGain = 0;
+                if (hasPrev) {
+                    removeGain += _distance(route.exit(first - 1), route.entry(first));
+                }
+                if (hasNext) {
+                    removeGain += _distance(route.exit(last), route.entry(last + 1));
+                }
+                if (hasPrev && hasNext) {
+                    removeGain -= _distance(route.exit(first - 1), route.entry(last + 1));
+                }
+                if (removeGain <= _minImprovement) {
+                    continue;
+                }
+
+                bool moved = false;
+                for (int insertAfter=firstMovable - 1; insertAfter<cTransects && !moved && !result.stopped; insertAfter++) {
+                    if (insertAfter >= first - 1 && insertAfter <= last) {
+                        continue;
+                    }
+
+                    const int next = insertAfter + 1;
+                    for (bool flip: { false, true }) {
+                        if (!evaluate()) {
+                            break;
+                        }
+
+                        QPointF runEntry    = flip ? route.exit(last) : route.entry(first);
+                        QPointF runExit     = flip ? route.entry(first) : route.exit(last);
+
+                        double insertCost = 0;
+                        if (insertAfter >= 0) {
+                            insertCost += _distance(route.exit(insertAfter), runEntry);
+                        }
+                        if (next < cTransects) {
+                            insertCost += _distance(runExit, route.entry(next));
+                        }
+                        if (insertAfter >= 0 && next < cTransects) {
+                            insertCost -= _distance(route.exit(insertAfter), route.entry(next));
+                        }
+
+                        if (insertCost < removeGain - _minImprovement) {
+                            route.moveRun(first, runLength, insertAfter, flip);
+                            improved = moved = true;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+
+        if (!result.stopped) {
+            result.passes++;
+        }
+    }
+
+    result.order            = route.order();
+    result.reversed         = route.reversed();
+    result.optimizedTransit = transitDistance(transects, result.order, result.reversed);
+    result.elapsedMsecs     = timer.elapsed();
+
+    qCDebug(TransectRouteOptimizerLog) << "optimize transects:initial:optimized:passes:evaluations:elapsed:stopped"
+                                       << cTransects << result.initialTransit << result.optimizedTransit << result.passes << result.evaluations << result.elapsedMsecs << result.stopped;
+
+    return result;
+}
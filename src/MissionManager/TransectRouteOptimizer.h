@@ -0,0 +1,50 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QLineF>
+#include <QtCore/QList>
+#include <QtCore/QLoggingCategory>
+
+#include <functional>
+
+Q_DECLARE_LOGGING_CATEGORY(TransectRouteOptimizerLog)
+
+/// Reorders and flips transects to reduce the transit distance flown between them.
+/// The search is a local search using 2-opt moves (reverse a run of transects) and Or-opt moves (relocate a run of
+/// up to three transects), both of which also flip transect direction. It is bounded by the number of candidate
+/// moves evaluated rather than by time, so the same input always gives the same route. It only works with
+/// planar coordinates and holds no state, so it is safe to run from any thread.
+class TransectRouteOptimizer
+{
+public:
+    typedef struct {
+        QList<int>  order;              ///< Index into the input transects for each position in the route
+        QList<bool> reversed;           ///< true: transect at this position is flown p2 -> p1
+        double      initialTransit;     ///< Transit distance of the input route
+        double      optimizedTransit;   ///< Transit distance of the returned route
+        qint64      elapsedMsecs;       ///< For logging only, plays no part in the search
+        qint64      evaluations;        ///< Candidate moves evaluated
+        int         passes;             ///< Number of complete improvement passes
+        bool        stopped;            ///< Search was stopped by the evaluation budget or cancellation
+    } Result_t;
+
+    /// @param transects Transects in current flight order, each flown p1 -> p2
+    /// @param fixFirst true: first transect keeps its position and direction (entry point chosen by the user)
+    /// @param maxEvaluations Search stops after evaluating this many candidate moves and returns the best route found so far
+    /// @param isCanceled Optional, checked periodically to abandon the search early
+    static Result_t optimize(const QList<QLineF>& transects, bool fixFirst, qint64 maxEvaluations, const std::function<bool()>& isCanceled = nullptr);
+
+    /// @return Sum of the distances from the end of each transect to the start of the next one
+    static double transitDistance(const QList<QLineF>& transects, const QList<int>& order, const QList<bool>& reversed);
+
+private:
+    static constexpr double _minImprovement = 0.01; ///< Meters, moves which gain less are ignored to prevent cycling on rounding noise
+};
@@ -128,6 +128,8 @@ void TransectStyleComplexItem::setDirty(bool dirty)
 
 void TransectStyleComplexItem::_save(QJsonObject& complexObject)
 {
+    _waitForTransectsJob();
+
     QJsonObject innerObject;
 
     innerObject[JsonHelper::jsonVersionKey] =       2;
@@ -388,12 +390,28 @@ void TransectStyleComplexItem::_rebuildTransects(void)
         return;
     }
 
+    if (_rebuildTransectsPhase1Async()) {
+        return;
+    }
+
     _transects.clear();
+    _rebuildTransectsPhase1();
+    _rebuildTransectsPhase2();
+}
+
+/// Replaces the current transects with the result of a background transect job
+void TransectStyleComplexItem::_publishTransects(const QList<QList<CoordInfo_t>>& transects)
+{
+    _transects = transects;
+    _rebuildTransectsPhase2();
+}
+
+/// Builds everything which derives from _transects: flight path, visuals, distances and camera shots
+void TransectStyleComplexItem::_rebuildTransectsPhase2(void)
+{
     _rgPathHeightInfo.clear();
     _rgFlightPathCoordInfo.clear();
 
-    _rebuildTransectsPhase1();
-
     _minAMSLAltitude = _maxAMSLAltitude = qQNaN();
 
     switch (_cameraCalc.distanceMode()) {
@@ -1108,6 +1126,8 @@ void TransectStyleComplexItem::_handleHoverAndCaptureEnabled(QVariant enabled)
 
 void TransectStyleComplexItem::appendMissionItems(QList<MissionItem*>& items, QObject* missionItemParent)
 {
+    _waitForTransectsJob();
+
     if (_loadedMissionItems.count()) {
         // We have mission items from the loaded plan, use those
         _appendLoadedMissionItems(items, missionItemParent);
@@ -138,6 +138,13 @@ protected slots:
     virtual void _rebuildTransectsPhase1    (void) = 0; ///< Rebuilds the _transects array
     virtual void _recalcCameraShots         (void) = 0;
 
+    /// Allows derived classes to generate transects on a worker thread. Return true if a job was started, in which case
+    /// the current transects stay published until the job hands its result to _publishTransects.
+    virtual bool _rebuildTransectsPhase1Async(void) { return false; }
+
+    /// Blocks until any in flight transect job has published its result
+    virtual void _waitForTransectsJob       (void) { }
+
     void    _save                           (QJsonObject& saveObject);
     bool    _load                           (const QJsonObject& complexObject, bool forPresets, QString& errorString);
     void    _setExitCoordinate              (const QGeoCoordinate& coordinate);
@@ -173,6 +180,8 @@ protected slots:
         CoordType       coordType;
     } CoordInfo_t;
 
+    void    _publishTransects               (const QList<QList<CoordInfo_t>>& transects);
+
     QVariantList                                _visualTransectPoints;                          ///< Used to draw the flight path visuals on the screen
     QList<QList<CoordInfo_t>>                   _transects;
     QList<TerrainPathQuery::PathHeightInfo_t>   _rgPathHeightInfo;                              ///< Path height for each segment includes turn segments
@@ -239,6 +248,7 @@ private slots:
     double  _altitudeBetweenCoords                                          (const QGeoCoordinate& fromCoord, const QGeoCoordinate& toCoord, double percentTowardsTo);
     int     _maxPathHeight                                                  (const TerrainPathQuery::PathHeightInfo_t& pathHeightInfo, int fromIndex, int toIndex, double& maxHeight);
     BuildMissionItemsState_t _buildMissionItemsState                        (void) const;
+    void    _rebuildTransectsPhase2                                         (void);
 
     TerrainPolyPathQuery*       _currentTerrainPolyPathQuery        = nullptr;
     TerrainAtCoordinateQuery*   _currentTerrainAtCoordinateQuery    = nullptr;
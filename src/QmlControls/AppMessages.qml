@@ -78,7 +78,7 @@ Item {
 
                 Connections {
                     target:         debugMessageModel
-                    function onDataChanged(topLeft, bottomRight, roles) { listView.scrollToEnd() }
+                    function onRowsInserted(parent, first, last) { listView.scrollToEnd() }
                 }
             }
 
@@ -61,6 +61,12 @@ ToolIndicatorPage {
                     label:      qsTr("Course Over Ground")
                     labelText:  activeVehicle ? activeVehicle.gps.courseOverGround.valueString : valueNA
                 }
+
+                LabelledLabel {
+                    label:      qsTr("RTK Correction Age")
+                    labelText:  activeVehicle ? activeVehicle.gps.correctionAge.valueString + " " + activeVehicle.gps.correctionAge.units : valueNA
+                    visible:    QGroundControl.gpsRtk.connected.value
+                }
             }
 
             SettingsGroupLayout {
@@ -175,28 +175,28 @@ bool QGCMapPolygon::containsCoordinate(const QGeoCoordinate& coordinate) const
 
 void QGCMapPolygon::setPath(const QList<QGeoCoordinate>& path)
 {
+    beginReset();
+
     _polygonPath.clear();
     _polygonModel.clearAndDeleteContents();
-    for(const QGeoCoordinate& coord: path) {
-        _polygonPath.append(QVariant::fromValue(coord));
-        _polygonModel.append(new QGCQGeoCoordinate(coord, this));
-    }
+    appendVertices(path);
 
     setDirty(true);
-    emit pathChanged();
+
+    endReset();
 }
 
 void QGCMapPolygon::setPath(const QVariantList& path)
 {
-    _polygonPath = path;
+    beginReset();
 
+    _polygonPath = path;
     _polygonModel.clearAndDeleteContents();
-    for (int i=0; i<_polygonPath.count(); i++) {
-        _polygonModel.append(new QGCQGeoCoordinate(_polygonPath[i].value<QGeoCoordinate>(), this));
-    }
+    _appendVertexObjects();
 
     setDirty(true);
-    emit pathChanged();
+
+    endReset();
 }
 
 void QGCMapPolygon::saveToJson(QJsonObject& json)
@@ -225,9 +225,7 @@ bool QGCMapPolygon::loadFromJson(const QJsonObject& json, bool required, QString
         return false;
     }
 
-    for (int i=0; i<_polygonPath.count(); i++) {
-        _polygonModel.append(new QGCQGeoCoordinate(_polygonPath[i].value<QGeoCoordinate>(), this));
-    }
+    _appendVertexObjects();
 
     setDirty(false);
     emit pathChanged();
@@ -238,6 +236,7 @@ bool QGCMapPolygon::loadFromJson(const QJsonObject& json, bool required, QString
 QList<QGeoCoordinate> QGCMapPolygon::coordinateList(void) const
 {
     QList<QGeoCoordinate> coords;
+    coords.reserve(_polygonPath.count());
 
     for (int i=0; i<_polygonPath.count(); i++) {
         coords.append(_polygonPath[i].value<QGeoCoordinate>());
@@ -288,28 +287,37 @@ void QGCMapPolygon::appendVertex(const QGeoCoordinate& coordinate)
 
 void QGCMapPolygon::appendVertices(const QList<QGeoCoordinate>& coordinates)
 {
-    QList<QObject*> objects;
-
+    // The model reset signals pathChanged once the outermost reset ends
     beginReset();
+    _polygonPath.reserve(_polygonPath.count() + coordinates.count());
     for (const QGeoCoordinate& coordinate: coordinates) {
-        objects.append(new QGCQGeoCoordinate(coordinate, this));
         _polygonPath.append(QVariant::fromValue(coordinate));
     }
-    _polygonModel.append(objects);
+    _appendVertexObjects();
     endReset();
-
-    emit pathChanged();
 }
 
 void QGCMapPolygon::appendVertices(const QVariantList& varCoords)
 {
     QList<QGeoCoordinate> rgCoords;
+    rgCoords.reserve(varCoords.count());
     for (const QVariant& varCoord: varCoords) {
         rgCoords.append(varCoord.value<QGeoCoordinate>());
     }
     appendVertices(rgCoords);
 }
 
+/// Adds the vertex objects for the entries in _polygonPath which are not in the model yet, in a single insert
+void QGCMapPolygon::_appendVertexObjects(void)
+{
+    QList<QObject*> objects;
+    objects.reserve(_polygonPath.count() - _polygonModel.count());
+    for (qsizetype i=_polygonModel.count(); i<_polygonPath.count(); i++) {
+        objects.append(new QGCQGeoCoordinate(_polygonPath[i].value<QGeoCoordinate>(), this));
+    }
+    _polygonModel.append(objects);
+}
+
 void QGCMapPolygon::_polygonModelDirtyChanged(bool dirty)
 {
     if (dirty) {
@@ -511,11 +519,11 @@ void QGCMapPolygon::offset(double distance)
     endReset();
 }
 
-bool QGCMapPolygon::loadKMLOrSHPFile(const QString& file)
+bool QGCMapPolygon::loadKMLOrSHPFile(const QString& file, double simplifyToleranceMeters)
 {
     QString errorString;
     QList<QGeoCoordinate> rgCoords;
-    if (!ShapeFileHelper::loadPolygonFromFile(file, rgCoords, errorString)) {
+    if (!ShapeFileHelper::loadPolygonFromFile(file, rgCoords, errorString, simplifyToleranceMeters)) {
         qgcApp()->showAppMessage(errorString);
         return false;
     }
@@ -70,8 +70,9 @@ class QGCMapPolygon : public QObject
     Q_INVOKABLE void offset(double distance);
 
     /// Loads a polygon from a KML/SHP file
+    ///     @param simplifyToleranceMeters Vertices closer than this to the simplified outline are dropped, 0 keeps all
     /// @return true: success
-    Q_INVOKABLE bool loadKMLOrSHPFile(const QString& file);
+    Q_INVOKABLE bool loadKMLOrSHPFile(const QString& file, double simplifyToleranceMeters = 0);
 
     /// Returns the path in a list of QGeoCoordinate's format
     QList<QGeoCoordinate> coordinateList(void) const;
@@ -157,6 +158,7 @@ private slots:
     QPolygonF       _toPolygonF             (void) const;
     QGeoCoordinate  _coordFromPointF        (const QPointF& point) const;
     QPointF         _pointFFromCoord        (const QGeoCoordinate& coordinate) const;
+    void            _appendVertexObjects    (void);
 
     QVariantList        _polygonPath;
     QmlObjectListModel  _polygonModel;
@@ -134,10 +134,7 @@ void QGCMapPolyline::setPath(const QList<QGeoCoordinate>& path)
 
     _polylinePath.clear();
     _polylineModel.clearAndDeleteContents();
-    for (const QGeoCoordinate& coord: path) {
-        _polylinePath.append(QVariant::fromValue(coord));
-        _polylineModel.append(new QGCQGeoCoordinate(coord, this));
-    }
+    appendVertices(path);
 
     setDirty(true);
 
@@ -150,9 +147,7 @@ void QGCMapPolyline::setPath(const QVariantList& path)
 
     _polylinePath = path;
     _polylineModel.clearAndDeleteContents();
-    for (int i=0; i<_polylinePath.count(); i++) {
-        _polylineModel.append(new QGCQGeoCoordinate(_polylinePath[i].value<QGeoCoordinate>(), this));
-    }
+    _appendVertexObjects();
     setDirty(true);
 
     endReset();
@@ -185,9 +180,7 @@ bool QGCMapPolyline::loadFromJson(const QJsonObject& json, bool required, QStrin
         return false;
     }
 
-    for (int i=0; i<_polylinePath.count(); i++) {
-        _polylineModel.append(new QGCQGeoCoordinate(_polylinePath[i].value<QGeoCoordinate>(), this));
-    }
+    _appendVertexObjects();
 
     setDirty(false);
     emit pathChanged();
@@ -198,6 +191,7 @@ bool QGCMapPolyline::loadFromJson(const QJsonObject& json, bool required, QStrin
 QList<QGeoCoordinate> QGCMapPolyline::coordinateList(void) const
 {
     QList<QGeoCoordinate> coords;
+    coords.reserve(_polylinePath.count());
 
     for (int i=0; i<_polylinePath.count(); i++) {
         coords.append(_polylinePath[i].value<QGeoCoordinate>());
@@ -358,11 +352,11 @@ QList<QGeoCoordinate> QGCMapPolyline::offsetPolyline(double distance)
     return rgNewPolyline;
 }
 
-bool QGCMapPolyline::loadKMLOrSHPFile(const QString &file)
+bool QGCMapPolyline::loadKMLOrSHPFile(const QString &file, double simplifyToleranceMeters)
 {
     QString errorString;
     QList<QGeoCoordinate> rgCoords;
-    if (!ShapeFileHelper::loadPolylineFromFile(file, rgCoords, errorString)) {
+    if (!ShapeFileHelper::loadPolylineFromFile(file, rgCoords, errorString, simplifyToleranceMeters)) {
         qgcApp()->showAppMessage(errorString);
         return false;
     }
@@ -403,18 +397,27 @@ double QGCMapPolyline::length(void) const
 
 void QGCMapPolyline::appendVertices(const QList<QGeoCoordinate>& coordinates)
 {
+    // The model reset signals pathChanged once the outermost reset ends
     beginReset();
 
-    QList<QObject*> objects;
+    _polylinePath.reserve(_polylinePath.count() + coordinates.count());
     for (const QGeoCoordinate& coordinate: coordinates) {
-        objects.append(new QGCQGeoCoordinate(coordinate, this));
         _polylinePath.append(QVariant::fromValue(coordinate));
     }
-    _polylineModel.append(objects);
+    _appendVertexObjects();
 
     endReset();
+}
 
-    emit pathChanged();
+/// Adds the vertex objects for the entries in _polylinePath which are not in the model yet, in a single insert
+void QGCMapPolyline::_appendVertexObjects(void)
+{
+    QList<QObject*> objects;
+    objects.reserve(_polylinePath.count() - _polylineModel.count());
+    for (qsizetype i=_polylineModel.count(); i<_polylinePath.count(); i++) {
+        objects.append(new QGCQGeoCoordinate(_polylinePath[i].value<QGeoCoordinate>(), this));
+    }
+    _polylineModel.append(objects);
 }
 
 void QGCMapPolyline::beginReset(void)
@@ -55,8 +55,9 @@ class QGCMapPolyline : public QObject
     QList<QGeoCoordinate> offsetPolyline(double distance);
 
     /// Loads a polyline from a KML/SHP file
+    ///     @param simplifyToleranceMeters Vertices closer than this to the simplified line are dropped, 0 keeps all
     /// @return true: success
-    Q_INVOKABLE bool loadKMLOrSHPFile(const QString &file);
+    Q_INVOKABLE bool loadKMLOrSHPFile(const QString &file, double simplifyToleranceMeters = 0);
 
     Q_INVOKABLE void beginReset (void);
     Q_INVOKABLE void endReset   (void);
@@ -125,6 +126,7 @@ private slots:
     void            _init                   (void);
     QGeoCoordinate  _coordFromPointF        (const QPointF& point) const;
     QPointF         _pointFFromCoord        (const QGeoCoordinate& coordinate) const;
+    void            _appendVertexObjects    (void);
 
     QVariantList        _polylinePath;
     QmlObjectListModel  _polylineModel;
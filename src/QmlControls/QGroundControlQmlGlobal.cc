@@ -30,6 +30,7 @@
 #endif
 #ifdef QT_DEBUG
 #include "MockLink.h"
+#include "MockSwarmLink.h"
 #endif
 #ifndef QGC_AIRLINK_DISABLED
 #include "AirLinkManager.h"
@@ -185,6 +186,15 @@ void QGroundControlQmlGlobal::startAPMArduRoverMockLink(bool sendStatusText)
 #endif
 }
 
+void QGroundControlQmlGlobal::startMockSwarmLink(int vehicleCount)
+{
+#ifdef QT_DEBUG
+    MockSwarmLink::startMockSwarmLink(vehicleCount);
+#else
+    Q_UNUSED(vehicleCount);
+#endif
+}
+
 void QGroundControlQmlGlobal::stopOneMockLink(void)
 {
 #ifdef QT_DEBUG
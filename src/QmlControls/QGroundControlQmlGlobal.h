@@ -140,6 +140,7 @@ class QGroundControlQmlGlobal : public QObject
     Q_INVOKABLE void    startAPMArduPlaneMockLink   (bool sendStatusText);
     Q_INVOKABLE void    startAPMArduSubMockLink     (bool sendStatusText);
     Q_INVOKABLE void    startAPMArduRoverMockLink   (bool sendStatusText);
+    Q_INVOKABLE void    startMockSwarmLink          (int vehicleCount);
     Q_INVOKABLE void    stopOneMockLink             (void);
 
     /// Returns the list of available logging category names.
@@ -93,10 +93,13 @@ bool QmlObjectListModel::insertRows(int position, int rows, const QModelIndex& p
         qCWarning(QmlObjectListModelLog) << "Invalid position - position:count" << position << _objectList.count() << this;
     }
     
-    beginInsertRows(QModelIndex(), position, position + rows - 1);
-    endInsertRows();
-    
-    emit countChanged(count());
+    // Inside a reset the views reload everything at endResetModel, which also signals the count
+    if (_resetModelNestingCount == 0) {
+        beginInsertRows(QModelIndex(), position, position + rows - 1);
+        endInsertRows();
+
+        emit countChanged(count());
+    }
     
     return true;
 }
@@ -202,21 +205,33 @@ void QmlObjectListModel::insert(int i, QList<QObject*> objects)
         qCWarning(QmlObjectListModelLog) << "Invalid index - index:count" << i << _objectList.count() << this;
     }
 
+    // Large lists are usually made up of a single type, so only look for the dirtyChanged signal when the type changes
+    const QMetaObject* lastMetaObject = nullptr;
+    bool hasDirtyChanged = false;
+
     int j = i;
     for (QObject* object: objects) {
         QQmlEngine::setObjectOwnership(object, QQmlEngine::CppOwnership);
 
         // Look for a dirtyChanged signal on the object
-        if (object->metaObject()->indexOfSignal(QMetaObject::normalizedSignature("dirtyChanged(bool)").constData()) != -1) {
+        if (object->metaObject() != lastMetaObject) {
+            lastMetaObject = object->metaObject();
+            hasDirtyChanged = lastMetaObject->indexOfSignal(QMetaObject::normalizedSignature("dirtyChanged(bool)").constData()) != -1;
+        }
+        if (hasDirtyChanged) {
             if (!_skipDirtyFirstItem || j != 0) {
                 QObject::connect(object, SIGNAL(dirtyChanged(bool)), this, SLOT(_childDirtyChanged(bool)));
             }
         }
-
-        _objectList.insert(j, object);
         j++;
     }
 
+    if (i == _objectList.count()) {
+        _objectList.append(objects);
+    } else {
+        _objectList = _objectList.mid(0, i) + objects + _objectList.mid(i);
+    }
+
     insertRows(i, objects.count());
 
     setDirty(true);
@@ -95,6 +95,12 @@ TransectStyleComplexItemEditor {
                         fact:       missionItem.flyAlternateTransects,
                         enabled:    true,
                         visible:    _vehicle ? (_vehicle.fixedWing || _vehicle.vtol) : false
+                    },
+                    {
+                        text:       qsTr("Split concave polygons"),
+                        fact:       missionItem.splitConcavePolygons,
+                        enabled:    !missionItem.flyAlternateTransects.rawValue,
+                        visible:    true
                     }
                 ]
             }
@@ -106,7 +112,7 @@ TransectStyleComplexItemEditor {
         title:          qsTr("Select Polygon File")
 
         onAcceptedForLoad: (file) => {
-            missionItem.surveyAreaPolygon.loadKMLOrSHPFile(file)
+            missionItem.surveyAreaPolygon.loadKMLOrSHPFile(file, QGroundControl.settingsManager.planViewSettings.shapeSimplifyTolerance.rawValue)
             missionItem.resetState = false
             //editorMap.mapFitFunctions.fitMapViewportTomissionItems()
             close()
@@ -13,6 +13,9 @@ Grid {
     columns:        2
     columnSpacing:  ScreenTools.defaultFontPixelWidth
 
+    // Only surveys optimize their transect route
+    property real _routeTimeSaved: missionItem.routeTimeSaved !== undefined ? missionItem.routeTimeSaved : 0
+
     QGCLabel { text: qsTr("Survey Area") }
     QGCLabel { text: QGroundControl.unitsConversion.squareMetersToAppSettingsAreaUnits(missionItem.coveredArea).toFixed(2) + " " + QGroundControl.unitsConversion.appSettingsAreaUnitsString }
 
@@ -24,4 +27,13 @@ Grid {
 
     QGCLabel { text: qsTr("Trigger Distance") }
     QGCLabel { text: missionItem.cameraCalc.adjustedFootprintFrontal.valueString + " " + missionItem.cameraCalc.adjustedFootprintFrontal.units }
+
+    QGCLabel {
+        text:       qsTr("Route Time Saved")
+        visible:    _routeTimeSaved > 0
+    }
+    QGCLabel {
+        text:       _routeTimeSaved.toFixed(0) + " " + qsTr("secs")
+        visible:    _routeTimeSaved > 0
+    }
 }
@@ -20,3 +20,4 @@ DECLARE_SETTINGSFACT(PlanViewSettings, takeoffItemNotRequired)
 DECLARE_SETTINGSFACT(PlanViewSettings, allowMultipleLandingPatterns)
 DECLARE_SETTINGSFACT(PlanViewSettings, showGimbalOnlyWhenSet)
 DECLARE_SETTINGSFACT(PlanViewSettings, vtolTransitionDistance)
+DECLARE_SETTINGSFACT(PlanViewSettings, shapeSimplifyTolerance)
@@ -31,4 +31,5 @@ class PlanViewSettings : public SettingsGroup
     DEFINE_SETTINGFACT(allowMultipleLandingPatterns)
     DEFINE_SETTINGFACT(showGimbalOnlyWhenSet)
     DEFINE_SETTINGFACT(vtolTransitionDistance)
+    DEFINE_SETTINGFACT(shapeSimplifyTolerance)
 };
@@ -31,6 +31,8 @@ class VideoSettings : public SettingsGroup
     DEFINE_SETTINGFACT(gridLines)
     DEFINE_SETTINGFACT(showRecControl)
     DEFINE_SETTINGFACT(recordingFormat)
+    DEFINE_SETTINGFACT(subtitleFormat)
+    DEFINE_SETTINGFACT(telemetryTrack)
     DEFINE_SETTINGFACT(maxVideoSize)
     DEFINE_SETTINGFACT(enableStorageLimit)
     DEFINE_SETTINGFACT(rtspTimeout)
@@ -17,5 +17,6 @@ DECLARE_SETTINGSFACT(Viewer3DSettings, enabled)
 DECLARE_SETTINGSFACT(Viewer3DSettings, osmFilePath)
 DECLARE_SETTINGSFACT(Viewer3DSettings, buildingLevelHeight)
 DECLARE_SETTINGSFACT(Viewer3DSettings, altitudeBias)
+DECLARE_SETTINGSFACT(Viewer3DSettings, terrainElevation)
 
 
@@ -29,4 +29,5 @@ class Viewer3DSettings : public SettingsGroup
     DEFINE_SETTINGFACT(osmFilePath)
     DEFINE_SETTINGFACT(buildingLevelHeight)
     DEFINE_SETTINGFACT(altitudeBias)
+    DEFINE_SETTINGFACT(terrainElevation)
 };
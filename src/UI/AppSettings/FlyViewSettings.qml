@@ -42,6 +42,7 @@ SettingsPage {
     property Fact   _viewer3DOsmFilePath:                   _viewer3DSettings.osmFilePath
     property Fact   _viewer3DBuildingLevelHeight:           _viewer3DSettings.buildingLevelHeight
     property Fact   _viewer3DAltitudeBias:                  _viewer3DSettings.altitudeBias
+    property Fact   _viewer3DTerrainElevation:              _viewer3DSettings.terrainElevation
 
     function mavlinkActionList() {
         var fileModel = QGCFileDialogController.getFiles(_settingsManager.appSettings.mavlinkActionsSavePath, "*.json")
@@ -332,5 +333,13 @@ SettingsPage {
             enabled:            _viewer3DEnabled.rawValue
             visible:            _viewer3DAltitudeBias.visible
         }
+
+        FactCheckBoxSlider {
+            Layout.fillWidth:   true
+            text:               qsTr("Terrain Elevation")
+            fact:               _viewer3DTerrainElevation
+            enabled:            _viewer3DEnabled.rawValue
+            visible:            _viewer3DTerrainElevation.visible
+        }
     }
 }
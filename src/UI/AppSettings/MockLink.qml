@@ -76,6 +76,20 @@ Rectangle {
                 Layout.fillWidth:   true
                 onClicked:          QGroundControl.startGenericMockLink(sendStatusText.checked)
             }
+            RowLayout {
+                Layout.fillWidth:   true
+
+                QGCButton {
+                    text:               qsTr("Vehicle Swarm")
+                    Layout.fillWidth:   true
+                    onClicked:          QGroundControl.startMockSwarmLink(parseInt(swarmVehicleCount.text))
+                }
+                QGCTextField {
+                    id:                 swarmVehicleCount
+                    text:               "50"
+                    inputMethodHints:   Qt.ImhDigitsOnly
+                }
+            }
             QGCButton {
                 text:               qsTr("Stop One MockLink")
                 Layout.fillWidth:   true
@@ -0,0 +1,161 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+import QtQuick
+import QtQuick.Controls
+import QtQuick.Layouts
+
+import QGroundControl
+import QGroundControl.Controls
+import QGroundControl.ScreenTools
+
+
+GridLayout {
+    columns:        2
+    rowSpacing:     _rowSpacing
+    columnSpacing:  _colSpacing
+
+    function saveSettings() {
+        subEditConfig.vehicleCount          = parseInt(vehicleCountField.text)
+        subEditConfig.firstSystemId         = parseInt(firstSystemIdField.text)
+        subEditConfig.workerThreads         = parseInt(workerThreadsField.text)
+        subEditConfig.attitudeRate          = parseFloat(attitudeRateField.text)
+        subEditConfig.globalPositionRate    = parseFloat(globalPositionRateField.text)
+        subEditConfig.vfrHudRate            = parseFloat(vfrHudRateField.text)
+        subEditConfig.sysStatusRate         = parseFloat(sysStatusRateField.text)
+        subEditConfig.escStatusRate         = parseFloat(escStatusRateField.text)
+        subEditConfig.adsbRate              = parseFloat(adsbRateField.text)
+        subEditConfig.packetLossPercent     = parseFloat(packetLossField.text)
+        subEditConfig.latencyMsecs          = parseInt(latencyField.text)
+        subEditConfig.latencyJitterMsecs    = parseInt(jitterField.text)
+        subEditConfig.burstIntervalMsecs    = parseInt(burstIntervalField.text)
+        subEditConfig.burstLengthMsecs      = parseInt(burstLengthField.text)
+        subEditConfig.randomSeed            = parseInt(randomSeedField.text)
+    }
+
+    QGCLabel { text: qsTr("Vehicles") }
+    QGCTextField {
+        id:                     vehicleCountField
+        Layout.preferredWidth:  _secondColumnWidth
+        text:                   subEditConfig.vehicleCount.toString()
+        inputMethodHints:       Qt.ImhFormattedNumbersOnly
+    }
+
+    QGCLabel { text: qsTr("First System Id") }
+    QGCTextField {
+        id:                     firstSystemIdField
+        Layout.preferredWidth:  _secondColumnWidth
+        text:                   subEditConfig.firstSystemId.toString()
+        inputMethodHints:       Qt.ImhFormattedNumbersOnly
+    }
+
+    QGCLabel { text: qsTr("Worker Threads") }
+    QGCTextField {
+        id:                     workerThreadsField
+        Layout.preferredWidth:  _secondColumnWidth
+        text:                   subEditConfig.workerThreads.toString()
+        inputMethodHints:       Qt.ImhFormattedNumbersOnly
+    }
+
+    QGCLabel { text: qsTr("ATTITUDE (Hz)") }
+    QGCTextField {
+        id:                     attitudeRateField
+        Layout.preferredWidth:  _secondColumnWidth
+        text:                   subEditConfig.attitudeRate.toString()
+        inputMethodHints:       Qt.ImhFormattedNumbersOnly
+    }
+
+    QGCLabel { text: qsTr("GLOBAL_POSITION_INT (Hz)") }
+    QGCTextField {
+        id:                     globalPositionRateField
+        Layout.preferredWidth:  _secondColumnWidth
+        text:                   subEditConfig.globalPositionRate.toString()
+        inputMethodHints:       Qt.ImhFormattedNumbersOnly
+    }
+
+    QGCLabel { text: qsTr("VFR_HUD (Hz)") }
+    QGCTextField {
+        id:                     vfrHudRateField
+        Layout.preferredWidth:  _secondColumnWidth
+        text:                   subEditConfig.vfrHudRate.toString()
+        inputMethodHints:       Qt.ImhFormattedNumbersOnly
+    }
+
+    QGCLabel { text: qsTr("SYS_STATUS (Hz)") }
+    QGCTextField {
+        id:                     sysStatusRateField
+        Layout.preferredWidth:  _secondColumnWidth
+        text:                   subEditConfig.sysStatusRate.toString()
+        inputMethodHints:       Qt.ImhFormattedNumbersOnly
+    }
+
+    QGCLabel { text: qsTr("ESC_STATUS (Hz)") }
+    QGCTextField {
+        id:                     escStatusRateField
+        Layout.preferredWidth:  _secondColumnWidth
+        text:                   subEditConfig.escStatusRate.toString()
+        inputMethodHints:       Qt.ImhFormattedNumbersOnly
+    }
+
+    QGCLabel { text: qsTr("ADSB_VEHICLE (Hz)") }
+    QGCTextField {
+        id:                     adsbRateField
+        Layout.preferredWidth:  _secondColumnWidth
+        text:                   subEditConfig.adsbRate.toString()
+        inputMethodHints:       Qt.ImhFormattedNumbersOnly
+    }
+
+    QGCLabel { text: qsTr("Packet Loss (%)") }
+    QGCTextField {
+        id:                     packetLossField
+        Layout.preferredWidth:  _secondColumnWidth
+        text:                   subEditConfig.packetLossPercent.toString()
+        inputMethodHints:       Qt.ImhFormattedNumbersOnly
+    }
+
+    QGCLabel { text: qsTr("Latency (ms)") }
+    QGCTextField {
+        id:                     latencyField
+        Layout.preferredWidth:  _secondColumnWidth
+        text:                   subEditConfig.latencyMsecs.toString()
+        inputMethodHints:       Qt.ImhFormattedNumbersOnly
+    }
+
+    QGCLabel { text: qsTr("Latency Jitter (ms)") }
+    QGCTextField {
+        id:                     jitterField
+        Layout.preferredWidth:  _secondColumnWidth
+        text:                   subEditConfig.latencyJitterMsecs.toString()
+        inputMethodHints:       Qt.ImhFormattedNumbersOnly
+    }
+
+    QGCLabel { text: qsTr("Burst Interval (ms)") }
+    QGCTextField {
+        id:                     burstIntervalField
+        Layout.preferredWidth:  _secondColumnWidth
+        text:                   subEditConfig.burstIntervalMsecs.toString()
+        inputMethodHints:       Qt.ImhFormattedNumbersOnly
+    }
+
+    QGCLabel { text: qsTr("Burst Length (ms)") }
+    QGCTextField {
+        id:                     burstLengthField
+        Layout.preferredWidth:  _secondColumnWidth
+        text:                   subEditConfig.burstLengthMsecs.toString()
+        inputMethodHints:       Qt.ImhFormattedNumbersOnly
+    }
+
+    QGCLabel { text: qsTr("Random Seed") }
+    QGCTextField {
+        id:                     randomSeedField
+        Layout.preferredWidth:  _secondColumnWidth
+        text:                   subEditConfig.randomSeed.toString()
+        inputMethodHints:       Qt.ImhFormattedNumbersOnly
+    }
+}
@@ -34,6 +34,23 @@ SettingsPage {
     property bool   _videoSourceDisabled:       _videoSource === _videoSettings.disabledVideoSource
     property real   _urlFieldWidth:             ScreenTools.defaultFontPixelWidth * 40
     property bool   _requiresUDPUrl:            _isUDP264 || _isUDP265 || _isMPEGTS
+    property bool   _showLatency:               _isGST && _isStreamSource && _videoManager.streaming
+    property var    _latencyStats:              ({})
+
+    function _formatLatency(frames, p50, p99, max) {
+        if (!frames) {
+            return qsTr("No frames")
+        }
+        return qsTr("%1 / %2 / %3 ms").arg((p50 / 1000).toFixed(1)).arg((p99 / 1000).toFixed(1)).arg((max / 1000).toFixed(1))
+    }
+
+    Timer {
+        interval:           1000
+        running:            _showLatency
+        repeat:             true
+        triggeredOnStart:   true
+        onTriggered:        _latencyStats = _videoManager.latencyStats()
+    }
 
     SettingsGroupLayout {
         Layout.fillWidth:   true
@@ -106,6 +123,32 @@ SettingsPage {
             visible:            !_videoAutoStreamConfig && _isStreamSource && fact.visible && _isGST
         }
 
+        // p50 / p99 / max
+        LabelledLabel {
+            Layout.fillWidth:   true
+            label:              qsTr("Receive latency")
+            labelText:          _formatLatency(_latencyStats.receiveFrames, _latencyStats.receiveLatencyP50, _latencyStats.receiveLatencyP99, _latencyStats.receiveLatencyMax)
+            visible:            _showLatency
+        }
+
+        LabelledLabel {
+            Layout.fillWidth:   true
+            label:              qsTr("Receive to render latency")
+            labelText:          _formatLatency(_latencyStats.renderFrames, _latencyStats.renderLatencyP50, _latencyStats.renderLatencyP99, _latencyStats.renderLatencyMax)
+            visible:            _showLatency
+        }
+
+        LabelledButton {
+            Layout.fillWidth:   true
+            label:              qsTr("Latency statistics")
+            buttonText:         qsTr("Reset")
+            visible:            _showLatency
+            onClicked: {
+                _videoManager.resetLatencyStats()
+                _latencyStats = _videoManager.latencyStats()
+            }
+        }
+
         LabelledFactComboBox {
             Layout.fillWidth:   true
             label:              qsTr("Video decode priority")
@@ -126,6 +169,21 @@ SettingsPage {
             visible:            _videoSettings.recordingFormat.visible
         }
 
+        LabelledFactComboBox {
+            Layout.fillWidth:   true
+            label:              qsTr("Telemetry Subtitle Format")
+            fact:               _videoSettings.subtitleFormat
+            visible:            fact.visible
+        }
+
+        FactCheckBoxSlider {
+            Layout.fillWidth:   true
+            text:               qsTr("Embed Telemetry Track (mkv)")
+            fact:               _videoSettings.telemetryTrack
+            visible:            fact.visible && _isGST
+            enabled:            _videoSettings.recordingFormat.rawValue === 0
+        }
+
         FactCheckBoxSlider {
             Layout.fillWidth:   true
             text:               qsTr("Auto-Delete Saved Recordings")
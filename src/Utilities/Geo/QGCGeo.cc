@@ -19,12 +19,17 @@
 #include <GeographicLib/MGRS.hpp>
 #include <GeographicLib/UTMUPS.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
 
 QGC_LOGGING_CATEGORY(QGCGeoLog, "qgc.geo.qgcgeo")
 
 static constexpr double epsilon = std::numeric_limits<double>::epsilon();
 
+/// Same radius QGeoCoordinate uses for distanceTo so batch and scalar results agree
+static constexpr double earthMeanRadius = 6371007.2;
+
 namespace QGCGeo {
 
 void convertGeoToNed(const QGeoCoordinate &coord, const QGeoCoordinate &origin, double &x, double &y, double &z)
@@ -163,4 +168,171 @@ bool convertMGRSToGeo(const QString &mgrs, QGeoCoordinate &coord)
     return true;
 }
 
+CoordinateArrays::CoordinateArrays(const QList<QGeoCoordinate> &coords)
+{
+    resize(coords.count());
+    for (qsizetype i = 0; i < coords.count(); i++) {
+        latitudes[i] = coords[i].latitude();
+        longitudes[i] = coords[i].longitude();
+        altitudes[i] = coords[i].altitude();
+    }
+}
+
+void CoordinateArrays::resize(size_t count)
+{
+    latitudes.resize(count);
+    longitudes.resize(count);
+    altitudes.resize(count);
+}
+
+QList<QGeoCoordinate> CoordinateArrays::toCoordinates() const
+{
+    QList<QGeoCoordinate> coords;
+    coords.reserve(size());
+    for (size_t i = 0; i < size(); i++) {
+        coords.append(QGeoCoordinate(latitudes[i], longitudes[i], altitudes[i]));
+    }
+
+    return coords;
+}
+
+void convertGeoToNed(std::span<const double> latitudes, std::span<const double> longitudes, std::span<const double> altitudes,
+                     const QGeoCoordinate &origin,
+                     std::span<double> x, std::span<double> y, std::span<double> z)
+{
+    Q_ASSERT(longitudes.size() == latitudes.size() && altitudes.size() == latitudes.size());
+    Q_ASSERT(x.size() == latitudes.size() && y.size() == latitudes.size() && z.size() == latitudes.size());
+
+    const double ref_lon_rad = qDegreesToRadians(origin.longitude());
+    const double ref_lat_rad = qDegreesToRadians(origin.latitude());
+    const double ref_sin_lat = sin(ref_lat_rad);
+    const double ref_cos_lat = cos(ref_lat_rad);
+    const double ref_alt = origin.altitude();
+    const double a = GeographicLib::Constants::WGS84_a();
+
+    const size_t count = latitudes.size();
+    for (size_t i = 0; i < count; i++) {
+        const double lat_rad = qDegreesToRadians(latitudes[i]);
+        const double d_lon = qDegreesToRadians(longitudes[i]) - ref_lon_rad;
+
+        const double sin_lat = std::sin(lat_rad);
+        const double cos_lat = std::cos(lat_rad);
+        const double cos_d_lon = std::cos(d_lon);
+
+        // Clamping keeps rounding at the origin from producing acos(1 + e) = NaN
+        const double cos_c = std::clamp(ref_sin_lat * sin_lat + ref_cos_lat * cos_lat * cos_d_lon, -1.0, 1.0);
+        const double c = std::acos(cos_c);
+        const double sin_c = std::sin(c);
+        const double k = (c > epsilon) ? (c / sin_c) : 1.0;
+
+        x[i] = k * (ref_cos_lat * sin_lat - ref_sin_lat * cos_lat * cos_d_lon) * a;
+        y[i] = k * cos_lat * std::sin(d_lon) * a;
+        z[i] = -(altitudes[i] - ref_alt);
+    }
+}
+
+void convertNedToGeo(std::span<const double> x, std::span<const double> y, std::span<const double> z,
+                     const QGeoCoordinate &origin,
+                     std::span<double> latitudes, std::span<double> longitudes, std::span<double> altitudes)
+{
+    Q_ASSERT(y.size() == x.size() && z.size() == x.size());
+    Q_ASSERT(latitudes.size() == x.size() && longitudes.size() == x.size() && altitudes.size() == x.size());
+
+    const double ref_lon_rad = qDegreesToRadians(origin.longitude());
+    const double ref_lat_rad = qDegreesToRadians(origin.latitude());
+    const double ref_sin_lat = sin(ref_lat_rad);
+    const double ref_cos_lat = cos(ref_lat_rad);
+    const double ref_alt = origin.altitude();
+    const double a = GeographicLib::Constants::WGS84_a();
+
+    const size_t count = x.size();
+    for (size_t i = 0; i < count; i++) {
+        const double x_rad = x[i] / a;
+        const double y_rad = y[i] / a;
+        const double c = std::sqrt(x_rad * x_rad + y_rad * y_rad);
+        const double sin_c = std::sin(c);
+        const double cos_c = std::cos(c);
+
+        // sin(c) / c tends to 1 at the origin, where both formulas below then reduce to the origin itself.
+        // Scaling both atan2 arguments by 1 / c leaves the angle unchanged.
+        const double sinc = (c > epsilon) ? (sin_c / c) : 1.0;
+
+        latitudes[i] = qRadiansToDegrees(std::asin(cos_c * ref_sin_lat + x_rad * sinc * ref_cos_lat));
+        longitudes[i] = qRadiansToDegrees(ref_lon_rad + std::atan2(y_rad * sinc, ref_cos_lat * cos_c - x_rad * ref_sin_lat * sinc));
+        altitudes[i] = -z[i] + ref_alt;
+    }
+}
+
+int convertGeoToUTM(std::span<const double> latitudes, std::span<const double> longitudes,
+                    std::span<double> eastings, std::span<double> northings)
+{
+    Q_ASSERT(longitudes.size() == latitudes.size());
+    Q_ASSERT(eastings.size() == latitudes.size() && northings.size() == latitudes.size());
+
+    if (latitudes.empty()) {
+        return 0;
+    }
+
+    try {
+        int zone;
+        bool northp;
+        GeographicLib::UTMUPS::Forward(latitudes[0], longitudes[0], zone, northp, eastings[0], northings[0]);
+
+        for (size_t i = 1; i < latitudes.size(); i++) {
+            int pointZone;
+            bool pointNorthp;
+            GeographicLib::UTMUPS::Forward(latitudes[i], longitudes[i], pointZone, pointNorthp, eastings[i], northings[i], zone);
+            if (pointNorthp != northp) {
+                // Move the false northing into the hemisphere of the first point
+                northings[i] += (northp ? -1.0 : 1.0) * GeographicLib::UTMUPS::UTMShift();
+            }
+        }
+
+        return zone;
+    } catch(const GeographicLib::GeographicErr& e) {
+        qCDebug(QGCGeoLog) << Q_FUNC_INFO << e.what();
+        return 0;
+    }
+}
+
+void haversineDistance(std::span<const double> fromLatitudes, std::span<const double> fromLongitudes,
+                       std::span<const double> toLatitudes, std::span<const double> toLongitudes,
+                       std::span<double> distances)
+{
+    Q_ASSERT(fromLongitudes.size() == fromLatitudes.size());
+    Q_ASSERT(toLatitudes.size() == fromLatitudes.size() && toLongitudes.size() == fromLatitudes.size());
+    Q_ASSERT(distances.size() == fromLatitudes.size());
+
+    const size_t count = fromLatitudes.size();
+    for (size_t i = 0; i < count; i++) {
+        const double haversine_dlat = std::sin(qDegreesToRadians(toLatitudes[i] - fromLatitudes[i]) / 2.0);
+        const double haversine_dlon = std::sin(qDegreesToRadians(toLongitudes[i] - fromLongitudes[i]) / 2.0);
+        const double h = haversine_dlat * haversine_dlat
+                       + std::cos(qDegreesToRadians(fromLatitudes[i])) * std::cos(qDegreesToRadians(toLatitudes[i])) * haversine_dlon * haversine_dlon;
+
+        distances[i] = 2.0 * std::asin(std::sqrt(h)) * earthMeanRadius;
+    }
+}
+
+void haversineAzimuth(std::span<const double> fromLatitudes, std::span<const double> fromLongitudes,
+                      std::span<const double> toLatitudes, std::span<const double> toLongitudes,
+                      std::span<double> azimuths)
+{
+    Q_ASSERT(fromLongitudes.size() == fromLatitudes.size());
+    Q_ASSERT(toLatitudes.size() == fromLatitudes.size() && toLongitudes.size() == fromLatitudes.size());
+    Q_ASSERT(azimuths.size() == fromLatitudes.size());
+
+    const size_t count = fromLatitudes.size();
+    for (size_t i = 0; i < count; i++) {
+        const double d_lon = qDegreesToRadians(toLongitudes[i] - fromLongitudes[i]);
+        const double lat1_rad = qDegreesToRadians(fromLatitudes[i]);
+        const double lat2_rad = qDegreesToRadians(toLatitudes[i]);
+
+        const double y = std::sin(d_lon) * std::cos(lat2_rad);
+        const double x = std::cos(lat1_rad) * std::sin(lat2_rad) - std::sin(lat1_rad) * std::cos(lat2_rad) * std::cos(d_lon);
+
+        azimuths[i] = std::fmod(qRadiansToDegrees(std::atan2(y, x)) + 360.0, 360.0);
+    }
+}
+
 } // namespace QGCGeo
@@ -18,8 +18,12 @@
 #pragma once
 
 #include <QtPositioning/QGeoCoordinate>
+#include <QtCore/QList>
 #include <QtCore/QLoggingCategory>
 
+#include <span>
+#include <vector>
+
 Q_DECLARE_LOGGING_CATEGORY(QGCGeoLog)
 
 namespace QGCGeo {
@@ -109,4 +113,65 @@ QString convertGeoToMGRS(const QGeoCoordinate &coord);
 // The function returns true if conversion succeeded.
 bool convertMGRSToGeo(const QString &mgrs, QGeoCoordinate &coord);
 
+/**
+ * @brief Struct of arrays coordinate storage for the batch conversions below.
+ * Latitude/longitude are in degrees, altitude in meters.
+ */
+struct CoordinateArrays
+{
+    CoordinateArrays() = default;
+    explicit CoordinateArrays(const QList<QGeoCoordinate> &coords);
+
+    void resize(size_t count);
+    size_t size() const { return latitudes.size(); }
+    QList<QGeoCoordinate> toCoordinates() const;
+
+    std::vector<double> latitudes;
+    std::vector<double> longitudes;
+    std::vector<double> altitudes;
+};
+
+/// @name Batch conversions
+/// Versions of the conversions above which work on struct of arrays spans for large coordinate sets. All spans
+/// passed to a single call must be the same size. Origin dependent terms are computed once per call and the loop
+/// bodies are branch free so the compiler can vectorize them.
+/// @{
+
+/**
+ * @brief Batch version of convertGeoToNed. Unlike the scalar version a point at the origin needs no special
+ * handling, it is converted to (0, 0, -altitude offset).
+ */
+void convertGeoToNed(std::span<const double> latitudes, std::span<const double> longitudes, std::span<const double> altitudes,
+                     const QGeoCoordinate &origin,
+                     std::span<double> x, std::span<double> y, std::span<double> z);
+
+/// @brief Batch version of convertNedToGeo.
+void convertNedToGeo(std::span<const double> x, std::span<const double> y, std::span<const double> z,
+                     const QGeoCoordinate &origin,
+                     std::span<double> latitudes, std::span<double> longitudes, std::span<double> altitudes);
+
+/**
+ * @brief Batch version of convertGeoToUTM. All points are projected into the zone and hemisphere of the first
+ * point so the results can be used together as a single planar set.
+ * @return The UTM zone used, 0 if conversion failed.
+ */
+int convertGeoToUTM(std::span<const double> latitudes, std::span<const double> longitudes,
+                    std::span<double> eastings, std::span<double> northings);
+
+/**
+ * @brief Great circle distance in meters between each pair of points, matching QGeoCoordinate::distanceTo.
+ */
+void haversineDistance(std::span<const double> fromLatitudes, std::span<const double> fromLongitudes,
+                       std::span<const double> toLatitudes, std::span<const double> toLongitudes,
+                       std::span<double> distances);
+
+/**
+ * @brief Initial azimuth in degrees [0, 360) from each from point to its to point, matching QGeoCoordinate::azimuthTo.
+ */
+void haversineAzimuth(std::span<const double> fromLatitudes, std::span<const double> fromLongitudes,
+                      std::span<const double> toLatitudes, std::span<const double> toLongitudes,
+                      std::span<double> azimuths);
+
+/// @}
+
 } // namespace QGCGeo
@@ -14,9 +14,17 @@
 #include "SettingsManager.h"
 
 #include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
 #include <QtCore/QGlobalStatic>
-#include <QtCore/QStringListModel>
+#include <QtCore/QSaveFile>
 #include <QtCore/QTextStream>
+#include <QtCore/QThread>
+#include <QtCore/QTimer>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 
 QGC_LOGGING_CATEGORY(QGCLoggingLog, "qgc.utilities.qgclogging")
 
@@ -43,14 +51,18 @@ Q_GLOBAL_STATIC(QGCLogging, _qgcLogging)
 
 static QtMessageHandler defaultHandler = nullptr;
 
-static void msgHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg)
+static const std::chrono::steady_clock::time_point processStart = std::chrono::steady_clock::now();
+
+static qint64 processMsecs()
 {
-    // Format the message using Qt's pattern
-    const QString message = qFormatLogMessage(type, context, msg);
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - processStart).count();
+}
 
+static void msgHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg)
+{
     // Filter out Qt Quick internals
-    if (!QString(context.category).startsWith("qt.quick")) {
-        QGCLogging::instance()->log(message);
+    if (!_qgcLogging.isDestroyed() && !(context.category && (strncmp(context.category, "qt.quick", 8) == 0))) {
+        QGCLogging::instance()->log(type, context, msg);
     }
 
     // Call the previous handler if it exists
@@ -59,32 +71,62 @@ static void msgHandler(QtMsgType type, const QMessageLogContext &context, const
     }
 }
 
+/// Reduces a function signature to the qualified name, as %{function} in the message pattern does
+static QLatin1StringView functionName(const QByteArray &function)
+{
+    if (function.isEmpty()) {
+        return QLatin1StringView();
+    }
+
+    QLatin1StringView name(function);
+    const qsizetype parameters = name.indexOf(QLatin1Char('('));
+    if (parameters > 0) {
+        name = name.first(parameters);
+    }
+    const qsizetype returnType = name.lastIndexOf(QLatin1Char(' '));
+    if (returnType >= 0) {
+        name = name.sliced(returnType + 1);
+    }
+    while (name.startsWith(QLatin1Char('*')) || name.startsWith(QLatin1Char('&'))) {
+        name = name.sliced(1);
+    }
+
+    return name;
+}
+
 QGCLogging *QGCLogging::instance()
 {
     return _qgcLogging();
 }
 
 QGCLogging::QGCLogging(QObject *parent)
-    : QStringListModel(parent)
+    : QAbstractListModel(parent)
+    , _writer(new QGCLogWriter(this))
+    , _writerThread(new QThread(this))
 {
     qCDebug(QGCLoggingLog) << this;
 
-    _flushTimer.setInterval(kFlushIntervalMSecs);
-    _flushTimer.setSingleShot(false);
-    (void) connect(&_flushTimer, &QTimer::timeout, this, &QGCLogging::_flushToDisk);
-    _flushTimer.start();
+    _writerThread->setObjectName("QGCLogging");
+    _writer->moveToThread(_writerThread);
+    (void) connect(_writerThread, &QThread::started, _writer, &QGCLogWriter::start);
+    (void) connect(_writer, &QGCLogWriter::ioError, this, [](const QString &message) {
+        if (qgcApp()) {
+            qgcApp()->showAppMessage(message);
+        }
+    });
 
-    // Connect the emitLog signal to threadsafeLog slot
-#if defined(Q_OS_ANDROID) || defined(Q_OS_IOS)
-    const Qt::ConnectionType conntype = Qt::QueuedConnection;
-#else
-    const Qt::ConnectionType conntype = Qt::AutoConnection;
-#endif
-    (void) connect(this, &QGCLogging::emitLog, this, &QGCLogging::_threadsafeLog, conntype);
+    // Write out whatever is left while the application is still around to receive it
+    if (QCoreApplication::instance()) {
+        (void) connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit, this, &QGCLogging::_shutdown);
+    }
+
+    _writerThread->start();
 }
 
 QGCLogging::~QGCLogging()
 {
+    _shutdown();
+
     qCDebug(QGCLoggingLog) << this;
 }
 
@@ -98,140 +140,239 @@ void QGCLogging::installHandler(bool quietWindowsAsserts)
     Q_UNUSED(quietWindowsAsserts)
 #endif
 
-    // Define the format for qDebug/qWarning/etc output
+    // Define the format for qDebug/qWarning/etc output, formatRecord must match
     qSetMessagePattern(QStringLiteral("%{category}:: %{time process} - %{type}: %{message} (%{function}:%{line})"));
 
     // Install our custom handler
     defaultHandler = qInstallMessageHandler(msgHandler);
 }
 
-void QGCLogging::log(const QString &message)
+QString QGCLogging::formatRecord(const Record_t &record)
 {
-    // Emit the signal so threadsafeLog runs in the correct thread
-    if (!_ioError) {
-        emit emitLog(message);
+    QLatin1StringView type;
+    switch (record.type) {
+    case QtDebugMsg:
+        type = QLatin1StringView("debug");
+        break;
+    case QtInfoMsg:
+        type = QLatin1StringView("info");
+        break;
+    case QtWarningMsg:
+        type = QLatin1StringView("warning");
+        break;
+    case QtCriticalMsg:
+        type = QLatin1StringView("critical");
+        break;
+    case QtFatalMsg:
+        type = QLatin1StringView("fatal");
+        break;
     }
+
+    const QString time = QString::asprintf("%6d.%03d", static_cast<int>(record.msecs / 1000), static_cast<int>(record.msecs % 1000));
+
+    return QStringLiteral("%1:: %2 - %3: %4 (%5:%6)")
+        .arg(QLatin1StringView(record.category), time, type, record.message, functionName(record.function))
+        .arg(record.line);
 }
 
-void QGCLogging::_threadsafeLog(const QString &message)
+QGCLogging::ThreadBuffer *QGCLogging::_threadBuffer()
 {
-    // Notify view of new row
-    const int line = rowCount();
-    beginInsertRows(QModelIndex(), line, line);
-    (void) QStringListModel::insertRows(line, 1);
-    (void) setData(index(line, 0), message, Qt::DisplayRole);
-    endInsertRows();
+    static thread_local ThreadBuffer *threadBuffer = nullptr;
+    static thread_local bool threadExited = false;
+
+    // Hands the buffer over to the writer for removal once it has been emptied
+    struct Owner {
+        ~Owner() {
+            if (buffer) {
+                buffer->orphaned.store(true, std::memory_order_release);
+            }
+            threadBuffer = nullptr;
+            threadExited = true;
+        }
 
-    // Trim old entries to cap memory usage
-    static constexpr const int kMaxLogRows = kMaxLogFileSize / 100;
-    if (rowCount() > kMaxLogRows) {
-        const int removeCount = rowCount() - kMaxLogRows;
-        beginRemoveRows(QModelIndex(), 0, removeCount - 1);
-        (void) removeRows(0, removeCount);
-        endRemoveRows();
+        std::shared_ptr<ThreadBuffer> buffer;
+    };
+
+    if (threadBuffer) {
+        return threadBuffer;
+    }
+
+    // Messages logged while the thread is being torn down are not kept
+    if (threadExited) {
+        return nullptr;
     }
 
-    // Queue for disk flush
-    _pendingDiskWrites.append(message);
+    static thread_local Owner owner;
+    owner.buffer = std::make_shared<ThreadBuffer>();
+    threadBuffer = owner.buffer.get();
+
+    QMutexLocker lock(&_threadBuffersMutex);
+    _threadBuffers.append(owner.buffer);
+
+    return threadBuffer;
 }
 
-void QGCLogging::_rotateLogs()
+void QGCLogging::log(QtMsgType type, const QMessageLogContext &context, const QString &message)
 {
-    // Close the current log
-    _logFile.close();
+    ThreadBuffer *const buffer = _threadBuffer();
+    if (!buffer) {
+        return;
+    }
 
-    // Full path without extension
-    const QString basePath = _logFile.fileName();    // e.g. "/path/QGCConsole.log"
-    const QFileInfo fileInfo(basePath);
-    const QString dir = fileInfo.absolutePath();
-    const QString name = fileInfo.baseName();        // "QGCConsole"
-    const QString ext = fileInfo.completeSuffix();   // "log"
+    const quint32 head = buffer->head.load(std::memory_order_relaxed);
+    if ((head - buffer->tail.load(std::memory_order_acquire)) >= kThreadBufferSize) {
+        // Never block the logging thread, the writer reports how many were lost
+        (void) buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
 
-    // Rotate existing backups: QGCConsole.4.log → QGCConsole.5.log, …
-    for (int i = kMaxBackupFiles - 1; i >= 1; --i) {
-        const QString from = QStringLiteral("%1/%2.%3.%4").arg(dir, name).arg(i).arg(ext);
-        const QString to = QStringLiteral("%1/%2.%3.%4").arg(dir, name).arg(i+1).arg(ext);
-        if (QFile::exists(to)) {
-            (void) QFile::remove(to);
+    Record_t &record = buffer->records[head % kThreadBufferSize];
+    record.msecs = processMsecs();
+    record.type = type;
+    record.category = context.category ? QByteArray(context.category) : QByteArrayLiteral("default");
+    record.function = QByteArray(context.function);
+    record.line = context.line;
+    record.message = message;
+
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+QList<QGCLogging::Record_t> QGCLogging::_takeRecords()
+{
+    QList<Record_t> records;
+
+    QMutexLocker lock(&_threadBuffersMutex);
+
+    for (auto it = _threadBuffers.begin(); it != _threadBuffers.end();) {
+        ThreadBuffer *const buffer = it->get();
+
+        // Read before head, so an orphaned buffer is known to be empty once this pass is done with it
+        const bool orphaned = buffer->orphaned.load(std::memory_order_acquire);
+
+        const quint32 head = buffer->head.load(std::memory_order_acquire);
+        quint32 tail = buffer->tail.load(std::memory_order_relaxed);
+        for (; tail != head; ++tail) {
+            records.append(std::move(buffer->records[tail % kThreadBufferSize]));
         }
-        if (QFile::exists(from)) {
-            (void) QFile::rename(from, to);
+        buffer->tail.store(tail, std::memory_order_release);
+
+        const quint32 dropped = buffer->dropped.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+            records.append({
+                processMsecs(),
+                QtWarningMsg,
+                QByteArray(QGCLoggingLog().categoryName()),
+                QByteArray(),
+                0,
+                QStringLiteral("%1 log messages dropped, thread buffer full").arg(dropped)
+            });
+        }
+
+        if (orphaned) {
+            it = _threadBuffers.erase(it);
+        } else {
+            ++it;
         }
     }
 
-    // Move the just‐closed log to “.1”
-    const QString firstBackup = QStringLiteral("%1/%2.1.%3").arg(dir, name, ext);
-    if (QFile::exists(firstBackup)) {
-        (void) QFile::remove(firstBackup);
+    lock.unlock();
+
+    // Each thread's records are already in order, interleave the threads
+    std::stable_sort(records.begin(), records.end(), [](const Record_t &a, const Record_t &b) {
+        return a.msecs < b.msecs;
+    });
+
+    return records;
+}
+
+void QGCLogging::_appendRecords(const QList<QGCLogging::Record_t> &records)
+{
+    if (!_logFileResolved) {
+        _openLogFile();
     }
-    (void) QFile::rename(basePath, firstBackup);
 
-    // Re‑open a fresh log file
-    _logFile.setFileName(basePath);
-    if (!_logFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
-        _ioError = true;
-        qgcApp()->showAppMessage(tr("Unable to reopen log file %1: %2").arg(_logFile.fileName(), _logFile.errorString()));
+    const int first = static_cast<int>(_records.size());
+    beginInsertRows(QModelIndex(), first, first + static_cast<int>(records.size()) - 1);
+    _records.append(records);
+    endInsertRows();
+
+    // Trim old entries to cap memory usage
+    if (_records.size() > kMaxLogRows) {
+        const int removeCount = static_cast<int>(_records.size()) - kMaxLogRows;
+        beginRemoveRows(QModelIndex(), 0, removeCount - 1);
+        _records.remove(0, removeCount);
+        endRemoveRows();
     }
 }
 
-void QGCLogging::_flushToDisk()
+void QGCLogging::_openLogFile()
 {
-    if (_pendingDiskWrites.isEmpty() || _ioError) {
+    // Settings are not available until the application is up, the writer holds on to the records until then
+    if (!qgcApp()) {
         return;
     }
+    _logFileResolved = true;
 
-    // Ensure log output enabled and file open
-    if (!_logFile.isOpen()) {
-        if (!qgcApp()->logOutput()) {
-            _pendingDiskWrites.clear();
-            return;
-        }
+    QString fileName;
+    if (qgcApp()->logOutput()) {
+        const QDir saveDir(SettingsManager::instance()->appSettings()->crashSavePath());
+        fileName = saveDir.absoluteFilePath("QGCConsole.log");
+    }
 
-        const QString saveDirPath = SettingsManager::instance()->appSettings()->crashSavePath();
-        const QDir saveDir(saveDirPath);
-        const QString saveFilePath = saveDir.absoluteFilePath("QGCConsole.log");
+    QGCLogWriter *const writer = _writer;
+    (void) QMetaObject::invokeMethod(writer, [writer, fileName]() {
+        writer->setLogFile(fileName);
+    });
+}
 
-        _logFile.setFileName(saveFilePath);
-        if (!_logFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
-            _ioError = true;
-            qgcApp()->showAppMessage(tr("Open console log output file failed %1 : %2").arg(_logFile.fileName(), _logFile.errorString()));
-            return;
-        }
+void QGCLogging::_shutdown()
+{
+    if (!_writer) {
+        return;
     }
 
-    // Check size before writing
-    if (_logFile.size() >= kMaxLogFileSize) {
-        _rotateLogs();
-    }
-
-    // Write all pending lines
-    QTextStream out(&_logFile);
-    for (const QString &line : std::as_const(_pendingDiskWrites)) {
-        out << line << '\n';
-        if (out.status() != QTextStream::Ok) {
-            _ioError = true;
-            qCWarning(QGCLoggingLog) << "Error writing to log file:" << _logFile.errorString();
-            break;
-        }
+    // Queued behind anything already posted to the writer, so the last records still make it to disk
+    QGCLogWriter *const writer = _writer;
+    QThread *const writerThread = _writerThread;
+    (void) QMetaObject::invokeMethod(writer, [writer, writerThread]() {
+        writer->stop();
+        writerThread->quit();
+    });
+    (void) _writerThread->wait();
+
+    delete _writer;
+    _writer = nullptr;
+}
+
+int QGCLogging::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(_records.size());
+}
+
+QVariant QGCLogging::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || (index.row() >= _records.size()) || (role != Qt::DisplayRole)) {
+        return QVariant();
     }
-    (void) _logFile.flush();
-    _pendingDiskWrites.clear();
+
+    // Only rows a view actually shows are ever formatted
+    return formatRecord(_records.at(index.row()));
 }
 
 void QGCLogging::writeMessages(const QString &destFile)
 {
-    // Snapshot current logs on GUI thread
-    const QStringList logs = stringList();
+    // Snapshot current logs on GUI thread, formatting happens on the worker
+    const QList<Record_t> records = _records;
 
     // Run the file write in a separate thread
-    (void) QtConcurrent::run([this, destFile, logs]() {
+    (void) QtConcurrent::run([this, destFile, records]() {
         emit writeStarted();
         bool success = false;
         QSaveFile file(destFile);
         if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
             QTextStream out(&file);
-            for (const QString &line : logs) {
-                out << line << '\n';
+            for (const Record_t &record : records) {
+                out << formatRecord(record) << '\n';
             }
             success = ((out.status() == QTextStream::Ok) && file.commit());
         } else {
@@ -240,3 +381,156 @@ void QGCLogging::writeMessages(const QString &destFile)
         emit writeFinished(success);
     });
 }
+
+/*===========================================================================*/
+
+QGCLogWriter::QGCLogWriter(QGCLogging *logging)
+    : QObject(nullptr)
+    , _logging(logging)
+{
+    // qCDebug(QGCLoggingLog) << Q_FUNC_INFO << this;
+}
+
+QGCLogWriter::~QGCLogWriter()
+{
+    // qCDebug(QGCLoggingLog) << Q_FUNC_INFO << this;
+}
+
+void QGCLogWriter::start()
+{
+    _timer = new QTimer(this);
+    _timer->setInterval(QGCLogging::kWriteIntervalMSecs);
+    _timer->setSingleShot(false);
+    (void) connect(_timer, &QTimer::timeout, this, &QGCLogWriter::_write);
+    _timer->start();
+}
+
+void QGCLogWriter::stop()
+{
+    if (_timer) {
+        _timer->stop();
+    }
+
+    _write();
+
+    if (_logFile.isOpen()) {
+        _logFile.close();
+    }
+}
+
+void QGCLogWriter::setLogFile(const QString &fileName)
+{
+    if (fileName.isEmpty()) {
+        _logFileState = LogFileDisabled;
+        _pendingRecords.clear();
+        return;
+    }
+
+    _logFile.setFileName(fileName);
+    if (!_logFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        _logFileState = LogFileError;
+        _pendingRecords.clear();
+        emit ioError(tr("Open console log output file failed %1 : %2").arg(_logFile.fileName(), _logFile.errorString()));
+        return;
+    }
+    _logFileState = LogFileOpen;
+
+    const QList<QGCLogging::Record_t> pendingRecords = std::move(_pendingRecords);
+    _pendingRecords.clear();
+    _writeToDisk(pendingRecords);
+}
+
+void QGCLogWriter::_write()
+{
+    const QList<QGCLogging::Record_t> records = _logging->_takeRecords();
+    if (records.isEmpty()) {
+        return;
+    }
+
+    _writeToDisk(records);
+
+    // A single model update for everything collected in this pass
+    QGCLogging *const logging = _logging;
+    (void) QMetaObject::invokeMethod(logging, [logging, records]() {
+        logging->_appendRecords(records);
+    });
+}
+
+void QGCLogWriter::_writeToDisk(const QList<QGCLogging::Record_t> &records)
+{
+    switch (_logFileState) {
+    case LogFileUnknown:
+        _pendingRecords.append(records);
+        if (_pendingRecords.size() > QGCLogging::kMaxLogRows) {
+            _pendingRecords.remove(0, _pendingRecords.size() - QGCLogging::kMaxLogRows);
+        }
+        return;
+    case LogFileDisabled:
+    case LogFileError:
+        return;
+    case LogFileOpen:
+        break;
+    }
+
+    if (records.isEmpty()) {
+        return;
+    }
+
+    // Check size before writing
+    if ((_logFile.size() >= QGCLogging::kMaxLogFileSize) && !_rotateLogs()) {
+        return;
+    }
+
+    QByteArray text;
+    for (const QGCLogging::Record_t &record : records) {
+        text += QGCLogging::formatRecord(record).toUtf8();
+        text += '\n';
+    }
+
+    if ((_logFile.write(text) != text.size()) || !_logFile.flush()) {
+        _logFileState = LogFileError;
+        qCWarning(QGCLoggingLog) << "Error writing to log file:" << _logFile.errorString();
+    }
+}
+
+bool QGCLogWriter::_rotateLogs()
+{
+    // Close the current log
+    _logFile.close();
+
+    // Full path without extension
+    const QString basePath = _logFile.fileName();    // e.g. "/path/QGCConsole.log"
+    const QFileInfo fileInfo(basePath);
+    const QString dir = fileInfo.absolutePath();
+    const QString name = fileInfo.baseName();        // "QGCConsole"
+    const QString ext = fileInfo.completeSuffix();   // "log"
+
+    // Rotate existing backups: QGCConsole.4.log → QGCConsole.5.log, …
+    for (int i = QGCLogging::kMaxBackupFiles - 1; i >= 1; --i) {
+        const QString from = QStringLiteral("%1/%2.%3.%4").arg(dir, name).arg(i).arg(ext);
+        const QString to = QStringLiteral("%1/%2.%3.%4").arg(dir, name).arg(i+1).arg(ext);
+        if (QFile::exists(to)) {
+            (void) QFile::remove(to);
+        }
+        if (QFile::exists(from)) {
+            (void) QFile::rename(from, to);
+        }
+    }
+
+    // Move the just‐closed log to “.1”
+    const QString firstBackup = QStringLiteral("%1/%2.1.%3").arg(dir, name, ext);
+    if (QFile::exists(firstBackup)) {
+        (void) QFile::remove(firstBackup);
+    }
+    (void) QFile::rename(basePath, firstBackup);
+
+    // Re‑open a fresh log file
+    _logFile.setFileName(basePath);
+    if (!_logFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        _logFileState = LogFileError;
+        emit ioError(tr("Unable to reopen log file %1: %2").arg(_logFile.fileName(), _logFile.errorString()));
+        return false;
+    }
+
+    return true;
+}
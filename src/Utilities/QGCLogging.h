@@ -9,18 +9,41 @@
 
 #pragma once
 
+#include <QtCore/QAbstractListModel>
 #include <QtCore/QFile>
+#include <QtCore/QList>
 #include <QtCore/QLoggingCategory>
-#include <QtCore/QStringListModel>
-#include <QtCore/QTimer>
+#include <QtCore/QMutex>
+
+#include <array>
+#include <atomic>
+#include <memory>
+
+class QGCLogWriter;
+class QThread;
+class QTimer;
 
 Q_DECLARE_LOGGING_CATEGORY(QGCLoggingLog)
 
-class QGCLogging : public QStringListModel
+/// Application log. The message handler only copies each message into a buffer owned by the logging thread, no
+/// locks, no formatting and no signals. A writer thread collects the buffers, writes the log file and rotates it,
+/// then hands the records to this model in batches. Records are kept unformatted and only turned into text when
+/// a view asks for a row or the log is saved.
+class QGCLogging : public QAbstractListModel
 {
     Q_OBJECT
 
 public:
+    /// Compact log record, formatted only when it is displayed or written out
+    typedef struct {
+        qint64 msecs;           ///< Since process start
+        QtMsgType type;
+        QByteArray category;    ///< Copied, QML messages pass context strings which don't outlive the call
+        QByteArray function;
+        int line;
+        QString message;
+    } Record_t;
+
     explicit QGCLogging(QObject *parent = nullptr);
     ~QGCLogging();
 
@@ -30,38 +53,94 @@ class QGCLogging : public QStringListModel
     /// Install Qt message handler to route logs through this class
     static void installHandler(bool quietWindowsAsserts);
 
+    /// Formats the record the same way the message pattern set by installHandler does
+    static QString formatRecord(const Record_t &record);
+
     /// Write current log messages to a file asynchronously
     Q_INVOKABLE void writeMessages(const QString &destFile);
 
-    /// Enqueue a log message (thread-safe)
-    void log(const QString &message);
+    /// Queue a log message (thread-safe, lock free)
+    void log(QtMsgType type, const QMessageLogContext &context, const QString &message);
 
-signals:
-    /// Emitted when a log message is enqueued
-    void emitLog(const QString &message);
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    static constexpr int kThreadBufferSize = 1024;  ///< Records each thread can queue between two writer passes
+    static constexpr int kMaxLogRows = 100000;
+    static constexpr int kMaxLogFileSize = 10LL * 1024 * 1024;
+    static constexpr int kMaxBackupFiles = 5;
+    static constexpr int kWriteIntervalMSecs = 50;
 
+signals:
     /// Emitted when file write starts
     void writeStarted();
 
     /// Emitted when file write finishes (success flag)
     void writeFinished(bool success);
 
-private slots:
-    /// Internal slot to append message on the GUI/main thread
-    void _threadsafeLog(const QString &message);
+private:
+    /// Single producer, single consumer ring. Only the thread which owns it pushes, only the writer thread takes.
+    struct ThreadBuffer {
+        std::array<Record_t, kThreadBufferSize> records{};
+        std::atomic<quint32> head = 0;      ///< Next slot the owning thread fills
+        std::atomic<quint32> tail = 0;      ///< Next slot the writer thread takes
+        std::atomic<quint32> dropped = 0;   ///< Records lost to a full ring since the last pass
+        std::atomic_bool orphaned = false;  ///< Owning thread has exited
+    };
 
-    /// Periodic flush of pending log lines to disk
-    void _flushToDisk();
+    ThreadBuffer *_threadBuffer();
+    void _appendRecords(const QList<QGCLogging::Record_t> &records);
+    void _openLogFile();
+    void _shutdown();
 
-private:
-    void _rotateLogs();
+    /// Writer thread only. Empties the thread buffers, oldest record first.
+    QList<Record_t> _takeRecords();
 
-    QFile _logFile;
-    QTimer _flushTimer;
-    QStringList _pendingDiskWrites;
-    bool _ioError = false;
+    QMutex _threadBuffersMutex;     ///< Only taken the first time a thread logs, and by the writer
+    QList<std::shared_ptr<ThreadBuffer>> _threadBuffers;
 
-    static constexpr int kMaxLogFileSize = 10LL * 1024 * 1024;
-    static constexpr int kMaxBackupFiles = 5;
-    static constexpr int kFlushIntervalMSecs = 1000;
+    QList<Record_t> _records;
+    bool _logFileResolved = false;
+
+    QGCLogWriter *_writer = nullptr;
+    QThread *_writerThread = nullptr;
+
+    friend class QGCLogWriter;
+};
+
+/// Collects the records from the thread buffers, writes them to the log file and passes them on to QGCLogging.
+/// Lives on the QGCLogging writer thread.
+class QGCLogWriter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit QGCLogWriter(QGCLogging *logging);
+    ~QGCLogWriter();
+
+    void start();
+    void stop();
+
+    /// @param fileName Empty to disable writing the log to disk
+    void setLogFile(const QString &fileName);
+
+signals:
+    void ioError(const QString &message);
+
+private:
+    void _write();
+    void _writeToDisk(const QList<QGCLogging::Record_t> &records);
+    bool _rotateLogs();
+
+    QGCLogging *_logging = nullptr;
+    QTimer *_timer = nullptr;
+
+    enum {
+        LogFileUnknown,     ///< Not resolved yet, records are held in _pendingRecords
+        LogFileDisabled,
+        LogFileOpen,
+        LogFileError
+    } _logFileState = LogFileUnknown;
+    QFile _logFile;
+    QList<QGCLogging::Record_t> _pendingRecords;
 };
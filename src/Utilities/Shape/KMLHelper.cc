@@ -10,56 +10,152 @@
 #include "KMLHelper.h"
 
 #include <QtCore/QFile>
-#include <QtXml/QDomDocument>
+#include <QtCore/QXmlStreamReader>
+
+#include <algorithm>
 
 namespace KMLHelper
 {
-    QDomDocument _loadFile(const QString &kmlFile, QString &errorString);
+    bool _openFile(QFile &file, QString &errorString);
+
+    /// Reads forward to the next start element with the specified name, anywhere in the document
+    ///     @return false: not found or the xml is not well formed
+    bool _findElement(QXmlStreamReader &xml, QStringView name);
+
+    /// Reads down through the child elements named in path, starting from the current element. Like
+    /// QDomNode::namedItem only direct children are matched and the first match is used.
+    ///     @return false: not found or the xml is not well formed
+    bool _findChildPath(QXmlStreamReader &xml, const QStringList &path);
+
+    /// Parses the text of a coordinates element: whitespace separated "lon,lat[,alt]" tuples
+    bool _parseCoordinates(QStringView text, QList<QGeoCoordinate> &coords, QString &errorString);
+
+    bool _xmlError(const QXmlStreamReader &xml, const QString &kmlFile, QString &errorString);
 
     constexpr const char *_errorPrefix = QT_TR_NOOP("KML file load failed. %1");
 }
 
-QDomDocument KMLHelper::_loadFile(const QString &kmlFile, QString &errorString)
+bool KMLHelper::_openFile(QFile &file, QString &errorString)
 {
     errorString.clear();
 
-    QFile file(kmlFile);
     if (!file.exists()) {
-        errorString = QString(_errorPrefix).arg(QString(QT_TRANSLATE_NOOP("KML", "File not found: %1")).arg(kmlFile));
-        return QDomDocument();
+        errorString = QString(_errorPrefix).arg(QString(QT_TRANSLATE_NOOP("KML", "File not found: %1")).arg(file.fileName()));
+        return false;
     }
 
     if (!file.open(QIODevice::ReadOnly)) {
-        errorString = QString(_errorPrefix).arg(QString(QT_TRANSLATE_NOOP("KML", "Unable to open file: %1 error: $%2")).arg(kmlFile).arg(file.errorString()));
-        return QDomDocument();
+        errorString = QString(_errorPrefix).arg(QString(QT_TRANSLATE_NOOP("KML", "Unable to open file: %1 error: $%2")).arg(file.fileName()).arg(file.errorString()));
+        return false;
+    }
+
+    return true;
+}
+
+bool KMLHelper::_xmlError(const QXmlStreamReader &xml, const QString &kmlFile, QString &errorString)
+{
+    if (!xml.hasError()) {
+        return false;
+    }
+
+    errorString = QString(_errorPrefix).arg(QString(QT_TRANSLATE_NOOP("KML", "Unable to parse KML file: %1 error: %2 line: %3")).arg(kmlFile).arg(xml.errorString()).arg(xml.lineNumber()));
+    return true;
+}
+
+bool KMLHelper::_findElement(QXmlStreamReader &xml, QStringView name)
+{
+    while (!xml.atEnd()) {
+        if ((xml.readNext() == QXmlStreamReader::StartElement) && (xml.name() == name)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool KMLHelper::_findChildPath(QXmlStreamReader &xml, const QStringList &path)
+{
+    for (const QString &name : path) {
+        bool found = false;
+        while (xml.readNextStartElement()) {
+            if (xml.name() == name) {
+                found = true;
+                break;
+            }
+            xml.skipCurrentElement();
+        }
+        if (!found) {
+            return false;
+        }
     }
 
-    QDomDocument doc;
-    const QDomDocument::ParseResult result = doc.setContent(&file, QDomDocument::ParseOption::Default);
-    if (!result) {
-        errorString = QString(_errorPrefix).arg(QString(QT_TRANSLATE_NOOP("KML", "Unable to parse KML file: %1 error: %2 line: %3")).arg(kmlFile).arg(result.errorMessage).arg(result.errorLine));
-        return QDomDocument();
+    return true;
+}
+
+bool KMLHelper::_parseCoordinates(QStringView text, QList<QGeoCoordinate> &coords, QString &errorString)
+{
+    // Every tuple has at least one comma, so this never reserves too little
+    coords.reserve(text.count(u','));
+
+    qsizetype pos = 0;
+    while (pos < text.size()) {
+        while ((pos < text.size()) && text[pos].isSpace()) {
+            pos++;
+        }
+        qsizetype end = pos;
+        while ((end < text.size()) && !text[end].isSpace()) {
+            end++;
+        }
+        if (end == pos) {
+            break;
+        }
+
+        const QStringView tuple = text.sliced(pos, end - pos);
+        pos = end;
+
+        const qsizetype lonEnd = tuple.indexOf(u',');
+        const qsizetype latEnd = (lonEnd < 0) ? -1 : tuple.indexOf(u',', lonEnd + 1);
+        bool lonOk = false;
+        bool latOk = false;
+        const double lon = (lonEnd < 0) ? 0 : tuple.first(lonEnd).toDouble(&lonOk);
+        const double lat = (lonEnd < 0) ? 0 : ((latEnd < 0) ? tuple.sliced(lonEnd + 1) : tuple.sliced(lonEnd + 1, latEnd - lonEnd - 1)).toDouble(&latOk);
+        if (!lonOk || !latOk) {
+            errorString = QString(_errorPrefix).arg(QString(QT_TRANSLATE_NOOP("KML", "Invalid coordinate: %1")).arg(tuple.toString()));
+            return false;
+        }
+
+        coords.append(QGeoCoordinate(lat, lon));
     }
 
-    return doc;
+    return true;
 }
 
 ShapeFileHelper::ShapeType KMLHelper::determineShapeType(const QString &kmlFile, QString &errorString)
 {
     using ShapeType = ShapeFileHelper::ShapeType;
 
-    const QDomDocument domDocument = KMLHelper::_loadFile(kmlFile, errorString);
-    if (!errorString.isEmpty()) {
+    QFile file(kmlFile);
+    if (!_openFile(file, errorString)) {
         return ShapeType::Error;
     }
 
-    const QDomNodeList rgNodesPolygon = domDocument.elementsByTagName("Polygon");
-    if (!rgNodesPolygon.isEmpty()) {
-        return ShapeType::Polygon;
+    // A polygon anywhere in the file wins over a line string, so only a polygon ends the scan early
+    bool foundLineString = false;
+    QXmlStreamReader xml(&file);
+    while (!xml.atEnd()) {
+        if (xml.readNext() == QXmlStreamReader::StartElement) {
+            if (xml.name() == u"Polygon") {
+                return ShapeType::Polygon;
+            } else if (xml.name() == u"LineString") {
+                foundLineString = true;
+            }
+        }
+    }
+    if (_xmlError(xml, kmlFile, errorString)) {
+        return ShapeType::Error;
     }
 
-    const QDomNodeList rgNodesLineString = domDocument.elementsByTagName("LineString");
-    if (!rgNodesLineString.isEmpty()) {
+    if (foundLineString) {
         return ShapeType::Polyline;
     }
 
@@ -72,49 +168,50 @@ bool KMLHelper::loadPolygonFromFile(const QString &kmlFile, QList<QGeoCoordinate
     errorString.clear();
     vertices.clear();
 
-    const QDomDocument domDocument = KMLHelper::_loadFile(kmlFile, errorString);
-    if (!errorString.isEmpty()) {
+    QFile file(kmlFile);
+    if (!_openFile(file, errorString)) {
         return false;
     }
 
-    const QDomNodeList rgNodes = domDocument.elementsByTagName("Polygon");
-    if (rgNodes.isEmpty()) {
-        errorString = QString(_errorPrefix).arg(QT_TRANSLATE_NOOP("KML", "Unable to find Polygon node in KML"));
+    // Only the first polygon is used, so the rest of the file is never read
+    QXmlStreamReader xml(&file);
+    if (!_findElement(xml, u"Polygon")) {
+        if (!_xmlError(xml, kmlFile, errorString)) {
+            errorString = QString(_errorPrefix).arg(QT_TRANSLATE_NOOP("KML", "Unable to find Polygon node in KML"));
+        }
         return false;
     }
 
-    const QDomNode coordinatesNode = rgNodes.item(0).namedItem("outerBoundaryIs").namedItem("LinearRing").namedItem("coordinates");
-    if (coordinatesNode.isNull()) {
-        errorString = QString(_errorPrefix).arg(QT_TRANSLATE_NOOP("KML", "Internal error: Unable to find coordinates node in KML"));
+    static const QStringList coordinatesPath = { QStringLiteral("outerBoundaryIs"), QStringLiteral("LinearRing"), QStringLiteral("coordinates") };
+    if (!_findChildPath(xml, coordinatesPath)) {
+        if (!_xmlError(xml, kmlFile, errorString)) {
+            errorString = QString(_errorPrefix).arg(QT_TRANSLATE_NOOP("KML", "Internal error: Unable to find coordinates node in KML"));
+        }
         return false;
     }
 
-    const QString coordinatesString = coordinatesNode.toElement().text().simplified();
-    const QStringList rgCoordinateStrings = coordinatesString.split(" ");
+    const QString coordinatesString = xml.readElementText();
+    if (_xmlError(xml, kmlFile, errorString)) {
+        return false;
+    }
 
     QList<QGeoCoordinate> rgCoords;
-    for (const QString &coordinateString : rgCoordinateStrings) {
-        const QStringList rgValueStrings = coordinateString.split(",");
-        const QGeoCoordinate coord(rgValueStrings[1].toDouble(), rgValueStrings[0].toDouble());
-        rgCoords.append(coord);
+    if (!_parseCoordinates(coordinatesString, rgCoords, errorString)) {
+        return false;
     }
 
     // Determine winding, reverse if needed. QGC wants clockwise winding
     double sum = 0;
     for (int i=0; i<rgCoords.count(); i++) {
-        const QGeoCoordinate coord1 = rgCoords[i];
-        const QGeoCoordinate coord2 = (i == (rgCoords.count() - 1)) ? rgCoords[0] : rgCoords[i+1];
+        const QGeoCoordinate &coord1 = rgCoords[i];
+        const QGeoCoordinate &coord2 = (i == (rgCoords.count() - 1)) ? rgCoords[0] : rgCoords[i+1];
 
         sum += (coord2.longitude() - coord1.longitude()) * (coord2.latitude() + coord1.latitude());
     }
 
     const bool reverse = sum < 0.0;
     if (reverse) {
-        QList<QGeoCoordinate> rgReversed;
-        for (const QGeoCoordinate &coord : rgCoords) {
-            rgReversed.prepend(coord);
-        }
-        rgCoords = rgReversed;
+        std::reverse(rgCoords.begin(), rgCoords.end());
     }
 
     vertices = rgCoords;
@@ -127,31 +224,36 @@ bool KMLHelper::loadPolylineFromFile(const QString &kmlFile, QList<QGeoCoordinat
     errorString.clear();
     coords.clear();
 
-    const QDomDocument domDocument = KMLHelper::_loadFile(kmlFile, errorString);
-    if (!errorString.isEmpty()) {
+    QFile file(kmlFile);
+    if (!_openFile(file, errorString)) {
         return false;
     }
 
-    const QDomNodeList rgNodes = domDocument.elementsByTagName("LineString");
-    if (rgNodes.isEmpty()) {
-        errorString = QString(_errorPrefix).arg(QT_TRANSLATE_NOOP("KML", "Unable to find LineString node in KML"));
+    // Only the first line string is used, so the rest of the file is never read
+    QXmlStreamReader xml(&file);
+    if (!_findElement(xml, u"LineString")) {
+        if (!_xmlError(xml, kmlFile, errorString)) {
+            errorString = QString(_errorPrefix).arg(QT_TRANSLATE_NOOP("KML", "Unable to find LineString node in KML"));
+        }
         return false;
     }
 
-    const QDomNode coordinatesNode = rgNodes.item(0).namedItem("coordinates");
-    if (coordinatesNode.isNull()) {
-        errorString = QString(_errorPrefix).arg(QT_TRANSLATE_NOOP("KML", "Internal error: Unable to find coordinates node in KML"));
+    static const QStringList coordinatesPath = { QStringLiteral("coordinates") };
+    if (!_findChildPath(xml, coordinatesPath)) {
+        if (!_xmlError(xml, kmlFile, errorString)) {
+            errorString = QString(_errorPrefix).arg(QT_TRANSLATE_NOOP("KML", "Internal error: Unable to find coordinates node in KML"));
+        }
         return false;
     }
 
-    const QString coordinatesString = coordinatesNode.toElement().text().simplified();
-    const QStringList rgCoordinateStrings = coordinatesString.split(" ");
+    const QString coordinatesString = xml.readElementText();
+    if (_xmlError(xml, kmlFile, errorString)) {
+        return false;
+    }
 
     QList<QGeoCoordinate> rgCoords;
-    for (const QString &coordinateString : rgCoordinateStrings) {
-        const QStringList rgValueStrings = coordinateString.split(",");
-        const QGeoCoordinate coord(rgValueStrings[1].toDouble(), rgValueStrings[0].toDouble());
-        rgCoords.append(coord);
+    if (!_parseCoordinates(coordinatesString, rgCoords, errorString)) {
+        return false;
     }
 
     coords = rgCoords;
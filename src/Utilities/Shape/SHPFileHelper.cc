@@ -173,6 +173,7 @@ bool SHPFileHelper::loadPolygonFromFile(const QString &shpFile, QList<QGeoCoordi
         goto Error;
     }
 
+    vertices.reserve(shpObject->nVertices);
     for (int i = 0; i < shpObject->nVertices; i++) {
         QGeoCoordinate coord;
         if (!utmZone || !QGCGeo::convertUTMToGeo(shpObject->padfX[i], shpObject->padfY[i], utmZone, utmSouthernHemisphere, coord)) {
@@ -183,23 +184,24 @@ bool SHPFileHelper::loadPolygonFromFile(const QString &shpFile, QList<QGeoCoordi
     }
 
     // Filter last vertex such that it differs from first
-    {
+    if (!vertices.isEmpty()) {
         const QGeoCoordinate firstVertex = vertices[0];
         while ((vertices.count() > 3) && (vertices.last().distanceTo(firstVertex) < vertexFilterMeters)) {
             vertices.removeLast();
         }
     }
 
-    // Filter vertex distances to be larger than 1 meter apart
-    {
-        int i = 0;
-        while (i < (vertices.count() - 2)) {
-            if (vertices[i].distanceTo(vertices[i+1]) < vertexFilterMeters) {
-                vertices.removeAt(i+1);
-            } else {
-                i++;
+    // Filter vertex distances to be larger than vertexFilterMeters apart. Each vertex is compared against the last one
+    // kept and the final vertex is always kept. Compacting in place keeps this a single pass for large files.
+    if (vertices.count() > 2) {
+        qsizetype kept = 1;
+        for (qsizetype i = 1; i < (vertices.count() - 1); i++) {
+            if (vertices[kept - 1].distanceTo(vertices[i]) >= vertexFilterMeters) {
+                vertices[kept++] = vertices[i];
             }
         }
+        vertices[kept++] = vertices.last();
+        vertices.resize(kept);
     }
 
 Error:
@@ -247,6 +249,7 @@ bool SHPFileHelper::loadPolylineFromFile(const QString &shpFile, QList<QGeoCoord
         goto Error;
     }
 
+    vertices.reserve(shpObject->nVertices);
     for (int i = 0; i < shpObject->nVertices; i++) {
         QGeoCoordinate coord;
         if (!utmZone || !QGCGeo::convertUTMToGeo(shpObject->padfX[i], shpObject->padfY[i], utmZone, utmSouthernHemisphere, coord)) {
@@ -10,6 +10,10 @@
 #include "ShapeFileHelper.h"
 #include "KMLHelper.h"
 #include "SHPFileHelper.h"
+#include "QGCGeo.h"
+
+#include <algorithm>
+#include <vector>
 
 bool ShapeFileHelper::_fileIsKML(const QString &file, QString &errorString)
 {
@@ -51,36 +55,120 @@ ShapeFileHelper::ShapeType ShapeFileHelper::determineShapeType(const QString &fi
     }
 }
 
-bool ShapeFileHelper::loadPolygonFromFile(const QString &file, QList<QGeoCoordinate> &vertices, QString &errorString)
+bool ShapeFileHelper::loadPolygonFromFile(const QString &file, QList<QGeoCoordinate> &vertices, QString &errorString, double simplifyToleranceMeters)
 {
     errorString.clear();
     vertices.clear();
 
+    bool success = false;
     switch (_getShapeFileType(file, errorString)) {
     case ShapeFileType::KML:
-        return KMLHelper::loadPolygonFromFile(file, vertices, errorString);
+        success = KMLHelper::loadPolygonFromFile(file, vertices, errorString);
+        break;
     case ShapeFileType::SHP:
-        return SHPFileHelper::loadPolygonFromFile(file, vertices, errorString);
+        success = SHPFileHelper::loadPolygonFromFile(file, vertices, errorString);
+        break;
     case ShapeFileType::None:
     default:
         return false;
     }
+
+    if (success && (simplifyToleranceMeters > 0)) {
+        // A tolerance larger than the polygon would collapse it, keep it as loaded in that case
+        const QList<QGeoCoordinate> simplified = simplify(vertices, simplifyToleranceMeters);
+        if (simplified.count() >= 3) {
+            vertices = simplified;
+        }
+    }
+
+    return success;
 }
 
-bool ShapeFileHelper::loadPolylineFromFile(const QString &file, QList<QGeoCoordinate> &coords, QString &errorString)
+bool ShapeFileHelper::loadPolylineFromFile(const QString &file, QList<QGeoCoordinate> &coords, QString &errorString, double simplifyToleranceMeters)
 {
     errorString.clear();
     coords.clear();
 
+    bool success = false;
     switch (_getShapeFileType(file, errorString)) {
     case ShapeFileType::KML:
-        return KMLHelper::loadPolylineFromFile(file, coords, errorString);
+        success = KMLHelper::loadPolylineFromFile(file, coords, errorString);
+        break;
     case ShapeFileType::SHP:
-        return SHPFileHelper::loadPolylineFromFile(file, coords, errorString);
+        success = SHPFileHelper::loadPolylineFromFile(file, coords, errorString);
+        break;
     case ShapeFileType::None:
     default:
         return false;
     }
+
+    if (success && (simplifyToleranceMeters > 0)) {
+        coords = simplify(coords, simplifyToleranceMeters);
+    }
+
+    return success;
+}
+
+QList<QGeoCoordinate> ShapeFileHelper::simplify(const QList<QGeoCoordinate> &coords, double toleranceMeters)
+{
+    if ((toleranceMeters <= 0) || (coords.count() < 3)) {
+        return coords;
+    }
+
+    // Work in a tangent plane at the first vertex, which is accurate enough at the size of a mission area
+    const QGCGeo::CoordinateArrays geoCoords(coords);
+    std::vector<double> x(geoCoords.size());
+    std::vector<double> y(geoCoords.size());
+    std::vector<double> z(geoCoords.size());
+    QGCGeo::convertGeoToNed(geoCoords.latitudes, geoCoords.longitudes, geoCoords.altitudes, coords.first(), x, y, z);
+
+    std::vector<bool> keep(coords.count(), false);
+    keep.front() = true;
+    keep.back() = true;
+
+    // Ranges still to be split are kept on a stack, recursion could go as deep as the vertex count
+    const double toleranceSquared = toleranceMeters * toleranceMeters;
+    QList<std::pair<qsizetype, qsizetype>> ranges{ { 0, coords.count() - 1 } };
+    while (!ranges.isEmpty()) {
+        const auto [first, last] = ranges.takeLast();
+
+        const double dx = x[last] - x[first];
+        const double dy = y[last] - y[first];
+        const double lengthSquared = (dx * dx) + (dy * dy);
+
+        qsizetype farthest = -1;
+        double farthestSquared = toleranceSquared;
+        for (qsizetype i = first + 1; i < last; i++) {
+            // Distance to the segment rather than the infinite line. Closed rings start and end on the same vertex,
+            // which leaves a zero length segment.
+            const double px = x[i] - x[first];
+            const double py = y[i] - y[first];
+            const double t = (lengthSquared > 0) ? std::clamp(((px * dx) + (py * dy)) / lengthSquared, 0.0, 1.0) : 0.0;
+            const double ex = px - (t * dx);
+            const double ey = py - (t * dy);
+            const double distanceSquared = (ex * ex) + (ey * ey);
+            if (distanceSquared > farthestSquared) {
+                farthest = i;
+                farthestSquared = distanceSquared;
+            }
+        }
+
+        if (farthest >= 0) {
+            keep[farthest] = true;
+            ranges.append({ first, farthest });
+            ranges.append({ farthest, last });
+        }
+    }
+
+    QList<QGeoCoordinate> simplified;
+    simplified.reserve(std::count(keep.cbegin(), keep.cend(), true));
+    for (qsizetype i = 0; i < coords.count(); i++) {
+        if (keep[i]) {
+            simplified.append(coords[i]);
+        }
+    }
+
+    return simplified;
 }
 
 QStringList ShapeFileHelper::fileDialogKMLFilters()
@@ -33,8 +33,14 @@ class ShapeFileHelper : public QObject
         Error
     };
     static ShapeType determineShapeType(const QString &file, QString &errorString);
-    static bool loadPolygonFromFile(const QString &file, QList<QGeoCoordinate> &vertices, QString &errorString);
-    static bool loadPolylineFromFile(const QString &file, QList<QGeoCoordinate> &coords, QString &errorString);
+
+    /// @param simplifyToleranceMeters Simplifies the shape to this tolerance after loading, 0 keeps every vertex
+    static bool loadPolygonFromFile(const QString &file, QList<QGeoCoordinate> &vertices, QString &errorString, double simplifyToleranceMeters = 0);
+    static bool loadPolylineFromFile(const QString &file, QList<QGeoCoordinate> &coords, QString &errorString, double simplifyToleranceMeters = 0);
+
+    /// Douglas-Peucker simplification. Drops the vertices which are less than toleranceMeters from the line between
+    /// the vertices kept on either side of them. The first and last vertex are always kept.
+    static QList<QGeoCoordinate> simplify(const QList<QGeoCoordinate> &coords, double toleranceMeters);
 
     static constexpr const char *kmlFileExtension = "kml";
     static constexpr const char *shpFileExtension = "shp";
@@ -0,0 +1,89 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LatencyHistogram.h"
+
+#include <bit>
+#include <cmath>
+
+int LatencyHistogram::_bucketIndex(quint64 value)
+{
+    if (value < kSubBuckets) {
+        return static_cast<int>(value);
+    }
+
+    // Shift the value down until it fits [kSubBuckets, 2 * kSubBuckets), the shift picks the range and what is
+    // left picks the linear bucket within it
+    const int shift = std::bit_width(value) - (kSubBucketBits + 1);
+    const int index = kSubBuckets + (shift * kSubBuckets) + static_cast<int>((value >> shift) - kSubBuckets);
+
+    return qMin(index, kBucketCount - 1);
+}
+
+quint64 LatencyHistogram::_bucketUpperBound(int index)
+{
+    if (index < kSubBuckets) {
+        return static_cast<quint64>(index);
+    }
+
+    const int shift = (index - kSubBuckets) / kSubBuckets;
+    const quint64 subBucket = static_cast<quint64>(kSubBuckets + ((index - kSubBuckets) % kSubBuckets));
+
+    return ((subBucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(quint64 value)
+{
+    _buckets[_bucketIndex(value)]++;
+
+    _min = _count ? qMin(_min, value) : value;
+    _max = qMax(_max, value);
+    _total += value;
+    _count++;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+    if (other._count == 0) {
+        return;
+    }
+
+    for (int i = 0; i < kBucketCount; i++) {
+        _buckets[i] += other._buckets[i];
+    }
+
+    _min = _count ? qMin(_min, other._min) : other._min;
+    _max = qMax(_max, other._max);
+    _total += other._total;
+    _count += other._count;
+}
+
+void LatencyHistogram::reset()
+{
+    *this = LatencyHistogram();
+}
+
+quint64 LatencyHistogram::valueAtPercentile(double percentile) const
+{
+    if (_count == 0) {
+        return 0;
+    }
+
+    const quint64 target = qMax(quint64(1), static_cast<quint64>(std::ceil((qBound(0., percentile, 100.) / 100.) * _count)));
+
+    quint64 seen = 0;
+    for (int i = 0; i < kBucketCount; i++) {
+        seen += _buckets[i];
+        if (seen >= target) {
+            return qMin(_bucketUpperBound(i), _max);
+        }
+    }
+
+    return _max;
+}
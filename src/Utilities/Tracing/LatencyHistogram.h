@@ -0,0 +1,49 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QtTypes>
+
+#include <array>
+
+/// Fixed size log-linear histogram in the style of HdrHistogram. Every power of two range is split into
+/// kSubBuckets linear buckets, so any recorded value is reproduced within 1/kSubBuckets (about 6%) over the
+/// full range with constant memory and O(1) recording.
+class LatencyHistogram
+{
+public:
+    void record(quint64 value);
+    void merge(const LatencyHistogram &other);
+    void reset();
+
+    quint64 count() const { return _count; }
+    quint64 min() const { return _count ? _min : 0; }
+    quint64 max() const { return _max; }
+    double mean() const { return _count ? (static_cast<double>(_total) / _count) : 0.; }
+
+    /// @param percentile 0-100
+    /// @return Highest value equivalent to the bucket containing the percentile, clamped to max()
+    quint64 valueAtPercentile(double percentile) const;
+
+    static constexpr int kSubBucketBits = 4;
+    static constexpr int kSubBuckets = 1 << kSubBucketBits;
+    static constexpr int kRanges = 40;                  ///< Resolves values below 2^43, anything larger lands in the last bucket
+    static constexpr int kBucketCount = kSubBuckets + ((kRanges - 1) * kSubBuckets);
+
+private:
+    static int _bucketIndex(quint64 value);
+    static quint64 _bucketUpperBound(int index);
+
+    std::array<quint32, kBucketCount> _buckets{};
+    quint64 _count = 0;
+    quint64 _total = 0;
+    quint64 _min = 0;
+    quint64 _max = 0;
+};
@@ -0,0 +1,296 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TelemetryTracer.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/qapplicationstatic.h>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QSet>
+#include <QtCore/QThread>
+
+QGC_LOGGING_CATEGORY(TelemetryTracerLog, "qgc.utilities.tracing.telemetrytracer")
+
+Q_APPLICATION_STATIC(TelemetryTracer, _telemetryTracerInstance);
+
+std::atomic_bool TelemetryTracer::_enabled = false;
+
+namespace {
+    const QElapsedTimer &tracerClock()
+    {
+        static const QElapsedTimer clock = []() {
+            QElapsedTimer timer;
+            timer.start();
+            return timer;
+        }();
+        return clock;
+    }
+}
+
+TelemetryTracer::TelemetryTracer(QObject *parent)
+    : QObject(parent)
+{
+    // qCDebug(TelemetryTracerLog) << Q_FUNC_INFO << this;
+
+    (void) tracerClock();
+}
+
+TelemetryTracer::~TelemetryTracer()
+{
+    // qCDebug(TelemetryTracerLog) << Q_FUNC_INFO << this;
+}
+
+TelemetryTracer *TelemetryTracer::instance()
+{
+    return _telemetryTracerInstance();
+}
+
+qint64 TelemetryTracer::nowNsecs()
+{
+    // Offset by one so a valid timestamp is never 0
+    return tracerClock().nsecsElapsed() + 1;
+}
+
+void TelemetryTracer::setEnabled(bool enabled)
+{
+    if (enabled == TelemetryTracer::enabled()) {
+        return;
+    }
+
+    if (enabled) {
+        _traces.assign(kTraceCapacity, Trace_t{});
+    } else {
+        _currentTraceId = 0;
+        _pendingFacts.clear();
+    }
+
+    _enabled.store(enabled, std::memory_order_relaxed);
+    qCDebug(TelemetryTracerLog) << "Tracing" << (enabled ? "enabled" : "disabled");
+
+    emit enabledChanged(enabled);
+}
+
+void TelemetryTracer::reset()
+{
+    _messageHistograms.clear();
+    _vehicleHistograms.clear();
+    _pendingFacts.clear();
+    if (!_traces.empty()) {
+        _traces.assign(kTraceCapacity, Trace_t{});
+    }
+}
+
+bool TelemetryTracer::_onTracerThread() const
+{
+    return (QThread::currentThread() == thread());
+}
+
+TelemetryTracer::Trace_t *TelemetryTracer::_trace(quint64 id)
+{
+    if ((id == 0) || _traces.empty()) {
+        return nullptr;
+    }
+
+    Trace_t &trace = _traces[id % kTraceCapacity];
+    return (trace.id == id) ? &trace : nullptr;
+}
+
+void TelemetryTracer::_markStage(quint64 id, Stage_t stage)
+{
+    Trace_t *const trace = _trace(id);
+    if (!trace || (trace->stageNsecs[stage] != 0)) {
+        return;
+    }
+
+    const qint64 now = nowNsecs();
+    trace->stageNsecs[stage] = now;
+
+    const quint64 latencyUsecs = static_cast<quint64>(qMax(qint64(0), now - trace->readNsecs)) / 1000;
+    _messageHistograms[trace->messageId][stage].record(latencyUsecs);
+    _vehicleHistograms[trace->systemId][stage].record(latencyUsecs);
+}
+
+void TelemetryTracer::beginMessage(qint64 readNsecs, const mavlink_message_t &message)
+{
+    if (!enabled() || !_onTracerThread()) {
+        return;
+    }
+
+    const quint64 id = _nextTraceId++;
+    Trace_t &trace = _traces[id % kTraceCapacity];
+    trace = Trace_t{};
+    trace.id = id;
+    trace.messageId = message.msgid;
+    trace.systemId = message.sysid;
+    trace.readNsecs = (readNsecs > 0) ? readNsecs : nowNsecs();
+
+    _currentTraceId = id;
+    _markStage(id, StageParse);
+}
+
+void TelemetryTracer::endMessage()
+{
+    _currentTraceId = 0;
+}
+
+void TelemetryTracer::markDispatch()
+{
+    if (_onTracerThread()) {
+        _markStage(_currentTraceId, StageDispatch);
+    }
+}
+
+void TelemetryTracer::markFactGroups()
+{
+    if (_onTracerThread()) {
+        _markStage(_currentTraceId, StageFactGroups);
+    }
+}
+
+void TelemetryTracer::factValueChanged(const Fact *fact, bool immediate)
+{
+    if ((_currentTraceId == 0) || !_onTracerThread()) {
+        return;
+    }
+
+    if (immediate) {
+        _markStage(_currentTraceId, StageFlush);
+    } else {
+        // Keep the oldest message, that is the one which waits longest for the flush
+        if (!_pendingFacts.contains(fact)) {
+            _pendingFacts.insert(fact, _currentTraceId);
+        }
+    }
+}
+
+void TelemetryTracer::factDeferredValueSent(const Fact *fact)
+{
+    if (_pendingFacts.isEmpty() || !_onTracerThread()) {
+        return;
+    }
+
+    const quint64 id = _pendingFacts.take(fact);
+    if (id != 0) {
+        _markStage(id, StageFlush);
+    }
+}
+
+void TelemetryTracer::factDestroyed(const Fact *fact)
+{
+    if (_onTracerThread()) {
+        (void) _pendingFacts.remove(fact);
+    }
+}
+
+QString TelemetryTracer::stageName(Stage_t stage)
+{
+    switch (stage) {
+    case StageParse:
+        return QStringLiteral("Parse");
+    case StageDispatch:
+        return QStringLiteral("Dispatch");
+    case StageFactGroups:
+        return QStringLiteral("FactGroups");
+    case StageFlush:
+        return QStringLiteral("Flush");
+    default:
+        return QString();
+    }
+}
+
+QString TelemetryTracer::messageName(uint32_t messageId)
+{
+    mavlink_message_t message{};
+    message.msgid = messageId;
+
+    const mavlink_message_info_t *const info = mavlink_get_message_info(&message);
+    return info ? QString(info->name) : QString::number(messageId);
+}
+
+QJsonObject TelemetryTracer::chromeTrace() const
+{
+    QJsonArray events;
+    QSet<uint8_t> systemIds;
+    QSet<QPair<uint8_t, uint32_t>> threads;
+
+    // Oldest first, the ring wraps at _nextTraceId
+    for (int i = 0; i < static_cast<int>(_traces.size()); i++) {
+        const Trace_t &trace = _traces[(_nextTraceId + i) % kTraceCapacity];
+        if (trace.id == 0) {
+            continue;
+        }
+
+        systemIds.insert(trace.systemId);
+        threads.insert(qMakePair(trace.systemId, trace.messageId));
+
+        qint64 sliceStart = trace.readNsecs;
+        for (int stage = 0; stage < StageCount; stage++) {
+            const qint64 stageEnd = trace.stageNsecs[stage];
+            if (stageEnd == 0) {
+                continue;
+            }
+
+            QJsonObject event;
+            event[QStringLiteral("name")] = stageName(static_cast<Stage_t>(stage));
+            event[QStringLiteral("cat")] = QStringLiteral("telemetry");
+            event[QStringLiteral("ph")] = QStringLiteral("X");
+            event[QStringLiteral("ts")] = sliceStart / 1000.;
+            event[QStringLiteral("dur")] = (stageEnd - sliceStart) / 1000.;
+            event[QStringLiteral("pid")] = trace.systemId;
+            event[QStringLiteral("tid")] = static_cast<qint64>(trace.messageId);
+            event[QStringLiteral("args")] = QJsonObject{ { QStringLiteral("trace"), static_cast<qint64>(trace.id) } };
+            events.append(event);
+
+            sliceStart = stageEnd;
+        }
+    }
+
+    for (const uint8_t systemId : systemIds) {
+        events.append(QJsonObject{
+            { QStringLiteral("name"), QStringLiteral("process_name") },
+            { QStringLiteral("ph"), QStringLiteral("M") },
+            { QStringLiteral("pid"), systemId },
+            { QStringLiteral("args"), QJsonObject{ { QStringLiteral("name"), QStringLiteral("Vehicle %1").arg(systemId) } } },
+        });
+    }
+    for (const QPair<uint8_t, uint32_t> &thread : threads) {
+        events.append(QJsonObject{
+            { QStringLiteral("name"), QStringLiteral("thread_name") },
+            { QStringLiteral("ph"), QStringLiteral("M") },
+            { QStringLiteral("pid"), thread.first },
+            { QStringLiteral("tid"), static_cast<qint64>(thread.second) },
+            { QStringLiteral("args"), QJsonObject{ { QStringLiteral("name"), messageName(thread.second) } } },
+        });
+    }
+
+    return QJsonObject{
+        { QStringLiteral("traceEvents"), events },
+        { QStringLiteral("displayTimeUnit"), QStringLiteral("ms") },
+    };
+}
+
+bool TelemetryTracer::exportChromeTrace(const QString &filename) const
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(TelemetryTracerLog) << "Unable to open" << filename << file.errorString();
+        return false;
+    }
+
+    const QByteArray json = QJsonDocument(chromeTrace()).toJson(QJsonDocument::Compact);
+    if (file.write(json) != json.size()) {
+        qCWarning(TelemetryTracerLog) << "Unable to write" << filename << file.errorString();
+        return false;
+    }
+
+    return true;
+}
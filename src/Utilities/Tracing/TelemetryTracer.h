@@ -0,0 +1,113 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "LatencyHistogram.h"
+#include "MAVLinkLib.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QJsonObject>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
+
+#include <array>
+#include <atomic>
+#include <vector>
+
+class Fact;
+
+Q_DECLARE_LOGGING_CATEGORY(TelemetryTracerLog)
+
+/// Opt-in tracing of where received telemetry spends its time on the way from a link to QML. Each message is
+/// timestamped as it passes the pipeline stages and the latency of each stage, measured from the moment the link
+/// handed over the bytes, is collected into per message id and per vehicle histograms. The most recent messages
+/// are also kept as a trace which can be exported in Chrome trace event format for chrome://tracing or Perfetto.
+///
+/// While disabled every hook costs a single relaxed atomic load. All hooks other than the link read are main thread only.
+class TelemetryTracer : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Stage_t {
+        StageParse,         ///< MAVLinkProtocol::receiveBytes has a complete message
+        StageDispatch,      ///< Vehicle::_mavlinkMessageReceived accepted it
+        StageFactGroups,    ///< All FactGroups have handled it
+        StageFlush,         ///< First Fact changed by it signalled the change to QML
+        StageCount
+    };
+
+    typedef std::array<LatencyHistogram, StageCount> StageHistograms_t;    ///< Microseconds since link read
+
+    explicit TelemetryTracer(QObject *parent = nullptr);
+    ~TelemetryTracer();
+
+    static TelemetryTracer *instance();
+
+    static bool enabled() { return _enabled.load(std::memory_order_relaxed); }
+    void setEnabled(bool enabled);
+
+    /// Clears histograms and trace
+    void reset();
+
+    /// Monotonic clock shared by all stages, thread safe
+    static qint64 nowNsecs();
+
+    /// A message has been parsed from bytes which the link read at readNsecs (-1: unknown, uses now).
+    /// Everything which happens until endMessage is attributed to it.
+    void beginMessage(qint64 readNsecs, const mavlink_message_t &message);
+    void endMessage();
+    void markDispatch();
+    void markFactGroups();
+
+    /// Fact value changed, immediate is true if the valueChanged signal went out right away rather than deferred
+    void factValueChanged(const Fact *fact, bool immediate);
+    void factDeferredValueSent(const Fact *fact);
+    void factDestroyed(const Fact *fact);
+
+    const QHash<uint32_t, StageHistograms_t> &messageHistograms() const { return _messageHistograms; }
+    const QHash<uint8_t, StageHistograms_t> &vehicleHistograms() const { return _vehicleHistograms; }
+
+    /// Trace of the most recent kTraceCapacity messages in Chrome trace event format. Each vehicle is a process
+    /// and each message id a thread, with one slice per stage.
+    QJsonObject chromeTrace() const;
+    bool exportChromeTrace(const QString &filename) const;
+
+    static QString stageName(Stage_t stage);
+    static QString messageName(uint32_t messageId);
+
+    static constexpr int kTraceCapacity = 20000;
+
+signals:
+    void enabledChanged(bool enabled);
+
+private:
+    typedef struct {
+        quint64 id;                         ///< 0: Unused slot
+        uint32_t messageId;
+        uint8_t systemId;
+        qint64 readNsecs;
+        qint64 stageNsecs[StageCount];      ///< 0: Stage not reached
+    } Trace_t;
+
+    Trace_t *_trace(quint64 id);
+    void _markStage(quint64 id, Stage_t stage);
+    bool _onTracerThread() const;
+
+    static std::atomic_bool _enabled;
+
+    std::vector<Trace_t> _traces;                   ///< Ring buffer indexed by id % kTraceCapacity
+    quint64 _nextTraceId = 1;
+    quint64 _currentTraceId = 0;                    ///< Message being dispatched, 0 for none
+    QHash<const Fact*, quint64> _pendingFacts;      ///< Facts with a deferred change, to the oldest message which changed them
+
+    QHash<uint32_t, StageHistograms_t> _messageHistograms;
+    QHash<uint8_t, StageHistograms_t> _vehicleHistograms;
+};
@@ -8,7 +8,6 @@
  ****************************************************************************/
 
 #include "CompInfoParam.h"
-#include "JsonHelper.h"
 #include "FactMetaData.h"
 #include "FirmwarePlugin.h"
 #include "FirmwarePluginManager.h"
@@ -16,11 +15,10 @@
 #include "QGCLoggingCategory.h"
 #include "Vehicle.h"
 
-#include <QtCore/QJsonDocument>
-#include <QtCore/QJsonArray>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QRegularExpression>
 #include <QtCore/QRegularExpressionMatch>
-#include <QtCore/QDir>
 
 QGC_LOGGING_CATEGORY(CompInfoParamLog, "CompInfoParamLog")
 
@@ -40,49 +38,21 @@ void CompInfoParam::setJson(const QString& metadataJsonFileName)
         return;
     }
 
-    QString         errorString;
-    QJsonDocument   jsonDoc;
-
     _noJsonMetadata = false;
 
-    if (!JsonHelper::isJsonFile(metadataJsonFileName, jsonDoc, errorString)) {
-        qCWarning(CompInfoParamLog) << "Metadata json file open failed: compid:" << compId << errorString;
-        return;
-    }
-    QJsonObject jsonObj = jsonDoc.object();
-
-    QList<JsonHelper::KeyValidateInfo> keyInfoList = {
-        { JsonHelper::jsonVersionKey,   QJsonValue::Double, true },
-        { _jsonParametersKey,           QJsonValue::Array,  true },
-    };
-    if (!JsonHelper::validateKeys(jsonObj, keyInfoList, errorString)) {
-        qCWarning(CompInfoParamLog) << "Metadata json validation failed: compid:" << compId << errorString;
-        return;
-    }
+    // The json is compiled into a store on first use, later connects map the store and only build metadata for the
+    // parameters the vehicle actually has
+    const QString cacheTag = QStringLiteral("%1-%2.%3.%4").arg(compId).arg(vehicle->firmwareMajorVersion()).arg(vehicle->firmwareMinorVersion()).arg(vehicle->firmwarePatchVersion());
+    const QString cacheDir = ParameterMetaDataStore::defaultCacheDirectory();
 
-    int version = jsonObj[JsonHelper::jsonVersionKey].toInt();
-    if (version != 1) {
-        qCWarning(CompInfoParamLog) << "Metadata json unsupported version" << version;
+    QElapsedTimer loadTimer;
+    loadTimer.start();
+    QString errorString;
+    if (!_metaDataStore.load(metadataJsonFileName, cacheTag, cacheDir, errorString)) {
+        qCWarning(CompInfoParamLog) << "Metadata json load failed: compid:" << compId << errorString;
         return;
     }
-
-    QJsonArray rgParameters = jsonObj[_jsonParametersKey].toArray();
-    for (QJsonValue parameterValue: rgParameters) {
-        QMap<QString, QString> emptyDefineMap;
-
-        if (!parameterValue.isObject()) {
-            qCWarning(CompInfoParamLog) << "Metadata json read failed: compid:" << compId << "parameters array contains non-object";
-            return;
-        }
-
-        FactMetaData* newMetaData = FactMetaData::createFromJsonObject(parameterValue.toObject(), emptyDefineMap, this);
-
-        if (newMetaData->name().contains(_indexedNameTag)) {
-            _indexedNameMetaDataList.append(RegexFactMetaDataPair_t(newMetaData->name(), newMetaData));
-        } else {
-            _nameToMetaDataMap[newMetaData->name()] = newMetaData;
-        }
-    }
+    qCDebug(CompInfoParamLog) << "Metadata store loaded: compid:" << compId << "parameters:" << _metaDataStore.count() << "msecs:" << loadTimer.elapsed();
 }
 
 FactMetaData* CompInfoParam::factMetaDataForName(const QString& name, FactMetaData::ValueType_t type)
@@ -100,27 +70,20 @@ FactMetaData* CompInfoParam::factMetaDataForName(const QString& name, FactMetaDa
         if (_nameToMetaDataMap.contains(name)) {
             factMetaData = _nameToMetaDataMap[name];
         } else {
-            // We didn't get any direct matches. Try an indexed name.
-            for (int i=0; i<_indexedNameMetaDataList.count(); i++) {
-                const RegexFactMetaDataPair_t& pair = _indexedNameMetaDataList[i];
-
-                QString indexedName = pair.first;
-                const QString indexedRegex("(\\d+)");
-                indexedName.replace(_indexedNameTag, indexedRegex);
-
-                const QRegularExpression      regex(indexedName);
-                const QRegularExpressionMatch match = regex.match(name);
+            QString indexValue;
+            const QJsonObject parameterObj = _metaDataStore.parameter(name, indexValue);
+            if (!parameterObj.isEmpty()) {
+                QMap<QString, QString> emptyDefineMap;
+                factMetaData = FactMetaData::createFromJsonObject(parameterObj, emptyDefineMap, this);
 
-                const QStringList captured = match.capturedTexts();
-                if (captured.count() == 2) {
-                    factMetaData = new FactMetaData(*pair.second, this);
+                if (!indexValue.isEmpty()) {
                     factMetaData->setName(name);
 
                     QString shortDescription = factMetaData->shortDescription();
-                    shortDescription.replace(_indexedNameTag, captured[1]);
+                    shortDescription.replace(ParameterMetaDataStore::indexedNameTag, indexValue);
                     factMetaData->setShortDescription(shortDescription);
-                    QString longDescription = factMetaData->shortDescription();
-                    longDescription.replace(_indexedNameTag, captured[1]);
+                    QString longDescription = factMetaData->longDescription();
+                    longDescription.replace(ParameterMetaDataStore::indexedNameTag, indexValue);
                     factMetaData->setLongDescription(longDescription);
                 }
             }
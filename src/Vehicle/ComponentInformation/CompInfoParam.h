@@ -12,6 +12,7 @@
 #include "CompInfo.h"
 #include "MAVLinkLib.h"
 #include "FactMetaData.h"
+#include "ParameterMetaDataStore.h"
 
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QObject>
@@ -41,14 +42,10 @@ class CompInfoParam : public CompInfo
     static FirmwarePlugin*  _anyVehicleTypeFirmwarePlugin   (MAV_AUTOPILOT firmwareType);
     static QString          _parameterMetaDataFile          (Vehicle* vehicle, MAV_AUTOPILOT firmwareType, int& majorVersion, int& minorVersion);
 
-    typedef QPair<QString /* indexed name */, FactMetaData*> RegexFactMetaDataPair_t;
-
     bool                                _noJsonMetadata             = true;
-    FactMetaData::NameToMetaDataMap_t   _nameToMetaDataMap;
-    QList<RegexFactMetaDataPair_t>      _indexedNameMetaDataList;
+    FactMetaData::NameToMetaDataMap_t   _nameToMetaDataMap;         ///< FactMetaData created so far
+    ParameterMetaDataStore              _metaDataStore;
     QObject*                            _opaqueParameterMetaData    = nullptr;
 
-    static constexpr const char* _jsonParametersKey           = "parameters";
     static constexpr const char* _cachedMetaDataFilePrefix    = "ParameterFactMetaData";
-    static constexpr const char* _indexedNameTag              = "{n}";
 };
@@ -0,0 +1,756 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ParameterMetaDataStore.h"
+#include "JsonHelper.h"
+#include "QGCLoggingCategory.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QHash>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QtEndian>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+QGC_LOGGING_CATEGORY(ParameterMetaDataStoreLog, "qgc.vehicle.componentinformation.parametermetadatastore")
+
+namespace {
+
+/// Builds the string table and the encoded records
+class StoreWriter
+{
+public:
+    quint32 stringId(const QString& string)
+    {
+        const auto it = _stringIds.constFind(string);
+        if (it != _stringIds.constEnd()) {
+            return *it;
+        }
+
+        const quint32 id = static_cast<quint32>(_strings.count());
+        _strings.append(string);
+        (void) _stringIds.insert(string, id);
+        return id;
+    }
+
+    /// @return Offset of the record within the records section
+    quint32 appendRecord(const QJsonObject& object)
+    {
+        const quint32 offset = static_cast<quint32>(records.size());
+        _appendValue(object);
+        return offset;
+    }
+
+    const QStringList& strings() const { return _strings; }
+
+    QByteArray records;
+
+private:
+    void _appendU8(quint8 value) { (void) records.append(static_cast<char>(value)); }
+
+    void _appendU32(quint32 value)
+    {
+        char bytes[sizeof(value)];
+        qToLittleEndian(value, bytes);
+        (void) records.append(bytes, sizeof(bytes));
+    }
+
+    void _appendValue(const QJsonValue& value)
+    {
+        switch (value.type()) {
+        case QJsonValue::Bool:
+            _appendU8(value.toBool() ? 2 : 1);
+            break;
+        case QJsonValue::Double:
+        {
+            // Integers stay integers so large values such as uint32 defaults go through unchanged
+            const QVariant variant = value.toVariant();
+            char bytes[sizeof(qint64)];
+            if (variant.typeId() == QMetaType::LongLong) {
+                _appendU8(3);
+                qToLittleEndian(variant.toLongLong(), bytes);
+            } else {
+                _appendU8(4);
+                qToLittleEndian(value.toDouble(), bytes);
+            }
+            (void) records.append(bytes, sizeof(bytes));
+            break;
+        }
+        case QJsonValue::String:
+            _appendU8(5);
+            _appendU32(stringId(value.toString()));
+            break;
+        case QJsonValue::Array:
+        {
+            const QJsonArray array = value.toArray();
+            _appendU8(6);
+            _appendU32(static_cast<quint32>(array.count()));
+            for (const QJsonValue& arrayValue : array) {
+                _appendValue(arrayValue);
+            }
+            break;
+        }
+        case QJsonValue::Object:
+        {
+            const QJsonObject object = value.toObject();
+            _appendU8(7);
+            _appendU32(static_cast<quint32>(object.count()));
+            for (auto it = object.constBegin(); it != object.constEnd(); ++it) {
+                _appendU32(stringId(it.key()));
+                _appendValue(it.value());
+            }
+            break;
+        }
+        default:
+            _appendU8(0);
+            break;
+        }
+    }
+
+    QStringList _strings;
+    QHash<QString, quint32> _stringIds;
+};
+
+void appendU32(QByteArray& bytes, quint32 value)
+{
+    char buffer[sizeof(value)];
+    qToLittleEndian(value, buffer);
+    (void) bytes.append(buffer, sizeof(buffer));
+}
+
+} // namespace
+
+ParameterMetaDataStore::ParameterMetaDataStore()
+{
+    static_assert(TagNull == 0 && TagFalse == 1 && TagTrue == 2 && TagInteger == 3 && TagDouble == 4 && TagString == 5 && TagArray == 6 && TagObject == 7, "StoreWriter tags out of sync");
+
+    // qCDebug(ParameterMetaDataStoreLog) << Q_FUNC_INFO << this;
+}
+
+ParameterMetaDataStore::~ParameterMetaDataStore()
+{
+    close();
+
+    // qCDebug(ParameterMetaDataStoreLog) << Q_FUNC_INFO << this;
+}
+
+quint32 ParameterMetaDataStore::_hash(QStringView name, quint32 seed)
+{
+    // FNV-1a followed by the murmur3 finalizer. Unlike qHash this is the same in every run and Qt version,
+    // which the stored seeds rely on.
+    quint32 hash = 2166136261u ^ (seed * 0x9e3779b9u);
+    for (const QChar c : name) {
+        hash ^= c.unicode();
+        hash *= 16777619u;
+    }
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    hash *= 0xc2b2ae35u;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+bool ParameterMetaDataStore::_buildPerfectHash(const QStringList& names, QList<quint32>& seeds, QList<quint32>& slots)
+{
+    // Hash and displace: names are split into buckets of about four, then starting with the largest bucket a seed is
+    // searched for which sends every name in the bucket to a free slot. A lookup is then two hashes and one compare.
+    const quint32 nameCount = static_cast<quint32>(names.count());
+    const quint32 bucketCount = qMax(1u, (nameCount + 3) / 4);
+
+    QList<QList<quint32>> buckets(bucketCount);
+    for (quint32 i = 0; i < nameCount; i++) {
+        buckets[_hash(names[i], 0) % bucketCount].append(i);
+    }
+
+    QList<quint32> bucketOrder(bucketCount);
+    for (quint32 i = 0; i < bucketCount; i++) {
+        bucketOrder[i] = i;
+    }
+    std::stable_sort(bucketOrder.begin(), bucketOrder.end(), [&buckets](quint32 a, quint32 b) {
+        return buckets[a].count() > buckets[b].count();
+    });
+
+    quint32 slotCount = qMax(1u, nameCount + (nameCount / 4));
+    for (int attempt = 0; attempt < 4; attempt++, slotCount += slotCount / 2) {
+        seeds.fill(0, bucketCount);
+        slots.fill(kEmptySlot, slotCount);
+
+        bool failed = false;
+        QList<quint32> bucketSlots;
+        for (const quint32 bucket : bucketOrder) {
+            const QList<quint32>& bucketNames = buckets[bucket];
+            if (bucketNames.isEmpty()) {
+                break;
+            }
+
+            bool placed = false;
+            for (quint32 seed = 1; (seed < kMaxSeed) && !placed; seed++) {
+                bucketSlots.clear();
+                placed = true;
+                for (const quint32 nameIndex : bucketNames) {
+                    const quint32 slot = _hash(names[nameIndex], seed) % slotCount;
+                    if ((slots[slot] != kEmptySlot) || bucketSlots.contains(slot)) {
+                        placed = false;
+                        break;
+                    }
+                    bucketSlots.append(slot);
+                }
+                if (placed) {
+                    seeds[bucket] = seed;
+                    for (qsizetype i = 0; i < bucketNames.count(); i++) {
+                        slots[bucketSlots[i]] = bucketNames[i];
+                    }
+                }
+            }
+
+            if (!placed) {
+                failed = true;
+                break;
+            }
+        }
+
+        if (!failed) {
+            return true;
+        }
+        qCDebug(ParameterMetaDataStoreLog) << "Perfect hash failed with" << slotCount << "slots, growing";
+    }
+
+    return false;
+}
+
+bool ParameterMetaDataStore::_jsonParameters(const QByteArray& jsonBytes, QJsonArray& parameters, QString& errorString)
+{
+    QJsonDocument jsonDoc;
+    if (!JsonHelper::isJsonFile(jsonBytes, jsonDoc, errorString)) {
+        return false;
+    }
+    const QJsonObject jsonObj = jsonDoc.object();
+
+    static const QList<JsonHelper::KeyValidateInfo> keyInfoList = {
+        { JsonHelper::jsonVersionKey,   QJsonValue::Double, true },
+        { "parameters",                 QJsonValue::Array,  true },
+    };
+    if (!JsonHelper::validateKeys(jsonObj, keyInfoList, errorString)) {
+        return false;
+    }
+
+    const int version = jsonObj[JsonHelper::jsonVersionKey].toInt();
+    if (version != 1) {
+        errorString = QStringLiteral("Unsupported parameter metadata version %1").arg(version);
+        return false;
+    }
+
+    parameters = jsonObj["parameters"].toArray();
+    return true;
+}
+
+bool ParameterMetaDataStore::compile(const QByteArray& jsonBytes, QByteArray& store, QString& errorString)
+{
+    QJsonArray parameters;
+    if (!_jsonParameters(jsonBytes, parameters, errorString)) {
+        return false;
+    }
+
+    return compileParameters(parameters, store, errorString);
+}
+
+bool ParameterMetaDataStore::compileParameters(const QJsonArray& rgParameters, QByteArray& store, QString& errorString)
+{
+    StoreWriter writer;
+
+    // Later definitions of a name replace earlier ones
+    QStringList names;
+    QList<quint32> nameRecords;
+    QHash<QString, qsizetype> nameIndex;
+    QList<quint32> patterns;    // prefix string id, suffix string id, record offset
+
+    for (const QJsonValue& parameterValue : rgParameters) {
+        if (!parameterValue.isObject()) {
+            errorString = QStringLiteral("parameters array contains non-object");
+            return false;
+        }
+
+        const QJsonObject parameterObj = parameterValue.toObject();
+        const QString name = parameterObj["name"].toString();
+        if (name.isEmpty()) {
+            errorString = QStringLiteral("parameter without name");
+            return false;
+        }
+
+        const quint32 recordOffset = writer.appendRecord(parameterObj);
+
+        const qsizetype tagIndex = name.indexOf(QLatin1String(indexedNameTag));
+        if (tagIndex >= 0) {
+            patterns.append(writer.stringId(name.left(tagIndex)));
+            patterns.append(writer.stringId(name.mid(tagIndex + qstrlen(indexedNameTag))));
+            patterns.append(recordOffset);
+            continue;
+        }
+
+        const auto it = nameIndex.constFind(name);
+        if (it != nameIndex.constEnd()) {
+            nameRecords[*it] = recordOffset;
+        } else {
+            (void) nameIndex.insert(name, names.count());
+            names.append(name);
+            nameRecords.append(recordOffset);
+        }
+    }
+
+    QList<quint32> seeds;
+    QList<quint32> slots;
+    if (!_buildPerfectHash(names, seeds, slots)) {
+        errorString = QStringLiteral("Unable to build parameter name index");
+        return false;
+    }
+
+    QList<quint32> nameIds;
+    nameIds.reserve(names.count());
+    for (const QString& name : names) {
+        nameIds.append(writer.stringId(name));
+    }
+
+    QByteArray stringIndex;
+    QByteArray stringData;
+    for (const QString& string : writer.strings()) {
+        const QByteArray utf8 = string.toUtf8();
+        appendU32(stringIndex, static_cast<quint32>(stringData.size()));
+        appendU32(stringIndex, static_cast<quint32>(utf8.size()));
+        (void) stringData.append(utf8);
+    }
+
+    quint32 header[HeaderFieldCount] = {};
+    header[HeaderMagic] = kStoreMagic;
+    header[HeaderVersion] = kStoreVersion;
+    header[HeaderParamCount] = static_cast<quint32>(names.count());
+    header[HeaderBucketCount] = static_cast<quint32>(seeds.count());
+    header[HeaderSlotCount] = static_cast<quint32>(slots.count());
+    header[HeaderPatternCount] = static_cast<quint32>(patterns.count() / 3);
+    header[HeaderStringCount] = static_cast<quint32>(writer.strings().count());
+    header[HeaderBucketsOffset] = HeaderFieldCount * sizeof(quint32);
+    header[HeaderSlotsOffset] = header[HeaderBucketsOffset] + (header[HeaderBucketCount] * sizeof(quint32));
+    header[HeaderEntriesOffset] = header[HeaderSlotsOffset] + (header[HeaderSlotCount] * sizeof(quint32));
+    header[HeaderPatternsOffset] = header[HeaderEntriesOffset] + (header[HeaderParamCount] * 2 * sizeof(quint32));
+    header[HeaderStringsOffset] = header[HeaderPatternsOffset] + (header[HeaderPatternCount] * 3 * sizeof(quint32));
+    header[HeaderStringDataOffset] = header[HeaderStringsOffset] + static_cast<quint32>(stringIndex.size());
+    header[HeaderRecordsOffset] = header[HeaderStringDataOffset] + static_cast<quint32>(stringData.size());
+    header[HeaderSize] = header[HeaderRecordsOffset] + static_cast<quint32>(writer.records.size());
+
+    store.clear();
+    store.reserve(header[HeaderSize]);
+    for (const quint32 value : header) {
+        appendU32(store, value);
+    }
+    for (const quint32 seed : seeds) {
+        appendU32(store, seed);
+    }
+    for (const quint32 slot : slots) {
+        appendU32(store, slot);
+    }
+    for (qsizetype i = 0; i < names.count(); i++) {
+        appendU32(store, nameIds[i]);
+        appendU32(store, nameRecords[i]);
+    }
+    for (const quint32 value : patterns) {
+        appendU32(store, value);
+    }
+    (void) store.append(stringIndex);
+    (void) store.append(stringData);
+    (void) store.append(writer.records);
+
+    Q_ASSERT(static_cast<quint32>(store.size()) == header[HeaderSize]);
+
+    qCDebug(ParameterMetaDataStoreLog) << "Compiled" << names.count() << "parameters" << header[HeaderPatternCount] << "indexed names"
+                                       << writer.strings().count() << "strings" << store.size() << "bytes";
+
+    return true;
+}
+
+bool ParameterMetaDataStore::load(const QString& jsonFileName, const QString& cacheTag, const QString& cacheDirectory, QString& errorString)
+{
+    return loadConverted(jsonFileName, cacheTag, cacheDirectory, &ParameterMetaDataStore::_jsonParameters, errorString);
+}
+
+bool ParameterMetaDataStore::loadConverted(const QString& fileName, const QString& cacheTag, const QString& cacheDirectory, const Converter_t& converter, QString& errorString)
+{
+    close();
+
+    QFile sourceFile(fileName);
+    if (!sourceFile.open(QIODevice::ReadOnly)) {
+        errorString = QStringLiteral("File open failed: %1 %2").arg(fileName, sourceFile.errorString());
+        return false;
+    }
+    const QByteArray sourceBytes = sourceFile.readAll();
+    sourceFile.close();
+
+    const QString sourceHash = QString::fromLatin1(QCryptographicHash::hash(sourceBytes, QCryptographicHash::Sha1).toHex().left(16));
+    QString tag = cacheTag;
+    (void) tag.replace(QRegularExpression(QStringLiteral("[^A-Za-z0-9._-]")), QStringLiteral("_"));
+    const QDir cacheDir(cacheDirectory);
+    const QString storeFileName = cacheDir.filePath(QStringLiteral("%1-%2.pmds").arg(tag, sourceHash));
+
+    if (QFile::exists(storeFileName)) {
+        if (open(storeFileName, errorString)) {
+            qCDebug(ParameterMetaDataStoreLog) << "Cache hit" << storeFileName;
+            return true;
+        }
+        qCWarning(ParameterMetaDataStoreLog) << "Discarding unusable store" << storeFileName << errorString;
+        (void) QFile::remove(storeFileName);
+    }
+
+    QJsonArray parameters;
+    if (!converter(sourceBytes, parameters, errorString)) {
+        return false;
+    }
+
+    QByteArray store;
+    if (!compileParameters(parameters, store, errorString)) {
+        return false;
+    }
+
+    if (cacheDir.mkpath(QStringLiteral("."))) {
+        QSaveFile saveFile(storeFileName);
+        if (saveFile.open(QIODevice::WriteOnly) && (saveFile.write(store) == store.size()) && saveFile.commit()) {
+            QFileInfoList storeFiles = cacheDir.entryInfoList({ QStringLiteral("*.pmds") }, QDir::Files, QDir::Time);
+            while (storeFiles.count() > kMaxCacheFiles) {
+                const QFileInfo oldest = storeFiles.takeLast();
+                if (oldest.absoluteFilePath() == QFileInfo(storeFileName).absoluteFilePath()) {
+                    storeFiles.prepend(oldest);
+                    continue;
+                }
+                (void) QFile::remove(oldest.absoluteFilePath());
+            }
+
+            if (open(storeFileName, errorString)) {
+                return true;
+            }
+        } else {
+            qCWarning(ParameterMetaDataStoreLog) << "Unable to write" << storeFileName << saveFile.errorString();
+        }
+    }
+
+    // Uncached still beats parsing the json again on every lookup
+    return openData(store, errorString);
+}
+
+QString ParameterMetaDataStore::defaultCacheDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QStringLiteral("/QGCParamMetaDataStore");
+}
+
+bool ParameterMetaDataStore::open(const QString& storeFileName, QString& errorString)
+{
+    close();
+
+    _file.setFileName(storeFileName);
+    if (!_file.open(QIODevice::ReadOnly)) {
+        errorString = _file.errorString();
+        return false;
+    }
+
+    const qint64 size = _file.size();
+    if ((size < static_cast<qint64>(HeaderFieldCount * sizeof(quint32))) || (size > std::numeric_limits<quint32>::max())) {
+        errorString = QStringLiteral("Invalid store size");
+        close();
+        return false;
+    }
+
+    _data = _file.map(0, size);
+    if (!_data) {
+        errorString = _file.errorString();
+        close();
+        return false;
+    }
+    _size = static_cast<quint32>(size);
+
+    if (!_validate(errorString)) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+bool ParameterMetaDataStore::openData(const QByteArray& store, QString& errorString)
+{
+    close();
+
+    if ((store.size() < static_cast<qsizetype>(HeaderFieldCount * sizeof(quint32))) || (store.size() > std::numeric_limits<quint32>::max())) {
+        errorString = QStringLiteral("Invalid store size");
+        return false;
+    }
+
+    _memoryStore = store;
+    _data = reinterpret_cast<const uchar*>(_memoryStore.constData());
+    _size = static_cast<quint32>(_memoryStore.size());
+
+    if (!_validate(errorString)) {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void ParameterMetaDataStore::close()
+{
+    if (_file.isOpen()) {
+        if (_data) {
+            (void) _file.unmap(const_cast<uchar*>(_data));
+        }
+        _file.close();
+    }
+    _memoryStore.clear();
+    _data = nullptr;
+    _size = 0;
+}
+
+bool ParameterMetaDataStore::_validate(QString& errorString) const
+{
+    if ((_header(HeaderMagic) != kStoreMagic) || (_header(HeaderVersion) != kStoreVersion)) {
+        errorString = QStringLiteral("Not a parameter metadata store or wrong version");
+        return false;
+    }
+    if (_header(HeaderSize) != _size) {
+        errorString = QStringLiteral("Store truncated");
+        return false;
+    }
+
+    // Sections are laid out back to back, so checking the offsets chain up checks every table fits
+    const quint64 stringCount = _header(HeaderStringCount);
+    const struct {
+        HeaderField_t offset;
+        HeaderField_t nextOffset;
+        quint64 size;
+    } rgSections[] = {
+        { HeaderBucketsOffset,      HeaderSlotsOffset,      static_cast<quint64>(_header(HeaderBucketCount)) * sizeof(quint32) },
+        { HeaderSlotsOffset,        HeaderEntriesOffset,    static_cast<quint64>(_header(HeaderSlotCount)) * sizeof(quint32) },
+        { HeaderEntriesOffset,      HeaderPatternsOffset,   static_cast<quint64>(_header(HeaderParamCount)) * 2 * sizeof(quint32) },
+        { HeaderPatternsOffset,     HeaderStringsOffset,    static_cast<quint64>(_header(HeaderPatternCount)) * 3 * sizeof(quint32) },
+        { HeaderStringsOffset,      HeaderStringDataOffset, stringCount * 2 * sizeof(quint32) },
+    };
+    if (_header(HeaderBucketsOffset) != (HeaderFieldCount * sizeof(quint32))) {
+        errorString = QStringLiteral("Store corrupt");
+        return false;
+    }
+    for (const auto& section : rgSections) {
+        if ((static_cast<quint64>(_header(section.offset)) + section.size) != _header(section.nextOffset)) {
+            errorString = QStringLiteral("Store corrupt");
+            return false;
+        }
+    }
+    if ((_header(HeaderStringDataOffset) > _header(HeaderRecordsOffset)) || (_header(HeaderRecordsOffset) > _size) || (_header(HeaderBucketCount) == 0) || (_header(HeaderSlotCount) == 0)) {
+        errorString = QStringLiteral("Store corrupt");
+        return false;
+    }
+
+    const quint32 stringDataSize = _header(HeaderRecordsOffset) - _header(HeaderStringDataOffset);
+    for (quint32 i = 0; i < stringCount; i++) {
+        const quint32 entry = _header(HeaderStringsOffset) + (i * 2 * sizeof(quint32));
+        if ((static_cast<quint64>(_u32(entry)) + _u32(entry + sizeof(quint32))) > stringDataSize) {
+            errorString = QStringLiteral("Store corrupt");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int ParameterMetaDataStore::count() const
+{
+    return isOpen() ? static_cast<int>(_header(HeaderParamCount) + _header(HeaderPatternCount)) : 0;
+}
+
+quint32 ParameterMetaDataStore::_header(HeaderField_t field) const
+{
+    return qFromLittleEndian<quint32>(_data + (field * sizeof(quint32)));
+}
+
+quint32 ParameterMetaDataStore::_u32(quint32 offset) const
+{
+    return qFromLittleEndian<quint32>(_data + offset);
+}
+
+QString ParameterMetaDataStore::_string(quint32 stringId) const
+{
+    if (stringId >= _header(HeaderStringCount)) {
+        return QString();
+    }
+
+    const quint32 entry = _header(HeaderStringsOffset) + (stringId * 2 * sizeof(quint32));
+    const char* const string = reinterpret_cast<const char*>(_data + _header(HeaderStringDataOffset) + _u32(entry));
+    return QString::fromUtf8(string, _u32(entry + sizeof(quint32)));
+}
+
+bool ParameterMetaDataStore::_stringEquals(quint32 stringId, QStringView value) const
+{
+    if (stringId >= _header(HeaderStringCount)) {
+        return false;
+    }
+
+    const quint32 entry = _header(HeaderStringsOffset) + (stringId * 2 * sizeof(quint32));
+    const char* const string = reinterpret_cast<const char*>(_data + _header(HeaderStringDataOffset) + _u32(entry));
+    return QAnyStringView::equal(QUtf8StringView(string, _u32(entry + sizeof(quint32))), value);
+}
+
+bool ParameterMetaDataStore::_readValue(quint32& offset, QJsonValue& value, int depth) const
+{
+    const quint32 end = _size;
+    if ((depth > kMaxValueDepth) || (offset >= end)) {
+        return false;
+    }
+
+    const quint8 tag = _data[offset++];
+    switch (tag) {
+    case TagNull:
+        value = QJsonValue();
+        return true;
+    case TagFalse:
+    case TagTrue:
+        value = QJsonValue(tag == TagTrue);
+        return true;
+    case TagInteger:
+        if ((static_cast<quint64>(offset) + sizeof(qint64)) > end) {
+            return false;
+        }
+        value = QJsonValue(qFromLittleEndian<qint64>(_data + offset));
+        offset += sizeof(qint64);
+        return true;
+    case TagDouble:
+        if ((static_cast<quint64>(offset) + sizeof(double)) > end) {
+            return false;
+        }
+        value = QJsonValue(qFromLittleEndian<double>(_data + offset));
+        offset += sizeof(double);
+        return true;
+    case TagString:
+        if ((static_cast<quint64>(offset) + sizeof(quint32)) > end) {
+            return false;
+        }
+        value = QJsonValue(_string(_u32(offset)));
+        offset += sizeof(quint32);
+        return true;
+    case TagArray:
+    {
+        if ((static_cast<quint64>(offset) + sizeof(quint32)) > end) {
+            return false;
+        }
+        const quint32 count = _u32(offset);
+        offset += sizeof(quint32);
+
+        QJsonArray array;
+        for (quint32 i = 0; i < count; i++) {
+            QJsonValue arrayValue;
+            if (!_readValue(offset, arrayValue, depth + 1)) {
+                return false;
+            }
+            array.append(arrayValue);
+        }
+        value = array;
+        return true;
+    }
+    case TagObject:
+    {
+        if ((static_cast<quint64>(offset) + sizeof(quint32)) > end) {
+            return false;
+        }
+        const quint32 count = _u32(offset);
+        offset += sizeof(quint32);
+
+        QJsonObject object;
+        for (quint32 i = 0; i < count; i++) {
+            if ((static_cast<quint64>(offset) + sizeof(quint32)) > end) {
+                return false;
+            }
+            const QString key = _string(_u32(offset));
+            offset += sizeof(quint32);
+
+            QJsonValue objectValue;
+            if (!_readValue(offset, objectValue, depth + 1)) {
+                return false;
+            }
+            object.insert(key, objectValue);
+        }
+        value = object;
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+QJsonObject ParameterMetaDataStore::_record(quint32 recordOffset) const
+{
+    quint32 offset = _header(HeaderRecordsOffset) + recordOffset;
+    if (offset < recordOffset) {
+        return QJsonObject();
+    }
+
+    QJsonValue value;
+    if (!_readValue(offset, value, 0) || !value.isObject()) {
+        qCWarning(ParameterMetaDataStoreLog) << "Corrupt record at" << recordOffset;
+        return QJsonObject();
+    }
+
+    return value.toObject();
+}
+
+QJsonObject ParameterMetaDataStore::parameter(const QString& name, QString& indexValue) const
+{
+    indexValue.clear();
+
+    if (!isOpen()) {
+        return QJsonObject();
+    }
+
+    if (_header(HeaderParamCount) > 0) {
+        const quint32 bucket = _hash(name, 0) % _header(HeaderBucketCount);
+        const quint32 seed = _u32(_header(HeaderBucketsOffset) + (bucket * sizeof(quint32)));
+        if (seed != 0) {
+            const quint32 slot = _hash(name, seed) % _header(HeaderSlotCount);
+            const quint32 entryIndex = _u32(_header(HeaderSlotsOffset) + (slot * sizeof(quint32)));
+            if (entryIndex < _header(HeaderParamCount)) {
+                const quint32 entry = _header(HeaderEntriesOffset) + (entryIndex * 2 * sizeof(quint32));
+                if (_stringEquals(_u32(entry), name)) {
+                    return _record(_u32(entry + sizeof(quint32)));
+                }
+            }
+        }
+    }
+
+    // Indexed names, the last definition which matches wins
+    const quint32 patternCount = _header(HeaderPatternCount);
+    for (quint32 i = patternCount; i > 0; i--) {
+        const quint32 pattern = _header(HeaderPatternsOffset) + ((i - 1) * 3 * sizeof(quint32));
+        const QString prefix = _string(_u32(pattern));
+        const QString suffix = _string(_u32(pattern + sizeof(quint32)));
+        if ((name.size() <= (prefix.size() + suffix.size())) || !name.startsWith(prefix) || !name.endsWith(suffix)) {
+            continue;
+        }
+
+        const QStringView index = QStringView(name).mid(prefix.size(), name.size() - prefix.size() - suffix.size());
+        if (!std::all_of(index.cbegin(), index.cend(), [](QChar c) { return c.isDigit(); })) {
+            continue;
+        }
+
+        indexValue = index.toString();
+        return _record(_u32(pattern + (2 * sizeof(quint32))));
+    }
+
+    return QJsonObject();
+}
@@ -0,0 +1,138 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QJsonValue>
+#include <QtCore/QLoggingCategory>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+#include <functional>
+
+Q_DECLARE_LOGGING_CATEGORY(ParameterMetaDataStoreLog)
+
+/// Compiled form of a component information parameter metadata json file, so the json only has to be parsed once.
+/// The store is a single little endian file which is mapped in: a string table holding every distinct key and string
+/// value once, a perfect hash index over the parameter names and the parameters encoded against the string table.
+/// Indexed names such as "CAL_ACC{n}_ID" are kept as prefix and suffix so they match without regular expressions.
+/// A parameter's json object is only decoded when it is looked up.
+/// The firmware plugin xml metadata goes into the same kind of store, converted to one json object per parameter.
+class ParameterMetaDataStore
+{
+public:
+    ParameterMetaDataStore();
+    ~ParameterMetaDataStore();
+
+    /// Turns a metadata file into parameter json objects, each of which must have a "name"
+    ///     @return false if failed, errorString set
+    typedef std::function<bool(const QByteArray& fileBytes, QJsonArray& parameters, QString& errorString)> Converter_t;
+
+    /// Compiles the parameters from a version 1 parameter metadata json file
+    ///     @return false if failed, errorString set
+    static bool compile(const QByteArray& jsonBytes, QByteArray& store, QString& errorString);
+
+    /// Compiles parameter json objects, see Converter_t
+    ///     @return false if failed, errorString set
+    static bool compileParameters(const QJsonArray& parameters, QByteArray& store, QString& errorString);
+
+    /// Opens the store for jsonFileName from cacheDirectory, compiling it first if it isn't in the cache yet. Stores are
+    /// named by cacheTag (for example the firmware version) and a hash of the json, so a changed file compiles again.
+    ///     @return false if failed, errorString set
+    bool load(const QString& jsonFileName, const QString& cacheTag, const QString& cacheDirectory, QString& errorString);
+
+    /// Same as load for a file in another format. converter only runs if the cache has no store for the file yet, so
+    /// cacheTag should change whenever the converter's output does.
+    ///     @return false if failed, errorString set
+    bool loadConverted(const QString& fileName, const QString& cacheTag, const QString& cacheDirectory, const Converter_t& converter, QString& errorString);
+
+    /// Cache directory used by the vehicle's metadata loads
+    static QString defaultCacheDirectory();
+
+    /// Maps a store file written by compile()
+    ///     @return false if failed, errorString set
+    bool open(const QString& storeFileName, QString& errorString);
+
+    /// Uses a store held in memory
+    ///     @return false if failed, errorString set
+    bool openData(const QByteArray& store, QString& errorString);
+
+    void close();
+    bool isOpen() const { return _data != nullptr; }
+
+    /// Number of parameters including indexed names
+    int count() const;
+
+    /// Json object for the parameter, empty if the store has no metadata for it
+    ///     @param indexValue Set to the digits which matched {n} if the parameter came from an indexed name, empty otherwise
+    QJsonObject parameter(const QString& name, QString& indexValue) const;
+
+    static constexpr const char* indexedNameTag = "{n}";
+
+    static constexpr quint32 kStoreMagic = 0x534d5051;      ///< "QPMS"
+    static constexpr quint32 kStoreVersion = 1;
+    static constexpr int kMaxCacheFiles = 10;               ///< Older stores are removed from the cache directory
+
+private:
+    enum ValueTag_t : quint8 {
+        TagNull,
+        TagFalse,
+        TagTrue,
+        TagInteger,
+        TagDouble,
+        TagString,
+        TagArray,
+        TagObject
+    };
+
+    /// Header fields, each a quint32 at the start of the store
+    enum HeaderField_t {
+        HeaderMagic,
+        HeaderVersion,
+        HeaderParamCount,
+        HeaderBucketCount,
+        HeaderSlotCount,
+        HeaderPatternCount,
+        HeaderStringCount,
+        HeaderBucketsOffset,    ///< quint32 hash seed per bucket, 0 for an empty bucket
+        HeaderSlotsOffset,      ///< quint32 entry index per slot, kEmptySlot if unused
+        HeaderEntriesOffset,    ///< name string id and record offset per parameter
+        HeaderPatternsOffset,   ///< prefix string id, suffix string id and record offset per indexed name
+        HeaderStringsOffset,    ///< offset and length per string, relative to the string data
+        HeaderStringDataOffset,
+        HeaderRecordsOffset,
+        HeaderSize,             ///< Total size of the store
+        HeaderFieldCount
+    };
+
+    static bool _jsonParameters(const QByteArray& jsonBytes, QJsonArray& parameters, QString& errorString);
+    static quint32 _hash(QStringView name, quint32 seed);
+    static bool _buildPerfectHash(const QStringList& names, QList<quint32>& seeds, QList<quint32>& slots);
+
+    quint32 _header(HeaderField_t field) const;
+    quint32 _u32(quint32 offset) const;
+    QString _string(quint32 stringId) const;
+    bool _stringEquals(quint32 stringId, QStringView value) const;
+    bool _readValue(quint32& offset, QJsonValue& value, int depth) const;
+    QJsonObject _record(quint32 recordOffset) const;
+    bool _validate(QString& errorString) const;
+
+    QFile _file;
+    QByteArray _memoryStore;
+    const uchar* _data = nullptr;
+    quint32 _size = 0;
+
+    static constexpr quint32 kEmptySlot = 0xffffffff;
+    static constexpr int kMaxValueDepth = 16;               ///< Nesting allowed when decoding, guards against corrupt stores
+    static constexpr quint32 kMaxSeed = 1u << 20;           ///< Seeds tried per bucket before the slot table is grown
+};
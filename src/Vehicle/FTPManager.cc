@@ -26,59 +26,61 @@ FTPManager::FTPManager(Vehicle* vehicle)
     // Mock link responds immediately if at all, speed up unit tests with faster timoue
     _ackOrNakTimeoutTimer.setInterval(qgcApp()->runningUnitTests() ? 10 : _ackOrNakTimeoutMsecs);
     connect(&_ackOrNakTimeoutTimer, &QTimer::timeout, this, &FTPManager::_ackOrNakTimeout);
-    
+
+    // Downloads run several requests at once, each one keeps its own activity time which is checked here
+    _downloadTimeoutTimer.setInterval(qMax(1, _ackOrNakTimeoutTimer.interval() / 2));
+    connect(&_downloadTimeoutTimer, &QTimer::timeout, this, &FTPManager::_downloadTimeoutCheck);
+
     // Make sure we don't have bad structure packing
     Q_ASSERT(sizeof(MavlinkFTP::RequestHeader) == 12);
 }
 
+FTPManager::~FTPManager()
+{
+    qDeleteAll(_downloads);
+}
+
 bool FTPManager::download(uint8_t fromCompId, const QString& fromURI, const QString& toDir, const QString& fileName, bool checksize)
 {
     qCDebug(FTPManagerLog) << "download fromURI:" << fromURI << "to:" << toDir << "fromCompId:" << fromCompId;
 
-    if (!_rgStateMachine.isEmpty()) {
+    if (!_rgStateMachine.isEmpty() || !_downloads.isEmpty()) {
         qCDebug(FTPManagerLog) << "Cannot download. Already in another operation";
         return false;
     }
 
-    static const StateFunctions_t rgDownloadStateMachine[] = {
-        { &FTPManager::_openFileROBegin,            &FTPManager::_openFileROAckOrNak,           &FTPManager::_openFileROTimeout },
-        { &FTPManager::_burstReadFileBegin,         &FTPManager::_burstReadFileAckOrNak,        &FTPManager::_burstReadFileTimeout },
-        { &FTPManager::_fillMissingBlocksBegin,     &FTPManager::_fillMissingBlocksAckOrNak,    &FTPManager::_fillMissingBlocksTimeout },
-        { &FTPManager::_resetSessionsBegin,         &FTPManager::_resetSessionsAckOrNak,        &FTPManager::_resetSessionsTimeout },
-        { &FTPManager::_downloadCompleteNoError,    nullptr,                                    nullptr },
-    };
-    for (size_t i=0; i<sizeof(rgDownloadStateMachine)/sizeof(rgDownloadStateMachine[0]); i++) {
-        _rgStateMachine.append(rgDownloadStateMachine[i]);
+    if (!_queueDownload(fromCompId, fromURI, toDir, fileName, checksize)) {
+        return false;
     }
 
-    _downloadState.reset();
-    _downloadState.toDir.setPath(toDir);
-    _downloadState.checksize = checksize;
+    _startQueuedDownloads();
 
-    if (!_parseURI(fromCompId, fromURI, _downloadState.fullPathOnVehicle, _ftpCompId)) {
-        qCWarning(FTPManagerLog) << "_parseURI failed";
+    return true;
+}
+
+bool FTPManager::downloadFiles(uint8_t fromCompId, const QStringList& fromURIs, const QString& toDir)
+{
+    qCDebug(FTPManagerLog) << "downloadFiles fromURIs:" << fromURIs << "to:" << toDir << "fromCompId:" << fromCompId;
+
+    if (!_rgStateMachine.isEmpty() || !_downloads.isEmpty()) {
+        qCDebug(FTPManagerLog) << "Cannot download. Already in another operation";
         return false;
     }
 
-    // We need to strip off the file name from the fully qualified path. We can't use the usual QDir
-    // routines because this path does not exist locally.
-    int lastDirSlashIndex;
-    for (lastDirSlashIndex=_downloadState.fullPathOnVehicle.size()-1; lastDirSlashIndex>=0; lastDirSlashIndex--) {
-        if (_downloadState.fullPathOnVehicle[lastDirSlashIndex] == '/') {
-            break;
-        }
+    if (fromURIs.isEmpty()) {
+        return false;
     }
-    lastDirSlashIndex++; // move past slash
 
-    if (fileName.isEmpty()) {
-        _downloadState.fileName = _downloadState.fullPathOnVehicle.right(_downloadState.fullPathOnVehicle.size() - lastDirSlashIndex);
-    } else {
-        _downloadState.fileName = fileName;
+    for (const QString& fromURI: fromURIs) {
+        if (!_queueDownload(fromCompId, fromURI, toDir, QString(), true /* checksize */)) {
+            qDeleteAll(_downloads);
+            _downloads.clear();
+            return false;
+        }
     }
 
-    qCDebug(FTPManagerLog) << "_downloadState.fullPathOnVehicle:_downloadState.fileName" << _downloadState.fullPathOnVehicle << _downloadState.fileName;
-
-    _startStateMachine();
+    _sessionLimit = _maxSessions;
+    _startQueuedDownloads();
 
     return true;
 }
@@ -87,7 +89,7 @@ bool FTPManager::listDirectory(uint8_t fromCompId, const QString& fromURI)
 {
     qCDebug(FTPManagerLog) << "list directory fromURI:" << fromURI << "fromCompId:" << fromCompId;
 
-    if (!_rgStateMachine.isEmpty()) {
+    if (!_rgStateMachine.isEmpty() || !_downloads.isEmpty()) {
         qCDebug(FTPManagerLog) << "Cannot list directory. Already in another operation";
         return false;
     }
@@ -114,85 +116,177 @@ bool FTPManager::listDirectory(uint8_t fromCompId, const QString& fromURI)
     return true;
 }
 
+FTPManager::Download_t* FTPManager::_queueDownload(uint8_t fromCompId, const QString& fromURI, const QString& toDir, const QString& fileName, bool checksize)
+{
+    Download_t* download = new Download_t;
+    download->toDir.setPath(toDir);
+    download->checksize = checksize;
+
+    if (!_parseURI(fromCompId, fromURI, download->fullPathOnVehicle, download->compId)) {
+        qCWarning(FTPManagerLog) << "_parseURI failed";
+        delete download;
+        return nullptr;
+    }
+
+    // Sessions belong to a single component
+    if (!_downloads.isEmpty() && (download->compId != _downloads.first()->compId)) {
+        qCWarning(FTPManagerLog) << "All files must be downloaded from the same component" << fromURI;
+        delete download;
+        return nullptr;
+    }
+    _ftpCompId = download->compId;
+
+    // We need to strip off the file name from the fully qualified path. We can't use the usual QDir
+    // routines because this path does not exist locally.
+    int lastDirSlashIndex;
+    for (lastDirSlashIndex=download->fullPathOnVehicle.size()-1; lastDirSlashIndex>=0; lastDirSlashIndex--) {
+        if (download->fullPathOnVehicle[lastDirSlashIndex] == '/') {
+            break;
+        }
+    }
+    lastDirSlashIndex++; // move past slash
+
+    if (fileName.isEmpty()) {
+        download->fileName = download->fullPathOnVehicle.right(download->fullPathOnVehicle.size() - lastDirSlashIndex);
+    } else {
+        download->fileName = fileName;
+    }
+
+    qCDebug(FTPManagerLog) << "fullPathOnVehicle:fileName" << download->fullPathOnVehicle << download->fileName;
+
+    _downloads.append(download);
+
+    return download;
+}
+
 void FTPManager::cancelDownload()
 {
-    if (!_downloadState.inProgress()) {
+    if (_downloads.isEmpty()) {
         return;
     }
 
-    _ackOrNakTimeoutTimer.stop();
-    _rgStateMachine.clear();
-    static const StateFunctions_t rgTerminateStateMachine[] = {
-        { &FTPManager::_terminateSessionBegin,  &FTPManager::_terminateSessionAckOrNak,     &FTPManager::_terminateSessionTimeout },
-        { &FTPManager::_terminateComplete,      nullptr,                                    nullptr },
-    };
-    for (size_t i=0; i<sizeof(rgTerminateStateMachine)/sizeof(rgTerminateStateMachine[0]); i++) {
-        _rgStateMachine.append(rgTerminateStateMachine[i]);
+    // Downloads which have not been opened yet have nothing to clean up on the vehicle
+    QList<Download_t*> rgQueued;
+    const QList<Download_t*> downloads = _downloads;
+    for (Download_t* download: downloads) {
+        download->canceled = true;
+        switch (download->state) {
+        case Download_t::Queued:
+            rgQueued.append(download);
+            break;
+        case Download_t::Reading:
+            _terminateSession(download, QStringLiteral("Aborted"));
+            break;
+        case Download_t::Opening:
+            // Terminated once the open is acked
+        case Download_t::Terminating:
+            break;
+        }
+    }
+
+    for (Download_t* download: rgQueued) {
+        _downloadComplete(download, QStringLiteral("Aborted"));
     }
-    _downloadState.retryCount = 0;
-    _startStateMachine();
 }
 
-void FTPManager::_terminateSessionBegin(void)
+FTPManager::TransferStats_t FTPManager::transferStats(void) const
 {
-    MavlinkFTP::Request request{};
-    request.hdr.session = _downloadState.sessionId;
-    request.hdr.opcode  = MavlinkFTP::kCmdTerminateSession;
-    _sendRequestExpectAck(&request);
+    TransferStats_t stats = _transferStats;
+    if (_transferElapsed.isValid()) {
+        stats.elapsedMsecs += _transferElapsed.elapsed();
+    }
+    return stats;
 }
 
-void FTPManager::_terminateSessionAckOrNak(const MavlinkFTP::Request *ackOrNak)
+void FTPManager::resetTransferStats(void)
 {
-    MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
-    if (requestOpCode != MavlinkFTP::kCmdTerminateSession) {
-        qCDebug(FTPManagerLog) << "_terminateSessionAckOrNak: Ack disregarding ack for incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
-        return;
+    _transferStats = TransferStats_t();
+    if (_transferElapsed.isValid()) {
+        _transferElapsed.start();
     }
-    if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
-        qCDebug(FTPManagerLog) << "_terminateSessionAckOrNak: Ack disregarding ack for incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
+}
+
+void FTPManager::_startQueuedDownloads(void)
+{
+    int         activeCount = 0;
+    Download_t* next        = nullptr;
+    for (Download_t* download: _downloads) {
+        if (download->state == Download_t::Queued) {
+            if (!next && !download->canceled) {
+                next = download;
+            }
+        } else if (download->state == Download_t::Opening) {
+            // Only one open at a time, the ack is how we find out which session the vehicle handed out
+            return;
+        } else {
+            activeCount++;
+        }
+    }
+
+    if (!next || (activeCount >= _sessionLimit)) {
         return;
     }
 
-    _ackOrNakTimeoutTimer.stop();
-    _advanceStateMachine();
+    if (!_transferElapsed.isValid()) {
+        _transferElapsed.start();
+    }
+    if (!_downloadTimeoutTimer.isActive()) {
+        _downloadTimeoutTimer.start();
+    }
+
+    _openFileRO(next);
 }
 
-void FTPManager::_terminateSessionTimeout(void)
+void FTPManager::_terminateSession(Download_t* download, const QString& errorMsg)
 {
-    if (++_downloadState.retryCount > _maxRetry) {
-        qCDebug(FTPManagerLog) << QString("_terminateSessionTimeout retries exceeded");
-        _downloadComplete(tr("Download failed"));
-    } else {
-        // Try again
-        qCDebug(FTPManagerLog) << QString("_terminateSessionTimeout: retrying - retryCount(%1)").arg(_downloadState.retryCount);
-        _terminateSessionBegin();
+    if (download->state != Download_t::Terminating) {
+        download->retryCount = 0;
     }
+    download->state     = Download_t::Terminating;
+    download->errorMsg  = errorMsg;
+    download->rgReadsInFlight.clear();
 
-}
+    MavlinkFTP::Request request{};
+    request.hdr.session = download->sessionId;
+    request.hdr.opcode  = MavlinkFTP::kCmdTerminateSession;
+    _sendRequest(&request);
 
-void FTPManager::_terminateComplete(void)
-{
-    _downloadComplete("Aborted");
+    download->lastActivity.start();
 }
 
-/// Closes out a download session by writing the file and doing cleanup.
+/// Closes out a download by closing the file and doing cleanup.
 ///     @param errorMsg Error message, empty if no error
-void FTPManager::_downloadComplete(const QString& errorMsg)
+void FTPManager::_downloadComplete(Download_t* download, const QString& errorMsg)
 {
-    qCDebug(FTPManagerLog) << QString("_downloadComplete: errorMsg(%1)").arg(errorMsg);
-    
-    QString downloadFilePath    = _downloadState.toDir.absoluteFilePath(_downloadState.fileName);
-    QString error               = errorMsg;
+    qCDebug(FTPManagerLog) << QString("_downloadComplete: file(%1) errorMsg(%2)").arg(download->fileName, errorMsg);
 
-    _ackOrNakTimeoutTimer.stop();
-    _rgStateMachine.clear();
-    _currentStateMachineIndex = -1;
-    if (_downloadState.file.isOpen()) {
-        _downloadState.file.close();
+    const QString downloadFilePath = download->localFilePath();
+
+    if (download->file.isOpen()) {
+        download->file.close();
         if (!errorMsg.isEmpty()) {
-            _downloadState.file.remove();
+            download->file.remove();
         }
     }
+    if (errorMsg.isEmpty()) {
+        _transferStats.filesCompleted++;
+    }
+
+    (void) _downloads.removeOne(download);
+    delete download;
+
+    if (_downloads.isEmpty()) {
+        _downloadTimeoutTimer.stop();
+        if (_transferElapsed.isValid()) {
+            _transferStats.elapsedMsecs += _transferElapsed.elapsed();
+            _transferElapsed.invalidate();
+        }
+        qCDebug(FTPManagerLog) << "Downloads complete - bytes:duplicates:bursts:gapReads:timeouts:bytesPerSecond"
+                               << _transferStats.bytesReceived << _transferStats.duplicateBytes << _transferStats.burstRequests
+                               << _transferStats.gapReads << _transferStats.timeouts << _transferStats.bytesPerSecond();
+    } else {
+        _startQueuedDownloads();
+    }
 
     emit downloadComplete(downloadFilePath, errorMsg);
 }
@@ -222,10 +316,6 @@ void FTPManager::_mavlinkMessageReceived(const mavlink_message_t& message)
         return;
     }
 
-    if (_currentStateMachineIndex == -1) {
-        return;
-    }
-
     mavlink_file_transfer_protocol_t data;
     mavlink_msg_file_transfer_protocol_decode(&message, &data);
 
@@ -237,6 +327,23 @@ void FTPManager::_mavlinkMessageReceived(const mavlink_message_t& message)
     
     MavlinkFTP::Request* request = (MavlinkFTP::Request*)&data.payload[0];
 
+    if (!_downloads.isEmpty()) {
+        switch (request->hdr.req_opcode) {
+        case MavlinkFTP::kCmdOpenFileRO:
+        case MavlinkFTP::kCmdReadFile:
+        case MavlinkFTP::kCmdBurstReadFile:
+        case MavlinkFTP::kCmdTerminateSession:
+            _downloadAckOrNak(request);
+            return;
+        default:
+            break;
+        }
+    }
+
+    if (_currentStateMachineIndex == -1) {
+        return;
+    }
+
     // Ignore old/reordered packets (handle wrap-around properly)
     uint16_t actualIncomingSeqNumber = request->hdr.seqNumber;
     if ((uint16_t)((_expectedIncomingSeqNumber - 1) - actualIncomingSeqNumber) < (std::numeric_limits<uint16_t>::max()/2)) {
@@ -293,182 +400,479 @@ QString FTPManager::_errorMsgFromNak(const MavlinkFTP::Request* nak)
     return errorMsg;
 }
 
-void FTPManager::_openFileROBegin(void)
+void FTPManager::_openFileRO(Download_t* download)
 {
+    download->state = Download_t::Opening;
+
     MavlinkFTP::Request request{};
     request.hdr.session = 0;
     request.hdr.opcode  = MavlinkFTP::kCmdOpenFileRO;
     request.hdr.offset  = 0;
     request.hdr.size    = 0;
-    _fillRequestDataWithString(&request, _downloadState.fullPathOnVehicle);
-    _sendRequestExpectAck(&request);
+    _fillRequestDataWithString(&request, download->fullPathOnVehicle);
+    _sendRequest(&request);
+
+    download->openSeqNumber = request.hdr.seqNumber;
+    download->lastActivity.start();
 }
 
-void FTPManager::_openFileROTimeout(void)
+FTPManager::Download_t* FTPManager::_downloadForSession(uint8_t sessionId) const
 {
-    qCDebug(FTPManagerLog) << "_openFileROTimeout";
-    _downloadComplete(tr("Download failed"));
+    for (Download_t* download: _downloads) {
+        if (((download->state == Download_t::Reading) || (download->state == Download_t::Terminating)) && (download->sessionId == sessionId)) {
+            return download;
+        }
+    }
+
+    return nullptr;
 }
 
-void FTPManager::_openFileROAckOrNak(const MavlinkFTP::Request* ackOrNak)
+void FTPManager::_downloadAckOrNak(const MavlinkFTP::Request* ackOrNak)
 {
-    MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
-    if (requestOpCode != MavlinkFTP::kCmdOpenFileRO) {
-        qCDebug(FTPManagerLog) << "_openFileROAckOrNak: Ack disregarding ack for incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
+    // Bursts advance the sequence number by more than one per request. Keep outgoing requests ahead of everything
+    // the vehicle has sent so they are never mistaken for a resend of an earlier request.
+    if ((uint16_t)(ackOrNak->hdr.seqNumber - _expectedIncomingSeqNumber) < (std::numeric_limits<uint16_t>::max()/2)) {
+        _expectedIncomingSeqNumber = ackOrNak->hdr.seqNumber;
+    }
+
+    const MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
+
+    if (requestOpCode == MavlinkFTP::kCmdOpenFileRO) {
+        for (Download_t* download: _downloads) {
+            if ((download->state == Download_t::Opening) && ((uint16_t)(download->openSeqNumber + 1) == ackOrNak->hdr.seqNumber)) {
+                _openFileROAckOrNak(download, ackOrNak);
+                return;
+            }
+        }
+        qCDebug(FTPManagerLog) << "_downloadAckOrNak: Disregarding open ack with unexpected sequence" << ackOrNak->hdr.seqNumber;
         return;
     }
-    if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
-        qCDebug(FTPManagerLog) << "_openFileROAckOrNak: Ack disregarding ack for incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
+
+    Download_t* download = _downloadForSession(ackOrNak->hdr.session);
+    if (!download) {
+        qCDebug(FTPManagerLog) << "_downloadAckOrNak: Disregarding due to unknown session id" << ackOrNak->hdr.session << MavlinkFTP::opCodeToString(requestOpCode);
         return;
     }
 
-    _ackOrNakTimeoutTimer.stop();
+    switch (requestOpCode) {
+    case MavlinkFTP::kCmdBurstReadFile:
+        if (download->state == Download_t::Reading) {
+            _burstReadAckOrNak(download, ackOrNak);
+        }
+        break;
+    case MavlinkFTP::kCmdReadFile:
+        if (download->state == Download_t::Reading) {
+            _readAckOrNak(download, ackOrNak);
+        }
+        break;
+    case MavlinkFTP::kCmdTerminateSession:
+        if (download->state == Download_t::Terminating) {
+            _downloadComplete(download, download->errorMsg);
+        }
+        break;
+    default:
+        break;
+    }
+}
 
+void FTPManager::_openFileROAckOrNak(Download_t* download, const MavlinkFTP::Request* ackOrNak)
+{
     if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
         qCDebug(FTPManagerLog) << "_openFileROAckOrNak: Ack  - sessionId:openFileLength" << ackOrNak->hdr.session << ackOrNak->openFileLength;
 
         if (ackOrNak->hdr.size != sizeof(uint32_t)) {
             qCDebug(FTPManagerLog) << "_openFileROAckOrNak: Ack ack->hdr.size != sizeof(uint32_t)" << ackOrNak->hdr.size << sizeof(uint32_t);
-            _downloadComplete(tr("Download failed"));
+            _downloadComplete(download, tr("Download failed"));
             return;
         }
 
-        _downloadState.sessionId        = ackOrNak->hdr.session;
-        _downloadState.fileSize         = ackOrNak->openFileLength;
-        _downloadState.expectedOffset   = 0;
+        download->state         = Download_t::Reading;
+        download->sessionId     = ackOrNak->hdr.session;
+        download->fileSize      = ackOrNak->openFileLength;
+        download->retryCount    = 0;
+        download->lastActivity.start();
 
-        _downloadState.file.setFileName(_downloadState.toDir.filePath(_downloadState.fileName));
-        if (_downloadState.file.open(QFile::WriteOnly | QFile::Truncate)) {
-            _advanceStateMachine();
-        } else {
-            qCDebug(FTPManagerLog) << "_openFileROAckOrNak: Ack _downloadState.file open failed" << _downloadState.file.errorString();
-            _downloadComplete(tr("Download failed"));
+        uint32_t sessionCount = 0;
+        for (const Download_t* other: _downloads) {
+            if ((other->state == Download_t::Reading) || (other->state == Download_t::Terminating)) {
+                sessionCount++;
+            }
+        }
+        _transferStats.peakSessions = qMax(_transferStats.peakSessions, sessionCount);
+
+        if (download->canceled) {
+            _terminateSession(download, QStringLiteral("Aborted"));
+            return;
+        }
+
+        // Data is written where it lands, so the file is allocated up front when the size is known
+        download->file.setFileName(download->localFilePath());
+        if (!download->file.open(QFile::WriteOnly | QFile::Truncate) || (download->checksize && !download->file.resize(download->fileSize))) {
+            qCDebug(FTPManagerLog) << "_openFileROAckOrNak: Ack file open failed" << download->file.errorString();
+            _terminateSession(download, tr("Download failed"));
+            return;
+        }
+
+        if (!download->checksize) {
+            // The size can't be trusted, so the hole runs to the end of the address space until a read hits EOF
+            download->rgMissingData.append({ 0, _openEndedHoleSize });
+        } else if (download->fileSize > 0) {
+            download->rgMissingData.append({ 0, download->fileSize });
         }
+
+        // The next file can be opened while this one streams
+        _startQueuedDownloads();
+
+        _requestBurst(download);
+        _checkDownloadComplete(download);
     } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
-        qCDebug(FTPManagerLog) << "_handlOpenFileROAck: Nak -" << _errorMsgFromNak(ackOrNak);
-        _downloadComplete(tr("Download failed") + ": " + _errorMsgFromNak(ackOrNak));
+        const MavlinkFTP::ErrorCode_t errorCode = static_cast<MavlinkFTP::ErrorCode_t>(ackOrNak->data[0]);
+
+        int activeCount = 0;
+        for (const Download_t* other: _downloads) {
+            if ((other != download) && (other->state != Download_t::Queued)) {
+                activeCount++;
+            }
+        }
+
+        if ((errorCode == MavlinkFTP::kErrNoSessionsAvailable) && (activeCount > 0)) {
+            // The vehicle supports fewer sessions than we tried, wait for one of the others to finish
+            qCDebug(FTPManagerLog) << "_openFileROAckOrNak: No sessions available, limiting to" << activeCount;
+            _sessionLimit   = activeCount;
+            download->state = Download_t::Queued;
+            _transferStats.sessionRequeues++;
+            return;
+        }
+
+        qCDebug(FTPManagerLog) << "_openFileROAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
+        _downloadComplete(download, tr("Download failed") + ": " + _errorMsgFromNak(ackOrNak));
     }
 }
 
-void FTPManager::_burstReadFileWorker(bool firstRequest)
+void FTPManager::_requestBurst(Download_t* download)
 {
-    qCDebug(FTPManagerLog) << "_burstReadFileWorker: starting burst at offset:firstRequest:retryCount" << _downloadState.expectedOffset << firstRequest << _downloadState.retryCount;
+    // Continue from where the last burst stopped, or skip ahead to the next hole if that part is already filled
+    bool        found   = false;
+    uint32_t    offset  = download->burstOffset;
+    for (const MissingData_t& missingData: download->rgMissingData) {
+        if ((missingData.offset + missingData.cBytesMissing) > offset) {
+            offset  = qMax(offset, missingData.offset);
+            found   = true;
+            break;
+        }
+    }
+
+    if (!found) {
+        // Everything past the burst is here, targeted reads take care of the rest
+        download->burstDone = true;
+        _requestMissingData(download);
+        return;
+    }
+
+    qCDebug(FTPManagerLog) << "_requestBurst: file:offset" << download->fileName << offset;
+
+    download->burstOffset = offset;
 
     MavlinkFTP::Request request{};
-    request.hdr.session = _downloadState.sessionId;
+    request.hdr.session = download->sessionId;
     request.hdr.opcode  = MavlinkFTP::kCmdBurstReadFile;
-    request.hdr.offset  = _downloadState.expectedOffset;
+    request.hdr.offset  = offset;
     request.hdr.size    = sizeof(request.data);
+    _sendRequest(&request);
 
-    if (firstRequest) {
-        _downloadState.retryCount = 0;
-    } else {
-        // Must used same sequence number as previous request
-        _expectedIncomingSeqNumber -= 2;
-    }
-
-    _sendRequestExpectAck(&request);
+    _transferStats.burstRequests++;
+    download->lastActivity.start();
 }
 
-void FTPManager::_burstReadFileBegin(void)
+void FTPManager::_requestMissingData(Download_t* download)
 {
-    _burstReadFileWorker(true /* firstRequestr */);
+    if (download->state != Download_t::Reading) {
+        return;
+    }
+
+    // Holes behind the burst are filled with targeted reads while the burst keeps streaming, holes ahead of it are
+    // left to the burst
+    const uint32_t limit = download->burstDone ? std::numeric_limits<uint32_t>::max() : download->burstOffset;
+
+    for (const MissingData_t& missingData: download->rgMissingData) {
+        if (missingData.offset >= limit) {
+            break;
+        }
+
+        const uint32_t missingEnd = missingData.offset + missingData.cBytesMissing;
+        for (uint32_t offset = missingData.offset; (offset < missingEnd) && (offset < limit); offset += sizeof(MavlinkFTP::Request::data)) {
+            if (download->rgReadsInFlight.count() >= _maxReadsInFlight) {
+                return;
+            }
+
+            bool inFlight = false;
+            for (const ReadInFlight_t& read: download->rgReadsInFlight) {
+                if (read.offset == offset) {
+                    inFlight = true;
+                    break;
+                }
+            }
+            if (inFlight) {
+                continue;
+            }
+
+            MavlinkFTP::Request request{};
+            request.hdr.session = download->sessionId;
+            request.hdr.opcode  = MavlinkFTP::kCmdReadFile;
+            request.hdr.offset  = offset;
+            request.hdr.size    = static_cast<uint8_t>(qMin(static_cast<uint32_t>(sizeof(request.data)), missingEnd - offset));
+            _sendRequest(&request);
+
+            download->rgReadsInFlight.append({ offset, request.hdr.seqNumber });
+            _transferStats.gapReads++;
+        }
+    }
 }
 
-void FTPManager::_burstReadFileAckOrNak(const MavlinkFTP::Request* ackOrNak)
+void FTPManager::_burstReadAckOrNak(Download_t* download, const MavlinkFTP::Request* ackOrNak)
 {
-    MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
+    if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
+        qCDebug(FTPManagerLog) << QString("_burstReadAckOrNak: Ack offset(%1) size(%2) burstComplete(%3)").arg(ackOrNak->hdr.offset).arg(ackOrNak->hdr.size).arg(ackOrNak->hdr.burstComplete);
 
-    if (requestOpCode != MavlinkFTP::kCmdBurstReadFile) {
-        qCDebug(FTPManagerLog) << "_burstReadFileAckOrNak: Disregarding due to incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
-        return;
-    }
-    if (ackOrNak->hdr.session != _downloadState.sessionId) {
-        qCDebug(FTPManagerLog) << "_burstReadFileAckOrNak: Disregarding due to incorrect session id actual:expected" << ackOrNak->hdr.session << _downloadState.sessionId;
-        return;
+        if (ackOrNak->hdr.offset > download->burstOffset) {
+            qCDebug(FTPManagerLog) << "_burstReadAckOrNak: hole offset:cBytesMissing" << download->burstOffset << (ackOrNak->hdr.offset - download->burstOffset);
+        }
+
+        if (!_writeData(download, ackOrNak->hdr.offset, ackOrNak->data, ackOrNak->hdr.size)) {
+            _terminateSession(download, tr("Download failed: Error saving file"));
+            return;
+        }
+
+        download->burstOffset = qMax(download->burstOffset, static_cast<uint32_t>(ackOrNak->hdr.offset + ackOrNak->hdr.size));
+        download->retryCount = 0;
+        download->lastActivity.start();
+
+        if (ackOrNak->hdr.burstComplete) {
+            _requestBurst(download);
+        }
+    } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
+        const MavlinkFTP::ErrorCode_t errorCode = static_cast<MavlinkFTP::ErrorCode_t>(ackOrNak->data[0]);
+
+        if (errorCode != MavlinkFTP::kErrEOF) {
+            qCDebug(FTPManagerLog) << "_burstReadAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
+            _terminateSession(download, tr("Download failed"));
+            return;
+        }
+
+        // The burst has gone through the whole file. Without a trusted size the end is confirmed by a read past
+        // the data received so far, which comes back as EOF.
+        qCDebug(FTPManagerLog) << "_burstReadAckOrNak EOF";
+        download->burstDone = true;
+        download->lastActivity.start();
     }
 
-    _ackOrNakTimeoutTimer.stop();
+    _requestMissingData(download);
+    _checkDownloadComplete(download);
+
+    // Emit progress last, as cancel could be called in there
+    _emitDownloadProgress();
+}
+
+void FTPManager::_readAckOrNak(Download_t* download, const MavlinkFTP::Request* ackOrNak)
+{
+    int readIndex = -1;
+    for (int i=0; i<download->rgReadsInFlight.count(); i++) {
+        const ReadInFlight_t& read = download->rgReadsInFlight[i];
+        if (((uint16_t)(read.seqNumber + 1) == ackOrNak->hdr.seqNumber) ||
+                ((ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) && (read.offset == ackOrNak->hdr.offset))) {
+            readIndex = i;
+            break;
+        }
+    }
 
     if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
-        if (ackOrNak->hdr.seqNumber < _expectedIncomingSeqNumber) {
-            qCDebug(FTPManagerLog) << "_burstReadFileAckOrNak: Disregarding Ack due to incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
-            return;
+        qCDebug(FTPManagerLog) << "_readAckOrNak: Ack offset:size" << ackOrNak->hdr.offset << ackOrNak->hdr.size;
+
+        if (readIndex >= 0) {
+            download->rgReadsInFlight.removeAt(readIndex);
         }
 
-        qCDebug(FTPManagerLog) << QString("_burstReadFileAckOrNak: Ack offset(%1) size(%2) burstComplete(%3)").arg(ackOrNak->hdr.offset).arg(ackOrNak->hdr.size).arg(ackOrNak->hdr.burstComplete);
+        if (!_writeData(download, ackOrNak->hdr.offset, ackOrNak->data, ackOrNak->hdr.size)) {
+            _terminateSession(download, tr("Download failed: Error saving file"));
+            return;
+        }
 
-        if (ackOrNak->hdr.offset != _downloadState.expectedOffset) {
-            if (ackOrNak->hdr.offset > _downloadState.expectedOffset) {
-                // There is a hole in our data, record it as missing and continue on
-                MissingData_t missingData;
-                missingData.offset          = _downloadState.expectedOffset;
-                missingData.cBytesMissing   = ackOrNak->hdr.offset - _downloadState.expectedOffset;
-                _downloadState.rgMissingData.append(missingData);
-                qCDebug(FTPManagerLog) << "_handleBurstReadFileAck: adding missing data offset:cBytesMissing" << missingData.offset << missingData.cBytesMissing;
-            } else {
-                // Offset is past what we have already seen, disregard and wait for something usefule
-                _ackOrNakTimeoutTimer.start();
-                qCDebug(FTPManagerLog) << "_handleBurstReadFileAck: received offset less than expected offset received:expected" << ackOrNak->hdr.offset << _downloadState.expectedOffset;
-                return;
-            }
+        download->retryCount = 0;
+        download->lastActivity.start();
+    } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
+        if (readIndex < 0) {
+            qCDebug(FTPManagerLog) << "_readAckOrNak: Disregarding Nak for unknown read" << ackOrNak->hdr.seqNumber;
+            return;
         }
 
-        _downloadState.file.seek(ackOrNak->hdr.offset);
-        int bytesWritten = _downloadState.file.write((const char*)ackOrNak->data, ackOrNak->hdr.size);
-        if (bytesWritten != ackOrNak->hdr.size) {
-            _downloadComplete(tr("Download failed: Error saving file"));
+        const ReadInFlight_t read = download->rgReadsInFlight.takeAt(readIndex);
+        const MavlinkFTP::ErrorCode_t errorCode = static_cast<MavlinkFTP::ErrorCode_t>(ackOrNak->data[0]);
+
+        if ((errorCode == MavlinkFTP::kErrEOF) && !download->checksize) {
+            // The file ends before the size reported by the open
+            qCDebug(FTPManagerLog) << "_readAckOrNak EOF at offset" << read.offset;
+            _truncateMissingData(download, read.offset);
+            download->lastActivity.start();
+        } else {
+            qCDebug(FTPManagerLog) << "_readAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak) << "offset" << read.offset;
+            _terminateSession(download, tr("Download failed"));
             return;
         }
-        _downloadState.bytesWritten += ackOrNak->hdr.size;
-        _downloadState.expectedOffset = ackOrNak->hdr.offset + ackOrNak->hdr.size;
+    }
 
-        if (ackOrNak->hdr.burstComplete) {
-            // The current burst is done, request next one in offset sequence
-            _expectedIncomingSeqNumber = ackOrNak->hdr.seqNumber;
-            _burstReadFileWorker(true /* firstRequest */);
+    _requestMissingData(download);
+    _checkDownloadComplete(download);
+
+    // Emit progress last, as cancel could be called in there
+    _emitDownloadProgress();
+}
+
+/// Writes the parts of the data which fill holes and removes them from the missing data list
+///     @return false: error writing file
+bool FTPManager::_writeData(Download_t* download, uint32_t offset, const uint8_t* data, uint32_t size)
+{
+    const uint32_t  end         = offset + size;
+    uint32_t        newBytes    = 0;
+
+    for (int i=0; i<download->rgMissingData.count();) {
+        const uint32_t missingOffset    = download->rgMissingData[i].offset;
+        const uint32_t missingEnd       = missingOffset + download->rgMissingData[i].cBytesMissing;
+
+        if (missingEnd <= offset) {
+            i++;
+            continue;
+        }
+        if (missingOffset >= end) {
+            break;
+        }
+
+        const uint32_t writeOffset  = qMax(offset, missingOffset);
+        const uint32_t writeEnd     = qMin(end, missingEnd);
+        if (!download->file.seek(writeOffset) ||
+                (download->file.write(reinterpret_cast<const char*>(data + (writeOffset - offset)), writeEnd - writeOffset) != (writeEnd - writeOffset))) {
+            qCDebug(FTPManagerLog) << "_writeData: write failed" << download->file.errorString();
+            return false;
+        }
+        newBytes += writeEnd - writeOffset;
+
+        // Cut the written range out of the hole
+        if ((writeOffset == missingOffset) && (writeEnd == missingEnd)) {
+            download->rgMissingData.removeAt(i);
+        } else if (writeOffset == missingOffset) {
+            download->rgMissingData[i] = { writeEnd, missingEnd - writeEnd };
+            i++;
+        } else if (writeEnd == missingEnd) {
+            download->rgMissingData[i].cBytesMissing = writeOffset - missingOffset;
+            i++;
         } else {
-            // Still within a burst, next ack should come automatically
-            _expectedIncomingSeqNumber = ackOrNak->hdr.seqNumber + 1;
-            _ackOrNakTimeoutTimer.start();
+            download->rgMissingData[i].cBytesMissing = writeOffset - missingOffset;
+            download->rgMissingData.insert(i + 1, { writeEnd, missingEnd - writeEnd });
+            i += 2;
         }
+    }
 
-        // Emit progress last, as cancel could be called in there
-        if (_downloadState.fileSize != 0) {
-            emit commandProgress((float)(_downloadState.bytesWritten) / (float)_downloadState.fileSize);
+    if (!download->checksize) {
+        // Keeps progress sensible when the file is larger than the open reported
+        download->fileSize = qMax(download->fileSize, end);
+    }
+
+    download->bytesWritten          += newBytes;
+    _transferStats.bytesReceived    += newBytes;
+    _transferStats.duplicateBytes   += size - newBytes;
+
+    return true;
+}
+
+void FTPManager::_truncateMissingData(Download_t* download, uint32_t endOffset)
+{
+    for (int i=download->rgMissingData.count()-1; i>=0; i--) {
+        MissingData_t& missingData = download->rgMissingData[i];
+        if (missingData.offset >= endOffset) {
+            download->rgMissingData.removeAt(i);
+        } else if ((missingData.offset + missingData.cBytesMissing) > endOffset) {
+            missingData.cBytesMissing = endOffset - missingData.offset;
         }
-    } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
-        MavlinkFTP::ErrorCode_t errorCode = static_cast<MavlinkFTP::ErrorCode_t>(ackOrNak->data[0]);
+    }
 
-        if (errorCode == MavlinkFTP::kErrEOF) {
-            // Burst sequence has gone through the whole file
-            if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
-                qCDebug(FTPManagerLog) << "_burstReadFileAckOrNak: EOF Nak"
-                    "with incorrect sequence nr actual:expected"
-                    << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
-                /* We have received the EOF Nak but out of sequence, i.e. data is missing */
-                _expectedIncomingSeqNumber = ackOrNak->hdr.seqNumber;
-                _burstReadFileWorker(true); /* Retry from last expected offset */
-            } else {
-                qCDebug(FTPManagerLog) << "_burstReadFileAckOrNak EOF";
-                _advanceStateMachine();
-            }
-        } else { /* Don't care is this is out of sequence */
-            qCDebug(FTPManagerLog) << "_burstReadFileAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
-            _downloadComplete(tr("Download failed"));
+    for (int i=download->rgReadsInFlight.count()-1; i>=0; i--) {
+        if (download->rgReadsInFlight[i].offset >= endOffset) {
+            download->rgReadsInFlight.removeAt(i);
         }
     }
+
+    download->fileSize = download->checksize ? qMin(download->fileSize, endOffset) : endOffset;
 }
 
-void FTPManager::_burstReadFileTimeout(void)
+void FTPManager::_checkDownloadComplete(Download_t* download)
 {
-    if (++_downloadState.retryCount > _maxRetry) {
-        qCDebug(FTPManagerLog) << QString("_burstReadFileTimeout retries exceeded");
-        _downloadComplete(tr("Download failed"));
-    } else {
-        // Try again
-        qCDebug(FTPManagerLog) << QString("_burstReadFileTimeout: retrying - retryCount(%1) offset(%2)").arg(_downloadState.retryCount).arg(_downloadState.expectedOffset);
-        _burstReadFileWorker(false /* firstReqeust */);
+    if ((download->state == Download_t::Reading) && download->rgMissingData.isEmpty()) {
+        qCDebug(FTPManagerLog) << "_checkDownloadComplete: all data received" << download->fileName << download->bytesWritten;
+        _terminateSession(download, QString());
+    }
+}
+
+void FTPManager::_emitDownloadProgress(void)
+{
+    uint64_t bytesWritten   = 0;
+    uint64_t fileSize       = 0;
+    for (const Download_t* download: _downloads) {
+        bytesWritten    += download->bytesWritten;
+        fileSize        += download->fileSize;
+    }
+
+    if (fileSize != 0) {
+        emit commandProgress(static_cast<float>(bytesWritten) / static_cast<float>(fileSize));
+    }
+}
+
+void FTPManager::_downloadTimeoutCheck(void)
+{
+    const int timeoutMsecs = _ackOrNakTimeoutTimer.interval();
+
+    const QList<Download_t*> downloads = _downloads;
+    for (Download_t* download: downloads) {
+        if (!_downloads.contains(download)) {
+            // Completed by an earlier timeout in this pass
+            continue;
+        }
+        if ((download->state == Download_t::Queued) || (download->lastActivity.elapsed() < timeoutMsecs)) {
+            continue;
+        }
+
+        _transferStats.timeouts++;
+
+        switch (download->state) {
+        case Download_t::Opening:
+            qCDebug(FTPManagerLog) << "_downloadTimeoutCheck: open timeout" << download->fileName;
+            _downloadComplete(download, download->canceled ? QStringLiteral("Aborted") : tr("Download failed"));
+            break;
+        case Download_t::Reading:
+            if (++download->retryCount > _maxRetry) {
+                qCDebug(FTPManagerLog) << "_downloadTimeoutCheck: retries exceeded" << download->fileName;
+                _terminateSession(download, tr("Download failed"));
+            } else {
+                // Whatever was in flight is lost, ask again
+                qCDebug(FTPManagerLog) << QString("_downloadTimeoutCheck: retrying - retryCount(%1) burstOffset(%2)").arg(download->retryCount).arg(download->burstOffset);
+                download->rgReadsInFlight.clear();
+                if (!download->burstDone) {
+                    _requestBurst(download);
+                }
+                _requestMissingData(download);
+                download->lastActivity.start();
+            }
+            break;
+        case Download_t::Terminating:
+            if (++download->retryCount > _maxRetry) {
+                // The file is complete either way, only the session is left open on the vehicle
+                qCDebug(FTPManagerLog) << "_downloadTimeoutCheck: terminate session retries exceeded" << download->fileName;
+                _downloadComplete(download, download->errorMsg);
+            } else {
+                _terminateSession(download, download->errorMsg);
+            }
+            break;
+        case Download_t::Queued:
+            break;
+        }
     }
 }
 
@@ -477,7 +881,7 @@ void FTPManager::_listDirectoryWorker(bool firstRequest)
     qCDebug(FTPManagerLog) << "_listDirectoryWorker: offset:firstRequest:retryCount" << _listDirectoryState.expectedOffset << firstRequest << _listDirectoryState.retryCount;
 
     MavlinkFTP::Request request{};
-    request.hdr.session = _downloadState.sessionId;
+    request.hdr.session = 0;
     request.hdr.opcode  = MavlinkFTP::kCmdListDirectory;
     request.hdr.offset  = _listDirectoryState.expectedOffset;
     request.hdr.size    = sizeof(request.data);
@@ -561,181 +965,20 @@ void FTPManager::_listDirectoryTimeout(void)
     }
 }
 
-void FTPManager::_fillMissingBlocksWorker(bool firstRequest)
-{
-    if (_downloadState.rgMissingData.count()) {
-        MavlinkFTP::Request request{};
-        MissingData_t&      missingData = _downloadState.rgMissingData.first();
-
-        uint32_t cBytesToRead = qMin((uint32_t)sizeof(request.data), missingData.cBytesMissing);
-
-        qCDebug(FTPManagerLog) << "_fillMissingBlocksBegin: offset:cBytesToRead" << missingData.offset << cBytesToRead;
-
-        request.hdr.session                 = _downloadState.sessionId;
-        request.hdr.opcode                  = MavlinkFTP::kCmdReadFile;
-        request.hdr.offset                  = missingData.offset;
-        request.hdr.size                    = cBytesToRead;
-
-        if (firstRequest) {
-            _downloadState.retryCount = 0;
-        } else {
-            // Must used same sequence number as previous request
-            _expectedIncomingSeqNumber -= 2;
-        }
-        _downloadState.expectedOffset = request.hdr.offset;
-
-        _sendRequestExpectAck(&request);
-    } else {
-        // We should have the full file now
-        if (_downloadState.checksize == false || _downloadState.bytesWritten == _downloadState.fileSize) {
-            _advanceStateMachine();
-        } else {
-            qCDebug(FTPManagerLog) << "_fillMissingBlocksWorker: no missing blocks but file still incomplete - bytesWritten:fileSize" << _downloadState.bytesWritten << _downloadState.fileSize;
-            _downloadComplete(tr("Download failed"));
-        }
-    }
-}
-
-void FTPManager::_fillMissingBlocksBegin(void)
-{
-    _fillMissingBlocksWorker(true /* firstRequest */);
-}
-
-void FTPManager::_fillMissingBlocksAckOrNak(const MavlinkFTP::Request* ackOrNak)
-{
-    MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
-
-    if (requestOpCode != MavlinkFTP::kCmdReadFile) {
-        qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Disregarding due to incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
-        return;
-    }
-    if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
-        qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Disregarding due to incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
-        return;
-    }
-    if (ackOrNak->hdr.session != _downloadState.sessionId) {
-        qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Disregarding due to incorrect session id actual:expected" << ackOrNak->hdr.session << _downloadState.sessionId;
-        return;
-    }
-
-    _ackOrNakTimeoutTimer.stop();
-
-    if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
-        qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Ack offset:size" << ackOrNak->hdr.offset << ackOrNak->hdr.size;
-
-        if (ackOrNak->hdr.offset != _downloadState.expectedOffset) {
-            if (++_downloadState.retryCount > _maxRetry) {
-                qCDebug(FTPManagerLog) << QString("_fillMissingBlocksAckOrNak: offset mismatch, retries exceeded");
-                _downloadComplete(tr("Download failed"));
-                return;
-            }
-
-            // Ask for current offset again
-            qCDebug(FTPManagerLog) << QString("_fillMissingBlocksAckOrNak: Ack offset mismatch retry, retryCount(%1) offset(%2)").arg(_downloadState.retryCount).arg(_downloadState.expectedOffset);
-            _fillMissingBlocksWorker(false /* firstReqeust */);
-            return;
-        }
-
-        _downloadState.file.seek(ackOrNak->hdr.offset);
-        int bytesWritten = _downloadState.file.write((const char*)ackOrNak->data, ackOrNak->hdr.size);
-        if (bytesWritten != ackOrNak->hdr.size) {
-            _downloadComplete(tr("Download failed: Error saving file"));
-            return;
-        }
-        _downloadState.bytesWritten += ackOrNak->hdr.size;
-
-        MissingData_t& missingData = _downloadState.rgMissingData.first();
-        missingData.offset += ackOrNak->hdr.size;
-        missingData.cBytesMissing -= ackOrNak->hdr.size;
-        if (missingData.cBytesMissing == 0) {
-            // This block is finished, remove it
-            _downloadState.rgMissingData.takeFirst();
-        }
-
-        // Move on to fill in possible next hole
-        _fillMissingBlocksWorker(true /* firstReqeust */);
-
-        // Emit progress last, as cancel could be called in there
-        if (_downloadState.fileSize != 0) {
-            emit commandProgress((float)(_downloadState.bytesWritten) / (float)_downloadState.fileSize);
-        }
-    } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
-        MavlinkFTP::ErrorCode_t errorCode = static_cast<MavlinkFTP::ErrorCode_t>(ackOrNak->data[0]);
-
-        if (errorCode == MavlinkFTP::kErrEOF) {
-            qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak EOF";
-            if (_downloadState.checksize == false || _downloadState.bytesWritten == _downloadState.fileSize) {
-                // We've successfully complete filling in all missing blocks
-                _advanceStateMachine();
-                return;
-            }
-        }
-
-        qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
-        _downloadComplete(tr("Download failed"));
-    }
-}
-
-void FTPManager::_fillMissingBlocksTimeout(void)
-{
-    if (++_downloadState.retryCount > _maxRetry) {
-        qCDebug(FTPManagerLog) << QString("_fillMissingBlocksTimeout retries exceeded");
-        _downloadComplete(tr("Download failed"));
-    } else {
-        // Ask for current offset again
-        qCDebug(FTPManagerLog) << QString("_fillMissingBlocksTimeout: retrying - retryCount(%1) offset(%2)").arg(_downloadState.retryCount).arg(_downloadState.expectedOffset);
-        _fillMissingBlocksWorker(false /* firstReqeust */);
-    }
-}
-
-void FTPManager::_resetSessionsBegin(void)
-{
-    MavlinkFTP::Request request{};
-    request.hdr.opcode  = MavlinkFTP::kCmdResetSessions;
-    request.hdr.size    = 0;
-    _sendRequestExpectAck(&request);
-}
-
-void FTPManager::_resetSessionsAckOrNak(const MavlinkFTP::Request* ackOrNak)
-{
-    MavlinkFTP::OpCode_t requestOpCode = static_cast<MavlinkFTP::OpCode_t>(ackOrNak->hdr.req_opcode);
-
-    if (requestOpCode != MavlinkFTP::kCmdResetSessions) {
-        qCDebug(FTPManagerLog) << "_fillMissingBlocksAckOrNak: Disregarding due to incorrect requestOpCode" << MavlinkFTP::opCodeToString(requestOpCode);
-        return;
-    }
-    if (ackOrNak->hdr.seqNumber != _expectedIncomingSeqNumber) {
-        qCDebug(FTPManagerLog) << "_resetSessionsAckOrNak: Disregarding due to incorrect sequence actual:expected" << ackOrNak->hdr.seqNumber << _expectedIncomingSeqNumber;
-        return;
-    }
-
-    _ackOrNakTimeoutTimer.stop();
-
-    if (ackOrNak->hdr.opcode == MavlinkFTP::kRspAck) {
-        qCDebug(FTPManagerLog) << "_resetSessionsAckOrNak: Ack";
-        _advanceStateMachine();
-    } else if (ackOrNak->hdr.opcode == MavlinkFTP::kRspNak) {
-        qCDebug(FTPManagerLog) << "_resetSessionsAckOrNak: Nak -" << _errorMsgFromNak(ackOrNak);
-        _downloadComplete(QString());
-    }
-}
-
-void FTPManager::_resetSessionsTimeout(void)
+void FTPManager::_sendRequestExpectAck(MavlinkFTP::Request* request)
 {
-    qCDebug(FTPManagerLog) << "_resetSessionsTimeout";
-    _downloadComplete(QString());
+    _ackOrNakTimeoutTimer.start();
+    _sendRequest(request);
 }
 
-void FTPManager::_sendRequestExpectAck(MavlinkFTP::Request* request)
+void FTPManager::_sendRequest(MavlinkFTP::Request* request)
 {
-    _ackOrNakTimeoutTimer.start();
-    
     SharedLinkInterfacePtr sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
     if (sharedLink) {
         request->hdr.seqNumber = _expectedIncomingSeqNumber + 1;    // Outgoing is 1 past last incoming
         _expectedIncomingSeqNumber += 2;
 
-        qCDebug(FTPManagerLog) << "_sendRequestExpectAck opcode:" << MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.opcode)) << "seqNumber:" << request->hdr.seqNumber;
+        qCDebug(FTPManagerLog) << "_sendRequest opcode:" << MavlinkFTP::opCodeToString(static_cast<MavlinkFTP::OpCode_t>(request->hdr.opcode)) << "seqNumber:" << request->hdr.seqNumber;
 
         mavlink_message_t message;
         mavlink_msg_file_transfer_protocol_pack_chan(MAVLinkProtocol::instance()->getSystemId(),
@@ -748,7 +991,7 @@ void FTPManager::_sendRequestExpectAck(MavlinkFTP::Request* request)
                                                      (uint8_t*)request);                                    // Payload
         _vehicle->sendMessageOnLinkThreadSafe(sharedLink.get(), message);
     } else {
-        qCDebug(FTPManagerLog) << "_sendRequestExpectAck No primary link. Allowing timeout to fail sequence.";
+        qCDebug(FTPManagerLog) << "_sendRequest No primary link. Allowing timeout to fail sequence.";
     }
 }
 
@@ -784,20 +1027,3 @@ bool FTPManager::_parseURI(uint8_t fromCompId, const QString& uri, QString& pars
 
     return true;
 }
-
-bool FTPManager::_isListDirectoryStateMachine(void)
-{
-    if (_rgStateMachine.isEmpty()) {
-        qCWarning(FTPManagerLog) << "INTERNAL ERROR: _isListDirectoryStateMachine called with empty state machine";
-        return false;
-    }
-
-    if (_rgStateMachine[0].beginFn == &FTPManager::_listDirectoryBegin) {
-        return true;
-    } else if (_rgStateMachine[0].beginFn == &FTPManager::_openFileROBegin) {
-        return false;
-    } else {
-        qCWarning(FTPManagerLog) << "INTERNAL ERROR: _isListDirectoryStateMachine called with invalid state machine";
-        return false;
-    }
-}
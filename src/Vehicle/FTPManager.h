@@ -13,9 +13,12 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QTimer>
 #include <QtCore/QLoggingCategory>
 
+#include <limits>
+
 Q_DECLARE_LOGGING_CATEGORY(FTPManagerLog)
 
 class Vehicle;
@@ -28,6 +31,22 @@ class FTPManager : public QObject
     
 public:
     FTPManager(Vehicle* vehicle);
+    ~FTPManager();
+
+    /// Throughput of the downloads since the last call to resetTransferStats
+    struct TransferStats_t {
+        uint64_t    bytesReceived   = 0;    ///< File bytes written, duplicates not included
+        uint64_t    duplicateBytes  = 0;    ///< Bytes received for data which was already written
+        uint32_t    burstRequests   = 0;
+        uint32_t    gapReads        = 0;    ///< Targeted reads sent to fill holes left by a burst
+        uint32_t    timeouts        = 0;
+        uint32_t    filesCompleted  = 0;
+        uint32_t    peakSessions    = 0;    ///< Most sessions open on the vehicle at the same time
+        uint32_t    sessionRequeues = 0;    ///< Opens refused with kErrNoSessionsAvailable and queued again
+        qint64      elapsedMsecs    = 0;    ///< Time during which at least one download was active
+
+        double bytesPerSecond() const { return (elapsedMsecs > 0) ? ((bytesReceived * 1000.0) / elapsedMsecs) : 0.0; }
+    };
 
 	/// Downloads the specified file.
     ///     @param fromCompId Component id of the component to download from. If fromCompId is MAV_COMP_ID_ALL, then MAV_COMP_ID_AUTOPILOT1 is used.
@@ -44,6 +63,14 @@ class FTPManager : public QObject
     /// Signals downloadComplete, commandProgress
     bool download(uint8_t fromCompId, const QString& fromURI, const QString& toDir, const QString& fileName="", bool checksize = true);
 
+    /// Downloads several files from the same component, using parallel sessions up to the number the vehicle allows.
+    ///     @param fromCompId Component id of the component to download from, see download
+    ///     @param fromURIs   Files to download, see download
+    ///     @param toDir      Local directory to download the files to
+    /// @return true: downloads have started, false: error, no download
+    /// Signals downloadComplete once for each file, commandProgress for the files combined
+    bool downloadFiles(uint8_t fromCompId, const QStringList& fromURIs, const QString& toDir);
+
 	/// Get the directory listing of the specified directory.
     ///     @param fromCompId Component id of the component to download from. If fromCompId is MAV_COMP_ID_ALL, then MAV_COMP_ID_AUTOPILOT1 is used.
     ///     @param fromURI    Directory path to list from component. May be in the format "mftp://[;comp=<id>]..." where the component id
@@ -53,9 +80,12 @@ class FTPManager : public QObject
     bool listDirectory(uint8_t fromCompId, const QString& fromURI);
 
     /// Cancel the download operation
-    /// This will emit downloadComplete() when done, and if there's currently a download in progress
+    /// This will emit downloadComplete() when done, for each download in progress
     void cancelDownload();
 
+    TransferStats_t transferStats   (void) const;
+    void            resetTransferStats(void);
+
     static constexpr const char* mavlinkFTPScheme = "mftp";
 
 signals:
@@ -68,6 +98,7 @@ class FTPManager : public QObject
 	
 private slots:
     void _ackOrNakTimeout(void);
+    void _downloadTimeoutCheck(void);
 
 private:
     typedef void (FTPManager::*StateBeginFn)    (void);
@@ -85,32 +116,41 @@ private slots:
         uint32_t cBytesMissing;
     };
 
-    struct DownloadState_t {
-        uint8_t                 sessionId;
-        uint32_t                expectedOffset;         ///< offset which should be coming next
-        uint32_t                bytesWritten;
-        QList<MissingData_t>    rgMissingData;
-        QString                 fullPathOnVehicle;      ///< Fully qualified path to file on vehicle
-        QDir                    toDir;                  ///< Directory to download file to
-        QString                 fileName;               ///< Filename (no path) for download file
-        uint32_t                fileSize;               ///< Size of file being downloaded
-        QFile                   file;
-        int                     retryCount;
-        bool                    checksize;
-
-        bool inProgress() const { return fileSize > 0; }
+    struct ReadInFlight_t {
+        uint32_t offset;
+        uint16_t seqNumber;                     ///< Sequence number of the request, the (n)ack comes back with seqNumber + 1
+    };
 
-        void reset() {
-            sessionId       = 0;
-            expectedOffset  = 0;
-            bytesWritten    = 0;
-            retryCount      = 0;
-            fileSize        = 0;
-            fullPathOnVehicle.clear();
-            fileName.clear();
-            rgMissingData.clear();
-            file.close();
-        }
+    /// State of a single file download. Each download has its own session on the vehicle.
+    struct Download_t {
+        enum State_t {
+            Queued,                             ///< Waiting for a free session
+            Opening,                            ///< kCmdOpenFileRO sent
+            Reading,                            ///< Bursting and filling holes
+            Terminating,                        ///< kCmdTerminateSession sent, file complete or aborted
+        };
+
+        State_t                 state           = Queued;
+        uint8_t                 compId          = MAV_COMP_ID_AUTOPILOT1;
+        uint8_t                 sessionId       = 0;
+        uint16_t                openSeqNumber   = 0;
+        QString                 fullPathOnVehicle;          ///< Fully qualified path to file on vehicle
+        QDir                    toDir;                      ///< Directory to download file to
+        QString                 fileName;                   ///< Filename (no path) for download file
+        uint32_t                fileSize        = 0;        ///< Size from the open response. If !checksize it only guides progress until EOF is found.
+        bool                    checksize       = true;
+        QFile                   file;
+        QList<MissingData_t>    rgMissingData;              ///< Holes still to be filled, sorted by offset
+        QList<ReadInFlight_t>   rgReadsInFlight;            ///< Targeted reads waiting for an ack
+        uint32_t                burstOffset     = 0;        ///< Offset the burst is expected to deliver next
+        bool                    burstDone       = false;    ///< The burst has reached the end of the file
+        uint32_t                bytesWritten    = 0;
+        int                     retryCount      = 0;
+        bool                    canceled        = false;
+        QString                 errorMsg;                   ///< Reported once the session is terminated
+        QElapsedTimer           lastActivity;
+
+        QString localFilePath() const { return toDir.absoluteFilePath(fileName); }
     };
 
     struct ListDirectoryState_t {
@@ -137,46 +177,49 @@ private slots:
     void    _listDirectoryBegin         (void);
     void    _listDirectoryAckOrNak      (const MavlinkFTP::Request* ackOrNak);
     void    _listDirectoryTimeout       (void);
-    void    _openFileROBegin            (void);
-    void    _openFileROAckOrNak         (const MavlinkFTP::Request* ackOrNak);
-    void    _openFileROTimeout          (void);
-    void    _burstReadFileBegin         (void);
-    void    _burstReadFileAckOrNak      (const MavlinkFTP::Request* ackOrNak);
-    void    _burstReadFileTimeout       (void);
-    void    _fillMissingBlocksBegin     (void);
-    void    _fillMissingBlocksAckOrNak  (const MavlinkFTP::Request* ackOrNak);
-    void    _fillMissingBlocksTimeout   (void);
-    void    _resetSessionsBegin         (void);
-    void    _resetSessionsAckOrNak      (const MavlinkFTP::Request* ackOrNak);
-    void    _resetSessionsTimeout       (void);
     QString _errorMsgFromNak            (const MavlinkFTP::Request* nak);
     void    _sendRequestExpectAck       (MavlinkFTP::Request* request);
-    void    _downloadCompleteNoError    (void) { _downloadComplete(QString()); }
-    void    _downloadComplete           (const QString& errorMsg);
+    void    _sendRequest                (MavlinkFTP::Request* request);
     void    _fillRequestDataWithString(MavlinkFTP::Request* request, const QString& str);
-    void    _fillMissingBlocksWorker    (bool firstRequest);
-    void    _burstReadFileWorker        (bool firstRequest);
     void    _listDirectoryWorker        (bool firstRequest);
     bool    _parseURI                   (uint8_t fromCompId, const QString& uri, QString& parsedURI, uint8_t& compId);
-    bool    _isListDirectoryStateMachine(void);
     void    _listDirectoryCompleteNoError(void) { _listDirectoryComplete(QString()); }
     void    _listDirectoryComplete      (const QString& errorMsg);
 
-    void    _terminateSessionBegin      (void);
-    void    _terminateSessionAckOrNak   (const MavlinkFTP::Request* ackOrNak);
-    void    _terminateSessionTimeout    (void);
-    void    _terminateComplete          (void);
+    Download_t* _queueDownload          (uint8_t fromCompId, const QString& fromURI, const QString& toDir, const QString& fileName, bool checksize);
+    void    _startQueuedDownloads       (void);
+    void    _openFileRO                 (Download_t* download);
+    void    _openFileROAckOrNak         (Download_t* download, const MavlinkFTP::Request* ackOrNak);
+    void    _downloadAckOrNak           (const MavlinkFTP::Request* ackOrNak);
+    void    _burstReadAckOrNak          (Download_t* download, const MavlinkFTP::Request* ackOrNak);
+    void    _readAckOrNak               (Download_t* download, const MavlinkFTP::Request* ackOrNak);
+    bool    _writeData                  (Download_t* download, uint32_t offset, const uint8_t* data, uint32_t size);
+    void    _truncateMissingData        (Download_t* download, uint32_t endOffset);
+    void    _requestBurst               (Download_t* download);
+    void    _requestMissingData         (Download_t* download);
+    void    _checkDownloadComplete      (Download_t* download);
+    void    _terminateSession           (Download_t* download, const QString& errorMsg);
+    void    _downloadComplete           (Download_t* download, const QString& errorMsg);
+    void    _emitDownloadProgress       (void);
+    Download_t* _downloadForSession     (uint8_t sessionId) const;
 
     Vehicle*                _vehicle;
     uint8_t                 _ftpCompId = MAV_COMP_ID_AUTOPILOT1;
     QList<StateFunctions_t> _rgStateMachine;
-    DownloadState_t         _downloadState;
+    QList<Download_t*>      _downloads;                     ///< Queued and active downloads, in request order
+    int                     _sessionLimit               = _maxSessions; ///< Lowered to what the vehicle accepts when it runs out of sessions
     ListDirectoryState_t    _listDirectoryState;
     QTimer                  _ackOrNakTimeoutTimer;
+    QTimer                  _downloadTimeoutTimer;
     int                     _currentStateMachineIndex   = -1;
     uint16_t                _expectedIncomingSeqNumber  = 0;
-    
+    TransferStats_t         _transferStats;
+    QElapsedTimer           _transferElapsed;               ///< Running while any download is active
+
     static const int _ackOrNakTimeoutMsecs  = 1000;
     static const int _maxRetry              = 3;
+    static const int _maxSessions           = 4;            ///< Parallel sessions used by downloadFiles
+    static const int _maxReadsInFlight      = 4;            ///< Per download, while the burst keeps streaming
+    static constexpr uint32_t _openEndedHoleSize = std::numeric_limits<uint32_t>::max();    ///< Hole from offset 0 to the unknown end of a !checksize file
 };
 
@@ -25,6 +25,7 @@ VehicleGPSFactGroup::VehicleGPSFactGroup(QObject *parent)
     _addFact(&_yawFact);
     _addFact(&_lockFact);
     _addFact(&_countFact);
+    _addFact(&_correctionAgeFact);
 
     _latFact.setRawValue(std::numeric_limits<float>::quiet_NaN());
     _lonFact.setRawValue(std::numeric_limits<float>::quiet_NaN());
@@ -33,6 +34,7 @@ VehicleGPSFactGroup::VehicleGPSFactGroup(QObject *parent)
     _vdopFact.setRawValue(std::numeric_limits<float>::quiet_NaN());
     _courseOverGroundFact.setRawValue(std::numeric_limits<float>::quiet_NaN());
     _yawFact.setRawValue(std::numeric_limits<int16_t>::quiet_NaN());
+    _correctionAgeFact.setRawValue(std::numeric_limits<double>::quiet_NaN());
 }
 
 void VehicleGPSFactGroup::handleMessage(Vehicle *vehicle, const mavlink_message_t &message)
@@ -23,6 +23,7 @@ class VehicleGPSFactGroup : public FactGroup
     Q_PROPERTY(Fact *yaw                READ yaw                CONSTANT)
     Q_PROPERTY(Fact *count              READ count              CONSTANT)
     Q_PROPERTY(Fact *lock               READ lock               CONSTANT)
+    Q_PROPERTY(Fact *correctionAge      READ correctionAge      CONSTANT)
 
 public:
     explicit VehicleGPSFactGroup(QObject *parent = nullptr);
@@ -36,6 +37,7 @@ class VehicleGPSFactGroup : public FactGroup
     Fact *yaw() { return &_yawFact; }
     Fact *count() { return &_countFact; }
     Fact *lock() { return &_lockFact; }
+    Fact *correctionAge() { return &_correctionAgeFact; }
 
     // Overrides from FactGroup
     void handleMessage(Vehicle *vehicle, const mavlink_message_t &message) override;
@@ -54,4 +56,5 @@ class VehicleGPSFactGroup : public FactGroup
     Fact _yawFact = Fact(0, QStringLiteral("yaw"), FactMetaData::valueTypeDouble);
     Fact _countFact = Fact(0, QStringLiteral("count"), FactMetaData::valueTypeInt32);
     Fact _lockFact = Fact(0, QStringLiteral("lock"), FactMetaData::valueTypeInt32);
+    Fact _correctionAgeFact = Fact(0, QStringLiteral("correctionAge"), FactMetaData::valueTypeDouble);   ///< Set by GPSRtk while streaming
 };
@@ -23,14 +23,16 @@
 QGC_LOGGING_CATEGORY(InitialConnectStateMachineLog, "qgc.vehicle.initialconnectstatemachine")
 
 InitialConnectStateMachine::InitialConnectStateMachine(Vehicle *vehicle, QObject *parent)
-    : StateMachine(parent)
+    : QObject(parent)
     , _vehicle(vehicle)
 {
-    static_assert(std::size(_rgStates) == std::size(_rgProgressWeights), "array size mismatch");
+    static_assert(StepCount <= 32, "step mask too small");
 
-    _progressWeightTotal = 0;
-    for (int i = 0; i < _cStates; ++i) {
-        _progressWeightTotal += _rgProgressWeights[i];
+    for (int i = 0; i < StepCount; ++i) {
+        _progressWeightTotal += _rgSteps[i].progressWeight;
+        _rgStepStates[i] = StepWaiting;
+        _rgStepProgress[i] = 0;
+        _rgStepTimings[i] = { -1, -1, -1, -1 };
     }
 
     // qCDebug(InitialConnectStateMachineLog) << Q_FUNC_INFO << this;
@@ -41,55 +43,175 @@ InitialConnectStateMachine::~InitialConnectStateMachine()
     // qCDebug(InitialConnectStateMachineLog) << Q_FUNC_INFO << this;
 }
 
-int InitialConnectStateMachine::stateCount(void) const
+const char* InitialConnectStateMachine::stepName(Step_t step)
 {
-    return _cStates;
+    switch (step) {
+    case StepAutopilotVersion:
+        return "AutopilotVersion";
+    case StepProtocolVersion:
+        return "ProtocolVersion";
+    case StepStandardModes:
+        return "StandardModes";
+    case StepCompInfo:
+        return "CompInfo";
+    case StepParameters:
+        return "Parameters";
+    case StepMission:
+        return "Mission";
+    case StepGeoFence:
+        return "GeoFence";
+    case StepRallyPoints:
+        return "RallyPoints";
+    default:
+        return "Unknown";
+    }
 }
 
-const InitialConnectStateMachine::StateFn* InitialConnectStateMachine::rgStates(void) const
+void InitialConnectStateMachine::start()
 {
-    return &_rgStates[0];
+    _active = true;
+    _slowLink = _isSlowLink();
+    _connectMsecs = -1;
+    _stepEventCount = 0;
+    _connectTimer.start();
+
+    qCDebug(InitialConnectStateMachineLog) << "Starting initial connect - slow link:" << _slowLink;
+
+    _startReadySteps();
 }
 
-void InitialConnectStateMachine::statesCompleted(void) const
+bool InitialConnectStateMachine::_isSlowLink() const
 {
+    SharedLinkInterfacePtr sharedLink = _vehicle->vehicleLinkManager()->primaryLink().lock();
+    if (!sharedLink) {
+        return false;
+    }
+
+    const qint64 bytesPerSecond = sharedLink->nominalBytesPerSecond();
+    return ((bytesPerSecond > 0) && (bytesPerSecond < _slowLinkBytesPerSecond));
+}
 
+void InitialConnectStateMachine::_startReadySteps()
+{
+    // A step function may complete its step immediately, which calls back in here. So the states are
+    // checked again for each step rather than collecting the ready steps up front.
+    for (int i = 0; i < StepCount && _active; ++i) {
+        if (_rgStepStates[i] != StepWaiting) {
+            continue;
+        }
+
+        const uint32_t dependsOn = stepDependencies(static_cast<Step_t>(i), _slowLink);
+        bool ready = true;
+        for (int j = 0; j < StepCount; ++j) {
+            if ((dependsOn & (1u << j)) && (_rgStepStates[j] != StepDone)) {
+                ready = false;
+                break;
+            }
+        }
+        if (!ready) {
+            continue;
+        }
+
+        qCDebug(InitialConnectStateMachineLog) << "Starting step" << stepName(static_cast<Step_t>(i));
+        _rgStepStates[i] = StepRunning;
+        _rgStepTimings[i].startMsecs = _connectTimer.elapsed();
+        _rgStepTimings[i].startOrder = _stepEventCount++;
+        (*_rgSteps[i].stepFn)(this);
+    }
 }
 
-void InitialConnectStateMachine::advance()
+uint32_t InitialConnectStateMachine::stepDependencies(Step_t step, bool slowLink)
 {
-    StateMachine::advance();
+    uint32_t dependsOn = _rgSteps[step].dependsOn;
+    if (slowLink) {
+        dependsOn |= _rgSteps[step].slowLinkDependsOn;
+    }
+
+    return dependsOn;
+}
+
+void InitialConnectStateMachine::stepComplete(Step_t step)
+{
+    if (!_active || (step >= StepCount) || (_rgStepStates[step] != StepRunning)) {
+        return;
+    }
+
+    if (_rgProgressConnections[step]) {
+        (void) disconnect(_rgProgressConnections[step]);
+        _rgProgressConnections[step] = QMetaObject::Connection();
+    }
+
+    _rgStepStates[step] = StepDone;
+    _rgStepProgress[step] = 1;
+    _rgStepTimings[step].durationMsecs = _connectTimer.elapsed() - _rgStepTimings[step].startMsecs;
+    _rgStepTimings[step].completeOrder = _stepEventCount++;
+    qCDebug(InitialConnectStateMachineLog) << "Step complete" << stepName(step) << _rgStepTimings[step].durationMsecs << "msecs";
+
     emit progressUpdate(_progress());
+
+    bool allDone = true;
+    for (int i = 0; i < StepCount; ++i) {
+        if (_rgStepStates[i] != StepDone) {
+            allDone = false;
+            break;
+        }
+    }
+
+    if (allDone) {
+        _signalConnectComplete();
+    } else {
+        _startReadySteps();
+    }
 }
 
-void InitialConnectStateMachine::gotProgressUpdate(double progressValue)
+void InitialConnectStateMachine::_setStepProgress(Step_t step, double progress)
 {
-    emit progressUpdate(_progress(static_cast<float>(progressValue)));
+    if (_rgStepStates[step] == StepRunning) {
+        _rgStepProgress[step] = qBound(0., progress, 1.);
+        emit progressUpdate(_progress());
+    }
+}
+
+float InitialConnectStateMachine::_progress() const
+{
+    double progressWeight = 0;
+    for (int i = 0; i < StepCount; ++i) {
+        progressWeight += _rgSteps[i].progressWeight * _rgStepProgress[i];
+    }
+    return static_cast<float>(progressWeight / _progressWeightTotal);
 }
 
-float InitialConnectStateMachine::_progress(float subProgress)
+void InitialConnectStateMachine::_signalConnectComplete()
 {
-    int progressWeight = 0;
-    for (int i = 0; i < _stateIndex && i < _cStates; ++i) {
-        progressWeight += _rgProgressWeights[i];
+    _active = false;
+    _connectMsecs = _connectTimer.elapsed();
+
+    qCDebug(InitialConnectStateMachineLog) << "Initial connect complete" << _connectMsecs << "msecs - slow link:" << _slowLink;
+    for (int i = 0; i < StepCount; ++i) {
+        qCDebug(InitialConnectStateMachineLog) << "   " << stepName(static_cast<Step_t>(i))
+                                               << "start:" << _rgStepTimings[i].startMsecs
+                                               << "duration:" << _rgStepTimings[i].durationMsecs;
     }
-    int currentWeight = _stateIndex < _cStates ? _rgProgressWeights[_stateIndex] : 1;
-    return (progressWeight + currentWeight * subProgress) / static_cast<float>(_progressWeightTotal);
+
+    // Vehicle resets the load progress once the sequence is no longer active
+    emit progressUpdate(0.f);
+
+    qCDebug(InitialConnectStateMachineLog) << "Signalling initialConnectComplete";
+    emit _vehicle->initialConnectComplete();
 }
 
-void InitialConnectStateMachine::_stateRequestAutopilotVersion(StateMachine* stateMachine)
+void InitialConnectStateMachine::_stepRequestAutopilotVersion(InitialConnectStateMachine* connectMachine)
 {
-    InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
     Vehicle*                    vehicle         = connectMachine->_vehicle;
     SharedLinkInterfacePtr      sharedLink      = vehicle->vehicleLinkManager()->primaryLink().lock();
 
     if (!sharedLink) {
         qCDebug(InitialConnectStateMachineLog) << "Skipping REQUEST_MESSAGE:AUTOPILOT_VERSION request due to no primary link";
-        connectMachine->advance();
+        connectMachine->stepComplete(StepAutopilotVersion);
     } else {
         if (sharedLink->linkConfiguration()->isHighLatency() || sharedLink->isLogReplay()) {
             qCDebug(InitialConnectStateMachineLog) << "Skipping REQUEST_MESSAGE:AUTOPILOT_VERSION request due to link type";
-            connectMachine->advance();
+            connectMachine->stepComplete(StepAutopilotVersion);
         } else {
             qCDebug(InitialConnectStateMachineLog) << "Sending REQUEST_MESSAGE:AUTOPILOT_VERSION";
             vehicle->requestMessage(_autopilotVersionRequestMessageHandler,
@@ -186,25 +308,24 @@ void InitialConnectStateMachine::_autopilotVersionRequestMessageHandler(void* re
         vehicle->_setCapabilities(assumedCapabilities);
     }
 
-    connectMachine->advance();
+    connectMachine->stepComplete(StepAutopilotVersion);
 }
 
-void InitialConnectStateMachine::_stateRequestProtocolVersion(StateMachine* stateMachine)
+void InitialConnectStateMachine::_stepRequestProtocolVersion(InitialConnectStateMachine* connectMachine)
 {
-    InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
     Vehicle*                    vehicle         = connectMachine->_vehicle;
     SharedLinkInterfacePtr      sharedLink      = vehicle->vehicleLinkManager()->primaryLink().lock();
 
     if (!sharedLink) {
         qCDebug(InitialConnectStateMachineLog) << "Skipping REQUEST_MESSAGE:PROTOCOL_VERSION request due to no primary link";
-        connectMachine->advance();
+        connectMachine->stepComplete(StepProtocolVersion);
     } else {
         if (sharedLink->linkConfiguration()->isHighLatency() || sharedLink->isLogReplay()) {
             qCDebug(InitialConnectStateMachineLog) << "Skipping REQUEST_MESSAGE:PROTOCOL_VERSION request due to link type";
-            connectMachine->advance();
+            connectMachine->stepComplete(StepProtocolVersion);
         } else if (vehicle->apmFirmware()) {
             qCDebug(InitialConnectStateMachineLog) << "Skipping REQUEST_MESSAGE:PROTOCOL_VERSION request due to Ardupilot firmware";
-            connectMachine->advance();
+            connectMachine->stepComplete(StepProtocolVersion);
         } else {
             qCDebug(InitialConnectStateMachineLog) << "Sending REQUEST_MESSAGE:PROTOCOL_VERSION";
             vehicle->requestMessage(_protocolVersionRequestMessageHandler,
@@ -255,150 +376,121 @@ void InitialConnectStateMachine::_protocolVersionRequestMessageHandler(void* res
         vehicle->_setMaxProtoVersionFromBothSources();
     }
 
-    connectMachine->advance();
+    connectMachine->stepComplete(StepProtocolVersion);
 }
-void InitialConnectStateMachine::_stateRequestCompInfo(StateMachine* stateMachine)
+
+void InitialConnectStateMachine::_stepRequestStandardModes(InitialConnectStateMachine* connectMachine)
 {
-    InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
     Vehicle*                    vehicle         = connectMachine->_vehicle;
 
-    qCDebug(InitialConnectStateMachineLog) << "_stateRequestCompInfo";
-    connect(vehicle->_componentInformationManager, &ComponentInformationManager::progressUpdate, connectMachine,
-            &InitialConnectStateMachine::gotProgressUpdate);
-    vehicle->_componentInformationManager->requestAllComponentInformation(_stateRequestCompInfoComplete, connectMachine);
+    qCDebug(InitialConnectStateMachineLog) << "_stepRequestStandardModes";
+    (void) connect(vehicle->_standardModes, &StandardModes::requestCompleted, connectMachine,
+                   &InitialConnectStateMachine::_standardModesRequestCompleted);
+    vehicle->_standardModes->request();
 }
 
-void InitialConnectStateMachine::_stateRequestStandardModes(StateMachine *stateMachine)
+void InitialConnectStateMachine::_standardModesRequestCompleted()
 {
-    InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
-    Vehicle*                    vehicle         = connectMachine->_vehicle;
-
-    qCDebug(InitialConnectStateMachineLog) << "_stateRequestStandardModes";
-    connect(vehicle->_standardModes, &StandardModes::requestCompleted, connectMachine,
-            &InitialConnectStateMachine::standardModesRequestCompleted);
-    vehicle->_standardModes->request();
+    (void) disconnect(_vehicle->_standardModes, &StandardModes::requestCompleted, this,
+                      &InitialConnectStateMachine::_standardModesRequestCompleted);
+    stepComplete(StepStandardModes);
 }
 
-void InitialConnectStateMachine::standardModesRequestCompleted()
+void InitialConnectStateMachine::_stepRequestCompInfo(InitialConnectStateMachine* connectMachine)
 {
-    disconnect(_vehicle->_standardModes, &StandardModes::requestCompleted, this,
-               &InitialConnectStateMachine::standardModesRequestCompleted);
-    advance();
+    Vehicle*                    vehicle         = connectMachine->_vehicle;
+
+    qCDebug(InitialConnectStateMachineLog) << "_stepRequestCompInfo";
+    connectMachine->_rgProgressConnections[StepCompInfo] = connect(vehicle->_componentInformationManager, &ComponentInformationManager::progressUpdate, connectMachine,
+                                                                   [connectMachine](float progress) { connectMachine->_setStepProgress(StepCompInfo, progress); });
+    vehicle->_componentInformationManager->requestAllComponentInformation(_stepRequestCompInfoComplete, connectMachine);
 }
 
-void InitialConnectStateMachine::_stateRequestCompInfoComplete(void* requestAllCompleteFnData)
+void InitialConnectStateMachine::_stepRequestCompInfoComplete(void* requestAllCompleteFnData)
 {
     InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(requestAllCompleteFnData);
-    disconnect(connectMachine->_vehicle->_componentInformationManager, &ComponentInformationManager::progressUpdate,
-            connectMachine, &InitialConnectStateMachine::gotProgressUpdate);
 
-    connectMachine->advance();
+    connectMachine->stepComplete(StepCompInfo);
 }
 
-void InitialConnectStateMachine::_stateRequestParameters(StateMachine* stateMachine)
+void InitialConnectStateMachine::_stepRequestParameters(InitialConnectStateMachine* connectMachine)
 {
-    InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
     Vehicle*                    vehicle         = connectMachine->_vehicle;
 
-    qCDebug(InitialConnectStateMachineLog) << "_stateRequestParameters";
-    connect(vehicle->_parameterManager, &ParameterManager::loadProgressChanged, connectMachine,
-            &InitialConnectStateMachine::gotProgressUpdate);
+    qCDebug(InitialConnectStateMachineLog) << "_stepRequestParameters";
+    connectMachine->_rgProgressConnections[StepParameters] = connect(vehicle->_parameterManager, &ParameterManager::loadProgressChanged, connectMachine,
+                                                                     [connectMachine](float progress) { connectMachine->_setStepProgress(StepParameters, progress); });
     vehicle->_parameterManager->refreshAllParameters();
 }
 
-void InitialConnectStateMachine::_stateRequestMission(StateMachine* stateMachine)
+void InitialConnectStateMachine::_stepRequestMission(InitialConnectStateMachine* connectMachine)
 {
-    InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
     Vehicle*                    vehicle         = connectMachine->_vehicle;
     SharedLinkInterfacePtr      sharedLink      = vehicle->vehicleLinkManager()->primaryLink().lock();
 
-    disconnect(vehicle->_parameterManager, &ParameterManager::loadProgressChanged, connectMachine,
-            &InitialConnectStateMachine::gotProgressUpdate);
-
     if (!sharedLink) {
-        qCDebug(InitialConnectStateMachineLog) << "_stateRequestMission: Skipping first mission load request due to no primary link";
-        connectMachine->advance();
+        qCDebug(InitialConnectStateMachineLog) << "_stepRequestMission: Skipping first mission load request due to no primary link";
+        connectMachine->stepComplete(StepMission);
     } else {
         if (sharedLink->linkConfiguration()->isHighLatency() || sharedLink->isLogReplay()) {
-            qCDebug(InitialConnectStateMachineLog) << "_stateRequestMission: Skipping first mission load request due to link type";
+            qCDebug(InitialConnectStateMachineLog) << "_stepRequestMission: Skipping first mission load request due to link type";
             vehicle->_firstMissionLoadComplete();
         } else {
-            qCDebug(InitialConnectStateMachineLog) << "_stateRequestMission";
+            qCDebug(InitialConnectStateMachineLog) << "_stepRequestMission";
+            connectMachine->_rgProgressConnections[StepMission] = connect(vehicle->_missionManager, &MissionManager::progressPctChanged, connectMachine,
+                                                                          [connectMachine](double progress) { connectMachine->_setStepProgress(StepMission, progress); });
             vehicle->_missionManager->loadFromVehicle();
-            (void) connect(vehicle->_missionManager, &MissionManager::progressPctChanged, connectMachine, &InitialConnectStateMachine::gotProgressUpdate);
         }
     }
 }
 
-void InitialConnectStateMachine::_stateRequestGeoFence(StateMachine* stateMachine)
+void InitialConnectStateMachine::_stepRequestGeoFence(InitialConnectStateMachine* connectMachine)
 {
-    InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
     Vehicle*                    vehicle         = connectMachine->_vehicle;
     SharedLinkInterfacePtr      sharedLink      = vehicle->vehicleLinkManager()->primaryLink().lock();
 
-    disconnect(vehicle->_missionManager, &MissionManager::progressPctChanged, connectMachine,
-               &InitialConnectStateMachine::gotProgressUpdate);
-
     if (!sharedLink) {
-        qCDebug(InitialConnectStateMachineLog) << "_stateRequestGeoFence: Skipping first geofence load request due to no primary link";
-        connectMachine->advance();
+        qCDebug(InitialConnectStateMachineLog) << "_stepRequestGeoFence: Skipping first geofence load request due to no primary link";
+        connectMachine->stepComplete(StepGeoFence);
     } else {
         if (sharedLink->linkConfiguration()->isHighLatency() || sharedLink->isLogReplay()) {
-            qCDebug(InitialConnectStateMachineLog) << "_stateRequestGeoFence: Skipping first geofence load request due to link type";
+            qCDebug(InitialConnectStateMachineLog) << "_stepRequestGeoFence: Skipping first geofence load request due to link type";
             vehicle->_firstGeoFenceLoadComplete();
         } else {
             if (vehicle->_geoFenceManager->supported()) {
-                qCDebug(InitialConnectStateMachineLog) << "_stateRequestGeoFence";
+                qCDebug(InitialConnectStateMachineLog) << "_stepRequestGeoFence";
+                connectMachine->_rgProgressConnections[StepGeoFence] = connect(vehicle->_geoFenceManager, &GeoFenceManager::progressPctChanged, connectMachine,
+                                                                               [connectMachine](double progress) { connectMachine->_setStepProgress(StepGeoFence, progress); });
                 vehicle->_geoFenceManager->loadFromVehicle();
-                connect(vehicle->_geoFenceManager, &GeoFenceManager::progressPctChanged, connectMachine,
-                        &InitialConnectStateMachine::gotProgressUpdate);
             } else {
-                qCDebug(InitialConnectStateMachineLog) << "_stateRequestGeoFence: skipped due to no support";
+                qCDebug(InitialConnectStateMachineLog) << "_stepRequestGeoFence: skipped due to no support";
                 vehicle->_firstGeoFenceLoadComplete();
             }
         }
     }
 }
 
-void InitialConnectStateMachine::_stateRequestRallyPoints(StateMachine* stateMachine)
+void InitialConnectStateMachine::_stepRequestRallyPoints(InitialConnectStateMachine* connectMachine)
 {
-    InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
     Vehicle*                    vehicle         = connectMachine->_vehicle;
     SharedLinkInterfacePtr      sharedLink      = vehicle->vehicleLinkManager()->primaryLink().lock();
 
-    disconnect(vehicle->_geoFenceManager, &GeoFenceManager::progressPctChanged, connectMachine,
-               &InitialConnectStateMachine::gotProgressUpdate);
-
     if (!sharedLink) {
-        qCDebug(InitialConnectStateMachineLog) << "_stateRequestRallyPoints: Skipping first rally point load request due to no primary link";
-        connectMachine->advance();
+        qCDebug(InitialConnectStateMachineLog) << "_stepRequestRallyPoints: Skipping first rally point load request due to no primary link";
+        connectMachine->stepComplete(StepRallyPoints);
     } else {
         if (sharedLink->linkConfiguration()->isHighLatency() || sharedLink->isLogReplay()) {
-            qCDebug(InitialConnectStateMachineLog) << "_stateRequestRallyPoints: Skipping first rally point load request due to link type";
+            qCDebug(InitialConnectStateMachineLog) << "_stepRequestRallyPoints: Skipping first rally point load request due to link type";
             vehicle->_firstRallyPointLoadComplete();
         } else {
             if (vehicle->_rallyPointManager->supported()) {
+                connectMachine->_rgProgressConnections[StepRallyPoints] = connect(vehicle->_rallyPointManager, &RallyPointManager::progressPctChanged, connectMachine,
+                                                                                  [connectMachine](double progress) { connectMachine->_setStepProgress(StepRallyPoints, progress); });
                 vehicle->_rallyPointManager->loadFromVehicle();
-                connect(vehicle->_rallyPointManager, &RallyPointManager::progressPctChanged, connectMachine,
-                        &InitialConnectStateMachine::gotProgressUpdate);
             } else {
-                qCDebug(InitialConnectStateMachineLog) << "_stateRequestRallyPoints: skipping due to no support";
+                qCDebug(InitialConnectStateMachineLog) << "_stepRequestRallyPoints: skipping due to no support";
                 vehicle->_firstRallyPointLoadComplete();
             }
         }
     }
 }
-
-void InitialConnectStateMachine::_stateSignalInitialConnectComplete(StateMachine* stateMachine)
-{
-    InitialConnectStateMachine* connectMachine  = static_cast<InitialConnectStateMachine*>(stateMachine);
-    Vehicle*                    vehicle         = connectMachine->_vehicle;
-
-    disconnect(vehicle->_rallyPointManager, &RallyPointManager::progressPctChanged, connectMachine,
-               &InitialConnectStateMachine::gotProgressUpdate);
-
-    connectMachine->advance();
-    qCDebug(InitialConnectStateMachineLog) << "Signalling initialConnectComplete";
-    emit vehicle->initialConnectComplete();
-}
-
@@ -9,15 +9,20 @@
 
 #pragma once
 
-#include "StateMachine.h"
 #include "MAVLinkLib.h"
 #include "Vehicle.h"
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QLoggingCategory>
+#include <QtCore/QObject>
 
 Q_DECLARE_LOGGING_CATEGORY(InitialConnectStateMachineLog)
 
-class InitialConnectStateMachine : public StateMachine
+/// Runs the initial connect sequence for a vehicle. The steps form a dependency graph, each step is started as
+/// soon as the steps it depends on have completed. So for example the plan downloads run alongside component
+/// information and parameter loading instead of after them. On slow links the plan downloads wait for the
+/// parameters, which leaves the whole link to the parameter stream.
+class InitialConnectStateMachine : public QObject
 {
     Q_OBJECT
 
@@ -25,64 +30,114 @@ class InitialConnectStateMachine : public StateMachine
     InitialConnectStateMachine(Vehicle *vehicle, QObject *parent = nullptr);
     ~InitialConnectStateMachine();
 
-    // Overrides from StateMachine
-    int             stateCount      (void) const final;
-    const StateFn*  rgStates        (void) const final;
-    void            statesCompleted (void) const final;
+    enum Step_t {
+        StepAutopilotVersion,
+        StepProtocolVersion,
+        StepStandardModes,
+        StepCompInfo,
+        StepParameters,
+        StepMission,
+        StepGeoFence,
+        StepRallyPoints,
+        StepCount
+    };
+
+    typedef struct {
+        qint64 startMsecs;      ///< Time the step was started, relative to the start of the sequence. -1 if not started.
+        qint64 durationMsecs;   ///< -1 until the step completes
+        int startOrder;         ///< Position of the start among all step starts and completions, -1 if not started
+        int completeOrder;      ///< Position of the completion among all step starts and completions, -1 until the step completes
+    } StepTiming_t;
+
+    /// Starts the sequence with the steps which have no dependencies
+    void start();
+
+    /// Signals that the specified step has completed, which starts any steps waiting on it
+    void stepComplete(Step_t step);
+
+    bool active() const { return _active; }
+
+    /// true: The plan downloads were held back until the parameters were loaded due to a slow link
+    bool slowLink() const { return _slowLink; }
+
+    StepTiming_t stepTiming(Step_t step) const { return _rgStepTimings[step]; }
+
+    /// Total time for the sequence in msecs, -1 if it has not completed
+    qint64 connectMsecs() const { return _connectMsecs; }
+
+    static const char* stepName(Step_t step);
 
-    void advance() override;
+    /// Mask of the steps which must complete before the specified step can start
+    static uint32_t stepDependencies(Step_t step, bool slowLink);
 
 signals:
     void progressUpdate(float progress);
 
 private slots:
-    void gotProgressUpdate(double progressValue);
-    void standardModesRequestCompleted();
+    void _standardModesRequestCompleted();
 
 private:
-    static void _stateRequestAutopilotVersion           (StateMachine* stateMachine);
-    static void _stateRequestProtocolVersion            (StateMachine* stateMachine);
-    static void _stateRequestCompInfo                   (StateMachine* stateMachine);
-    static void _stateRequestStandardModes              (StateMachine* stateMachine);
-    static void _stateRequestCompInfoComplete           (void* requestAllCompleteFnData);
-    static void _stateRequestParameters                 (StateMachine* stateMachine);
-    static void _stateRequestMission                    (StateMachine* stateMachine);
-    static void _stateRequestGeoFence                   (StateMachine* stateMachine);
-    static void _stateRequestRallyPoints                (StateMachine* stateMachine);
-    static void _stateSignalInitialConnectComplete      (StateMachine* stateMachine);
+    typedef void (*StepFn)(InitialConnectStateMachine* connectMachine);
+
+    typedef struct {
+        StepFn      stepFn;
+        uint32_t    dependsOn;          ///< Mask of steps which must complete before this step can start
+        uint32_t    slowLinkDependsOn;  ///< Additional steps to wait for on a slow link
+        int         progressWeight;
+    } StepInfo_t;
+
+    enum StepState_t {
+        StepWaiting,
+        StepRunning,
+        StepDone
+    };
+
+    static void _stepRequestAutopilotVersion            (InitialConnectStateMachine* connectMachine);
+    static void _stepRequestProtocolVersion             (InitialConnectStateMachine* connectMachine);
+    static void _stepRequestStandardModes               (InitialConnectStateMachine* connectMachine);
+    static void _stepRequestCompInfo                    (InitialConnectStateMachine* connectMachine);
+    static void _stepRequestCompInfoComplete            (void* requestAllCompleteFnData);
+    static void _stepRequestParameters                  (InitialConnectStateMachine* connectMachine);
+    static void _stepRequestMission                     (InitialConnectStateMachine* connectMachine);
+    static void _stepRequestGeoFence                    (InitialConnectStateMachine* connectMachine);
+    static void _stepRequestRallyPoints                 (InitialConnectStateMachine* connectMachine);
 
     static void _autopilotVersionRequestMessageHandler  (void* resultHandlerData, MAV_RESULT commandResult, Vehicle::RequestMessageResultHandlerFailureCode_t failureCode, const mavlink_message_t& message);
     static void _protocolVersionRequestMessageHandler   (void* resultHandlerData, MAV_RESULT commandResult, Vehicle::RequestMessageResultHandlerFailureCode_t failureCode, const mavlink_message_t& message);
 
-    float _progress(float subProgress = 0.f);
-
-    Vehicle* _vehicle;
-
-    int _progressWeightTotal;
-
-    static constexpr const StateMachine::StateFn _rgStates[] = {
-        _stateRequestAutopilotVersion,
-        _stateRequestProtocolVersion,
-        _stateRequestStandardModes,
-        _stateRequestCompInfo,
-        _stateRequestParameters,
-        _stateRequestMission,
-        _stateRequestGeoFence,
-        _stateRequestRallyPoints,
-        _stateSignalInitialConnectComplete
-    };
-
-    static constexpr const int _rgProgressWeights[] = {
-        1, //_stateRequestCapabilities
-        1, //_stateRequestProtocolVersion
-        1, //_stateRequestStandardModes
-        5, //_stateRequestCompInfo
-        5, //_stateRequestParameters
-        2, //_stateRequestMission
-        1, //_stateRequestGeoFence
-        1, //_stateRequestRallyPoints
-        1, //_stateSignalInitialConnectComplete
+    void    _startReadySteps        (void);
+    void    _setStepProgress        (Step_t step, double progress);
+    void    _signalConnectComplete  (void);
+    float   _progress               (void) const;
+    bool    _isSlowLink             (void) const;
+
+    Vehicle*                _vehicle;
+    bool                    _active             = false;
+    bool                    _slowLink           = false;
+    int                     _progressWeightTotal = 0;
+    QElapsedTimer           _connectTimer;
+    qint64                  _connectMsecs       = -1;
+    int                     _stepEventCount     = 0;
+    StepState_t             _rgStepStates[StepCount];
+    double                  _rgStepProgress[StepCount];
+    StepTiming_t            _rgStepTimings[StepCount];
+    QMetaObject::Connection _rgProgressConnections[StepCount];
+
+    /// Links slower than this in bytes per second hold the plan downloads back until the parameters are loaded
+    static constexpr qint64 _slowLinkBytesPerSecond = 10000;
+
+    // AUTOPILOT_VERSION provides the capabilities and PROTOCOL_VERSION the mavlink version which the later steps check.
+    // Standard modes and component information both use REQUEST_MESSAGE to the autopilot, which Vehicle won't send
+    // twice at the same time, so they run one after the other. Parameter metadata comes from component information.
+    // Mission, fence and rally share the mission protocol on the vehicle so only one of them can be in progress.
+    static constexpr const StepInfo_t _rgSteps[StepCount] = {
+        { _stepRequestAutopilotVersion,   0,                             0,                        1 },
+        { _stepRequestProtocolVersion,    1u << StepAutopilotVersion,    0,                        1 },
+        { _stepRequestStandardModes,      1u << StepProtocolVersion,     0,                        1 },
+        { _stepRequestCompInfo,           1u << StepStandardModes,       0,                        5 },
+        { _stepRequestParameters,         1u << StepCompInfo,            0,                        5 },
+        { _stepRequestMission,            1u << StepProtocolVersion,     1u << StepParameters,     2 },
+        { _stepRequestGeoFence,           1u << StepMission,             0,                        1 },
+        { _stepRequestRallyPoints,        1u << StepGeoFence,            0,                        1 },
     };
-
-    static constexpr int _cStates = sizeof(_rgStates) / sizeof(_rgStates[0]);
 };
@@ -0,0 +1,97 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QList>
+
+#include <utility>
+
+/// Hashed timer wheel. Deadlines fall into fixed size slots, so scheduling is O(1) and expiring only looks at the slots
+/// which passed since the last call instead of at every pending timeout. Deadlines further out than one turn of the
+/// wheel stay in their slot until their turn comes round. Entries can't be cancelled, the owner ignores stale ones.
+template<typename T>
+class TimerWheel
+{
+public:
+    TimerWheel(int slotMSecs, int slotCount)
+        : _slotMSecs(slotMSecs)
+        , _slots(slotCount)
+    {
+        Q_ASSERT(slotMSecs > 0 && slotCount > 0);
+    }
+
+    int slotMSecs() const { return _slotMSecs; }
+    int count() const { return _count; }
+    bool isEmpty() const { return _count == 0; }
+
+    /// @param deadlineMSecs Monotonic time in msecs at which the entry expires
+    void schedule(qint64 deadlineMSecs, const T& value)
+    {
+        // Anything due in a tick which was already processed goes into the last processed one, which is always checked again
+        const qint64 tick = qMax(deadlineMSecs / _slotMSecs, _lastTick);
+        _slots[tick % _slots.count()].append({ deadlineMSecs, value });
+        _count++;
+    }
+
+    /// Removes and returns the entries whose deadline is at or before nowMSecs. Entries due in the same slot are returned
+    /// in the order they were scheduled.
+    QList<T> expire(qint64 nowMSecs)
+    {
+        QList<T> expired;
+
+        const qint64 nowTick = nowMSecs / _slotMSecs;
+        if (_lastTick < 0) {
+            _lastTick = nowTick - _slots.count();
+        }
+
+        // The last tick is checked again since its entries may only have become due now. One full turn visits every
+        // slot, so a long gap between calls doesn't need to walk every tick.
+        const qint64 firstTick = qMax(_lastTick, nowTick - _slots.count() + 1);
+        for (qint64 tick = firstTick; tick <= nowTick; tick++) {
+            // Due entries are taken in scheduling order, the rest are compacted down in a single pass
+            QList<Entry_t>& slot = _slots[tick % _slots.count()];
+            qsizetype kept = 0;
+            for (qsizetype i = 0; i < slot.count(); i++) {
+                if (slot[i].deadlineMSecs <= nowMSecs) {
+                    expired.append(std::move(slot[i].value));
+                } else {
+                    if (kept != i) {
+                        slot[kept] = std::move(slot[i]);
+                    }
+                    kept++;
+                }
+            }
+            _count -= slot.count() - kept;
+            slot.remove(kept, slot.count() - kept);
+        }
+        _lastTick = qMax(_lastTick, nowTick);
+
+        return expired;
+    }
+
+    void clear()
+    {
+        for (QList<Entry_t>& slot : _slots) {
+            slot.clear();
+        }
+        _count = 0;
+    }
+
+private:
+    typedef struct {
+        qint64  deadlineMSecs;
+        T       value;
+    } Entry_t;
+
+    int                     _slotMSecs;
+    QList<QList<Entry_t>>   _slots;
+    qint64                  _lastTick   = -1;
+    int                     _count      = 0;
+};
@@ -46,6 +46,7 @@
 #include "StandardModes.h"
 #include "TerrainProtocolHandler.h"
 #include "TerrainQuery.h"
+#include "TelemetryTracer.h"
 #include "TrajectoryPoints.h"
 #include "VehicleBatteryFactGroup.h"
 #include "VehicleLinkManager.h"
@@ -68,6 +69,7 @@
 #endif
 
 #include <QtCore/QDateTime>
+#include <QtCore/QDeadlineTimer>
 
 QGC_LOGGING_CATEGORY(VehicleLog, "VehicleLog")
 
@@ -162,11 +164,10 @@ Vehicle::Vehicle(LinkInterface*             link,
     _prearmErrorTimer.setInterval(_prearmErrorTimeoutMSecs);
     _prearmErrorTimer.setSingleShot(true);
 
-    // Send MAV_CMD ack timer
-    _mavCommandResponseCheckTimer.setSingleShot(false);
-    _mavCommandResponseCheckTimer.setInterval(_mavCommandResponseCheckTimeoutMSecs);
-    _mavCommandResponseCheckTimer.start();
-    connect(&_mavCommandResponseCheckTimer, &QTimer::timeout, this, &Vehicle::_sendMavCommandResponseTimeoutCheck);
+    // MAV_CMD ack and request message timeouts, only runs while something is pending
+    _pendingTimeoutTimer.setSingleShot(false);
+    _pendingTimeoutTimer.setInterval(_pendingTimeoutWheel.slotMSecs());
+    connect(&_pendingTimeoutTimer, &QTimer::timeout, this, &Vehicle::_pendingTimeoutCheck);
 
     // MAV_TYPE_GENERIC is used by unit test for creating a vehicle which doesn't do the connect sequence. This
     // way we can test the methods that are used within the connect sequence.
@@ -470,6 +471,11 @@ void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t mes
         }
     }
 
+    const bool tracing = TelemetryTracer::enabled();
+    if (tracing) {
+        TelemetryTracer::instance()->markDispatch();
+    }
+
     // We give the link manager first whack since it it reponsible for adding new links
     _vehicleLinkManager->mavlinkMessageReceived(link, message);
 
@@ -529,6 +535,10 @@ void Vehicle::_mavlinkMessageReceived(LinkInterface* link, mavlink_message_t mes
 
     this->handleMessage(this, message);
 
+    if (tracing) {
+        TelemetryTracer::instance()->markFactGroups();
+    }
+
     switch (message.msgid) {
     case MAVLINK_MSG_ID_HOME_POSITION:
         _handleHomePosition(message);
@@ -1822,13 +1832,13 @@ void Vehicle::_gotProgressUpdate(float progressValue)
 void Vehicle::_firstMissionLoadComplete()
 {
     disconnect(_missionManager, &MissionManager::newMissionItemsAvailable, this, &Vehicle::_firstMissionLoadComplete);
-    _initialConnectStateMachine->advance();
+    _initialConnectStateMachine->stepComplete(InitialConnectStateMachine::StepMission);
 }
 
 void Vehicle::_firstGeoFenceLoadComplete()
 {
     disconnect(_geoFenceManager, &GeoFenceManager::loadComplete, this, &Vehicle::_firstGeoFenceLoadComplete);
-    _initialConnectStateMachine->advance();
+    _initialConnectStateMachine->stepComplete(InitialConnectStateMachine::StepGeoFence);
 }
 
 void Vehicle::_firstRallyPointLoadComplete()
@@ -1836,7 +1846,7 @@ void Vehicle::_firstRallyPointLoadComplete()
     disconnect(_rallyPointManager, &RallyPointManager::loadComplete, this, &Vehicle::_firstRallyPointLoadComplete);
     _initialPlanRequestComplete = true;
     emit initialPlanRequestCompleteChanged(true);
-    _initialConnectStateMachine->advance();
+    _initialConnectStateMachine->stepComplete(InitialConnectStateMachine::StepRallyPoints);
 }
 
 void Vehicle::_parametersReady(bool parametersReady)
@@ -1850,7 +1860,7 @@ void Vehicle::_parametersReady(bool parametersReady)
     if (parametersReady) {
         disconnect(_parameterManager, &ParameterManager::parametersReadyChanged, this, &Vehicle::_parametersReady);
         _setupAutoDisarmSignalling();
-        _initialConnectStateMachine->advance();
+        _initialConnectStateMachine->stepComplete(InitialConnectStateMachine::StepParameters);
     }
 
     _multirotor_speed_limits_available = _firmwarePlugin->mulirotorSpeedLimitsAvailable(this);
@@ -2564,21 +2574,85 @@ void Vehicle::sendMavCommandWithLambdaFallback(std::function<void()> lambda, int
 
 bool Vehicle::isMavCommandPending(int targetCompId, MAV_CMD command)
 {
-    bool pending = ((-1) < _findMavCommandListEntryIndex(targetCompId, command));
+    bool pending = _findMavCommandEntry(targetCompId, command) != nullptr;
     // qDebug() << "Pending target: " << targetCompId << ", command: " << (int)command << ", pending: " << (pending ? "yes" : "no");
     return pending;
 }
 
-int Vehicle::_findMavCommandListEntryIndex(int targetCompId, MAV_CMD command)
+Vehicle::MavCommandListEntry_t* Vehicle::_findMavCommandEntry(int targetCompId, MAV_CMD command)
+{
+    // Duplicates of the same command are only possible for _commandCanBeDuplicated commands, in which case acks go to the oldest
+    const auto it = _mavCommandSequences.constFind(_mavCommandKey(targetCompId, command));
+    if (it == _mavCommandSequences.constEnd() || it->isEmpty()) {
+        return nullptr;
+    }
+
+    const auto entryIt = _mavCommandMap.find(it->constFirst());
+    return (entryIt != _mavCommandMap.end()) ? &(*entryIt) : nullptr;
+}
+
+bool Vehicle::_takeMavCommandEntry(int targetCompId, MAV_CMD command, MavCommandListEntry_t& commandEntry)
+{
+    const MavCommandListEntry_t* const entry = _findMavCommandEntry(targetCompId, command);
+    if (!entry) {
+        return false;
+    }
+
+    commandEntry = *entry;
+    _removeMavCommandEntry(commandEntry.sequence);
+    return true;
+}
+
+void Vehicle::_removeMavCommandEntry(quint64 sequence)
 {
-    for (int i=0; i<_mavCommandList.count(); i++) {
-        const MavCommandListEntry_t& entry = _mavCommandList[i];
-        if (entry.targetCompId == targetCompId && entry.command == command) {
-            return i;
+    const auto entryIt = _mavCommandMap.constFind(sequence);
+    if (entryIt == _mavCommandMap.constEnd()) {
+        return;
+    }
+
+    const quint32 key = _mavCommandKey(entryIt->targetCompId, entryIt->command);
+    (void) _mavCommandMap.erase(entryIt);
+
+    auto it = _mavCommandSequences.find(key);
+    if (it != _mavCommandSequences.end()) {
+        (void) it->removeOne(sequence);
+        if (it->isEmpty()) {
+            (void) _mavCommandSequences.erase(it);
         }
     }
+}
+
+void Vehicle::_recordMavCommandResponse(MavCommandListEntry_t& commandEntry)
+{
+    if (commandEntry.responded) {
+        return;
+    }
+    commandEntry.responded = true;
+
+    MavCommandStats_t& stats = _mavCommandStats[commandEntry.command];
+    stats.responseCount++;
+
+    // A response after a retry can't be matched to a send, so only first attempts give a round trip time
+    if (commandEntry.tryCount == 1) {
+        const qint64 rttMSecs = _pendingTimeoutNowMSecs() - commandEntry.sentMSecs;
+        stats.rttMinMSecs = stats.rttCount ? qMin(stats.rttMinMSecs, rttMSecs) : rttMSecs;
+        stats.rttMaxMSecs = qMax(stats.rttMaxMSecs, rttMSecs);
+        stats.rttTotalMSecs += rttMSecs;
+        stats.rttCount++;
+    }
+}
+
+qint64 Vehicle::_pendingTimeoutNowMSecs()
+{
+    return QDeadlineTimer::current().deadline();
+}
 
-    return -1;
+void Vehicle::_schedulePendingTimeout(qint64 deadlineMSecs, const PendingTimeout_t& timeout)
+{
+    _pendingTimeoutWheel.schedule(deadlineMSecs, timeout);
+    if (!_pendingTimeoutTimer.isActive()) {
+        _pendingTimeoutTimer.start();
+    }
 }
 
 bool Vehicle::_sendMavCommandShouldRetry(MAV_CMD command)
@@ -2688,23 +2762,32 @@ void Vehicle::_sendMavCommandWorker(
     entry.rgParam7          = param7;
     entry.maxTries          = _sendMavCommandShouldRetry(command) ? _mavCommandMaxRetryCount : 1;
     entry.ackTimeoutMSecs   = sharedLink->linkConfiguration()->isHighLatency() ? _mavCommandAckTimeoutMSecsHighLatency : _mavCommandAckTimeoutMSecs;
-    entry.elapsedTimer.start();
+    entry.sequence          = _nextPendingSequence++;
 
     qCDebug(VehicleLog) << Q_FUNC_INFO << "command:param1-7" << command << param1 << param2 << param3 << param4 << param5 << param6 << param7;
 
-    _mavCommandList.append(entry);
-    _sendMavCommandFromList(_mavCommandList.count() - 1);
+    _mavCommandMap.insert(entry.sequence, entry);
+    _mavCommandSequences[_mavCommandKey(targetCompId, command)].append(entry.sequence);
+    _mavCommandStats[command].sendCount++;
+    _sendMavCommandFromList(entry.sequence);
 }
 
-void Vehicle::_sendMavCommandFromList(int index)
+void Vehicle::_sendMavCommandFromList(quint64 sequence)
 {
-    MavCommandListEntry_t commandEntry = _mavCommandList[index];
+    const auto entryIt = _mavCommandMap.find(sequence);
+    if (entryIt == _mavCommandMap.end()) {
+        return;
+    }
+
+    const int tryCount = ++entryIt->tryCount;
+    const MavCommandListEntry_t commandEntry = *entryIt;
 
     QString rawCommandName  = MissionCommandTree::instance()->rawName(commandEntry.command);
 
-    if (++_mavCommandList[index].tryCount > commandEntry.maxTries) {
+    if (tryCount > commandEntry.maxTries) {
         qCDebug(VehicleLog) << Q_FUNC_INFO << "giving up after max retries" << rawCommandName;
-        _mavCommandList.removeAt(index);
+        _removeMavCommandEntry(sequence);
+        _mavCommandStats[commandEntry.command].noResponseCount++;
         if (commandEntry.ackHandlerInfo.resultHandler) {
             mavlink_command_ack_t ack = {};
             ack.result = MAV_RESULT_FAILED;
@@ -2718,6 +2801,15 @@ void Vehicle::_sendMavCommandFromList(int index)
         return;
     }
 
+    // The first try waits for the full ack timeout, retries follow each other at the shorter check interval
+    const qint64 nowMSecs = _pendingTimeoutNowMSecs();
+    entryIt->sentMSecs = nowMSecs;
+    entryIt->deadlineMSecs = nowMSecs + ((tryCount == 1) ? commandEntry.ackTimeoutMSecs : _mavCommandResponseCheckTimeoutMSecs);
+    _schedulePendingTimeout(entryIt->deadlineMSecs, { false, 0, sequence });
+    if (tryCount > 1) {
+        _mavCommandStats[commandEntry.command].retryCount++;
+    }
+
     if (commandEntry.tryCount > 1 && !px4Firmware() && commandEntry.command == MAV_CMD_START_RX_PAIR) {
         // The implementation of this command comes from the IO layer and is shared across stacks. So for other firmwares
         // we aren't really sure whether they are correct or not.
@@ -2779,19 +2871,34 @@ void Vehicle::_sendMavCommandFromList(int index)
     sendMessageOnLinkThreadSafe(sharedLink.get(), msg);
 }
 
-void Vehicle::_sendMavCommandResponseTimeoutCheck(void)
+void Vehicle::_pendingTimeoutCheck(void)
 {
-    if (_mavCommandList.isEmpty()) {
-        return;
-    }
+    const qint64 nowMSecs = _pendingTimeoutNowMSecs();
+
+    // Entries for commands and requests which have completed since are still in the wheel, they are skipped here
+    const QList<PendingTimeout_t> expired = _pendingTimeoutWheel.expire(nowMSecs);
+    for (const PendingTimeout_t& timeout : expired) {
+        if (timeout.requestMessage) {
+            _requestMessageWaitTimeout(timeout.key, timeout.sequence);
+            continue;
+        }
 
-    // Walk the list backwards since _sendMavCommandFromList can remove entries
-    for (int i=_mavCommandList.count()-1; i>=0; i--) {
-        MavCommandListEntry_t& commandEntry = _mavCommandList[i];
-        if (commandEntry.elapsedTimer.elapsed() > commandEntry.ackTimeoutMSecs) {
-            // Try sending command again
-            _sendMavCommandFromList(i);
+        const auto entryIt = _mavCommandMap.constFind(timeout.sequence);
+        if (entryIt == _mavCommandMap.constEnd()) {
+            continue;
+        }
+        if (entryIt->deadlineMSecs > nowMSecs) {
+            // Deadline was pushed out by an in progress ack
+            _pendingTimeoutWheel.schedule(entryIt->deadlineMSecs, timeout);
+            continue;
         }
+
+        // Try sending command again
+        _sendMavCommandFromList(timeout.sequence);
+    }
+
+    if (_pendingTimeoutWheel.isEmpty()) {
+        _pendingTimeoutTimer.stop();
     }
 }
 
@@ -2851,18 +2958,22 @@ void Vehicle::_handleCommandAck(mavlink_message_t& message)
     }
 #endif
 
-    int entryIndex = _findMavCommandListEntryIndex(message.compid, static_cast<MAV_CMD>(ack.command));
-    if (entryIndex != -1) {
+    MavCommandListEntry_t* const commandEntryPtr = _findMavCommandEntry(message.compid, static_cast<MAV_CMD>(ack.command));
+    if (commandEntryPtr) {
+        _recordMavCommandResponse(*commandEntryPtr);
+
         if (ack.result == MAV_RESULT_IN_PROGRESS) {
             MavCommandListEntry_t commandEntry;
             if (px4Firmware() && ack.command == MAV_CMD_DO_AUTOTUNE_ENABLE) {
                 // HacK to support PX4 autotune which does not send final result ack and just sends in progress
-                commandEntry = _mavCommandList.takeAt(entryIndex);
+                commandEntry = *commandEntryPtr;
+                _removeMavCommandEntry(commandEntry.sequence);
             } else {
                 // Command has not completed yet, don't remove
-                MavCommandListEntry_t& commandEntryRef = _mavCommandList[entryIndex];
-                commandEntryRef.maxTries = 1;         // Vehicle responsed to command so don't retry
-                commandEntryRef.elapsedTimer.start(); // We've heard from vehicle, restart elapsed timer for no ack received timeout
+                MavCommandListEntry_t& commandEntryRef = *commandEntryPtr;
+                commandEntryRef.maxTries = 1;   // Vehicle responsed to command so don't retry
+                // We've heard from vehicle, restart the no ack received timeout. The wheel entry is moved when it comes due.
+                commandEntryRef.deadlineMSecs = _pendingTimeoutNowMSecs() + commandEntryRef.ackTimeoutMSecs;
                 commandEntry = commandEntryRef;
             }
 
@@ -2870,7 +2981,8 @@ void Vehicle::_handleCommandAck(mavlink_message_t& message)
                 (*commandEntry.ackHandlerInfo.progressHandler)(commandEntry.ackHandlerInfo.progressHandlerData, message.compid, ack);
             }
         } else {
-            MavCommandListEntry_t commandEntry = _mavCommandList.takeAt(entryIndex);
+            const MavCommandListEntry_t commandEntry = *commandEntryPtr;
+            _removeMavCommandEntry(commandEntry.sequence);
 
             if (commandEntry.ackHandlerInfo.resultHandler) {
                 (*commandEntry.ackHandlerInfo.resultHandler)(commandEntry.ackHandlerInfo.resultHandlerData, message.compid, ack, MavCmdResultCommandResultOnly);
@@ -2893,9 +3005,9 @@ void Vehicle::_handleCommandAck(mavlink_message_t& message)
 
 void Vehicle::_removeRequestMessageInfo(int compId, int msgId)
 {
-    if (_requestMessageInfoMap.contains(compId) && _requestMessageInfoMap[compId].contains(msgId)) {
-        delete _requestMessageInfoMap[compId][msgId];
-        _requestMessageInfoMap[compId].remove(msgId);
+    RequestMessageInfo_t* const requestMessageInfo = _requestMessageInfoMap.take(_requestMessageKey(compId, msgId));
+    if (requestMessageInfo) {
+        delete requestMessageInfo;
     } else {
         qWarning() << Q_FUNC_INFO << "compId:msgId not found" << compId << msgId;
     }
@@ -2904,8 +3016,13 @@ void Vehicle::_removeRequestMessageInfo(int compId, int msgId)
 
 void Vehicle::_waitForMavlinkMessageMessageReceivedHandler(const mavlink_message_t& message)
 {
-    if (_requestMessageInfoMap.contains(message.compid) && _requestMessageInfoMap[message.compid].contains(message.msgid)) {
-        auto pInfo              = _requestMessageInfoMap[message.compid][message.msgid];
+    if (_requestMessageInfoMap.isEmpty()) {
+        return;
+    }
+
+    const auto it = _requestMessageInfoMap.constFind(_requestMessageKey(message.compid, message.msgid));
+    if (it != _requestMessageInfoMap.constEnd()) {
+        auto pInfo              = *it;
         auto resultHandler      = pInfo->resultHandler;
         auto resultHandlerData  = pInfo->resultHandlerData;
 
@@ -2913,9 +3030,10 @@ void Vehicle::_waitForMavlinkMessageMessageReceivedHandler(const mavlink_message
 
         if (!pInfo->commandAckReceived) {
             qCDebug(VehicleLog) << Q_FUNC_INFO << "message received before ack came back.";
-            int entryIndex = _findMavCommandListEntryIndex(message.compid, MAV_CMD_REQUEST_MESSAGE);
-            if (entryIndex != -1) {
-                _mavCommandList.takeAt(entryIndex);
+            MavCommandListEntry_t* const commandEntry = _findMavCommandEntry(message.compid, MAV_CMD_REQUEST_MESSAGE);
+            if (commandEntry) {
+                _recordMavCommandResponse(*commandEntry);
+                _removeMavCommandEntry(commandEntry->sequence);
             } else {
                 qWarning() << Q_FUNC_INFO << "Removing request message command from list failed - not found in list";
             }
@@ -2923,27 +3041,27 @@ void Vehicle::_waitForMavlinkMessageMessageReceivedHandler(const mavlink_message
         _removeRequestMessageInfo(message.compid, message.msgid);
 
         (*resultHandler)(resultHandlerData, MAV_RESULT_ACCEPTED, RequestMessageNoFailure, message);
-    } else {
-        // We use any incoming message as a trigger to check timeouts on message requests
+    }
+}
 
-        for (auto& compIdEntry : _requestMessageInfoMap) {
-            for (auto requestMessageInfo : compIdEntry) {    
-                if (requestMessageInfo->messageWaitElapsedTimer.isValid() && requestMessageInfo->messageWaitElapsedTimer.elapsed() > (qgcApp()->runningUnitTests() ? 50 : 1000)) {
-                    auto resultHandler      = requestMessageInfo->resultHandler;
-                    auto resultHandlerData  = requestMessageInfo->resultHandlerData;
+void Vehicle::_requestMessageWaitTimeout(quint32 requestKey, quint64 waitSequence)
+{
+    const auto it = _requestMessageInfoMap.constFind(requestKey);
+    if ((it == _requestMessageInfoMap.constEnd()) || ((*it)->waitSequence != waitSequence)) {
+        // Message arrived or the request was replaced
+        return;
+    }
 
-                    qCDebug(VehicleLog) << Q_FUNC_INFO << "request message timed out - compId:msgId" << requestMessageInfo->compId << requestMessageInfo->msgId;
+    auto requestMessageInfo = *it;
+    auto resultHandler      = requestMessageInfo->resultHandler;
+    auto resultHandlerData  = requestMessageInfo->resultHandlerData;
 
-                    _removeRequestMessageInfo(requestMessageInfo->compId, requestMessageInfo->msgId);
+    qCDebug(VehicleLog) << Q_FUNC_INFO << "request message timed out - compId:msgId" << requestMessageInfo->compId << requestMessageInfo->msgId;
 
-                    mavlink_message_t message;
-                    (*resultHandler)(resultHandlerData, MAV_RESULT_FAILED, RequestMessageFailureMessageNotReceived, message);
+    _removeRequestMessageInfo(requestMessageInfo->compId, requestMessageInfo->msgId);
 
-                    return; // We only handle one timeout at a time
-                }
-            }
-        }
-    }
+    mavlink_message_t message;
+    (*resultHandler)(resultHandlerData, MAV_RESULT_FAILED, RequestMessageFailureMessageNotReceived, message);
 }
 
 void Vehicle::_requestMessageCmdResultHandler(void* resultHandlerData_, [[maybe_unused]] int compId, const mavlink_command_ack_t& ack, MavCmdResultFailureCode_t failureCode)
@@ -2983,7 +3101,9 @@ void Vehicle::_requestMessageCmdResultHandler(void* resultHandlerData_, [[maybe_
         qWarning() << Q_FUNC_INFO << "Command result handler should now have been called if message has already been received";
     } else {
         // Now that the request has been acked we start the timer to wait for the message
-        requestMessageInfo->messageWaitElapsedTimer.start();
+        const int waitMSecs = qgcApp()->runningUnitTests() ? _requestMessageWaitMSecsUnitTest : _requestMessageWaitMSecs;
+        requestMessageInfo->waitSequence = vehicle->_nextPendingSequence++;
+        vehicle->_schedulePendingTimeout(_pendingTimeoutNowMSecs() + waitMSecs, { true, _requestMessageKey(requestMessageInfo->compId, requestMessageInfo->msgId), requestMessageInfo->waitSequence });
     }
 }
 
@@ -3009,7 +3129,7 @@ void Vehicle::requestMessage(RequestMessageResultHandler resultHandler, void* re
     requestMessageInfo->resultHandler           = resultHandler;
     requestMessageInfo->resultHandlerData       = resultHandlerData;
 
-    _requestMessageInfoMap[compId][messageId] = requestMessageInfo;
+    _requestMessageInfoMap[_requestMessageKey(compId, messageId)] = requestMessageInfo;
 
     Vehicle::MavCmdAckHandlerInfo_t handlerInfo;
     handlerInfo.resultHandler       = _requestMessageCmdResultHandler;
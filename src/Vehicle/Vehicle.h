@@ -11,6 +11,7 @@
 
 #include <QtCore/QElapsedTimer>
 #include <QtCore/QFile>
+#include <QtCore/QHash>
 #include <QtCore/QObject>
 #include <QtCore/QSharedPointer>
 #include <QtCore/QTime>
@@ -46,6 +47,7 @@
 #include "VehicleVibrationFactGroup.h"
 #include "VehicleWindFactGroup.h"
 #include "GimbalController.h"
+#include "TimerWheel.h"
 
 class Actuators;
 class AutoPilotPlugin;
@@ -109,6 +111,7 @@ class Vehicle : public VehicleFactGroup
     friend class SendMavCommandWithSignallingTest;  // Unit test
     friend class SendMavCommandWithHandlerTest;     // Unit test
     friend class RequestMessageTest;                // Unit test
+    friend class InitialConnectTest;                // Unit test
     friend class GimbalController;                  // Allow GimbalController to call _addFactGroup
 
 public:
@@ -656,6 +659,27 @@ class Vehicle : public VehicleFactGroup
     ///
     bool isMavCommandPending(int targetCompId, MAV_CMD command);
 
+    /// Per MAV_CMD counters for commands sent through sendMavCommand and friends
+    typedef struct MavCommandStats {
+        int     sendCount           = 0;    ///< Commands sent, not counting retries
+        int     retryCount          = 0;    ///< Retries sent due to ack timeouts
+        int     responseCount       = 0;    ///< Commands the vehicle responded to
+        int     noResponseCount     = 0;    ///< Commands which failed with no response after all retries
+        int     rttCount            = 0;    ///< Responses to first attempts, only these are used for round trip times
+        qint64  rttTotalMSecs       = 0;
+        qint64  rttMinMSecs         = 0;
+        qint64  rttMaxMSecs         = 0;
+
+        double retryRate        () const { return sendCount ? static_cast<double>(retryCount) / sendCount : 0; }
+        double averageRttMSecs  () const { return rttCount ? static_cast<double>(rttTotalMSecs) / rttCount : 0; }
+    } MavCommandStats_t;
+
+    /// Number of commands waiting on a response
+    int mavCommandsInFlight() const { return static_cast<int>(_mavCommandMap.count()); }
+
+    /// @return Stats keyed by MAV_CMD
+    const QHash<int, MavCommandStats_t>& mavCommandStats() const { return _mavCommandStats; }
+
     /// Same as sendMavCommand but available from Qml.
     Q_INVOKABLE void sendCommand(int compId, int command, bool showError, double param1 = 0.0, double param2 = 0.0, double param3 = 0.0, double param4 = 0.0, double param5 = 0.0, double param6 = 0.0, double param7 = 0.0);
 
@@ -935,7 +959,7 @@ private slots:
     void _firstMissionLoadComplete          ();
     void _firstGeoFenceLoadComplete         ();
     void _firstRallyPointLoadComplete       ();
-    void _sendMavCommandResponseTimeoutCheck();
+    void _pendingTimeoutCheck();
     void _clearCameraTriggerPoints          ();
     void _updateDistanceHeadingHome         ();
     void _updateMissionItemIndex            ();
@@ -1176,13 +1200,18 @@ private slots:
         void*                       resultHandlerData   = nullptr;
         bool                        commandAckReceived  = false;    // We keep track of the ack/message being received since the order in which this will come in is random
         bool                        messageReceived     = false;    // We only delete the allocated RequestMessageInfo_t when both happen (or the message wait times out)
-        QElapsedTimer               messageWaitElapsedTimer;        // Elapsed time since we started waiting for the message to show up
+        quint64                     waitSequence        = 0;        // Timeout wheel entry for the message wait, 0 until the ack is received
         mavlink_message_t           message;
     } RequestMessageInfo_t;
 
-    QMap<int /* compId */, QMap<int /* msgId */, RequestMessageInfo_t*>> _requestMessageInfoMap; // Map of all request message calls currently waiting on a response
+    QHash<quint32 /* _requestMessageKey */, RequestMessageInfo_t*> _requestMessageInfoMap; // All request message calls currently waiting on a response
 
+    static quint32 _requestMessageKey(int compId, int msgId) { return (static_cast<quint32>(compId & 0xff) << 24) | (static_cast<quint32>(msgId) & 0xffffff); }
     void _removeRequestMessageInfo(int compId, int msgId);
+    void _requestMessageWaitTimeout(quint32 requestKey, quint64 waitSequence);
+
+    static const int _requestMessageWaitMSecs           = 1000;
+    static const int _requestMessageWaitMSecsUnitTest   = 50;
 
     static void _requestMessageCmdResultHandler             (void* resultHandlerData, int compId, const mavlink_command_ack_t& ack, MavCmdResultFailureCode_t failureCode);
     static void _requestMessageWaitForMessageResultHandler  (void* resultHandlerData, bool noResponsefromVehicle, const mavlink_message_t& message);
@@ -1203,24 +1232,47 @@ private slots:
         MavCmdAckHandlerInfo_t  ackHandlerInfo;
         int                     maxTries            = _mavCommandMaxRetryCount;
         int                     tryCount            = 0;
-        QElapsedTimer           elapsedTimer;
         int                     ackTimeoutMSecs     = _mavCommandAckTimeoutMSecs;
+        quint64                 sequence            = 0;        ///< Key into _mavCommandMap
+        qint64                  sentMSecs           = 0;        ///< Time of the last send, for round trip times
+        qint64                  deadlineMSecs       = 0;        ///< Time at which the command is sent again or fails
+        bool                    responded           = false;
     } MavCommandListEntry_t;
 
-    QList<MavCommandListEntry_t>    _mavCommandList;
-    QTimer                          _mavCommandResponseCheckTimer;
+    /// Timeouts are checked through a single timer wheel for commands and request message waits
+    typedef struct {
+        bool    requestMessage;     ///< true: message wait for requestMessage, key is a _requestMessageKey. false: command ack, key unused.
+        quint32 key;
+        quint64 sequence;
+    } PendingTimeout_t;
+
+    QHash<quint64 /* sequence */, MavCommandListEntry_t>            _mavCommandMap;         ///< Commands waiting on a response
+    QHash<quint32 /* _mavCommandKey */, QList<quint64>>             _mavCommandSequences;   ///< Sequences per compId:command, oldest first
+    QHash<int /* MAV_CMD */, MavCommandStats_t>                     _mavCommandStats;
+    quint64                                                         _nextPendingSequence    = 1;
+    TimerWheel<PendingTimeout_t>                                    _pendingTimeoutWheel    { _pendingTimeoutSlotMSecs, _pendingTimeoutSlotCount };
+    QTimer                                                          _pendingTimeoutTimer;
+
     static const int                _mavCommandMaxRetryCount                = 3;
-    static const int                _mavCommandResponseCheckTimeoutMSecs    = 500;
+    static const int                _mavCommandResponseCheckTimeoutMSecs    = 500;  ///< Once the ack timeout has passed, retries follow at this interval
     static const int                _mavCommandAckTimeoutMSecs              = 3000;
     static const int                _mavCommandAckTimeoutMSecsHighLatency   = 120000;
+    static const int                _pendingTimeoutSlotMSecs                = 50;
+    static const int                _pendingTimeoutSlotCount                = 128;
 
     void _sendMavCommandWorker  (
             bool commandInt, bool showError, 
             const MavCmdAckHandlerInfo_t* ackHandlerInfo,   ///> nullptr to signale no handlers
             int compId, MAV_CMD command, MAV_FRAME frame, 
             float param1, float param2, float param3, float param4, double param5, double param6, float param7);
-    void _sendMavCommandFromList(int index);
-    int  _findMavCommandListEntryIndex(int targetCompId, MAV_CMD command);
+    void _sendMavCommandFromList(quint64 sequence);
+    MavCommandListEntry_t* _findMavCommandEntry(int targetCompId, MAV_CMD command);
+    bool _takeMavCommandEntry(int targetCompId, MAV_CMD command, MavCommandListEntry_t& commandEntry);
+    void _removeMavCommandEntry(quint64 sequence);
+    void _recordMavCommandResponse(MavCommandListEntry_t& commandEntry);
+    void _schedulePendingTimeout(qint64 deadlineMSecs, const PendingTimeout_t& timeout);
+    static quint32 _mavCommandKey(int targetCompId, MAV_CMD command) { return (static_cast<quint32>(targetCompId & 0xff) << 16) | (static_cast<quint32>(command) & 0xffff); }
+    static qint64 _pendingTimeoutNowMSecs();
     bool _sendMavCommandShouldRetry(MAV_CMD command);
     bool _commandCanBeDuplicated(MAV_CMD command);
 
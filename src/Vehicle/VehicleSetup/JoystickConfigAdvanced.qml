@@ -23,6 +23,20 @@ import QGroundControl.FactControls
 Item {
     width:                  grid.width  + (ScreenTools.defaultFontPixelWidth  * 2)
     height:                 grid.height + (ScreenTools.defaultFontPixelHeight * 2)
+
+    property var _inputStats: ({})
+
+    function _formatTiming(p50, p99, max) {
+        return qsTr("%1 / %2 / %3 ms").arg((p50 / 1000).toFixed(2)).arg((p99 / 1000).toFixed(2)).arg((max / 1000).toFixed(2))
+    }
+
+    Timer {
+        interval:           1000
+        running:            advancedSettings.checked && !!_activeJoystick
+        repeat:             true
+        triggeredOnStart:   true
+        onTriggered:        _inputStats = _activeJoystick.inputStats()
+    }
     //---------------------------------------------------------------------
     GridLayout {
         id:                 grid
@@ -182,6 +196,37 @@ Item {
                     qsTr("Deadband can also be adjusted by clicking and ") +
                     qsTr("dragging vertically on the corresponding axis monitor.")
         }
+        //-----------------------------------------------------------------
+        //-- Input timing (p50 / p99 / max)
+        QGCLabel {
+            text:               qsTr("Input to send latency:")
+            Layout.alignment:   Qt.AlignVCenter
+            visible:            advancedSettings.checked
+        }
+        QGCLabel {
+            text:               _inputStats.inputSends ? _formatTiming(_inputStats.inputLatencyP50, _inputStats.inputLatencyP99, _inputStats.inputLatencyMax) : qsTr("No input")
+            visible:            advancedSettings.checked
+        }
+        QGCLabel {
+            text:               qsTr("Periodic send jitter:")
+            Layout.alignment:   Qt.AlignVCenter
+            visible:            advancedSettings.checked
+        }
+        RowLayout {
+            spacing:            ScreenTools.defaultFontPixelWidth
+            visible:            advancedSettings.checked
+
+            QGCLabel {
+                text:           _inputStats.periodicSends ? _formatTiming(_inputStats.sendJitterP50, _inputStats.sendJitterP99, _inputStats.sendJitterMax) : qsTr("Not polling")
+            }
+            QGCButton {
+                text:           qsTr("Reset")
+                onClicked: {
+                    _activeJoystick.resetInputStats()
+                    _inputStats = _activeJoystick.inputStats()
+                }
+            }
+        }
     }
 }
 
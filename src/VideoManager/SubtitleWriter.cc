@@ -17,65 +17,119 @@
 
 #include <QtCore/QDateTime>
 #include <QtCore/QFileInfo>
+#include <QtCore/QLocale>
 #include <QtCore/QString>
+#include <QtCore/QThread>
+#include <QtCore/QTime>
 
 QGC_LOGGING_CATEGORY(SubtitleWriterLog, "qgc.videomanager.subtitlewriter")
 
-SubtitleWriter::SubtitleWriter(QObject *parent)
+SubtitleWriterWorker::SubtitleWriterWorker(QObject *parent)
     : QObject(parent)
 {
     // qCDebug(SubtitleWriterLog) << Q_FUNC_INFO << this;
-
-    (void) connect(&_timer, &QTimer::timeout, this, &SubtitleWriter::_captureTelemetry);
 }
 
-SubtitleWriter::~SubtitleWriter()
+SubtitleWriterWorker::~SubtitleWriterWorker()
 {
+    close();
+
     // qCDebug(SubtitleWriterLog) << Q_FUNC_INFO << this;
 }
 
-void SubtitleWriter::startCapturingTelemetry(const QString &videoFile, QSize size)
+void SubtitleWriterWorker::open(const QString &subtitleFile, const QList<Column_t> &columns, QSize size, SUBTITLE_FORMAT format, bool telemetryTrack)
 {
+    close();
+
+    _columns = columns;
     _size = size;
-    _facts.clear();
+    _format = format;
+    _telemetryTrack = telemetryTrack;
+    _cueIndex = 0;
+    _pendingText.clear();
+    _pendingSamples = 0;
 
-    // Gather the facts currently displayed into _facts
-    FactValueGrid *grid = new FactValueGrid();
-    (void) grid->setProperty("settingsGroup", HorizontalFactValueGrid::telemetryBarSettingsGroup);
-    grid->componentComplete();
-    for (int colIndex = 0; colIndex < grid->columns()->count(); colIndex++) {
-        const QmlObjectListModel *list = grid->columns()->value<const QmlObjectListModel*>(colIndex);
-        for (int rowIndex = 0; rowIndex < list->count(); rowIndex++) {
-            const InstrumentValueData *value = list->value<InstrumentValueData*>(rowIndex);
-            if (value->fact()) {
-                _facts += value->fact();
-            }
+    qCDebug(SubtitleWriterLog) << "Writing overlay to file:" << subtitleFile;
+    _file.setFileName(subtitleFile);
+
+    if (!_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(SubtitleWriterLog) << "Unable to write subtitle data to file";
+        return;
+    }
+
+    if (_format == SUBTITLE_FORMAT_ASS) {
+        (void) _file.write(_assHeader().toUtf8());
+    }
+}
+
+void SubtitleWriterWorker::write(const SubtitleWriterWorker::Sample_t &sample)
+{
+    const int nColumns = _columns.count();
+    const qint64 durationMsecs = 1000 / SubtitleWriter::kSampleRate;
+    const qint64 endMsecs = sample.startMsecs + durationMsecs;
+    const QString date = QDateTime::fromMSecsSinceEpoch(sample.timestamp).toString(QLocale::system().dateFormat(QLocale::ShortFormat));
+
+    QStringList values;
+    values.reserve(nColumns);
+    for (int column = 0; column < nColumns; column++) {
+        const Column_t &info = _columns[column];
+        values << QStringLiteral("%1 %2").arg(Fact::variantToString(sample.values[column], info.type, info.decimalPlaces), info.units);
+    }
+
+    QString plainText;
+    if ((_format == SUBTITLE_FORMAT_SRT) || _telemetryTrack) {
+        plainText = date;
+        for (int column = 0; column < nColumns; column++) {
+            plainText += QStringLiteral("\n%1: %2").arg(_columns[column].name, values[column]);
         }
     }
-    grid->deleteLater();
 
-    // One subtitle always starts where the previous ended
-    _lastEndTime = QTime(0, 0);
+    // The telemetry track is muxed live, so it gets every sample right away
+    if (_telemetryTrack) {
+        emit telemetrySample(plainText, sample.startMsecs, durationMsecs);
+    }
 
-    const QFileInfo videoFileInfo(videoFile);
-    const QString subtitleFilePath = QStringLiteral("%1/%2.ass").arg(videoFileInfo.path(), videoFileInfo.completeBaseName());
-    qCDebug(SubtitleWriterLog) << "Writing overlay to file:" << subtitleFilePath;
-    _file.setFileName(subtitleFilePath);
+    if (_format == SUBTITLE_FORMAT_SRT) {
+        _pendingText += _srtCue(plainText, sample.startMsecs, endMsecs);
+    } else {
+        _pendingText += _assEvents(values, sample.startMsecs, endMsecs, date);
+    }
 
-    if (!_file.open(QIODevice::ReadWrite)) {
-        qCWarning(SubtitleWriterLog) << "Unable to write subtitle data to file";
-        return;
+    if (++_pendingSamples >= kBatchSamples) {
+        _flush();
+    }
+}
+
+void SubtitleWriterWorker::close()
+{
+    _flush();
+
+    if (_file.isOpen()) {
+        _file.close();
+    }
+}
+
+void SubtitleWriterWorker::_flush()
+{
+    if (_file.isOpen() && !_pendingText.isEmpty()) {
+        (void) _file.write(_pendingText.toUtf8());
     }
 
-    QTextStream stream(&_file);
+    _pendingText.clear();
+    _pendingSamples = 0;
+}
 
+QString SubtitleWriterWorker::_assHeader() const
+{
     // Calculate the scaled font size based on the recording width
     static constexpr int baseWidth = 640;
     static constexpr int baseFontSize = 12;
     const int scaledFontSize = (_size.width() * baseFontSize) / baseWidth;
 
-    // This is file header
-    stream << QStringLiteral(
+    // TODO: Find a good way to input title
+    // "Dialogue: 0,0:00:00.00,999:00:00.00,Default,,0,0,0,,{\\pos(5,35)}%1\n"
+
+    return QStringLiteral(
         "[Script Info]\n"
         "Title: QGroundControl Subtitle Telemetry file\n"
         "ScriptType: v4.00+\n"
@@ -92,88 +146,192 @@ void SubtitleWriter::startCapturingTelemetry(const QString &videoFile, QSize siz
         "[Events]\n"
         "Format: Layer, Start, End, Style, Name, MarginL, MarginR, MarginV, Effect, Text\n"
     ).arg(_size.width()).arg(_size.height()).arg(scaledFontSize);
-
-    // TODO: Find a good way to input title
-    // stream << QStringLiteral("Dialogue: 0,0:00:00.00,999:00:00.00,Default,,0,0,0,,{\\pos(5,35)}%1\n");
-
-    _timer.start(1000 / _kSampleRate);
-}
-
-void SubtitleWriter::stopCapturingTelemetry()
-{
-    qCDebug(SubtitleWriterLog) << "Stopping writing";
-    _timer.stop();
-    _file.close();
 }
 
-void SubtitleWriter::_captureTelemetry()
+QString SubtitleWriterWorker::_assEvents(const QStringList &values, qint64 startMsecs, qint64 endMsecs, const QString &date) const
 {
-    if (!MultiVehicleManager::instance()->activeVehicle()) {
-        qCWarning(SubtitleWriterLog) << "Attempting to capture fact data with no active vehicle!";
-        return;
-    }
-
-    // Each list corresponds to a column in the subtitles
-    QStringList namesStrings;
-    QStringList valuesStrings;
-
-    // Make a list of "factname:" strings and other with the values, so one can be aligned left and the other right
-    for (const Fact *fact : std::as_const(_facts)) {
-        valuesStrings << QStringLiteral("%2 %3").arg(fact->cookedValueString(), fact->cookedUnits());
-        namesStrings << QStringLiteral("%1:").arg(fact->shortDescription());
-    }
-
-    // The time to start displaying this subtitle text
-    const QTime start = _lastEndTime;
-
-    // The time to stop displaying this subtitle text
-    const QTime end = start.addMSecs(1000 / _kSampleRate);
-    _lastEndTime = end;
+    const QString start = _timeString(startMsecs, SUBTITLE_FORMAT_ASS);
+    const QString end = _timeString(endMsecs, SUBTITLE_FORMAT_ASS);
 
     // This splits the screen in N parts and uses the N-1 internal parts to align the subtitles to.
     // Should we try to get the resolution from the pipeline? This seems to work fine with other resolutions too.
     static constexpr int offsetFactor = 100; // Used to reduce the borders in the layout
     static constexpr float nRows = 3; // number of rows used for displaying data
-    static const int rowWidth = (_size.width() + offsetFactor) / (nRows + 1);
-    const int nValuesByRow = ceil(_facts.length() / nRows);
-
-    QStringList stringColumns;
+    const int rowWidth = (_size.width() + offsetFactor) / (nRows + 1);
+    const int nValuesByRow = ceil(_columns.length() / nRows);
 
     // These templates are used for the data columns, one right-aligned for names and one for
     // the facts values. The arguments expected are: start time, end time, xposition, and string content.
     static const QString namesLine = QStringLiteral("Dialogue: 0,%3,%4,Default,,0,0,0,,{\\an3\\pos(%1,%2)}%5\n");
     static const QString valuesLine = QStringLiteral("Dialogue: 0,%3,%4,Default,,0,0,0,,{\\pos(%1,%2)}%5\n");
 
+    QString events;
+
     // Split values into N columns and create a subtitle entry for each column
     for (int i = 0; i < nRows; i++) {
-        const QStringList currentColumnNameStrings = namesStrings.mid(i * nValuesByRow, nValuesByRow);
-        const QStringList currentColumnValueStrings = valuesStrings.mid(i * nValuesByRow, nValuesByRow);
+        QStringList currentColumnNameStrings;
+        for (int column = i * nValuesByRow; (column < ((i + 1) * nValuesByRow)) && (column < _columns.count()); column++) {
+            currentColumnNameStrings << QStringLiteral("%1:").arg(_columns[column].name);
+        }
+        const QStringList currentColumnValueStrings = values.mid(i * nValuesByRow, nValuesByRow);
 
         // Fill templates for names of column i
-        const QString names = namesLine.arg(QString::number((-offsetFactor / 2) + (rowWidth * (i + 1)) - 10),
-                                            QString::number(_size.height() - 30),
-                                            start.toString("H:mm:ss.zzz").chopped(2),
-                                            end.toString("H:mm:ss.zzz").chopped(2),
-                                            currentColumnNameStrings.join("\\N"));
-        stringColumns << names;
+        events += namesLine.arg(QString::number((-offsetFactor / 2) + (rowWidth * (i + 1)) - 10),
+                                QString::number(_size.height() - 30),
+                                start,
+                                end,
+                                currentColumnNameStrings.join("\\N"));
 
         // Fill templates for values of column i
-        const QString values = valuesLine.arg(QString::number((-offsetFactor / 2) + (rowWidth * (i + 1))),
-                                              QString::number(_size.height() - 30),
-                                              start.toString("H:mm:ss.zzz").chopped(2),
-                                              end.toString("H:mm:ss.zzz").chopped(2),
-                                              currentColumnValueStrings.join("\\N"));
-        stringColumns << values;
+        events += valuesLine.arg(QString::number((-offsetFactor / 2) + (rowWidth * (i + 1))),
+                                 QString::number(_size.height() - 30),
+                                 start,
+                                 end,
+                                 currentColumnValueStrings.join("\\N"));
     }
 
     // Write the date to the corner
-    stringColumns << QStringLiteral("Dialogue: 0,%1,%2,Default,,0,0,0,,{\\pos(10,35)}%3\n").arg(
-                                    start.toString("H:mm:ss.zzz").chopped(2),
-                                    end.toString("H:mm:ss.zzz").chopped(2),
-                                    QDateTime::currentDateTime().toString(QLocale::system().dateFormat(QLocale::ShortFormat)));
-    // Write new data
-    QTextStream stream(&_file);
-    for (const QString &col : std::as_const(stringColumns)) {
-        stream << col;
+    events += QStringLiteral("Dialogue: 0,%1,%2,Default,,0,0,0,,{\\pos(10,35)}%3\n").arg(start, end, date);
+
+    return events;
+}
+
+QString SubtitleWriterWorker::_srtCue(const QString &text, qint64 startMsecs, qint64 endMsecs)
+{
+    return QStringLiteral("%1\n%2 --> %3\n%4\n\n").arg(QString::number(++_cueIndex),
+                                                        _timeString(startMsecs, SUBTITLE_FORMAT_SRT),
+                                                        _timeString(endMsecs, SUBTITLE_FORMAT_SRT),
+                                                        text);
+}
+
+QString SubtitleWriterWorker::_timeString(qint64 msecs, SUBTITLE_FORMAT format)
+{
+    const QTime time = QTime(0, 0).addMSecs(msecs);
+    if (format == SUBTITLE_FORMAT_SRT) {
+        return time.toString(QStringLiteral("HH:mm:ss,zzz"));
+    }
+
+    // ASS times are in centiseconds. With the pre-roll shift cues no longer start on whole seconds.
+    return time.toString(QStringLiteral("H:mm:ss.zzz")).chopped(1);
+}
+
+/*===========================================================================*/
+
+SubtitleWriter::SubtitleWriter(QObject *parent)
+    : QObject(parent)
+    , _worker(new SubtitleWriterWorker())
+    , _workerThread(new QThread(this))
+{
+    // qCDebug(SubtitleWriterLog) << Q_FUNC_INFO << this;
+
+    _workerThread->setObjectName(QStringLiteral("SubtitleWriter"));
+    _worker->moveToThread(_workerThread);
+
+    (void) connect(&_timer, &QTimer::timeout, this, &SubtitleWriter::_captureTelemetry);
+    (void) connect(_worker, &SubtitleWriterWorker::telemetrySample, this, &SubtitleWriter::telemetrySample, Qt::DirectConnection);
+
+    _workerThread->start(QThread::LowPriority);
+}
+
+SubtitleWriter::~SubtitleWriter()
+{
+    stopCapturingTelemetry();
+
+    // Quit from the worker's own queue so the last batch and the close run first
+    QThread *const workerThread = _workerThread;
+    (void) QMetaObject::invokeMethod(_worker, [workerThread]() { workerThread->quit(); });
+    _workerThread->wait();
+    delete _worker;
+
+    // qCDebug(SubtitleWriterLog) << Q_FUNC_INFO << this;
+}
+
+void SubtitleWriter::startCapturingTelemetry(const QString &videoFile, QSize size, SubtitleWriterWorker::SUBTITLE_FORMAT format, bool telemetryTrack, qint64 prerollMsecs)
+{
+    stopCapturingTelemetry();
+
+    _facts.clear();
+
+    // Gather the facts currently displayed into _facts
+    FactValueGrid *grid = new FactValueGrid();
+    (void) grid->setProperty("settingsGroup", HorizontalFactValueGrid::telemetryBarSettingsGroup);
+    grid->componentComplete();
+    for (int colIndex = 0; colIndex < grid->columns()->count(); colIndex++) {
+        const QmlObjectListModel *list = grid->columns()->value<const QmlObjectListModel*>(colIndex);
+        for (int rowIndex = 0; rowIndex < list->count(); rowIndex++) {
+            const InstrumentValueData *value = list->value<InstrumentValueData*>(rowIndex);
+            if (value->fact()) {
+                _facts += value->fact();
+            }
+        }
+    }
+    grid->deleteLater();
+
+    // Everything the worker needs to format a value, so it never has to touch the facts
+    QList<SubtitleWriterWorker::Column_t> columns;
+    columns.reserve(_facts.count());
+    for (const Fact *fact : std::as_const(_facts)) {
+        columns.append({ fact->shortDescription(), fact->cookedUnits(), fact->type(), fact->decimalPlaces() });
+    }
+
+    const QFileInfo videoFileInfo(videoFile);
+    const QString extension = (format == SubtitleWriterWorker::SUBTITLE_FORMAT_SRT) ? QStringLiteral("srt") : QStringLiteral("ass");
+    const QString subtitleFilePath = QStringLiteral("%1/%2.%3").arg(videoFileInfo.path(), videoFileInfo.completeBaseName(), extension);
+
+    SubtitleWriterWorker *const worker = _worker;
+    (void) QMetaObject::invokeMethod(worker, [worker, subtitleFilePath, columns, size, format, telemetryTrack]() {
+        worker->open(subtitleFilePath, columns, size, format, telemetryTrack);
+    });
+
+    // One subtitle always starts where the previous ended. The recording may already hold video from before now.
+    _nextStartMsecs = prerollMsecs;
+    _capturing = true;
+
+    _timer.start(1000 / kSampleRate);
+}
+
+void SubtitleWriter::stopCapturingTelemetry()
+{
+    if (!_capturing) {
+        return;
+    }
+
+    qCDebug(SubtitleWriterLog) << "Stopping writing";
+    _timer.stop();
+    _capturing = false;
+
+    SubtitleWriterWorker *const worker = _worker;
+    (void) QMetaObject::invokeMethod(worker, [worker]() { worker->close(); });
+}
+
+void SubtitleWriter::_captureTelemetry()
+{
+    // The time to start displaying this subtitle text. Advanced even when nothing is captured so the
+    // subtitles stay in step with the video.
+    const qint64 startMsecs = _nextStartMsecs;
+    _nextStartMsecs += 1000 / kSampleRate;
+
+    if (startMsecs < 0) {
+        // The recording has not reached this point yet
+        return;
     }
+
+    if (!MultiVehicleManager::instance()->activeVehicle()) {
+        qCWarning(SubtitleWriterLog) << "Attempting to capture fact data with no active vehicle!";
+        return;
+    }
+
+    // Only the raw values are copied here, formatting is left to the worker
+    SubtitleWriterWorker::Sample_t sample;
+    sample.values.reserve(_facts.count());
+    for (const Fact *fact : std::as_const(_facts)) {
+        sample.values.append(fact->cookedValue());
+    }
+    sample.startMsecs = startMsecs;
+    sample.timestamp = QDateTime::currentMSecsSinceEpoch();
+
+    SubtitleWriterWorker *const worker = _worker;
+    (void) QMetaObject::invokeMethod(worker, [worker, sample = std::move(sample)]() {
+        worker->write(sample);
+    });
 }
@@ -9,17 +9,80 @@
 
 #pragma once
 
+#include "FactMetaData.h"
+
 #include <QtCore/QFile>
+#include <QtCore/QList>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QObject>
 #include <QtCore/QSize>
-#include <QtCore/QTime>
 #include <QtCore/QTimer>
+#include <QtCore/QVariant>
 
 class Fact;
+class QThread;
 
 Q_DECLARE_LOGGING_CATEGORY(SubtitleWriterLog)
 
+/// Formats telemetry samples and writes them to the subtitle file. Lives on the SubtitleWriter worker thread.
+/// Each sample is handed on to the telemetry track as soon as it arrives, file writes are collected into batches.
+class SubtitleWriterWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Video.SettingsGroup.json subtitleFormat
+    enum SUBTITLE_FORMAT {
+        SUBTITLE_FORMAT_ASS = 0,
+        SUBTITLE_FORMAT_SRT
+    };
+
+    typedef struct {
+        QString name;
+        QString units;
+        FactMetaData::ValueType_t type;
+        int decimalPlaces;
+    } Column_t;
+
+    /// Raw values of one sample, one per column
+    typedef struct {
+        QList<QVariant> values;
+        qint64 startMsecs;          ///< Relative to the start of the recording
+        qint64 timestamp;           ///< Wall clock, msecs since epoch
+    } Sample_t;
+
+    explicit SubtitleWriterWorker(QObject *parent = nullptr);
+    ~SubtitleWriterWorker();
+
+    void open(const QString &subtitleFile, const QList<Column_t> &columns, QSize size, SUBTITLE_FORMAT format, bool telemetryTrack);
+    void write(const SubtitleWriterWorker::Sample_t &sample);
+    /// Writes out what is still pending and closes the file
+    void close();
+
+    static constexpr int kBatchSamples = 10; ///< Samples formatted before they are written to the file
+
+signals:
+    void telemetrySample(const QString &text, qint64 startMsecs, qint64 durationMsecs);
+
+private:
+    QString _assHeader() const;
+    QString _assEvents(const QStringList &values, qint64 startMsecs, qint64 endMsecs, const QString &date) const;
+    QString _srtCue(const QString &text, qint64 startMsecs, qint64 endMsecs);
+    static QString _timeString(qint64 msecs, SUBTITLE_FORMAT format);
+    void _flush();
+
+    QFile _file;
+    QString _pendingText;
+    int _pendingSamples = 0;
+    QList<Column_t> _columns;
+    QSize _size;
+    SUBTITLE_FORMAT _format = SUBTITLE_FORMAT_ASS;
+    bool _telemetryTrack = false;
+    int _cueIndex = 0;
+};
+
+/// Records the telemetry bar values alongside a video recording. The values are snapshotted on the GUI thread,
+/// where the facts live, and handed to a worker thread which does the formatting and file writes.
 class SubtitleWriter : public QObject
 {
     Q_OBJECT
@@ -28,18 +91,27 @@ class SubtitleWriter : public QObject
     explicit SubtitleWriter(QObject *parent = nullptr);
     ~SubtitleWriter();
 
-    void startCapturingTelemetry(const QString &videoFile, QSize size);
+    /// @param telemetryTrack Also emit telemetrySample for each sample, for muxing into the recording
+    /// @param prerollMsecs Position in the recording of the moment capture starts. Negative when the recording
+    ///                     itself only starts later, samples from before then are dropped.
+    void startCapturingTelemetry(const QString &videoFile, QSize size, SubtitleWriterWorker::SUBTITLE_FORMAT format, bool telemetryTrack, qint64 prerollMsecs);
     void stopCapturingTelemetry();
 
+    static constexpr int kSampleRate = 1; ///< Sample rate in Hz for getting telemetry data, most players do weird stuff when > 1Hz
+
+signals:
+    /// Emitted from the worker thread, use a direct connection with a thread safe receiver
+    void telemetrySample(const QString &text, qint64 startMsecs, qint64 durationMsecs);
+
 private slots:
     void _captureTelemetry();
 
 private:
-    QFile _file;
     QList<Fact*> _facts;
-    QSize _size;
-    QTime _lastEndTime;
+    qint64 _nextStartMsecs = 0;
+    bool _capturing = false;
     QTimer _timer;
 
-    static constexpr int _kSampleRate = 1; ///< Sample rate in Hz for getting telemetry data, most players do weird stuff when > 1Hz
+    SubtitleWriterWorker *_worker = nullptr;
+    QThread *_workerThread = nullptr;
 };
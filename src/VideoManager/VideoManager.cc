@@ -185,6 +185,7 @@ void VideoManager::startRecording(const QString &videoFile)
         }
         const QString streamName = (receiver->name() == QStringLiteral("videoContent")) ? "" : (receiver->name() + ".");
         const QString videoFileName = videoFileNameTemplate.arg(streamName);
+        receiver->setTelemetryTrack(!receiver->isThermal() && (fileFormat == VideoReceiver::FILE_FORMAT_MKV) && _videoSettings->telemetryTrack()->rawValue().toBool());
         receiver->startRecording(videoFileName, fileFormat);
     }
 }
@@ -196,6 +197,24 @@ void VideoManager::stopRecording()
     }
 }
 
+QVariantMap VideoManager::latencyStats() const
+{
+    for (const VideoReceiver *receiver : _videoReceivers) {
+        if (!receiver->isThermal()) {
+            return receiver->latencyStats();
+        }
+    }
+
+    return QVariantMap();
+}
+
+void VideoManager::resetLatencyStats()
+{
+    for (VideoReceiver *receiver : std::as_const(_videoReceivers)) {
+        receiver->resetLatencyStats();
+    }
+}
+
 void VideoManager::grabImage(const QString &imageFile)
 {
     if (imageFile.isEmpty()) {
@@ -731,13 +750,19 @@ void VideoManager::_initVideoReceiver(VideoReceiver *receiver, QQuickWindow *win
         }
     });
 
-    (void) connect(receiver, &VideoReceiver::recordingStarted, this, [this, receiver](const QString &filename) {
-        qCDebug(VideoManagerLog) << "Video" << receiver->name() << "recording started";
+    (void) connect(receiver, &VideoReceiver::recordingStarted, this, [this, receiver](const QString &filename, qint64 prerollMsecs) {
+        qCDebug(VideoManagerLog) << "Video" << receiver->name() << "recording started, pre-roll" << prerollMsecs << "msecs";
         if (!receiver->isThermal()) {
-            _subtitleWriter->startCapturingTelemetry(filename, videoSize());
+            const SubtitleWriterWorker::SUBTITLE_FORMAT subtitleFormat = static_cast<SubtitleWriterWorker::SUBTITLE_FORMAT>(_videoSettings->subtitleFormat()->rawValue().toInt());
+            _subtitleWriter->startCapturingTelemetry(filename, videoSize(), subtitleFormat, receiver->telemetryTrack(), prerollMsecs);
         }
     });
 
+    if (!receiver->isThermal()) {
+        // Emitted from the subtitle worker thread, pushTelemetry is thread safe
+        (void) connect(_subtitleWriter, &SubtitleWriter::telemetrySample, receiver, &VideoReceiver::pushTelemetry, Qt::DirectConnection);
+    }
+
     (void) connect(receiver, &VideoReceiver::videoSizeChanged, this, [this, receiver](QSize size) {
         qCDebug(VideoManagerLog) << "Video" << receiver->name() << "resized. New resolution:" << size.width() << "x" << size.height();
         if (!receiver->isThermal()) {
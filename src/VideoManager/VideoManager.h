@@ -13,6 +13,7 @@
 #include <QtCore/QObject>
 #include <QtCore/QRunnable>
 #include <QtCore/QSize>
+#include <QtCore/QVariantMap>
 #include <QtQmlIntegration/QtQmlIntegration>
 
 Q_DECLARE_LOGGING_CATEGORY(VideoManagerLog)
@@ -57,6 +58,9 @@ class VideoManager : public QObject
     static VideoManager *instance();
 
     Q_INVOKABLE void grabImage(const QString &imageFile = QString());
+    /// Latency statistics of the main (not thermal) video stream, see VideoReceiver::latencyStats
+    Q_INVOKABLE QVariantMap latencyStats() const;
+    Q_INVOKABLE void resetLatencyStats();
     Q_INVOKABLE void startRecording(const QString &videoFile = QString());
     Q_INVOKABLE void startVideo();
     Q_INVOKABLE void stopRecording();
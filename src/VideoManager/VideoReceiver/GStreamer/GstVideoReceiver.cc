@@ -15,6 +15,11 @@
 // _source-->_tee
 //              |
 //              +-->queue-->_recorderValve[-->_fileSink]
+//
+// The recorder branch carries the parsed elementary stream straight from the
+// source, it is muxed as is and never decoded or re-encoded. While the valve is
+// closed the most recent GOP is kept (by reference) so that a recording starts
+// from the last keyframe instead of waiting for the next one.
 //-----------------------------------------------------------------------------
 
 #include "GstVideoReceiver.h"
@@ -23,9 +28,11 @@
 
 #include <QtCore/QDateTime>
 #include <QtCore/QUrl>
+#include <QtGui/QImage>
 #include <QtQuick/QQuickItem>
 
 #include <gst/gst.h>
+#include <gst/video/video.h>
 
 QGC_LOGGING_CATEGORY(GstVideoReceiverLog, "qgc.videomanager.videoreceiver.gstreamer.gstvideoreceiver")
 
@@ -68,12 +75,15 @@ void GstVideoReceiver::start(uint32_t timeout)
     }
 
     _timeout = timeout;
-    _buffer = lowLatency() ? -1 : 0;
+    _buffer = lowLatency() ? _kLowLatencyBufferMs : 0;
 
     qCDebug(GstVideoReceiverLog) << "Starting" << _uri << ", lowLatency" << lowLatency() << ", timeout" << _timeout;
 
     _endOfStream = false;
 
+    resetLatencyStats();
+    _pipelineLatency = 0;
+
     bool running = false;
     bool pipelineUp = false;
 
@@ -104,6 +114,16 @@ void GstVideoReceiver::start(uint32_t timeout)
             break;
         }
 
+        if (lowLatency()) {
+            // The default queue holds up to a second of video ahead of a decoder which falls behind.
+            // Keep it to a couple of frames, backpressure then lands on the jitter buffer which drops late packets.
+            g_object_set(decoderQueue,
+                         "max-size-buffers", _kLowLatencyQueueBuffers,
+                         "max-size-bytes", 0,
+                         "max-size-time", static_cast<guint64>(0),
+                         nullptr);
+        }
+
         _decoderValve = gst_element_factory_make("valve", nullptr);
         if (!_decoderValve)  {
             qCCritical(GstVideoReceiverLog) << "gst_element_factory_make('valve') failed";
@@ -130,6 +150,15 @@ void GstVideoReceiver::start(uint32_t timeout)
                      "drop", TRUE,
                      nullptr);
 
+        pad = gst_element_get_static_pad(_recorderValve, "sink");
+        if (!pad) {
+            qCCritical(GstVideoReceiverLog) << "gst_element_get_static_pad() failed";
+            break;
+        }
+
+        (void) gst_pad_add_probe(pad, GST_PAD_PROBE_TYPE_BUFFER, _prerollProbe, this, nullptr);
+        gst_clear_object(&pad);
+
         _pipeline = gst_pipeline_new("receiver");
         if (!_pipeline) {
             qCCritical(GstVideoReceiverLog) << "gst_pipeline_new() failed";
@@ -285,6 +314,12 @@ void GstVideoReceiver::stop()
 
         (void) gst_element_set_state(_pipeline, GST_STATE_NULL);
 
+        _prerollMutex.lock();
+        _prerollPending = false;
+        _prerollPushing = false;
+        _clearPreroll();
+        _prerollMutex.unlock();
+
         // FIXME: check if branch is connected and remove all elements from branch
         if (_fileSink) {
            _shutdownRecordingBranch();
@@ -477,9 +512,11 @@ void GstVideoReceiver::startRecording(const QString &videoFile, FILE_FORMAT form
     (void) gst_pad_add_probe(probepad, GST_PAD_PROBE_TYPE_BUFFER, _keyframeWatch, this, nullptr); // to drop the buffers until key frame is received
     gst_clear_object(&probepad);
 
-    g_object_set(_recorderValve,
-                 "drop", FALSE,
-                 nullptr);
+    // The valve is opened from the streaming thread, right after the cached GOP has been pushed, so no
+    // live buffer can get between the pre-roll and the rest of the stream
+    _prerollMutex.lock();
+    _prerollPending = true;
+    _prerollMutex.unlock();
 
     _recordingOutput = videoFile;
     _recording = true;
@@ -505,9 +542,16 @@ void GstVideoReceiver::stopRecording()
         return;
     }
 
+    _prerollMutex.lock();
+    _prerollPending = false;
+    _prerollPushing = false;
     g_object_set(_recorderValve,
                  "drop", TRUE,
                  nullptr);
+    _prerollMutex.unlock();
+
+    // The muxer only finishes the file once every one of its inputs has ended
+    _endTelemetryTrack();
 
     _removingRecorder = true;
 
@@ -528,8 +572,54 @@ void GstVideoReceiver::takeScreenshot(const QString &imageFile)
 
     qCDebug(GstVideoReceiverLog) << "taking screenshot" << _uri;
 
-    // FIXME: record screenshot here
-    _dispatchSignal([this]() { emit onTakeScreenshotComplete(STATUS_NOT_IMPLEMENTED); });
+    // The pipeline is left alone, the image comes from the last frame which reached the video sink
+    GstSample *sample = nullptr;
+    _lastSampleMutex.lock();
+    if (_lastSample) {
+        sample = gst_sample_ref(_lastSample);
+    }
+    _lastSampleMutex.unlock();
+
+    if (!sample) {
+        qCDebug(GstVideoReceiverLog) << "No decoded frame available" << _uri;
+        _dispatchSignal([this]() { emit onTakeScreenshotComplete(STATUS_INVALID_STATE); });
+        return;
+    }
+
+    const bool ret = _saveSample(sample, imageFile);
+    gst_sample_unref(sample);
+
+    if (ret) {
+        qCDebug(GstVideoReceiverLog) << "Screenshot saved" << imageFile << _uri;
+    }
+
+    _dispatchSignal([this, ret]() { emit onTakeScreenshotComplete(ret ? STATUS_OK : STATUS_FAIL); });
+}
+
+QVariantMap GstVideoReceiver::latencyStats() const
+{
+    QMutexLocker lock(&_latencyMutex);
+
+    QVariantMap stats;
+    stats[QStringLiteral("lowLatency")] = lowLatency();
+    stats[QStringLiteral("receiveFrames")] = _receiveLatency.count();
+    stats[QStringLiteral("receiveLatencyP50")] = _receiveLatency.valueAtPercentile(50.);
+    stats[QStringLiteral("receiveLatencyP99")] = _receiveLatency.valueAtPercentile(99.);
+    stats[QStringLiteral("receiveLatencyMax")] = _receiveLatency.max();
+    stats[QStringLiteral("renderFrames")] = _renderLatency.count();
+    stats[QStringLiteral("renderLatencyP50")] = _renderLatency.valueAtPercentile(50.);
+    stats[QStringLiteral("renderLatencyP99")] = _renderLatency.valueAtPercentile(99.);
+    stats[QStringLiteral("renderLatencyMax")] = _renderLatency.max();
+
+    return stats;
+}
+
+void GstVideoReceiver::resetLatencyStats()
+{
+    QMutexLocker lock(&_latencyMutex);
+
+    _receiveLatency.reset();
+    _renderLatency.reset();
 }
 
 void GstVideoReceiver::_watchdog()
@@ -539,6 +629,16 @@ void GstVideoReceiver::_watchdog()
             return;
         }
 
+        if (_videoSinkSync) {
+            GstQuery *query = gst_query_new_latency();
+            if (gst_element_query(_pipeline, query)) {
+                GstClockTime minLatency = 0;
+                gst_query_parse_latency(query, nullptr, &minLatency, nullptr);
+                _pipelineLatency = minLatency;
+            }
+            gst_query_unref(query);
+        }
+
         const qint64 now = QDateTime::currentSecsSinceEpoch();
         if (_lastSourceFrameTime == 0) {
             _lastSourceFrameTime = now;
@@ -661,7 +761,7 @@ GstElement *GstVideoReceiver::_makeSource(const QString &input)
 
             g_object_set(source,
                          "location", input.toUtf8().constData(),
-                         "latency", 25,
+                         "latency", (_buffer > 0) ? _buffer : 25,
                          nullptr);
         } else if (isTcpMPEGTS) {
             source = gst_element_factory_make("tcpclientsrc", "source");
@@ -765,6 +865,13 @@ GstElement *GstVideoReceiver::_makeSource(const QString &input)
                     break;
                 }
 
+                if (_buffer > 0) {
+                    g_object_set(buffer,
+                                 "latency", _buffer,
+                                 "drop-on-latency", TRUE,
+                                 nullptr);
+                }
+
                 (void) gst_bin_add(GST_BIN(bin), buffer);
 
                 if (!gst_element_link_many(source, buffer, parser, nullptr)) {
@@ -805,6 +912,11 @@ GstElement *GstVideoReceiver::_makeDecoder(GstCaps *caps, GstElement *videoSink)
     GstElement *decoder = gst_element_factory_make("decodebin3", nullptr);
     if (!decoder) {
         qCCritical(GstVideoReceiverLog) << "gst_element_factory_make('decodebin3') failed";
+        return nullptr;
+    }
+
+    if (lowLatency()) {
+        (void) g_signal_connect(decoder, "deep-element-added", G_CALLBACK(_onDecoderElementAdded), this);
     }
 
     return decoder;
@@ -872,6 +984,18 @@ GstElement *GstVideoReceiver::_makeFileSink(const QString &videoFile, FILE_FORMA
             break;
         }
 
+        // Only matroskamux treats subtitle pads as sparse, with the others a quiet track would stall the video
+        if (_telemetryTrack && (format == FILE_FORMAT_MKV)) {
+            GstElement *telemetrySrc = _makeTelemetrySource(bin, mux);
+            if (telemetrySrc) {
+                QMutexLocker lock(&_telemetryMutex);
+                gst_clear_object(&_telemetrySrc);
+                _telemetrySrc = telemetrySrc;
+            } else {
+                qCWarning(GstVideoReceiverLog) << "Recording without telemetry track";
+            }
+        }
+
         fileSink = bin;
         bin = nullptr;
     } while(0);
@@ -885,6 +1009,118 @@ GstElement *GstVideoReceiver::_makeFileSink(const QString &videoFile, FILE_FORMA
     return fileSink;
 }
 
+GstElement *GstVideoReceiver::_makeTelemetrySource(GstElement *bin, GstElement *mux)
+{
+    GstElement *telemetrySrc = nullptr;
+    GstElement *src = nullptr;
+    GstCaps *caps = nullptr;
+    GstPad *srcPad = nullptr;
+    GstPad *muxPad = nullptr;
+
+    do {
+        src = gst_element_factory_make("appsrc", nullptr);
+        if (!src) {
+            qCCritical(GstVideoReceiverLog) << "gst_element_factory_make('appsrc') failed";
+            break;
+        }
+
+        caps = gst_caps_from_string("text/x-raw,format=utf8");
+        if (!caps) {
+            qCCritical(GstVideoReceiverLog) << "gst_caps_from_string() failed";
+            break;
+        }
+
+        g_object_set(src,
+                     "caps", caps,
+                     "format", GST_FORMAT_TIME,
+                     "is-live", TRUE,
+                     nullptr);
+
+        GstPadTemplate *padTemplate = gst_element_class_get_pad_template(GST_ELEMENT_GET_CLASS(mux), "subtitle_%u");
+        if (!padTemplate) {
+            qCCritical(GstVideoReceiverLog) << "gst_element_class_get_pad_template(mux, subtitle) failed";
+            break;
+        }
+
+        muxPad = gst_element_request_pad(mux, padTemplate, nullptr, nullptr);
+        if (!muxPad) {
+            qCCritical(GstVideoReceiverLog) << "gst_element_request_pad(mux, subtitle) failed";
+            break;
+        }
+
+        if (!gst_bin_add(GST_BIN(bin), src)) {
+            qCCritical(GstVideoReceiverLog) << "gst_bin_add(appsrc) failed";
+            gst_element_release_request_pad(mux, muxPad);
+            break;
+        }
+
+        // The bin owns the element from here on, keep one reference for pushing
+        telemetrySrc = GST_ELEMENT(gst_object_ref(src));
+        src = nullptr;
+
+        srcPad = gst_element_get_static_pad(telemetrySrc, "src");
+        if (!srcPad || (gst_pad_link(srcPad, muxPad) != GST_PAD_LINK_OK)) {
+            qCCritical(GstVideoReceiverLog) << "Failed to link telemetry source";
+            gst_element_release_request_pad(mux, muxPad);
+            (void) gst_bin_remove(GST_BIN(bin), telemetrySrc);
+            gst_clear_object(&telemetrySrc);
+            break;
+        }
+    } while(0);
+
+    gst_clear_object(&srcPad);
+    gst_clear_object(&muxPad);
+    gst_clear_caps(&caps);
+    gst_clear_object(&src);
+
+    return telemetrySrc;
+}
+
+void GstVideoReceiver::pushTelemetry(const QString &text, qint64 startMsecs, qint64 durationMsecs)
+{
+    GstElement *telemetrySrc = nullptr;
+    _telemetryMutex.lock();
+    if (_telemetrySrc) {
+        telemetrySrc = GST_ELEMENT(gst_object_ref(_telemetrySrc));
+    }
+    _telemetryMutex.unlock();
+
+    if (!telemetrySrc) {
+        return;
+    }
+
+    const QByteArray utf8 = text.toUtf8();
+    GstBuffer *buf = gst_buffer_new_memdup(utf8.constData(), utf8.size());
+    GST_BUFFER_PTS(buf) = static_cast<GstClockTime>(startMsecs) * GST_MSECOND;
+    GST_BUFFER_DURATION(buf) = static_cast<GstClockTime>(durationMsecs) * GST_MSECOND;
+
+    // appsrc takes its own reference to the buffer
+    GstFlowReturn ret = GST_FLOW_OK;
+    g_signal_emit_by_name(telemetrySrc, "push-buffer", buf, &ret);
+    if (ret != GST_FLOW_OK) {
+        qCDebug(GstVideoReceiverLog) << "Telemetry buffer not accepted" << gst_flow_get_name(ret);
+    }
+
+    gst_buffer_unref(buf);
+    gst_object_unref(telemetrySrc);
+}
+
+void GstVideoReceiver::_endTelemetryTrack()
+{
+    _telemetryMutex.lock();
+    GstElement *telemetrySrc = _telemetrySrc;
+    _telemetrySrc = nullptr;
+    _telemetryMutex.unlock();
+
+    if (!telemetrySrc) {
+        return;
+    }
+
+    GstFlowReturn ret = GST_FLOW_OK;
+    g_signal_emit_by_name(telemetrySrc, "end-of-stream", &ret);
+    gst_object_unref(telemetrySrc);
+}
+
 void GstVideoReceiver::_onNewSourcePad(GstPad *pad)
 {
     // FIXME: check for caps - if this is not video stream (and preferably - one of these which we have to support) then simply skip it
@@ -1011,9 +1247,15 @@ bool GstVideoReceiver::_addVideoSink(GstPad *pad)
 
     g_object_set(_videoSink,
                  "widget", _widget,
-                 "sync", (_buffer >= 0),
+                 "sync", (_buffer >= 0) && !lowLatency(),
                  NULL);
 
+    gboolean sync = FALSE;
+    if (g_object_class_find_property(G_OBJECT_GET_CLASS(_videoSink), "sync")) {
+        g_object_get(_videoSink, "sync", &sync, NULL);
+    }
+    _videoSinkSync = sync;
+
     (void) gst_element_sync_state_with_parent(_videoSink);
 
     GST_DEBUG_BIN_TO_DOT_FILE(GST_BIN(_pipeline), GST_DEBUG_GRAPH_SHOW_ALL, "pipeline-with-videosink");
@@ -1037,13 +1279,25 @@ bool GstVideoReceiver::_addVideoSink(GstPad *pad)
     return true;
 }
 
-void GstVideoReceiver::_noteTeeFrame()
+void GstVideoReceiver::_noteTeeFrame(GstPad *pad, GstBuffer *buf)
 {
     _lastSourceFrameTime = QDateTime::currentSecsSinceEpoch();
+
+    const qint64 ageUsecs = _bufferAgeUsecs(pad, buf, false);
+    if (ageUsecs >= 0) {
+        QMutexLocker lock(&_latencyMutex);
+        _receiveLatency.record(ageUsecs);
+    }
 }
 
-void GstVideoReceiver::_noteVideoSinkFrame()
+void GstVideoReceiver::_noteVideoSinkFrame(GstPad *pad, GstBuffer *buf)
 {
+    const qint64 ageUsecs = _bufferAgeUsecs(pad, buf, true);
+    if (ageUsecs >= 0) {
+        QMutexLocker lock(&_latencyMutex);
+        _renderLatency.record(ageUsecs);
+    }
+
     _lastVideoFrameTime = QDateTime::currentSecsSinceEpoch();
     if (!_decoding) {
         _decoding = true;
@@ -1052,11 +1306,213 @@ void GstVideoReceiver::_noteVideoSinkFrame()
     }
 }
 
+qint64 GstVideoReceiver::_bufferAgeUsecs(GstPad *pad, GstBuffer *buf, bool rendered) const
+{
+    if (!buf || !_pipeline || !GST_BUFFER_PTS_IS_VALID(buf)) {
+        return -1;
+    }
+
+    GstEvent *event = gst_pad_get_sticky_event(pad, GST_EVENT_SEGMENT, 0);
+    if (!event) {
+        return -1;
+    }
+
+    const GstSegment *segment = nullptr;
+    gst_event_parse_segment(event, &segment);
+    const GstClockTime runningTime = gst_segment_to_running_time(segment, GST_FORMAT_TIME, GST_BUFFER_PTS(buf));
+    gst_event_unref(event);
+
+    if (!GST_CLOCK_TIME_IS_VALID(runningTime)) {
+        return -1;
+    }
+
+    GstClock *clock = gst_element_get_clock(_pipeline);
+    if (!clock) {
+        return -1;
+    }
+
+    const GstClockTime now = gst_clock_get_time(clock) - gst_element_get_base_time(_pipeline);
+    gst_object_unref(clock);
+
+    GstClockTime renderTime = now;
+    if (rendered && _videoSinkSync) {
+        // A syncing sink holds the frame back until its running time plus the pipeline latency
+        renderTime = qMax(now, runningTime + _pipelineLatency.load());
+    }
+
+    if (renderTime < runningTime) {
+        // Timestamps which are not arrival based, e.g. taken from an MPEG-TS stream
+        return -1;
+    }
+
+    return static_cast<qint64>(GST_TIME_AS_USECONDS(renderTime - runningTime));
+}
+
+void GstVideoReceiver::_applyLatencyProfile(GstElement *element)
+{
+    GObjectClass *elementClass = G_OBJECT_GET_CLASS(element);
+
+    // Frame threading (the libav default) holds back one frame per decoder thread, slice threading does not
+    if (g_object_class_find_property(elementClass, "thread-type")) {
+        gst_util_set_object_arg(G_OBJECT(element), "thread-type", "slice");
+        qCDebug(GstVideoReceiverLog) << "Slice threading for" << GST_ELEMENT_NAME(element);
+    }
+
+    const GParamSpec *lowLatencySpec = g_object_class_find_property(elementClass, "low-latency");
+    if (lowLatencySpec && (lowLatencySpec->value_type == G_TYPE_BOOLEAN) && (lowLatencySpec->flags & G_PARAM_WRITABLE)) {
+        g_object_set(element,
+                     "low-latency", TRUE,
+                     nullptr);
+        qCDebug(GstVideoReceiverLog) << "Low latency set for" << GST_ELEMENT_NAME(element);
+    }
+}
+
 void GstVideoReceiver::_noteEndOfStream()
 {
     _endOfStream = true;
 }
 
+void GstVideoReceiver::_noteVideoSinkSample(GstPad *pad, GstBuffer *buf)
+{
+    if (!buf) {
+        return;
+    }
+
+    // Only references are taken, the frame itself is not touched unless a screenshot is requested
+    GstCaps *caps = gst_pad_get_current_caps(pad);
+    GstSample *sample = gst_sample_new(buf, caps, nullptr, nullptr);
+    gst_clear_caps(&caps);
+
+    QMutexLocker lock(&_lastSampleMutex);
+    if (_lastSample) {
+        gst_sample_unref(_lastSample);
+    }
+    _lastSample = sample;
+}
+
+void GstVideoReceiver::_cachePrerollBuffer(GstBuffer *buf)
+{
+    if (!GST_BUFFER_FLAG_IS_SET(buf, GST_BUFFER_FLAG_DELTA_UNIT)) {
+        _clearPreroll();
+    } else if (_prerollBuffers.isEmpty()) {
+        // No keyframe yet, nothing before it is any use
+        return;
+    }
+
+    const gsize size = gst_buffer_get_size(buf);
+    if ((_prerollBytes + size) > _kMaxPrerollBytes) {
+        // Unusually long GOP, give up on it and wait for the next keyframe
+        qCDebug(GstVideoReceiverLog) << "Pre-roll GOP exceeds" << _kMaxPrerollBytes << "bytes, dropped" << _uri;
+        _clearPreroll();
+        return;
+    }
+
+    _prerollBuffers.append(gst_buffer_ref(buf));
+    _prerollBytes += size;
+}
+
+void GstVideoReceiver::_pushPreroll(GstBuffer *buf, const QList<GstBuffer*> &preroll)
+{
+    GstPad *sinkpad = gst_element_get_static_pad(_recorderValve, "sink");
+    GstPad *srcpad = gst_element_get_static_pad(_recorderValve, "src");
+
+    // _keyframeWatch measures the recording's first keyframe against this, it runs from the pushes below
+    _recordingStartPts = GST_BUFFER_PTS(buf);
+
+    if (sinkpad && srcpad && !preroll.isEmpty()) {
+        // The closed valve has not forwarded caps/segment yet, the file sink needs them ahead of the first buffer
+        gst_pad_sticky_events_foreach(sinkpad, _copyStickyEvent, srcpad);
+
+        qCDebug(GstVideoReceiverLog) << "Pushing pre-roll of" << preroll.count() << "buffers" << _uri;
+
+        for (qsizetype i = 0; i < preroll.count(); i++) {
+            // gst_pad_push takes over the reference
+            const GstFlowReturn ret = gst_pad_push(srcpad, preroll[i]);
+            if (ret != GST_FLOW_OK) {
+                qCWarning(GstVideoReceiverLog) << "Pre-roll push failed" << gst_flow_get_name(ret) << _uri;
+                for (qsizetype j = i + 1; j < preroll.count(); j++) {
+                    gst_buffer_unref(preroll[j]);
+                }
+                break;
+            }
+        }
+    } else {
+        for (GstBuffer *cached : preroll) {
+            gst_buffer_unref(cached);
+        }
+    }
+
+    gst_clear_object(&srcpad);
+    gst_clear_object(&sinkpad);
+}
+
+void GstVideoReceiver::_clearPreroll()
+{
+    for (GstBuffer *buf : std::as_const(_prerollBuffers)) {
+        gst_buffer_unref(buf);
+    }
+
+    _prerollBuffers.clear();
+    _prerollBytes = 0;
+}
+
+bool GstVideoReceiver::_saveSample(GstSample *sample, const QString &imageFile)
+{
+    GstVideoInfo inInfo;
+    if (!gst_video_info_from_caps(&inInfo, gst_sample_get_caps(sample))) {
+        qCCritical(GstVideoReceiverLog) << "gst_video_info_from_caps() failed";
+        return false;
+    }
+
+    // Mapping for read works for system memory as well as GL/VA/D3D11 memory, which is downloaded on map.
+    // The conversion is done on the mapped frame rather than through a conversion pipeline for that reason.
+    GstVideoFrame inFrame;
+    if (!gst_video_frame_map(&inFrame, &inInfo, gst_sample_get_buffer(sample), GST_MAP_READ)) {
+        qCCritical(GstVideoReceiverLog) << "gst_video_frame_map() failed";
+        return false;
+    }
+
+    const gint width = GST_VIDEO_INFO_WIDTH(&inInfo);
+    const gint height = GST_VIDEO_INFO_HEIGHT(&inInfo);
+    QImage image(width, height, QImage::Format_RGBA8888);
+
+    GstVideoInfo outInfo;
+    (void) gst_video_info_set_format(&outInfo, GST_VIDEO_FORMAT_RGBA, width, height);
+    GST_VIDEO_INFO_PLANE_STRIDE(&outInfo, 0) = image.bytesPerLine();
+    GST_VIDEO_INFO_SIZE(&outInfo) = image.sizeInBytes();
+
+    bool converted = false;
+    GstBuffer *outBuffer = gst_buffer_new_wrapped_full(static_cast<GstMemoryFlags>(0), image.bits(), image.sizeInBytes(), 0, image.sizeInBytes(), nullptr, nullptr);
+    GstVideoFrame outFrame;
+    if (gst_video_frame_map(&outFrame, &outInfo, outBuffer, GST_MAP_WRITE)) {
+        GstVideoConverter *converter = gst_video_converter_new(&inInfo, &outInfo, nullptr);
+        if (converter) {
+            gst_video_converter_frame(converter, &inFrame, &outFrame);
+            gst_video_converter_free(converter);
+            converted = true;
+        } else {
+            qCCritical(GstVideoReceiverLog) << "gst_video_converter_new() failed";
+        }
+        gst_video_frame_unmap(&outFrame);
+    } else {
+        qCCritical(GstVideoReceiverLog) << "gst_video_frame_map() failed";
+    }
+
+    gst_buffer_unref(outBuffer);
+    gst_video_frame_unmap(&inFrame);
+
+    if (!converted) {
+        return false;
+    }
+
+    if (!image.save(imageFile)) {
+        qCCritical(GstVideoReceiverLog) << "QImage::save() failed" << imageFile;
+        return false;
+    }
+
+    return true;
+}
+
 bool GstVideoReceiver::_unlinkBranch(GstElement *from)
 {
     GstPad *src = gst_element_get_static_pad(from, "src");
@@ -1120,6 +1576,13 @@ void GstVideoReceiver::_shutdownDecodingBranch()
 
     _lastVideoFrameTime = 0;
 
+    _lastSampleMutex.lock();
+    if (_lastSample) {
+        gst_sample_unref(_lastSample);
+        _lastSample = nullptr;
+    }
+    _lastSampleMutex.unlock();
+
     GstObject *parent = gst_element_get_parent(_videoSink);
     if (parent) {
         (void) gst_bin_remove(GST_BIN(_pipeline), _videoSink);
@@ -1142,6 +1605,8 @@ void GstVideoReceiver::_shutdownDecodingBranch()
 
 void GstVideoReceiver::_shutdownRecordingBranch()
 {
+    _endTelemetryTrack();
+
     gst_bin_remove(GST_BIN(_pipeline), _fileSink);
     gst_element_set_state(_fileSink, GST_STATE_NULL);
     gst_clear_object(&_fileSink);
@@ -1322,11 +1787,9 @@ gboolean GstVideoReceiver::_padProbe(GstElement *element, GstPad *pad, gpointer
 
 GstPadProbeReturn GstVideoReceiver::_teeProbe(GstPad *pad, GstPadProbeInfo *info, gpointer user_data)
 {
-    Q_UNUSED(pad); Q_UNUSED(info)
-
     if (user_data) {
         GstVideoReceiver *pThis = static_cast<GstVideoReceiver*>(user_data);
-        pThis->_noteTeeFrame();
+        pThis->_noteTeeFrame(pad, gst_pad_probe_info_get_buffer(info));
     }
 
     return GST_PAD_PROBE_OK;
@@ -1334,8 +1797,6 @@ GstPadProbeReturn GstVideoReceiver::_teeProbe(GstPad *pad, GstPadProbeInfo *info
 
 GstPadProbeReturn GstVideoReceiver::_videoSinkProbe(GstPad *pad, GstPadProbeInfo *info, gpointer user_data)
 {
-    Q_UNUSED(pad); Q_UNUSED(info)
-
     if (user_data) {
         GstVideoReceiver *pThis = static_cast<GstVideoReceiver*>(user_data);
 
@@ -1367,7 +1828,8 @@ GstPadProbeReturn GstVideoReceiver::_videoSinkProbe(GstPad *pad, GstPadProbeInfo
 #endif
         }
 
-        pThis->_noteVideoSinkFrame();
+        pThis->_noteVideoSinkSample(pad, gst_pad_probe_info_get_buffer(info));
+        pThis->_noteVideoSinkFrame(pad, gst_pad_probe_info_get_buffer(info));
     }
 
     return GST_PAD_PROBE_OK;
@@ -1408,11 +1870,90 @@ GstPadProbeReturn GstVideoReceiver::_keyframeWatch(GstPad *pad, GstPadProbeInfo
     qCDebug(GstVideoReceiverLog) << "Got keyframe, stop dropping buffers";
 
     GstVideoReceiver *pThis = static_cast<GstVideoReceiver*>(user_data);
-    pThis->_dispatchSignal([pThis]() { emit pThis->recordingStarted(pThis->recordingOutput()); });
+
+    // The file starts at this keyframe. That is the cached one, up to a GOP ahead of the moment the recording was
+    // started, or a later live one when nothing was cached. Telemetry written alongside is shifted to match.
+    qint64 prerollMsecs = 0;
+    if (GST_CLOCK_TIME_IS_VALID(pThis->_recordingStartPts) && GST_BUFFER_PTS_IS_VALID(buf)) {
+        prerollMsecs = GST_CLOCK_DIFF(buf->pts, pThis->_recordingStartPts) / static_cast<GstClockTimeDiff>(GST_MSECOND);
+    }
+    qCDebug(GstVideoReceiverLog) << "Recording pre-roll" << prerollMsecs << "msecs";
+
+    pThis->_dispatchSignal([pThis, prerollMsecs]() { emit pThis->recordingStarted(pThis->recordingOutput(), prerollMsecs); });
 
     return GST_PAD_PROBE_REMOVE;
 }
 
+GstPadProbeReturn GstVideoReceiver::_prerollProbe(GstPad *pad, GstPadProbeInfo *info, gpointer user_data)
+{
+    Q_UNUSED(pad);
+
+    if (!info || !user_data) {
+        return GST_PAD_PROBE_OK;
+    }
+
+    GstBuffer *buf = gst_pad_probe_info_get_buffer(info);
+    if (!buf) {
+        return GST_PAD_PROBE_OK;
+    }
+
+    GstVideoReceiver *pThis = static_cast<GstVideoReceiver*>(user_data);
+
+    // The cached GOP can be large, so it is pushed without holding the lock stopRecording needs
+    QList<GstBuffer*> preroll;
+    bool push = false;
+    pThis->_prerollMutex.lock();
+    if (pThis->_prerollPending) {
+        pThis->_prerollPending = false;
+        pThis->_prerollPushing = true;
+        push = true;
+        preroll.reserve(pThis->_prerollBuffers.count());
+        for (GstBuffer *cached : std::as_const(pThis->_prerollBuffers)) {
+            preroll.append(gst_buffer_ref(cached));
+        }
+    }
+    pThis->_prerollMutex.unlock();
+
+    if (push) {
+        pThis->_pushPreroll(buf, preroll);
+    }
+
+    QMutexLocker lock(&pThis->_prerollMutex);
+
+    // Only opened if the recording was not stopped while the pre-roll was pushed
+    if (pThis->_prerollPushing) {
+        pThis->_prerollPushing = false;
+        g_object_set(pThis->_recorderValve,
+                     "drop", FALSE,
+                     nullptr);
+    }
+
+    // Keep caching while recording as well, the next recording may follow shortly
+    pThis->_cachePrerollBuffer(buf);
+
+    return GST_PAD_PROBE_OK;
+}
+
+void GstVideoReceiver::_onDecoderElementAdded(GstBin *bin, GstBin *subBin, GstElement *element, gpointer user_data)
+{
+    Q_UNUSED(bin); Q_UNUSED(subBin);
+
+    GstVideoReceiver *pThis = static_cast<GstVideoReceiver*>(user_data);
+    pThis->_applyLatencyProfile(element);
+}
+
+gboolean GstVideoReceiver::_copyStickyEvent(GstPad *pad, GstEvent **event, gpointer user_data)
+{
+    Q_UNUSED(pad);
+
+    GstPad *srcpad = static_cast<GstPad*>(user_data);
+    if (gst_pad_store_sticky_event(srcpad, *event) != GST_FLOW_OK) {
+        qCWarning(GstVideoReceiverLog) << "gst_pad_store_sticky_event() failed" << GST_EVENT_TYPE_NAME(*event);
+    }
+
+    return TRUE;
+}
+
 GstVideoWorker::GstVideoWorker(QObject *parent)
     : QThread(parent)
 {
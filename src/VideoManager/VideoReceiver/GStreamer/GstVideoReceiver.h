@@ -9,19 +9,26 @@
 
 #pragma once
 
+#include <QtCore/QList>
 #include <QtCore/QLoggingCategory>
 #include <QtCore/QMutex>
 #include <QtCore/QQueue>
 #include <QtCore/QThread>
 #include <QtCore/QTimer>
+#include <QtCore/QVariantMap>
 #include <QtCore/QWaitCondition>
 
 #include <glib.h>
+#include <gst/gstbin.h>
 #include <gst/gstelement.h>
 #include <gst/gstpad.h>
+#include <gst/gstsample.h>
 
+#include "LatencyHistogram.h"
 #include "VideoReceiver.h"
 
+#include <atomic>
+
 Q_DECLARE_LOGGING_CATEGORY(GstVideoReceiverLog)
 
 typedef std::function<void()> Task;
@@ -60,6 +67,14 @@ class GstVideoReceiver : public VideoReceiver
     explicit GstVideoReceiver(QObject *parent = nullptr);
     ~GstVideoReceiver();
 
+    /// Receive-to-render latency, usecs. Frames are aged from their buffer timestamps, which live RTP sources
+    /// set from packet arrival. Measured up to the video sink, display refresh is not included.
+    QVariantMap latencyStats() const override;
+    void resetLatencyStats() override;
+
+    /// Thread safe. Dropped unless a recording with a telemetry track is running.
+    void pushTelemetry(const QString &text, qint64 startMsecs, qint64 durationMsecs) override;
+
 public slots:
     void start(uint32_t timeout) override;
     void stop() override;
@@ -77,14 +92,31 @@ private slots:
     GstElement *_makeSource(const QString &input);
     GstElement *_makeDecoder(GstCaps *caps = nullptr, GstElement *videoSink = nullptr);
     GstElement *_makeFileSink(const QString &videoFile, FILE_FORMAT format);
+    /// Adds an appsrc for telemetry text to the file sink bin, linked to a subtitle pad of the muxer
+    ///     @return Referenced appsrc, nullptr on failure
+    GstElement *_makeTelemetrySource(GstElement *bin, GstElement *mux);
 
     void _onNewSourcePad(GstPad *pad);
     void _onNewDecoderPad(GstPad *pad);
     bool _addDecoder(GstElement *src);
     bool _addVideoSink(GstPad *pad);
-    void _noteTeeFrame();
-    void _noteVideoSinkFrame();
+    void _noteTeeFrame(GstPad *pad, GstBuffer *buf);
+    void _noteVideoSinkFrame(GstPad *pad, GstBuffer *buf);
+    /// Time since the buffer was received, -1 if that can't be told from its timestamp
+    qint64 _bufferAgeUsecs(GstPad *pad, GstBuffer *buf, bool rendered) const;
+    void _applyLatencyProfile(GstElement *element);
     void _noteEndOfStream();
+    void _noteVideoSinkSample(GstPad *pad, GstBuffer *buf);
+    /// Keeps the recorder branch's most recent GOP, starting from its keyframe. Streaming thread only.
+    void _cachePrerollBuffer(GstBuffer *buf);
+    /// Pushes the GOP into the file sink, without holding _prerollMutex. Streaming thread only.
+    ///     @param buf Live buffer which arrived once the recording was requested
+    ///     @param preroll Referenced copy of the cached GOP, unreferenced here
+    void _pushPreroll(GstBuffer *buf, const QList<GstBuffer*> &preroll);
+    void _clearPreroll();
+    /// Ends the telemetry track, if any, and forgets its source
+    void _endTelemetryTrack();
+    static bool _saveSample(GstSample *sample, const QString &imageFile);
     /// -Unlink the branch from the src pad
     /// -Send an EOS event at the beginning of that branch
     bool _unlinkBranch(GstElement *from);
@@ -104,6 +136,9 @@ private slots:
     static GstPadProbeReturn _videoSinkProbe(GstPad *pad, GstPadProbeInfo *info, gpointer user_data);
     static GstPadProbeReturn _eosProbe(GstPad *pad, GstPadProbeInfo *info, gpointer user_data);
     static GstPadProbeReturn _keyframeWatch(GstPad *pad, GstPadProbeInfo *info, gpointer user_data);
+    static GstPadProbeReturn _prerollProbe(GstPad *pad, GstPadProbeInfo *info, gpointer user_data);
+    static gboolean _copyStickyEvent(GstPad *pad, GstEvent **event, gpointer user_data);
+    static void _onDecoderElementAdded(GstBin *bin, GstBin *subBin, GstElement *element, gpointer user_data);
 
     GstElement *_decoder = nullptr;
     GstElement *_decoderValve = nullptr;
@@ -117,6 +152,29 @@ private slots:
     gulong _teeProbeId = 0;
     gulong _videoSinkProbeId = 0;
 
+    QMutex _prerollMutex;
+    QList<GstBuffer*> _prerollBuffers;  ///< Referenced, not copied
+    gsize _prerollBytes = 0;
+    bool _prerollPending = false;       ///< Recording was requested, the next buffer flushes the pre-roll
+    bool _prerollPushing = false;       ///< Pre-roll is being pushed, cleared if the recording stops meanwhile
+    GstClockTime _recordingStartPts = GST_CLOCK_TIME_NONE;  ///< Buffer the recording was started on, streaming thread only
+
+    QMutex _telemetryMutex;
+    GstElement *_telemetrySrc = nullptr;    ///< appsrc feeding the recording's subtitle track, referenced
+
+    QMutex _lastSampleMutex;
+    GstSample *_lastSample = nullptr;   ///< Last decoded frame, for screenshots
+
+    mutable QMutex _latencyMutex;
+    LatencyHistogram _receiveLatency;   ///< Received to leaving the source bin (jitter buffer, depay, parse)
+    LatencyHistogram _renderLatency;    ///< Received to reaching the video sink
+    std::atomic_bool _videoSinkSync = false;
+    std::atomic<GstClockTime> _pipelineLatency = 0;     ///< Refreshed by the watchdog, applies to syncing sinks
+
+    static constexpr gsize _kMaxPrerollBytes = 32 * 1024 * 1024;
+    static constexpr int _kLowLatencyBufferMs = 10;   ///< Jitter buffer latency in low latency mode
+    static constexpr int _kLowLatencyQueueBuffers = 2;
+
     static constexpr const char *_kFileMux[FILE_FORMAT_MAX + 1] = {
         "matroskamux",
         "qtmux",
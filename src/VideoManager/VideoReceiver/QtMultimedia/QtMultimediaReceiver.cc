@@ -77,7 +77,7 @@ QtMultimediaReceiver::QtMultimediaReceiver(QObject *parent)
     _mediaRecorder->setVideoResolution(QSize());
     (void) connect(_mediaRecorder, &QMediaRecorder::recorderStateChanged, this, [this](QMediaRecorder::RecorderState state) {
         if (state == QMediaRecorder::RecorderState::RecordingState) {
-            emit recordingStarted(_mediaRecorder->actualLocation().toString());
+            emit recordingStarted(_mediaRecorder->actualLocation().toString(), 0);
         }
         emit recordingChanged(_mediaRecorder->recorderState() == QMediaRecorder::RecorderState::RecordingState);
     });
@@ -12,6 +12,7 @@
 #include <QtCore/QObject>
 #include <QtCore/QSize>
 #include <QtCore/QTimer>
+#include <QtCore/QVariantMap>
 #include <QtQmlIntegration/QtQmlIntegration>
 
 class QGCVideoStreamInfo;
@@ -35,6 +36,7 @@ class VideoReceiver : public QObject
     QString uri() const { return _uri; }
     bool started() const { return _started; }
     bool lowLatency() const { return _lowLatency; }
+    bool telemetryTrack() const { return _telemetryTrack; }
     QGCVideoStreamInfo *videoStreamInfo() { return _videoStreamInfo; }
     QString recordingOutput() const { return _recordingOutput; }
 
@@ -44,8 +46,17 @@ class VideoReceiver : public QObject
     void setUri(const QString &uri) { if (uri != _uri) { _uri = uri; emit uriChanged(_uri); } }
     void setStarted(bool started) { if (started != _started) { _started = started; emit startedChanged(_started); } }
     void setLowLatency(bool lowLatency) { if (lowLatency != _lowLatency) { _lowLatency = lowLatency; emit lowLatencyChanged(_lowLatency); } }
+    void setTelemetryTrack(bool telemetryTrack) { if (telemetryTrack != _telemetryTrack) { _telemetryTrack = telemetryTrack; emit telemetryTrackChanged(_telemetryTrack); } }
     void setVideoStreamInfo(QGCVideoStreamInfo *videoStreamInfo) { if (videoStreamInfo != _videoStreamInfo) { _videoStreamInfo = videoStreamInfo; emit videoStreamInfoChanged(); } }
 
+    /// Per frame latency statistics, empty if the receiver does not measure latency
+    virtual QVariantMap latencyStats() const { return QVariantMap(); }
+    virtual void resetLatencyStats() {}
+
+    /// Adds a telemetry text sample to the running recording, when the receiver embeds a telemetry track.
+    /// Times are relative to the start of the recording. Must be thread safe.
+    virtual void pushTelemetry(const QString &text, qint64 startMsecs, qint64 durationMsecs) { Q_UNUSED(text); Q_UNUSED(startMsecs); Q_UNUSED(durationMsecs); }
+
     // QMediaFormat::FileFormat
     enum FILE_FORMAT {
         FILE_FORMAT_MIN = 0,
@@ -74,7 +85,9 @@ class VideoReceiver : public QObject
     void streamingChanged(bool active);
     void decodingChanged(bool active);
     void recordingChanged(bool active);
-    void recordingStarted(const QString &filename);
+    /// @param prerollMsecs Video already in the recording ahead of the moment it was started, telemetry
+    ///                     written alongside has to start this far into the file
+    void recordingStarted(const QString &filename, qint64 prerollMsecs);
     void videoSizeChanged(QSize size);
 
     void sinkChanged(void *sink);
@@ -82,6 +95,7 @@ class VideoReceiver : public QObject
     void uriChanged(const QString &uri);
     void startedChanged(bool started);
     void lowLatencyChanged(bool lowLatency);
+    void telemetryTrackChanged(bool telemetryTrack);
     void videoStreamInfoChanged();
     void widgetChanged(QQuickItem *widget);
 
@@ -113,6 +127,7 @@ public slots:
     bool _recording = false;
     bool _streaming = false;
     bool _lowLatency = false;
+    bool _telemetryTrack = false;   ///< Recordings get a telemetry track, read when a recording starts
     bool _resetVideoSink = false;
     bool _endOfStream = false;
     bool _removingDecoder = false;
@@ -11,6 +11,9 @@
 #include "SettingsManager.h"
 #include "Viewer3DSettings.h"
 #include "OsmParser.h"
+#include "MultiVehicleManager.h"
+#include "Vehicle.h"
+#include "Viewer3DUtils.h"
 
 
 CityMapGeometry::CityMapGeometry()
@@ -24,6 +27,9 @@ CityMapGeometry::CityMapGeometry()
 
     setOsmFilePath(_viewer3DSettings->osmFilePath()->rawValue());
     connect(_viewer3DSettings->osmFilePath(), &Fact::rawValueChanged, this, &CityMapGeometry::setOsmFilePath);
+
+    activeVehicleChanged(MultiVehicleManager::instance()->activeVehicle());
+    connect(MultiVehicleManager::instance(), &MultiVehicleManager::activeVehicleChanged, this, &CityMapGeometry::activeVehicleChanged);
 }
 
 void CityMapGeometry::setModelName(QString modelName)
@@ -48,13 +54,50 @@ void CityMapGeometry::setOsmParser(OsmParser *newOsmParser)
     _osmParser = newOsmParser;
 
     if(_osmParser){
-        connect(_osmParser, &OsmParser::buildingLevelHeightChanged, this, &CityMapGeometry::updateViewer);
+        connect(_osmParser, &OsmParser::buildingMeshChanged, this, &CityMapGeometry::updateViewer);
         connect(_osmParser, &OsmParser::mapChanged, this, &CityMapGeometry::updateViewer);
     }
     emit osmParserChanged();
     loadOsmMap();
 }
 
+void CityMapGeometry::setTileLoadRadius(float tileLoadRadius)
+{
+    if(_tileLoadRadius != tileLoadRadius){
+        _tileLoadRadius = tileLoadRadius;
+        emit tileLoadRadiusChanged();
+        updateVisibleTiles();
+    }
+}
+
+void CityMapGeometry::activeVehicleChanged(Vehicle *vehicle)
+{
+    if(_activeVehicle){
+        disconnect(_activeVehicle, &Vehicle::coordinateChanged, this, &CityMapGeometry::activeVehicleCoordinateChanged);
+    }
+
+    _activeVehicle = vehicle;
+    _vehiclePositionValid = false;
+    if(_activeVehicle){
+        connect(_activeVehicle, &Vehicle::coordinateChanged, this, &CityMapGeometry::activeVehicleCoordinateChanged);
+        activeVehicleCoordinateChanged(_activeVehicle->coordinate());
+    }else{
+        updateVisibleTiles();
+    }
+}
+
+void CityMapGeometry::activeVehicleCoordinateChanged(QGeoCoordinate newCoordinate)
+{
+    if(!_osmParser || !newCoordinate.isValid() || !(newCoordinate.latitude() && newCoordinate.longitude())){
+        return;
+    }
+
+    const QVector3D localPoint = mapGpsToLocalPoint(newCoordinate, _osmParser->getGpsRef());
+    _vehiclePosition = QVector2D(localPoint.x(), localPoint.y());
+    _vehiclePositionValid = true;
+    updateVisibleTiles();
+}
+
 bool CityMapGeometry::loadOsmMap()
 {
     if(!_osmParser){
@@ -67,33 +110,80 @@ bool CityMapGeometry::loadOsmMap()
 
 void CityMapGeometry::updateViewer()
 {
-    clear();
-
     if(!_osmParser){
+        clearViewer();
         return;
     }
 
+    _meshTiles.clear();
     if(_osmParser->mapLoaded()){
-        _vertexData = _osmParser->buildingToMesh();
+        _meshTiles = _osmParser->meshTiles();
+    }
 
-        int stride = 3 * sizeof(float);
-        if(!_vertexData.isEmpty()){
-            setVertexData(_vertexData);
-            setStride(stride);
+    // Force the upload even if the same tile indices are selected, the meshes are new
+    _visibleTiles = { -1 };
 
-            setPrimitiveType(QQuick3DGeometry::PrimitiveType::Triangles);
+    // Vehicle position is relative to the gps reference, which the new map may have moved
+    _vehiclePositionValid = false;
+    if(_activeVehicle){
+        activeVehicleCoordinateChanged(_activeVehicle->coordinate());
+    }
+    if(!_vehiclePositionValid){
+        updateVisibleTiles();
+    }
+}
 
-            addAttribute(QQuick3DGeometry::Attribute::PositionSemantic,
-                         0,
-                         QQuick3DGeometry::Attribute::F32Type);
+void CityMapGeometry::updateVisibleTiles()
+{
+    QList<int> visibleTiles;
+    for(int i=0; i<_meshTiles.size(); i++){
+        const OsmParserThread::MeshTile_t& tile = _meshTiles[i];
+        if(_vehiclePositionValid){
+            // Distance from the vehicle to the closest point of the tile bounding box
+            const float dx = qMax(qMax(tile.bb_min.x() - _vehiclePosition.x(), _vehiclePosition.x() - tile.bb_max.x()), 0.0f);
+            const float dy = qMax(qMax(tile.bb_min.y() - _vehiclePosition.y(), _vehiclePosition.y() - tile.bb_max.y()), 0.0f);
+            if((dx * dx + dy * dy) > (_tileLoadRadius * _tileLoadRadius)){
+                continue;
+            }
         }
-        update();
+        visibleTiles.append(i);
+    }
+
+    if(visibleTiles == _visibleTiles){
+        return;
+    }
+    _visibleTiles = visibleTiles;
+
+    qsizetype vertexDataSize = 0;
+    for(const int i : _visibleTiles){
+        vertexDataSize += _meshTiles[i].vertexData.size();
+    }
+    _vertexData.clear();
+    _vertexData.reserve(vertexDataSize);
+    for(const int i : _visibleTiles){
+        _vertexData.append(_meshTiles[i].vertexData);
     }
+
+    clear();
+    int stride = 3 * sizeof(float);
+    if(!_vertexData.isEmpty()){
+        setVertexData(_vertexData);
+        setStride(stride);
+
+        setPrimitiveType(QQuick3DGeometry::PrimitiveType::Triangles);
+
+        addAttribute(QQuick3DGeometry::Attribute::PositionSemantic,
+                     0,
+                     QQuick3DGeometry::Attribute::F32Type);
+    }
+    update();
 }
 
 void CityMapGeometry::clearViewer()
 {
     clear();
     _vertexData.clear();
+    _meshTiles.clear();
+    _visibleTiles.clear();
     update();
 }
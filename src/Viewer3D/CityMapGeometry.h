@@ -10,13 +10,18 @@
 #pragma once
 
 #include <QtCore/QString>
+#include <QtGui/QVector2D>
+#include <QtPositioning/QGeoCoordinate>
 #include <QtQuick3D/QQuick3DGeometry>
 #include <QtQmlIntegration/QtQmlIntegration>
 
+#include "OsmParserThread.h"
+
 ///     @author Omid Esrafilian <esrafilian.omid@gmail.com>
 
 class Viewer3DSettings;
 class OsmParser;
+class Vehicle;
 
 class CityMapGeometry : public QQuick3DGeometry
 {
@@ -26,6 +31,7 @@ class CityMapGeometry : public QQuick3DGeometry
 
     Q_PROPERTY(QString modelName READ modelName WRITE setModelName NOTIFY modelNameChanged)
     Q_PROPERTY(OsmParser* osmParser READ osmParser WRITE setOsmParser NOTIFY osmParserChanged)
+    Q_PROPERTY(float tileLoadRadius READ tileLoadRadius WRITE setTileLoadRadius NOTIFY tileLoadRadiusChanged)
 
 public:
 
@@ -39,16 +45,22 @@ class CityMapGeometry : public QQuick3DGeometry
     OsmParser* osmParser(){ return _osmParser;}
     void setOsmParser(OsmParser* newOsmParser);
 
+    /// Only building tiles within this distance (meters) of the active vehicle are uploaded
+    float tileLoadRadius() const { return _tileLoadRadius; }
+    void setTileLoadRadius(float tileLoadRadius);
+
     bool loadOsmMap();
 
 signals:
     void modelNameChanged();
     void osmFilePathChanged();
     void osmParserChanged();
+    void tileLoadRadiusChanged();
 
 private:
     void updateViewer();
     void clearViewer();
+    void updateVisibleTiles();
 
     QString _modelName;
     QString _osmFilePath;
@@ -56,7 +68,15 @@ class CityMapGeometry : public QQuick3DGeometry
     OsmParser *_osmParser;
     bool _mapLoadedFlag;
     Viewer3DSettings* _viewer3DSettings = nullptr;
+    QList<OsmParserThread::MeshTile_t> _meshTiles;
+    QList<int> _visibleTiles;   ///< Indices into _meshTiles of the tiles currently uploaded
+    float _tileLoadRadius = 3000;
+    Vehicle* _activeVehicle = nullptr;
+    bool _vehiclePositionValid = false;
+    QVector2D _vehiclePosition;  ///< Local coordinates of the active vehicle
 
 private slots:
     void setOsmFilePath(QVariant value);
+    void activeVehicleChanged(Vehicle* vehicle);
+    void activeVehicleCoordinateChanged(QGeoCoordinate newCoordinate);
 };
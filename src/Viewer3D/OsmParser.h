@@ -16,10 +16,11 @@
 #include <QtCore/QVariant>
 #include <QtQmlIntegration/QtQmlIntegration>
 
+#include "OsmParserThread.h"
+
 ///     @author Omid Esrafilian <esrafilian.omid@gmail.com>
 
 class Viewer3DSettings;
-class OsmParserThread;
 
 class OsmParser : public QObject
 {
@@ -40,10 +41,9 @@ class OsmParser : public QObject
     float buildingLevelHeight(void){return _buildingLevelHeight;}
     void parseOsmFile(QString filePath);
 
-    QByteArray buildingToMesh();
+    /// Building meshes of the loaded map, split into OsmParserThread::meshTileSize squares
+    QList<OsmParserThread::MeshTile_t> meshTiles();
 
-    void trianglateWallsExtrudedPolygon(std::vector<QVector3D>& triangulatedMesh, std::vector<QVector2D> verticesCcw, float h, bool inverseOrder=0, bool duplicateStartEndPoint=0);
-    void trianglateRectangle(std::vector<QVector3D>& triangulatedMesh, std::vector<QVector3D> verticesCcw, bool invertNormal);
     std::pair<QGeoCoordinate, QGeoCoordinate> getMapBoundingBoxCoordinate(){ return std::pair(_coordinateMin, _coordinateMax);}
 
 private:
@@ -64,10 +64,12 @@ class OsmParser : public QObject
     void gpsRefChanged(QGeoCoordinate newGpsRef, bool isRefSet);
     void mapChanged();
     void buildingLevelHeightChanged(void);
+    void buildingMeshChanged(void);
 
 private slots:
     void setBuildingLevelHeight(QVariant value);
     void osmParserFinished(bool isValid);
+    void osmMeshBuilt();
 
 
 };
@@ -9,8 +9,19 @@
 
 #include "OsmParserThread.h"
 #include "Viewer3DUtils.h"
-
+#include "earcut.hpp"
+
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QtMath>
 
 OsmParserThread::OsmParserThread(QObject *parent)
     : QThread{parent}
@@ -26,25 +37,46 @@ OsmParserThread::OsmParserThread(QObject *parent)
     _doubleStoreyLeisure.append("sauna");
 
     connect(this, &OsmParserThread::startThread, this, &OsmParserThread::startThreadEvent);
+    connect(this, &OsmParserThread::startRebuildMesh, this, &OsmParserThread::rebuildMeshEvent);
 
     this->moveToThread(_mainThread);
     _mainThread->start();
 }
 
-void OsmParserThread::start(QString filePath)
+void OsmParserThread::start(QString filePath, float buildingLevelHeight)
+{
+    emit startThread(filePath, buildingLevelHeight);
+}
+
+void OsmParserThread::rebuildMesh(float buildingLevelHeight)
+{
+    emit startRebuildMesh(buildingLevelHeight);
+}
+
+QList<OsmParserThread::MeshTile_t> OsmParserThread::meshTiles()
+{
+    QMutexLocker lock(&_meshTilesMutex);
+    return _meshTiles;
+}
+
+void OsmParserThread::setMeshTiles(const QList<MeshTile_t>& meshTiles)
 {
-    emit startThread(filePath);
+    QMutexLocker lock(&_meshTilesMutex);
+    _meshTiles = meshTiles;
 }
 
-void OsmParserThread::parseOsmFile(QString filePath)
+void OsmParserThread::parseOsmFile(QString filePath, float buildingLevelHeight)
 {
+    const bool mapWasLoaded = _mapLoadedFlag;
     mapNodes.clear();
     mapBuildings.clear();
+    setMeshTiles({});
+    _filePath.clear();
     _mapLoadedFlag = false;
 
 
     if(filePath == "Please select an OSM file"){
-        if(_mapLoadedFlag){
+        if(mapWasLoaded){
             qDebug("The 3D View has been cleared!");
         }else{
             qDebug("No OSM File is selected!");
@@ -52,99 +84,128 @@ void OsmParserThread::parseOsmFile(QString filePath)
         return;
     }
 
-    //The QDomDocument class represents an XML document.
-    QDomDocument xml_content;
 // Load xml file as raw data
 #ifdef __unix__
     filePath = QString("/") + filePath;
 #endif
+    _filePath = filePath;
+
+    QElapsedTimer loadTimer;
+    loadTimer.start();
+
+    const QString cacheFileName = meshCacheFileName(filePath, buildingLevelHeight);
+    if(!cacheFileName.isEmpty() && loadMeshCache(cacheFileName)){
+        qDebug() << "OSM mesh loaded from cache in" << loadTimer.elapsed() << "ms";
+        _mapLoadedFlag = true;
+        emit fileParsed(true);
+        return;
+    }
+
+    if(!loadBuildings(filePath)){
+        emit fileParsed(false);
+        return;
+    }
+    const qint64 parseMsecs = loadTimer.elapsed();
+
+    const QList<MeshTile_t> tiles = buildMeshTiles(mapBuildings, buildingLevelHeight);
+    setMeshTiles(tiles);
+    qDebug() << "OSM file parsed in" << parseMsecs << "ms, meshed into" << tiles.size() << "tiles in" << (loadTimer.elapsed() - parseMsecs) << "ms";
+
+    if(!cacheFileName.isEmpty()){
+        saveMeshCache(cacheFileName, tiles);
+    }
+
+    _mapLoadedFlag = true;
+    emit fileParsed(true);
+}
+
+bool OsmParserThread::loadBuildings(const QString& filePath)
+{
+    mapNodes.clear();
+    mapBuildings.clear();
+
     QFile f(filePath);
     if (!f.open(QIODevice::ReadOnly )) {
         // Error while loading file
         qDebug() << "Error while loading OSM file" << filePath;
-        return;
+        return false;
     }
     qDebug("Loading the OSM file!!!");
-    // Set data into the QDomDocument before processing
-    xml_content.setContent(&f);
+
+    // The file is read as a stream so large extracts never have to be held in memory as a document
+    QXmlStreamReader xml(&f);
+    const bool isValid = decodeFile(xml, mapBuildings, mapNodes, coordinateMin, coordinateMax, gpsRefPoint);
     f.close();
 
-    if(decodeFile(xml_content, mapBuildings, mapNodes, coordinateMin, coordinateMax, gpsRefPoint)){
-        _mapLoadedFlag = true;
-        emit fileParsed(true);
-        return;
-    }
+    // Nodes are only needed to resolve the ways
+    mapNodes.clear();
+    mapNodes.squeeze();
 
-    emit fileParsed(false);
+    return isValid;
 }
 
-bool OsmParserThread::decodeFile(QDomDocument &xml_content, QMap<uint64_t, OsmParserThread::BuildingType_t> &buildingMap, QMap<uint64_t, QGeoCoordinate> &nodeMap, QGeoCoordinate &coordinateMin, QGeoCoordinate &coordinateMax, QGeoCoordinate &gpsRef)
+bool OsmParserThread::decodeFile(QXmlStreamReader& xml, QMap<uint64_t, OsmParserThread::BuildingType_t> &buildingMap, QHash<uint64_t, NodeCoordinate_t> &nodeMap, QGeoCoordinate &coordinateMin, QGeoCoordinate &coordinateMax, QGeoCoordinate &gpsRef)
 {
-    QDomElement root = xml_content.documentElement();
-    QDomElement xmlComponent = root.firstChild().toElement();
-    QGeoCoordinate tmpGpsRef;
     bool gpsRefIsSet = false;
-    while(!xmlComponent.isNull()) {
-        if(decodeNodeTags(xmlComponent, nodeMap, coordinateMin, coordinateMax, tmpGpsRef)){
+
+    if(!xml.readNextStartElement()){
+        qDebug() << "OSM file is empty" << xml.errorString();
+        return false;
+    }
+
+    while(xml.readNextStartElement()) {
+        if(xml.name() == QLatin1String("node")){
+            decodeNodeTags(xml, nodeMap);
+        }else if(xml.name() == QLatin1String("bounds")){
+            decodeBounds(xml, coordinateMin, coordinateMax, gpsRef);
             gpsRefIsSet = true;
-            gpsRef = tmpGpsRef;
+        }else if(xml.name() == QLatin1String("way")){
+            decodeBuildings(xml, buildingMap, nodeMap, coordinateMin, coordinateMax, gpsRef);
+        }else if(xml.name() == QLatin1String("relation")){
+            decodeRelations(xml, buildingMap);
+        }else{
+            xml.skipCurrentElement();
         }
-        decodeBuildings(xmlComponent, buildingMap, nodeMap, coordinateMin, coordinateMax, gpsRef);
-        decodeRelations(xmlComponent, buildingMap, nodeMap, gpsRef);
+    }
 
-        xmlComponent = xmlComponent.nextSibling().toElement();
+    if(xml.hasError()){
+        qDebug() << "OSM file parse error at line" << xml.lineNumber() << xml.errorString();
     }
     return gpsRefIsSet;
 }
 
-bool OsmParserThread::decodeNodeTags(QDomElement &xmlComponent, QMap<uint64_t, QGeoCoordinate> &nodeMap, QGeoCoordinate &coordMin, QGeoCoordinate &coordMax, QGeoCoordinate &gpsRef)
+void OsmParserThread::decodeNodeTags(QXmlStreamReader &xml, QHash<uint64_t, NodeCoordinate_t> &nodeMap)
 {
-    int64_t id_tmp=0;
-    QGeoCoordinate gps_tmp;
-    QString attribute;
-    bool gpsRefIsSet = false;
-
-    if (xmlComponent.tagName()=="node") {
+    const QXmlStreamAttributes attributes = xml.attributes();
+    const int64_t id_tmp = attributes.value(QLatin1String("id")).toLongLong();
 
-        attribute = xmlComponent.attribute("id","-1");
-        id_tmp = attribute.toLongLong();
+    if(id_tmp > 0) {
+        nodeMap.insert((uint64_t)id_tmp, { attributes.value(QLatin1String("lat")).toDouble(), attributes.value(QLatin1String("lon")).toDouble() });
+    }
+    xml.skipCurrentElement();
+}
 
-        attribute = xmlComponent.attribute("lat","0");
-        gps_tmp.setLatitude(attribute.toDouble());
+void OsmParserThread::decodeBounds(QXmlStreamReader &xml, QGeoCoordinate &coordMin, QGeoCoordinate &coordMax, QGeoCoordinate &gpsRef)
+{
+    const QXmlStreamAttributes attributes = xml.attributes();
 
-        attribute = xmlComponent.attribute("lon","0");
-        gps_tmp.setLongitude(attribute.toDouble());
+    coordMin.setLatitude(attributes.value(QLatin1String("minlat")).toDouble());
+    coordMin.setLongitude(attributes.value(QLatin1String("minlon")).toDouble());
+    coordMin.setAltitude(0);
+    coordMax.setLatitude(attributes.value(QLatin1String("maxlat")).toDouble());
+    coordMax.setLongitude(attributes.value(QLatin1String("maxlon")).toDouble());
+    coordMax.setAltitude(0);
 
-        gps_tmp.setAltitude(0);
+    gpsRef = QGeoCoordinate(0.5 * (coordMin.latitude() + coordMax.latitude()), 0.5 * (coordMin.longitude() + coordMax.longitude()), 0);
 
-        if(id_tmp > 0) {
-            nodeMap.insert((uint64_t)id_tmp, gps_tmp);
-        }
-    }else if(xmlComponent.tagName() == "bounds") {
-        coordMin.setLatitude(xmlComponent.attribute("minlat","0").toFloat());
-        coordMin.setLongitude(xmlComponent.attribute("minlon","0").toFloat());
-        coordMin.setAltitude(0);
-        coordMax.setLatitude(xmlComponent.attribute("maxlat","0").toFloat());
-        coordMax.setLongitude(xmlComponent.attribute("maxlon","0").toFloat());
-        coordMax.setAltitude(0);
-
-        gpsRefIsSet = true;
-        gps_tmp.setLatitude(0.5 * (coordMin.latitude() + coordMax.latitude()));
-        gps_tmp.setLongitude(0.5 * (coordMin.longitude() + coordMax.longitude()));
-        gps_tmp.setAltitude(0);
-        gpsRef = gps_tmp;
-    }
-    return gpsRefIsSet;
+    xml.skipCurrentElement();
 }
 
-void OsmParserThread::decodeBuildings(QDomElement &xmlComponent, QMap<uint64_t, OsmParserThread::BuildingType_t> &bldMap, QMap<uint64_t, QGeoCoordinate> &nodeMap, QGeoCoordinate &coordMin, QGeoCoordinate &coordMax, QGeoCoordinate gpsRef)
+void OsmParserThread::decodeBuildings(QXmlStreamReader &xml, QMap<uint64_t, OsmParserThread::BuildingType_t> &bldMap, QHash<uint64_t, NodeCoordinate_t> &nodeMap, QGeoCoordinate &coordMin, QGeoCoordinate &coordMax, QGeoCoordinate gpsRef)
 {
-    if (xmlComponent.tagName()!="way"){
-        return;
-    }
-
-    int64_t id_tmp = xmlComponent.attribute("id","0").toLongLong();
+    int64_t id_tmp = xml.attributes().value(QLatin1String("id")).toLongLong();
     if(id_tmp == 0) {
+        xml.skipCurrentElement();
         return;
     }
     OsmParserThread::BuildingType_t bld_tmp;
@@ -160,18 +221,18 @@ void OsmParserThread::decodeBuildings(QDomElement &xmlComponent, QMap<uint64_t,
     bld_lon_min = bld_lat_min = 1e10;
 
     int64_t ref_id;
-    QDomElement Child = xmlComponent.firstChild().toElement();
-    QString attribute;
 
     bld_tmp.height = 0;
     bld_tmp.levels = 0;
 
-    while (!Child.isNull()) {
-        if (Child.tagName()=="nd") {
-            ref_id = Child.attribute("ref","0").toLongLong();
+    while (xml.readNextStartElement()) {
+        const QXmlStreamAttributes attributes = xml.attributes();
+        if (xml.name() == QLatin1String("nd")) {
+            ref_id = attributes.value(QLatin1String("ref")).toLongLong();
 
             if(ref_id > 0) {
-                gps_pt_tmp = nodeMap[ref_id];
+                const auto node = nodeMap.constFind(ref_id);
+                gps_pt_tmp = (node != nodeMap.constEnd()) ? QGeoCoordinate(node->latitude, node->longitude, 0) : QGeoCoordinate();
                 bld_points.push_back(gps_pt_tmp);
                 local_pt_tmp = mapGpsToLocalPoint(gps_pt_tmp, gpsRef);
                 bld_points_local.push_back(QVector2D(local_pt_tmp.x(), local_pt_tmp.y()));
@@ -186,63 +247,53 @@ void OsmParserThread::decodeBuildings(QDomElement &xmlComponent, QMap<uint64_t,
                 bld_lon_min = fmin(bld_lon_min, gps_pt_tmp.longitude());
                 bld_lat_min = fmin(bld_lat_min, gps_pt_tmp.latitude());
             }
-        }else if (Child.tagName()=="tag") {
-            attribute = Child.attribute("k","0");
-            if(attribute == "building:levels") {
-                bld_tmp.levels = Child.attribute("v","0").toFloat();
-            }else if(attribute == "height") {
-                bld_tmp.height = Child.attribute("v","0").toFloat();
-            }else if(attribute == "building" && bld_tmp.levels == 0 && bld_tmp.height == 0){
-                QString attribute_2 = Child.attribute("v","0");
-                if(_singleStoreyBuildings.contains(attribute_2)){
+        }else if (xml.name() == QLatin1String("tag")) {
+            const QStringView attribute = attributes.value(QLatin1String("k"));
+            if(attribute == QLatin1String("building:levels")) {
+                bld_tmp.levels = attributes.value(QLatin1String("v")).toFloat();
+            }else if(attribute == QLatin1String("height")) {
+                bld_tmp.height = attributes.value(QLatin1String("v")).toFloat();
+            }else if(attribute == QLatin1String("building") && bld_tmp.levels == 0 && bld_tmp.height == 0){
+                if(_singleStoreyBuildings.contains(attributes.value(QLatin1String("v")).toString())){
                     bld_tmp.levels = 1;
                 }else{
                     bld_tmp.levels = 2;
                 }
-            }else if(attribute == "leisure" && bld_tmp.levels == 0 && bld_tmp.height == 0){
-                QString attribute_2 = Child.attribute("v","0");
-                if(_doubleStoreyLeisure.contains(attribute_2)){
+            }else if(attribute == QLatin1String("leisure") && bld_tmp.levels == 0 && bld_tmp.height == 0){
+                if(_doubleStoreyLeisure.contains(attributes.value(QLatin1String("v")).toString())){
                     bld_tmp.levels = 2;
                 }
             }
         }
 
-        Child = Child.nextSibling().toElement();
+        xml.skipCurrentElement();
     }
 
     if(bld_points.size() > 2) {
-        //        float bld_height = (bld_tmp.height >= bld_tmp.levels * _buildingLevelHeight)?(bld_tmp.height):(bld_tmp.levels * _buildingLevelHeight);
-        //        bld_tmp.height = bld_height;
         if(bld_tmp.levels > 0 || bld_tmp.height > 0){
             coordMin.setLatitude(fmin(coordMin.latitude(), bld_lat_min));
             coordMin.setLongitude(fmin(coordMin.longitude(), bld_lon_min));
             coordMax.setLatitude(fmax(coordMax.latitude(), bld_lat_max));
             coordMax.setLongitude(fmax(coordMax.longitude(), bld_lon_max));
         }
-        bld_tmp.points_gps = bld_points;
-        bld_tmp.points_local = bld_points_local;
+        bld_tmp.points_gps = std::move(bld_points);
+        bld_tmp.points_local = std::move(bld_points_local);
         bld_tmp.bb_max = QVector2D(bld_x_max, bld_y_max);
         bld_tmp.bb_min = QVector2D(bld_x_min, bld_y_min);
         bldMap.insert(id_tmp, bld_tmp);
     }
 }
 
-void OsmParserThread::decodeRelations(QDomElement &xmlComponent, QMap<uint64_t, OsmParserThread::BuildingType_t> &bldMap, QMap<uint64_t, QGeoCoordinate> &nodeMap, QGeoCoordinate gpsRef)
+void OsmParserThread::decodeRelations(QXmlStreamReader &xml, QMap<uint64_t, OsmParserThread::BuildingType_t> &bldMap)
 {
-    if (xmlComponent.tagName()!="relation"){
-        return;
-    }
-
-    int64_t id_tmp = xmlComponent.attribute("id","0").toLongLong();
+    int64_t id_tmp = xml.attributes().value(QLatin1String("id")).toLongLong();
     if(id_tmp == 0) {
+        xml.skipCurrentElement();
         return;
     }
 
     OsmParserThread::BuildingType_t bld_tmp;
     int64_t ref_id;
-    QDomElement Child = xmlComponent.firstChild().toElement();
-    QString attribute;
-    QString role;
 
     bld_tmp.height = 0;
     bld_tmp.levels = 0;
@@ -250,14 +301,15 @@ void OsmParserThread::decodeRelations(QDomElement &xmlComponent, QMap<uint64_t,
     bool isBuilding = false;
     bool isMultipolygon = false;
 
-    while (!Child.isNull()) {
-        if (Child.tagName()=="member") {
-            ref_id = Child.attribute("ref","0").toLongLong();
-            role = Child.attribute("role","0");
+    while (xml.readNextStartElement()) {
+        const QXmlStreamAttributes attributes = xml.attributes();
+        if (xml.name() == QLatin1String("member")) {
+            ref_id = attributes.value(QLatin1String("ref")).toLongLong();
+            const bool isInner = attributes.value(QLatin1String("role")) == QLatin1String("inner");
             auto bldItem = bldMap.find(ref_id);
             if(bldItem != bldMap.end()) {
-                bld_tmp.append(bldItem.value().points_local, role == "inner");
-                bld_tmp.append(bldItem.value().points_gps, role == "inner");
+                bld_tmp.append(bldItem.value().points_local, isInner);
+                bld_tmp.append(bldItem.value().points_gps, isInner);
                 bld_tmp.levels = fmax(bld_tmp.levels, bldItem.value().levels);
                 bld_tmp.height = fmax(bld_tmp.height, bldItem.value().height);
 
@@ -267,17 +319,17 @@ void OsmParserThread::decodeRelations(QDomElement &xmlComponent, QMap<uint64_t,
                 bld_tmp.bb_min[1] = fmin(bld_tmp.bb_min[1], bldItem.value().bb_min[1]);
                 bldToBeRemoved.push_back(ref_id);
             }
-        }else if (Child.tagName()=="tag") {
-            attribute = Child.attribute("k","0");
-            if(attribute == "type") {
-                if(Child.attribute("v","0") == "multipolygon"){
+        }else if (xml.name() == QLatin1String("tag")) {
+            const QStringView attribute = attributes.value(QLatin1String("k"));
+            if(attribute == QLatin1String("type")) {
+                if(attributes.value(QLatin1String("v")) == QLatin1String("multipolygon")){
                     isMultipolygon = true;
                 }
-            }else if(attribute == "building"){
+            }else if(attribute == QLatin1String("building")){
                 isBuilding = true;
             }
         }
-        Child = Child.nextSibling().toElement();
+        xml.skipCurrentElement();
     }
 
     if(isBuilding){
@@ -293,7 +345,279 @@ void OsmParserThread::decodeRelations(QDomElement &xmlComponent, QMap<uint64_t,
     }
 }
 
-void OsmParserThread::startThreadEvent(QString filePath)
+float OsmParserThread::buildingHeight(const BuildingType_t& building, float buildingLevelHeight)
+{
+    if(building.height > 0){
+        return building.height;
+    }else if(building.levels > 0){
+        return building.levels * buildingLevelHeight;
+    }
+    return 0;
+}
+
+QList<OsmParserThread::MeshTile_t> OsmParserThread::buildMeshTiles(const QMap<uint64_t, BuildingType_t>& buildings, float buildingLevelHeight)
+{
+    // Buildings go to the tile holding the center of their bounding box
+    QHash<quint64, QList<const BuildingType_t*>> tileBuildings;
+    for(const BuildingType_t& building : buildings){
+        if(buildingHeight(building, buildingLevelHeight) <= 0){
+            continue;
+        }
+        const QVector2D center = 0.5f * (building.bb_min + building.bb_max);
+        const qint32 index_x = qFloor(center.x() / meshTileSize);
+        const qint32 index_y = qFloor(center.y() / meshTileSize);
+        tileBuildings[(static_cast<quint64>(static_cast<quint32>(index_x)) << 32) | static_cast<quint32>(index_y)].append(&building);
+    }
+
+    QList<quint64> tileKeys = tileBuildings.keys();
+    std::sort(tileKeys.begin(), tileKeys.end());
+
+    // Each tile is triangulated on its own pool thread into its own buffer
+    const auto& constTileBuildings = tileBuildings;
+    return QtConcurrent::blockingMapped<QList<MeshTile_t>>(tileKeys, [&constTileBuildings, buildingLevelHeight](quint64 tileKey) {
+        return buildMeshTile(tileKey, constTileBuildings.value(tileKey), buildingLevelHeight);
+    });
+}
+
+OsmParserThread::MeshTile_t OsmParserThread::buildMeshTile(quint64 tileKey, const QList<const BuildingType_t*>& buildings, float buildingLevelHeight)
 {
-    parseOsmFile(filePath);
+    typedef struct {
+        const BuildingType_t* building;
+        float height;
+        std::vector<std::array<float, 2>> points;
+        std::vector<uint32_t> indices;
+    } Roof_t;
+
+    MeshTile_t tile;
+    tile.index_x = static_cast<qint32>(tileKey >> 32);
+    tile.index_y = static_cast<qint32>(tileKey & 0xffffffff);
+    tile.bb_min = QVector2D(1e10, 1e10);
+    tile.bb_max = QVector2D(-1e10, -1e10);
+
+    // Triangulate the roofs first so the vertex buffer can be sized once
+    std::vector<Roof_t> roofs;
+    roofs.reserve(buildings.size());
+    qsizetype vertexCount = 0;
+    for(const BuildingType_t* building : buildings){
+        Roof_t roof;
+        roof.building = building;
+        roof.height = buildingHeight(*building, buildingLevelHeight);
+
+        std::vector<std::vector<std::array<float, 2> > > polygon(1);
+        polygon[0].reserve(building->points_local.size());
+        for(const QVector2D& point : building->points_local){
+            polygon[0].push_back({point.x(), point.y()});
+        }
+        if(building->points_local_inner.size() > 0){
+            polygon.emplace_back();
+            polygon[1].reserve(building->points_local_inner.size());
+            for(const QVector2D& point : building->points_local_inner){
+                polygon[1].push_back({point.x(), point.y()});
+            }
+        }
+        roof.indices = mapbox::earcut<uint32_t>(polygon);
+        for(const auto& ring : polygon){
+            roof.points.insert(roof.points.end(), ring.begin(), ring.end());
+        }
+
+        // Roof and floor, then both sides of the outer and inner walls
+        vertexCount += 2 * static_cast<qsizetype>(roof.indices.size());
+        vertexCount += 2 * wallVertexCount(building->points_local);
+        vertexCount += 2 * wallVertexCount(building->points_local_inner);
+
+        tile.bb_min = QVector2D(qMin(tile.bb_min.x(), building->bb_min.x()), qMin(tile.bb_min.y(), building->bb_min.y()));
+        tile.bb_max = QVector2D(qMax(tile.bb_max.x(), building->bb_max.x()), qMax(tile.bb_max.y(), building->bb_max.y()));
+
+        roofs.push_back(std::move(roof));
+    }
+
+    tile.vertexData = QByteArray(vertexCount * 3 * sizeof(float), Qt::Initialization::Uninitialized);
+    float* p = reinterpret_cast<float*>(tile.vertexData.data());
+
+    for(const Roof_t& roof : roofs){
+        const float bld_height = roof.height;
+        const auto& all_bld_points = roof.points;
+
+        for(size_t i_i=0; i_i<roof.indices.size(); i_i+=3) {
+            // mesh for roof
+            for(const uint32_t n_idx : { roof.indices[i_i], roof.indices[i_i+1], roof.indices[i_i+2] }){
+                *p++ = all_bld_points[n_idx][0]; *p++ = all_bld_points[n_idx][1]; *p++ = bld_height;
+            }
+            // mesh for floor
+            for(const uint32_t n_idx : { roof.indices[i_i+2], roof.indices[i_i+1], roof.indices[i_i] }){
+                *p++ = all_bld_points[n_idx][0]; *p++ = all_bld_points[n_idx][1]; *p++ = 0;
+            }
+        }
+
+        p = trianglateWallsExtrudedPolygon(p, roof.building->points_local, bld_height, 0); // mesh for wall outside
+        p = trianglateWallsExtrudedPolygon(p, roof.building->points_local, bld_height, 1); // mesh for wall inside
+        p = trianglateWallsExtrudedPolygon(p, roof.building->points_local_inner, bld_height, 0); // mesh for wall outside
+        p = trianglateWallsExtrudedPolygon(p, roof.building->points_local_inner, bld_height, 1); // mesh for wall inside
+    }
+    Q_ASSERT(p == reinterpret_cast<float*>(tile.vertexData.data()) + (vertexCount * 3));
+
+    return tile;
+}
+
+qsizetype OsmParserThread::wallVertexCount(const std::vector<QVector2D>& verticesCcw)
+{
+    // Two triangles per wall plus the closing wall with inverted normal
+    return verticesCcw.empty() ? 0 : static_cast<qsizetype>(verticesCcw.size() + 1) * 6;
+}
+
+float* OsmParserThread::trianglateWallsExtrudedPolygon(float* vertexData, const std::vector<QVector2D>& verticesCcw, float h, bool inverseOrder)
+{
+    if(verticesCcw.empty()){
+        return vertexData;
+    }
+
+    QVector3D tmp_rec_ccw[4];
+    const size_t vertices_size = verticesCcw.size();
+
+    for(size_t i_p=0; i_p<vertices_size; i_p++) {
+        const size_t i_p_p = (i_p < vertices_size-1)?(i_p+1):(0);
+        const size_t i_a = inverseOrder ? i_p_p : i_p;
+        const size_t i_b = inverseOrder ? i_p : i_p_p;
+        tmp_rec_ccw[0] = QVector3D(verticesCcw[i_a].x(), verticesCcw[i_a].y(), 0);
+        tmp_rec_ccw[1] = QVector3D(verticesCcw[i_b].x(), verticesCcw[i_b].y(), 0);
+        tmp_rec_ccw[2] = QVector3D(verticesCcw[i_b].x(), verticesCcw[i_b].y(), h);
+        tmp_rec_ccw[3] = QVector3D(verticesCcw[i_a].x(), verticesCcw[i_a].y(), h);
+        vertexData = trianglateRectangle(vertexData, tmp_rec_ccw, 0);
+    }
+    return trianglateRectangle(vertexData, tmp_rec_ccw, 1);
+}
+
+float* OsmParserThread::trianglateRectangle(float* vertexData, const QVector3D (&verticesCcw)[4], bool invertNormal)
+{
+    static constexpr int rgIndices[2][6] = {
+        { 0, 1, 3, 1, 2, 3 },
+        { 3, 1, 0, 3, 2, 1 },
+    };
+
+    for(const int idx_tmp : rgIndices[invertNormal ? 1 : 0]) {
+        *vertexData++ = verticesCcw[idx_tmp].x();
+        *vertexData++ = verticesCcw[idx_tmp].y();
+        *vertexData++ = verticesCcw[idx_tmp].z();
+    }
+    return vertexData;
+}
+
+QString OsmParserThread::meshCacheFileName(const QString& filePath, float buildingLevelHeight)
+{
+    const QFileInfo fileInfo(filePath);
+    if(!fileInfo.exists()){
+        return QString();
+    }
+
+    const QString cacheKey = QStringLiteral("%1|%2|%3|%4").arg(fileInfo.absoluteFilePath()).arg(fileInfo.size()).arg(fileInfo.lastModified().toMSecsSinceEpoch()).arg(buildingLevelHeight);
+    const QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1String("/QGCViewer3DMeshCache");
+    return cacheDir + QLatin1Char('/') + QString::fromLatin1(QCryptographicHash::hash(cacheKey.toUtf8(), QCryptographicHash::Sha1).toHex()) + QLatin1String(".mesh");
+}
+
+bool OsmParserThread::loadMeshCache(const QString& cacheFileName)
+{
+    QFile cacheFile(cacheFileName);
+    if(!cacheFile.open(QIODevice::ReadOnly)){
+        return false;
+    }
+
+    QDataStream stream(&cacheFile);
+    stream.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic, version;
+    stream >> magic >> version;
+    if(magic != _meshCacheMagic || version != _meshCacheVersion){
+        return false;
+    }
+
+    double refLat, refLon, minLat, minLon, maxLat, maxLon;
+    qint32 tileCount;
+    stream >> refLat >> refLon >> minLat >> minLon >> maxLat >> maxLon >> tileCount;
+    if(stream.status() != QDataStream::Ok || tileCount < 0){
+        return false;
+    }
+
+    QList<MeshTile_t> tiles;
+    tiles.reserve(tileCount);
+    for(qint32 i=0; i<tileCount; i++){
+        MeshTile_t tile;
+        stream >> tile.index_x >> tile.index_y >> tile.bb_min >> tile.bb_max >> tile.vertexData;
+        if(stream.status() != QDataStream::Ok || (tile.vertexData.size() % (3 * sizeof(float))) != 0){
+            qDebug() << "Discarding corrupt OSM mesh cache" << cacheFileName;
+            cacheFile.close();
+            (void) QFile::remove(cacheFileName);
+            return false;
+        }
+        tiles.append(tile);
+    }
+
+    gpsRefPoint = QGeoCoordinate(refLat, refLon, 0);
+    coordinateMin = QGeoCoordinate(minLat, minLon, 0);
+    coordinateMax = QGeoCoordinate(maxLat, maxLon, 0);
+    setMeshTiles(tiles);
+    return true;
+}
+
+void OsmParserThread::saveMeshCache(const QString& cacheFileName, const QList<MeshTile_t>& meshTiles)
+{
+    QDir cacheDir = QFileInfo(cacheFileName).dir();
+    if(!cacheDir.mkpath(QStringLiteral("."))){
+        return;
+    }
+
+    QSaveFile cacheFile(cacheFileName);
+    if(!cacheFile.open(QIODevice::WriteOnly)){
+        return;
+    }
+
+    QDataStream stream(&cacheFile);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << _meshCacheMagic << _meshCacheVersion;
+    stream << gpsRefPoint.latitude() << gpsRefPoint.longitude();
+    stream << coordinateMin.latitude() << coordinateMin.longitude() << coordinateMax.latitude() << coordinateMax.longitude();
+    stream << static_cast<qint32>(meshTiles.size());
+    for(const MeshTile_t& tile : meshTiles){
+        stream << tile.index_x << tile.index_y << tile.bb_min << tile.bb_max << tile.vertexData;
+    }
+
+    if(stream.status() != QDataStream::Ok || !cacheFile.commit()){
+        qDebug() << "Unable to write OSM mesh cache" << cacheFileName;
+        return;
+    }
+
+    QFileInfoList cacheFiles = cacheDir.entryInfoList({ QStringLiteral("*.mesh") }, QDir::Files, QDir::Time);
+    while(cacheFiles.size() > _maxMeshCacheFiles){
+        (void) QFile::remove(cacheFiles.takeLast().absoluteFilePath());
+    }
+}
+
+void OsmParserThread::startThreadEvent(QString filePath, float buildingLevelHeight)
+{
+    parseOsmFile(filePath, buildingLevelHeight);
+}
+
+void OsmParserThread::rebuildMeshEvent(float buildingLevelHeight)
+{
+    if(!_mapLoadedFlag){
+        return;
+    }
+
+    const QString cacheFileName = meshCacheFileName(_filePath, buildingLevelHeight);
+    if(mapBuildings.isEmpty()){
+        // Map came from the mesh cache, so the buildings have to be read from the file for a new level height
+        if(!cacheFileName.isEmpty() && loadMeshCache(cacheFileName)){
+            emit meshBuilt();
+            return;
+        }
+        if(!loadBuildings(_filePath)){
+            return;
+        }
+    }
+
+    const QList<MeshTile_t> tiles = buildMeshTiles(mapBuildings, buildingLevelHeight);
+    setMeshTiles(tiles);
+    if(!cacheFileName.isEmpty()){
+        saveMeshCache(cacheFileName, tiles);
+    }
+    emit meshBuilt();
 }
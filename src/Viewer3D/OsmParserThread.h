@@ -11,8 +11,10 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QThread>
-#include <QtXml/QDomDocument>
+#include <QtCore/QHash>
 #include <QtCore/QMap>
+#include <QtCore/QMutex>
+#include <QtCore/QXmlStreamReader>
 #include <QtGui/QVector3D>
 #include <QtGui/QVector2D>
 #include <QtPositioning/QGeoCoordinate>
@@ -30,7 +32,6 @@ class OsmParserThread : public QThread
         std::vector<QGeoCoordinate> points_gps_inner;
         std::vector<QVector2D> points_local;
         std::vector<QVector2D> points_local_inner;
-        std::vector<QVector3D> triangulated_mesh;
         QVector2D bb_max = QVector2D(-1e6, -1e6); //bounding boxes
         QVector2D bb_min = QVector2D(1e6, 1e6); //bounding boxes
         float height;
@@ -57,34 +58,80 @@ class OsmParserThread : public QThread
         }
     }BuildingType_t;
 
+    /// Building mesh for one square of the map, so the viewer only needs to upload the squares near the vehicle
+    typedef struct {
+        qint32 index_x;
+        qint32 index_y;
+        QVector2D bb_min;       ///< Bounding box of the buildings in the tile, local coordinates
+        QVector2D bb_max;
+        QByteArray vertexData;  ///< Triangles as x, y, z floats
+    } MeshTile_t;
+
+    typedef struct {
+        double latitude;
+        double longitude;
+    } NodeCoordinate_t;
+
     Q_OBJECT
 public:
     explicit OsmParserThread(QObject *parent = nullptr);
 
     QGeoCoordinate gpsRefPoint;
-    QMap<uint64_t, QGeoCoordinate> mapNodes;
+    QHash<uint64_t, NodeCoordinate_t> mapNodes;
     QMap<uint64_t, BuildingType_t> mapBuildings;
     QGeoCoordinate coordinateMin, coordinateMax;
 
-    void start(QString filePath);
+    void start(QString filePath, float buildingLevelHeight);
+
+    /// Builds the meshes again from the loaded buildings for a new level height. Signals meshBuilt when done.
+    void rebuildMesh(float buildingLevelHeight);
+
+    /// Thread safe copy of the current tiles
+    QList<MeshTile_t> meshTiles();
+
+    static constexpr float meshTileSize = 500; ///< Tile edge in meters
 
 private:
     QThread* _mainThread;
-    bool _mapLoadedFlag;
+    bool _mapLoadedFlag = false;
+    QString _filePath;
     QList<QString> _singleStoreyBuildings;
     QList<QString> _doubleStoreyLeisure;
-
-    void parseOsmFile(QString filePath);
-    bool decodeFile(QDomDocument& xml_content, QMap<uint64_t, BuildingType_t > &buildingMap, QMap<uint64_t, QGeoCoordinate> &nodeMap, QGeoCoordinate& coordinateMin, QGeoCoordinate& coordinateMax, QGeoCoordinate& gpsRef);
-    bool decodeNodeTags(QDomElement& xmlComponent, QMap<uint64_t, QGeoCoordinate> &nodeMap, QGeoCoordinate& coordMin, QGeoCoordinate& coordMax, QGeoCoordinate& gpsRef);
-    void decodeBuildings(QDomElement& xmlComponent, QMap<uint64_t, BuildingType_t > &bldMap, QMap<uint64_t, QGeoCoordinate> &nodeMap, QGeoCoordinate& coordMin, QGeoCoordinate& coordMax, QGeoCoordinate gpsRef);
-    void decodeRelations(QDomElement& xmlComponent, QMap<uint64_t, BuildingType_t > &bldMap, QMap<uint64_t, QGeoCoordinate> &nodeMap, QGeoCoordinate gpsRef);
-
+    QMutex _meshTilesMutex;
+    QList<MeshTile_t> _meshTiles;
+
+    void parseOsmFile(QString filePath, float buildingLevelHeight);
+    bool loadBuildings(const QString& filePath);
+    bool decodeFile(QXmlStreamReader& xml, QMap<uint64_t, BuildingType_t > &buildingMap, QHash<uint64_t, NodeCoordinate_t> &nodeMap, QGeoCoordinate& coordinateMin, QGeoCoordinate& coordinateMax, QGeoCoordinate& gpsRef);
+    void decodeNodeTags(QXmlStreamReader& xml, QHash<uint64_t, NodeCoordinate_t> &nodeMap);
+    void decodeBounds(QXmlStreamReader& xml, QGeoCoordinate& coordMin, QGeoCoordinate& coordMax, QGeoCoordinate& gpsRef);
+    void decodeBuildings(QXmlStreamReader& xml, QMap<uint64_t, BuildingType_t > &bldMap, QHash<uint64_t, NodeCoordinate_t> &nodeMap, QGeoCoordinate& coordMin, QGeoCoordinate& coordMax, QGeoCoordinate gpsRef);
+    void decodeRelations(QXmlStreamReader& xml, QMap<uint64_t, BuildingType_t > &bldMap);
+
+    void setMeshTiles(const QList<MeshTile_t>& meshTiles);
+    static QList<MeshTile_t> buildMeshTiles(const QMap<uint64_t, BuildingType_t>& buildings, float buildingLevelHeight);
+    static MeshTile_t buildMeshTile(quint64 tileKey, const QList<const BuildingType_t*>& buildings, float buildingLevelHeight);
+    static float buildingHeight(const BuildingType_t& building, float buildingLevelHeight);
+    static qsizetype wallVertexCount(const std::vector<QVector2D>& verticesCcw);
+    static float* trianglateWallsExtrudedPolygon(float* vertexData, const std::vector<QVector2D>& verticesCcw, float h, bool inverseOrder);
+    static float* trianglateRectangle(float* vertexData, const QVector3D (&verticesCcw)[4], bool invertNormal);
+
+    // Mesh cache, so opening the same map again doesn't need to parse it
+    static QString meshCacheFileName(const QString& filePath, float buildingLevelHeight);
+    bool loadMeshCache(const QString& cacheFileName);
+    void saveMeshCache(const QString& cacheFileName, const QList<MeshTile_t>& meshTiles);
+
+    static constexpr quint32 _meshCacheMagic = 0x4d534d43; // "CMSM"
+    static constexpr quint32 _meshCacheVersion = 1;
+    static constexpr int _maxMeshCacheFiles = 5;
 
 signals:
     void fileParsed(bool isValid);
-    void startThread(QString filePath);
+    void meshBuilt();
+    void startThread(QString filePath, float buildingLevelHeight);
+    void startRebuildMesh(float buildingLevelHeight);
 
 private slots:
-    void startThreadEvent(QString filePath);
+    void startThreadEvent(QString filePath, float buildingLevelHeight);
+    void rebuildMeshEvent(float buildingLevelHeight);
 };
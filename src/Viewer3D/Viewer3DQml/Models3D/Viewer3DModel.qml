@@ -156,6 +156,8 @@ View3D {
                 geometry: Viewer3DTerrainGeometry {
                     id: terrainGeometryManager
                     refCoordinate: _gpsRef
+                    cameraPosition: pointModel.mapPositionFromScene(standAloneScene.cameraOne.scenePosition)
+                    elevationEnabled: QGroundControl.settingsManager.viewer3DSettings.terrainElevation.rawValue
                 }
 
                 materials: CustomMaterial {
@@ -11,6 +11,14 @@
 #include "Viewer3DUtils.h"
 #include "SettingsManager.h"
 #include "Viewer3DSettings.h"
+#include "MultiVehicleManager.h"
+#include "Vehicle.h"
+#include "TerrainQuery.h"
+
+#include <QtConcurrent/QtConcurrentMap>
+
+#include <algorithm>
+#include <array>
 
 #include "math.h"
 
@@ -24,38 +32,287 @@ Viewer3DTerrainGeometry::Viewer3DTerrainGeometry()
     setSectorCount(0);
     setStackCount(0);
     setRadius(EarthRadius);
+
+    _updateTimer.setSingleShot(true);
+    _updateTimer.setInterval(_updateDelayMSecs);
+    connect(&_updateTimer, &QTimer::timeout, this, &Viewer3DTerrainGeometry::updateNodes);
+    connect(&_buildWatcher, &QFutureWatcher<TerrainNodeMesh_t>::finished, this, &Viewer3DTerrainGeometry::nodeMeshesBuilt);
+
     connect(_viewer3DSettings->osmFilePath(), &Fact::rawValueChanged, this, &Viewer3DTerrainGeometry::clearScene);
     connect(this, &Viewer3DTerrainGeometry::refCoordinateChanged, this, &Viewer3DTerrainGeometry::updateEarthData);
+
+    activeVehicleChanged(MultiVehicleManager::instance()->activeVehicle());
+    connect(MultiVehicleManager::instance(), &MultiVehicleManager::activeVehicleChanged, this, &Viewer3DTerrainGeometry::activeVehicleChanged);
+}
+
+Viewer3DTerrainGeometry::~Viewer3DTerrainGeometry()
+{
+    _buildWatcher.waitForFinished();
 }
 
 void Viewer3DTerrainGeometry::updateEarthData()
 {
-    clear();
-    int stride = 3 * sizeof(float);
-    stride += 3 * sizeof(float); // for normals
-    stride += 2 * sizeof(float); // for UV
+    // Roi or reference changed, none of the built nodes are valid anymore
+    _meshGeneration++;
+    _nodeMeshes.clear();
+    _nodeHeights.clear();
+    _pendingHeights.clear();
+    _selectedNodes.clear();
+
+    if(_sectorCount == 0 || _stackCount == 0 || !_roiMin.isValid() || !_roiMax.isValid()){
+        clear();
+        return;
+    }
+
+    // Vehicle position is relative to the reference
+    if(_activeVehicle){
+        activeVehicleCoordinateChanged(_activeVehicle->coordinate());
+    }
+    updateNodes();
+}
+
+quint64 Viewer3DTerrainGeometry::nodeKey(const TerrainNode_t& node) const
+{
+    return (static_cast<quint64>(node.level) << 48) | (static_cast<quint64>(node.x) << 24) | static_cast<quint64>(node.y);
+}
+
+void Viewer3DTerrainGeometry::nodeBounds(const TerrainNode_t& node, QGeoCoordinate& northWest, QGeoCoordinate& southEast) const
+{
+    const double north = fmax(_roiMin.latitude(), _roiMax.latitude());
+    const double south = fmin(_roiMin.latitude(), _roiMax.latitude());
+    const double west = fmin(_roiMin.longitude(), _roiMax.longitude());
+    const double east = fmax(_roiMin.longitude(), _roiMax.longitude());
+    const double nodeCount = 1 << node.level;
+    const double latStep = (north - south) / nodeCount;
+    const double lonStep = (east - west) / nodeCount;
+
+    northWest = QGeoCoordinate(north - node.y * latStep, west + node.x * lonStep, 0);
+    southEast = QGeoCoordinate(north - (node.y + 1) * latStep, west + (node.x + 1) * lonStep, 0);
+}
+
+float Viewer3DTerrainGeometry::nodeError(const TerrainNode_t& node, const QList<QVector3D>& focusPoints) const
+{
+    QGeoCoordinate northWest, southEast;
+    nodeBounds(node, northWest, southEast);
+    const QVector3D cornerNw = mapGpsToLocalPoint(northWest, _refCoordinate);
+    const QVector3D cornerSe = mapGpsToLocalPoint(southEast, _refCoordinate);
+    const QVector2D bbMin(fmin(cornerNw.x(), cornerSe.x()), fmin(cornerNw.y(), cornerSe.y()));
+    const QVector2D bbMax(fmax(cornerNw.x(), cornerSe.x()), fmax(cornerNw.y(), cornerSe.y()));
+    const float nodeSize = fmax(bbMax.x() - bbMin.x(), bbMax.y() - bbMin.y());
+
+    float distance = 1e10;
+    for(const QVector3D& focus : focusPoints){
+        const float dx = fmax(fmax(bbMin.x() - focus.x(), focus.x() - bbMax.x()), 0);
+        const float dy = fmax(fmax(bbMin.y() - focus.y(), focus.y() - bbMax.y()), 0);
+        distance = fmin(distance, sqrtf(dx * dx + dy * dy + focus.z() * focus.z()));
+    }
+
+    return lodFactor * nodeSize / fmax(distance, 1.0f);
+}
+
+QList<Viewer3DTerrainGeometry::TerrainNode_t> Viewer3DTerrainGeometry::selectNodes() const
+{
+    QList<QVector3D> focusPoints = { _cameraPosition };
+    if(_vehiclePositionValid){
+        focusPoints.append(QVector3D(_vehiclePosition.x(), _vehiclePosition.y(), 0));
+    }
+
+    // Nodes with the largest error are split first, so when the budget runs out the detail went where it is needed most
+    typedef std::pair<float, TerrainNode_t> WeightedNode_t;
+    const auto lessError = [](const WeightedNode_t& a, const WeightedNode_t& b) { return a.first < b.first; };
+    const int nodeTriangles = nodeVertexCount(nodeResolution) / 3;
+
+    std::vector<WeightedNode_t> candidates;
+    const TerrainNode_t root = { 0, 0, 0 };
+    candidates.push_back({ nodeError(root, focusPoints), root });
+    int triangleCount = nodeTriangles;
+
+    QList<TerrainNode_t> nodes;
+    while(!candidates.empty()){
+        std::pop_heap(candidates.begin(), candidates.end(), lessError);
+        const WeightedNode_t candidate = candidates.back();
+        candidates.pop_back();
+
+        const TerrainNode_t& node = candidate.second;
+        if(candidate.first <= 1 || node.level >= maxNodeLevel || (triangleCount + 3 * nodeTriangles) > _triangleBudget){
+            nodes.append(node);
+            continue;
+        }
+
+        triangleCount += 3 * nodeTriangles;
+        for(int i=0; i<4; i++){
+            const TerrainNode_t child = { node.level + 1, 2 * node.x + (i & 1), 2 * node.y + (i >> 1) };
+            candidates.push_back({ nodeError(child, focusPoints), child });
+            std::push_heap(candidates.begin(), candidates.end(), lessError);
+        }
+    }
+    return nodes;
+}
 
-    if(buildTerrain_2(roiMin(), roiMax(), refCoordinate(), 1) == 0){
+void Viewer3DTerrainGeometry::scheduleUpdate()
+{
+    if(!_updateTimer.isActive()){
+        _updateTimer.start();
+    }
+}
+
+void Viewer3DTerrainGeometry::updateNodes()
+{
+    if(_sectorCount == 0 || _stackCount == 0 || !_roiMin.isValid() || !_roiMax.isValid()){
+        return;
+    }
+    if(_buildWatcher.isRunning()){
+        _updatePending = true;
         return;
     }
 
-    QByteArray vertexData;
-    vertexData.resize(_vertices.size() * stride);
-    float *p = reinterpret_cast<float *>(vertexData.data());
+    const double north = fmax(_roiMin.latitude(), _roiMax.latitude());
+    const double south = fmin(_roiMin.latitude(), _roiMax.latitude());
+    const double west = fmin(_roiMin.longitude(), _roiMax.longitude());
+    const double east = fmax(_roiMin.longitude(), _roiMax.longitude());
+    const QVector2D sRange(textureS(west), textureS(east));
+    const QVector2D tRange(textureT(north, north), textureT(south, north));
+
+    QList<quint64> selectedNodes;
+    QList<TerrainNodeJob_t> jobs;
+    for(const TerrainNode_t& node : selectNodes()){
+        const quint64 key = nodeKey(node);
+        selectedNodes.append(key);
+
+        if(_elevationEnabled && !_nodeHeights.contains(key)){
+            requestNodeHeights(node);
+        }
+        if(_nodeMeshes.contains(key)){
+            continue;
+        }
+
+        TerrainNodeJob_t job;
+        job.key = key;
+        nodeBounds(node, job.northWest, job.southEast);
+        job.refCoordinate = _refCoordinate;
+        job.resolution = nodeResolution;
+        job.skirtDepth = fmax(0.05 * job.northWest.distanceTo(QGeoCoordinate(job.northWest.latitude(), job.southEast.longitude(), 0)), 5.0);
+        job.heights = _nodeHeights.value(key);
+        job.sRange = sRange;
+        job.tRange = tRange;
+        jobs.append(job);
+    }
+    std::sort(selectedNodes.begin(), selectedNodes.end());
+
+    if(selectedNodes == _selectedNodes && jobs.isEmpty()){
+        return;
+    }
+    _selectedNodes = selectedNodes;
 
-    for (uint i = 0; i < _vertices.size(); ++i) {
-        *p++ = _vertices[i].x();
-        *p++ = _vertices[i].y();
-        *p++ = _vertices[i].z();
+    if(jobs.isEmpty()){
+        uploadNodes();
+        return;
+    }
 
-        *p++ = _normals[i].x();
-        *p++ = _normals[i].y();
-        *p++ = _normals[i].z();
+    _buildGeneration = _meshGeneration;
+    _buildWatcher.setFuture(QtConcurrent::mapped(jobs, &Viewer3DTerrainGeometry::buildNodeMesh));
+}
 
-        *p++ = _texCoords[i].x();
-        *p++ = _texCoords[i].y();
+void Viewer3DTerrainGeometry::requestNodeHeights(const TerrainNode_t& node)
+{
+    const quint64 key = nodeKey(node);
+    if(_pendingHeights.contains(key)){
+        return;
     }
 
+    QGeoCoordinate northWest, southEast;
+    nodeBounds(node, northWest, southEast);
+    const double latStep = (northWest.latitude() - southEast.latitude()) / nodeResolution;
+    const double lonStep = (southEast.longitude() - northWest.longitude()) / nodeResolution;
+
+    // The reference goes first so the heights can be made relative to it
+    QList<QGeoCoordinate> coordinates;
+    coordinates.reserve((nodeResolution + 1) * (nodeResolution + 1) + 1);
+    coordinates.append(_refCoordinate);
+    for(int i = 0; i <= nodeResolution; ++i){
+        for(int j = 0; j <= nodeResolution; ++j){
+            coordinates.append(QGeoCoordinate(northWest.latitude() - i * latStep, northWest.longitude() + j * lonStep));
+        }
+    }
+
+    const int generation = _meshGeneration;
+    const qsizetype coordinateCount = coordinates.size();
+    TerrainAtCoordinateQuery* const query = new TerrainAtCoordinateQuery(true /* autoDelete */);
+    (void) connect(query, &TerrainAtCoordinateQuery::terrainDataReceived, this, [this, key, generation, coordinateCount](bool success, const QList<double>& heights) {
+        if(generation != _meshGeneration){
+            return;
+        }
+        _pendingHeights.remove(key);
+
+        // A failed node stays flat rather than being requested over and over
+        QList<double> relativeHeights;
+        if(success && heights.size() == coordinateCount){
+            relativeHeights.reserve(heights.size() - 1);
+            for(qsizetype i = 1; i < heights.size(); i++){
+                relativeHeights.append(heights[i] - heights[0]);
+            }
+        }
+        _nodeHeights.insert(key, relativeHeights);
+
+        if(!relativeHeights.isEmpty()){
+            _nodeMeshes.remove(key);
+            scheduleUpdate();
+        }
+    });
+    _pendingHeights.insert(key);
+    query->requestData(coordinates);
+}
+
+void Viewer3DTerrainGeometry::nodeMeshesBuilt()
+{
+    if(_buildGeneration == _meshGeneration){
+        const QList<TerrainNodeMesh_t> meshes = _buildWatcher.future().results();
+        for(const TerrainNodeMesh_t& mesh : meshes){
+            _nodeMeshes.insert(mesh.key, mesh.vertexData);
+        }
+        uploadNodes();
+
+        // Keep some of the unselected nodes around so moving back and forth doesn't rebuild them, but not without bound
+        if(_nodeMeshes.size() > 4 * _selectedNodes.size()){
+            for(auto it = _nodeMeshes.begin(); it != _nodeMeshes.end(); ){
+                if(std::binary_search(_selectedNodes.cbegin(), _selectedNodes.cend(), it.key())){
+                    ++it;
+                }else{
+                    it = _nodeMeshes.erase(it);
+                }
+            }
+        }
+    }
+
+    if(_updatePending){
+        _updatePending = false;
+        updateNodes();
+    }
+}
+
+void Viewer3DTerrainGeometry::uploadNodes()
+{
+    qsizetype vertexDataSize = 0;
+    for(const quint64 key : _selectedNodes){
+        vertexDataSize += _nodeMeshes.value(key).size();
+    }
+
+    QByteArray vertexData;
+    vertexData.reserve(vertexDataSize);
+    for(const quint64 key : _selectedNodes){
+        vertexData.append(_nodeMeshes.value(key));
+    }
+
+    clear();
+    if(vertexData.isEmpty()){
+        update();
+        return;
+    }
+
+    int stride = 3 * sizeof(float);
+    stride += 3 * sizeof(float); // for normals
+    stride += 2 * sizeof(float); // for UV
+
     setVertexData(vertexData);
     setStride(stride);
 
@@ -73,6 +330,118 @@ void Viewer3DTerrainGeometry::updateEarthData()
     update();
 }
 
+qsizetype Viewer3DTerrainGeometry::nodeVertexCount(int resolution)
+{
+    // Two triangles per quad, plus two per edge segment for the skirts on the four edges
+    return 6 * static_cast<qsizetype>(resolution) * (resolution + 4);
+}
+
+float Viewer3DTerrainGeometry::textureS(double longitude)
+{
+    return (longitude + 180.0f) / 360.0f;
+}
+
+float Viewer3DTerrainGeometry::textureT(double latitude, double northLatitude)
+{
+    if(fabs(latitude) < MaxLatitude){
+        double sinLatitude = sin(latitude * DEG_TO_RAD);
+        return 0.5 - log((1 + sinLatitude) / (1 - sinLatitude)) / (4 * PI);
+    }
+    return (northLatitude - latitude) / 180;
+}
+
+Viewer3DTerrainGeometry::TerrainNodeMesh_t Viewer3DTerrainGeometry::buildNodeMesh(const TerrainNodeJob_t& job)
+{
+    // tmp vertex definition (position, texture coords)
+    struct Vertex{
+        QVector3D position;
+        QVector2D texCoord;
+    };
+
+    const int resolution = job.resolution;
+    const int rowSize = resolution + 1;
+    const double latStep = (job.northWest.latitude() - job.southEast.latitude()) / resolution;
+    const double lonStep = (job.southEast.longitude() - job.northWest.longitude()) / resolution;
+    const float scaleS = job.sRange.y() - job.sRange.x();
+    const float scaleT = job.tRange.y() - job.tRange.x();
+    const bool hasHeights = job.heights.size() == rowSize * rowSize;
+
+    std::vector<Vertex> grid(rowSize * rowSize);
+    for(int i = 0; i <= resolution; ++i){
+        const double latitude = job.northWest.latitude() - i * latStep;
+        for(int j = 0; j <= resolution; ++j){
+            const double longitude = job.northWest.longitude() + j * lonStep;
+            const QVector3D localPoint = mapGpsToLocalPoint(QGeoCoordinate(latitude, longitude, 0), job.refCoordinate);
+
+            Vertex& vertex = grid[i * rowSize + j];
+            vertex.position = QVector3D(localPoint.x(), localPoint.y(), hasHeights ? job.heights[i * rowSize + j] : 0);
+            vertex.texCoord = QVector2D((textureS(longitude) - job.sRange.x()) / scaleS,
+                                        (textureT(latitude, job.northWest.latitude()) - job.tRange.x()) / scaleT);
+        }
+    }
+
+    TerrainNodeMesh_t mesh;
+    mesh.key = job.key;
+    mesh.vertexData = QByteArray(nodeVertexCount(resolution) * 8 * sizeof(float), Qt::Initialization::Uninitialized);
+    float *p = reinterpret_cast<float *>(mesh.vertexData.data());
+
+    const auto addTriangle = [&p](const Vertex& v1, const Vertex& v2, const Vertex& v3) {
+        const QVector3D normal = computeFaceNormal(v1.position, v2.position, v3.position);
+        for(const Vertex* vertex : { &v1, &v2, &v3 }){
+            *p++ = vertex->position.x();
+            *p++ = vertex->position.y();
+            *p++ = vertex->position.z();
+
+            *p++ = normal.x();
+            *p++ = normal.y();
+            *p++ = normal.z();
+
+            *p++ = vertex->texCoord.x();
+            *p++ = vertex->texCoord.y();
+        }
+    };
+
+    for(int i = 0; i < resolution; ++i){
+        for(int j = 0; j < resolution; ++j){
+            // get 4 vertices per quad
+            //  v1--v3
+            //  |    |
+            //  v2--v4
+            const Vertex& v1 = grid[i * rowSize + j];
+            const Vertex& v2 = grid[(i + 1) * rowSize + j];
+            const Vertex& v3 = grid[i * rowSize + j + 1];
+            const Vertex& v4 = grid[(i + 1) * rowSize + j + 1];
+
+            addTriangle(v1, v2, v3);
+            addTriangle(v3, v2, v4);
+        }
+    }
+
+    // Skirts hang down from the edges so the gaps between nodes of different levels aren't visible. Each edge is walked
+    // with the outside on its left so the skirt faces outwards: north west to east, east north to south and so on.
+    const std::array<std::pair<int, int>, 4> edgeStarts = {{ { 0, 0 }, { 0, resolution }, { resolution, resolution }, { resolution, 0 } }};
+    const std::array<std::pair<int, int>, 4> edgeSteps = {{ { 0, 1 }, { 1, 0 }, { 0, -1 }, { -1, 0 } }};
+    for(size_t edge = 0; edge < edgeStarts.size(); edge++){
+        for(int k = 0; k < resolution; ++k){
+            const int i_a = edgeStarts[edge].first + k * edgeSteps[edge].first;
+            const int j_a = edgeStarts[edge].second + k * edgeSteps[edge].second;
+            const Vertex& a = grid[i_a * rowSize + j_a];
+            const Vertex& b = grid[(i_a + edgeSteps[edge].first) * rowSize + j_a + edgeSteps[edge].second];
+
+            Vertex aLow = a;
+            Vertex bLow = b;
+            aLow.position.setZ(a.position.z() - job.skirtDepth);
+            bLow.position.setZ(b.position.z() - job.skirtDepth);
+
+            addTriangle(a, b, aLow);
+            addTriangle(b, bLow, aLow);
+        }
+    }
+    Q_ASSERT(p == reinterpret_cast<float *>(mesh.vertexData.data()) + nodeVertexCount(resolution) * 8);
+
+    return mesh;
+}
+
 QVector3D Viewer3DTerrainGeometry::computeFaceNormal(QVector3D x1, QVector3D x2, QVector3D x3)
 {
     const float EPSILON = 0.000001f;
@@ -107,83 +476,81 @@ QVector3D Viewer3DTerrainGeometry::computeFaceNormal(QVector3D x1, QVector3D x2,
     return normal;
 }
 
-void Viewer3DTerrainGeometry::changeUpAxis(int from, int to)
+void Viewer3DTerrainGeometry::clearScene()
 {
-    // initial transform matrix cols
-    float tx[] = {1.0f, 0.0f, 0.0f};    // x-axis (left)
-    float ty[] = {0.0f, 1.0f, 0.0f};    // y-axis (up)
-    float tz[] = {0.0f, 0.0f, 1.0f};    // z-axis (forward)
-
-    float sign_to = (to >= 0)?(1):(-1);
+    clear();
+    setSectorCount(0);
+    setStackCount(0);
+    _meshGeneration++;
+    _updateTimer.stop();
+    _nodeMeshes.clear();
+    _nodeHeights.clear();
+    _pendingHeights.clear();
+    _selectedNodes.clear();
+    update();
+}
 
-    // X -> Y
-    if(from == 1 && to == 2)
-    {
-        tx[0] =  0.0f * sign_to; tx[1] =  1.0f * sign_to;
-        ty[0] = -1.0f * sign_to; ty[1] =  0.0f * sign_to;
-    }
-    // X -> Z
-    else if(from == 1 && to == 3)
-    {
-        tx[0] =  0.0f * sign_to; tx[2] =  1.0f * sign_to;
-        tz[0] = -1.0f * sign_to; tz[2] =  0.0f * sign_to;
-    }
-    // Y -> X
-    else if(from == 2 && to == 1)
-    {
-        tx[0] =  0.0f * sign_to; tx[1] = -1.0f * sign_to;
-        ty[0] =  1.0f * sign_to; ty[1] =  0.0f * sign_to;
-    }
-    // Y -> Z
-    else if(from == 2 && to == 3)
-    {
-        ty[1] =  0.0f * sign_to; ty[2] =  1.0f * sign_to;
-        tz[1] = -1.0f * sign_to; tz[2] =  0.0f * sign_to;
+void Viewer3DTerrainGeometry::activeVehicleChanged(Vehicle *vehicle)
+{
+    if(_activeVehicle){
+        disconnect(_activeVehicle, &Vehicle::coordinateChanged, this, &Viewer3DTerrainGeometry::activeVehicleCoordinateChanged);
     }
-    //  Z -> X
-    else if(from == 3 && to == 1)
-    {
-        tx[0] =  0.0f * sign_to; tx[2] = -1.0f * sign_to;
-        tz[0] =  1.0f * sign_to; tz[2] =  0.0f * sign_to;
+
+    _activeVehicle = vehicle;
+    _vehiclePositionValid = false;
+    if(_activeVehicle){
+        connect(_activeVehicle, &Vehicle::coordinateChanged, this, &Viewer3DTerrainGeometry::activeVehicleCoordinateChanged);
+        activeVehicleCoordinateChanged(_activeVehicle->coordinate());
+    }else{
+        scheduleUpdate();
     }
-    // Z -> Y
-    else
-    {
-        ty[1] =  0.0f * sign_to; ty[2] = -1.0f * sign_to;
-        tz[1] =  1.0f * sign_to; tz[2] =  0.0f * sign_to;
+}
+
+void Viewer3DTerrainGeometry::activeVehicleCoordinateChanged(QGeoCoordinate newCoordinate)
+{
+    if(!newCoordinate.isValid() || !(newCoordinate.latitude() && newCoordinate.longitude())){
+        return;
     }
 
-    float vx, vy, vz;
-    float nx, ny, nz;
-    for(std::size_t i = 0; i < _vertices.size(); i++)
-    {
-        // transform vertices
-        vx = _vertices[i].x();
-        vy = _vertices[i].y();
-        vz = _vertices[i].z();
-        _vertices[i] = QVector3D(tx[0] * vx + ty[0] * vy + tz[0] * vz,
-                                 tx[1] * vx + ty[1] * vy + tz[1] * vz,
-                                 tx[2] * vx + ty[2] * vy + tz[2] * vz);
+    const QVector3D localPoint = mapGpsToLocalPoint(newCoordinate, _refCoordinate);
+    _vehiclePosition = QVector2D(localPoint.x(), localPoint.y());
+    _vehiclePositionValid = true;
+    scheduleUpdate();
+}
 
-        // transform normals
-        nx = _normals[i].x();
-        ny = _normals[i].y();
-        nz = _normals[i].z();
-        _normals[i]   = QVector3D(tx[0] * nx + ty[0] * ny + tz[0] * nz,
-                                tx[1] * nx + ty[1] * ny + tz[1] * nz,
-                                tx[2] * nx + ty[2] * ny + tz[2] * nz);
+void Viewer3DTerrainGeometry::setCameraPosition(const QVector3D &newCameraPosition)
+{
+    if (_cameraPosition == newCameraPosition){
+        return;
     }
+    _cameraPosition = newCameraPosition;
+    emit cameraPositionChanged();
+    scheduleUpdate();
 }
 
-void Viewer3DTerrainGeometry::clearScene()
+void Viewer3DTerrainGeometry::setTriangleBudget(int newTriangleBudget)
 {
-    clear();
-    setSectorCount(0);
-    setStackCount(0);
-    _vertices.clear();
-    _normals.clear();
-    _texCoords.clear();
-    update();
+    if (_triangleBudget == newTriangleBudget){
+        return;
+    }
+    _triangleBudget = newTriangleBudget;
+    emit triangleBudgetChanged();
+    scheduleUpdate();
+}
+
+void Viewer3DTerrainGeometry::setElevationEnabled(bool newElevationEnabled)
+{
+    if (_elevationEnabled == newElevationEnabled){
+        return;
+    }
+    _elevationEnabled = newElevationEnabled;
+    emit elevationEnabledChanged();
+
+    _meshGeneration++;
+    _nodeMeshes.clear();
+    _nodeHeights.clear();
+    _pendingHeights.clear();
+    scheduleUpdate();
 }
 
 int Viewer3DTerrainGeometry::sectorCount() const
@@ -212,292 +579,6 @@ void Viewer3DTerrainGeometry::setStackCount(int newStackCount)
     emit stackCountChanged();
 }
 
-void Viewer3DTerrainGeometry::buildTerrain(QGeoCoordinate roiMinCoordinate, QGeoCoordinate roiMaxCoordinate, QGeoCoordinate refCoordinate, bool scale)
-{
-    float sectorLength = abs(roiMaxCoordinate.longitude() - roiMinCoordinate.longitude());
-    float stackLength = abs(roiMaxCoordinate.latitude() - roiMinCoordinate.latitude());
-    float stackRef = roiMaxCoordinate.latitude();
-    float sectorRef = roiMinCoordinate.longitude();
-
-
-    // tmp vertex definition (x,y,z,s,t)
-    struct Vertex{
-        float x, y, z, s, t;
-    };
-    std::vector<Vertex> tmpVertices;
-
-    float minT = 10;
-    float maxT = -10;
-    float minS = 10;
-    float maxS = -10;
-
-    // There si a bug now that the resolution of each polygon changes
-    // by thge portion. It hsould be fixed I think
-    float sectorStep =   sectorLength / _sectorCount;
-    float stackStep = stackLength / _stackCount;
-    float sectorAngle, stackAngle;
-
-    QVector3D refLocalPosition;
-    float refXY = _radius * cosf(refCoordinate.latitude() * DEG_TO_RAD);
-    refLocalPosition.setX(refXY * cosf(refCoordinate.longitude() * DEG_TO_RAD));
-    refLocalPosition.setY(refXY * sinf(refCoordinate.longitude() * DEG_TO_RAD));
-    refLocalPosition.setZ(_radius * sinf(refCoordinate.latitude() * DEG_TO_RAD));
-
-    // compute all vertices first, each vertex contains (x,y,z,s,t) except normal
-    for(int i = 0; i <= _stackCount; ++i){
-        stackAngle = stackRef - i * stackStep;        // starting from 90 to -90
-        float xy = _radius * cosf(stackAngle * DEG_TO_RAD);       // r * cos(u)
-        // float z = _radius * sinf(stackAngle * DEG_TO_RAD);        // r * sin(u)
-
-        // add (sectorCount+1) vertices per stack
-        // the first and last vertices have same position and normal, but different tex coords
-        for(int j = 0; j <= _sectorCount; ++j){
-            sectorAngle = sectorRef + j * sectorStep;           // starting from -180 to 180
-
-            Vertex vertex;
-            vertex.x = xy * cosf(sectorAngle * DEG_TO_RAD) - refLocalPosition.x();      // x = r * cos(u) * cos(v)
-            vertex.y = xy * sinf(sectorAngle * DEG_TO_RAD) - refLocalPosition.y();      // y = r * cos(u) * sin(v)
-            // vertex.z = z - refLocalPosition.z();                           // z = r * sin(u)
-            vertex.z = 0;                           // z = r * sin(u)
-
-            qDebug() << vertex.x << vertex.y << vertex.z;
-            vertex.s = (sectorAngle + 180.0f) / 360.0f;
-            minS = fmin(minS, vertex.s);
-            maxS = fmax(maxS, vertex.s);
-            if(abs(stackAngle) < MaxLatitude){
-                double sinLatitude = sin(stackAngle * DEG_TO_RAD);
-                vertex.t = 0.5 - log((1 + sinLatitude) / (1 - sinLatitude)) / (4 * PI);
-
-            }else{
-                vertex.t = (stackRef - stackAngle) / 180;
-            }
-            minT = fmin(minT, vertex.t);
-            maxT = fmax(maxT, vertex.t);
-
-            tmpVertices.push_back(vertex);
-        }
-    }
-
-    float scaleT = maxT - minT;
-    float scaleS = maxS - minS;
-    _vertices.clear();
-    _texCoords.clear();
-    _normals.clear();
-    Vertex v1, v2, v3, v4;                          // 4 vertex positions and tex coords
-    int i, j, vi1, vi2;
-    QVector3D _n;
-    for(i = 0; i < _stackCount; ++i){
-        vi1 = i * (_sectorCount + 1);                // index of tmpVertices
-        vi2 = (i + 1) * (_sectorCount + 1);
-        stackAngle = stackRef - i * stackStep;
-        for(j = 0; j < _sectorCount; ++j, ++vi1, ++vi2){
-            // get 4 vertices per sector
-            //  v1--v3
-            //  |    |
-            //  v2--v4
-
-            v1 = tmpVertices[vi1];
-            v2 = tmpVertices[vi2];
-            v3 = tmpVertices[vi1 + 1];
-            v4 = tmpVertices[vi2 + 1];
-
-            if(scale){
-                v1.s = (v1.s - minS) / scaleS;
-                v1.t = (v1.t - minT) / scaleT;
-                v2.s = (v2.s - minS) / scaleS;
-                v2.t = (v2.t - minT) / scaleT;
-                v3.s = (v3.s - minS) / scaleS;
-                v3.t = (v3.t - minT) / scaleT;
-                v4.s = (v4.s - minS) / scaleS;
-                v4.t = (v4.t - minT) / scaleT;
-            }
-
-            // 2 triangles per sector excluding 1st and last stacks
-            if(stackAngle < 90){
-                _vertices.push_back(QVector3D(v1.x, v1.y, v1.z));
-                _vertices.push_back(QVector3D(v2.x, v2.y, v2.z));
-                _vertices.push_back(QVector3D(v3.x, v3.y, v3.z));
-
-                _texCoords.push_back(QVector2D(v1.s, v1.t));
-                _texCoords.push_back(QVector2D(v2.s, v2.t));
-                _texCoords.push_back(QVector2D(v3.s, v3.t));
-
-                _n = computeFaceNormal(QVector3D(v1.x,v1.y,v1.z),
-                                       QVector3D(v2.x,v2.y,v2.z),
-                                       QVector3D(v3.x,v3.y,v3.z));
-
-                for(int k = 0; k < 3; ++k)  // same normals for 3 vertices
-                {
-                    _normals.push_back(_n);
-                }
-            }
-
-            if(stackAngle > -90){
-                _vertices.push_back(QVector3D(v3.x, v3.y, v3.z));
-                _vertices.push_back(QVector3D(v2.x, v2.y, v2.z));
-                _vertices.push_back(QVector3D(v4.x, v4.y, v4.z));
-
-                _texCoords.push_back(QVector2D(v3.s, v3.t));
-                _texCoords.push_back(QVector2D(v2.s, v2.t));
-                _texCoords.push_back(QVector2D(v4.s, v4.t));
-
-                _n = computeFaceNormal(QVector3D(v3.x,v3.y,v3.z),
-                                       QVector3D(v2.x,v2.y,v2.z),
-                                       QVector3D(v4.x,v4.y,v4.z));
-
-                for(int k = 0; k < 3; ++k)  // same normals for 3 vertices
-                {
-                    _normals.push_back(_n);
-                }
-            }
-        }
-    }
-
-    changeUpAxis(3, 2);
-}
-
-bool Viewer3DTerrainGeometry::buildTerrain_2(QGeoCoordinate roiMinCoordinate, QGeoCoordinate roiMaxCoordinate, QGeoCoordinate refCoordinate, bool scale)
-{
-    if(_sectorCount == 0 || _stackCount == 0){
-        return false;
-    }
-
-    float sectorLength = abs(roiMaxCoordinate.longitude() - roiMinCoordinate.longitude());
-    float stackLength = abs(roiMaxCoordinate.latitude() - roiMinCoordinate.latitude());
-    float stackRef = roiMaxCoordinate.latitude();
-    float sectorRef = roiMinCoordinate.longitude();
-
-
-    // tmp vertex definition (x,y,z,s,t)
-    struct Vertex{
-        float x, y, z, s, t;
-    };
-    std::vector<Vertex> tmpVertices;
-
-    float minT = 10;
-    float maxT = -10;
-    float minS = 10;
-    float maxS = -10;
-
-    // There si a bug now that the resolution of each polygon changes
-    // by thge portion. It hsould be fixed I think
-    float sectorStep =   sectorLength / _sectorCount;
-    float stackStep = stackLength / _stackCount;
-    float sectorAngle, stackAngle;
-
-    QVector3D refLocalPosition;
-    QVector3D localPoint;
-    float refXY = _radius * cosf(refCoordinate.latitude() * DEG_TO_RAD);
-    refLocalPosition.setX(refXY * cosf(refCoordinate.longitude() * DEG_TO_RAD));
-    refLocalPosition.setY(refXY * sinf(refCoordinate.longitude() * DEG_TO_RAD));
-    refLocalPosition.setZ(_radius * sinf(refCoordinate.latitude() * DEG_TO_RAD));
-
-    for(int i = 0; i <= _stackCount; ++i){
-        stackAngle = stackRef - i * stackStep;        // starting from 90 to -90
-
-        for(int j = 0; j <= _sectorCount; ++j){
-            sectorAngle = sectorRef + j * sectorStep;           // starting from -180 to 180
-
-            Vertex vertex;
-            localPoint = mapGpsToLocalPoint(QGeoCoordinate(stackAngle, sectorAngle, 0), refCoordinate);
-            vertex.x = localPoint.x();
-            vertex.y = localPoint.y();
-            vertex.z = 0;
-
-            vertex.s = (sectorAngle + 180.0f) / 360.0f;
-            minS = fmin(minS, vertex.s);
-            maxS = fmax(maxS, vertex.s);
-            if(abs(stackAngle) < MaxLatitude){
-                double sinLatitude = sin(stackAngle * DEG_TO_RAD);
-                vertex.t = 0.5 - log((1 + sinLatitude) / (1 - sinLatitude)) / (4 * PI);
-
-            }else{
-                vertex.t = (stackRef - stackAngle) / 180;
-            }
-            minT = fmin(minT, vertex.t);
-            maxT = fmax(maxT, vertex.t);
-
-            tmpVertices.push_back(vertex);
-        }
-    }
-
-    float scaleT = maxT - minT;
-    float scaleS = maxS - minS;
-    _vertices.clear();
-    _texCoords.clear();
-    _normals.clear();
-    Vertex v1, v2, v3, v4;                          // 4 vertex positions and texture coords
-    int i, j, vi1, vi2;
-    QVector3D _n;
-    for(i = 0; i < _stackCount; ++i){
-        vi1 = i * (_sectorCount + 1);                // index of tmpVertices
-        vi2 = (i + 1) * (_sectorCount + 1);
-        stackAngle = stackRef - i * stackStep;
-        for(j = 0; j < _sectorCount; ++j, ++vi1, ++vi2){
-            // get 4 vertices per sector
-            //  v1--v3
-            //  |    |
-            //  v2--v4
-
-            v1 = tmpVertices[vi1];
-            v2 = tmpVertices[vi2];
-            v3 = tmpVertices[vi1 + 1];
-            v4 = tmpVertices[vi2 + 1];
-
-            if(scale){
-                v1.s = (v1.s - minS) / scaleS;
-                v1.t = (v1.t - minT) / scaleT;
-                v2.s = (v2.s - minS) / scaleS;
-                v2.t = (v2.t - minT) / scaleT;
-                v3.s = (v3.s - minS) / scaleS;
-                v3.t = (v3.t - minT) / scaleT;
-                v4.s = (v4.s - minS) / scaleS;
-                v4.t = (v4.t - minT) / scaleT;
-            }
-
-            // 2 triangles per sector excluding 1st and last stacks
-            if(stackAngle < 90){
-                _vertices.push_back(QVector3D(v1.x, v1.y, v1.z));
-                _vertices.push_back(QVector3D(v2.x, v2.y, v2.z));
-                _vertices.push_back(QVector3D(v3.x, v3.y, v3.z));
-
-                _texCoords.push_back(QVector2D(v1.s, v1.t));
-                _texCoords.push_back(QVector2D(v2.s, v2.t));
-                _texCoords.push_back(QVector2D(v3.s, v3.t));
-
-                _n = computeFaceNormal(QVector3D(v1.x,v1.y,v1.z),
-                                       QVector3D(v2.x,v2.y,v2.z),
-                                       QVector3D(v3.x,v3.y,v3.z));
-
-                for(int k = 0; k < 3; ++k)  // same normals for 3 vertices
-                {
-                    _normals.push_back(_n);
-                }
-            }
-
-            if(stackAngle > -90){
-                _vertices.push_back(QVector3D(v3.x, v3.y, v3.z));
-                _vertices.push_back(QVector3D(v2.x, v2.y, v2.z));
-                _vertices.push_back(QVector3D(v4.x, v4.y, v4.z));
-
-                _texCoords.push_back(QVector2D(v3.s, v3.t));
-                _texCoords.push_back(QVector2D(v2.s, v2.t));
-                _texCoords.push_back(QVector2D(v4.s, v4.t));
-
-                _n = computeFaceNormal(QVector3D(v3.x,v3.y,v3.z),
-                                       QVector3D(v2.x,v2.y,v2.z),
-                                       QVector3D(v4.x,v4.y,v4.z));
-
-                for(int k = 0; k < 3; ++k)  // same normals for 3 vertices
-                {
-                    _normals.push_back(_n);
-                }
-            }
-        }
-    }
-    return true;
-}
-
 int Viewer3DTerrainGeometry::radius() const
 {
     return _radius;
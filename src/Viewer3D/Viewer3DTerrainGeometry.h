@@ -13,9 +13,14 @@
 #include <QtPositioning/QGeoCoordinate>
 #include <QtGui/QVector3D>
 #include <QtGui/QVector2D>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QTimer>
 #include <QtQmlIntegration/QtQmlIntegration>
 
 class Viewer3DSettings;
+class Vehicle;
 
 ///     @author Omid Esrafilian <esrafilian.omid@gmail.com>
 
@@ -30,9 +35,40 @@ class Viewer3DTerrainGeometry : public QQuick3DGeometry
     Q_PROPERTY(QGeoCoordinate roiMin READ roiMin WRITE setRoiMin NOTIFY roiMinChanged)
     Q_PROPERTY(QGeoCoordinate roiMax READ roiMax WRITE setRoiMax NOTIFY roiMaxChanged)
     Q_PROPERTY(QGeoCoordinate refCoordinate READ refCoordinate WRITE setRefCoordinate NOTIFY refCoordinateChanged)
+    Q_PROPERTY(QVector3D cameraPosition READ cameraPosition WRITE setCameraPosition NOTIFY cameraPositionChanged)
+    Q_PROPERTY(int triangleBudget READ triangleBudget WRITE setTriangleBudget NOTIFY triangleBudgetChanged)
+    Q_PROPERTY(bool elevationEnabled READ elevationEnabled WRITE setElevationEnabled NOTIFY elevationEnabledChanged)
+
+    friend class Viewer3DTerrainGeometryTest;
 
 public:
+    /// Quadtree node of the terrain. Level 0 is the whole roi, each level halves the node along latitude and longitude.
+    typedef struct {
+        int level;
+        int x;      ///< Column from the west edge of the roi
+        int y;      ///< Row from the north edge of the roi
+    } TerrainNode_t;
+
+    /// Everything a worker thread needs to build the mesh of one node
+    typedef struct {
+        quint64 key;
+        QGeoCoordinate northWest;
+        QGeoCoordinate southEast;
+        QGeoCoordinate refCoordinate;
+        int resolution;             ///< Quads along each edge of the node
+        float skirtDepth;           ///< Meters the edge skirts reach down, hides cracks between neighbours of different levels
+        QList<double> heights;      ///< (resolution+1)^2 heights relative to the reference, row major from north west. Empty for flat.
+        QVector2D sRange;           ///< Texture s at the west and east edges of the roi
+        QVector2D tRange;           ///< Texture t at the north and south edges of the roi
+    } TerrainNodeJob_t;
+
+    typedef struct {
+        quint64 key;
+        QByteArray vertexData;
+    } TerrainNodeMesh_t;
+
     explicit Viewer3DTerrainGeometry();
+    ~Viewer3DTerrainGeometry();
 
     Q_INVOKABLE void updateEarthData();
 
@@ -55,27 +91,71 @@ class Viewer3DTerrainGeometry : public QQuick3DGeometry
     QGeoCoordinate refCoordinate() const;
     void setRefCoordinate(const QGeoCoordinate &newRefCoordinate);
 
+    /// Camera position in the local coordinates of the geometry, the terrain is refined around it
+    QVector3D cameraPosition() const { return _cameraPosition; }
+    void setCameraPosition(const QVector3D &newCameraPosition);
+
+    /// Upper bound for the triangles of the selected nodes
+    int triangleBudget() const { return _triangleBudget; }
+    void setTriangleBudget(int newTriangleBudget);
+
+    /// Displaces the terrain by the elevation from the terrain tile cache, relative to the reference coordinate
+    bool elevationEnabled() const { return _elevationEnabled; }
+    void setElevationEnabled(bool newElevationEnabled);
+
+    static TerrainNodeMesh_t buildNodeMesh(const TerrainNodeJob_t& job);
+    static qsizetype nodeVertexCount(int resolution);
+
+    static constexpr int nodeResolution = 16;   ///< Quads along each edge of a node
+    static constexpr int maxNodeLevel = 10;
+    static constexpr float lodFactor = 1.5f;    ///< A node is split while the focus is closer than lodFactor times its size
+
 private:
 
     int _sectorCount;
     int _stackCount;
-    std::vector<QVector3D> _vertices;
-    std::vector<QVector2D> _texCoords;
-    std::vector<QVector3D> _normals;
-
-    void buildTerrain(QGeoCoordinate roiMinCoordinate, QGeoCoordinate roiMaxCoordinate, QGeoCoordinate refCoordinate, bool scale);
-    bool buildTerrain_2(QGeoCoordinate roiMinCoordinate, QGeoCoordinate roiMaxCoordinate, QGeoCoordinate refCoordinate, bool scale);
 
-    QVector3D computeFaceNormal(QVector3D x1, QVector3D x2, QVector3D x3);
-    void changeUpAxis(int from, int to);
+    static QVector3D computeFaceNormal(QVector3D x1, QVector3D x2, QVector3D x3);
+    static float textureS(double longitude);
+    static float textureT(double latitude, double northLatitude);
     void clearScene();
 
+    quint64 nodeKey(const TerrainNode_t& node) const;
+    void nodeBounds(const TerrainNode_t& node, QGeoCoordinate& northWest, QGeoCoordinate& southEast) const;
+    float nodeError(const TerrainNode_t& node, const QList<QVector3D>& focusPoints) const;
+    QList<TerrainNode_t> selectNodes() const;
+    void scheduleUpdate();
+    void updateNodes();
+    void requestNodeHeights(const TerrainNode_t& node);
+    void nodeMeshesBuilt();
+    void uploadNodes();
+    void activeVehicleChanged(Vehicle* vehicle);
+    void activeVehicleCoordinateChanged(QGeoCoordinate newCoordinate);
+
     int _radius;
     QGeoCoordinate _roiMin;
     QGeoCoordinate _roiMax;
     QGeoCoordinate _refCoordinate;
     Viewer3DSettings* _viewer3DSettings = nullptr;
 
+    QVector3D _cameraPosition;
+    int _triangleBudget = 300000;
+    bool _elevationEnabled = false;
+    Vehicle* _activeVehicle = nullptr;
+    bool _vehiclePositionValid = false;
+    QVector2D _vehiclePosition;
+
+    QList<quint64> _selectedNodes;                      ///< Keys of the nodes making up the current mesh
+    QHash<quint64, QByteArray> _nodeMeshes;             ///< Built meshes, kept while the roi doesn't change
+    QHash<quint64, QList<double>> _nodeHeights;         ///< Elevations received for a node
+    QSet<quint64> _pendingHeights;                      ///< Nodes waiting for elevation data
+    QFutureWatcher<TerrainNodeMesh_t> _buildWatcher;
+    bool _updatePending = false;                        ///< Selection changed while a build was running
+    int _meshGeneration = 0;                            ///< Bumped when the roi changes, results of older builds are dropped
+    int _buildGeneration = 0;
+    QTimer _updateTimer;                                ///< Collapses focus changes into one reselection
+    static constexpr int _updateDelayMSecs = 250;
+
 
 signals:
 
@@ -85,4 +165,7 @@ class Viewer3DTerrainGeometry : public QQuick3DGeometry
     void roiMinChanged();
     void roiMaxChanged();
     void refCoordinateChanged();
+    void cameraPositionChanged();
+    void triangleBudgetChanged();
+    void elevationEnabledChanged();
 };
@@ -44,3 +44,32 @@ void ExifParserTest::_writeTest()
     // QVERIFY(outputFile.open(QIODevice::WriteOnly | QIODevice::Truncate));
     // QCOMPARE(outputFile.write(imageBuffer), imageBuffer.size());
 }
+
+void ExifParserTest::_readHeaderTest()
+{
+    QFile file(":/unittest/DSCN0010.jpg");
+    QVERIFY(file.open(QIODevice::ReadOnly));
+
+    QByteArray header = ExifParser::readHeader(file);
+    QVERIFY(!header.isEmpty());
+    QVERIFY(header.size() < file.size());
+
+    QVERIFY(file.seek(0));
+    QByteArray imageBuffer = file.readAll();
+    file.close();
+    QVERIFY(imageBuffer.startsWith(header));
+
+    // The header alone is enough to read the time
+    QCOMPARE(ExifParser::readTime(header), ExifParser::readTime(imageBuffer));
+
+    // Tagging just the header and appending the untouched remainder gives the same image as tagging the whole file
+    struct GeoTagWorker::CameraFeedbackPacket data;
+    data.latitude = 37.225;
+    data.longitude = -80.425;
+    data.altitude = 618.4392;
+
+    const QByteArray remainder = imageBuffer.mid(header.size());
+    QVERIFY(ExifParser::write(header, data));
+    QVERIFY(ExifParser::write(imageBuffer, data));
+    QCOMPARE(header + remainder, imageBuffer);
+}
@@ -12,4 +12,5 @@ class ExifParserTest : public UnitTest
 private slots:
 	void _readTimeTest();
 	void _writeTest();
+	void _readHeaderTest();
 };
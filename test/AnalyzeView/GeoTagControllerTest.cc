@@ -94,5 +94,17 @@ void GeoTagControllerTest::_geoTagWorkerTest()
     worker->setImageDirectory(imageDirPath + "/");
     worker->setSaveDirectory(worker->imageDirectory() + "/TAGGED");
 
+    QSignalSpy spyImagesPerSecond(worker, &GeoTagWorker::imagesPerSecondChanged);
+
     QVERIFY(worker->process());
+
+    QVERIFY(spyImagesPerSecond.count() > 0);
+
+    const QStringList taggedImages = QDir(worker->saveDirectory()).entryList(QDir::Files);
+    QVERIFY(!taggedImages.isEmpty());
+    for (const QString &fileName : taggedImages) {
+        const QFileInfo taggedInfo(worker->saveDirectory() + "/" + fileName);
+        const QFileInfo originalInfo(imageDirPath + "/" + fileName);
+        QVERIFY(taggedInfo.size() > originalInfo.size());
+    }
 }
@@ -0,0 +1,293 @@
+#include "LogColumnStoreTest.h"
+#include "LogColumnStore.h"
+#include "MAVLinkLib.h"
+#include "ULogBuilder.h"
+
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QTest>
+
+#include <cmath>
+
+namespace {
+    constexpr int kVibrationSamples = 300000;  // 5 minutes at 1kHz
+    constexpr int kThrottleSamples = 3000;     // 5 minutes at 10Hz
+    constexpr qint64 kStartUsecs = 1000000;
+
+    float vibration(int sample)
+    {
+        return (static_cast<float>((sample * 37) % 1000) / 100.f) - 5.f;
+    }
+
+    float throttle(int sample)
+    {
+        return (static_cast<float>(sample % 10) / 10.f) + 0.05f;
+    }
+
+    bool nearlyEqual(double a, double b)
+    {
+        return std::abs(a - b) <= (1e-9 * qMax(1., std::abs(b)));
+    }
+
+    bool writeFile(const QString &fileName, const QByteArray &bytes)
+    {
+        QFile file(fileName);
+        return file.open(QIODevice::WriteOnly) && (file.write(bytes) == bytes.size());
+    }
+
+    QByteArray vibrationLog()
+    {
+        ULogBuilder builder;
+        builder.format("vib:uint64_t timestamp;float[3] accel;uint8_t[4] _padding0;");
+        builder.format("battery:uint64_t timestamp;float voltage;uint8_t[4] _padding0;");
+        builder.format("throttle:uint64_t timestamp;float throttle;uint8_t[4] _padding0;");
+        builder.addLogged(0, 0, "vib");
+        builder.addLogged(1, 1, "vib");
+        builder.addLogged(0, 2, "battery");
+        builder.addLogged(0, 3, "throttle");
+
+        for (int i = 0; i < kVibrationSamples; i++) {
+            QByteArray sample;
+            ULogBuilder::put<uint64_t>(sample, kStartUsecs + (i * 1000ULL));
+            ULogBuilder::put<float>(sample, vibration(i));
+            ULogBuilder::put<float>(sample, ((i % 1000) == 0) ? NAN : 1.f);
+            ULogBuilder::put<float>(sample, -vibration(i));
+            builder.data(0, sample);
+
+            if ((i % 100) == 0) {
+                const int j = i / 100;
+
+                QByteArray other;
+                ULogBuilder::put<uint64_t>(other, kStartUsecs + (i * 1000ULL));
+                for (int axis = 0; axis < 3; axis++) {
+                    ULogBuilder::put<float>(other, 0.f);
+                }
+                builder.data(1, other);
+
+                QByteArray throttleSample;
+                ULogBuilder::put<uint64_t>(throttleSample, kStartUsecs + (j * 100000ULL));
+                ULogBuilder::put<float>(throttleSample, throttle(j));
+                builder.data(3, throttleSample);
+
+                QByteArray battery;
+                ULogBuilder::put<uint64_t>(battery, kStartUsecs + (j * 100000ULL) + 5000);
+                ULogBuilder::put<float>(battery, 16.8f - (2.f * throttle(j)));
+                builder.data(2, battery);
+            }
+        }
+
+        return builder.log;
+    }
+
+    void appendTlogMessage(QByteArray &tlog, quint64 usecs, const mavlink_message_t &message)
+    {
+        const quint64 timestamp = qToBigEndian(usecs);
+        (void) tlog.append(reinterpret_cast<const char*>(&timestamp), sizeof(timestamp));
+
+        uint8_t buffer[MAVLINK_MAX_PACKET_LEN];
+        const uint16_t length = mavlink_msg_to_send_buffer(buffer, &message);
+        (void) tlog.append(reinterpret_cast<const char*>(buffer), length);
+    }
+}
+
+void LogColumnStoreTest::_ulogQueriesTest()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString logFile = tempDir.filePath(QStringLiteral("vibration.ulg"));
+    QVERIFY(writeFile(logFile, vibrationLog()));
+
+    QString errorMessage;
+    const QString cacheDirectory = LogColumnStore::cacheDirectory(logFile, tempDir.filePath(QStringLiteral("cache")));
+    QVERIFY2(LogColumnStore::build(logFile, cacheDirectory, errorMessage), qPrintable(errorMessage));
+
+    LogColumnStore store;
+    QVERIFY2(store.open(cacheDirectory, errorMessage), qPrintable(errorMessage));
+    QCOMPARE(store.topics(), QStringList({ "battery", "throttle", "vib", "vib#1" }));
+    QCOMPARE(store.fields(QStringLiteral("vib")), QStringList({ "accel[0]", "accel[1]", "accel[2]" }));
+    QCOMPARE(store.rows(QStringLiteral("vib")), qint64(kVibrationSamples));
+    QCOMPARE(store.rows(QStringLiteral("vib#1")), qint64(kThrottleSamples));
+    QVERIFY(nearlyEqual(store.duration(), (kVibrationSamples - 1) / 1000.));
+
+    // Range, both ends inclusive
+    const QList<QPointF> range = store.range(QStringLiteral("vib"), QStringLiteral("accel[0]"), 10., 11.);
+    QCOMPARE(range.size(), qsizetype(1001));
+    for (int i = 0; i < range.size(); i++) {
+        QVERIFY(nearlyEqual(range[i].x(), 10. + (i / 1000.)));
+        QCOMPARE(range[i].y(), static_cast<double>(vibration(10000 + i)));
+    }
+
+    // Reduced range keeps the extremes of each slice, in time order
+    const QList<QPointF> reduced = store.range(QStringLiteral("vib"), QStringLiteral("accel[0]"), 0., store.duration(), 100);
+    QVERIFY(!reduced.isEmpty());
+    QVERIFY(reduced.size() <= 100);
+    double previousX = -1.;
+    double reducedMin = 0.;
+    double reducedMax = 0.;
+    for (const QPointF &point : reduced) {
+        QVERIFY(point.x() > previousX);
+        previousX = point.x();
+        reducedMin = qMin(reducedMin, point.y());
+        reducedMax = qMax(reducedMax, point.y());
+    }
+    QCOMPARE(reducedMin, static_cast<double>(vibration(0)));
+    QCOMPARE(reducedMax, static_cast<double>(vibration(999 * 27)));
+
+    // Vibration RMS per minute against a brute force scan
+    const QList<QPointF> rms = store.resample(QStringLiteral("vib"), QStringLiteral("accel[2]"), 0., store.duration(), 60., LogColumnStore::AggregateRms);
+
+    QCOMPARE(rms.size(), qsizetype(5));
+    for (int minute = 0; minute < rms.size(); minute++) {
+        double sumSquares = 0.;
+        for (int i = minute * 60000; i < ((minute + 1) * 60000); i++) {
+            const double value = -vibration(i);
+            sumSquares += value * value;
+        }
+        QCOMPARE(rms[minute].x(), minute * 60.);
+        QVERIFY(nearlyEqual(rms[minute].y(), std::sqrt(sumSquares / 60000)));
+    }
+
+    // Intervals which do not line up with the blocks
+    const QList<QPointF> means = store.resample(QStringLiteral("vib"), QStringLiteral("accel[0]"), 1.5, 20., 0.7, LogColumnStore::AggregateMean);
+    QCOMPARE(means.size(), qsizetype(27));
+    for (int bucket = 0; bucket < means.size(); bucket++) {
+        const int first = 1500 + (bucket * 700);
+        const int last = qMin(first + 700, 20001);
+        double sum = 0.;
+        for (int i = first; i < last; i++) {
+            sum += vibration(i);
+        }
+        QVERIFY(nearlyEqual(means[bucket].y(), sum / (last - first)));
+    }
+
+    double sum = 0.;
+    for (int i = 30000; i <= 90500; i++) {
+        sum += vibration(i);
+    }
+    QVERIFY(nearlyEqual(store.aggregate(QStringLiteral("vib"), QStringLiteral("accel[0]"), 30., 90.5, LogColumnStore::AggregateMean), sum / 60501));
+
+    // NaN samples are left out
+    QCOMPARE(store.aggregate(QStringLiteral("vib"), QStringLiteral("accel[1]"), 0., store.duration(), LogColumnStore::AggregateCount), double(kVibrationSamples - (kVibrationSamples / 1000)));
+    QVERIFY(std::isnan(store.aggregate(QStringLiteral("vib"), QStringLiteral("accel[0]"), 1000., 2000., LogColumnStore::AggregateMean)));
+
+    // Battery sag per throttle bin
+    const QList<QPointF> sag = store.binned(QStringLiteral("throttle"), QStringLiteral("throttle"), QStringLiteral("battery"), QStringLiteral("voltage"), 0.1, LogColumnStore::AggregateMean);
+    const QList<QPointF> counts = store.binned(QStringLiteral("throttle"), QStringLiteral("throttle"), QStringLiteral("battery"), QStringLiteral("voltage"), 0.1, LogColumnStore::AggregateCount);
+    QCOMPARE(sag.size(), qsizetype(10));
+    QCOMPARE(counts.size(), qsizetype(10));
+    for (int bin = 0; bin < sag.size(); bin++) {
+        QVERIFY(std::abs(sag[bin].x() - ((bin + 0.5) * 0.1)) < 1e-9);
+        QVERIFY(std::abs(sag[bin].y() - (16.8 - (2. * ((bin / 10.) + 0.05)))) < 1e-4);
+        QCOMPARE(counts[bin].y(), double(kThrottleSamples / 10));
+    }
+
+    QVERIFY(store.range(QStringLiteral("vib"), QStringLiteral("unknown"), 0., 10.).isEmpty());
+    QVERIFY(store.range(QStringLiteral("unknown"), QStringLiteral("accel[0]"), 0., 10.).isEmpty());
+}
+
+void LogColumnStoreTest::_tlogTest()
+{
+    QByteArray tlog;
+    const quint64 startUsecs = 1700000000000000ULL;
+    mavlink_message_t message;
+
+    // A ground station heartbeat comes first, the vehicle is the first autopilot
+    (void) mavlink_msg_heartbeat_pack(255, MAV_COMP_ID_MISSIONPLANNER, &message, MAV_TYPE_GCS, MAV_AUTOPILOT_INVALID, 0, 0, 0);
+    appendTlogMessage(tlog, startUsecs, message);
+    (void) mavlink_msg_heartbeat_pack(1, MAV_COMP_ID_AUTOPILOT1, &message, MAV_TYPE_QUADROTOR, MAV_AUTOPILOT_PX4, 0, 0, MAV_STATE_ACTIVE);
+    appendTlogMessage(tlog, startUsecs + 10, message);
+
+    static constexpr int kAttitudeSamples = 500;
+    for (int i = 0; i < kAttitudeSamples; i++) {
+        const quint64 usecs = startUsecs + 1000 + (i * 20000ULL);
+        (void) mavlink_msg_attitude_pack(1, MAV_COMP_ID_AUTOPILOT1, &message, i * 20, i * 0.001f, 0.f, -i * 0.002f, 0.f, 0.f, 0.f);
+        appendTlogMessage(tlog, usecs, message);
+        (void) mavlink_msg_attitude_pack(2, MAV_COMP_ID_AUTOPILOT1, &message, i * 20, 1.f, 0.f, 0.f, 0.f, 0.f, 0.f);
+        appendTlogMessage(tlog, usecs + 1, message);
+
+        if (i == 100) {
+            // Corrupt stretch, including a stray start of frame byte
+            (void) tlog.append(QByteArray("\x00\x11\xFD\x22\x33\x44", 6));
+        }
+    }
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString logFile = tempDir.filePath(QStringLiteral("flight.tlog"));
+    QVERIFY(writeFile(logFile, tlog));
+
+    QString errorMessage;
+    const QString cacheDirectory = tempDir.filePath(QStringLiteral("cache"));
+    QVERIFY2(LogColumnStore::build(logFile, cacheDirectory, errorMessage), qPrintable(errorMessage));
+
+    LogColumnStore store;
+    QVERIFY2(store.open(cacheDirectory, errorMessage), qPrintable(errorMessage));
+    const QStringList topics = store.topics();
+    QVERIFY(topics.contains(QStringLiteral("ATTITUDE")));
+    QVERIFY(topics.contains(QStringLiteral("ATTITUDE#2:1")));
+    QVERIFY(topics.contains(QStringLiteral("HEARTBEAT")));
+    QVERIFY(topics.contains(QStringLiteral("HEARTBEAT#255:%1").arg(MAV_COMP_ID_MISSIONPLANNER)));
+    QVERIFY(store.fields(QStringLiteral("ATTITUDE")).contains(QStringLiteral("roll")));
+    QCOMPARE(store.rows(QStringLiteral("ATTITUDE")), qint64(kAttitudeSamples));
+    QCOMPARE(store.rows(QStringLiteral("ATTITUDE#2:1")), qint64(kAttitudeSamples));
+
+    const QList<QPointF> roll = store.range(QStringLiteral("ATTITUDE"), QStringLiteral("roll"), 0., store.duration());
+    QCOMPARE(roll.size(), qsizetype(kAttitudeSamples));
+    for (int i = 0; i < roll.size(); i++) {
+        QVERIFY(nearlyEqual(roll[i].x(), (1000 + (i * 20000)) / 1e6));
+        QCOMPARE(roll[i].y(), static_cast<double>(i * 0.001f));
+    }
+
+    // Zero values trimmed from MAVLink 2 payloads read back as zero
+    QCOMPARE(store.aggregate(QStringLiteral("ATTITUDE"), QStringLiteral("yawspeed"), 0., store.duration(), LogColumnStore::AggregateMax), 0.);
+    QCOMPARE(store.aggregate(QStringLiteral("ATTITUDE"), QStringLiteral("time_boot_ms"), 0., store.duration(), LogColumnStore::AggregateMax), double((kAttitudeSamples - 1) * 20));
+
+    // Not a tlog
+    const QString textFile = tempDir.filePath(QStringLiteral("notes.txt"));
+    QVERIFY(writeFile(textFile, QByteArray("Not a telemetry log")));
+    QVERIFY(!LogColumnStore::build(textFile, tempDir.filePath(QStringLiteral("textcache")), errorMessage));
+    QVERIFY(!errorMessage.isEmpty());
+}
+
+void LogColumnStoreTest::_cacheTest()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString cacheRoot = tempDir.filePath(QStringLiteral("cache"));
+    const QString logFile = tempDir.filePath(QStringLiteral("small.ulg"));
+
+    ULogBuilder builder;
+    builder.format("battery:uint64_t timestamp;float voltage;uint8_t[4] _padding0;");
+    builder.addLogged(0, 0, "battery");
+    for (int i = 0; i < 10; i++) {
+        QByteArray sample;
+        ULogBuilder::put<uint64_t>(sample, kStartUsecs + (i * 1000ULL));
+        ULogBuilder::put<float>(sample, 16.f);
+        builder.data(0, sample);
+    }
+    QVERIFY(writeFile(logFile, builder.log));
+
+    QString errorMessage;
+    const QString cacheDirectory = LogColumnStore::cacheDirectory(logFile, cacheRoot);
+    QVERIFY(cacheDirectory.startsWith(cacheRoot));
+    QCOMPARE(LogColumnStore::cacheDirectory(logFile, cacheRoot), cacheDirectory);
+
+    // Nothing ingested yet
+    LogColumnStore store;
+    QVERIFY(!store.open(cacheDirectory, errorMessage));
+    QVERIFY(!store.isOpen());
+
+    QVERIFY2(LogColumnStore::build(logFile, cacheDirectory, errorMessage), qPrintable(errorMessage));
+    QVERIFY2(store.open(cacheDirectory, errorMessage), qPrintable(errorMessage));
+    QCOMPARE(store.rows(QStringLiteral("battery")), qint64(10));
+    store.close();
+    QVERIFY(!store.isOpen());
+
+    // A changed log gets a cache of its own
+    QVERIFY(writeFile(logFile, builder.log + builder.log.right(17)));
+    QVERIFY(LogColumnStore::cacheDirectory(logFile, cacheRoot) != cacheDirectory);
+
+    // Rebuilding replaces the old cache
+    QVERIFY2(LogColumnStore::build(logFile, cacheDirectory, errorMessage), qPrintable(errorMessage));
+    QVERIFY2(store.open(cacheDirectory, errorMessage), qPrintable(errorMessage));
+    QCOMPARE(store.rows(QStringLiteral("battery")), qint64(11));
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "UnitTest.h"
+
+class LogColumnStoreTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    LogColumnStoreTest() = default;
+
+private slots:
+    void _ulogQueriesTest();
+    void _tlogTest();
+    void _cacheTest();
+};
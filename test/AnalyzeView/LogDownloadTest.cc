@@ -20,42 +20,135 @@
 #include <QtCore/QDir>
 #include <QtTest/QTest>
 
-void LogDownloadTest::_downloadTest()
+void LogDownloadTest::_connect(uint32_t logSize, int lossPercent)
 {
     MultiVehicleManager::instance()->init();
     MAVLinkProtocol::instance()->init();
 
     _connectMockLink(MAV_AUTOPILOT_PX4);
+    _mockLink->setLogDownloadFileSize(logSize);
+    _mockLink->setLogDownloadLossPercent(lossPercent);
 
-    LogDownloadController *const controller = new LogDownloadController(this);
-    MultiSignalSpyV2 *multiSpyLogDownloadController = new MultiSignalSpyV2(this);
-    QVERIFY(multiSpyLogDownloadController->init(controller));
+    _controller = new LogDownloadController(this);
+    _multiSpy = new MultiSignalSpyV2(this);
+    QVERIFY(_multiSpy->init(_controller));
+}
 
-    controller->refresh();
-    QVERIFY(multiSpyLogDownloadController->waitForSignal("requestingListChanged", 10000));
-    multiSpyLogDownloadController->clearAllSignals();
-    if (controller->_getRequestingList()) {
-        QVERIFY(multiSpyLogDownloadController->waitForSignal("requestingListChanged", 10000));
-        QCOMPARE(controller->_getRequestingList(), false);
+bool LogDownloadTest::_refreshLogList()
+{
+    _controller->refresh();
+    if (!_multiSpy->waitForSignal("requestingListChanged", 10000)) {
+        return false;
     }
-    multiSpyLogDownloadController->clearAllSignals();
+    _multiSpy->clearAllSignals();
+    if (_controller->_getRequestingList()) {
+        if (!_multiSpy->waitForSignal("requestingListChanged", 10000)) {
+            return false;
+        }
+    }
+    _multiSpy->clearAllSignals();
+
+    return !_controller->_getRequestingList();
+}
+
+bool LogDownloadTest::_waitForDownload(int timeoutMs)
+{
+    if (!_multiSpy->waitForSignal("downloadingLogsChanged", 10000)) {
+        return false;
+    }
+    _multiSpy->clearAllSignals();
+    if (_controller->_getDownloadingLogs()) {
+        if (!_multiSpy->waitForSignal("downloadingLogsChanged", timeoutMs)) {
+            return false;
+        }
+    }
+    _multiSpy->clearAllSignals();
+
+    return !_controller->_getDownloadingLogs();
+}
+
+void LogDownloadTest::_downloadTest()
+{
+    _connect(1000, 0);
+    QVERIFY(_refreshLogList());
 
-    QmlObjectListModel *const model = controller->_getModel();
+    QmlObjectListModel *const model = _controller->_getModel();
     QVERIFY(model);
     model->value<QGCLogEntry*>(0)->setSelected(true);
 
     const QString downloadTo = QDir::currentPath();
-    controller->download(downloadTo);
-    QVERIFY(multiSpyLogDownloadController->waitForSignal("downloadingLogsChanged", 10000));
-    multiSpyLogDownloadController->clearAllSignals();
-    if (controller->_getDownloadingLogs()) {
-        QVERIFY(multiSpyLogDownloadController->waitForSignal("downloadingLogsChanged", 10000));
-        QCOMPARE(controller->_getDownloadingLogs(), false);
-    }
-    multiSpyLogDownloadController->clearAllSignals();
+    _controller->download(downloadTo);
+    QVERIFY(_waitForDownload(10000));
+
+    const QString downloadFile = QDir(downloadTo).filePath("log_0_UnknownDate.ulg");
+    QVERIFY(UnitTest::fileCompare(downloadFile, _mockLink->logDownloadFile()));
+
+    (void) QFile::remove(downloadFile);
+}
 
+void LogDownloadTest::_lossyDownloadTest()
+{
+    static constexpr uint32_t kLogSize = 256 * 1024;
+    static constexpr int kLossPercent = 20;
+
+    _connect(kLogSize, kLossPercent);
+    QVERIFY(_refreshLogList());
+
+    _controller->_getModel()->value<QGCLogEntry*>(0)->setSelected(true);
+
+    const QString downloadTo = QDir::currentPath();
+    _controller->download(downloadTo);
+    QVERIFY(_waitForDownload(60000));
+
+    // Dropped data was asked for again
+    QVERIFY(_mockLink->logDownloadBytesSent() > kLogSize);
+
+    const QString downloadFile = QDir(downloadTo).filePath("log_0_UnknownDate.ulg");
+    QVERIFY(UnitTest::fileCompare(downloadFile, _mockLink->logDownloadFile()));
+    QVERIFY(!QFile::exists(downloadFile + QLatin1String(LogDownloadData::kPartialSuffix)));
+
+    (void) QFile::remove(downloadFile);
+}
+
+void LogDownloadTest::_resumeTest()
+{
+    static constexpr uint32_t kLogSize = 256 * 1024;
+
+    _connect(kLogSize, 0);
+    QVERIFY(_refreshLogList());
+
+    QGCLogEntry *const entry = _controller->_getModel()->value<QGCLogEntry*>(0);
+    entry->setSelected(true);
+
+    const QString downloadTo = QDir::currentPath();
     const QString downloadFile = QDir(downloadTo).filePath("log_0_UnknownDate.ulg");
+    const QString partialFile = downloadFile + QLatin1String(LogDownloadData::kPartialSuffix);
+    const QString stateFile = partialFile + QLatin1String(LogDownloadData::kStateSuffix);
+    (void) QFile::remove(partialFile);
+    (void) QFile::remove(stateFile);
+
+    // Interrupt the download about half way through
+    _controller->download(downloadTo);
+    QTRY_VERIFY_WITH_TIMEOUT(_mockLink->logDownloadBytesSent() > (kLogSize / 2), 30000);
+    _controller->cancel();
+    QCOMPARE(_controller->_getDownloadingLogs(), false);
+    QVERIFY(QFile::exists(partialFile));
+    QVERIFY(QFile::exists(stateFile));
+    QVERIFY(!QFile::exists(downloadFile));
+
+    // Downloading again only fetches what is missing
+    _multiSpy->clearAllSignals();
+    const uint64_t sentBeforeResume = _mockLink->logDownloadBytesSent();
+    entry->setSelected(true);
+    _controller->download(downloadTo);
+    QVERIFY(_waitForDownload(30000));
+
+    const uint64_t sentAfterResume = _mockLink->logDownloadBytesSent() - sentBeforeResume;
+    QVERIFY2(sentAfterResume < kLogSize, qPrintable(QString::number(sentAfterResume)));
+
     QVERIFY(UnitTest::fileCompare(downloadFile, _mockLink->logDownloadFile()));
+    QVERIFY(!QFile::exists(partialFile));
+    QVERIFY(!QFile::exists(stateFile));
 
     (void) QFile::remove(downloadFile);
 }
@@ -2,10 +2,23 @@
 
 #include "UnitTest.h"
 
+class LogDownloadController;
+class MultiSignalSpyV2;
+
 class LogDownloadTest : public UnitTest
 {
     Q_OBJECT
 
 private slots:
     void _downloadTest();
+    void _lossyDownloadTest();
+    void _resumeTest();
+
+private:
+    void _connect(uint32_t logSize, int lossPercent);
+    bool _refreshLogList();
+    bool _waitForDownload(int timeoutMs);
+
+    LogDownloadController *_controller = nullptr;
+    MultiSignalSpyV2 *_multiSpy = nullptr;
 };
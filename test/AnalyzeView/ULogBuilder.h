@@ -0,0 +1,64 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include <QtCore/QByteArray>
+#include <QtCore/QtEndian>
+
+/// Writes ULog files message by message
+class ULogBuilder
+{
+public:
+    ULogBuilder()
+    {
+        (void) log.append("ULog\x01\x12\x35", 7);
+        put<uint8_t>(log, 1);           // Version
+        put<uint64_t>(log, 1000);       // Timestamp
+        QByteArray flags(40, '\0');
+        message('B', flags);
+    }
+
+    template<typename T>
+    static void put(QByteArray &bytes, T value)
+    {
+        value = qToLittleEndian(value);
+        (void) bytes.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    void message(char type, const QByteArray &payload)
+    {
+        put<uint16_t>(log, static_cast<uint16_t>(payload.size()));
+        (void) log.append(type);
+        (void) log.append(payload);
+    }
+
+    void format(const QByteArray &format) { message('F', format); }
+
+    void addLogged(uint8_t multiId, uint16_t msgId, const QByteArray &name)
+    {
+        QByteArray payload;
+        put<uint8_t>(payload, multiId);
+        put<uint16_t>(payload, msgId);
+        (void) payload.append(name);
+        message('A', payload);
+    }
+
+    void data(uint16_t msgId, const QByteArray &sample)
+    {
+        QByteArray payload;
+        put<uint16_t>(payload, msgId);
+        (void) payload.append(sample);
+        message('D', payload);
+    }
+
+    void sync() { message('S', QByteArray("\x2F\x73\x13\x20\x25\x0C\xBB\x12", 8)); }
+
+    QByteArray log;
+};
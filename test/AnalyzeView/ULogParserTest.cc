@@ -1,12 +1,54 @@
 #include "ULogParserTest.h"
+#include "ULogBuilder.h"
 #include "ULogParser.h"
+#include "ULogReader.h"
 #include "GeoTagWorker.h"
 
+#include <QtCore/QTemporaryFile>
+#include <QtCore/QThreadPool>
+#include <QtCore/QtEndian>
 #include <QtTest/QTest>
 
+namespace {
+    constexpr char kCameraCaptureFormat[] = "camera_capture:uint64_t timestamp;uint64_t timestamp_utc;double lat;double lon;float alt;float ground_distance;float[4] q;uint32_t seq;int8_t result;uint8_t[3] _padding0;";
+
+    QByteArray cameraCapture(uint32_t seq)
+    {
+        QByteArray sample;
+        ULogBuilder::put<uint64_t>(sample, seq * 1000000ULL);
+        ULogBuilder::put<uint64_t>(sample, 1700000000000000ULL + (seq * 1000000ULL));
+        ULogBuilder::put<double>(sample, 47. + (seq * 1e-5));
+        ULogBuilder::put<double>(sample, 8. + (seq * 1e-5));
+        ULogBuilder::put<float>(sample, 500.f + seq);
+        ULogBuilder::put<float>(sample, 20.f);
+        for (const float q : { 1.f, 0.f, 0.f, 0.f }) {
+            ULogBuilder::put<float>(sample, q);
+        }
+        ULogBuilder::put<uint32_t>(sample, seq);
+        ULogBuilder::put<int8_t>(sample, 1);
+        return sample;  // Trailing padding is not logged
+    }
+
+    constexpr char kSensorFormat[] = "sensor_test:uint64_t timestamp;float[3] accel;uint32_t counter;uint8_t[4] _padding0;";
+
+    QByteArray sensorSample(uint32_t counter)
+    {
+        QByteArray sample;
+        ULogBuilder::put<uint64_t>(sample, counter * 1000ULL);
+        for (int i = 0; i < 3; i++) {
+            ULogBuilder::put<float>(sample, static_cast<float>(counter + i));
+        }
+        ULogBuilder::put<uint32_t>(sample, counter);
+        return sample;
+    }
+}
+
 void ULogParserTest::_getTagsFromLogTest()
 {
     QFile file(":/SampleULog.ulg");
+    if (!file.exists()) {
+        QSKIP("SampleULog.ulg is not part of the test resources");
+    }
     QVERIFY(file.open(QIODevice::ReadOnly));
 
     const QByteArray logBuffer = file.readAll();
@@ -22,3 +64,186 @@ void ULogParserTest::_getTagsFromLogTest()
     // QVERIFY(!qFuzzyIsNull(firstCameraFeedback.timestamp));
     QVERIFY(firstCameraFeedback.imageSequence != 0);
 }
+
+void ULogParserTest::_syntheticTagsTest()
+{
+    ULogBuilder builder;
+    builder.format(kCameraCaptureFormat);
+    builder.format(kSensorFormat);
+    builder.addLogged(0, 0, "sensor_test");
+    builder.addLogged(0, 1, "camera_capture");
+    for (uint32_t seq = 1; seq <= 10; seq++) {
+        builder.data(0, sensorSample(seq));
+        builder.data(1, cameraCapture(seq));
+    }
+
+    QList<GeoTagWorker::CameraFeedbackPacket> cameraFeedback;
+    QString errorMessage;
+    QVERIFY2(ULogParser::getTagsFromLog(builder.log, cameraFeedback, errorMessage), qPrintable(errorMessage));
+    QCOMPARE(cameraFeedback.size(), qsizetype(10));
+
+    for (int i = 0; i < cameraFeedback.size(); i++) {
+        const GeoTagWorker::CameraFeedbackPacket &feedback = cameraFeedback[i];
+        const uint32_t seq = i + 1;
+        QCOMPARE(feedback.imageSequence, seq);
+        QCOMPARE(feedback.timestamp, static_cast<double>(seq));
+        QCOMPARE(feedback.timestampUTC, 1700000000. + seq);
+        QCOMPARE(feedback.latitude, 47. + (seq * 1e-5));
+        QCOMPARE(feedback.altitude, 500.f + seq);
+        QCOMPARE(feedback.groundDistance, 20.f);
+        QCOMPARE(feedback.attitudeQuaternion[0], 1.f);
+        QCOMPARE(feedback.captureResult, uint8_t(1));
+    }
+
+    // A log without camera_capture is an error
+    ULogBuilder noCamera;
+    noCamera.format(kSensorFormat);
+    noCamera.addLogged(0, 0, "sensor_test");
+    noCamera.data(0, sensorSample(1));
+    cameraFeedback.clear();
+    QVERIFY(!ULogParser::getTagsFromLog(noCamera.log, cameraFeedback, errorMessage));
+    QVERIFY(!errorMessage.isEmpty());
+
+    QVERIFY(!ULogParser::getTagsFromLog(QByteArray("Not a ULog"), cameraFeedback, errorMessage));
+}
+
+void ULogParserTest::_formatFieldsTest()
+{
+    // Nested formats may be defined after the formats which use them
+    ULogBuilder builder;
+    builder.format("outer:uint64_t timestamp;inner[2] in;char[4] name;uint8_t[1] _padding0;");
+    builder.format("inner:float a;uint8_t b;uint8_t[3] _padding0;");
+
+    ULogReader reader;
+    QString errorMessage;
+    QVERIFY2(reader.open(builder.log, errorMessage), qPrintable(errorMessage));
+
+    const QList<ULogReader::Field_t> fields = reader.formatFields("outer");
+    QCOMPARE(fields.size(), qsizetype(5));
+    const QStringList names = { "timestamp", "in[0].a", "in[0].b", "in[1].a", "in[1].b" };
+    const QList<int> offsets = { 0, 8, 12, 16, 20 };
+    for (int i = 0; i < fields.size(); i++) {
+        QCOMPARE(fields[i].name, names[i]);
+        QCOMPARE(fields[i].offset, offsets[i]);
+    }
+    QCOMPARE(fields[1].type, ULogReader::FieldTypeFloat);
+    QCOMPARE(fields[2].type, ULogReader::FieldTypeUInt8);
+}
+
+void ULogParserTest::_largeLogTest()
+{
+    static constexpr qint64 kLogSize = 64 * 1024 * 1024;
+    static constexpr qint64 kChunkSize = 1024 * 1024;
+    static constexpr int kSyncInterval = 2000;      // Messages, about every 60kB
+    static constexpr int kCameraInterval = 1000;
+
+    // High rate sensor topic with a camera subscribed part way through, and a zeroed stretch to resync over
+    ULogBuilder builder;
+    builder.format(kCameraCaptureFormat);
+    builder.format(kSensorFormat);
+    builder.addLogged(0, 0, "sensor_test");
+
+    uint32_t sensorCount = 0;
+    uint32_t cameraCount = 0;
+    bool cameraSubscribed = false;
+    bool corrupted = false;
+    while (builder.log.size() < kLogSize) {
+        if ((sensorCount % kSyncInterval) == 0) {
+            builder.sync();
+        }
+        if (!cameraSubscribed && (builder.log.size() > (kLogSize * 2 / 5))) {
+            builder.addLogged(0, 1, "camera_capture");
+            cameraSubscribed = true;
+        }
+        if (!corrupted && (builder.log.size() > (kLogSize / 2)) && ((sensorCount % kSyncInterval) == (kSyncInterval - 1))) {
+            // Lost data is zero filled, the reader picks up again at the sync which follows
+            (void) builder.log.append(100, '\0');
+            corrupted = true;
+            sensorCount++;
+            continue;
+        }
+        builder.data(0, sensorSample(sensorCount++));
+        if (cameraSubscribed && ((sensorCount % kCameraInterval) == 0)) {
+            builder.data(1, cameraCapture(++cameraCount));
+        }
+    }
+    QVERIFY(corrupted);
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write(builder.log), qint64(builder.log.size()));
+    QVERIFY(file.flush());
+    builder.log.clear();
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(4);
+
+    ULogReader reader;
+    QString errorMessage;
+    QVERIFY2(reader.open(file.fileName(), errorMessage), qPrintable(errorMessage));
+    reader.setThreadPool(&threadPool);
+    reader.setChunkSize(kChunkSize);
+    reader.subscribe("sensor_test", { "timestamp", "counter" });
+    reader.subscribe("camera_capture");
+    QVERIFY2(reader.read(errorMessage), qPrintable(errorMessage));
+
+    const ULogReader::Stats_t stats = reader.stats();
+    QVERIFY(stats.bytesScanned <= file.size());
+    QCOMPARE(stats.samplesDecoded, qint64(sensorCount - 1 + cameraCount));
+    QVERIFY(stats.chunks > 32);
+    // Unless a chunk happens to end on the zeroed stretch, then there's nothing to resync to
+    QVERIFY(stats.resyncs <= 1);
+
+    // Only a chunk per thread is held at a time, never the log
+    QVERIFY2(stats.peakMappedBytes <= (threadPool.maxThreadCount() * 2 * kChunkSize), qPrintable(QString::number(stats.peakMappedBytes)));
+
+    // Every sensor sample but the one overwritten by the zeroed stretch, in order
+    const ULogReader::Topic_t *const sensor = reader.topic("sensor_test");
+    QVERIFY(sensor);
+    QCOMPARE(sensor->fields.size(), qsizetype(2));
+    QCOMPARE(sensor->rows, qsizetype(sensorCount - 1));
+    const int counterColumn = ULogReader::fieldIndex(*sensor, "counter");
+    QVERIFY(counterColumn >= 0);
+    uint32_t expectedCounter = 0;
+    int gaps = 0;
+    for (qsizetype row = 0; row < sensor->rows; row++) {
+        const uint32_t counter = static_cast<uint32_t>(ULogReader::value(sensor->columns[counterColumn], row));
+        if (counter != expectedCounter) {
+            gaps++;
+            QCOMPARE(counter, expectedCounter + 1);
+        }
+        expectedCounter = counter + 1;
+    }
+    QCOMPARE(gaps, 1);
+
+    // Subscribed in one chunk, decoded in the chunks after it
+    const ULogReader::Topic_t *const camera = reader.topic("camera_capture");
+    QVERIFY(camera);
+    QCOMPARE(camera->rows, qsizetype(cameraCount));
+    const int seqColumn = ULogReader::fieldIndex(*camera, "seq");
+    QCOMPARE(ULogReader::value(camera->columns[seqColumn], cameraCount - 1), static_cast<double>(cameraCount));
+
+    // A single sequential chunk decodes the same
+    ULogReader sequentialReader;
+    QVERIFY(sequentialReader.open(file.fileName(), errorMessage));
+    sequentialReader.setChunkSize(kLogSize * 2);
+    sequentialReader.subscribe("sensor_test", { "timestamp", "counter" });
+    sequentialReader.subscribe("camera_capture");
+    QVERIFY(sequentialReader.read(errorMessage));
+    QCOMPARE(sequentialReader.stats().chunks, 1);
+    QCOMPARE(sequentialReader.stats().bytesScanned, stats.bytesScanned);
+    QCOMPARE(sequentialReader.stats().samplesDecoded, stats.samplesDecoded);
+    for (const ULogReader::Topic_t &topic : reader.topics()) {
+        const ULogReader::Topic_t *const sequentialTopic = sequentialReader.topic(topic.name, topic.multiId);
+        QVERIFY(sequentialTopic);
+        QCOMPARE(sequentialTopic->rows, topic.rows);
+        for (qsizetype i = 0; i < topic.columns.size(); i++) {
+            QVERIFY(sequentialTopic->columns[i].data == topic.columns[i].data);
+        }
+    }
+
+    // GeoTagWorker's path through the file
+    QList<GeoTagWorker::CameraFeedbackPacket> cameraFeedback;
+    QVERIFY2(ULogParser::getTagsFromLog(file.fileName(), cameraFeedback, errorMessage, &threadPool), qPrintable(errorMessage));
+    QCOMPARE(cameraFeedback.size(), static_cast<qsizetype>(cameraCount));
+}
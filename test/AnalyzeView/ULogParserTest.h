@@ -11,4 +11,7 @@ class ULogParserTest : public UnitTest
 
 private slots:
     void _getTagsFromLogTest();
+    void _syntheticTagsTest();
+    void _formatFieldsTest();
+    void _largeLogTest();
 };
@@ -0,0 +1,213 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "LinkWriteQueueTest.h"
+#include "LinkWriteQueue.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QThread>
+#include <QtTest/QTest>
+
+#include <cstring>
+
+namespace {
+    /// Frame tagged with its producer and sequence number, padded out to length
+    QByteArray makeFrame(int producer, int sequence, int length)
+    {
+        QByteArray frame(length, static_cast<char>(producer));
+        (void) memcpy(frame.data(), &producer, sizeof(producer));
+        (void) memcpy(frame.data() + sizeof(producer), &sequence, sizeof(sequence));
+        return frame;
+    }
+
+    int frameLength(int sequence)
+    {
+        // Mostly MAVLink sized, with the occasional frame too large for the pool
+        return ((sequence % 50) == 0) ? (LinkWriteQueue::kInlineFrameSize + 100) : (12 + (sequence % 40));
+    }
+}
+
+void LinkWriteQueueTest::_testOrderAndContents()
+{
+    LinkWriteQueue queue;
+
+    QList<QByteArray> frames;
+    for (int i = 0; i < 200; i++) {
+        frames.append(makeFrame(0, i, frameLength(i)));
+        const bool drainNeeded = queue.push(frames.last().constData(), frames.last().size());
+        QCOMPARE(drainNeeded, (i == 0));
+    }
+
+    QList<QByteArray> written;
+    queue.drain(false, [&written](const char *bytes, int length) {
+        written.append(QByteArray(bytes, length));
+    });
+    QCOMPARE(written, frames);
+
+    // Draining resets the request
+    QVERIFY(queue.push(frames.first().constData(), frames.first().size()));
+
+    const LinkWriteQueue::Stats_t stats = queue.stats();
+    QCOMPARE(stats.framesQueued, quint64(201));
+    QCOMPARE(stats.framesWritten, quint64(200));
+    QCOMPARE(stats.writeCalls, quint64(200));
+    QVERIFY(stats.maxLatencyUsecs >= stats.averageLatencyUsecs);
+}
+
+void LinkWriteQueueTest::_testCoalesce()
+{
+    LinkWriteQueue queue;
+
+    QByteArray expected;
+    for (int i = 0; i < 100; i++) {
+        const QByteArray frame = makeFrame(0, i, 100);
+        expected.append(frame);
+        (void) queue.push(frame.constData(), frame.size());
+    }
+
+    QList<QByteArray> written;
+    queue.drain(true, [&written](const char *bytes, int length) {
+        written.append(QByteArray(bytes, length));
+    });
+
+    QVERIFY(written.count() > 1);
+    QVERIFY(written.count() < 10);
+    QByteArray joined;
+    for (const QByteArray &bytes : written) {
+        QVERIFY(bytes.size() <= LinkWriteQueue::kMaxCoalescedBytes);
+        joined.append(bytes);
+    }
+    QCOMPARE(joined, expected);
+    QCOMPARE(queue.stats().writeCalls, quint64(written.count()));
+
+    // A frame larger than a coalesced write goes out on its own, between what was joined before and after it
+    const QByteArray before = makeFrame(0, 0, 100);
+    const QByteArray large = makeFrame(0, 1, LinkWriteQueue::kMaxCoalescedBytes + 1);
+    const QByteArray after = makeFrame(0, 2, 100);
+    for (const QByteArray *frame : { &before, &large, &after }) {
+        (void) queue.push(frame->constData(), frame->size());
+    }
+
+    written.clear();
+    queue.drain(true, [&written](const char *bytes, int length) {
+        written.append(QByteArray(bytes, length));
+    });
+    QCOMPARE(written, QList<QByteArray>({ before, large, after }));
+}
+
+void LinkWriteQueueTest::_testPoolReuse()
+{
+    LinkWriteQueue queue;
+    const QByteArray frame = makeFrame(0, 0, 32);
+
+    for (int round = 0; round < 10; round++) {
+        for (int i = 0; i < LinkWriteQueue::kPoolSize; i++) {
+            (void) queue.push(frame.constData(), frame.size());
+        }
+        queue.drain(false, [](const char *, int) {});
+    }
+    QCOMPARE(queue.stats().poolMisses, quint64(0));
+
+    // One more than the pool holds spills to the heap
+    for (int i = 0; i <= LinkWriteQueue::kPoolSize; i++) {
+        (void) queue.push(frame.constData(), frame.size());
+    }
+    queue.drain(false, [](const char *, int) {});
+    QCOMPARE(queue.stats().poolMisses, quint64(1));
+}
+
+void LinkWriteQueueTest::_testPriority()
+{
+    LinkWriteQueue queue;
+
+    QList<QByteArray> bulk;
+    for (int i = 0; i < 20; i++) {
+        bulk.append(makeFrame(0, i, 64));
+        (void) queue.push(bulk.last().constData(), bulk.last().size());
+    }
+
+    QList<QByteArray> priority;
+    for (int i = 0; i < 3; i++) {
+        priority.append(makeFrame(1, i, frameLength(i)));
+        (void) queue.push(priority.last().constData(), priority.last().size(), true);
+    }
+
+    // Priority frames overtake the bulk backlog, each kind stays in order
+    QList<QByteArray> written;
+    queue.drain(false, [&written](const char *bytes, int length) {
+        written.append(QByteArray(bytes, length));
+    });
+    QCOMPARE(written, priority + bulk);
+
+    const LinkWriteQueue::Stats_t stats = queue.stats();
+    QCOMPARE(stats.priorityFrames, quint64(3));
+    QCOMPARE(stats.framesWritten, quint64(23));
+}
+
+void LinkWriteQueueTest::_testMultipleProducers()
+{
+    constexpr int cProducers = 4;
+    constexpr int cFrames = 20000;
+
+    LinkWriteQueue queue;
+    std::atomic_int drainRequests = 0;
+
+    QList<QThread*> producers;
+    for (int producer = 0; producer < cProducers; producer++) {
+        producers.append(QThread::create([&queue, &drainRequests, producer]() {
+            for (int i = 0; i < cFrames; i++) {
+                const QByteArray frame = makeFrame(producer, i, frameLength(i));
+                if (queue.push(frame.constData(), frame.size())) {
+                    drainRequests++;
+                }
+            }
+        }));
+    }
+
+    QList<int> nextSequence(cProducers, 0);
+    int received = 0;
+    bool valid = true;
+    const auto write = [&](const char *data, int length) {
+        const QByteArray bytes(data, length);
+        int producer, sequence;
+        (void) memcpy(&producer, bytes.constData(), sizeof(producer));
+        (void) memcpy(&sequence, bytes.constData() + sizeof(producer), sizeof(sequence));
+        valid = valid && (producer >= 0) && (producer < cProducers) && (sequence == nextSequence[producer]) && (bytes == makeFrame(producer, sequence, frameLength(sequence)));
+        if (valid) {
+            nextSequence[producer]++;
+        }
+        received++;
+    };
+
+    for (QThread *thread : producers) {
+        thread->start();
+    }
+
+    // Behave like the link thread: only drain when asked to, which must never leave frames stranded
+    int drainsHandled = 0;
+    QElapsedTimer timeout;
+    timeout.start();
+    while ((received < (cProducers * cFrames)) && (timeout.elapsed() < 10000)) {
+        if (drainRequests > drainsHandled) {
+            drainsHandled = drainRequests;
+            queue.drain(false, write);
+        } else {
+            QThread::yieldCurrentThread();
+        }
+    }
+
+    for (QThread *thread : producers) {
+        QVERIFY(thread->wait(10000));
+        delete thread;
+    }
+
+    QVERIFY(valid);
+    QCOMPARE(received, cProducers * cFrames);
+    QCOMPARE(queue.stats().framesWritten, quint64(cProducers * cFrames));
+}
@@ -0,0 +1,270 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "MockSwarmLinkTest.h"
+#include "LinkManager.h"
+#include "MockSwarmLink.h"
+#include "MockSwarmWorker.h"
+#include "MultiVehicleManager.h"
+
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+namespace {
+    /// Parses generated traffic without tying up a mavlink channel
+    class Parser
+    {
+    public:
+        QList<mavlink_message_t> parse(const QByteArray &bytes)
+        {
+            QList<mavlink_message_t> messages;
+            for (const char byte : bytes) {
+                mavlink_message_t message{};
+                mavlink_status_t status{};
+                if (mavlink_frame_char_buffer(&_buffer, &_status, static_cast<uint8_t>(byte), &message, &status) == MAVLINK_FRAMING_OK) {
+                    messages.append(message);
+                }
+            }
+            return messages;
+        }
+
+    private:
+        mavlink_message_t _buffer{};
+        mavlink_status_t _status{};
+    };
+
+    QList<int> vehicleRange(int count)
+    {
+        QList<int> indices;
+        for (int i = 0; i < count; i++) {
+            indices.append(i);
+        }
+        return indices;
+    }
+}
+
+void MockSwarmLinkTest::_testSystemIdRange()
+{
+    MockSwarmConfiguration config(QStringLiteral("MockSwarmLinkTest"));
+    QSignalSpy countSpy(&config, &MockSwarmConfiguration::vehicleCountChanged);
+
+    // The last vehicle lands exactly on the highest id which isn't the GCS
+    config.setVehicleCount(MockSwarmConfiguration::kMaxVehicleCount);
+    config.setFirstSystemId(MockSwarmConfiguration::kMaxSystemId - MockSwarmConfiguration::kMaxVehicleCount + 1);
+    QCOMPARE(config.vehicleCount(), MockSwarmConfiguration::kMaxVehicleCount);
+
+    // One further and the count shrinks instead of overflowing into 255 and wrapping to 0
+    countSpy.clear();
+    config.setFirstSystemId(config.firstSystemId() + 1);
+    QCOMPARE(config.vehicleCount(), MockSwarmConfiguration::kMaxVehicleCount - 1);
+    QCOMPARE(countSpy.count(), 1);
+
+    config.setFirstSystemId(255);
+    QCOMPARE(config.firstSystemId(), MockSwarmConfiguration::kMaxSystemId);
+    QCOMPARE(config.vehicleCount(), 1);
+
+    // Asking for more while the ids are used up changes nothing
+    countSpy.clear();
+    config.setVehicleCount(20);
+    QCOMPARE(config.vehicleCount(), 1);
+    QCOMPARE(countSpy.count(), 0);
+
+    // The count asked for returns once there is room, whichever order the two are set in
+    config.setFirstSystemId(100);
+    QCOMPARE(config.vehicleCount(), 20);
+    QCOMPARE(countSpy.count(), 1);
+
+    MockSwarmConfiguration copy(QStringLiteral("MockSwarmLinkTestCopy"));
+    copy.setFirstSystemId(MockSwarmConfiguration::kMaxSystemId);
+    copy.copyFrom(&config);
+    QCOMPARE(copy.firstSystemId(), 100);
+    QCOMPARE(copy.vehicleCount(), 20);
+
+    // Every generated vehicle gets a valid id
+    config.setVehicleCount(MockSwarmConfiguration::kMaxVehicleCount);
+    config.setFirstSystemId(200);
+    MockSwarmWorker worker(&config, vehicleRange(config.vehicleCount()), 0);
+
+    Parser parser;
+    QSet<uint8_t> systemIds;
+    for (qint64 now = 0; now < 2000; now += MockSwarmWorker::kTickMsecs) {
+        for (const mavlink_message_t &message : parser.parse(worker.generate(now))) {
+            systemIds.insert(message.sysid);
+        }
+    }
+    QCOMPARE(systemIds.count(), MockSwarmConfiguration::kMaxSystemId - 200 + 1);
+    QVERIFY(!systemIds.contains(0));
+    QVERIFY(!systemIds.contains(255));
+}
+
+void MockSwarmLinkTest::_testMessageRates()
+{
+    MockSwarmConfiguration config(QStringLiteral("MockSwarmLinkTest"));
+    config.setFirstSystemId(10);
+    config.setAttitudeRate(30.);
+    config.setEscStatusRate(0.);
+
+    constexpr int cVehicles = 5;
+    constexpr int cSeconds = 10;
+    MockSwarmWorker worker(&config, vehicleRange(cVehicles), 0);
+
+    Parser parser;
+    QMap<uint32_t, int> counts;
+    QSet<uint8_t> systemIds;
+    for (qint64 now = 0; now < (cSeconds * 1000); now += MockSwarmWorker::kTickMsecs) {
+        for (const mavlink_message_t &message : parser.parse(worker.generate(now))) {
+            counts[message.msgid]++;
+            systemIds.insert(message.sysid);
+        }
+    }
+
+    QCOMPARE(systemIds.count(), cVehicles);
+    QVERIFY(systemIds.contains(10) && systemIds.contains(14));
+    QVERIFY(qAbs(counts[MAVLINK_MSG_ID_HEARTBEAT] - (cVehicles * cSeconds)) <= cVehicles);
+    QVERIFY(qAbs(counts[MAVLINK_MSG_ID_ATTITUDE] - (cVehicles * cSeconds * 30)) <= cVehicles);
+    QVERIFY(qAbs(counts[MAVLINK_MSG_ID_GLOBAL_POSITION_INT] - (cVehicles * cSeconds * 10)) <= cVehicles);
+    QVERIFY(qAbs(counts[MAVLINK_MSG_ID_ADSB_VEHICLE] - (cVehicles * cSeconds * 2)) <= cVehicles);
+    QCOMPARE(counts.value(MAVLINK_MSG_ID_ESC_STATUS), 0);
+    QCOMPARE(worker.stats().messagesDropped.load(), quint64(0));
+}
+
+void MockSwarmLinkTest::_testPacketLoss()
+{
+    MockSwarmConfiguration config(QStringLiteral("MockSwarmLinkTest"));
+    config.setPacketLossPercent(25.);
+
+    MockSwarmWorker worker(&config, vehicleRange(1), 0);
+
+    Parser parser;
+    int received = 0;
+    int sequenceGaps = 0;
+    uint8_t expectedSequence = 0;
+    for (qint64 now = 0; now < 10000; now += MockSwarmWorker::kTickMsecs) {
+        for (const mavlink_message_t &message : parser.parse(worker.generate(now))) {
+            if ((received > 0) && (message.seq != expectedSequence)) {
+                sequenceGaps++;
+            }
+            expectedSequence = message.seq + 1;
+            received++;
+        }
+    }
+
+    const MockSwarmWorker::Stats_t &stats = worker.stats();
+    const double lossPercent = (100. * stats.messagesDropped.load()) / stats.messagesGenerated.load();
+    QCOMPARE(static_cast<quint64>(received), stats.messagesGenerated.load() - stats.messagesDropped.load());
+    QVERIFY(qAbs(lossPercent - 25.) < 3.);
+
+    // Lost packets still used up their sequence numbers
+    QVERIFY(sequenceGaps > 0);
+
+    // The same seed loses the same packets
+    MockSwarmWorker repeat(&config, vehicleRange(1), 0);
+    for (qint64 now = 0; now < 10000; now += MockSwarmWorker::kTickMsecs) {
+        (void) repeat.generate(now);
+    }
+    QCOMPARE(repeat.stats().messagesDropped.load(), stats.messagesDropped.load());
+}
+
+void MockSwarmLinkTest::_testLatencyAndBursts()
+{
+    const auto firstDelivery = [](const MockSwarmConfiguration &config) {
+        MockSwarmWorker worker(&config, vehicleRange(10), 0);
+        for (qint64 now = 0; now < 1000; now += MockSwarmWorker::kTickMsecs) {
+            if (!worker.generate(now).isEmpty()) {
+                return now;
+            }
+        }
+        return qint64(-1);
+    };
+
+    // Same seed, so both workers generate on the same schedule
+    MockSwarmConfiguration config(QStringLiteral("MockSwarmLinkTest"));
+    const qint64 immediate = firstDelivery(config);
+    config.setLatencyMsecs(200);
+    QVERIFY(immediate >= 0);
+    QCOMPARE(firstDelivery(config), immediate + 200);
+
+    config.setLatencyMsecs(0);
+    config.setBurstIntervalMsecs(1000);
+    config.setBurstLengthMsecs(400);
+
+    MockSwarmWorker bursty(&config, vehicleRange(10), 0);
+    for (qint64 now = 0; now < 3000; now += MockSwarmWorker::kTickMsecs) {
+        const bool delivered = !bursty.generate(now).isEmpty();
+        if ((now % 1000) < 400) {
+            QVERIFY(!delivered);
+        } else if ((now % 1000) == 400) {
+            // Everything held back during the burst arrives at once
+            QVERIFY(delivered);
+        }
+    }
+}
+
+void MockSwarmLinkTest::_testResponses()
+{
+    MockSwarmConfiguration config(QStringLiteral("MockSwarmLinkTest"));
+    config.setFirstSystemId(20);
+    for (int i = 0; i < MockSwarmConfiguration::MessageCount; i++) {
+        config.setMessageRate(static_cast<MockSwarmConfiguration::Message_t>(i), 0.);
+    }
+
+    MockSwarmWorker worker(&config, QList<int>({ 0, 2 }), 0);
+    QCOMPARE(worker.vehicleCount(), 2);
+
+    mavlink_message_t request{};
+    mavlink_param_request_list_t paramRequest{};
+    paramRequest.target_system = 22;
+    (void) mavlink_msg_param_request_list_encode(255, MAV_COMP_ID_MISSIONPLANNER, &request, &paramRequest);
+    worker.handleMessage(request);
+
+    // Vehicle 21 belongs to another worker
+    mavlink_command_long_t command{};
+    command.target_system = 21;
+    command.command = MAV_CMD_REQUEST_MESSAGE;
+    (void) mavlink_msg_command_long_encode(255, MAV_COMP_ID_MISSIONPLANNER, &request, &command);
+    worker.handleMessage(request);
+
+    command.target_system = 20;
+    (void) mavlink_msg_command_long_encode(255, MAV_COMP_ID_MISSIONPLANNER, &request, &command);
+    worker.handleMessage(request);
+
+    Parser parser;
+    QList<mavlink_message_t> responses;
+    for (const mavlink_message_t &message : parser.parse(worker.generate(0))) {
+        if (message.msgid != MAVLINK_MSG_ID_HEARTBEAT) {
+            responses.append(message);
+        }
+    }
+
+    QCOMPARE(responses.count(), 2);
+    QCOMPARE(static_cast<uint32_t>(responses[0].msgid), static_cast<uint32_t>(MAVLINK_MSG_ID_PARAM_VALUE));
+    QCOMPARE(responses[0].sysid, static_cast<uint8_t>(22));
+    QCOMPARE(static_cast<uint32_t>(responses[1].msgid), static_cast<uint32_t>(MAVLINK_MSG_ID_COMMAND_ACK));
+    QCOMPARE(responses[1].sysid, static_cast<uint8_t>(20));
+
+    mavlink_command_ack_t ack{};
+    mavlink_msg_command_ack_decode(&responses[1], &ack);
+    QCOMPARE(ack.command, static_cast<uint16_t>(MAV_CMD_REQUEST_MESSAGE));
+    QCOMPARE(ack.target_system, static_cast<uint8_t>(255));
+}
+
+void MockSwarmLinkTest::_testLink()
+{
+    constexpr int cVehicles = 12;
+
+    MockSwarmLink *const link = MockSwarmLink::startMockSwarmLink(cVehicles);
+    QVERIFY(link);
+
+    // Every simulated vehicle shows up as its own Vehicle
+    QTRY_COMPARE_WITH_TIMEOUT(MultiVehicleManager::instance()->vehicles()->count(), cVehicles, 10000);
+    QVERIFY(link->stats().bytesDelivered > 0);
+
+    link->disconnect();
+    QTRY_COMPARE_WITH_TIMEOUT(MultiVehicleManager::instance()->vehicles()->count(), 0, 10000);
+}
@@ -0,0 +1,25 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class MockSwarmLinkTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testSystemIdRange();
+    void _testMessageRates();
+    void _testPacketLoss();
+    void _testLatencyAndBursts();
+    void _testResponses();
+    void _testLink();
+};
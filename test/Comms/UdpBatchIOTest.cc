@@ -0,0 +1,173 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "UdpBatchIOTest.h"
+#include "UdpBatchIO.h"
+#include "UDPLink.h"
+
+#include <QtCore/QElapsedTimer>
+#include <QtNetwork/QNetworkDatagram>
+#include <QtNetwork/QUdpSocket>
+#include <QtTest/QTest>
+
+namespace {
+    /// Datagrams per round when filling a receive queue, small enough to never overflow the default socket buffer
+    constexpr int kRoundSize = 48;
+
+    QList<std::shared_ptr<UDPClient>> bindReceivers(QList<QUdpSocket*> &receivers, int count, QObject *parent)
+    {
+        QList<std::shared_ptr<UDPClient>> targets;
+        for (int i = 0; i < count; i++) {
+            QUdpSocket *const receiver = new QUdpSocket(parent);
+            if (!receiver->bind(QHostAddress::LocalHost, 0)) {
+                return QList<std::shared_ptr<UDPClient>>();
+            }
+            receivers.append(receiver);
+            targets.append(std::make_shared<UDPClient>(QHostAddress(QHostAddress::LocalHost), receiver->localPort()));
+        }
+
+        return targets;
+    }
+
+    int drainWithQt(QUdpSocket *socket, int expected)
+    {
+        int count = 0;
+        while ((count < expected) && socket->waitForReadyRead(1000)) {
+            while (socket->hasPendingDatagrams()) {
+                if (!socket->receiveDatagram().data().isEmpty()) {
+                    count++;
+                }
+            }
+        }
+
+        return count;
+    }
+
+    int drainWithBatch(UdpBatchIO &batchIO, QUdpSocket *socket, int expected)
+    {
+        QElapsedTimer timeout;
+        timeout.start();
+
+        int count = 0;
+        while ((count < expected) && (timeout.elapsed() < 1000)) {
+            const int received = batchIO.receive(socket->socketDescriptor());
+            if (received < 0) {
+                break;
+            }
+            count += received;
+        }
+
+        return count;
+    }
+}
+
+void UdpBatchIOTest::_testSendReceive()
+{
+    if (!UdpBatchIO::isSupported()) {
+        QSKIP("recvmmsg/sendmmsg not available on this platform");
+    }
+
+    QUdpSocket sender;
+    QVERIFY(sender.bind(QHostAddress::LocalHost, 0));
+
+    QList<QUdpSocket*> receivers;
+    const QList<std::shared_ptr<UDPClient>> targets = bindReceivers(receivers, 10, this);
+    QCOMPARE(targets.count(), 10);
+
+    // Fan out crosses a batch boundary
+    UdpBatchIO batchIO(4);
+    const QByteArray payload("\xFD\x09\x00\x00\x00\x01\x01\x00\x00\x00", 10);
+    QCOMPARE(batchIO.send(sender.socketDescriptor(), payload, targets), targets.count());
+
+    for (QUdpSocket *receiver : receivers) {
+        QVERIFY(receiver->waitForReadyRead(1000));
+        const QNetworkDatagram datagram = receiver->receiveDatagram();
+        QCOMPARE(datagram.data(), payload);
+        QCOMPARE(datagram.senderPort(), sender.localPort());
+    }
+
+    // Non IPv4 targets are left to the caller
+    QList<std::shared_ptr<UDPClient>> mixedTargets = targets.mid(0, 2);
+    mixedTargets.insert(1, std::make_shared<UDPClient>(QHostAddress(QHostAddress::LocalHostIPv6), receivers[1]->localPort()));
+    QCOMPARE(batchIO.send(sender.socketDescriptor(), payload, mixedTargets), qsizetype(1));
+    QCOMPARE(drainWithQt(receivers[0], 1), 1);
+
+    // Receive several batches worth, in order, with the sender intact
+    QUdpSocket *const receiver = receivers[2];
+    for (int i = 0; i < 10; i++) {
+        QVERIFY(sender.writeDatagram(QByteArray(1, static_cast<char>(i)) + payload, receiver->localAddress(), receiver->localPort()) > 0);
+    }
+    QVERIFY(receiver->waitForReadyRead(1000));
+
+    int next = 0;
+    QElapsedTimer timeout;
+    timeout.start();
+    while ((next < 10) && (timeout.elapsed() < 1000)) {
+        const int count = batchIO.receive(receiver->socketDescriptor());
+        QVERIFY(count >= 0);
+        QVERIFY(count <= batchIO.batchSize());
+        for (int i = 0; i < count; i++) {
+            const UdpBatchIO::Datagram &datagram = batchIO.datagram(i);
+            QCOMPARE(datagram.size, payload.size() + 1);
+            QCOMPARE(static_cast<int>(datagram.data[0]), next++);
+            QCOMPARE(QByteArray(datagram.data + 1, datagram.size - 1), payload);
+            QCOMPARE(QHostAddress(datagram.senderAddress), sender.localAddress());
+            QCOMPARE(datagram.senderPort, sender.localPort());
+        }
+    }
+    QCOMPARE(next, 10);
+    QCOMPARE(batchIO.receive(receiver->socketDescriptor()), 0);
+}
+
+void UdpBatchIOTest::_testSustainedLoopback()
+{
+    if (!UdpBatchIO::isSupported()) {
+        QSKIP("recvmmsg/sendmmsg not available on this platform");
+    }
+
+    QUdpSocket sender;
+    QVERIFY(sender.bind(QHostAddress::LocalHost, 0));
+
+    QList<QUdpSocket*> receivers;
+    const QList<std::shared_ptr<UDPClient>> targets = bindReceivers(receivers, 16, this);
+    QCOMPARE(targets.count(), 16);
+
+    UdpBatchIO batchIO;
+    const QByteArray payload(64, 'x');
+
+    // Every round sends to every target even once the receive queues are full, the kernel drops what doesn't fit
+    constexpr int fanOutRounds = 200;
+    for (int round = 0; round < fanOutRounds; round++) {
+        QCOMPARE(batchIO.send(sender.socketDescriptor(), payload, targets), targets.count());
+    }
+
+    // Draining round after round gets every datagram, as reading through Qt does
+    QUdpSocket *const receiver = receivers.first();
+    while (receiver->hasPendingDatagrams()) {
+        (void) receiver->receiveDatagram();
+    }
+    while (batchIO.receive(receiver->socketDescriptor()) > 0) {}
+
+    constexpr int receiveRounds = 50;
+    int qtReceived = 0, batchReceived = 0;
+    for (int round = 0; round < receiveRounds; round++) {
+        for (int i = 0; i < kRoundSize; i++) {
+            (void) sender.writeDatagram(payload, receiver->localAddress(), receiver->localPort());
+        }
+        qtReceived += drainWithQt(receiver, kRoundSize);
+
+        for (int i = 0; i < kRoundSize; i++) {
+            (void) sender.writeDatagram(payload, receiver->localAddress(), receiver->localPort());
+        }
+        batchReceived += drainWithBatch(batchIO, receiver, kRoundSize);
+    }
+
+    QCOMPARE(qtReceived, receiveRounds * kRoundSize);
+    QCOMPARE(batchReceived, receiveRounds * kRoundSize);
+}
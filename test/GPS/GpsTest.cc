@@ -15,5 +15,50 @@
 
 void GpsTest::_testGpsRTCM()
 {
+    static constexpr int maxLength = MAVLINK_MSG_GPS_RTCM_DATA_FIELD_DATA_LEN;
 
+    const auto message = [](int length, char fill) {
+        return QByteArray(length, fill);
+    };
+
+    // Whole messages share packets while they fit, in order
+    uint8_t sequenceId = 0;
+    const QList<QByteArray> small = { message(30, 'a'), message(170, 'b'), message(40, 'c'), message(100, 'd') };
+    QList<mavlink_gps_rtcm_data_t> packets = RTCMMavlink::pack(small, sequenceId);
+    QCOMPARE(packets.count(), 3);
+    QCOMPARE(int(packets[0].len), 30);
+    QCOMPARE(int(packets[1].len), 170);
+    QCOMPARE(int(packets[2].len), 140);
+    QCOMPARE(QByteArray(reinterpret_cast<const char*>(packets[2].data), packets[2].len), message(40, 'c') + message(100, 'd'));
+    for (int i = 0; i < packets.count(); i++) {
+        QCOMPARE(packets[i].flags & 0x01U, 0U);
+        QCOMPARE(packets[i].flags >> 3, i);
+    }
+    QCOMPARE(int(sequenceId), 3);
+
+    // A full packet still goes out unfragmented
+    packets = RTCMMavlink::pack({ message(maxLength, 'e') }, sequenceId);
+    QCOMPARE(packets.count(), 1);
+    QCOMPARE(packets[0].flags & 0x01U, 0U);
+
+    // Larger messages are fragmented under one sequence id, after anything packed ahead of them
+    sequenceId = 31;
+    const QByteArray large = message(400, 'f');
+    packets = RTCMMavlink::pack({ message(20, 'g'), large, message(10, 'h') }, sequenceId);
+    QCOMPARE(packets.count(), 5);
+    QCOMPARE(int(packets[0].len), 20);
+    QByteArray reassembled;
+    for (int i = 1; i <= 3; i++) {
+        QCOMPARE(packets[i].flags & 0x01U, 1U);
+        QCOMPARE((packets[i].flags >> 1) & 0x03U, uint(i - 1));
+        QCOMPARE(packets[i].flags >> 3, 0);
+        reassembled.append(reinterpret_cast<const char*>(packets[i].data), packets[i].len);
+    }
+    QCOMPARE(reassembled, large);
+    QCOMPARE(int(packets[4].len), 10);
+    QCOMPARE(packets[4].flags >> 3, 1);
+
+    // Too large for the two bit fragment id
+    packets = RTCMMavlink::pack({ message((RTCMMavlink::kMaxFragments * maxLength) + 1, 'i') }, sequenceId);
+    QVERIFY(packets.isEmpty());
 }
@@ -0,0 +1,131 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "JoystickSDLTest.h"
+#include "JoystickSDL.h"
+#include "JoystickManager.h"
+
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+#include <SDL.h>
+
+static constexpr int kAxisCount = 4;
+static constexpr int kButtonCount = 4;
+
+void JoystickSDLTest::init()
+{
+    UnitTest::init();
+
+    QVERIFY(JoystickSDL::init());
+
+    _deviceIndex = SDL_JoystickAttachVirtual(SDL_JOYSTICK_TYPE_UNKNOWN, kAxisCount, kButtonCount, 0);
+    QVERIFY2(_deviceIndex >= 0, SDL_GetError());
+}
+
+void JoystickSDLTest::cleanup()
+{
+    if (_deviceIndex >= 0) {
+        (void) SDL_JoystickDetachVirtual(_deviceIndex);
+        _deviceIndex = -1;
+    }
+
+    UnitTest::cleanup();
+}
+
+void JoystickSDLTest::_testInputLatency()
+{
+    SDL_Joystick *const virtualJoystick = SDL_JoystickOpen(_deviceIndex);
+    QVERIFY(virtualJoystick);
+
+    JoystickSDL joystick(QStringLiteral("JoystickSDLTest Latency"), kAxisCount, kButtonCount, 0, _deviceIndex, false);
+
+    // Periodic sends four seconds apart, anything quicker than that must come from the input event
+    joystick.setAxisFrequency(joystick.property("minAxisFrequencyHz").toFloat());
+
+    QList<int> axis0Values;
+    (void) connect(&joystick, &Joystick::rawAxisValueChanged, this, [&axis0Values](int index, int value) {
+        if (index == 0) {
+            axis0Values.append(value);
+        }
+    });
+
+    joystick.startPolling(nullptr);
+
+    // The first periodic send goes out right away
+    QTRY_VERIFY_WITH_TIMEOUT(!axis0Values.isEmpty(), 5000);
+
+    QCOMPARE(SDL_JoystickSetVirtualAxis(virtualJoystick, 0, 20000), 0);
+    QTRY_VERIFY_WITH_TIMEOUT(joystick.inputStats()[QStringLiteral("inputSends")].toULongLong() >= 1, 5000);
+
+    // The input was sent on its own, ahead of the deadline for the second periodic send
+    const QVariantMap stats = joystick.inputStats();
+    QCOMPARE(stats[QStringLiteral("inputSendsAhead")].toULongLong(), stats[QStringLiteral("inputSends")].toULongLong());
+    QTRY_VERIFY_WITH_TIMEOUT(axis0Values.contains(20000), 5000);
+
+    joystick.resetInputStats();
+    QCOMPARE(joystick.inputStats()[QStringLiteral("inputSends")].toULongLong(), 0ULL);
+
+    joystick.stopPolling();
+    joystick.stop();
+    SDL_JoystickClose(virtualJoystick);
+}
+
+void JoystickSDLTest::_testPeriodicSends()
+{
+    JoystickSDL joystick(QStringLiteral("JoystickSDLTest Periodic"), kAxisCount, kButtonCount, 0, _deviceIndex, false);
+    joystick.setAxisFrequency(50.0f);
+
+    int axis0Count = 0;
+    (void) connect(&joystick, &Joystick::rawAxisValueChanged, this, [&axis0Count](int index, int) {
+        if (index == 0) {
+            axis0Count++;
+        }
+    });
+
+    joystick.startPolling(nullptr);
+    QTRY_VERIFY_WITH_TIMEOUT(joystick.inputStats()[QStringLiteral("periodicSends")].toULongLong() >= 20, 5000);
+    joystick.stopPolling();
+    joystick.stop();
+    QCoreApplication::processEvents();
+
+    // Without input every send is a periodic one
+    const QVariantMap stats = joystick.inputStats();
+    QCOMPARE(stats[QStringLiteral("inputSends")].toULongLong(), 0ULL);
+    QCOMPARE(static_cast<qulonglong>(axis0Count), stats[QStringLiteral("periodicSends")].toULongLong());
+}
+
+void JoystickSDLTest::_testDeviceEvents()
+{
+    JoystickSDL joystick(QStringLiteral("JoystickSDLTest Devices"), kAxisCount, kButtonCount, 0, _deviceIndex, false);
+    joystick.setAxisFrequency(50.0f);
+
+    int axis0Count = 0;
+    (void) connect(&joystick, &Joystick::rawAxisValueChanged, this, [&axis0Count](int index, int) {
+        if (index == 0) {
+            axis0Count++;
+        }
+    });
+
+    joystick.startPolling(nullptr);
+    QTRY_VERIFY_WITH_TIMEOUT(axis0Count > 0, 1000);
+
+    // The polling thread owns the event queue, device changes must still reach JoystickManager
+    QSignalSpy updateSpy(JoystickManager::instance(), &JoystickManager::updateAvailableJoysticksSignal);
+    const int deviceIndex = SDL_JoystickAttachVirtual(SDL_JOYSTICK_TYPE_UNKNOWN, kAxisCount, kButtonCount, 0);
+    QVERIFY2(deviceIndex >= 0, SDL_GetError());
+    QTRY_VERIFY_WITH_TIMEOUT(updateSpy.count() >= 1, 1000);
+
+    updateSpy.clear();
+    QCOMPARE(SDL_JoystickDetachVirtual(deviceIndex), 0);
+    QTRY_VERIFY_WITH_TIMEOUT(updateSpy.count() >= 1, 1000);
+
+    joystick.stopPolling();
+    joystick.stop();
+}
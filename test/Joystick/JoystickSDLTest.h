@@ -0,0 +1,29 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+/// Drives JoystickSDL polling with an SDL virtual joystick
+class JoystickSDLTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void init() final;
+    void cleanup() final;
+
+    void _testInputLatency();
+    void _testPeriodicSends();
+    void _testDeviceEvents();
+
+private:
+    int _deviceIndex = -1;
+};
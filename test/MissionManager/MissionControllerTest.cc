@@ -19,6 +19,7 @@
 #include "MultiSignalSpy.h"
 
 #include <QtTest/QTest>
+#include <QtTest/QSignalSpy>
 
 MissionControllerTest::MissionControllerTest(void)
 {
@@ -232,6 +233,57 @@ void MissionControllerTest::_testVehicleYawRecalc(void)
     }
 }
 
+void MissionControllerTest::_testIncrementalRecalc(void)
+{
+    _initForFirmwareType(MAV_AUTOPILOT_PX4);
+
+    const int cMissionItems = 10;
+    QGeoCoordinate currentCoord(47.3764, 8.5481);
+    for (int i=1; i<=cMissionItems; i++) {
+        _missionController->insertSimpleMissionItem(currentCoord, i);
+        currentCoord = currentCoord.atDistanceAndAzimuth(100, 90);
+    }
+
+    QTest::qWait(100); // Recalcs in MissionController are queued to remove dups. Allow return to main message loop.
+
+    QmlObjectListModel* visualItems = _missionController->visualItems();
+    QmlObjectListModel* simpleFlightPathSegments = _missionController->simpleFlightPathSegments();
+    QCOMPARE(simpleFlightPathSegments->count(), cMissionItems - 1);
+
+    // Editing a single item should only produce row level model changes
+    QSignalSpy resetSpy(simpleFlightPathSegments, &QAbstractItemModel::modelReset);
+    QObject* firstSegment = simpleFlightPathSegments->get(0);
+
+    const int movedIndex = 5;
+    VisualMissionItem* movedItem = visualItems->value<VisualMissionItem*>(movedIndex);
+    movedItem->setCoordinate(movedItem->coordinate().atDistanceAndAzimuth(250, 0));
+    QTest::qWait(100);
+
+    QCOMPARE(resetSpy.count(), 0);
+    QCOMPARE(simpleFlightPathSegments->count(), cMissionItems - 1);
+    QCOMPARE(simpleFlightPathSegments->get(0), firstSegment);
+
+    // Cumulative values after the edited item must match a walk of the whole mission
+    double totalDistance = 0;
+    for (int i=2; i<visualItems->count(); i++) {
+        VisualMissionItem* prevItem = visualItems->value<VisualMissionItem*>(i - 1);
+        VisualMissionItem* item = visualItems->value<VisualMissionItem*>(i);
+        const double distance = prevItem->exitCoordinate().distanceTo(item->coordinate());
+        totalDistance += distance;
+        QVERIFY(qAbs(item->distance() - distance) < 0.01);
+        QVERIFY(qAbs(item->distanceFromStart() - totalDistance) < 0.01);
+    }
+    QVERIFY(qAbs(_missionController->missionTotalDistance() - totalDistance) < 0.01);
+
+    // Removing an item replaces the segments adjacent to it without a reset
+    _missionController->removeVisualItem(movedIndex);
+    QTest::qWait(100);
+
+    QCOMPARE(resetSpy.count(), 0);
+    QCOMPARE(simpleFlightPathSegments->count(), cMissionItems - 2);
+    QCOMPARE(simpleFlightPathSegments->get(0), firstSegment);
+}
+
 void MissionControllerTest::_testLoadJsonSectionAvailable(void)
 {
     _initForFirmwareType(MAV_AUTOPILOT_PX4);
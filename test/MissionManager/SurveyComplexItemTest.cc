@@ -10,9 +10,16 @@
 #include "SurveyComplexItemTest.h"
 #include "SurveyComplexItem.h"
 #include "PlanViewSettings.h"
+#include "SettingsManager.h"
 #include "MultiSignalSpy.h"
 
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QTextStream>
 #include <QtTest/QTest>
+#include <QtTest/QSignalSpy>
 
 SurveyComplexItemTest::SurveyComplexItemTest(void)
 {
@@ -357,3 +364,153 @@ void SurveyComplexItemTest::_testHoverCaptureItemGeneration(void)
     _testItemGenerationWorker(false /* imagesInTurnaround */, true /* hasTurnaround */, true /* useConditionGate */, expectedCommands);
     _testItemGenerationWorker(false /* imagesInTurnaround */, true /* hasTurnaround */, false /* useConditionGate */, expectedCommands);
 }
+
+void SurveyComplexItemTest::_testBackgroundTransects(void)
+{
+    // Large many sided polygon with tight spacing is expensive enough to be generated on a worker thread
+    QList<QGeoCoordinate> rgCircleVertices;
+    for (int i=0; i<64; i++) {
+        rgCircleVertices.append(_polyVertices[0].atDistanceAndAzimuth(5000, i * (360.0 / 64)));
+    }
+    _mapPolygon->clear();
+    _mapPolygon->appendVertices(rgCircleVertices);
+    int cheapTransectCount = _surveyItem->_transectCount();
+    QVERIFY(cheapTransectCount > 0);
+
+    QSignalSpy visualTransectPointsSpy(_surveyItem, &SurveyComplexItem::visualTransectPointsChanged);
+
+    // Previous result stays published until the job completes
+    _surveyItem->cameraCalc()->adjustedFootprintSide()->setRawValue(2);
+    QCOMPARE(_surveyItem->_transectCount(), cheapTransectCount);
+    QCOMPARE(visualTransectPointsSpy.count(), 0);
+    QVERIFY(visualTransectPointsSpy.wait(10000));
+    int expensiveTransectCount = _surveyItem->_transectCount();
+    QVERIFY(expensiveTransectCount > 1000);
+
+    // A job superseded before it completes is discarded, only the newest result is published
+    visualTransectPointsSpy.clear();
+    _surveyItem->cameraCalc()->adjustedFootprintSide()->setRawValue(3);
+    _surveyItem->gridAngle()->setRawValue(45);
+    QVERIFY(visualTransectPointsSpy.wait(10000));
+    QTest::qWait(100);
+    QCOMPARE(visualTransectPointsSpy.count(), 1);
+    QVERIFY(_surveyItem->_transectCount() < expensiveTransectCount);
+    QVariantList gridPoints = _surveyItem->visualTransectPoints();
+    double azimuth = gridPoints[0].value<QGeoCoordinate>().azimuthTo(gridPoints[1].value<QGeoCoordinate>());
+    QCOMPARE(qRound(_clampGridAngle180(azimuth)), 45);
+
+    // Mission item generation waits for an in flight job
+    visualTransectPointsSpy.clear();
+    _surveyItem->cameraCalc()->adjustedFootprintSide()->setRawValue(2);
+    QList<MissionItem*> items;
+    QObject* missionItemParent = new QObject(this);
+    _surveyItem->appendMissionItems(items, missionItemParent);
+    QVERIFY(_surveyItem->_transectCount() > 1000);
+    QCOMPARE(visualTransectPointsSpy.count(), 1);
+    QTest::qWait(100);
+    QCOMPARE(visualTransectPointsSpy.count(), 1);
+    missionItemParent->deleteLater();
+
+    // Saving right after a geometry change, without spinning the event loop, saves the new transects
+    visualTransectPointsSpy.clear();
+    _surveyItem->cameraCalc()->adjustedFootprintSide()->setRawValue(3);
+    QCOMPARE(visualTransectPointsSpy.count(), 0);
+    QJsonArray planItems;
+    _surveyItem->save(planItems);
+    QCOMPARE(visualTransectPointsSpy.count(), 1);
+    const int savedTransectCount = _surveyItem->_transectCount();
+    QVERIFY(savedTransectCount < expensiveTransectCount);
+    QCOMPARE(planItems.count(), 1);
+    const QJsonObject transectStyleObject = planItems[0].toObject()[QStringLiteral("TransectStyleComplexItem")].toObject();
+    QCOMPARE(transectStyleObject[QStringLiteral("CameraShots")].toInt(), _surveyItem->cameraShots());
+    QCOMPARE(transectStyleObject[QStringLiteral("VisualTransectPoints")].toArray().count(), _surveyItem->visualTransectPoints().count());
+}
+
+void SurveyComplexItemTest::_testSplitConcavePolygon(void)
+{
+    // C shaped field opening to the east: north/south scan lines through the arms cross the polygon twice
+    const QGeoCoordinate southWest = _polyVertices[0].atDistanceAndAzimuth(200, 180);
+    auto offset = [&southWest](double east, double north) {
+        return southWest.atDistanceAndAzimuth(east, 90).atDistanceAndAzimuth(north, 0);
+    };
+    _mapPolygon->clear();
+    _mapPolygon->appendVertices(QList<QGeoCoordinate>({
+        offset(0, 200), offset(200, 200), offset(200, 140), offset(60, 140),
+        offset(60, 60), offset(200, 60), offset(200, 0), offset(0, 0)
+    }));
+    _surveyItem->gridAngle()->setRawValue(0);
+    _surveyItem->cameraCalc()->adjustedFootprintSide()->setRawValue(20);
+
+    // Transect entry and exit only, so the visual points pair up
+    _surveyItem->turnAroundDistance()->setRawValue(0);
+    _surveyItem->hoverAndCapture()->setRawValue(false);
+
+    MissionController::MissionFlightStatus_t missionFlightStatus;
+    missionFlightStatus.vtolMode        = false;
+    missionFlightStatus.vehicleSpeed    = 10;
+    missionFlightStatus.gimbalYaw       = qQNaN();
+    missionFlightStatus.gimbalPitch     = qQNaN();
+    _surveyItem->setMissionFlightStatus(missionFlightStatus);
+
+    // Whole scan lines keep the lawnmower order, there is nothing to optimize
+    QVERIFY(!_surveyItem->splitConcavePolygons()->rawValue().toBool());
+    const int scanLineCount = _surveyItem->_transectCount();
+    QVERIFY(scanLineCount > 2);
+    QCOMPARE(_surveyItem->routeTimeSaved(), 0.);
+
+    // Lines through the arms are split in two, and the route then does one arm after the other rather than
+    // crossing the gap on every line
+    _surveyItem->splitConcavePolygons()->setRawValue(true);
+    QVERIFY(_surveyItem->_transectCount() > scanLineCount);
+    QVERIFY(_surveyItem->routeTimeSaved() > 0);
+
+    // No transect flies over the gap between the arms
+    const QVariantList gridPoints = _surveyItem->visualTransectPoints();
+    const QGeoCoordinate gapCenter = offset(130, 100);
+    for (int i=0; i+1<gridPoints.count(); i+=2) {
+        const QGeoCoordinate entry = gridPoints[i].value<QGeoCoordinate>();
+        const QGeoCoordinate exit = gridPoints[i + 1].value<QGeoCoordinate>();
+        const double eastOfGapStart = southWest.distanceTo(QGeoCoordinate(southWest.latitude(), entry.longitude()));
+        if (eastOfGapStart > 65) {
+            const bool spansGap = (qMin(entry.latitude(), exit.latitude()) < gapCenter.latitude()) && (qMax(entry.latitude(), exit.latitude()) > gapCenter.latitude());
+            QVERIFY(!spansGap);
+        }
+    }
+}
+
+void SurveyComplexItemTest::_testLoadSimplifiedShape(void)
+{
+    // Densely sampled 500m circle, as exported by most GIS tools
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString kmlFile = tmpDir.filePath(QStringLiteral("circle.kml"));
+    constexpr int vertexCount = 200;
+    {
+        QFile file(kmlFile);
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+        QTextStream stream(&file);
+        stream << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+               << "<kml xmlns=\"http://www.opengis.net/kml/2.2\"><Document><Placemark><Polygon><outerBoundaryIs><LinearRing><coordinates>\n";
+        stream.setRealNumberPrecision(12);
+        for (int i = 0; i < vertexCount; i++) {
+            const QGeoCoordinate coord = _polyVertices[0].atDistanceAndAzimuth(500, (360.0 * i) / vertexCount);
+            stream << coord.longitude() << ',' << coord.latitude() << ",0 ";
+        }
+        stream << "\n</coordinates></LinearRing></outerBoundaryIs></Polygon></Placemark></Document></kml>\n";
+    }
+
+    Fact* const toleranceFact = SettingsManager::instance()->planViewSettings()->shapeSimplifyTolerance();
+    const QVariant savedTolerance = toleranceFact->rawValue();
+
+    toleranceFact->setRawValue(0);
+    SurveyComplexItem fullItem(_masterController, false /* flyView */, kmlFile);
+    QCOMPARE(fullItem.surveyAreaPolygon()->count(), vertexCount);
+
+    // The survey created from the file uses the import tolerance from the settings
+    toleranceFact->setRawValue(5);
+    SurveyComplexItem simplifiedItem(_masterController, false /* flyView */, kmlFile);
+    QVERIFY(simplifiedItem.surveyAreaPolygon()->count() >= 3);
+    QVERIFY(simplifiedItem.surveyAreaPolygon()->count() < vertexCount / 2);
+
+    toleranceFact->setRawValue(savedTolerance);
+}
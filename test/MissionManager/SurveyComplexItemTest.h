@@ -37,6 +37,9 @@ private slots:
     void _testItemGeneration(void);
     void _testItemCount(void);
     void _testHoverCaptureItemGeneration(void);
+    void _testBackgroundTransects(void);
+    void _testSplitConcavePolygon(void);
+    void _testLoadSimplifiedShape(void);
 #else
     // Handy mechanism to to a single test
 private slots:
@@ -47,6 +50,9 @@ private slots:
     void _testEntryLocation(void);
     void _testItemGeneration(void);
     void _testHoverCaptureItemGeneration(void);
+    void _testBackgroundTransects(void);
+    void _testSplitConcavePolygon(void);
+    void _testLoadSimplifiedShape(void);
 #endif
 
 private:
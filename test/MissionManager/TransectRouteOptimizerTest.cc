@@ -0,0 +1,224 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TransectRouteOptimizerTest.h"
+#include "TransectRouteOptimizer.h"
+#include "ShapeFileHelper.h"
+#include "QGCGeo.h"
+
+#include <QtCore/QRandomGenerator>
+#include <QtCore/QTemporaryDir>
+#include <QtGui/QPolygonF>
+#include <QtGui/QTransform>
+#include <QtTest/QTest>
+
+#include <algorithm>
+#include <limits>
+
+QString TransectRouteOptimizerTest::_copyRes(const QTemporaryDir& tmpDir, const QString& name)
+{
+    const QString dstPath = tmpDir.filePath(name);
+    (void) QFile::remove(dstPath);
+    const QString resPath = QStringLiteral(":/unittest/%1").arg(name);
+    (void) QFile(resPath).copy(dstPath);
+    return dstPath;
+}
+
+/// Each transect must be used exactly once and the first one must stay in place when fixFirst is used
+void TransectRouteOptimizerTest::_verifyRoute(const QList<QLineF>& transects, const QList<int>& order, const QList<bool>& reversed)
+{
+    QCOMPARE(order.count(), transects.count());
+    QCOMPARE(reversed.count(), transects.count());
+    QCOMPARE(order[0], 0);
+    QCOMPARE(reversed[0], false);
+
+    QList<int> sortedOrder = order;
+    std::sort(sortedOrder.begin(), sortedOrder.end());
+    for (int i=0; i<sortedOrder.count(); i++) {
+        QCOMPARE(sortedOrder[i], i);
+    }
+}
+
+/// Builds transects the way a concave polygon split into convex pieces would be flown: every scan line is cut
+/// into one transect per pass through the polygon interior. Transects are returned in naive scan line order.
+QList<QLineF> TransectRouteOptimizerTest::_splitPolygonTransects(const QList<QGeoCoordinate>& vertices, double gridSpacing, double gridAngle)
+{
+    QPolygonF polygon;
+    for (const QGeoCoordinate& vertex: vertices) {
+        double y, x, down;
+        QGCGeo::convertGeoToNed(vertex, vertices[0], y, x, down);
+        polygon << QPointF(x, y);
+    }
+
+    // Rotate so scan lines run along the y axis
+    QTransform rotate;
+    rotate.rotate(-gridAngle);
+    polygon = rotate.map(polygon);
+    polygon << polygon.first();
+
+    QList<QLineF>   transects;
+    QRectF          boundingRect    = polygon.boundingRect();
+    bool            reverse         = false;
+    for (double x=boundingRect.left() + (gridSpacing / 2.0); x<boundingRect.right(); x+=gridSpacing) {
+        QLineF scanLine(x, boundingRect.top() - 1, x, boundingRect.bottom() + 1);
+
+        QList<double> crossings;
+        for (int i=0; i<polygon.count() - 1; i++) {
+            QPointF intersection;
+            if (scanLine.intersects(QLineF(polygon[i], polygon[i + 1]), &intersection) == QLineF::BoundedIntersection) {
+                crossings.append(intersection.y());
+            }
+        }
+        std::sort(crossings.begin(), crossings.end());
+
+        QList<QLineF> lineTransects;
+        for (int i=0; i + 1<crossings.count(); i+=2) {
+            lineTransects.append(QLineF(x, crossings[i], x, crossings[i + 1]));
+        }
+        if (reverse) {
+            std::reverse(lineTransects.begin(), lineTransects.end());
+            for (QLineF& transect: lineTransects) {
+                transect = QLineF(transect.p2(), transect.p1());
+            }
+        }
+        reverse = !reverse;
+        transects.append(lineTransects);
+    }
+
+    return transects;
+}
+
+void TransectRouteOptimizerTest::_testScrambledLawnmower(void)
+{
+    // Parallel transects 10m apart, scrambled and randomly flipped. Perfect order has 10m between each transect.
+    const int cTransects = 50;
+    QList<QLineF> transects;
+    for (int i=0; i<cTransects; i++) {
+        transects.append(QLineF(i * 10, 0, i * 10, 500));
+    }
+    QRandomGenerator random(1234);
+    std::shuffle(transects.begin() + 1, transects.end(), random);
+    for (int i=1; i<cTransects; i++) {
+        if (random.bounded(2)) {
+            transects[i] = QLineF(transects[i].p2(), transects[i].p1());
+        }
+    }
+
+    TransectRouteOptimizer::Result_t result = TransectRouteOptimizer::optimize(transects, true /* fixFirst */, std::numeric_limits<qint64>::max());
+    _verifyRoute(transects, result.order, result.reversed);
+    QVERIFY(!result.stopped);
+    QCOMPARE(result.optimizedTransit, TransectRouteOptimizer::transitDistance(transects, result.order, result.reversed));
+    QVERIFY(result.optimizedTransit < result.initialTransit / 5);
+    QVERIFY(result.optimizedTransit < (cTransects - 1) * 10 * 3);
+}
+
+void TransectRouteOptimizerTest::_testLawnmowerUnchanged(void)
+{
+    QList<QLineF> transects;
+    for (int i=0; i<20; i++) {
+        QLineF transect(i * 10, 0, i * 10, 500);
+        transects.append(i & 1 ? QLineF(transect.p2(), transect.p1()) : transect);
+    }
+
+    TransectRouteOptimizer::Result_t result = TransectRouteOptimizer::optimize(transects, true /* fixFirst */, std::numeric_limits<qint64>::max());
+    QCOMPARE(result.optimizedTransit, result.initialTransit);
+    for (int i=0; i<transects.count(); i++) {
+        QCOMPARE(result.order[i], i);
+        QCOMPARE(result.reversed[i], false);
+    }
+}
+
+void TransectRouteOptimizerTest::_testEvaluationBudget(void)
+{
+    QList<QLineF> transects;
+    QRandomGenerator random(4321);
+    for (int i=0; i<3000; i++) {
+        QPointF p1(random.bounded(10000.0), random.bounded(10000.0));
+        transects.append(QLineF(p1, p1 + QPointF(random.bounded(200.0), random.bounded(200.0))));
+    }
+
+    const qint64 maxEvaluations = 100000;
+    TransectRouteOptimizer::Result_t result = TransectRouteOptimizer::optimize(transects, true /* fixFirst */, maxEvaluations);
+    _verifyRoute(transects, result.order, result.reversed);
+    QVERIFY(result.stopped);
+    QCOMPARE(result.evaluations, maxEvaluations);
+    QVERIFY(result.optimizedTransit < result.initialTransit);
+
+    // The budget doesn't depend on the machine, the same input gives the same route every time
+    const TransectRouteOptimizer::Result_t repeat = TransectRouteOptimizer::optimize(transects, true /* fixFirst */, maxEvaluations);
+    QCOMPARE(repeat.order, result.order);
+    QCOMPARE(repeat.reversed, result.reversed);
+    QCOMPARE(repeat.optimizedTransit, result.optimizedTransit);
+
+    // A larger budget carries on from the same point, so it can only do better
+    const TransectRouteOptimizer::Result_t larger = TransectRouteOptimizer::optimize(transects, true /* fixFirst */, maxEvaluations * 10);
+    QVERIFY(larger.optimizedTransit <= result.optimizedTransit);
+
+    // Cancellation stops the search as well
+    result = TransectRouteOptimizer::optimize(transects, true /* fixFirst */, std::numeric_limits<qint64>::max(), []() { return true; });
+    QVERIFY(result.stopped);
+    QCOMPARE(result.evaluations, qint64(0));
+    QCOMPARE(result.passes, 0);
+}
+
+void TransectRouteOptimizerTest::_testRealWorldPolygons(void)
+{
+    const QTemporaryDir tmpDir;
+    const QStringList rgShapeNames = { "SarahsFarm", "MP19", "MPBonus" };
+
+    QList<QPair<QString, QList<QGeoCoordinate>>> rgPolygons;
+    for (const QString& shapeName: rgShapeNames) {
+        const QString shpFile = _copyRes(tmpDir, shapeName + ".shp");
+        (void) _copyRes(tmpDir, shapeName + ".shx");
+        (void) _copyRes(tmpDir, shapeName + ".prj");
+
+        QString errorString;
+        QList<QGeoCoordinate> vertices;
+        QVERIFY2(ShapeFileHelper::loadPolygonFromFile(shpFile, vertices, errorString), qPrintable(errorString));
+        QVERIFY(vertices.count() >= 3);
+        rgPolygons.append(qMakePair(shapeName, vertices));
+    }
+
+    // Strongly concave comb shaped field, typical of fields split by drainage ditches
+    QList<QGeoCoordinate> combVertices;
+    const QGeoCoordinate combOrigin(47.6335, -122.0898);
+    combVertices.append(combOrigin);
+    for (int tooth=0; tooth<6; tooth++) {
+        QGeoCoordinate toothBase = combOrigin.atDistanceAndAzimuth(tooth * 100, 90);
+        combVertices.append(toothBase.atDistanceAndAzimuth(400, 0));
+        combVertices.append(toothBase.atDistanceAndAzimuth(400, 0).atDistanceAndAzimuth(60, 90));
+        combVertices.append(toothBase.atDistanceAndAzimuth(60, 90).atDistanceAndAzimuth(50, 0));
+        combVertices.append(toothBase.atDistanceAndAzimuth(100, 90).atDistanceAndAzimuth(50, 0));
+    }
+    combVertices.append(combOrigin.atDistanceAndAzimuth(600, 90));
+    rgPolygons.append(qMakePair(QStringLiteral("Comb"), combVertices));
+
+    double bestCombSavedPercent = 0;
+    for (const auto& polygon: rgPolygons) {
+        for (double gridAngle: { 0.0, 45.0, 90.0 }) {
+            QList<QLineF> transects = _splitPolygonTransects(polygon.second, 10, gridAngle);
+            if (transects.count() < 3) {
+                continue;
+            }
+
+            TransectRouteOptimizer::Result_t result = TransectRouteOptimizer::optimize(transects, true /* fixFirst */, 50000000);
+            _verifyRoute(transects, result.order, result.reversed);
+            QVERIFY(result.optimizedTransit <= result.initialTransit);
+
+            double savedPercent = result.initialTransit > 0 ? 100.0 * (result.initialTransit - result.optimizedTransit) / result.initialTransit : 0;
+
+            if (polygon.first == QStringLiteral("Comb")) {
+                bestCombSavedPercent = qMax(bestCombSavedPercent, savedPercent);
+            }
+        }
+    }
+
+    // Scan lines crossing every tooth fly back and forth across the gaps, a good route clears a tooth at a time
+    QVERIFY(bestCombSavedPercent > 25);
+}
@@ -0,0 +1,33 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+#include <QtCore/QLineF>
+#include <QtPositioning/QGeoCoordinate>
+
+class QTemporaryDir;
+
+class TransectRouteOptimizerTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testScrambledLawnmower(void);
+    void _testLawnmowerUnchanged(void);
+    void _testEvaluationBudget(void);
+    void _testRealWorldPolygons(void);
+
+private:
+    static QString          _copyRes                (const QTemporaryDir& tmpDir, const QString& name);
+    static QList<QLineF>    _splitPolygonTransects  (const QList<QGeoCoordinate>& vertices, double gridSpacing, double gridAngle);
+    static void             _verifyRoute            (const QList<QLineF>& transects, const QList<int>& order, const QList<bool>& reversed);
+};
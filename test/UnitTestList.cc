@@ -18,9 +18,10 @@
 #include "ExifParserTest.h"
 // #include "GeoTagControllerTest.h"
 // #include "MavlinkLogTest.h"
+#include "LogColumnStoreTest.h"
 #include "LogDownloadTest.h"
 #include "PX4LogParserTest.h"
-// #include "ULogParserTest.h"
+#include "ULogParserTest.h"
 
 
 
@@ -31,7 +32,10 @@
 #include "QGCCameraManagerTest.h"
 
 // Comms
+#include "LinkWriteQueueTest.h"
+#include "MockSwarmLinkTest.h"
 #include "QGCSerialPortInfoTest.h"
+#include "UdpBatchIOTest.h"
 
 // FactSystem
 #include "FactSystemTestGeneric.h"
@@ -44,6 +48,11 @@
 // GPS
 #include "GpsTest.h"
 
+// Joystick
+#ifdef QGC_SDL_JOYSTICK
+#include "JoystickSDLTest.h"
+#endif
+
 // MAVLink
 #include "StatusTextHandlerTest.h"
 #include "SigningTest.h"
@@ -69,6 +78,7 @@
 #include "SpeedSectionTest.h"
 #include "StructureScanComplexItemTest.h"
 #include "SurveyComplexItemTest.h"
+#include "TransectRouteOptimizerTest.h"
 #include "TransectStyleComplexItemTest.h"
 // #include "VisualMissionItemTest.h"
 
@@ -85,6 +95,7 @@
 // UI
 
 // Utilities
+#include "QGCLoggingTest.h"
 // Audio
 #include "AudioOutputTest.h"
 // Compression
@@ -95,6 +106,14 @@
 #include "GeoTest.h"
 // Shape
 #include "ShapeTest.h"
+// Tracing
+#include "TelemetryTracerTest.h"
+
+// VideoManager
+#include "SubtitleWriterTest.h"
+#ifdef QGC_GST_STREAMING
+#include "GstVideoReceiverTest.h"
+#endif
 
 // Vehicle
 // Components
@@ -103,11 +122,18 @@
 #include "FTPManagerTest.h"
 // #include "InitialConnectTest.h"
 #include "MAVLinkLogManagerTest.h"
+#include "ParameterMetaDataStoreTest.h"
 // #include "RequestMessageTest.h"
 // #include "SendMavCommandWithHandlerTest.h"
 // #include "SendMavCommandWithSignalingTest.h"
+#include "TimerWheelTest.h"
 #include "VehicleLinkManagerTest.h"
 
+// Viewer3D
+#ifdef QGC_VIEWER3D
+#include "Viewer3DTerrainGeometryTest.h"
+#endif
+
 // Missing
 // #include "FlightGearUnitTest.h"
 // #include "LinkManagerTest.h"
@@ -125,9 +151,10 @@ int runTests(bool stress, QStringView unitTestOptions)
     UT_REGISTER_TEST(ExifParserTest)
     // UT_REGISTER_TEST(GeoTagControllerTest)
     // UT_REGISTER_TEST(MavlinkLogTest)
+    UT_REGISTER_TEST(LogColumnStoreTest)
     UT_REGISTER_TEST(LogDownloadTest)
     UT_REGISTER_TEST(PX4LogParserTest)
-    // UT_REGISTER_TEST(ULogParserTest)
+    UT_REGISTER_TEST(ULogParserTest)
 
     // AutoPilotPlugins
     // UT_REGISTER_TEST(RadioConfigTest)
@@ -136,7 +163,10 @@ int runTests(bool stress, QStringView unitTestOptions)
     UT_REGISTER_TEST(QGCCameraManagerTest)
 
     // Comms
+    UT_REGISTER_TEST(LinkWriteQueueTest)
+    UT_REGISTER_TEST(MockSwarmLinkTest)
     UT_REGISTER_TEST(QGCSerialPortInfoTest)
+    UT_REGISTER_TEST(UdpBatchIOTest)
 
     // FactSystem
     UT_REGISTER_TEST(FactSystemTestGeneric)
@@ -147,7 +177,12 @@ int runTests(bool stress, QStringView unitTestOptions)
     UT_REGISTER_TEST(FollowMeTest)
 
     // GPS
-    // UT_REGISTER_TEST(GpsTest)
+    UT_REGISTER_TEST(GpsTest)
+
+    // Joystick
+#ifdef QGC_SDL_JOYSTICK
+    UT_REGISTER_TEST(JoystickSDLTest)
+#endif
 
     // MAVLink
     UT_REGISTER_TEST(StatusTextHandlerTest)
@@ -174,6 +209,7 @@ int runTests(bool stress, QStringView unitTestOptions)
     UT_REGISTER_TEST(SpeedSectionTest)
     UT_REGISTER_TEST(StructureScanComplexItemTest)
     UT_REGISTER_TEST(SurveyComplexItemTest)
+    UT_REGISTER_TEST(TransectRouteOptimizerTest)
     UT_REGISTER_TEST(TransectStyleComplexItemTest)
     // UT_REGISTER_TEST(VisualMissionItemTest)
 
@@ -188,6 +224,7 @@ int runTests(bool stress, QStringView unitTestOptions)
     // UI
 
     // Utilities
+    UT_REGISTER_TEST(QGCLoggingTest)
     // Audio
     UT_REGISTER_TEST(AudioOutputTest)
     // Compression
@@ -198,6 +235,14 @@ int runTests(bool stress, QStringView unitTestOptions)
     UT_REGISTER_TEST(GeoTest)
     // Shape
     UT_REGISTER_TEST(ShapeTest)
+    // Tracing
+    UT_REGISTER_TEST(TelemetryTracerTest)
+
+    // VideoManager
+    UT_REGISTER_TEST(SubtitleWriterTest)
+#ifdef QGC_GST_STREAMING
+    UT_REGISTER_TEST(GstVideoReceiverTest)
+#endif
 
     // Vehicle
     // Components
@@ -206,11 +251,18 @@ int runTests(bool stress, QStringView unitTestOptions)
     UT_REGISTER_TEST(FTPManagerTest)
     // UT_REGISTER_TEST(InitialConnectTest)
     UT_REGISTER_TEST(MAVLinkLogManagerTest)
+    UT_REGISTER_TEST(ParameterMetaDataStoreTest)
     // UT_REGISTER_TEST(RequestMessageTest)
     // UT_REGISTER_TEST(SendMavCommandWithHandlerTest)
     // UT_REGISTER_TEST(SendMavCommandWithSignalingTest)
+    UT_REGISTER_TEST(TimerWheelTest)
     UT_REGISTER_TEST(VehicleLinkManagerTest)
 
+    // Viewer3D
+#ifdef QGC_VIEWER3D
+    UT_REGISTER_TEST(Viewer3DTerrainGeometryTest)
+#endif
+
     // Missing
     // UT_REGISTER_TEST(FlightGearUnitTest)
     // UT_REGISTER_TEST(LinkManagerTest)
@@ -16,6 +16,7 @@
 #include "GeoTest.h"
 #include "QGCGeo.h"
 
+#include <QtCore/QRandomGenerator>
 #include <QtTest/QTest>
 
 static bool compareDoubles(double actual, double expected, double epsilon = 0.00001)
@@ -23,6 +24,22 @@ static bool compareDoubles(double actual, double expected, double epsilon = 0.00
     return (qAbs(actual - expected) <= epsilon);
 }
 
+/// Random points within roughly 50km of the origin
+static QGCGeo::CoordinateArrays randomCoordinates(const QGeoCoordinate &origin, size_t count)
+{
+    QRandomGenerator random(1234);
+
+    QGCGeo::CoordinateArrays coords;
+    coords.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        coords.latitudes[i] = origin.latitude() + random.bounded(1.0) - 0.5;
+        coords.longitudes[i] = origin.longitude() + random.bounded(1.0) - 0.5;
+        coords.altitudes[i] = random.bounded(500.0);
+    }
+
+    return coords;
+}
+
 void GeoTest::_convertGeoToNed_test()
 {
     const QGeoCoordinate coord(47.364869, 8.594398, 0.0);
@@ -138,3 +155,74 @@ void GeoTest::_convertMGRSToGeo_test()
     QVERIFY(compareDoubles(coord.longitude(), m_origin.longitude()));
     QVERIFY(compareDoubles(coord.altitude(), m_origin.altitude()));
 }
+
+void GeoTest::_batchConversions_test()
+{
+    constexpr size_t count = 1000;
+    QGCGeo::CoordinateArrays coords = randomCoordinates(m_origin, count);
+
+    // Include the origin itself, which the scalar version special cases
+    coords.latitudes[0] = m_origin.latitude();
+    coords.longitudes[0] = m_origin.longitude();
+    coords.altitudes[0] = m_origin.altitude();
+
+    std::vector<double> x(count), y(count), z(count);
+    QGCGeo::convertGeoToNed(coords.latitudes, coords.longitudes, coords.altitudes, m_origin, x, y, z);
+
+    QGCGeo::CoordinateArrays roundTrip;
+    roundTrip.resize(count);
+    QGCGeo::convertNedToGeo(x, y, z, m_origin, roundTrip.latitudes, roundTrip.longitudes, roundTrip.altitudes);
+
+    std::vector<double> eastings(count), northings(count);
+    const int zone = QGCGeo::convertGeoToUTM(coords.latitudes, coords.longitudes, eastings, northings);
+    QCOMPARE(zone, 32);
+
+    const QList<QGeoCoordinate> geoCoords = coords.toCoordinates();
+    for (size_t i = 0; i < count; i++) {
+        double scalarX, scalarY, scalarZ;
+        QGCGeo::convertGeoToNed(geoCoords[i], m_origin, scalarX, scalarY, scalarZ);
+        QVERIFY(compareDoubles(x[i], scalarX, 1e-6));
+        QVERIFY(compareDoubles(y[i], scalarY, 1e-6));
+        QVERIFY(compareDoubles(z[i], scalarZ, 1e-6));
+
+        QGeoCoordinate scalarCoord;
+        QGCGeo::convertNedToGeo(scalarX, scalarY, scalarZ, m_origin, scalarCoord);
+        QVERIFY(compareDoubles(roundTrip.latitudes[i], scalarCoord.latitude(), 1e-9));
+        QVERIFY(compareDoubles(roundTrip.longitudes[i], scalarCoord.longitude(), 1e-9));
+        QVERIFY(compareDoubles(roundTrip.altitudes[i], scalarCoord.altitude(), 1e-6));
+        QVERIFY(compareDoubles(roundTrip.latitudes[i], coords.latitudes[i], 1e-9));
+        QVERIFY(compareDoubles(roundTrip.longitudes[i], coords.longitudes[i], 1e-9));
+
+        double scalarEasting, scalarNorthing;
+        QCOMPARE(QGCGeo::convertGeoToUTM(geoCoords[i], scalarEasting, scalarNorthing), zone);
+        QVERIFY(compareDoubles(eastings[i], scalarEasting, 1e-6));
+        QVERIFY(compareDoubles(northings[i], scalarNorthing, 1e-6));
+    }
+
+    // Points across the equator are kept in the hemisphere of the first point
+    const std::vector<double> latitudes = { 0.001, -0.001 };
+    const std::vector<double> longitudes = { 9.0, 9.0 };
+    QCOMPARE(QGCGeo::convertGeoToUTM(latitudes, longitudes, std::span<double>(eastings).first(2), std::span<double>(northings).first(2)), 32);
+    QVERIFY(northings[0] > 0.);
+    QVERIFY(northings[1] < 0.);
+    QVERIFY(compareDoubles(northings[0] - northings[1], 221.1, 0.5));
+}
+
+void GeoTest::_batchHaversine_test()
+{
+    constexpr size_t count = 1000;
+    const QGCGeo::CoordinateArrays from = randomCoordinates(m_origin, count);
+    const QGCGeo::CoordinateArrays to = randomCoordinates(QGeoCoordinate(-33.8688, 151.2093), count);
+
+    std::vector<double> distances(count), azimuths(count);
+    QGCGeo::haversineDistance(from.latitudes, from.longitudes, to.latitudes, to.longitudes, distances);
+    QGCGeo::haversineAzimuth(from.latitudes, from.longitudes, to.latitudes, to.longitudes, azimuths);
+
+    for (size_t i = 0; i < count; i++) {
+        const QGeoCoordinate fromCoord(from.latitudes[i], from.longitudes[i]);
+        const QGeoCoordinate toCoord(to.latitudes[i], to.longitudes[i]);
+        QVERIFY(compareDoubles(distances[i], fromCoord.distanceTo(toCoord), 1e-3));
+        QVERIFY(compareDoubles(azimuths[i], fromCoord.azimuthTo(toCoord), 1e-9));
+        QVERIFY(azimuths[i] >= 0. && azimuths[i] < 360.);
+    }
+}
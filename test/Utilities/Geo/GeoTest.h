@@ -37,6 +37,9 @@ private slots:
     void _convertGeoToMGRS_test(void);
     void _convertMGRSToGeo_test(void);
 
+    void _batchConversions_test(void);
+    void _batchHaversine_test(void);
+
 private:
      /// Use ETH campus (47.3764° N, 8.5481° E)
     const QGeoCoordinate m_origin{47.3764, 8.5481, 0.0};
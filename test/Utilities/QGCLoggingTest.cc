@@ -0,0 +1,110 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "QGCLoggingTest.h"
+#include "QGCLogging.h"
+
+#include <QtCore/QRegularExpression>
+#include <QtCore/QThread>
+#include <QtTest/QTest>
+
+#include <memory>
+
+void QGCLoggingTest::_testFormatRecord()
+{
+    const QGCLogging::Record_t record = {
+        12345,
+        QtWarningMsg,
+        "qgc.test",
+        "void QGCLoggingTest::_testFormatRecord(int, const QString&)",
+        42,
+        QStringLiteral("Message")
+    };
+    QCOMPARE(QGCLogging::formatRecord(record), QStringLiteral("qgc.test::     12.345 - warning: Message (QGCLoggingTest::_testFormatRecord:42)"));
+
+    // No context in the message
+    const QGCLogging::Record_t noContext = { 1000, QtDebugMsg, "default", QByteArray(), 0, QStringLiteral("Message") };
+    QCOMPARE(QGCLogging::formatRecord(noContext), QStringLiteral("default::      1.000 - debug: Message (:0)"));
+}
+
+void QGCLoggingTest::_testTransientContext()
+{
+    QGCLogging *const logging = QGCLogging::instance();
+    const int firstRow = logging->rowCount();
+
+    // QML messages pass category and function strings which are freed once the handler returns
+    {
+        QByteArray category("qgc.test.transient");
+        QByteArray function("void QGCLoggingTest::transientFunction()");
+        auto context = std::make_unique<QMessageLogContext>(__FILE__, __LINE__, function.constData(), category.constData());
+        logging->log(QtDebugMsg, *context, QStringLiteral("QGCLoggingTest transient context"));
+        context.reset();
+        category.fill('x');
+        function.fill('x');
+    }
+
+    QTRY_VERIFY_WITH_TIMEOUT(([&]() {
+        for (int row = firstRow; row < logging->rowCount(); row++) {
+            const QString text = logging->data(logging->index(row)).toString();
+            if (text.contains(QStringLiteral("QGCLoggingTest transient context"))) {
+                return text.startsWith(QStringLiteral("qgc.test.transient::")) && text.contains(QStringLiteral("(QGCLoggingTest::transientFunction:"));
+            }
+        }
+        return false;
+    }()), 5000);
+}
+
+void QGCLoggingTest::_testThreads()
+{
+    static constexpr int kThreadCount = 4;
+    static constexpr int kMessageCount = 500;     // Fits a thread buffer, nothing is dropped
+
+    QGCLogging *const logging = QGCLogging::instance();
+    const int firstRow = logging->rowCount();
+
+    QList<QThread*> threads;
+    for (int thread = 0; thread < kThreadCount; thread++) {
+        threads.append(QThread::create([logging, thread]() {
+            const QMessageLogContext context(__FILE__, __LINE__, Q_FUNC_INFO, "qgc.test");
+            for (int i = 0; i < kMessageCount; i++) {
+                logging->log(QtDebugMsg, context, QStringLiteral("QGCLoggingTest thread %1 message %2").arg(thread).arg(i));
+            }
+        }));
+        threads.last()->start();
+    }
+    for (QThread *const thread : threads) {
+        QVERIFY(thread->wait(5000));
+        delete thread;
+    }
+
+    // Records reach the model in batches from the writer thread, each thread's in the order they were logged
+    static const QRegularExpression messageRegExp(QStringLiteral("QGCLoggingTest thread (\\d+) message (\\d+)"));
+    QList<int> nextMessage(kThreadCount, 0);
+    int received = 0;
+    int row = firstRow;
+    QTRY_VERIFY_WITH_TIMEOUT(([&]() {
+        for (; row < logging->rowCount(); row++) {
+            const QRegularExpressionMatch match = messageRegExp.match(logging->data(logging->index(row)).toString());
+            if (!match.hasMatch()) {
+                continue;
+            }
+            const int thread = match.captured(1).toInt();
+            const int message = match.captured(2).toInt();
+            if (message != nextMessage[thread]) {
+                qWarning() << "Out of order" << thread << message << nextMessage[thread];
+                return true;
+            }
+            nextMessage[thread]++;
+            received++;
+        }
+        return received == (kThreadCount * kMessageCount);
+    }()), 5000);
+
+    QCOMPARE(received, kThreadCount * kMessageCount);
+}
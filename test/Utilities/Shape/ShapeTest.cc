@@ -1,6 +1,9 @@
 #include "ShapeTest.h"
 #include "ShapeFileHelper.h"
 
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QTextStream>
 #include <QtTest/QTest>
 
 QString ShapeTest::_copyRes(const QTemporaryDir &tmpDir, const QString &name)
@@ -53,3 +56,67 @@ void ShapeTest::_testLoadPolygonFromKML()
     QList<QGeoCoordinate> rgCoords;
     QVERIFY(ShapeFileHelper::loadPolygonFromFile(shpFile, rgCoords, errorString));
 }
+
+void ShapeTest::_testLoadLargePolygonFromKML()
+{
+    // Survey boundary sized polygon: a 2km radius circle with a vertex every 25cm
+    static constexpr int vertexCount = 50000;
+    static constexpr double radiusMeters = 2000;
+    const QGeoCoordinate center(47.6, -122.1);
+
+    const QTemporaryDir tmpDir;
+    const QString kmlFile = tmpDir.filePath(QStringLiteral("large.kml"));
+    {
+        QFile file(kmlFile);
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Text));
+        QTextStream stream(&file);
+        stream << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+               << "<kml xmlns=\"http://www.opengis.net/kml/2.2\"><Document><Placemark><Polygon><outerBoundaryIs><LinearRing><coordinates>\n";
+        stream.setRealNumberPrecision(12);
+        for (int i = 0; i < vertexCount; i++) {
+            const QGeoCoordinate coord = center.atDistanceAndAzimuth(radiusMeters, (360.0 * i) / vertexCount);
+            stream << coord.longitude() << ',' << coord.latitude() << ",0 ";
+        }
+        stream << "\n</coordinates></LinearRing></outerBoundaryIs></Polygon></Placemark></Document></kml>\n";
+    }
+
+    QString errorString;
+    QList<QGeoCoordinate> rgCoords;
+
+    QVERIFY2(ShapeFileHelper::loadPolygonFromFile(kmlFile, rgCoords, errorString), qPrintable(errorString));
+    QCOMPARE(rgCoords.count(), vertexCount);
+
+    QList<QGeoCoordinate> rgSimplified;
+    QVERIFY2(ShapeFileHelper::loadPolygonFromFile(kmlFile, rgSimplified, errorString, 1 /* simplifyToleranceMeters */), qPrintable(errorString));
+
+    // A 1m tolerance on a 2km circle needs a vertex at least every ~126m, splitting in halves gives 128 segments
+    QVERIFY(rgSimplified.count() >= 3);
+    QVERIFY(rgSimplified.count() < 200);
+}
+
+void ShapeTest::_testSimplify()
+{
+    const QGeoCoordinate origin(47.6, -122.1);
+
+    // Straight line with a 10m spike in the middle
+    QList<QGeoCoordinate> rgLine;
+    for (int i = 0; i <= 100; i++) {
+        const QGeoCoordinate onLine = origin.atDistanceAndAzimuth(i, 90);
+        rgLine.append((i == 50) ? onLine.atDistanceAndAzimuth(10, 0) : onLine);
+    }
+
+    // No tolerance keeps everything
+    QCOMPARE(ShapeFileHelper::simplify(rgLine, 0).count(), rgLine.count());
+
+    // Spike is larger than the tolerance, so it stays along with the end points and the vertices at its base
+    const QList<QGeoCoordinate> rgSimplified = ShapeFileHelper::simplify(rgLine, 1);
+    QCOMPARE(rgSimplified.count(), 5);
+    QCOMPARE(rgSimplified[0], rgLine[0]);
+    QCOMPARE(rgSimplified[1], rgLine[49]);
+    QCOMPARE(rgSimplified[2], rgLine[50]);
+    QCOMPARE(rgSimplified[3], rgLine[51]);
+    QCOMPARE(rgSimplified[4], rgLine[100]);
+
+    // Spike is smaller than the tolerance
+    QCOMPARE(ShapeFileHelper::simplify(rgLine, 20).count(), 2);
+}
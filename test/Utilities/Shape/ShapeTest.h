@@ -13,6 +13,8 @@ private slots:
     void _testLoadPolylineFromKML();
     void _testLoadPolygonFromSHP();
     void _testLoadPolygonFromKML();
+    void _testLoadLargePolygonFromKML();
+    void _testSimplify();
 
 private:
     static QString _copyRes(const QTemporaryDir &tmpDir, const QString &name);
@@ -0,0 +1,220 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TelemetryTracerTest.h"
+#include "TelemetryTracer.h"
+#include "LatencyHistogram.h"
+#include "Fact.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QThread>
+#include <QtTest/QTest>
+
+static mavlink_message_t makeMessage(uint8_t systemId, uint32_t messageId)
+{
+    mavlink_message_t message{};
+    message.sysid = systemId;
+    message.compid = MAV_COMP_ID_AUTOPILOT1;
+    message.msgid = messageId;
+    return message;
+}
+
+void TelemetryTracerTest::_testHistogram()
+{
+    LatencyHistogram histogram;
+    QCOMPARE(histogram.count(), 0ULL);
+    QCOMPARE(histogram.valueAtPercentile(50.), 0ULL);
+
+    for (quint64 value = 1; value <= 10000; value++) {
+        histogram.record(value);
+    }
+
+    QCOMPARE(histogram.count(), 10000ULL);
+    QCOMPARE(histogram.min(), 1ULL);
+    QCOMPARE(histogram.max(), 10000ULL);
+    QVERIFY(qAbs(histogram.mean() - 5000.5) < 0.001);
+
+    // Sixteen sub buckets per power of two keeps every percentile within 1/16 above the exact value
+    for (const double percentile : { 50., 90., 99., 99.9 }) {
+        const double exact = percentile * 100.;
+        const double value = histogram.valueAtPercentile(percentile);
+        QVERIFY2((value >= exact) && (value <= exact * (1. + 1. / 16.)), qPrintable(QStringLiteral("p%1 = %2").arg(percentile).arg(value)));
+    }
+    QCOMPARE(histogram.valueAtPercentile(100.), 10000ULL);
+
+    // Small values are exact
+    LatencyHistogram small;
+    for (const quint64 value : { 0ULL, 3ULL, 7ULL, 15ULL }) {
+        small.record(value);
+    }
+    QCOMPARE(small.valueAtPercentile(25.), 0ULL);
+    QCOMPARE(small.valueAtPercentile(50.), 3ULL);
+    QCOMPARE(small.valueAtPercentile(75.), 7ULL);
+
+    histogram.merge(small);
+    QCOMPARE(histogram.count(), 10004ULL);
+    QCOMPARE(histogram.min(), 0ULL);
+
+    histogram.reset();
+    QCOMPARE(histogram.count(), 0ULL);
+    QCOMPARE(histogram.max(), 0ULL);
+}
+
+void TelemetryTracerTest::_testStages()
+{
+    TelemetryTracer *const tracer = TelemetryTracer::instance();
+    tracer->reset();
+
+    // Nothing is collected while disabled
+    QVERIFY(!TelemetryTracer::enabled());
+    tracer->beginMessage(TelemetryTracer::nowNsecs(), makeMessage(1, MAVLINK_MSG_ID_ATTITUDE));
+    tracer->markDispatch();
+    tracer->endMessage();
+    QVERIFY(tracer->messageHistograms().isEmpty());
+
+    tracer->setEnabled(true);
+
+    const qint64 readNsecs = TelemetryTracer::nowNsecs();
+    QThread::usleep(2000);
+    tracer->beginMessage(readNsecs, makeMessage(1, MAVLINK_MSG_ID_ATTITUDE));
+    tracer->markDispatch();
+    tracer->markFactGroups();
+    tracer->markFactGroups();
+    tracer->endMessage();
+
+    // Marks outside of a message are ignored
+    tracer->markDispatch();
+
+    tracer->beginMessage(-1, makeMessage(2, MAVLINK_MSG_ID_VFR_HUD));
+    tracer->markDispatch();
+    tracer->endMessage();
+
+    QCOMPARE(tracer->messageHistograms().count(), 2);
+    QCOMPARE(tracer->vehicleHistograms().count(), 2);
+
+    const TelemetryTracer::StageHistograms_t &attitude = tracer->messageHistograms()[MAVLINK_MSG_ID_ATTITUDE];
+    QCOMPARE(attitude[TelemetryTracer::StageParse].count(), 1ULL);
+    QCOMPARE(attitude[TelemetryTracer::StageDispatch].count(), 1ULL);
+    QCOMPARE(attitude[TelemetryTracer::StageFactGroups].count(), 1ULL);
+    QCOMPARE(attitude[TelemetryTracer::StageFlush].count(), 0ULL);
+    QVERIFY(attitude[TelemetryTracer::StageParse].min() >= 2000);
+    QVERIFY(attitude[TelemetryTracer::StageFactGroups].min() >= attitude[TelemetryTracer::StageParse].max());
+
+    const TelemetryTracer::StageHistograms_t &vehicle2 = tracer->vehicleHistograms()[2];
+    QCOMPARE(vehicle2[TelemetryTracer::StageDispatch].count(), 1ULL);
+    QCOMPARE(vehicle2[TelemetryTracer::StageFactGroups].count(), 0ULL);
+
+    tracer->setEnabled(false);
+    tracer->reset();
+    QVERIFY(tracer->messageHistograms().isEmpty());
+}
+
+void TelemetryTracerTest::_testDeferredFlush()
+{
+    TelemetryTracer *const tracer = TelemetryTracer::instance();
+    tracer->reset();
+    tracer->setEnabled(true);
+
+    Fact immediateFact(0, QStringLiteral("immediate"), FactMetaData::valueTypeDouble);
+    Fact deferredFact(0, QStringLiteral("deferred"), FactMetaData::valueTypeDouble);
+    deferredFact.setSendValueChangedSignals(false);
+
+    tracer->beginMessage(-1, makeMessage(1, MAVLINK_MSG_ID_ATTITUDE));
+    immediateFact.setRawValue(1.);
+    tracer->endMessage();
+
+    QCOMPARE(tracer->messageHistograms()[MAVLINK_MSG_ID_ATTITUDE][TelemetryTracer::StageFlush].count(), 1ULL);
+
+    // Two messages change the deferred fact before the flush, latency is measured from the first
+    tracer->beginMessage(TelemetryTracer::nowNsecs(), makeMessage(1, MAVLINK_MSG_ID_VFR_HUD));
+    deferredFact.setRawValue(1.);
+    tracer->endMessage();
+    QThread::usleep(2000);
+    tracer->beginMessage(-1, makeMessage(1, MAVLINK_MSG_ID_GLOBAL_POSITION_INT));
+    deferredFact.setRawValue(2.);
+    tracer->endMessage();
+
+    QCOMPARE(tracer->messageHistograms()[MAVLINK_MSG_ID_VFR_HUD][TelemetryTracer::StageFlush].count(), 0ULL);
+
+    deferredFact.sendDeferredValueChangedSignal();
+    const LatencyHistogram &flush = tracer->messageHistograms()[MAVLINK_MSG_ID_VFR_HUD][TelemetryTracer::StageFlush];
+    QCOMPARE(flush.count(), 1ULL);
+    QVERIFY(flush.min() >= 2000);
+    QCOMPARE(tracer->messageHistograms()[MAVLINK_MSG_ID_GLOBAL_POSITION_INT][TelemetryTracer::StageFlush].count(), 0ULL);
+
+    // A second flush without a new change records nothing
+    deferredFact.sendDeferredValueChangedSignal();
+    QCOMPARE(tracer->messageHistograms()[MAVLINK_MSG_ID_VFR_HUD][TelemetryTracer::StageFlush].count(), 1ULL);
+
+    tracer->setEnabled(false);
+    tracer->reset();
+}
+
+void TelemetryTracerTest::_testChromeTrace()
+{
+    TelemetryTracer *const tracer = TelemetryTracer::instance();
+    tracer->reset();
+    tracer->setEnabled(true);
+
+    for (int i = 0; i < 3; i++) {
+        tracer->beginMessage(-1, makeMessage(1, MAVLINK_MSG_ID_ATTITUDE));
+        tracer->markDispatch();
+        tracer->markFactGroups();
+        tracer->endMessage();
+    }
+    tracer->beginMessage(-1, makeMessage(3, MAVLINK_MSG_ID_HEARTBEAT));
+    tracer->endMessage();
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString filename = tempDir.filePath(QStringLiteral("trace.json"));
+    QVERIFY(tracer->exportChromeTrace(filename));
+
+    tracer->setEnabled(false);
+    tracer->reset();
+
+    QFile file(filename);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+
+    const QJsonArray events = document.object()[QStringLiteral("traceEvents")].toArray();
+    int slices = 0;
+    QStringList processNames;
+    QStringList threadNames;
+    double lastTs = 0;
+    for (const QJsonValue &value : events) {
+        const QJsonObject event = value.toObject();
+        const QString phase = event[QStringLiteral("ph")].toString();
+        if (phase == QStringLiteral("X")) {
+            slices++;
+            QVERIFY(event[QStringLiteral("dur")].toDouble() >= 0);
+            QVERIFY(event[QStringLiteral("ts")].toDouble() >= lastTs);
+            lastTs = event[QStringLiteral("ts")].toDouble();
+        } else if (phase == QStringLiteral("M")) {
+            const QString name = event[QStringLiteral("args")].toObject()[QStringLiteral("name")].toString();
+            if (event[QStringLiteral("name")].toString() == QStringLiteral("process_name")) {
+                processNames.append(name);
+            } else {
+                threadNames.append(name);
+            }
+        }
+    }
+
+    // Three stages for each ATTITUDE, parse only for the HEARTBEAT
+    QCOMPARE(slices, 10);
+    processNames.sort();
+    QCOMPARE(processNames, QStringList({ QStringLiteral("Vehicle 1"), QStringLiteral("Vehicle 3") }));
+    QVERIFY(threadNames.contains(QStringLiteral("ATTITUDE")));
+    QVERIFY(threadNames.contains(QStringLiteral("HEARTBEAT")));
+}
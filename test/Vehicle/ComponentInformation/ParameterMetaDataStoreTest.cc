@@ -0,0 +1,386 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "ParameterMetaDataStoreTest.h"
+#include "ParameterMetaDataStore.h"
+#include "FactMetaData.h"
+#include "APMParameterMetaData.h"
+#include "PX4ParameterMetaData.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QTest>
+
+namespace {
+
+constexpr const char* kMockLinkMetaDataFile = ":MockLink/Parameter.MetaData.json";
+constexpr const char* kAPMPlaneMetaDataFile = ":/FirmwarePlugin/APM/APMParameterFactMetaData.Plane.4.5.xml";
+
+// The first parameter's elements are never read by the PX4 parser, hence FIRST
+constexpr const char* kPX4MetaDataXml = R"(<?xml version="1.0" encoding="UTF-8"?>
+<parameters>
+  <version>3</version>
+  <group name="Test">
+    <parameter default="0" name="FIRST" type="INT32">
+      <short_desc>Skipped</short_desc>
+    </parameter>
+    <parameter default="2" name="TEST_ENUM" type="INT32" category="System">
+      <short_desc>Enum
+parameter</short_desc>
+      <min>0</min>
+      <max>2</max>
+      <unit>m</unit>
+      <reboot_required>true</reboot_required>
+      <values>
+        <value code="0">Zero</value>
+        <value code="1">One</value>
+        <value code="3">Out of range</value>
+      </values>
+    </parameter>
+    <parameter default="1" name="TEST_BOOL" type="INT32" readonly="true">
+      <short_desc>Bool</short_desc>
+      <boolean />
+    </parameter>
+    <parameter default="0.5" name="TEST_FLOAT" type="FLOAT" volatile="true">
+      <short_desc>Float</short_desc>
+      <decimal>3</decimal>
+      <increment>0.25</increment>
+    </parameter>
+    <parameter default="0" name="TEST_BITS" type="INT32">
+      <bitmask>
+        <bit index="0">Bit zero</bit>
+        <bit index="2">Bit two</bit>
+      </bitmask>
+    </parameter>
+    <parameter default="0" name="TEST_DUP" type="INT32">
+      <short_desc>First</short_desc>
+    </parameter>
+    <parameter default="0" name="TEST_DUP" type="INT32">
+      <short_desc>Second</short_desc>
+    </parameter>
+  </group>
+</parameters>
+)";
+
+QByteArray readFile(const QString& fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return QByteArray();
+    }
+    return file.readAll();
+}
+
+} // namespace
+
+void ParameterMetaDataStoreTest::_compileTest()
+{
+    const QByteArray jsonBytes = readFile(kMockLinkMetaDataFile);
+    QVERIFY(!jsonBytes.isEmpty());
+
+    QByteArray storeBytes;
+    QString errorString;
+    QVERIFY2(ParameterMetaDataStore::compile(jsonBytes, storeBytes, errorString), qPrintable(errorString));
+
+    ParameterMetaDataStore store;
+    QVERIFY2(store.openData(storeBytes, errorString), qPrintable(errorString));
+
+    // Every parameter comes back exactly as it was in the json
+    const QJsonArray rgParameters = QJsonDocument::fromJson(jsonBytes).object()["parameters"].toArray();
+    QVERIFY(!rgParameters.isEmpty());
+    QHash<QString, QJsonObject> expected;
+    for (const QJsonValue& parameterValue : rgParameters) {
+        const QJsonObject parameterObj = parameterValue.toObject();
+        expected[parameterObj["name"].toString()] = parameterObj;
+    }
+    QCOMPARE(store.count(), expected.count());
+
+    for (auto it = expected.constBegin(); it != expected.constEnd(); ++it) {
+        QString indexValue;
+        const QJsonObject parameterObj = store.parameter(it.key(), indexValue);
+        QCOMPARE(parameterObj, it.value());
+        QVERIFY(indexValue.isEmpty());
+    }
+
+    QString indexValue;
+    QVERIFY(store.parameter(QStringLiteral("NOT_A_PARAM"), indexValue).isEmpty());
+    QVERIFY(store.parameter(QString(), indexValue).isEmpty());
+}
+
+void ParameterMetaDataStoreTest::_indexedNameTest()
+{
+    const QByteArray jsonBytes = R"({
+        "version": 1,
+        "parameters": [
+            { "name": "CAL_ACC{n}_ID", "type": "Int32", "shortDesc": "Accel {n} id", "default": 0 },
+            { "name": "CAL_ACC0_ID", "type": "Int32", "shortDesc": "First accel", "default": 4294967295 },
+            { "name": "RC{n}_MIN", "type": "Float", "shortDesc": "RC {n} min", "default": 1000.5 },
+            { "name": "RC1_MIN", "type": "Float", "shortDesc": "Replaced", "default": 1 },
+            { "name": "RC1_MIN", "type": "Float", "shortDesc": "Replacement", "default": 2 }
+        ]
+    })";
+
+    QByteArray storeBytes;
+    QString errorString;
+    QVERIFY2(ParameterMetaDataStore::compile(jsonBytes, storeBytes, errorString), qPrintable(errorString));
+
+    ParameterMetaDataStore store;
+    QVERIFY2(store.openData(storeBytes, errorString), qPrintable(errorString));
+    QCOMPARE(store.count(), 4);
+
+    // Direct names take precedence over indexed names
+    QString indexValue;
+    QJsonObject parameterObj = store.parameter(QStringLiteral("CAL_ACC0_ID"), indexValue);
+    QCOMPARE(parameterObj["shortDesc"].toString(), QStringLiteral("First accel"));
+    QCOMPARE(parameterObj["default"].toVariant().toLongLong(), 4294967295ll);
+    QVERIFY(indexValue.isEmpty());
+
+    parameterObj = store.parameter(QStringLiteral("CAL_ACC12_ID"), indexValue);
+    QCOMPARE(parameterObj["name"].toString(), QStringLiteral("CAL_ACC{n}_ID"));
+    QCOMPARE(indexValue, QStringLiteral("12"));
+
+    parameterObj = store.parameter(QStringLiteral("RC8_MIN"), indexValue);
+    QCOMPARE(parameterObj["default"].toDouble(), 1000.5);
+    QCOMPARE(indexValue, QStringLiteral("8"));
+
+    // Later definitions replace earlier ones
+    parameterObj = store.parameter(QStringLiteral("RC1_MIN"), indexValue);
+    QCOMPARE(parameterObj["shortDesc"].toString(), QStringLiteral("Replacement"));
+
+    // The index must be digits
+    QVERIFY(store.parameter(QStringLiteral("CAL_ACC_ID"), indexValue).isEmpty());
+    QVERIFY(store.parameter(QStringLiteral("CAL_ACCX_ID"), indexValue).isEmpty());
+    QVERIFY(store.parameter(QStringLiteral("CAL_ACC1_IDX"), indexValue).isEmpty());
+
+    // Same result through FactMetaData as the json parse gave
+    parameterObj = store.parameter(QStringLiteral("RC3_MIN"), indexValue);
+    QMap<QString, QString> emptyDefineMap;
+    FactMetaData* const metaData = FactMetaData::createFromJsonObject(parameterObj, emptyDefineMap, this);
+    QCOMPARE(metaData->type(), FactMetaData::valueTypeFloat);
+    QCOMPARE(metaData->rawDefaultValue().toDouble(), 1000.5);
+}
+
+void ParameterMetaDataStoreTest::_corruptStoreTest()
+{
+    QByteArray storeBytes;
+    QString errorString;
+    QVERIFY(ParameterMetaDataStore::compile(readFile(kMockLinkMetaDataFile), storeBytes, errorString));
+
+    ParameterMetaDataStore store;
+    QVERIFY(!store.openData(storeBytes.left(storeBytes.size() - 1), errorString));
+    QVERIFY(!store.isOpen());
+
+    QByteArray badMagic = storeBytes;
+    badMagic[0] = 'x';
+    QVERIFY(!store.openData(badMagic, errorString));
+
+    QVERIFY(!store.openData(QByteArray(8, '\0'), errorString));
+
+    QVERIFY(!ParameterMetaDataStore::compile(QByteArrayLiteral("{ \"version\": 2, \"parameters\": [] }"), storeBytes, errorString));
+    QVERIFY(!ParameterMetaDataStore::compile(QByteArrayLiteral("not json"), storeBytes, errorString));
+}
+
+void ParameterMetaDataStoreTest::_cacheTest()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString cacheDir = tempDir.filePath(QStringLiteral("cache"));
+    const QString jsonFileName = tempDir.filePath(QStringLiteral("params.json"));
+    QVERIFY(QFile::copy(kMockLinkMetaDataFile, jsonFileName));
+    QVERIFY(QFile::setPermissions(jsonFileName, QFileDevice::ReadOwner | QFileDevice::WriteOwner));
+
+    QString errorString;
+    {
+        ParameterMetaDataStore store;
+        QVERIFY2(store.load(jsonFileName, QStringLiteral("1-1.15.0"), cacheDir, errorString), qPrintable(errorString));
+    }
+    const QStringList storeFiles = QDir(cacheDir).entryList({ QStringLiteral("*.pmds") }, QDir::Files);
+    QCOMPARE(storeFiles.count(), 1);
+
+    // Second load maps the cached store
+    ParameterMetaDataStore store;
+    QVERIFY2(store.load(jsonFileName, QStringLiteral("1-1.15.0"), cacheDir, errorString), qPrintable(errorString));
+    QCOMPARE(QDir(cacheDir).entryList({ QStringLiteral("*.pmds") }, QDir::Files), storeFiles);
+    QVERIFY(store.count() > 0);
+
+    // A changed json compiles again
+    QFile jsonFile(jsonFileName);
+    QVERIFY(jsonFile.open(QIODevice::Append));
+    (void) jsonFile.write("\n");
+    jsonFile.close();
+    QVERIFY(store.load(jsonFileName, QStringLiteral("1-1.15.0"), cacheDir, errorString));
+    QCOMPARE(QDir(cacheDir).entryList({ QStringLiteral("*.pmds") }, QDir::Files).count(), 2);
+
+    // Old stores are pruned
+    for (int i = 0; i < ParameterMetaDataStore::kMaxCacheFiles + 2; i++) {
+        QVERIFY(store.load(jsonFileName, QStringLiteral("tag%1").arg(i), cacheDir, errorString));
+    }
+    QCOMPARE(QDir(cacheDir).entryList({ QStringLiteral("*.pmds") }, QDir::Files).count(), ParameterMetaDataStore::kMaxCacheFiles);
+}
+
+void ParameterMetaDataStoreTest::_apmXmlTest()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString cacheDir = tempDir.filePath(QStringLiteral("cache"));
+
+    const QString xml = QString::fromUtf8(readFile(kAPMPlaneMetaDataFile));
+    QVERIFY(!xml.isEmpty());
+    QStringList names;
+    static const QRegularExpression paramNameRegExp(QStringLiteral("<param [^>]*name=\"(?:[^\":]*:)?([^\"]+)\""));
+    QRegularExpressionMatchIterator it = paramNameRegExp.globalMatch(xml);
+    while (it.hasNext()) {
+        names.append(it.next().captured(1));
+    }
+    names.removeDuplicates();
+    QVERIFY(names.count() > 100);
+
+    // The first load parses the xml, the second only maps what the first cached
+    APMParameterMetaData parsed;
+    parsed.loadParameterFactMetaDataFile(kAPMPlaneMetaDataFile, cacheDir);
+    const QStringList storeFiles = QDir(cacheDir).entryList({ QStringLiteral("*.pmds") }, QDir::Files);
+    QCOMPARE(storeFiles.count(), 1);
+
+    APMParameterMetaData cached;
+    cached.loadParameterFactMetaDataFile(kAPMPlaneMetaDataFile, cacheDir);
+    QCOMPARE(QDir(cacheDir).entryList({ QStringLiteral("*.pmds") }, QDir::Files), storeFiles);
+
+    int withDescription = 0;
+    for (const QString& name : names) {
+        const FactMetaData* expected = parsed.getMetaDataForFact(name, MAV_TYPE_FIXED_WING, FactMetaData::valueTypeFloat);
+        const FactMetaData* actual = cached.getMetaDataForFact(name, MAV_TYPE_FIXED_WING, FactMetaData::valueTypeFloat);
+        QVERIFY(expected && actual);
+        QCOMPARE(actual->shortDescription(), expected->shortDescription());
+        QCOMPARE(actual->longDescription(), expected->longDescription());
+        QCOMPARE(actual->group(), expected->group());
+        QCOMPARE(actual->category(), expected->category());
+        QCOMPARE(actual->rawUnits(), expected->rawUnits());
+        QCOMPARE(actual->rawMin(), expected->rawMin());
+        QCOMPARE(actual->rawMax(), expected->rawMax());
+        QCOMPARE(actual->enumStrings(), expected->enumStrings());
+        QCOMPARE(actual->enumValues(), expected->enumValues());
+        QCOMPARE(actual->bitmaskStrings(), expected->bitmaskStrings());
+        QCOMPARE(actual->readOnly(), expected->readOnly());
+        QCOMPARE(actual->vehicleRebootRequired(), expected->vehicleRebootRequired());
+        if (!expected->shortDescription().isEmpty()) {
+            withDescription++;
+        }
+    }
+    QVERIFY(withDescription > 0);
+}
+
+void ParameterMetaDataStoreTest::_px4XmlTest()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString cacheDir = tempDir.filePath(QStringLiteral("cache"));
+    const QString xmlFileName = tempDir.filePath(QStringLiteral("PX4ParameterFactMetaData.xml"));
+    QFile xmlFile(xmlFileName);
+    QVERIFY(xmlFile.open(QIODevice::WriteOnly));
+    (void) xmlFile.write(kPX4MetaDataXml);
+    xmlFile.close();
+
+    // Both the converting load and the cached load build the same FactMetaData
+    for (int pass = 0; pass < 2; pass++) {
+        PX4ParameterMetaData metaData;
+        metaData.loadParameterFactMetaDataFile(xmlFileName, cacheDir);
+        QCOMPARE(QDir(cacheDir).entryList({ QStringLiteral("*.pmds") }, QDir::Files).count(), 1);
+
+        const FactMetaData* first = metaData.getMetaDataForFact(QStringLiteral("FIRST"), MAV_TYPE_QUADROTOR, FactMetaData::valueTypeInt32);
+        QCOMPARE(first->group(), QStringLiteral("Test"));
+        QVERIFY(first->shortDescription().isEmpty());
+
+        const FactMetaData* enumMetaData = metaData.getMetaDataForFact(QStringLiteral("TEST_ENUM"), MAV_TYPE_QUADROTOR, FactMetaData::valueTypeInt32);
+        QCOMPARE(enumMetaData->shortDescription(), QStringLiteral("Enum parameter"));
+        QCOMPARE(enumMetaData->category(), QStringLiteral("System"));
+        QCOMPARE(enumMetaData->rawMin(), QVariant(0));
+        QCOMPARE(enumMetaData->rawMax(), QVariant(2));
+        QCOMPARE(enumMetaData->rawUnits(), QStringLiteral("m"));
+        QVERIFY(enumMetaData->vehicleRebootRequired());
+        QCOMPARE(enumMetaData->enumStrings(), QStringList({ QStringLiteral("Zero"), QStringLiteral("One") }));
+        QCOMPARE(enumMetaData->rawDefaultValue(), QVariant(2));
+
+        const FactMetaData* boolMetaData = metaData.getMetaDataForFact(QStringLiteral("TEST_BOOL"), MAV_TYPE_QUADROTOR, FactMetaData::valueTypeInt32);
+        QCOMPARE(boolMetaData->category(), QStringLiteral("Standard"));
+        QVERIFY(boolMetaData->readOnly());
+        QCOMPARE(boolMetaData->enumStrings().count(), 2);
+
+        const FactMetaData* floatMetaData = metaData.getMetaDataForFact(QStringLiteral("TEST_FLOAT"), MAV_TYPE_QUADROTOR, FactMetaData::valueTypeFloat);
+        QVERIFY(floatMetaData->volatileValue());
+        QVERIFY(floatMetaData->readOnly());
+        QCOMPARE(floatMetaData->decimalPlaces(), 3);
+        QCOMPARE(floatMetaData->rawIncrement(), 0.25);
+
+        const FactMetaData* bitsMetaData = metaData.getMetaDataForFact(QStringLiteral("TEST_BITS"), MAV_TYPE_QUADROTOR, FactMetaData::valueTypeInt32);
+        QCOMPARE(bitsMetaData->bitmaskStrings(), QStringList({ QStringLiteral("Bit zero"), QStringLiteral("Bit two") }));
+        QCOMPARE(bitsMetaData->bitmaskValues(), QVariantList({ QVariant(1), QVariant(4) }));
+
+        // Duplicated parameters fall back to default meta data
+        const FactMetaData* dupMetaData = metaData.getMetaDataForFact(QStringLiteral("TEST_DUP"), MAV_TYPE_QUADROTOR, FactMetaData::valueTypeInt32);
+        QVERIFY(dupMetaData->shortDescription().isEmpty());
+
+        // Unknown parameters get generic meta data
+        const FactMetaData* unknownMetaData = metaData.getMetaDataForFact(QStringLiteral("NOT_THERE"), MAV_TYPE_QUADROTOR, FactMetaData::valueTypeUint8);
+        QCOMPARE(unknownMetaData->type(), FactMetaData::valueTypeUint8);
+    }
+}
+
+void ParameterMetaDataStoreTest::_lookupTest()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString jsonFileName = tempDir.filePath(QStringLiteral("params.json"));
+    QVERIFY(QFile::copy(kMockLinkMetaDataFile, jsonFileName));
+    const QString cacheDir = tempDir.filePath(QStringLiteral("cache"));
+
+    QString errorString;
+    {
+        ParameterMetaDataStore store;
+        QVERIFY(store.load(jsonFileName, QStringLiteral("lookup"), cacheDir, errorString));
+    }
+
+    const QJsonArray rgParameters = QJsonDocument::fromJson(readFile(jsonFileName)).object()["parameters"].toArray();
+    QStringList lookupNames;
+    for (int i = 0; i < rgParameters.count(); i += 10) {
+        lookupNames.append(rgParameters[i].toObject()["name"].toString());
+    }
+
+    QMap<QString, QString> emptyDefineMap;
+
+    // The second load maps the store the first one cached
+    ParameterMetaDataStore store;
+    QVERIFY(store.load(jsonFileName, QStringLiteral("lookup"), cacheDir, errorString));
+    QCOMPARE(QDir(cacheDir).entryList({ QStringLiteral("*.pmds") }, QDir::Files).count(), 1);
+    QCOMPARE(store.count(), rgParameters.count());
+
+    // Only the looked up parameters get FactMetaData, and it is the same as built from the json
+    QObject jsonParent;
+    QHash<QString, FactMetaData*> jsonMetaData;
+    for (const QJsonValue& parameterValue : rgParameters) {
+        FactMetaData *const metaData = FactMetaData::createFromJsonObject(parameterValue.toObject(), emptyDefineMap, &jsonParent);
+        jsonMetaData[metaData->name()] = metaData;
+    }
+
+    QObject storeParent;
+    for (const QString& name : lookupNames) {
+        QString indexValue;
+        const FactMetaData *const fromStore = FactMetaData::createFromJsonObject(store.parameter(name, indexValue), emptyDefineMap, &storeParent);
+        const FactMetaData *const fromJson = jsonMetaData.value(name);
+        QVERIFY(fromJson);
+        QCOMPARE(fromStore->name(), name);
+        QCOMPARE(fromStore->type(), fromJson->type());
+        QCOMPARE(fromStore->shortDescription(), fromJson->shortDescription());
+        QCOMPARE(fromStore->rawUnits(), fromJson->rawUnits());
+        QCOMPARE(fromStore->rawDefaultValue(), fromJson->rawDefaultValue());
+    }
+    QCOMPARE(storeParent.children().count(), lookupNames.count());
+}
@@ -0,0 +1,29 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+class ParameterMetaDataStoreTest : public UnitTest
+{
+    Q_OBJECT
+
+public:
+    ParameterMetaDataStoreTest() = default;
+
+private slots:
+    void _compileTest();
+    void _indexedNameTest();
+    void _corruptStoreTest();
+    void _cacheTest();
+    void _apmXmlTest();
+    void _px4XmlTest();
+    void _lookupTest();
+};
@@ -14,6 +14,7 @@
 #include "FTPManager.h"
 #include "MockLinkFTP.h"
 
+#include <QtCore/QFileInfo>
 #include <QtCore/QStandardPaths>
 #include <QtTest/QTest>
 #include <QtTest/QSignalSpy>
@@ -125,6 +126,127 @@ void FTPManagerTest::_testLostPackets(void)
     _disconnectMockLink();
 }
 
+void FTPManagerTest::_testSizeBasedDownloads(void)
+{
+    _performSizeBasedTestCases();
+}
+
+void FTPManagerTest::_testUncheckedFileSize(void)
+{
+    // With checksize false the size from the open response is ignored and the file is read until EOF
+    static constexpr int fileSize = 3 * 1024 + 1;
+    const QString filename = QStringLiteral("%1%2").arg(MockLinkFTP::sizeFilenamePrefix).arg(fileSize);
+
+    for (int reportedFileSize: { 0, 100, fileSize, 10 * 1024 }) {
+        for (int dropPercent: { 0, 5 }) {
+            _connectMockLinkNoInitialConnectSequence();
+
+            FTPManager* ftpManager = _vehicle->ftpManager();
+            _mockLink->mockLinkFTP()->setReportedFileSize(reportedFileSize);
+            _mockLink->mockLinkFTP()->setRandomDropPercent(dropPercent);
+
+            QSignalSpy spyDownloadComplete(ftpManager, &FTPManager::downloadComplete);
+
+            QVERIFY(ftpManager->download(MAV_COMP_ID_AUTOPILOT1, filename, QStandardPaths::writableLocation(QStandardPaths::TempLocation), QString(), false /* checksize */));
+            QCOMPARE(spyDownloadComplete.wait(10000), true);
+            QCOMPARE(spyDownloadComplete.count(), 1);
+
+            // void downloadComplete   (const QString& file, const QString& errorMsg);
+            QList<QVariant> arguments = spyDownloadComplete.takeFirst();
+            QVERIFY2(arguments[1].toString().isEmpty(), qPrintable(arguments[1].toString()));
+
+            _verifyFileSizeAndDelete(arguments[0].toString(), fileSize);
+
+            _disconnectMockLink();
+        }
+    }
+}
+
+void FTPManagerTest::_testDownloadFiles(void)
+{
+    QStringList rgFiles;
+    QList<int>  rgFileSizes = { 32 * 1024, 24 * 1024 + 1, 40 * 1024, 16 * 1024 };
+    for (int fileSize: rgFileSizes) {
+        rgFiles.append(QStringLiteral("%1%2").arg(MockLinkFTP::sizeFilenamePrefix).arg(fileSize));
+    }
+
+    // With enough sessions all files stream at once. With fewer, the open which the vehicle refuses
+    // is queued again and waits for a session to free up.
+    for (int vehicleSessions: { 8, 2 }) {
+        _connectMockLinkNoInitialConnectSequence();
+
+        FTPManager* ftpManager = _vehicle->ftpManager();
+        _mockLink->mockLinkFTP()->setMaxSessions(vehicleSessions);
+
+        QSignalSpy spyDownloadComplete(ftpManager, &FTPManager::downloadComplete);
+
+        QVERIFY(ftpManager->downloadFiles(MAV_COMP_ID_AUTOPILOT1, rgFiles, QStandardPaths::writableLocation(QStandardPaths::TempLocation)));
+        QVERIFY(!ftpManager->download(MAV_COMP_ID_AUTOPILOT1, rgFiles[0], QStandardPaths::writableLocation(QStandardPaths::TempLocation)));
+
+        QTRY_COMPARE_WITH_TIMEOUT(spyDownloadComplete.count(), rgFiles.count(), 20000);
+
+        // void downloadComplete   (const QString& file, const QString& errorMsg);
+        for (const QList<QVariant>& arguments: spyDownloadComplete) {
+            QVERIFY2(arguments[1].toString().isEmpty(), qPrintable(arguments[1].toString()));
+
+            const QString fileName = QFileInfo(arguments[0].toString()).fileName();
+            const int fileSize = fileName.right(fileName.length() - QString(MockLinkFTP::sizeFilenamePrefix).length()).toInt();
+            QVERIFY(rgFileSizes.contains(fileSize));
+            _verifyFileSizeAndDelete(arguments[0].toString(), fileSize);
+        }
+
+        const FTPManager::TransferStats_t stats = ftpManager->transferStats();
+        QCOMPARE(stats.filesCompleted, static_cast<uint32_t>(rgFiles.count()));
+        if (vehicleSessions >= rgFiles.count()) {
+            QCOMPARE(stats.peakSessions, static_cast<uint32_t>(rgFiles.count()));
+            QCOMPARE(stats.sessionRequeues, static_cast<uint32_t>(0));
+        } else {
+            QCOMPARE(stats.peakSessions, static_cast<uint32_t>(vehicleSessions));
+            QVERIFY(stats.sessionRequeues > 0);
+        }
+
+        _disconnectMockLink();
+    }
+}
+
+void FTPManagerTest::_testBurstDownload(void)
+{
+    _connectMockLinkNoInitialConnectSequence();
+
+    FTPManager* ftpManager  = _vehicle->ftpManager();
+    int         fileSize    = 64 * 1024;
+    QString     filename    = QStringLiteral("%1%2").arg(MockLinkFTP::sizeFilenamePrefix).arg(fileSize);
+
+    QSignalSpy spyDownloadComplete(ftpManager, &FTPManager::downloadComplete);
+
+    for (int dropPercent: { 0, 2, 5 }) {
+        _mockLink->mockLinkFTP()->setRandomDropPercent(dropPercent);
+        ftpManager->resetTransferStats();
+
+        QVERIFY(ftpManager->download(MAV_COMP_ID_AUTOPILOT1, filename, QStandardPaths::writableLocation(QStandardPaths::TempLocation)));
+        QCOMPARE(spyDownloadComplete.wait(30000), true);
+        QCOMPARE(spyDownloadComplete.count(), 1);
+
+        // void downloadComplete   (const QString& file, const QString& errorMsg);
+        QList<QVariant> arguments = spyDownloadComplete.takeFirst();
+        QVERIFY(arguments[1].toString().isEmpty());
+
+        const FTPManager::TransferStats_t stats = ftpManager->transferStats();
+        QCOMPARE(stats.bytesReceived, static_cast<uint64_t>(fileSize));
+        QCOMPARE(stats.filesCompleted, static_cast<uint32_t>(1));
+        QVERIFY(stats.burstRequests > 0);
+        if (dropPercent == 0) {
+            // Nothing to fill in behind the burst
+            QCOMPARE(stats.gapReads, static_cast<uint32_t>(0));
+            QCOMPARE(stats.duplicateBytes, static_cast<uint64_t>(0));
+        }
+
+        _verifyFileSizeAndDelete(arguments[0].toString(), fileSize);
+    }
+
+    _disconnectMockLink();
+}
+
 void FTPManagerTest::_verifyFileSizeAndDelete(const QString& filename, int expectedSize)
 {
     QFileInfo fileInfo(filename);
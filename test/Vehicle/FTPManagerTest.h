@@ -17,6 +17,10 @@ class FTPManagerTest : public UnitTest
 
 private slots:
     void _testLostPackets                               (void);
+    void _testSizeBasedDownloads                        (void);
+    void _testUncheckedFileSize                         (void);
+    void _testDownloadFiles                             (void);
+    void _testBurstDownload                             (void);
     void _testListDirectory                             (void);
     void _testListDirectoryNoResponse                   (void);
     void _testListDirectoryNakResponse                  (void);
@@ -8,6 +8,7 @@
  ****************************************************************************/
 
 #include "InitialConnectTest.h"
+#include "InitialConnectStateMachine.h"
 #include "MultiVehicleManager.h"
 #include "LinkManager.h"
 #include "MockLink.h"
@@ -62,3 +63,59 @@ void InitialConnectTest::_boardVendorProductId(void)
 
     LinkManager::instance()->disconnectAll();
 }
+
+void InitialConnectTest::_connectTimeByLinkRate(void)
+{
+    // 0 is an unlimited link, 11520 is a 115200 baud radio and 5760 a 57600 baud radio which is slow enough
+    // for the plan downloads to wait for the parameters.
+    static const int rgLinkRates[] = { 0, 11520, 5760 };
+
+    for (const int linkRate: rgLinkRates) {
+        auto *mvm = MultiVehicleManager::instance();
+        QSignalSpy activeVehicleSpy{mvm, &MultiVehicleManager::activeVehicleChanged};
+
+        auto mockConfig = std::make_shared<MockConfiguration>(QStringLiteral("MockLink"));
+        mockConfig->setLinkBytesPerSecond(linkRate);
+
+        SharedLinkConfigurationPtr linkConfig = mockConfig;
+        LinkManager::instance()->createConnectedLink(linkConfig);
+
+        QVERIFY(activeVehicleSpy.wait());
+        auto *vehicle = mvm->activeVehicle();
+        QVERIFY(vehicle);
+        QSignalSpy initialConnectCompleteSpy{vehicle, &Vehicle::initialConnectComplete};
+        QVERIFY(initialConnectCompleteSpy.wait(60000) || vehicle->isInitialConnectComplete());
+
+        const InitialConnectStateMachine *const connectMachine = vehicle->_initialConnectStateMachine;
+        QCOMPARE(connectMachine->slowLink(), (linkRate > 0) && (linkRate < 10000));
+
+        // Every step ran, in an order its dependencies allow
+        for (int i = 0; i < InitialConnectStateMachine::StepCount; i++) {
+            const InitialConnectStateMachine::Step_t step = static_cast<InitialConnectStateMachine::Step_t>(i);
+            const InitialConnectStateMachine::StepTiming_t timing = connectMachine->stepTiming(step);
+            QVERIFY(timing.startOrder >= 0);
+            QVERIFY(timing.completeOrder > timing.startOrder);
+
+            // Nothing starts before the steps it depends on are done
+            const uint32_t dependsOn = InitialConnectStateMachine::stepDependencies(step, connectMachine->slowLink());
+            for (int j = 0; j < InitialConnectStateMachine::StepCount; j++) {
+                if (dependsOn & (1u << j)) {
+                    QVERIFY(timing.startOrder > connectMachine->stepTiming(static_cast<InitialConnectStateMachine::Step_t>(j)).completeOrder);
+                }
+            }
+        }
+
+        // On a fast link the plan downloads run alongside the parameters, on a slow one they wait for them
+        const InitialConnectStateMachine::StepTiming_t paramTiming = connectMachine->stepTiming(InitialConnectStateMachine::StepParameters);
+        const InitialConnectStateMachine::StepTiming_t missionTiming = connectMachine->stepTiming(InitialConnectStateMachine::StepMission);
+        if (connectMachine->slowLink()) {
+            QVERIFY(missionTiming.startOrder > paramTiming.completeOrder);
+        } else {
+            QVERIFY(missionTiming.startOrder < paramTiming.startOrder);
+        }
+
+        QSignalSpy vehicleRemovedSpy{mvm, &MultiVehicleManager::activeVehicleChanged};
+        LinkManager::instance()->disconnectAll();
+        QVERIFY(vehicleRemovedSpy.wait());
+    }
+}
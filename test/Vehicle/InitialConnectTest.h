@@ -18,4 +18,5 @@ class InitialConnectTest : public UnitTest
 private slots:
     void _performTestCases(void);
     void _boardVendorProductId(void);
+    void _connectTimeByLinkRate(void);
 };
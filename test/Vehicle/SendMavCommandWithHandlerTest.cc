@@ -52,7 +52,7 @@ void SendMavCommandWithHandlerTest::_mavCmdProgressHandler(void* progressHandler
     QCOMPARE(1,                                         ack.progress);
 
     // Command should still be in list
-    QVERIFY(vehicle->_findMavCommandListEntryIndex(MAV_COMP_ID_AUTOPILOT1, testCase->command) != -1);
+    QVERIFY(vehicle->isMavCommandPending(MAV_COMP_ID_AUTOPILOT1, testCase->command));
 }
 
 void SendMavCommandWithHandlerTest::_testCaseWorker(TestCase_t& testCase)
@@ -80,7 +80,15 @@ void SendMavCommandWithHandlerTest::_testCaseWorker(TestCase_t& testCase)
     
     QVERIFY(QTest::qWaitFor([&]() { return _resultHandlerCalled; }, 10000));
     QCOMPARE(_mockLink->receivedMavCommandCount(testCase.command), testCase.expectedSendCount);
-    QCOMPARE(vehicle->_findMavCommandListEntryIndex(MAV_COMP_ID_AUTOPILOT1, testCase.command), -1);
+    QVERIFY(!vehicle->isMavCommandPending(MAV_COMP_ID_AUTOPILOT1, testCase.command));
+
+    const bool responded = testCase.expectInProgressResult || (testCase.expectedFailureCode == Vehicle::MavCmdResultCommandResultOnly);
+    const Vehicle::MavCommandStats_t stats = vehicle->mavCommandStats().value(testCase.command);
+    QCOMPARE(stats.sendCount,       1);
+    QCOMPARE(stats.retryCount,      testCase.expectedSendCount - 1);
+    QCOMPARE(stats.responseCount,   responded ? 1 : 0);
+    QCOMPARE(stats.noResponseCount, (testCase.expectedFailureCode == Vehicle::MavCmdResultFailureNoResponseToCommand) ? 1 : 0);
+    QCOMPARE(stats.rttCount,        (responded && (testCase.expectedSendCount == 1)) ? 1 : 0);
 
     _disconnectMockLink();
 }
@@ -123,7 +131,7 @@ void SendMavCommandWithHandlerTest::_duplicateCommand(void)
 
     // Duplicate command response should happen immediately
     QVERIFY(_resultHandlerCalled);
-    QVERIFY(vehicle->_findMavCommandListEntryIndex(MAV_COMP_ID_AUTOPILOT1, testCase.command) != -1);
+    QVERIFY(vehicle->isMavCommandPending(MAV_COMP_ID_AUTOPILOT1, testCase.command));
     QCOMPARE(_mockLink->receivedMavCommandCount(testCase.command), 1);
 }
 
@@ -156,7 +164,7 @@ void SendMavCommandWithHandlerTest::_compIdAllFailure(void)
     vehicle->sendMavCommandWithHandler(&handlerInfo, MAV_COMP_ID_ALL, testCase.command);
 
     QCOMPARE(_resultHandlerCalled,                                                      true);
-    QCOMPARE(vehicle->_findMavCommandListEntryIndex(MAV_COMP_ID_ALL, testCase.command), -1);
+    QVERIFY(!vehicle->isMavCommandPending(MAV_COMP_ID_ALL, testCase.command));
     QCOMPARE(_mockLink->receivedMavCommandCount(testCase.command),                      testCase.expectedSendCount);
 
     _disconnectMockLink();
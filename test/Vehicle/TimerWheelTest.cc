@@ -0,0 +1,103 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "TimerWheelTest.h"
+#include "TimerWheel.h"
+
+#include <QtTest/QTest>
+
+void TimerWheelTest::_expireTest()
+{
+    TimerWheel<int> wheel(50, 8);
+    const qint64 startMSecs = 100000;
+
+    (void) wheel.expire(startMSecs);
+    wheel.schedule(startMSecs + 120, 1);
+    wheel.schedule(startMSecs + 60, 2);
+    wheel.schedule(startMSecs + 130, 3);
+    QCOMPARE(wheel.count(), 3);
+
+    QVERIFY(wheel.expire(startMSecs + 50).isEmpty());
+    QCOMPARE(wheel.expire(startMSecs + 60), QList<int>({ 2 }));
+
+    // Same slot, only the entry which is due comes out
+    QCOMPARE(wheel.expire(startMSecs + 125), QList<int>({ 1 }));
+    QCOMPARE(wheel.expire(startMSecs + 140), QList<int>({ 3 }));
+    QVERIFY(wheel.isEmpty());
+}
+
+void TimerWheelTest::_longDeadlineTest()
+{
+    // Deadline several turns out shares slots with nearer ones
+    TimerWheel<int> wheel(50, 4);
+    const qint64 startMSecs = 100000;
+
+    (void) wheel.expire(startMSecs);
+    wheel.schedule(startMSecs + 1000, 1);
+    wheel.schedule(startMSecs + 200, 2);
+
+    for (qint64 nowMSecs = startMSecs; nowMSecs < startMSecs + 1000; nowMSecs += 50) {
+        const QList<int> expired = wheel.expire(nowMSecs);
+        QCOMPARE(expired, (nowMSecs == startMSecs + 200) ? QList<int>({ 2 }) : QList<int>());
+    }
+    QCOMPARE(wheel.count(), 1);
+
+    // A long gap between calls still finds it
+    QCOMPARE(wheel.expire(startMSecs + 5000), QList<int>({ 1 }));
+    QVERIFY(wheel.isEmpty());
+}
+
+void TimerWheelTest::_lateScheduleTest()
+{
+    TimerWheel<int> wheel(50, 8);
+    const qint64 startMSecs = 100000;
+
+    (void) wheel.expire(startMSecs);
+
+    // Deadline already passed goes out on the next call
+    wheel.schedule(startMSecs - 500, 1);
+    QCOMPARE(wheel.expire(startMSecs + 1), QList<int>({ 1 }));
+
+    wheel.schedule(startMSecs + 10, 2);
+    wheel.clear();
+    QVERIFY(wheel.isEmpty());
+    QVERIFY(wheel.expire(startMSecs + 1000).isEmpty());
+}
+
+void TimerWheelTest::_orderTest()
+{
+    TimerWheel<int> wheel(50, 8);
+    const qint64 startMSecs = 100000;
+
+    (void) wheel.expire(startMSecs);
+
+    // Interleave due and later entries within one slot, plus a second slot
+    for (int i = 0; i < 100; i++) {
+        wheel.schedule(startMSecs + (((i % 2) == 0) ? 10 : 40), i);
+    }
+    wheel.schedule(startMSecs + 60, 100);
+    wheel.schedule(startMSecs + 55, 101);
+
+    QList<int> expected;
+    for (int i = 0; i < 100; i += 2) {
+        expected.append(i);
+    }
+    QCOMPARE(wheel.expire(startMSecs + 20), expected);
+    QCOMPARE(wheel.count(), 52);
+
+    // Slots come out in tick order, each in scheduling order
+    expected.clear();
+    for (int i = 1; i < 100; i += 2) {
+        expected.append(i);
+    }
+    expected.append(100);
+    expected.append(101);
+    QCOMPARE(wheel.expire(startMSecs + 60), expected);
+    QVERIFY(wheel.isEmpty());
+}
@@ -0,0 +1,252 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "GstVideoReceiverTest.h"
+#include "GStreamer.h"
+#include "GstVideoReceiver.h"
+
+#include <QtCore/QFileInfo>
+#include <QtCore/QTemporaryDir>
+#include <QtGui/QImage>
+#include <QtNetwork/QUdpSocket>
+#include <QtQuick/QQuickItem>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+#include <gst/gst.h>
+
+static constexpr int kWidth = 320;
+static constexpr int kHeight = 240;
+static constexpr int kGopMsecs = 2000;  ///< key-int-max 60 at 30 fps
+
+static bool _hasElements(std::initializer_list<const char*> names)
+{
+    for (const char *name : names) {
+        GstElementFactory *factory = gst_element_factory_find(name);
+        if (!factory) {
+            return false;
+        }
+        gst_object_unref(factory);
+    }
+
+    return true;
+}
+
+static bool _hasH264Decoder()
+{
+    return (_hasElements({ "avdec_h264" }) || _hasElements({ "openh264dec" }));
+}
+
+/// Latency of the rtpjitterbuffer in the pipeline the sink was added to, -1 if there is none
+static int _jitterBufferLatency(GstElement *videoSink)
+{
+    GstObject *const pipeline = gst_element_get_parent(videoSink);
+    if (!pipeline) {
+        return -1;
+    }
+
+    int latency = -1;
+    GstIterator *const it = gst_bin_iterate_recurse(GST_BIN(pipeline));
+    GValue item = G_VALUE_INIT;
+    while (gst_iterator_next(it, &item) == GST_ITERATOR_OK) {
+        GstElement *const element = GST_ELEMENT(g_value_get_object(&item));
+        GstElementFactory *const factory = gst_element_get_factory(element);
+        if (factory && (g_strcmp0(GST_OBJECT_NAME(factory), "rtpjitterbuffer") == 0)) {
+            guint value = 0;
+            g_object_get(element, "latency", &value, nullptr);
+            latency = static_cast<int>(value);
+        }
+        g_value_reset(&item);
+    }
+    g_value_unset(&item);
+    gst_iterator_free(it);
+    gst_object_unref(pipeline);
+
+    return latency;
+}
+
+static void _stopReceiver(GstVideoReceiver &receiver)
+{
+    QSignalSpy stopSpy(&receiver, &VideoReceiver::onStopComplete);
+    receiver.stop();
+    QVERIFY(stopSpy.wait(5000));
+}
+
+void GstVideoReceiverTest::init()
+{
+    UnitTest::init();
+
+    if (!gst_is_initialized()) {
+        QVERIFY(GStreamer::initialize());
+    }
+
+    if (!_hasElements({ "videotestsrc", "x264enc", "rtph264pay", "udpsink", "udpsrc", "rtph264depay", "h264parse", "matroskamux" })) {
+        QSKIP("GStreamer elements for the test stream are not available");
+    }
+
+    // Grab a free port for the stream
+    QUdpSocket socket;
+    QVERIFY(socket.bind(QHostAddress::LocalHost, 0));
+    _port = socket.localPort();
+    socket.close();
+
+    const QString description = QStringLiteral(
+        "videotestsrc is-live=true pattern=ball ! video/x-raw,width=%1,height=%2,framerate=30/1 ! "
+        "x264enc tune=zerolatency speed-preset=ultrafast key-int-max=60 ! "
+        "rtph264pay config-interval=-1 pt=96 ! udpsink host=127.0.0.1 port=%3")
+        .arg(kWidth).arg(kHeight).arg(_port);
+
+    GError *error = nullptr;
+    _sender = gst_parse_launch(description.toUtf8().constData(), &error);
+    if (error) {
+        qWarning() << error->message;
+        g_clear_error(&error);
+    }
+    QVERIFY(_sender);
+    QVERIFY(gst_element_set_state(_sender, GST_STATE_PLAYING) != GST_STATE_CHANGE_FAILURE);
+}
+
+void GstVideoReceiverTest::cleanup()
+{
+    if (_sender) {
+        (void) gst_element_set_state(_sender, GST_STATE_NULL);
+        gst_clear_object(&_sender);
+    }
+
+    UnitTest::cleanup();
+}
+
+void GstVideoReceiverTest::_testRecordingPreroll()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString videoFile = tempDir.filePath(QStringLiteral("preroll.mkv"));
+
+    GstVideoReceiver receiver;
+    receiver.setUri(QStringLiteral("udp://127.0.0.1:%1").arg(_port));
+
+    QSignalSpy streamingSpy(&receiver, &VideoReceiver::streamingChanged);
+    receiver.start(5);
+    QVERIFY(streamingSpy.wait(5000));
+
+    // Let the recorder branch see at least one keyframe
+    QTest::qWait(kGopMsecs + 500);
+
+    QSignalSpy recordingStartedSpy(&receiver, &VideoReceiver::recordingStarted);
+    receiver.startRecording(videoFile, VideoReceiver::FILE_FORMAT_MKV);
+    QVERIFY(recordingStartedSpy.wait(kGopMsecs * 2));
+
+    // The file starts at the cached keyframe, which always comes before the buffer recording was started on.
+    // Without the pre-roll the file would start at the next keyframe instead, with nothing before it.
+    const qint64 prerollMsecs = recordingStartedSpy.first().at(1).toLongLong();
+    QVERIFY2((prerollMsecs > 0) && (prerollMsecs <= kGopMsecs), qPrintable(QString::number(prerollMsecs)));
+
+    QTest::qWait(500);
+
+    QSignalSpy recordingSpy(&receiver, &VideoReceiver::recordingChanged);
+    receiver.stopRecording();
+    QVERIFY(recordingSpy.wait(5000));
+    QCOMPARE(recordingSpy.last().at(0).toBool(), false);
+
+    QVERIFY(QFileInfo(videoFile).size() > 0);
+
+    _stopReceiver(receiver);
+}
+
+void GstVideoReceiverTest::_testScreenshot()
+{
+    if (!_hasH264Decoder()) {
+        QSKIP("No H.264 decoder available");
+    }
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString imageFile = tempDir.filePath(QStringLiteral("screenshot.png"));
+
+    GstVideoReceiver receiver;
+    receiver.setUri(QStringLiteral("udp://127.0.0.1:%1").arg(_port));
+
+    // Nothing is rendered, the item only has to exist. fakesink stands in for the GL video sink.
+    QQuickItem widget;
+    receiver.setWidget(&widget);
+
+    QSignalSpy screenshotSpy(&receiver, &VideoReceiver::onTakeScreenshotComplete);
+    receiver.takeScreenshot(imageFile);
+    QVERIFY(screenshotSpy.wait(5000));
+    QCOMPARE(screenshotSpy.last().at(0).value<VideoReceiver::STATUS>(), VideoReceiver::STATUS_INVALID_STATE);
+
+    GstElement *videoSink = gst_element_factory_make("fakesink", nullptr);
+    QVERIFY(videoSink);
+    (void) gst_object_ref_sink(videoSink);
+
+    QSignalSpy decodingSpy(&receiver, &VideoReceiver::decodingChanged);
+    receiver.start(5);
+    receiver.startDecoding(videoSink);
+    QVERIFY(decodingSpy.wait(kGopMsecs * 3));
+
+    receiver.takeScreenshot(imageFile);
+    QVERIFY(screenshotSpy.wait(5000));
+    QCOMPARE(screenshotSpy.last().at(0).value<VideoReceiver::STATUS>(), VideoReceiver::STATUS_OK);
+
+    const QImage image(imageFile);
+    QVERIFY(!image.isNull());
+    QCOMPARE(image.size(), QSize(kWidth, kHeight));
+
+    _stopReceiver(receiver);
+    gst_object_unref(videoSink);
+}
+
+void GstVideoReceiverTest::_testLatencyBenchmark()
+{
+    if (!_hasH264Decoder()) {
+        QSKIP("No H.264 decoder available");
+    }
+
+    int jitterBufferLatency[2];
+
+    for (const bool lowLatency : { false, true }) {
+        GstVideoReceiver receiver;
+        receiver.setUri(QStringLiteral("udp://127.0.0.1:%1").arg(_port));
+        receiver.setLowLatency(lowLatency);
+
+        QQuickItem widget;
+        receiver.setWidget(&widget);
+
+        GstElement *videoSink = gst_element_factory_make("fakesink", nullptr);
+        QVERIFY(videoSink);
+        (void) gst_object_ref_sink(videoSink);
+
+        QSignalSpy decodingSpy(&receiver, &VideoReceiver::decodingChanged);
+        receiver.start(5);
+        receiver.startDecoding(videoSink);
+        QVERIFY(decodingSpy.wait(kGopMsecs * 3));
+
+        // The profile shows in how the pipeline is built
+        jitterBufferLatency[lowLatency ? 1 : 0] = _jitterBufferLatency(videoSink);
+        QVERIFY(jitterBufferLatency[lowLatency ? 1 : 0] > 0);
+
+        gboolean sync = FALSE;
+        g_object_get(videoSink, "sync", &sync, nullptr);
+        QCOMPARE(static_cast<bool>(sync), !lowLatency);
+
+        // Measure steady state only, the first frames wait for a keyframe
+        receiver.resetLatencyStats();
+        QTest::qWait(3000);
+
+        const QVariantMap stats = receiver.latencyStats();
+        QVERIFY(stats[QStringLiteral("receiveFrames")].toULongLong() > 0);
+        QVERIFY(stats[QStringLiteral("renderFrames")].toULongLong() > 0);
+
+        _stopReceiver(receiver);
+        gst_object_unref(videoSink);
+    }
+
+    // The default profile holds packets in the jitter buffer's default 200 ms
+    QVERIFY(jitterBufferLatency[1] < jitterBufferLatency[0]);
+}
@@ -0,0 +1,32 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+
+typedef struct _GstElement GstElement;
+
+/// Runs GstVideoReceiver against a local videotestsrc -> H.264 -> RTP/UDP stand-in for a camera
+class GstVideoReceiverTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void init() final;
+    void cleanup() final;
+
+    void _testRecordingPreroll();
+    void _testScreenshot();
+    void _testLatencyBenchmark();
+
+private:
+    GstElement *_sender = nullptr;
+    quint16 _port = 0;
+};
@@ -0,0 +1,145 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "SubtitleWriterTest.h"
+#include "SubtitleWriter.h"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QLocale>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QSignalSpy>
+#include <QtTest/QTest>
+
+namespace {
+    const QList<SubtitleWriterWorker::Column_t> kColumns = {
+        { QStringLiteral("Alt"), QStringLiteral("m"), FactMetaData::valueTypeDouble, 1 },
+        { QStringLiteral("Speed"), QStringLiteral("m/s"), FactMetaData::valueTypeDouble, 1 },
+    };
+
+    constexpr qint64 kTimestamp = 1700000000000;
+
+    /// Samples one second apart, the first starting at firstStartMsecs
+    SubtitleWriterWorker::Sample_t makeSample(int index, qint64 firstStartMsecs)
+    {
+        SubtitleWriterWorker::Sample_t sample;
+        sample.values = { 12.34 + index, 4. };
+        sample.startMsecs = firstStartMsecs + (index * 1000);
+        sample.timestamp = kTimestamp + (index * 1000);
+        return sample;
+    }
+
+    QString dateString(int index)
+    {
+        return QDateTime::fromMSecsSinceEpoch(kTimestamp + (index * 1000)).toString(QLocale::system().dateFormat(QLocale::ShortFormat));
+    }
+
+    QString readFile(const QString &fileName)
+    {
+        QFile file(fileName);
+        if (!file.open(QIODevice::ReadOnly)) {
+            return QString();
+        }
+        return QString::fromUtf8(file.readAll());
+    }
+}
+
+void SubtitleWriterTest::_testSrt()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString fileName = tempDir.filePath(QStringLiteral("test.srt"));
+
+    // More than a batch, the tail must still reach the file when it is closed
+    constexpr int cSamples = SubtitleWriterWorker::kBatchSamples + 3;
+    constexpr qint64 cPrerollMsecs = 250;
+
+    SubtitleWriterWorker worker;
+    worker.open(fileName, kColumns, QSize(640, 480), SubtitleWriterWorker::SUBTITLE_FORMAT_SRT, false);
+    for (int i = 0; i < cSamples; i++) {
+        worker.write(makeSample(i, cPrerollMsecs));
+    }
+    worker.close();
+
+    QString expected;
+    for (int i = 0; i < cSamples; i++) {
+        const QTime start = QTime(0, 0).addMSecs(cPrerollMsecs + (i * 1000));
+        expected += QStringLiteral("%1\n%2 --> %3\n%4\nAlt: %5 m\nSpeed: 4.0 m/s\n\n").arg(
+            QString::number(i + 1),
+            start.toString(QStringLiteral("HH:mm:ss,zzz")),
+            start.addMSecs(1000).toString(QStringLiteral("HH:mm:ss,zzz")),
+            dateString(i),
+            QString::number(12.34 + i, 'f', 1));
+    }
+
+    const QString contents = readFile(fileName);
+    QCOMPARE(contents, expected);
+    QVERIFY(contents.startsWith(QStringLiteral("1\n00:00:00,250 --> 00:00:01,250\n")));
+}
+
+void SubtitleWriterTest::_testAss()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString fileName = tempDir.filePath(QStringLiteral("test.ass"));
+
+    constexpr int cSamples = 3;
+
+    SubtitleWriterWorker worker;
+    worker.open(fileName, kColumns, QSize(640, 480), SubtitleWriterWorker::SUBTITLE_FORMAT_ASS, false);
+    for (int i = 0; i < cSamples; i++) {
+        worker.write(makeSample(i, 1500));
+    }
+    worker.close();
+
+    const QString contents = readFile(fileName);
+    QVERIFY(contents.startsWith(QStringLiteral("[Script Info]\n")));
+    QVERIFY(contents.contains(QStringLiteral("PlayResX: 640\nPlayResY: 480\n")));
+    QVERIFY(contents.contains(QStringLiteral("Style: Default,Monospace,12,")));
+
+    const QString events = contents.mid(contents.indexOf(QStringLiteral("[Events]\n")));
+    const QStringList dialogues = events.split(QLatin1Char('\n')).filter(QStringLiteral("Dialogue: "));
+
+    // Names and values for each of the three rows, plus the date
+    QCOMPARE(dialogues.count(), cSamples * 7);
+
+    // Times are centiseconds, the first cue starts where the video has already been running for 1.5 secs
+    QCOMPARE(dialogues[0], QStringLiteral("Dialogue: 0,0:00:01.50,0:00:02.50,Default,,0,0,0,,{\\an3\\pos(125,450)}Alt:"));
+    QCOMPARE(dialogues[1], QStringLiteral("Dialogue: 0,0:00:01.50,0:00:02.50,Default,,0,0,0,,{\\pos(135,450)}12.3 m"));
+    QCOMPARE(dialogues[2], QStringLiteral("Dialogue: 0,0:00:01.50,0:00:02.50,Default,,0,0,0,,{\\an3\\pos(310,450)}Speed:"));
+    QCOMPARE(dialogues[3], QStringLiteral("Dialogue: 0,0:00:01.50,0:00:02.50,Default,,0,0,0,,{\\pos(320,450)}4.0 m/s"));
+    QCOMPARE(dialogues[6], QStringLiteral("Dialogue: 0,0:00:01.50,0:00:02.50,Default,,0,0,0,,{\\pos(10,35)}%1").arg(dateString(0)));
+
+    // Each subtitle starts where the previous one ended
+    QVERIFY(dialogues[7].startsWith(QStringLiteral("Dialogue: 0,0:00:02.50,0:00:03.50,")));
+    QVERIFY(dialogues[14].startsWith(QStringLiteral("Dialogue: 0,0:00:03.50,0:00:04.50,")));
+}
+
+void SubtitleWriterTest::_testTelemetrySamples()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+
+    SubtitleWriterWorker worker;
+    QSignalSpy sampleSpy(&worker, &SubtitleWriterWorker::telemetrySample);
+    worker.open(tempDir.filePath(QStringLiteral("test.ass")), kColumns, QSize(640, 480), SubtitleWriterWorker::SUBTITLE_FORMAT_ASS, true);
+
+    // The track is muxed live, every sample goes out as it is written rather than with the file batch
+    for (int i = 0; i < 3; i++) {
+        worker.write(makeSample(i, 500));
+        QCOMPARE(sampleSpy.count(), i + 1);
+
+        const QList<QVariant> arguments = sampleSpy.last();
+        QCOMPARE(arguments[0].toString(), QStringLiteral("%1\nAlt: %2 m\nSpeed: 4.0 m/s").arg(dateString(i), QString::number(12.34 + i, 'f', 1)));
+        QCOMPARE(arguments[1].toLongLong(), 500 + (i * 1000));
+        QCOMPARE(arguments[2].toLongLong(), 1000 / SubtitleWriter::kSampleRate);
+    }
+
+    worker.close();
+    QCOMPARE(sampleSpy.count(), 3);
+}
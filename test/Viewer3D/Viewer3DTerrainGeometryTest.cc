@@ -0,0 +1,295 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#include "Viewer3DTerrainGeometryTest.h"
+#include "Viewer3DUtils.h"
+
+#include <QtTest/QTest>
+
+#include <limits>
+
+namespace {
+    constexpr int kFloatsPerVertex = 8;     ///< position, normal, texture coordinate
+
+    struct Triangle {
+        QVector3D position[3];
+        QVector3D normal;
+        QVector2D texCoord[3];
+    };
+
+    QList<Triangle> triangles(const QByteArray& vertexData)
+    {
+        const float *p = reinterpret_cast<const float *>(vertexData.constData());
+        const qsizetype vertexCount = vertexData.size() / (kFloatsPerVertex * sizeof(float));
+
+        QList<Triangle> result;
+        for (qsizetype i = 0; i < vertexCount / 3; i++) {
+            Triangle triangle;
+            for (int v = 0; v < 3; v++) {
+                triangle.position[v] = QVector3D(p[0], p[1], p[2]);
+                triangle.normal = QVector3D(p[3], p[4], p[5]);
+                triangle.texCoord[v] = QVector2D(p[6], p[7]);
+                p += kFloatsPerVertex;
+            }
+            result.append(triangle);
+        }
+
+        return result;
+    }
+
+    int nodeTriangles()
+    {
+        return Viewer3DTerrainGeometry::nodeVertexCount(Viewer3DTerrainGeometry::nodeResolution) / 3;
+    }
+}
+
+Viewer3DTerrainGeometry::TerrainNodeJob_t Viewer3DTerrainGeometryTest::_rootJob(int resolution) const
+{
+    Viewer3DTerrainGeometry::TerrainNodeJob_t job;
+    job.key = 0;
+    job.northWest = _northWest;
+    job.southEast = _southEast;
+    job.refCoordinate = _ref;
+    job.resolution = resolution;
+    job.skirtDepth = 20;
+    job.sRange = QVector2D(Viewer3DTerrainGeometry::textureS(_northWest.longitude()), Viewer3DTerrainGeometry::textureS(_southEast.longitude()));
+    job.tRange = QVector2D(Viewer3DTerrainGeometry::textureT(_northWest.latitude(), _northWest.latitude()), Viewer3DTerrainGeometry::textureT(_southEast.latitude(), _northWest.latitude()));
+
+    return job;
+}
+
+void Viewer3DTerrainGeometryTest::_setRoi(Viewer3DTerrainGeometry& geometry) const
+{
+    geometry.setRoiMin(_southEast);
+    geometry.setRoiMax(_northWest);
+    geometry.setRefCoordinate(_ref);
+}
+
+void Viewer3DTerrainGeometryTest::_verifyCoverage(const QList<Viewer3DTerrainGeometry::TerrainNode_t>& nodes)
+{
+    // The selected nodes cover the roi exactly once, whatever levels they are at
+    int maxLevel = 0;
+    for (const Viewer3DTerrainGeometry::TerrainNode_t& node : nodes) {
+        QVERIFY(node.level >= 0 && node.level <= Viewer3DTerrainGeometry::maxNodeLevel);
+        maxLevel = qMax(maxLevel, node.level);
+    }
+
+    const int cellsPerSide = 1 << maxLevel;
+    QList<int> coverCount(cellsPerSide * cellsPerSide, 0);
+    for (const Viewer3DTerrainGeometry::TerrainNode_t& node : nodes) {
+        const int span = 1 << (maxLevel - node.level);
+        QVERIFY(node.x >= 0 && node.x < (1 << node.level));
+        QVERIFY(node.y >= 0 && node.y < (1 << node.level));
+        for (int y = node.y * span; y < (node.y + 1) * span; y++) {
+            for (int x = node.x * span; x < (node.x + 1) * span; x++) {
+                coverCount[y * cellsPerSide + x]++;
+            }
+        }
+    }
+    for (const int count : coverCount) {
+        QCOMPARE(count, 1);
+    }
+}
+
+void Viewer3DTerrainGeometryTest::_testNodeMesh()
+{
+    constexpr int resolution = 4;
+    const Viewer3DTerrainGeometry::TerrainNodeJob_t job = _rootJob(resolution);
+    const Viewer3DTerrainGeometry::TerrainNodeMesh_t mesh = Viewer3DTerrainGeometry::buildNodeMesh(job);
+
+    QCOMPARE(mesh.key, job.key);
+    QCOMPARE(mesh.vertexData.size(), Viewer3DTerrainGeometry::nodeVertexCount(resolution) * kFloatsPerVertex * static_cast<qsizetype>(sizeof(float)));
+
+    const QList<Triangle> rgTriangles = triangles(mesh.vertexData);
+    const qsizetype surfaceTriangles = 2 * resolution * resolution;
+    QCOMPARE(rgTriangles.count(), surfaceTriangles + (4 * 2 * resolution));
+
+    // The surface faces up and the roi maps onto the whole texture
+    QVector2D texMin(1, 1);
+    QVector2D texMax(0, 0);
+    for (qsizetype i = 0; i < surfaceTriangles; i++) {
+        const Triangle& triangle = rgTriangles[i];
+        QVERIFY(triangle.normal.z() > 0.99f);
+        for (int v = 0; v < 3; v++) {
+            QVERIFY(qAbs(triangle.position[v].z()) < 1);
+            texMin = QVector2D(qMin(texMin.x(), triangle.texCoord[v].x()), qMin(texMin.y(), triangle.texCoord[v].y()));
+            texMax = QVector2D(qMax(texMax.x(), triangle.texCoord[v].x()), qMax(texMax.y(), triangle.texCoord[v].y()));
+        }
+    }
+    QVERIFY(qAbs(texMin.x()) < 1e-3f && qAbs(texMin.y()) < 1e-3f);
+    QVERIFY(qAbs(texMax.x() - 1) < 1e-3f && qAbs(texMax.y() - 1) < 1e-3f);
+
+    // Skirts hang skirtDepth down from the edges and face away from the node
+    const QVector3D northWest = mapGpsToLocalPoint(job.northWest, job.refCoordinate);
+    const QVector3D southEast = mapGpsToLocalPoint(job.southEast, job.refCoordinate);
+    const QVector3D center = (northWest + southEast) / 2;
+    for (qsizetype i = surfaceTriangles; i < rgTriangles.count(); i++) {
+        const Triangle& triangle = rgTriangles[i];
+        QVERIFY(qAbs(triangle.normal.z()) < 0.01f);
+
+        QVector3D centroid;
+        int lowVertices = 0;
+        for (int v = 0; v < 3; v++) {
+            centroid += triangle.position[v] / 3;
+            if (qAbs(triangle.position[v].z() + job.skirtDepth) < 1) {
+                lowVertices++;
+            } else {
+                QVERIFY(qAbs(triangle.position[v].z()) < 1);
+            }
+        }
+        QVERIFY(lowVertices == 1 || lowVertices == 2);
+
+        const QVector3D outwards(centroid.x() - center.x(), centroid.y() - center.y(), 0);
+        QVERIFY(QVector3D::dotProduct(triangle.normal, outwards) > 0);
+    }
+}
+
+void Viewer3DTerrainGeometryTest::_testNodeMeshHeights()
+{
+    constexpr int resolution = 4;
+    constexpr int rowSize = resolution + 1;
+    Viewer3DTerrainGeometry::TerrainNodeJob_t job = _rootJob(resolution);
+    for (int i = 0; i < rowSize * rowSize; i++) {
+        job.heights.append(100 + i);
+    }
+    const QList<Triangle> rgTriangles = triangles(Viewer3DTerrainGeometry::buildNodeMesh(job).vertexData);
+
+    // The first quad's first triangle is north west, south west, north east
+    const Triangle& first = rgTriangles.first();
+    QVERIFY(qAbs(first.position[0].z() - job.heights[0]) < 0.01f);
+    QVERIFY(qAbs(first.position[1].z() - job.heights[rowSize]) < 0.01f);
+    QVERIFY(qAbs(first.position[2].z() - job.heights[1]) < 0.01f);
+
+    // The skirts follow the edge heights down
+    float minZ = std::numeric_limits<float>::max();
+    for (const Triangle& triangle : rgTriangles) {
+        for (int v = 0; v < 3; v++) {
+            minZ = qMin(minZ, triangle.position[v].z());
+        }
+    }
+    QVERIFY(qAbs(minZ - (job.heights[0] - job.skirtDepth)) < 0.01f);
+
+    // Heights which don't match the grid leave the node flat
+    job.heights.removeLast();
+    for (const Triangle& triangle : triangles(Viewer3DTerrainGeometry::buildNodeMesh(job).vertexData).mid(0, 2 * resolution * resolution)) {
+        for (int v = 0; v < 3; v++) {
+            QVERIFY(qAbs(triangle.position[v].z()) < 1);
+        }
+    }
+}
+
+void Viewer3DTerrainGeometryTest::_testSelectNodes()
+{
+    Viewer3DTerrainGeometry geometry;
+    _setRoi(geometry);
+
+    // Seen from far away the root node is enough
+    geometry._cameraPosition = QVector3D(0, 0, 1e6);
+    QList<Viewer3DTerrainGeometry::TerrainNode_t> nodes = geometry.selectNodes();
+    QCOMPARE(nodes.count(), 1);
+    QCOMPARE(nodes.first().level, 0);
+
+    // Close to the ground at the north west corner the nodes get smaller towards the camera
+    const QVector3D cornerNw = mapGpsToLocalPoint(_northWest, _ref);
+    geometry._cameraPosition = QVector3D(cornerNw.x(), cornerNw.y(), 10);
+    nodes = geometry.selectNodes();
+    QVERIFY(nodes.count() > 1);
+    QVERIFY(nodes.count() * nodeTriangles() <= geometry.triangleBudget());
+    _verifyCoverage(nodes);
+
+    int cornerLevel = -1;
+    int farLevel = -1;
+    int maxLevel = 0;
+    for (const Viewer3DTerrainGeometry::TerrainNode_t& node : nodes) {
+        maxLevel = qMax(maxLevel, node.level);
+        if (node.x == 0 && node.y == 0) {
+            cornerLevel = node.level;
+        }
+        const int last = (1 << node.level) - 1;
+        if (node.x == last && node.y == last) {
+            farLevel = node.level;
+        }
+    }
+    QCOMPARE(cornerLevel, maxLevel);
+    QVERIFY(farLevel >= 0);
+    QVERIFY(farLevel < cornerLevel);
+    QVERIFY(cornerLevel >= 6);
+}
+
+void Viewer3DTerrainGeometryTest::_testSelectNodesBudget()
+{
+    Viewer3DTerrainGeometry geometry;
+    _setRoi(geometry);
+
+    const QVector3D cornerNw = mapGpsToLocalPoint(_northWest, _ref);
+    geometry._cameraPosition = QVector3D(cornerNw.x(), cornerNw.y(), 10);
+
+    // Each split replaces one node by four, so a budget of ten nodes allows three splits
+    geometry._triangleBudget = 10 * nodeTriangles();
+    QList<Viewer3DTerrainGeometry::TerrainNode_t> nodes = geometry.selectNodes();
+    QCOMPARE(nodes.count(), 10);
+    _verifyCoverage(nodes);
+
+    // The splits went to the corner the camera is at
+    bool foundCorner = false;
+    for (const Viewer3DTerrainGeometry::TerrainNode_t& node : nodes) {
+        if (node.x == 0 && node.y == 0) {
+            QCOMPARE(node.level, 3);
+            foundCorner = true;
+        }
+    }
+    QVERIFY(foundCorner);
+
+    // A larger budget never selects fewer nodes, and never goes over
+    qsizetype previousCount = 0;
+    for (const int budgetNodes : { 4, 20, 50, 200 }) {
+        geometry._triangleBudget = budgetNodes * nodeTriangles();
+        nodes = geometry.selectNodes();
+        QVERIFY(nodes.count() <= budgetNodes);
+        QVERIFY(nodes.count() >= previousCount);
+        previousCount = nodes.count();
+        _verifyCoverage(nodes);
+    }
+
+    // Less than a node still shows the root
+    geometry._triangleBudget = 0;
+    nodes = geometry.selectNodes();
+    QCOMPARE(nodes.count(), 1);
+    QCOMPARE(nodes.first().level, 0);
+}
+
+void Viewer3DTerrainGeometryTest::_testSelectNodesVehicle()
+{
+    Viewer3DTerrainGeometry geometry;
+    _setRoi(geometry);
+
+    // The camera is far away but the vehicle flies low over the south east corner
+    geometry._cameraPosition = QVector3D(0, 0, 1e6);
+    const QVector3D cornerSe = mapGpsToLocalPoint(_southEast, _ref);
+    geometry._vehiclePosition = QVector2D(cornerSe.x(), cornerSe.y());
+    geometry._vehiclePositionValid = true;
+
+    const QList<Viewer3DTerrainGeometry::TerrainNode_t> nodes = geometry.selectNodes();
+    QVERIFY(nodes.count() > 1);
+    _verifyCoverage(nodes);
+
+    int maxLevel = 0;
+    for (const Viewer3DTerrainGeometry::TerrainNode_t& node : nodes) {
+        maxLevel = qMax(maxLevel, node.level);
+    }
+    bool foundCorner = false;
+    for (const Viewer3DTerrainGeometry::TerrainNode_t& node : nodes) {
+        const int last = (1 << node.level) - 1;
+        if (node.x == last && node.y == last) {
+            QCOMPARE(node.level, maxLevel);
+            foundCorner = true;
+        }
+    }
+    QVERIFY(foundCorner);
+}
@@ -0,0 +1,34 @@
+/****************************************************************************
+ *
+ * (c) 2009-2024 QGROUNDCONTROL PROJECT <http://www.qgroundcontrol.org>
+ *
+ * QGroundControl is licensed according to the terms in the file
+ * COPYING.md in the root of the source code directory.
+ *
+ ****************************************************************************/
+
+#pragma once
+
+#include "UnitTest.h"
+#include "Viewer3DTerrainGeometry.h"
+
+class Viewer3DTerrainGeometryTest : public UnitTest
+{
+    Q_OBJECT
+
+private slots:
+    void _testNodeMesh();
+    void _testNodeMeshHeights();
+    void _testSelectNodes();
+    void _testSelectNodesBudget();
+    void _testSelectNodesVehicle();
+
+private:
+    Viewer3DTerrainGeometry::TerrainNodeJob_t _rootJob(int resolution) const;
+    void _setRoi(Viewer3DTerrainGeometry& geometry) const;
+    void _verifyCoverage(const QList<Viewer3DTerrainGeometry::TerrainNode_t>& nodes);
+
+    const QGeoCoordinate _northWest = QGeoCoordinate(47.40, 8.53, 0);
+    const QGeoCoordinate _southEast = QGeoCoordinate(47.38, 8.56, 0);
+    const QGeoCoordinate _ref = QGeoCoordinate(47.39, 8.545, 0);
+};